@@ -102,7 +102,7 @@ namespace pod
                 // Find in which position of 'satSet' is the current '(*itSat)'
                 // Please note that 'currSatSet' is a subset of 'satSet'
                 int j(0);
-                auto& itSat2 = csFlags.begin();
+                auto itSat2 = csFlags.begin();
                 while ((itSat2->first) != (itSat))
                 {
                     ++j;
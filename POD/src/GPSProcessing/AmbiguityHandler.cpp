@@ -152,7 +152,7 @@ namespace pod
         int i(0);
         for (const auto & amb : *pAmbs)
         {
-            auto  &it = gData.getBody().find(amb.sv);
+            auto it = gData.getBody().find(amb.sv);
             if (it != gData.getBody().end())
             {
                 if (refSVs.find(amb.sv) == refSVs.end())
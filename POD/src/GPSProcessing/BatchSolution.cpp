@@ -0,0 +1,135 @@
+#include"BatchSolution.h"
+#include"Solution.h"
+
+#include<atomic>
+#include<chrono>
+#include<thread>
+
+using namespace gpstk;
+
+namespace pod
+{
+    BatchSolution::BatchSolution(const char* path, const std::list<std::string>& siteIDs)
+        :numThreads(0)
+    {
+        // the products are loaded once, the sites only keep a pointer to them
+        ConfDataReader confReader;
+        GnssDataStore shared(confReader);
+        shared.LoadProducts(path);
+        products = shared.products;
+
+        numThreads = confReader.getValueAsInt("batchThreads");
+
+        std::list<std::string> ids(siteIDs);
+        if (ids.empty())
+            ids = confReader.getListValue("batchSites");
+
+        // the sites are set up here, in one thread; only the
+        // processing is done in parallel
+        for (auto& id : ids)
+        {
+            std::unique_ptr<Site> site(new Site);
+            site->id = id;
+
+            std::cout << "Site " << id << ":" << std::endl;
+            site->data = std::make_shared<GnssDataStore>(site->confReader, products);
+            site->data->LoadSiteData(path, id);
+            site->solver.setConfigData(site->data);
+
+            sites.push_back(std::move(site));
+        }
+    }
+
+    void BatchSolution::process(std::ostream& os)
+    {
+        unsigned n = numThreads;
+        if (n == 0)
+            n = std::thread::hardware_concurrency();
+        if (n == 0)
+            n = 1;
+        if (n > sites.size())
+            n = sites.size();
+
+        // every worker takes the next site not yet taken
+        std::atomic<size_t> next(0);
+        auto worker = [&]()
+        {
+            for (size_t i = next++; i < sites.size(); i = next++)
+                processSite(*sites[i]);
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned i = 1; i < n; i++)
+            pool.emplace_back(worker);
+        worker();
+        for (auto& it : pool)
+            it.join();
+        dbWriter.wait();
+
+        for (auto& site : sites)
+            os << site->log.str();
+    }
+
+    void BatchSolution::processSite(Site& site)
+    {
+        std::ostream& log = site.log;
+        auto t1 = std::chrono::steady_clock::now();
+        try
+        {
+            Solution::initSpill(site.solver, *site.data);
+            site.solver.process();
+            log << site.id << ": process complete, epochs: " << site.solver.getData().size() << std::endl;
+
+            Solution::saveStatistic(site.solver, *site.data);
+        }
+        catch (gpstk::Exception & e)
+        {
+            site.failed = true;
+            log << site.id << ": an exception has occured. Processing stopped." << std::endl;
+            log << e.getLocation() << std::endl;
+            log << e.getText() << std::endl;
+        }
+        catch (std::exception & e)
+        {
+            site.failed = true;
+            log << site.id << ": an exception has occured. Processing stopped." << std::endl;
+            log << e.what() << std::endl;
+        }
+        std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t1;
+        log << site.id << ": " << dt.count() << " s" << std::endl;
+
+        if (site.failed)
+            return;
+
+        // the results are saved by the writer thread while this one goes on
+        // with the next site; from now on only the writer thread uses 'site'
+        Solution::moveToDb(site.solver, *site.data, dbWriter, [&site](std::exception_ptr error)
+        {
+            try
+            {
+                if (error)
+                    std::rethrow_exception(error);
+                site.log << site.id << ": results saved to " << site.solver.fileName() << std::endl;
+                return;
+            }
+            catch (gpstk::Exception & e)
+            {
+                site.log << site.id << ": can't save the results: " << e.getText() << std::endl;
+            }
+            catch (std::exception & e)
+            {
+                site.log << site.id << ": can't save the results: " << e.what() << std::endl;
+            }
+            site.failed = true;
+        });
+    }
+
+    size_t BatchSolution::numFailed() const
+    {
+        size_t n(0);
+        for (auto& site : sites)
+            if (site->failed)
+                n++;
+        return n;
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef POD_BATCH_SOLUTION_H
+#define POD_BATCH_SOLUTION_H
+
+#include"ConfDataReader.hpp"
+
+#include"GnssDataStore.hpp"
+#include"CustomSolution.h"
+#include"SQLiteWriter.h"
+
+#include<list>
+#include<memory>
+#include<sstream>
+#include<string>
+#include<vector>
+
+namespace pod
+{
+    // Processes many sites with the same configuration file.
+    // The products (precise orbits and clocks, EOP, ionospheric data) are
+    // loaded once and shared by all the sites; each site gets its own
+    // configuration reader, data store and solver, and the sites are
+    // processed by a pool of threads. As with Solution, the results of a
+    // site are saved to its own statistic file and database; the databases
+    // are written by a background thread while the next sites are processed.
+    class BatchSolution
+    {
+    public:
+
+        // 'path'  - configuration file
+        // 'sites' - IDs of the sites to process; if empty, they are read
+        //           from the 'batchSites' list of the configuration file
+        BatchSolution(const char* path,
+                      const std::list<std::string>& sites = std::list<std::string>());
+
+        virtual ~BatchSolution()
+        {
+        }
+
+        // Sets the number of threads; 0 means one per hardware thread.
+        BatchSolution& setNumThreads(unsigned n)
+        {
+            numThreads = n; return (*this);
+        }
+
+        unsigned getNumThreads() const
+        {
+            return numThreads;
+        }
+
+        // Processes all the sites and saves their results. The report of
+        // each site is printed to 'os' once all of them are done.
+        virtual void process(std::ostream& os = std::cout);
+
+        // Number of sites whose processing has failed.
+        size_t numFailed() const;
+
+    protected:
+
+        // data and output of one site
+        struct Site
+        {
+            std::string id;
+
+            // Configuration file reader
+            gpstk::ConfDataReader confReader;
+
+            GnssDataStore_sptr data;
+
+            CustomSolution solver;
+
+            // report, written only by the thread processing the site
+            std::ostringstream log;
+
+            bool failed = false;
+        };
+
+        // process one site, in a worker thread
+        virtual void processSite(Site& site);
+
+        // Products loaded once for all the sites
+        GnssProducts_sptr products;
+
+        std::vector<std::unique_ptr<Site>> sites;
+
+        // number of worker threads
+        unsigned numThreads;
+
+        // writes the databases of the sites
+        SQLiteWriter dbWriter;
+    };
+}
+
+#endif // !POD_BATCH_SOLUTION_H
@@ -229,7 +229,7 @@ namespace pod
                     auto ep = opts().fullOutput? GnssEpoch(gRin.getBody()): GnssEpoch();
                     // updateNomPos(solverFB);
                     printSolution( solver, t, ep);
-                    gMap.data.insert(std::make_pair(t, ep));
+                    gMap.add(t, ep);
                 }
             }
         }
@@ -244,7 +244,7 @@ namespace pod
                 auto ep = opts().fullOutput ? GnssEpoch(gRin.getBody()) : GnssEpoch();
                 //updateNomPos(solverFB);
                 printSolution( solverFb, gRin.getHeader().epoch, ep);
-                gMap.data.insert(std::make_pair(gRin.getHeader().epoch, ep));
+                gMap.add(gRin.getHeader().epoch, ep);
             }
             std::cout << "Measurments rejected: " << solverFb.rejectedMeasurements << std::endl;
         }
@@ -16,51 +16,66 @@ namespace pod
         return corr;
     }
 
-    void ComputeStatistic::compute(const GnssEpochMap & data, gpstk::Vector<double>& sln, gpstk::Matrix<double>& covar)
+    void ComputeStatistic::reset()
     {
-        int s = types.size();
-        std::list<Vector<double>> res;
-        sln.resize(s, .0);
-        covar = Matrix<double>(s, s, .0);
-        int i(0);
+        goodEpochs = 0;
+        totalEpochs = 0;
+        svInView = 0;
+        svInUse = 0;
+        mean.resize(types.size(), .0);
+        comoment = Matrix<double>(types.size(), types.size(), .0);
+    }
 
-        //for (auto ep = begin(data); ep != end(data); ep++)
-        for (auto && ep : data)
-        {
-            SlnType curSt = (SlnType)(int)ep.second.slnData.getValue(TypeID::recSlnType);
+    void ComputeStatistic::add(const CommonTime& t, const GnssEpoch& ep)
+    {
+        totalEpochs++;
 
-            if (curSt == slnType)
-            {
-                i++;
-                Vector<double> resi(s, .0);
-                int j(0);
-                for (auto && it : types)
-                {
-                    resi[j] = ep.second.slnData.getValue(it);
-                    sln[j] = sln[j] * (i - 1) / i + resi[j] / i;
-                    j++;
-                }
-                res.push_back(resi);
-            }
-        }
-		goodEpochs = i;
-		totalEpochs = data.size();
+        SlnType curSt = (SlnType)(int)ep.slnData.getValue(TypeID::recSlnType);
+        if (curSt != slnType)
+            return;
+
+        int i = ++goodEpochs;
+        svInView += ep.satData.size();
+        auto used = ep.slnData.find(TypeID::recUsedSV);
+        if (used != ep.slnData.end())
+            svInUse += used->second;
 
-        //calculate sum squares 
-        for (auto&& it : res)
+        // Welford's update: the deviations from the old and the new mean
+        size_t s = types.size();
+        Vector<double> d1(s, .0), d2(s, .0);
+        int j(0);
+        for (auto && it : types)
         {
-            for (size_t k = 0; k < s; k++)
-                for (size_t l = 0; l <= k; l++)
-                {
-                    double d1 = it[k] - sln[k];
-                    double d2 = it[l] - sln[l];
-                    covar(k, l) += d1 * d2;
-                }
+            double x = ep.slnData.getValue(it);
+            d1[j] = x - mean[j];
+            mean[j] += d1[j] / i;
+            d2[j] = x - mean[j];
+            j++;
         }
 
         for (size_t k = 0; k < s; k++)
             for (size_t l = 0; l <= k; l++)
-                covar(k, l) = covar(k, l) / (res.size() - 1);
+                comoment(k, l) += d1[k] * d2[l];
+    }
+
+    void ComputeStatistic::result(Vector<double>& sln, Matrix<double>& covar) const
+    {
+        size_t s = types.size();
+        sln = mean;
+        covar = Matrix<double>(s, s, .0);
+
+        for (size_t k = 0; k < s; k++)
+            for (size_t l = 0; l <= k; l++)
+                covar(k, l) = comoment(k, l) / (goodEpochs - 1);
+    }
+
+    void ComputeStatistic::compute(const GnssEpochMap & data, gpstk::Vector<double>& sln, gpstk::Matrix<double>& covar)
+    {
+        reset();
+        for (auto && ep : data)
+            add(ep.first, ep.second);
+        totalEpochs = data.size();
 
+        result(sln, covar);
     }
 }
@@ -5,7 +5,12 @@
 
 namespace pod
 {
-    class ComputeStatistic
+    // Mean and covariance of the solution values 'types' over the epochs
+    // of solution type 'slnType'. The epochs are added one by one (it's
+    // also a sink of a GnssEpochMap), so that the memory used doesn't
+    // depend on their number.
+    class ComputeStatistic :
+        public GnssEpochSink
     {
 
     public:
@@ -14,30 +19,54 @@ namespace pod
         static  gpstk::Matrix<double> corrMatrix(const gpstk::Matrix<double>& covar);
 
         ComputeStatistic(SlnType st, gpstk::TypeIDSet tIDs)
-            :slnType(st), types(tIDs), goodEpochs(0)
-        {};
-        ~ComputeStatistic() {};
+            :slnType(st), types(tIDs)
+        {
+            reset();
+        };
+        virtual ~ComputeStatistic() {};
         
-        SlnType getSlnType()
+        SlnType getSlnType() const
         {
             return slnType;
         }
 
-        gpstk::TypeIDSet getTypeIDSet()
+        gpstk::TypeIDSet getTypeIDSet() const
         {
             return types;
         }
 
+        // statistic of all the epochs of 'data'
         void compute(const GnssEpochMap& data, gpstk::Vector<double>& sln, gpstk::Matrix<double>& cov);
 
+        // adds an epoch to the statistic
+        void add(const gpstk::CommonTime& t, const GnssEpoch& ep);
+
+        virtual void write(const gpstk::CommonTime& t, const GnssEpoch& ep) override
+        {
+            add(t, ep);
+        }
+
+        // Mean and covariance (lower triangle) of the epochs added
+        void result(gpstk::Vector<double>& sln, gpstk::Matrix<double>& cov) const;
+
+        void reset();
+
 		int goodEpochs;
 		int totalEpochs;
 
+        // sums of the number of SV in view and in use of the good epochs
+        double svInView;
+        double svInUse;
+
     private:
 
         SlnType slnType;
         gpstk::TypeIDSet types;
 
+        // running mean and sums of the products of the deviations
+        gpstk::Vector<double> mean;
+        gpstk::Matrix<double> comoment;
+
     };
 }
 
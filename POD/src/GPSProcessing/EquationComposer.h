@@ -31,6 +31,13 @@ namespace pod
 		};
 		typedef std::map<FilterParameter, FilterData> FilterState;
 
+        //measurement update strategy of the Kalman filter
+        enum UpdateType
+        {
+            Information = 0,    ///< all measurements at once, in information form
+            Sequential = 1,     ///< one measurement at a time, Joseph form covariance
+        };
+
         //to map opbservables TypeID to weight factor
         static const std::map<gpstk::TypeID, double> weigthFactors;
 
@@ -126,6 +133,17 @@ namespace pod
              slnType = sType;
              return *this;
         }
+
+        virtual UpdateType getUpdateType() const
+        {
+            return updateType;
+        }
+
+        virtual EquationComposer& setUpdateType(UpdateType uType)
+        {
+            updateType = uType;
+            return *this;
+        }
         
         /// add new equation to equation list
         virtual EquationComposer& addEquation(std::unique_ptr<EquationBase> eq)
@@ -181,6 +199,9 @@ namespace pod
 		//desired solution type
         SlnType slnType;
 
+        //measurement update strategy
+        UpdateType updateType = Information;
+
     };
 
     typedef std::shared_ptr<pod::EquationComposer> eqComposer_sptr;
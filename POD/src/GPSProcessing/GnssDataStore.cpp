@@ -59,100 +59,165 @@ namespace pod
     {
         try
         {
-            initReader(path);
+            loadOpts(path);
+            loadProducts();
+            initSite();
+        }
+        catch (const Exception& e)
+        {
+            std::cout << "Failed to load input data. An error has occured: " << e.what() << std::endl;
+            exit(-1);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "Failed to load input data: An error has occured: " << e.what() << std::endl;
+            exit(-1);
+        }
+    }
 
-            opts.workingDir = fs::path(path).parent_path().string();
-            
-            opts.isSpaceborneRcv = confReader->getValueAsBoolean("IsSpaceborneRcv");
-            
-            opts.isSmoothCode = confReader->getValueAsBoolean("IsSmoothCode");
-            
-            opts.computeTropo = confReader->getValueAsBoolean("computeTropo");
+    void  GnssDataStore::LoadProducts(const char* path)
+    {
+        try
+        {
+            loadOpts(path);
+            loadProducts();
+        }
+        catch (const Exception& e)
+        {
+            std::cout << "Failed to load input data. An error has occured: " << e.what() << std::endl;
+            exit(-1);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "Failed to load input data: An error has occured: " << e.what() << std::endl;
+            exit(-1);
+        }
+    }
 
-            opts.tropoModelType = (TropoModelType)confReader->getValueAsInt("tropoModelType");
-            
-            opts.maskEl = confReader->getValueAsDouble("ElMask");
-            
-            opts.maskSNR = confReader->getValueAsDouble("SNRmask");
-            
-            opts.dynamics = (Dynamics)confReader->getValueAsInt("Dynamics");
-           
-            opts.bceDir = confReader->getValue("RinexNavFilesDir");
+    void  GnssDataStore::LoadProducts()
+    {
+        loadProducts();
+    }
 
-            opts.SiteRover = confReader->getValue("SiteRover");
+    void  GnssDataStore::LoadSiteData(const char* path, const std::string& siteID)
+    {
+        try
+        {
+            loadOpts(path);
+            opts.SiteRover = siteID;
+            initSite();
+        }
+        catch (const Exception& e)
+        {
+            std::cout << "Failed to load data of site " << siteID << ". An error has occured: " << e.what() << std::endl;
+            exit(-1);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "Failed to load data of site " << siteID << ": An error has occured: " << e.what() << std::endl;
+            exit(-1);
+        }
+    }
 
-            opts.SiteBase = confReader->getValue("SiteBase");
+    void  GnssDataStore::loadOpts(const char* path)
+    {
+        initReader(path);
 
-            opts.fullOutput = confReader->getValueAsBoolean("fullOutput");
+        opts.workingDir = fs::path(path).parent_path().string();
+        
+        opts.isSpaceborneRcv = confReader->getValueAsBoolean("IsSpaceborneRcv");
+        
+        opts.isSmoothCode = confReader->getValueAsBoolean("IsSmoothCode");
+        
+        opts.computeTropo = confReader->getValueAsBoolean("computeTropo");
 
-            opts.slnType = (SlnType)confReader->getValueAsInt("slnType");
-            std::cout << "Solution Type: " << slnType2Str[opts.slnType] << std::endl;
+        opts.tropoModelType = (TropoModelType)confReader->getValueAsInt("tropoModelType");
+        
+        opts.maskEl = confReader->getValueAsDouble("ElMask");
+        
+        opts.maskSNR = confReader->getValueAsDouble("SNRmask");
+        
+        opts.dynamics = (Dynamics)confReader->getValueAsInt("Dynamics");
+       
+        opts.bceDir = confReader->getValue("RinexNavFilesDir");
 
-            //set generic files direcory 
-            std::string subdir = confReader->getValue("GenericFilesDir");
-            opts.genericFilesDirectory = opts.workingDir + "\\" + subdir + "\\";
+        opts.SiteRover = confReader->getValue("SiteRover");
 
-            for (auto it : confReader->getListValueAsInt("carrierBands"))
-                opts.carrierBands.insert(static_cast<CarrierBand>(it));
+        opts.SiteBase = confReader->getValue("SiteBase");
 
-            std::cout << "Used Carrier bands: ";
-            for_each(opts.carrierBands.begin(), opts.carrierBands.end(), [](auto && it) { std::cout << carrierBand2Str[it] << " "; });
-            std::cout << std::endl;
+        opts.fullOutput = confReader->getValueAsBoolean("fullOutput");
 
-            for (auto it : confReader->getListValueAsInt("satSystems"))
-                opts.systems.insert(static_cast<SatID::SatelliteSystem>(it));
+        opts.slnType = (SlnType)confReader->getValueAsInt("slnType");
+        std::cout << "Solution Type: " << slnType2Str[opts.slnType] << std::endl;
 
-            std::cout << "Used Sat. Systems: ";
-            for_each(opts.systems.begin(), opts.systems.end(), [](auto && ss) { std::cout << SatID::convertSatelliteSystemToString(ss) << " "; });
-            std::cout << std::endl;
+        //set generic files direcory 
+        std::string subdir = confReader->getValue("GenericFilesDir");
+        opts.genericFilesDirectory = opts.workingDir + "\\" + subdir + "\\";
 
-            std::cout << "Ephemeris Loading... ";
-            std::cout << loadEphemeris() << std::endl;
+        for (auto it : confReader->getListValueAsInt("carrierBands"))
+            opts.carrierBands.insert(static_cast<CarrierBand>(it));
 
-            //opts.isComputeApprPos = confReader->getValueAsBoolean("calcApprPos");
-            //if (opts.isComputeApprPos)
-            //    apprPosFile = confReader->getValue("apprPosFile");
+        std::cout << "Used Carrier bands: ";
+        for_each(opts.carrierBands.begin(), opts.carrierBands.end(), [](auto && it) { std::cout << carrierBand2Str[it] << " "; });
+        std::cout << std::endl;
 
-            //load clock data from RINEX clk files, if required
-            if (confReader->getValueAsBoolean("UseRinexClock"))
-            {
-#if !_DEBUG
-                std::cout << "Load Rinex clock data ... ";
-                std::cout << loadClocks() << std::endl;
-#endif
-            }
+        for (auto it : confReader->getListValueAsInt("satSystems"))
+            opts.systems.insert(static_cast<SatID::SatelliteSystem>(it));
 
-            std::cout << "Load ionospheric data ... ";
-            std::cout << loadIono() << std::endl;
+        std::cout << "Used Sat. Systems: ";
+        for_each(opts.systems.begin(), opts.systems.end(), [](auto && ss) { std::cout << SatID::convertSatelliteSystemToString(ss) << " "; });
+        std::cout << std::endl;
+    }
 
-            std::cout << "Load Glonass FCN data... ";
-            std::cout << loadFcn() << std::endl;
+    void  GnssDataStore::loadProducts()
+    {
+        std::cout << "Ephemeris Loading... ";
+        std::cout << loadEphemeris() << std::endl;
 
-            std::cout << "Load Earth orientation data... ";
-            std::cout << loadEOPData() << std::endl;
+        //opts.isComputeApprPos = confReader->getValueAsBoolean("calcApprPos");
+        //if (opts.isComputeApprPos)
+        //    apprPosFile = confReader->getValue("apprPosFile");
 
-			std::cout << "Appr. position  source: ";
-			if (createPosProvider())
-				std::cout << IApprPosProvider::posSource2Str[apprPos->getSource()] << std::endl;
-        }
-        catch (const Exception& e)
-        {
-            std::cout << "Failed to load input data. An error has occured: " << e.what() << std::endl;
-            exit(-1);
-        }
-        catch (const std::exception& e)
+        //load clock data from RINEX clk files, if required
+        if (confReader->getValueAsBoolean("UseRinexClock"))
         {
-            std::cout << "Failed to load input data: An error has occured: " << e.what() << std::endl;
-            exit(-1);
+#if !_DEBUG
+            std::cout << "Load Rinex clock data ... ";
+            std::cout << loadClocks() << std::endl;
+#endif
         }
+
+        // all precise orbits and clocks are in; switch the tables
+        // to the flat read-only layout used for interpolation
+        SP3EphList.freeze();
+
+        std::cout << "Load ionospheric data ... ";
+        std::cout << loadIono() << std::endl;
+
+        std::cout << "Load Glonass FCN data... ";
+        std::cout << loadFcn() << std::endl;
+
+        std::cout << "Load Earth orientation data... ";
+        std::cout << loadEOPData() << std::endl;
+
+        products->loaded = true;
+    }
+
+    void  GnssDataStore::initSite()
+    {
+        initIonoCorrector();
+
+        std::cout << "Appr. position  source: ";
+        if (createPosProvider())
+            std::cout << IApprPosProvider::posSource2Str[apprPos->getSource()] << std::endl;
     }
 
-	
     //
     bool GnssDataStore::loadEphemeris()
     {
         // Set flags to reject satellites with bad or absent positional values or clocks
         SP3EphList.clear();
+        products->productFiles.clear();
         SP3EphList.rejectBadPositions(true);
         SP3EphList.rejectBadClocks(true);
 
@@ -172,6 +237,7 @@ namespace pod
             try
             {
                 SP3EphList.loadFile(file);
+                products->productFiles.insert(file);
             }
             catch (FileMissingException& e)
             {
@@ -197,6 +263,7 @@ namespace pod
             try
             {
                 SP3EphList.loadRinexClockFile(file);
+                products->productFiles.insert(file);
             }
             catch (FileMissingException& e)
             {
@@ -209,6 +276,52 @@ namespace pod
         return files.size() > 0;
     }
 
+    int GnssDataStore::refreshProducts()
+    {
+        bool frozen = SP3EphList.isFrozen();
+        if (frozen)
+            SP3EphList.thaw();
+
+        int n = loadNewFiles(confReader->getValue("EphemerisDir"), false);
+        if (confReader->getValueAsBoolean("UseRinexClock"))
+            n += loadNewFiles(confReader->getValue("RinexClockDir"), true);
+
+        if (frozen)
+            SP3EphList.freeze();
+        return n;
+    }
+
+    int GnssDataStore::loadNewFiles(const std::string& subdir, bool isClock)
+    {
+        std::list<std::string> files;
+        FsUtils::getAllFilesInDir(opts.workingDir + "\\" + subdir, files);
+
+        int n = 0;
+        for (auto file : files)
+        {
+            if (products->productFiles.count(file))
+                continue;
+            // a file still being written is skipped, and loaded
+            // by a later refresh
+            try
+            {
+                if (isClock)
+                    SP3EphList.loadRinexClockFile(file);
+                else
+                    SP3EphList.loadFile(file);
+
+                products->productFiles.insert(file);
+                ++n;
+            }
+            catch (Exception& e)
+            {
+                std::cerr << "Can't load product file '" << file << "': "
+                    << e.what() << std::endl;
+            }
+        }
+        return n;
+    }
+
     bool  GnssDataStore::loadIono()
     {
         bool isIonexLoaded = loadIonoMap();
@@ -216,26 +329,40 @@ namespace pod
         auto type = (ComputeIonoModel::IonoModelType)confReader->getValueAsInt("CodeIonoCorrType");
         switch (type)
         {
-        case gpstk::ComputeIonoModel::Zero:
-            ionoCorrector.setZeroModel();
-            break;
         case gpstk::ComputeIonoModel::Klobuchar:
             if (!loadBceIonoModel())
                 GPSTK_THROW(InvalidRequest("Can't load iono model from Rinex GPS Navigation files."));
             break;
         case gpstk::ComputeIonoModel::Ionex:
-            if (isIonexLoaded)
-                ionoCorrector.setIonosphereMap(ionexStore);
-            else
+            if (!isIonexLoaded)
                 GPSTK_THROW(InvalidRequest("Can't load Ionosphere map from Ionex files."));
             break;
+        default:
+            break;
+        }
+        return true;
+    }
+
+    void  GnssDataStore::initIonoCorrector()
+    {
+        auto type = (ComputeIonoModel::IonoModelType)confReader->getValueAsInt("CodeIonoCorrType");
+        switch (type)
+        {
+        case gpstk::ComputeIonoModel::Zero:
+            ionoCorrector.setZeroModel();
+            break;
+        case gpstk::ComputeIonoModel::Klobuchar:
+            ionoCorrector.setKlobucharModel(bceIonoStore);
+            break;
+        case gpstk::ComputeIonoModel::Ionex:
+            ionoCorrector.setIonosphereMap(ionexStore);
+            break;
         case gpstk::ComputeIonoModel::DualFreq:
             ionoCorrector.setDualFreqModel();
             break;
         default:
             GPSTK_THROW(InvalidRequest("Unknown Ionospheric model type."));
         }
-        return true;
     }
 
     bool GnssDataStore::loadIonoMap()
@@ -339,9 +466,6 @@ namespace pod
                 exit(-1);
             }
         }
-        
-        //
-        ionoCorrector.setKlobucharModel(bceIonoStore);
 
         return  i > 0;
     }
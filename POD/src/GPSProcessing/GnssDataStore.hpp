@@ -15,6 +15,7 @@
 #include<memory>
 #include<string>
 #include<map>
+#include<set>
 
 namespace pod
 { 
@@ -50,6 +51,32 @@ namespace pod
     extern std::map<SlnType, std::string>  slnType2Str;
     extern std::map<CarrierBand, std::string> carrierBand2Str;
 
+    // Products shared by all the sites processed with them. They are
+    // loaded once, by GnssDataStore::loadProducts(), and only read (from
+    // several threads, in a batch) afterwards.
+    struct GnssProducts
+    {
+            //object to handle precise ephemeris and clocks
+        gpstk::SP3EphemerisStore SP3EphList;
+
+            //Earth orintation parameters store
+        gpstk::EOPStore eopStore;
+
+            //GPS Navigation Message based ionospheric models store
+        gpstk::IonoModelStore bceIonoStore;
+
+            //ionosphere map store
+        gpstk::IonexStore ionexStore;
+
+            //SP3 and RINEX clock files loaded to SP3EphList
+        std::set<std::string> productFiles;
+
+            //have the products been loaded?
+        bool loaded = false;
+    };
+
+    typedef std::shared_ptr<GnssProducts> GnssProducts_sptr;
+
     //class to store processing configuration and input data  
     struct GnssDataStore
     {
@@ -63,7 +90,19 @@ namespace pod
         static Initializer GnssDataInitializer;
 
 #pragma region Constructors
-    public: GnssDataStore(gpstk::ConfDataReader& confReader) :confReader(&confReader)
+    public: GnssDataStore(gpstk::ConfDataReader& confReader)
+        : GnssDataStore(confReader, std::make_shared<GnssProducts>())
+    {
+    }
+
+            // Data store using 'products' loaded by another data store
+    public: GnssDataStore(gpstk::ConfDataReader& confReader, GnssProducts_sptr products)
+        : confReader(&confReader),
+          products(products),
+          SP3EphList(products->SP3EphList),
+          eopStore(products->eopStore),
+          bceIonoStore(products->bceIonoStore),
+          ionexStore(products->ionexStore)
     {
     }
 
@@ -78,7 +117,28 @@ namespace pod
     public: void checkObservable();
     public: void LoadData(const char* path);
 
+            // Loads only the products, to be shared by other data stores
+    public: void LoadProducts(const char* path);
+
+            // Loads the products with the options loaded already,
+            // e.g. by LoadSiteData()
+    public: void LoadProducts();
+
+            // Loads the configuration of site 'siteID'; the products
+            // must have been loaded already
+    public: void LoadSiteData(const char* path, const std::string& siteID);
+
+            // Loads the SP3 and RINEX clock files added to the product
+            // directories since the products were loaded, e.g. by a
+            // real-time product feed; returns the number of files loaded.
+            // The products must not be read by other threads meanwhile.
+    public: int refreshProducts();
+
     private: bool initReader(const char* path);
+    private: void loadProducts();
+    private: void loadOpts(const char* path);
+    private: void initSite();
+    private: void initIonoCorrector();
 
     private: bool loadIono();
     private: bool loadBceIonoModel();
@@ -87,6 +147,7 @@ namespace pod
     private: bool loadEphemeris();
     private: bool loadFcn();
     private: bool loadClocks();
+    private: int loadNewFiles(const std::string& subdir, bool isClock);
     private: bool loadEOPData();
     private: bool loadCodeBiades();
 	private: bool createPosProvider();
@@ -100,17 +161,20 @@ namespace pod
              // pointer to  configuration file reader
     public: gpstk::ConfDataReader* confReader;
 
+            //products, possibly shared with other data stores
+    public: GnssProducts_sptr products;
+
             //object to handle precise ephemeris and clocks
-    public: gpstk::SP3EphemerisStore SP3EphList;
+    public: gpstk::SP3EphemerisStore& SP3EphList;
 
             //Earth orintation parameters store
-    public: gpstk::EOPStore eopStore;
+    public: gpstk::EOPStore& eopStore;
 
             //GPS Navigation Message based ionospheric models store
-    public: gpstk::IonoModelStore bceIonoStore;
+    public: gpstk::IonoModelStore& bceIonoStore;
 
             //ionosphere map store
-    public: gpstk::IonexStore ionexStore;
+    public: gpstk::IonexStore& ionexStore;
 
             // compute the  values related to a given GNSS ionospheric model.
     public: gpstk::ComputeIonoModel ionoCorrector;
@@ -68,39 +68,82 @@ namespace pod
 
     void GnssEpochMap::updateMetadata()
     {
-        svs.clear();
-        slnTypes.clear();
-        types.clear();
-        types.insert(TypeID::recSlnType);
+        if (numSpilled == 0)
+        {
+            svs.clear();
+            slnTypes.clear();
+            types.clear();
+        }
 
         for (auto && epoch : data)
+            addMetadata(epoch.second);
+    }
+
+    void GnssEpochMap::addMetadata(GnssEpoch& ep)
+    {
+        types.insert(TypeID::recSlnType);
+
+        for (auto && svRcord : ep.satData)
         {
-            for (auto && svRcord : epoch.second.satData)
-            {
-                //update list of SV 
-                svs.insert(svRcord.first);
-                //update list of typeID 
-                for (const auto & data : svRcord.second)
-                    types.insert(data.first);
-            }
-
-            //update list of  typeID
-            for (auto && data : epoch.second.slnData)
+            //update list of SV 
+            svs.insert(svRcord.first);
+            //update list of typeID 
+            for (const auto & data : svRcord.second)
                 types.insert(data.first);
-            //update list of Solution types
-            const auto& st = epoch.second.slnData.find(TypeID::recSlnType);
+        }
 
-            if (st == epoch.second.slnData.end())
-            {
-                epoch.second.slnData[TypeID::recSlnType] = 0;
-                slnTypes.insert(0);
-            }
-                
-            else
-                slnTypes.insert(st->second);
+        //update list of  typeID
+        for (auto && data : ep.slnData)
+            types.insert(data.first);
+        //update list of Solution types
+        const auto& st = ep.slnData.find(TypeID::recSlnType);
+
+        if (st == ep.slnData.end())
+        {
+            ep.slnData[TypeID::recSlnType] = 0;
+            slnTypes.insert(0);
+        }
+        else
+            slnTypes.insert(st->second);
+    }
+
+    void GnssEpochMap::add(const CommonTime& t, GnssEpoch ep)
+    {
+        data.insert(std::make_pair(t, std::move(ep)));
+
+        if (maxEpochs > 0 && data.size() > maxEpochs && !sinks.empty() && !flushed)
+            spill(maxEpochs);
+    }
+
+    void GnssEpochMap::spill(size_t keep)
+    {
+        while (data.size() > keep)
+        {
+            auto it = data.begin();
+            addMetadata(it->second);
+            for (auto& sink : sinks)
+                sink->write(it->first, it->second);
+
+            if (numSpilled == 0)
+                firstSpilled = it->first;
+            lastSpilled = it->first;
+            ++numSpilled;
+
+            data.erase(it);
         }
     }
 
+    void GnssEpochMap::flush()
+    {
+        if (sinks.empty() || flushed)
+            return;
+
+        spill(0);
+        for (auto& sink : sinks)
+            sink->close(*this);
+        flushed = true;
+    }
+
     /// Method to print data values
     std::ostream& GnssEpochMap::dump(std::ostream& s, int precision)
     {
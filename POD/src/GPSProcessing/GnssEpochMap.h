@@ -5,6 +5,9 @@
 #include"CommonTime.hpp"
 #include"Position.hpp"
 
+#include<memory>
+#include<vector>
+
 namespace pod
 {
     struct GnssEpoch
@@ -25,17 +28,85 @@ namespace pod
   
     };
 
+    struct GnssEpochMap;
+
+    // Receives the epochs spilled from a GnssEpochMap (see GnssEpochMap::add)
+    class GnssEpochSink
+    {
+    public:
+        virtual ~GnssEpochSink() {}
+
+        // epoch 't' is final and leaves the memory
+        virtual void write(const gpstk::CommonTime& t, const GnssEpoch& ep) = 0;
+
+        // all the epochs are written; 'eMap' holds the metadata of all of them
+        virtual void close(const GnssEpochMap& eMap) {}
+    };
+
     struct GnssEpochMap
     {
         GnssEpochMap();
 
+        GnssEpochMap(const GnssEpochMap&) = default;
+        GnssEpochMap(GnssEpochMap&&) = default;
+
+        GnssEpochMap& operator=(const GnssEpochMap&) = default;
+        GnssEpochMap& operator=(GnssEpochMap&&) = default;
+
         ~GnssEpochMap();
 
         //dump object to a stream
         std::ostream& dump(std::ostream& s, int precision = 4);
         
+        // Updates svs, slnTypes and types; those of the spilled epochs are kept
         void updateMetadata();
 
+        // Adds a final epoch. If sinks are set, the oldest epochs beyond
+        // getMaxEpochs() are written to them and removed from 'data', so
+        // that the memory used doesn't grow with the length of the arc.
+        // Epochs which are revisited later (e.g. by a smoother) must be
+        // inserted in 'data' directly.
+        void add(const gpstk::CommonTime& t, GnssEpoch ep);
+
+        // Epochs to keep in memory; 0 (the default) keeps all of them
+        GnssEpochMap& setMaxEpochs(size_t n)
+        {
+            maxEpochs = n;
+            return *this;
+        }
+
+        size_t getMaxEpochs() const
+        {
+            return maxEpochs;
+        }
+
+        GnssEpochMap& addSink(std::shared_ptr<GnssEpochSink> sink)
+        {
+            sinks.push_back(sink);
+            return *this;
+        }
+
+        // the first sink of type T, if any
+        template<class T>
+        std::shared_ptr<T> findSink() const
+        {
+            for (const auto& it : sinks)
+                if (auto p = std::dynamic_pointer_cast<T>(it))
+                    return p;
+            return nullptr;
+        }
+
+        // Writes all the epochs left to the sinks and closes them;
+        // afterwards only the metadata are left, and the epochs added
+        // are kept in memory.
+        void flush();
+
+        // number of epochs written to the sinks
+        size_t spilled() const
+        {
+            return numSpilled;
+        }
+
         std::string title;
 
         //all sv in data 
@@ -91,28 +162,43 @@ namespace pod
             return data.rend();
         };
 
+        // first and last epoch, including the spilled ones
         gpstk::CommonTime getInitialTime() const
         {
-            if (data.size() == 0)
+            if (size() == 0)
                 GPSTK_THROW(gpstk::InvalidRequest("GnssEpochMap objects contais no elements"));
 
-            return begin()->first;
+            return numSpilled ? firstSpilled : begin()->first;
         }
 
         gpstk::CommonTime getFinalTime() const
         {
-            if (data.size() == 0)
+            if (size() == 0)
                 GPSTK_THROW(gpstk::InvalidRequest("GnssEpochMap objects contais no elements"));
 
-            return rbegin()->first;
+            return data.empty() ? lastSpilled : rbegin()->first;
         }
 
+        // number of epochs, including the spilled ones
         size_t size() const
         {
-            return data.size();
+            return data.size() + numSpilled;
         }
 
     protected: void updateTypes(const gpstk::TypeIDSet & types);
+
+               // adds the SV, types and solution type of 'ep' to the metadata
+    protected: void addMetadata(GnssEpoch& ep);
+
+               // writes the oldest epochs to the sinks, keeping 'keep' of them
+    protected: void spill(size_t keep);
+
+    protected: std::vector<std::shared_ptr<GnssEpochSink>> sinks;
+    protected: size_t maxEpochs = 0;
+    protected: size_t numSpilled = 0;
+    protected: bool flushed = false;
+    protected: gpstk::CommonTime firstSpilled;
+    protected: gpstk::CommonTime lastSpilled;
     };
 
 } 
@@ -0,0 +1,380 @@
+#include "KalmanSmoother.h"
+#include"MatrixKernels.hpp"
+
+#include<map>
+
+#ifdef _WIN32
+#define POD_FSEEK _fseeki64
+#else
+#define POD_FSEEK fseeko
+#endif
+
+using namespace std;
+using namespace gpstk;
+
+namespace pod
+{
+    KalmanSmoother::Layout::Layout(size_t size, size_t nPhi)
+        :n(size)
+    {
+        size_t nP = n * (n + 1) / 2;
+        params = headerSize;
+        map = params + 3 * n;
+        x = map + n;
+        P = x + n;
+        xPred = P + nP;
+        PPred = xPred + n;
+        phi = PPred + nP;
+        length = phi + 3 * nPhi;
+    }
+
+    KalmanSmoother::Layout::Layout(const double* header)
+    {
+        *this = Layout(size_t(header[4]), size_t(header[6]));
+    }
+
+    KalmanSmoother::KalmanSmoother()
+        :spillFile(nullptr), length(0), smoothed(false)
+    {}
+
+    KalmanSmoother::~KalmanSmoother()
+    {
+        if (spillFile)
+            fclose(spillFile);
+    }
+
+    KalmanSmoother& KalmanSmoother::setSpillToDisk(bool spill)
+    {
+        clear();
+        if (spill && !spillFile)
+        {
+            spillFile = tmpfile();
+            if (!spillFile)
+            {
+                Exception e("KalmanSmoother: can't create temporary file");
+                GPSTK_THROW(e);
+            }
+        }
+        else if (!spill && spillFile)
+        {
+            fclose(spillFile);
+            spillFile = nullptr;
+        }
+        return *this;
+    }
+
+    void KalmanSmoother::clear()
+    {
+        staged.clear();
+        lastParams.clear();
+        log.clear();
+        offsets.clear();
+        length = 0;
+        smoothed = false;
+        if (spillFile)
+            rewind(spillFile);
+    }
+
+    void KalmanSmoother::pack(const Matrix<double>& P, double* dst)
+    {
+        for (size_t j = 0; j < P.cols(); j++)
+            for (size_t i = 0; i <= j; i++)
+                *dst++ = P(i, j);
+    }
+
+    void KalmanSmoother::unpack(const double* src, Matrix<double>& P)
+    {
+        for (size_t j = 0; j < P.cols(); j++)
+            for (size_t i = 0; i <= j; i++)
+                P(i, j) = P(j, i) = *src++;
+    }
+
+    void KalmanSmoother::stagePrediction(const CommonTime& t,
+                                         const ParametersSet& unknowns,
+                                         const EquationComposer::FilterState& carried,
+                                         bool linked,
+                                         const Matrix<double>& phi,
+                                         const Vector<double>& xPredicted,
+                                         const Matrix<double>& pPredicted)
+    {
+        size_t n = unknowns.size();
+        if (phi.rows() != n || xPredicted.size() != n || pPredicted.rows() != n)
+        {
+            InvalidRequest e("KalmanSmoother: prediction doesn't match the unknowns");
+            GPSTK_THROW(e);
+        }
+
+        size_t nPhi(0);
+        for (size_t j = 0; j < n; j++)
+            for (size_t i = 0; i < n; i++)
+                if (phi(i, j) != 0.0)
+                    nPhi++;
+
+        Layout l(n, nPhi);
+        staged.assign(l.length, 0.0);
+
+        long day, sod;
+        double fsod;
+        TimeSystem ts;
+        t.get(day, sod, fsod, ts);
+        staged[0] = day;
+        staged[1] = sod;
+        staged[2] = fsod;
+        staged[3] = static_cast<int>(ts.getTimeSystem());
+        staged[4] = n;
+        staged[5] = (linked && !offsets.empty()) ? 1 : 0;
+        staged[6] = nPhi;
+
+        std::map<FilterParameter, size_t> prevIndex;
+        if (staged[5] != 0)
+            for (size_t j = 0; j < lastParams.size(); j++)
+                prevIndex[lastParams[j]] = j;
+
+        size_t k(0);
+        for (const auto& par : unknowns)
+        {
+            staged[l.params + 3 * k] = par.type.type;
+            staged[l.params + 3 * k + 1] = par.sv.id;
+            staged[l.params + 3 * k + 2] = par.sv.system;
+
+            //index in the previous record, or -1 for a new unknown
+            double prev(-1);
+            auto it = prevIndex.find(par);
+            if (it != prevIndex.end() && carried.find(par) != carried.end())
+                prev = it->second;
+            staged[l.map + k] = prev;
+
+            staged[l.xPred + k] = xPredicted(k);
+            k++;
+        }
+        pack(pPredicted, &staged[l.PPred]);
+
+        double* p = &staged[l.phi];
+        for (size_t j = 0; j < n; j++)
+            for (size_t i = 0; i < n; i++)
+                if (phi(i, j) != 0.0)
+                {
+                    *p++ = i;
+                    *p++ = j;
+                    *p++ = phi(i, j);
+                }
+    }
+
+    void KalmanSmoother::commitUpdate(const Vector<double>& xFiltered,
+                                      const Matrix<double>& pFiltered)
+    {
+        if (staged.empty())
+            return;
+
+        Layout l(&staged[0]);
+        if (xFiltered.size() != l.n || pFiltered.rows() != l.n)
+        {
+            InvalidRequest e("KalmanSmoother: update doesn't match the prediction");
+            GPSTK_THROW(e);
+        }
+
+        for (size_t i = 0; i < l.n; i++)
+            staged[l.x + i] = xFiltered(i);
+        pack(pFiltered, &staged[l.P]);
+
+        lastParams.resize(l.n);
+        for (size_t i = 0; i < l.n; i++)
+        {
+            const double* par = &staged[l.params + 3 * i];
+            lastParams[i] = FilterParameter(TypeID(TypeID::ValueType(int(par[0]))),
+                SatID(int(par[1]), SatID::SatelliteSystem(int(par[2]))));
+        }
+
+        offsets.push_back(length);
+        write(length, &staged[0], l.length);
+        length += l.length;
+        staged.clear();
+        smoothed = false;
+    }
+
+    void KalmanSmoother::write(size_t offset, const double* src, size_t count)
+    {
+        if (spillFile)
+        {
+            if (POD_FSEEK(spillFile, offset * sizeof(double), SEEK_SET) != 0 ||
+                fwrite(src, sizeof(double), count, spillFile) != count)
+            {
+                Exception e("KalmanSmoother: can't write temporary file");
+                GPSTK_THROW(e);
+            }
+        }
+        else
+        {
+            if (log.size() < offset + count)
+                log.resize(offset + count);
+            std::copy(src, src + count, log.begin() + offset);
+        }
+    }
+
+    void KalmanSmoother::read(size_t offset, double* dst, size_t count) const
+    {
+        if (spillFile)
+        {
+            if (POD_FSEEK(spillFile, offset * sizeof(double), SEEK_SET) != 0 ||
+                fread(dst, sizeof(double), count, spillFile) != count)
+            {
+                Exception e("KalmanSmoother: can't read temporary file");
+                GPSTK_THROW(e);
+            }
+        }
+        else
+            std::copy(log.begin() + offset, log.begin() + offset + count, dst);
+    }
+
+    void KalmanSmoother::load(size_t i, std::vector<double>& rec) const
+    {
+        double header[headerSize];
+        read(offsets.at(i), header, headerSize);
+        Layout l(&header[0]);
+        rec.resize(l.length);
+        read(offsets[i], &rec[0], l.length);
+    }
+
+    CommonTime KalmanSmoother::getEpoch(size_t i) const
+    {
+        double header[headerSize];
+        read(offsets.at(i), header, headerSize);
+        CommonTime t;
+        t.set(long(header[0]), long(header[1]), header[2],
+            TimeSystem(TimeSystem::Systems(int(header[3]))));
+        return t;
+    }
+
+    void KalmanSmoother::getState(size_t i, ParametersSet& unknowns,
+                                  Vector<double>& x, Matrix<double>& P) const
+    {
+        std::vector<double> rec;
+        load(i, rec);
+        Layout l(&rec[0]);
+
+        unknowns.clear();
+        for (size_t k = 0; k < l.n; k++)
+        {
+            const double* par = &rec[l.params + 3 * k];
+            unknowns.insert(FilterParameter(TypeID(TypeID::ValueType(int(par[0]))),
+                SatID(int(par[1]), SatID::SatelliteSystem(int(par[2])))));
+        }
+
+        x.resize(l.n);
+        for (size_t k = 0; k < l.n; k++)
+            x(k) = rec[l.x + k];
+        P.resize(l.n, l.n);
+        unpack(&rec[l.P], P);
+    }
+
+    // For the link between records k-1 and k, with F = Phi*A the transition
+    // from the unknowns of k-1 to those of k (A selects the carried unknowns):
+    //   C = Pf(k-1) * F^T * Pp(k)^-1
+    //   xs(k-1) = xf(k-1) + C * (xs(k) - xp(k))
+    //   Ps(k-1) = Pf(k-1) + C * (Ps(k) - Pp(k)) * C^T
+    void KalmanSmoother::smooth()
+    {
+        if (smoothed || offsets.size() < 2)
+        {
+            smoothed = true;
+            return;
+        }
+
+        std::vector<double> cur, prev;
+        Matrix<double> Pf, Pp, Ps, G, C, T;
+        Vector<double> row, dx;
+
+        load(offsets.size() - 1, cur);
+        for (size_t k = offsets.size() - 1; k > 0; k--)
+        {
+            load(k - 1, prev);
+            Layout lc(&cur[0]);
+            Layout lp(&prev[0]);
+
+            if (cur[5] != 0)
+            {
+                size_t n(lc.n), m(lp.n);
+                Pf.resize(m, m);
+                unpack(&prev[lp.P], Pf);
+                Pp.resize(n, n);
+                unpack(&cur[lc.PPred], Pp);
+                Ps.resize(n, n);
+                unpack(&cur[lc.P], Ps);
+
+                // G = Pf * F^T, column i is the sum of phi(i,l) times the
+                // column of Pf of the predecessor of unknown l
+                G.resize(m, n);
+                G = 0.0;
+                const double* p = &cur[lc.phi];
+                for (size_t e = 0; e < size_t(cur[6]); e++, p += 3)
+                {
+                    size_t i = static_cast<size_t>(p[0]);
+                    double prevIdx = cur[lc.map + static_cast<size_t>(p[1])];
+                    if (prevIdx < 0)
+                        continue;
+                    size_t j = static_cast<size_t>(prevIdx);
+                    for (size_t r = 0; r < m; r++)
+                        G(r, i) += p[2] * Pf(r, j);
+                }
+
+                bool ok(true);
+                try
+                {
+                    // C = G * Pp^-1, row by row
+                    choleskyFactor(Pp);
+                    C.resize(m, n);
+                    row.resize(n);
+                    for (size_t r = 0; r < m; r++)
+                    {
+                        for (size_t i = 0; i < n; i++)
+                            row(i) = G(r, i);
+                        choleskySolve(Pp, row);
+                        for (size_t i = 0; i < n; i++)
+                            C(r, i) = row(i);
+                    }
+                }
+                catch (const MatrixException&)
+                {
+                    // the filtered state of k-1 is kept
+                    ok = false;
+                }
+
+                if (ok)
+                {
+                    // Ps - Pp (Pp holds its factor now)
+                    unpack(&cur[lc.PPred], Pp);
+                    dx.resize(n);
+                    for (size_t i = 0; i < n; i++)
+                        dx(i) = cur[lc.x + i] - cur[lc.xPred + i];
+                    for (size_t j = 0; j < n; j++)
+                        for (size_t i = 0; i < n; i++)
+                            Ps(i, j) -= Pp(i, j);
+
+                    for (size_t r = 0; r < m; r++)
+                    {
+                        double sum(0.0);
+                        for (size_t i = 0; i < n; i++)
+                            sum += C(r, i) * dx(i);
+                        prev[lp.x + r] += sum;
+                    }
+
+                    // Pf += C * (Ps - Pp) * C^T, upper triangle
+                    T = C * Ps;
+                    double* pp = &prev[lp.P];
+                    for (size_t j = 0; j < m; j++)
+                        for (size_t i = 0; i <= j; i++)
+                        {
+                            double sum(0.0);
+                            for (size_t c = 0; c < n; c++)
+                                sum += T(i, c) * C(j, c);
+                            *pp++ += sum;
+                        }
+
+                    write(offsets[k - 1] + lp.x, &prev[lp.x], lp.xPred - lp.x);
+                }
+            }
+            cur.swap(prev);
+        }
+        smoothed = true;
+    }
+}
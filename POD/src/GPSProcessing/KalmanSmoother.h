@@ -0,0 +1,134 @@
+#pragma once
+#include"EquationComposer.h"
+#include"FilterParameter.h"
+#include"CommonTime.hpp"
+#include"Matrix.hpp"
+
+#include<cstdio>
+#include<vector>
+
+namespace pod
+{
+    //Rauch-Tung-Striebel smoother for the Kalman filter of KalmanSolver.
+    //
+    //During the forward pass the filter hands over, for every epoch, its
+    //prediction (state transition matrix, predicted state and covariance)
+    //and its update (filtered state and covariance). Each epoch is kept as
+    //one flat record of doubles (covariances as upper triangles, the state
+    //transition matrix as its non-zero elements), either in memory or in a
+    //temporary file. smooth() then runs a single backward pass, replacing
+    //the filtered state and covariance of every record by the smoothed ones.
+    //
+    //The set of unknowns may change from epoch to epoch: unknowns carried
+    //over from the previous epoch are matched by FilterParameter, new ones
+    //have no predecessor. An epoch which starts a new filter segment (after
+    //a reset) is not linked to the previous one.
+    class KalmanSmoother
+    {
+    public:
+
+        KalmanSmoother();
+
+        virtual ~KalmanSmoother();
+
+        KalmanSmoother(const KalmanSmoother&) = delete;
+        KalmanSmoother& operator=(const KalmanSmoother&) = delete;
+
+        //keep the records in a temporary file instead of memory;
+        //clears the records stored so far
+        KalmanSmoother& setSpillToDisk(bool spill);
+
+        bool getSpillToDisk() const
+        {
+            return spillFile != nullptr;
+        }
+
+        //record the prediction of epoch 't'; 'carried' holds the unknowns
+        //whose prior values were taken from the previous epoch, 'linked' is
+        //false if the filter was (re)initialized at this epoch.
+        //Replaces any prediction not yet committed.
+        void stagePrediction(const gpstk::CommonTime& t,
+                             const ParametersSet& unknowns,
+                             const EquationComposer::FilterState& carried,
+                             bool linked,
+                             const gpstk::Matrix<double>& phi,
+                             const gpstk::Vector<double>& xPredicted,
+                             const gpstk::Matrix<double>& pPredicted);
+
+        //complete the staged epoch with the filtered state and covariance
+        //and append it to the log
+        void commitUpdate(const gpstk::Vector<double>& xFiltered,
+                          const gpstk::Matrix<double>& pFiltered);
+
+        //backward pass: replace filtered states by smoothed ones
+        void smooth();
+
+        //number of epochs stored
+        size_t size() const
+        {
+            return offsets.size();
+        }
+
+        bool isSmoothed() const
+        {
+            return smoothed;
+        }
+
+        //epoch of record 'i'
+        gpstk::CommonTime getEpoch(size_t i) const;
+
+        //unknowns, state and covariance of record 'i' (smoothed ones after
+        //smooth() was called)
+        void getState(size_t i, ParametersSet& unknowns,
+                      gpstk::Vector<double>& x, gpstk::Matrix<double>& P) const;
+
+        //remove all records
+        void clear();
+
+    private:
+
+        //layout of a record
+        struct Layout
+        {
+            Layout(size_t n, size_t nPhi);
+
+            //layout of the record starting with 'header'
+            explicit Layout(const double* header);
+
+            size_t n, params, map, x, P, xPred, PPred, phi, length;
+        };
+
+        //header: day, sod, fsod, time system, n, linked, number of phi elements
+        static const size_t headerSize = 7;
+
+        //write/read 'count' doubles at 'offset' of the log
+        void write(size_t offset, const double* src, size_t count);
+        void read(size_t offset, double* dst, size_t count) const;
+
+        //load record 'i' into 'rec'
+        void load(size_t i, std::vector<double>& rec) const;
+
+        static void pack(const gpstk::Matrix<double>& P, double* dst);
+        static void unpack(const double* src, gpstk::Matrix<double>& P);
+
+        //record being built
+        std::vector<double> staged;
+
+        //unknowns of the last committed record
+        std::vector<FilterParameter> lastParams;
+
+        //in-memory log, used if there is no spill file
+        std::vector<double> log;
+
+        //log file, if the records are spilled to disk
+        std::FILE* spillFile;
+
+        //start of every record, in doubles
+        std::vector<size_t> offsets;
+
+        //log length, in doubles
+        size_t length;
+
+        bool smoothed;
+    };
+}
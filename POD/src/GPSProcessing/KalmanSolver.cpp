@@ -8,7 +8,9 @@
 #include"ARSimple.hpp"
 #include"ARMLambda.hpp"
 #include"MatrixExtensions.h"
+#include"MatrixKernels.hpp"
 #include"GnssSolution.h"
+#include"KalmanSmoother.h"
 
 #include <algorithm>
 
@@ -40,17 +42,18 @@ namespace pod
 	double KalmanSolver::maxGap = 61;
 
 	KalmanSolver::KalmanSolver()
-		:firstTime(true), isValid(false)
+		:firstTime(true), isValid(false), smoother(nullptr)
 	{}
 
 	KalmanSolver::KalmanSolver(eqComposer_sptr eqs)
-		: firstTime(true), equations(eqs), isValid(false)
+		: firstTime(true), equations(eqs), isValid(false), smoother(nullptr)
 	{}
 
 	KalmanSolver::~KalmanSolver()
 	{}
 
 	IRinex& KalmanSolver::Process(IRinex& gData)
+		throw(ProcessingException)
 	{
 		//invalidate solution
 		isValid = false;
@@ -83,12 +86,15 @@ namespace pod
 			return gData;
 		}
 
-		equations->updateH(gData, hMatrix);
-		equations->updateMeas(gData, measVector);
-		equations->updateW(gData, weigthMatrix);
+		{
+			GPSTK_PROFILE_SCOPE("KalmanSolver::equations");
+			equations->updateH(gData, hMatrix);
+			equations->updateMeas(gData, measVector);
+			equations->updateW(gData, weigthMatrix);
 
-		equations->updatePhi(phiMatrix);
-		equations->updateQ(qMatrix);
+			equations->updatePhi(phiMatrix);
+			equations->updateQ(qMatrix);
+		}
 
 		if (dt > maxGap)
 			equations->initKfState(solution, covMatrix);
@@ -97,6 +103,11 @@ namespace pod
 
 		firstTime = false;
 
+		//the state of the previous epoch: a second pass, after a phase
+		//rejection, predicts again from it and not from the first update
+		xPrevious = solution;
+		pPrevious = covMatrix;
+
 		for (int i = 0; i < 2; i++)
 		{
 			//if number of satellies passed to processing is less than 'MIN_NUM_SV'
@@ -120,30 +131,71 @@ namespace pod
 			//DBOUT_LINE("qMatrix: " << qMatrix.diagCopy());
 			//DBOUT_LINE("phiMatrix: " << phiMatrix.diagCopy());
 
-			//prepare
-			Matrix<double> hMatrixTr = transpose(hMatrix);
-			Matrix<double> phiMatrixTr = transpose(phiMatrix);
-			Matrix<double> hTrTimesW = hMatrixTr * weigthMatrix;
-
 			//predict
-			Matrix<double> Pminus = phiMatrix * covMatrix*phiMatrixTr + qMatrix;
-			Vector<double> xminus = phiMatrix * solution;
+			{
+				GPSTK_PROFILE_SCOPE("KalmanSolver::predict");
+				propagateCovariance(phiMatrix, pPrevious, qMatrix, pMinus, workMatrix);
+				multiplyInto(phiMatrix, xPrevious, xMinus);
+			}
+
+			//the prediction from the previous epoch, for the smoother; that
+			//of a second pass replaces the first one
+			if (smoother)
+				smoother->stagePrediction(gData.getHeader().epoch,
+					equations->currentUnknowns(), equations->getState(),
+					!(dt > maxGap), phiMatrix, xMinus, pMinus);
+
+			//DBOUT_LINE("Pminus\n" << pMinus);
+			//the update, down to the phase residual check
+			GPSTK_PROFILE_SCOPE("KalmanSolver::update");
 
-			//DBOUT_LINE("Pminus\n" << Pminus);
-			//correct
-			try
+			//correct, one measurement at a time if the weights are diagonal
+			bool corrected(false);
+			if (equations->getUpdateType() == EquationComposer::Sequential)
 			{
-				Matrix<double> invPminus = inverseChol(Pminus);
-				covMatrix = inverseChol(hTrTimesW*hMatrix + invPminus);
-				solution = covMatrix * (hTrTimesW*measVector + invPminus * xminus);
+				try
+				{
+					solution = xMinus;
+					covMatrix = pMinus;
+					sequentialUpdate(hMatrix, weigthMatrix, measVector,
+						solution, covMatrix, infoVector);
+					corrected = true;
+				}
+				catch (const gpstk::MatrixException &e)
+				{
+					std::cerr << e << endl;
+				}
 			}
-			catch (const gpstk::MatrixException &e)
+
+			//correct, in information form:
+			// P = (H'WH + Pminus^-1)^-1, x = P(H'Wy + Pminus^-1 xminus)
+			if (!corrected)
 			{
-				std::cerr << e << endl;
+				try
+				{
+					infoMatrix = pMinus;
+					choleskyFactor(infoMatrix);
+					choleskyInvert(infoMatrix);
+					multiplyInto(infoMatrix, xMinus, infoVector);
+
+					accumulateNormals(hMatrix, weigthMatrix, measVector,
+						infoMatrix, infoVector, workMatrix);
+
+					choleskyFactor(infoMatrix);
+					solution = infoVector;
+					choleskySolve(infoMatrix, solution);
+					choleskyInvert(infoMatrix);
+					covMatrix = infoMatrix;
+				}
+				catch (const gpstk::MatrixException &e)
+				{
+					std::cerr << e << endl;
 
-				Matrix<double> invPminus = inverseSVD(Pminus);
-				covMatrix = inverseSVD(hTrTimesW*hMatrix + invPminus);
-				solution = covMatrix * (hTrTimesW*measVector + invPminus * xminus);
+					Matrix<double> hTrTimesW = transpose(hMatrix) * weigthMatrix;
+					Matrix<double> invPminus = inverseSVD(pMinus);
+					covMatrix = inverseSVD(hTrTimesW*hMatrix + invPminus);
+					solution = covMatrix * (hTrTimesW*measVector + invPminus * xMinus);
+				}
 			}
 
 			postfitResiduals = measVector - hMatrix * solution;
@@ -156,7 +208,10 @@ namespace pod
 
 			floatSolution = solution;
 
-			fixAmbiguities(gData);
+			{
+				GPSTK_PROFILE_SCOPE("KalmanSolver::fixAmbiguities");
+				fixAmbiguities(gData);
+			}
 			//storeAmbiguities(gData);
 
 			auto vpv = postfitResiduals * weigthMatrix*postfitResiduals;
@@ -176,6 +231,9 @@ namespace pod
 
 		equations->storeKfState(floatSolution, covMatrix);
 
+		if (smoother)
+			smoother->commitUpdate(floatSolution, covMatrix);
+
 		//everything is OK => set solutiuon status to VALID
 		isValid = true;
 		return gData;
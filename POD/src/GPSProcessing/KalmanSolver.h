@@ -5,6 +5,8 @@
 
 namespace pod
 {
+	class KalmanSmoother;
+
 	class KalmanSolver :
 		public gpstk::SolverBase, public gpstk::ProcessingClass
 	{
@@ -99,6 +101,13 @@ namespace pod
 			return isReset;
 		}
 
+		//log the prediction and update of every epoch to 'log' (nullptr to stop)
+		virtual KalmanSolver& setSmoother(KalmanSmoother* log)
+		{
+			smoother = log;
+			return *this;
+		}
+
 		bool ResetIfRequared(const gpstk::CommonTime& t, const filterHistory& data);
 
 		//filter states, processed so far will be used in case of filer reset
@@ -146,6 +155,11 @@ namespace pod
 		// Measurements vector (prefit-residuals)
 		gpstk::Vector<double> measVector;
 
+		// Workspace of the filter update, kept between epochs so that
+		// it is only reallocated when the number of unknowns grows
+		gpstk::Matrix<double> pMinus, infoMatrix, workMatrix, pPrevious;
+		gpstk::Vector<double> xMinus, infoVector, xPrevious;
+
 		//Weight unit error (sqrt(vpv/(n-p)))
 		double sigma;
 
@@ -161,5 +175,8 @@ namespace pod
 
 		// Indicate, if reset occurred on current filter step
 		bool isReset;
+
+		// Log of filter epochs for the RTS smoother, not owned
+		KalmanSmoother* smoother;
 	};
 }
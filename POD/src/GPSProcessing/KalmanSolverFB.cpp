@@ -9,33 +9,53 @@ namespace pod
 {
 
     KalmanSolverFB::KalmanSolverFB()
-        :currCycle(0), processedMeasurements(0), rejectedMeasurements(0)
+        :currCycle(0), processedMeasurements(0), rejectedMeasurements(0),
+        lastEpoch(0), rtsSmoothing(false), smoothedEpoch(0)
     {}
 
     KalmanSolverFB::KalmanSolverFB(eqComposer_sptr eqs)
-        : currCycle(0), processedMeasurements(0), rejectedMeasurements(0)
+        : currCycle(0), processedMeasurements(0), rejectedMeasurements(0),
+        lastEpoch(0), rtsSmoothing(false), smoothedEpoch(0)
     {
         solver = KalmanSolver(eqs);
     }
 
+    KalmanSolverFB& KalmanSolverFB::setRtsSmoothing(bool useRts, bool spillToDisk)
+    {
+        rtsSmoothing = useRts;
+        smoother.setSpillToDisk(useRts && spillToDisk);
+        smoothedEpoch = 0;
+        solver.setSmoother(useRts ? &smoother : nullptr);
+        return *this;
+    }
+
     KalmanSolverFB::~KalmanSolverFB()
     {}
 
     gpstk::IRinex & KalmanSolverFB::Process(gpstk::IRinex & gRin)
+        throw(gpstk::ProcessingException)
     {
         solver.Process(gRin);
+
 		if (solver.getResetState())
 		{
 			LIDetMap[gRin.getHeader().epoch] = *LIDet;
 			MWDetMap[gRin.getHeader().epoch] = *MWDet;
 		}
 
+        //the smoother log is filled by the solver itself
+        if (rtsSmoothing)
+        {
+            processedMeasurements += gRin.getBody().numSats();
+            return gRin;
+        }
+
 
         // Before returning, store the results for a future iteration
         if (currCycle==0)
         {
             // Store observation data
-            ObsData.push_back(gRin.clone());
+            ObsData.push_back(gRin);
 
             // Update the number of processed measurements
             processedMeasurements += gRin.getBody().numSats();
@@ -46,44 +66,70 @@ namespace pod
 
     bool KalmanSolverFB::lastProcess(gpstk::IRinex & gRin)
     {
+        //return the smoothed states one by one: only the epoch of 'gRin'
+        //is set, the solver state is the smoothed one
+        if (rtsSmoothing)
+        {
+            if (smoothedEpoch >= smoother.size())
+                return false;
 
-        // Keep processing while 'ObsData' is not empty
-        if (!ObsData.empty())
+            gRin.getHeader().epoch = smoother.getEpoch(smoothedEpoch);
+            smoother.getState(smoothedEpoch, solver.eqComposer().currentUnknowns(),
+                solver.Solution(), solver.CovMatrix());
+            ++smoothedEpoch;
+            return true;
+        }
+
+        // Keep processing while there are stored epochs left
+        if (lastEpoch < ObsData.size())
         {
-            // Get the first data epoch in 'ObsData' and process it. 
-            // The result will be stored in 'gData'
-			gRin = ReProcessOneEpoch(*ObsData.front());
-
-            // gData = ObsData.front();
-            // Remove the first data epoch in 'ObsData', freeing some
-            // memory and preparing for next epoch
-            ObsData.pop_front();
+            // Get the next data epoch in 'ObsData' and process it. 
+            // The result will be stored in 'gRin'
+			RinexEpoch epoch;
+			ObsData.read(lastEpoch++, epoch);
+			gRin = ReProcessOneEpoch(epoch);
             return true;
         }
         else
         {
+            // All data is processed, free the log
+            ObsData.clear();
+            lastEpoch = 0;
             return false;
         }
     }
 
 	void KalmanSolverFB::reProcess()
 	{
+		if (rtsSmoothing)
+		{
+			smoother.smooth();
+			smoothedEpoch = 0;
+			return;
+		}
+
 		// Backwards iteration. We must do this at least once
-		for (auto rpos = ObsData.rbegin(); rpos != ObsData.rend(); ++rpos)
-			ReProcessOneEpoch(**rpos);
+		for (size_t i = ObsData.size(); i-- > 0;)
+			reProcessStored(i);
 
 		for ( currCycle = 0; currCycle < cyclesNumber - 1; ++currCycle)
 		{
-			for (auto &it : ObsData)
-			{
-				ReProcessOneEpoch(*it);
-			}
+			for (size_t i = 0; i < ObsData.size(); i++)
+				reProcessStored(i);
 
-			for (auto rpos = ObsData.rbegin(); rpos != ObsData.rend(); ++rpos)
-				ReProcessOneEpoch(**rpos);
+			for (size_t i = ObsData.size(); i-- > 0;)
+				reProcessStored(i);
 		}
 	}
 
+	void KalmanSolverFB::reProcessStored(size_t i)
+	{
+		RinexEpoch epoch;
+		ObsData.read(i, epoch);
+		ReProcessOneEpoch(epoch);
+		ObsData.write(i, epoch);
+	}
+
 	gpstk::IRinex & KalmanSolverFB::ReProcessOneEpoch(gpstk::IRinex & gRin)
 	{
 
@@ -1,7 +1,9 @@
 #pragma once
 #include "KalmanSolver.h"
+#include"KalmanSmoother.h"
 #include"ProcessingList.hpp"
 #include"RinexEpoch.h"
+#include"RinexEpochLog.h"
 #include"UsedInPvtMarker.hpp"
 #include"LICSDetector2.hpp"
 #include"MWCSDetector.hpp"
@@ -143,7 +145,30 @@ namespace pod
             return *this;
         }
 
-        gpstk::IRinex & Process(gpstk::IRinex & gRin);
+        //Smooth the forward solution with a single Rauch-Tung-Striebel
+        //backward pass instead of re-filtering the stored epochs; only the
+        //filter states are kept, optionally in a temporary file.
+        KalmanSolverFB& setRtsSmoothing(bool useRts, bool spillToDisk = false);
+
+        bool getRtsSmoothing() const
+        {
+            return rtsSmoothing;
+        }
+
+        //keep the observations for the reprocessing in a temporary file
+        KalmanSolverFB& setSpillToDisk(bool spill)
+        {
+            ObsData.setSpillToDisk(spill);
+            return *this;
+        }
+
+        bool getSpillToDisk() const
+        {
+            return ObsData.getSpillToDisk();
+        }
+
+        gpstk::IRinex & Process(gpstk::IRinex & gRin)
+            throw(gpstk::ProcessingException);
 
         //last forward process cycle
         bool lastProcess(gpstk::IRinex & gRin);
@@ -161,6 +186,9 @@ namespace pod
 		
 		gpstk::IRinex & ReProcessOneEpoch(gpstk::IRinex & gRin);
 
+		//reprocess stored epoch 'i' and store the result back
+		void reProcessStored(size_t i);
+
         //This method checks the residuals and modifies 'gData' accordingly.
         void checkLimits(gpstk::IRinex& gData, size_t cycleNumber);
 
@@ -185,7 +213,10 @@ namespace pod
     private:
 
         //observations data to be reprocessed
-        std::list<gpstk::irinex_uptr> ObsData;
+        gpstk::RinexEpochLog ObsData;
+
+        //next stored epoch returned by 'lastProcess()'
+        size_t lastEpoch;
 
 		std::map<gpstk::CommonTime, gpstk::LICSDetector2> LIDetMap;
 		std::map<gpstk::CommonTime, gpstk::MWCSDetector>  MWDetMap;
@@ -193,6 +224,15 @@ namespace pod
         //internal kalman solver object, which do main part of real work
         KalmanSolver solver;
 
+        //RTS smoothing instead of forward-backward re-filtering
+        bool rtsSmoothing;
+
+        //filter states logged for the RTS smoother
+        KalmanSmoother smoother;
+
+        //next smoothed epoch returned by 'lastProcess()'
+        size_t smoothedEpoch;
+
         //number of forward-backward cycles
         size_t cyclesNumber;
 		
@@ -367,7 +367,7 @@ namespace pod
 
                     if (fm < 0.1)
                         pppSolver.printSolution(outfile, time0, time, cDOP, ep,  0.0, stats, nominalPos);
-                    gMap.data.insert(std::pair<CommonTime, GnssEpoch>(time, ep));
+                    gMap.add(time, ep);
                 }  // End of 'if ( cycles < 1 )'
              
             }  // End of 'while(rin >> gRin)'
@@ -428,7 +428,7 @@ namespace pod
             if (fm < 0.1)
                 fbpppSolver.printSolution(outfile, time0, time, cDOP, ep, 0.0, stats, nominalPos);
             //add epoch to results
-            gMap.data.insert(std::pair<CommonTime, GnssEpoch>(time, ep));
+            gMap.add(time, ep);
         }  // End of 'while( fbpppSolver.LastProcess(gRin) )'
 
         // Close output file for this station
@@ -197,6 +197,7 @@ namespace pod
         fbpppSolver.setPhaseList(phaselims);
 		std::list<double> codelims = confReader().getListValueAsDouble("codeLimList");
         fbpppSolver.setCodeList(codelims);
+        fbpppSolver.setSpillToDisk(confReader().getValueAsBoolean("fbSpillToDisk"));
         int cycles(std::max<int>(phaselims.size(), codelims.size()));
         std::cout <<"cycles "<< cycles << std::endl;
 
@@ -336,7 +337,7 @@ namespace pod
                     printSolution(outfile, pppSolver, time,  ep);
 
                     //add epoch to results
-                    gMap.data.insert(std::pair<CommonTime, GnssEpoch>(time, ep));
+                    gMap.add(time, ep);
                 } 
             } 
 
@@ -382,7 +383,7 @@ namespace pod
             GnssEpoch ep(gRin.getBody());
 			apprPos().getPosition(gRin, nominalPos);
             printSolution(outfile, fbpppSolver, gRin.getHeader().epoch, ep);
-            gMap.data.insert(std::pair<CommonTime, GnssEpoch>(gRin.getHeader().epoch, ep));
+            gMap.add(gRin.getHeader().epoch, ep);
 
         }  // End of 'while( fbpppSolver.LastProcess(gRin) )'
 
@@ -401,7 +401,7 @@ namespace pod
                     auto ep = opts().fullOutput ? GnssEpoch(gRin.getBody()) : GnssEpoch();
                     // updateNomPos(solverFB);
                     printSolution( solver, t, ep);
-                    gMap.data.insert(std::make_pair(t, ep));
+                    gMap.add(t, ep);
                 }
             }
         }
@@ -416,7 +416,7 @@ namespace pod
                 auto ep = opts().fullOutput ? GnssEpoch(gRin.getBody()) : GnssEpoch();
                 //updateNomPos(solverFB);
                 printSolution( solverFb, gRin.getHeader().epoch, ep);
-                gMap.data.insert(std::make_pair(gRin.getHeader().epoch, ep));
+                gMap.add(gRin.getHeader().epoch, ep);
             }
 			std::cout << "Measurments rejected: " << solverFb.rejectedMeasurements << std::endl;
         }
@@ -543,6 +543,9 @@ namespace pod
         if (opts().carrierBands.find(CarrierBand::L2) != opts().carrierBands.end())
             Equations->addEquation(std::make_unique<AmbiguitiesEquations>(TypeID::BL2));
 
+        Equations->setUpdateType(
+            (EquationComposer::UpdateType)confReader().getValueAsInt("kfUpdateType"));
+
         forwardBackwardCycles = confReader().getValueAsInt("forwardBackwardCycles");
     }
 }
@@ -6,6 +6,8 @@
 #include"MWCSDetector.hpp"
 #include"Decimate.hpp"
 #include"BasicModel.hpp"
+#include"SatGeometryCache.hpp"
+#include"ProcessingThreadPool.hpp"
 #include"ComputeWeightSimple.h"
 #include"NeillTropModel.hpp"
 #include"PowerSum.hpp"
@@ -59,122 +61,288 @@ namespace pod
         : GnssSolution(data_ptr, max_sigma)
     { }
 
-    void  PppFloatSolution::process()
+    // processing objects of the epochs
+    struct PppFloatSolution::Pipeline
     {
-        updateRequaredObs();
+        Pipeline(PppFloatSolution& sln);
+
+        // threads modeling the satellites of an epoch, if more than one
+        std::unique_ptr<ProcessingThreadPool> modelThreads;
+
+        // satellite geometry of the epoch, shared by the modeling objects
+        SatGeometryCache geometry;
 
         BasicModel model;
-        model.setDefaultEphemeris(data->SP3EphList);
-        model.setDefaultObservable(codeL1);
-        model.setMinElev(.0);
-		
-		ElevationMask elMask(opts().maskEl);
 
-        SimpleFilter CodeFilter(TypeIDSet{ codeL1,TypeID::P2,TypeID::L1,TypeID::L2 });
-        SimpleFilter SNRFilter(TypeID::S1, confReader().getValueAsInt("SNRmask"), DBL_MAX);
+        ElevationMask elMask;
+
+        SimpleFilter CodeFilter;
+        SimpleFilter SNRFilter;
+
         // Object to remove eclipsed satellites
         EclipsedSatFilter eclipsedSV;
 
-        RinexEpoch gRin;
-
         //Object to decimate data
-        Decimate decimateData(confReader().getValueAsDouble("decimationInterval"),
-            confReader().getValueAsDouble("decimationTolerance"),
-            data->SP3EphList.getInitialTime());
-
-		// Object to compute gravitational delay effects
-		GravitationalDelay grDelayRover;
+        Decimate decimateData;
 
-#pragma region troposhere modeling objects
+        // Object to compute gravitational delay effects
+        GravitationalDelay grDelayRover;
 
-        //for rover
+        //troposhere modeling objects for rover
         NeillTropModel tropoRovPtr;
-		ComputeTropModel computeTropoRover(tropoRovPtr, true);
-
-#pragma endregion
-
-#pragma region CS detectors
+        ComputeTropModel computeTropoRover;
 
         // Objects to mark cycle slips
         // Checks LI cycle slips
         LICSDetector2 markCSLI2Rover;
-		markCSLI2Rover.setSatThreshold(confReader().getValueAsDouble("LISatThreshold"));
-		
+
         // Checks Merbourne-Wubbena cycle slips
         MWCSDetector markCSMW2Rover;
-		markCSMW2Rover.setMaxNumLambdas(confReader().getValueAsDouble("MWNLambdas"));
-		
-		// check sharp SNR drops 
+
+        // check sharp SNR drops 
         SNRCatcher snrCatcherL1Rover;
-        PrefitResCatcher resCatcher(Equations->measTypes());
+        PrefitResCatcher resCatcher;
 
         // Object to keep track of satellite arcs
-        SatArcMarker markArcRover(TypeID::CSL1, true, 31.0);
+        SatArcMarker markArcRover;
 
-#pragma endregion
+        AntexReader antexReader;
+
+        CorrectObservables corrRover;
+
+        ComputeWeightSimple computeWeightSimple;
+
+        // Objects to compute tidal effects
+        SolidTides solid;
+        PoleTides pole;
+        OceanLoading ocean;
+
+        ComputeWindUp windupRover;
+
+        ComputeSatPCenter svPcenterRover;
+
+        ProcessLinear linearIonoFree;
+
+        UsedInPvtMarker useMarker;
+        KalmanSolver solver;
+        KalmanSolverFB solverFb;
+    };
+
+    PppFloatSolution::Pipeline::Pipeline(PppFloatSolution& sln)
+        :elMask(sln.opts().maskEl),
+        CodeFilter(TypeIDSet{ sln.codeL1,TypeID::P2,TypeID::L1,TypeID::L2 }),
+        SNRFilter(TypeID::S1, sln.confReader().getValueAsInt("SNRmask"), DBL_MAX),
+        decimateData(sln.confReader().getValueAsDouble("decimationInterval"),
+            sln.confReader().getValueAsDouble("decimationTolerance"),
+            sln.data->SP3EphList.getInitialTime()),
+        computeTropoRover(tropoRovPtr, true),
+        resCatcher(sln.Equations->measTypes()),
+        markArcRover(TypeID::CSL1, true, 31.0),
+        corrRover(sln.data->SP3EphList),
+        computeWeightSimple(2),
+        windupRover(sln.data->SP3EphList, sln.opts().genericFilesDirectory + sln.confReader().getValue("satDataFile")),
+        solver(sln.Equations),
+        solverFb(sln.Equations)
+    {
+        auto& confReader = sln.confReader();
+        auto& opts = sln.opts();
+
+        geometry.setDefaultEphemeris(sln.data->SP3EphList);
+        geometry.setDefaultObservable(sln.codeL1);
+
+        model.setDefaultEphemeris(sln.data->SP3EphList);
+        model.setDefaultObservable(sln.codeL1);
+        model.setMinElev(.0);
+        model.setGeometryCache(geometry);
+
+        eclipsedSV.setGeometryCache(geometry);
+        grDelayRover.setGeometryCache(geometry);
+        svPcenterRover.setGeometryCache(geometry);
+        windupRover.setGeometryCache(geometry);
+
+		markCSLI2Rover.setSatThreshold(confReader.getValueAsDouble("LISatThreshold"));
+		markCSMW2Rover.setMaxNumLambdas(confReader.getValueAsDouble("MWNLambdas"));
 
 #pragma region prepare ANTEX reader
 
-        std::string antxfile = opts().genericFilesDirectory;
-        antxfile += confReader().getValue("antexFile");
+        std::string antxfile = opts.genericFilesDirectory;
+        antxfile += confReader.getValue("antexFile");
 
-        AntexReader antexReader;
         antexReader.open(antxfile);
 
 #pragma endregion
 
 #pragma region correct observable
 
-        CorrectObservables corrRover(data->SP3EphList);
-
         // Vector from monument to antenna ARP [UEN], in meters
         Triple offsetARP;
         int i = 0;
-        for (auto &it : confReader().getListValueAsDouble("offsetARP", opts().SiteRover))
+        for (auto &it : confReader.getListValueAsDouble("offsetARP", opts.SiteRover))
             offsetARP[i++] = it;
         corrRover.setMonument(offsetARP);
 
-        Antenna roverAnt(antexReader.getAntenna(confReader().getValue("antennaModel", opts().SiteRover)));
-		corrRover.setUsePcv(confReader().getValueAsBoolean("usePCPatterns", opts().SiteRover));
+        Antenna roverAnt(antexReader.getAntenna(confReader.getValue("antennaModel", opts.SiteRover)));
+		corrRover.setUsePcv(confReader.getValueAsBoolean("usePCPatterns", opts.SiteRover));
         corrRover.setAntenna(roverAnt);
-        corrRover.setUseAzimuth(confReader().getValueAsBoolean("useAzim", opts().SiteRover));
+        corrRover.setUseAzimuth(confReader.getValueAsBoolean("useAzim", opts.SiteRover));
 
 #pragma endregion
 
-		ComputeWeightSimple computeWeightSimple(2);
-        // Objects to compute tidal effects
-        SolidTides solid;
-        PoleTides pole;
         // Configure ocean loading model
-        OceanLoading ocean;
-        ocean.setFilename(opts().genericFilesDirectory + confReader().getValue("oceanLoadingFile"));
-
-        ComputeWindUp windupRover(data->SP3EphList, opts().genericFilesDirectory + confReader().getValue("satDataFile"));
+        ocean.setFilename(opts.genericFilesDirectory + confReader.getValue("oceanLoadingFile"));
 
-        ComputeSatPCenter svPcenterRover;
         svPcenterRover.setAntexReader(antexReader);
 
-        ProcessLinear linearIonoFree;
+        int numThreads = confReader.getValueAsInt("modelThreads", "DEFAULT", 1);
+        if (numThreads != 1)
+        {
+            modelThreads.reset(new ProcessingThreadPool(std::max(numThreads, 0)));
+            model.setThreadPool(modelThreads.get());
+            grDelayRover.setThreadPool(modelThreads.get());
+            svPcenterRover.setThreadPool(modelThreads.get());
+            computeTropoRover.setThreadPool(modelThreads.get());
+        }
+
         linearIonoFree.add(std::make_unique<PCCombimnation>());
         linearIonoFree.add(std::make_unique<LCCombimnation>());
+    }
+
+    PppFloatSolution::~PppFloatSolution()
+    { }
+
+    void PppFloatSolution::initPipeline()
+    {
+        pipeline.reset(new Pipeline(*this));
+    }
 
-		UsedInPvtMarker useMarker;
-        KalmanSolver solver(Equations);
-        KalmanSolverFB solverFb(Equations);
+    bool PppFloatSolution::modelEpoch(RinexEpoch& gRin)
+    {
+        Pipeline& p = *pipeline;
+
+		//gRin.removeSatID(18, SatID::SatelliteSystem::systemGPS);
+		if (p.decimateData.check(gRin))
+			return false;
+
+		if (gRin.getBody().size() == 0)
+		{
+			printMsg(gRin.getHeader().epoch, "Empty epoch record in Rinex file");
+			return false;
+		}
+
+        const auto& t = gRin.getHeader().epoch;
+#if _DEBUG
+		bool b;
+
+		CATCH_TIME(t, 2014, 12, 19, 0, 14, 15, b)
+			if (b)
+				DBOUT_LINE("catched")
+#endif
+        //keep only satellites from satellites systems selecyted for processing
+        gRin.keepOnlySatSystems(opts().systems);
+
+        //keep only types used for processing
+        // gRin.keepOnlyTypeID(requireObs.getRequiredType());
+
+        //get approximate position
+		if (apprPos().getPosition(gRin, nominalPos))
+			return false;
+		//std::cout << nominalPos << std::endl;
+        p.grDelayRover.setNominalPosition(nominalPos);
+
+        p.tropoRovPtr.setAllParameters(t, nominalPos);
+
+        p.corrRover.setNominalPosition(nominalPos);
+        p.windupRover.setNominalPosition(nominalPos);
+        p.svPcenterRover.setNominalPosition(nominalPos);
+        p.geometry.setNominalPosition(nominalPos);
+        p.model.rxPos = nominalPos;
+
+        gRin >> requireObs;
+        gRin >> p.CodeFilter;
+        gRin >> p.SNRFilter;
+
+        if (gRin.getBody().size() == 0)
+        {
+            printMsg(gRin.getHeader().epoch, "Rover receiver: all SV has been rejected.");
+            return false;
+        }
+        gRin >> computeLinear;
+
+        auto eop = data->eopStore.getEOP(MJD(t).mjd, IERSConvention::IERS2010);
+        p.pole.setXY(eop.xp, eop.yp);
+
+        gRin >> p.geometry;
+        gRin >> p.model;
+        gRin >> p.eclipsedSV;
+        gRin >> p.grDelayRover;
+        gRin >> p.svPcenterRover;
+
+        Triple tides(p.solid.getSolidTide(nominalPos, p.geometry.getSunPosition(t), p.geometry.getMoonPosition(t)) + p.ocean.getOceanLoading(opts().SiteRover, t) + p.pole.getPoleTide(t, nominalPos));
+        p.corrRover.setExtraBiases(tides);
+        gRin >> p.corrRover;
+
+        gRin >> p.windupRover;
+        gRin >> p.computeTropoRover;
+
+        gRin >> p.linearIonoFree;
+        gRin >> oMinusC;
+        gRin >> p.resCatcher;
+		gRin >> p.computeWeightSimple;
+
+		gRin >> p.useMarker;
+		gRin >> p.markCSLI2Rover;
+		gRin >> p.markCSMW2Rover;
+		gRin >> p.markArcRover;
+		gRin >> p.elMask;
+		//gRin >> p.snrCatcherL1Rover;
+
+        return true;
+    }
+
+    void PppFloatSolution::filterEpoch(IRinex& gRin)
+    {
+        KalmanSolver& solver = pipeline->solver;
+		solver.setMinSatNumber(4 /*+ gRin.getBody().getSatSystems().size()*/);
+        gRin >> solver;
+    }
+
+    GnssEpoch PppFloatSolution::solutionEpoch(IRinex& gRin)
+    {
+        auto ep = opts().fullOutput ? GnssEpoch(gRin.getBody()) : GnssEpoch();
+        // updateNomPos(solverFB);
+        printSolution(pipeline->solver, gRin.getHeader().epoch, ep);
+        return ep;
+    }
+
+    void  PppFloatSolution::process()
+    {
+        updateRequaredObs();
+        initPipeline();
+
+        Pipeline& p = *pipeline;
+        KalmanSolverFB& solverFb = p.solverFb;
+
+        RinexEpoch gRin;
 
         if (forwardBackwardCycles > 0)
         {
             solverFb.setCyclesNumber(forwardBackwardCycles);
             solverFb.setLimits(confReader().getListValueAsDouble("codeLimList"), confReader().getListValueAsDouble("phaseLimList"));
-			solverFb.setCSDetRef(markCSLI2Rover, markCSMW2Rover);
+			solverFb.setCSDetRef(p.markCSLI2Rover, p.markCSMW2Rover);
+
+			solverFb.ReProcList().push_back(p.markCSLI2Rover);
+			solverFb.ReProcList().push_back(p.markCSMW2Rover);
+			solverFb.ReProcList().push_back(p.markArcRover);
+			solverFb.ReProcList().push_back(p.elMask);
 
-			solverFb.ReProcList().push_back(markCSLI2Rover);
-			solverFb.ReProcList().push_back(markCSMW2Rover);
-			solverFb.ReProcList().push_back(markArcRover);
-			solverFb.ReProcList().push_back(elMask);
+			solverFb.setRtsSmoothing(confReader().getValueAsBoolean("useRtsSmoother"),
+				confReader().getValueAsBoolean("rtsSpillToDisk"));
+			solverFb.setSpillToDisk(confReader().getValueAsBoolean("fbSpillToDisk"));
         }
 
-        bool firstTime = true;
+		//nominal positions of the forward pass, for the smoothed solution
+		std::map<CommonTime, Position> rtsNominalPos;
+
         //
         for (auto &obsFile : data->getObsFiles(opts().SiteRover))
         {
@@ -195,81 +363,13 @@ namespace pod
             //read all epochs
             while (rin >> gRin)
             {
-				//gRin.removeSatID(18, SatID::SatelliteSystem::systemGPS);
-				if (decimateData.check(gRin))
-					continue;
-
-				if (gRin.getBody().size() == 0)
-				{
-					printMsg(gRin.getHeader().epoch, "Empty epoch record in Rinex file");
+				GPSTK_PROFILE_COUNT("PppFloatSolution::epochs read", 1);
+				if (!modelEpoch(gRin))
 					continue;
-				}
+				GPSTK_PROFILE_COUNT("PppFloatSolution::epochs modeled", 1);
+				GPSTK_PROFILE_COUNT("PppFloatSolution::satellites modeled", gRin.getBody().size());
 
                 const auto& t = gRin.getHeader().epoch;
-#if _DEBUG
-				bool b;
-
-				CATCH_TIME(t, 2014, 12, 19, 0, 14, 15, b)
-					if (b)
-						DBOUT_LINE("catched")
-#endif
-                //keep only satellites from satellites systems selecyted for processing
-                gRin.keepOnlySatSystems(opts().systems);
-
-                //keep only types used for processing
-                // gRin.keepOnlyTypeID(requireObs.getRequiredType());
-
-                //get approximate position
-				if (apprPos().getPosition(gRin, nominalPos))
-					continue;
-				//std::cout << nominalPos << std::endl;
-                grDelayRover.setNominalPosition(nominalPos);
-
-                tropoRovPtr.setAllParameters(t, nominalPos);
-
-                corrRover.setNominalPosition(nominalPos);
-                windupRover.setNominalPosition(nominalPos);
-                svPcenterRover.setNominalPosition(nominalPos);
-                model.rxPos = nominalPos;
-
-                gRin >> requireObs;
-                gRin >> CodeFilter;
-                gRin >> SNRFilter;
-
-                if (gRin.getBody().size() == 0)
-                {
-                    printMsg(gRin.getHeader().epoch, "Rover receiver: all SV has been rejected.");
-                    continue;
-                }
-                gRin >> computeLinear;
-
-                auto eop = data->eopStore.getEOP(MJD(t).mjd, IERSConvention::IERS2010);
-                pole.setXY(eop.xp, eop.yp);
-
-                gRin >> model;
-                gRin >> eclipsedSV;
-                gRin >> grDelayRover;
-                gRin >> svPcenterRover;
-
-                Triple tides(solid.getSolidTide(t, nominalPos) + ocean.getOceanLoading(opts().SiteRover, t) + pole.getPoleTide(t, nominalPos));
-                corrRover.setExtraBiases(tides);
-                gRin >> corrRover;
-
-                gRin >> windupRover;
-                gRin >> computeTropoRover;
-
-                gRin >> linearIonoFree;
-                gRin >> oMinusC;
-                gRin >> resCatcher;
-				gRin >> computeWeightSimple;
-
-				gRin >> useMarker;
-				gRin >> markCSLI2Rover;
-				gRin >> markCSMW2Rover;
-				gRin >> markArcRover;
-				gRin >> elMask;
-				//gRin >> snrCatcherL1Rover;
-
 
                 //DBOUT_LINE(">>" << CivilTime(gRin.getHeader().epoch).asString());
 
@@ -277,29 +377,51 @@ namespace pod
                 {
 					solverFb.setMinSatNumber(4 /*+ gRin.getBody().getSatSystems().size()*/);
                     gRin >> solverFb;
+
+					//with RTS smoothing the epochs are not kept: store the
+					//forward solution now, it is updated after smoothing
+					if (solverFb.getRtsSmoothing() && solverFb.getValid())
+					{
+						auto ep = opts().fullOutput ? GnssEpoch(gRin.getBody()) : GnssEpoch();
+						printSolution(solverFb, t, ep);
+						gMap.data.insert(std::make_pair(t, ep));
+						rtsNominalPos[t] = nominalPos;
+					}
                 }
                 else
                 {
-					solver.setMinSatNumber(4 /*+ gRin.getBody().getSatSystems().size()*/);
-                    gRin >> solver;
-                    auto ep = opts().fullOutput ? GnssEpoch(gRin.getBody()) : GnssEpoch();
-                    // updateNomPos(solverFB);
-                    printSolution( solver, t, ep);
-                    gMap.data.insert(std::make_pair(t, ep));
+                    filterEpoch(gRin);
+                    gMap.add(t, solutionEpoch(gRin));
                 }
             }
         }
         if (forwardBackwardCycles > 0)
         {
-			markCSLI2Rover.setIsReprocess(true);
-			markCSMW2Rover.setIsReprocess(true);
+			p.markCSLI2Rover.setIsReprocess(true);
+			p.markCSMW2Rover.setIsReprocess(true);
 
             std::cout << "Fw-Bw part started" << std::endl;
             solverFb.reProcess();
             RinexEpoch gRin;
             std::cout << "Last process part started" << std::endl;
 
-            while (solverFb.lastProcess(gRin))
+            while (solverFb.getRtsSmoothing() && solverFb.lastProcess(gRin))
+            {
+				const auto& t = gRin.getHeader().epoch;
+				auto it = gMap.data.find(t);
+				if (it == gMap.data.end())
+					continue;
+
+				//replace the forward solution by the smoothed one; number of
+				//used SV and sigma are those of the forward pass
+				for (const auto& type : { TypeID::recX, TypeID::recY, TypeID::recZ, TypeID::recStDev3D })
+					it->second.slnData.erase(type);
+
+				nominalPos = rtsNominalPos[t];
+				printSolution(solverFb, t, it->second);
+            }
+
+            while (!solverFb.getRtsSmoothing() && solverFb.lastProcess(gRin))
             {
 				//fill GnssEpoch by IRinex object data
                 auto ep = opts().fullOutput ? GnssEpoch(gRin.getBody()) : GnssEpoch();
@@ -311,7 +433,7 @@ namespace pod
                 printSolution( solverFb, gRin.getHeader().epoch, ep);
 				
 				//add epoch to map
-                gMap.data.insert(std::make_pair(gRin.getHeader().epoch, ep));
+                gMap.add(gRin.getHeader().epoch, ep);
             }
             std::cout << "Measurments rejected: " << solverFb.rejectedMeasurements << std::endl;
         }
@@ -399,6 +521,9 @@ namespace pod
 
         Equations->addEquation(std::make_unique<AmbiguitiesEquations>(TypeID::BLC));
 
+        Equations->setUpdateType(
+            (EquationComposer::UpdateType)confReader().getValueAsInt("kfUpdateType"));
+
         forwardBackwardCycles = confReader().getValueAsInt("forwardBackwardCycles");
     }
 }
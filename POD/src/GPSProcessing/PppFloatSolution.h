@@ -1,5 +1,8 @@
 #pragma once
 #include "GnssSolution.h"
+
+#include<memory>
+
 namespace pod
 {
     class PppFloatSolution :
@@ -8,7 +11,7 @@ namespace pod
     public:
         PppFloatSolution(GnssDataStore_sptr data_ptr);
         PppFloatSolution(GnssDataStore_sptr data_ptr, double  max_sigma);
-        virtual ~PppFloatSolution() {};
+        virtual ~PppFloatSolution();
 
         virtual std::string  fileName() const override
         {
@@ -27,7 +30,26 @@ namespace pod
 
         void configureSolver();
 
+        // processing objects of the epochs, created by initPipeline()
+        // when the products are loaded
+        struct Pipeline;
+        void initPipeline();
+
+        // Steps of the processing of an epoch, shared by the batch
+        // processing and the epoch-by-epoch processing of the derived classes.
+        // Corrections, modeling and cycle slip detection; returns false
+        // if the epoch is rejected.
+        bool modelEpoch(gpstk::RinexEpoch& gRin);
+
+        // forward Kalman filter update
+        void filterEpoch(gpstk::IRinex& gRin);
+
+        // the solution of the last filtered epoch
+        GnssEpoch solutionEpoch(gpstk::IRinex& gRin);
+
         ProcessLinear OminusC;
 
+        std::unique_ptr<Pipeline> pipeline;
+
     };
 }
@@ -0,0 +1,223 @@
+#include "PppStreamSolution.h"
+
+#include"Rtcm3Decoder.hpp"
+#include"Rtcm3MsmMessage.hpp"
+#include"Rinex3ObsStream.hpp"
+
+#include<thread>
+#include<vector>
+
+using namespace gpstk;
+
+namespace pod
+{
+    const char* PppStreamSolution::stageName(Stage stage)
+    {
+        static const char* names[NumStages] = { "decode", "model", "filter", "output", "total" };
+        return names[stage];
+    }
+
+    PppStreamSolution::PppStreamSolution(GnssDataStore_sptr data_ptr)
+        :PppStreamSolution(data_ptr, 50.0)
+    { }
+
+    PppStreamSolution::PppStreamSolution(GnssDataStore_sptr data_ptr, double max_sigma)
+        : PppFloatSolution(data_ptr, max_sigma),
+        isRealTime(false), keepEpochs(true), playbackStarted(false),
+        refreshMargin(3600.0), refreshInterval(300.0),
+        lastRefresh(CommonTime::BEGINNING_OF_TIME), numEpochs(0)
+    { }
+
+    PppStreamSolution::~PppStreamSolution()
+    { }
+
+    void PppStreamSolution::init()
+    {
+        if (!data->products->loaded)
+            data->LoadProducts();
+
+        refreshMargin = confReader().getValueAsDouble("productRefreshMargin", "DEFAULT", refreshMargin);
+        refreshInterval = confReader().getValueAsDouble("productRefreshInterval", "DEFAULT", refreshInterval);
+
+        updateRequaredObs();
+        initPipeline();
+    }
+
+    void PppStreamSolution::refreshProducts(const CommonTime& t)
+    {
+        // zero interval: no refresh
+        if (refreshInterval <= 0 || t - lastRefresh < refreshInterval)
+            return;
+
+        try
+        {
+            if (data->SP3EphList.getFinalTime() - t > refreshMargin)
+                return;
+        }
+        catch (InvalidRequest&)
+        {
+            // no products yet
+        }
+
+        lastRefresh = t;
+        if (data->refreshProducts() > 0)
+            printMsg(t, "New product files loaded");
+    }
+
+    PppStreamSolution::clock::time_point PppStreamSolution::
+        receivedAt(const CommonTime& t, clock::duration decodeTime)
+    {
+        auto now = clock::now();
+        if (!isRealTime)
+            return now - decodeTime;
+
+        if (!playbackStarted)
+        {
+            playbackStarted = true;
+            playbackStart = now - decodeTime;
+            playbackEpoch = t;
+        }
+        auto due = playbackStart +
+            std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(t - playbackEpoch));
+
+        // the data can't be decoded before they are received
+        std::this_thread::sleep_until(due + decodeTime);
+        return due;
+    }
+
+    bool PppStreamSolution::processEpoch(IRinex& gRin, clock::time_point received, clock::duration decodeTime)
+    {
+        RinexEpoch& ep = dynamic_cast<RinexEpoch&>(gRin);
+        const CommonTime t = ep.getHeader().epoch;
+
+        if (!pipeline)
+            init();
+        refreshProducts(t);
+
+        if (decodeTime > clock::duration::zero())
+            latencies[Decode].add(toMicroseconds(decodeTime));
+
+        auto t0 = clock::now();
+        bool valid = modelEpoch(ep);
+        auto t1 = clock::now();
+        latencies[Model].add(toMicroseconds(t1 - t0));
+        if (!valid)
+            return false;
+
+        filterEpoch(ep);
+        auto t2 = clock::now();
+        latencies[Filter].add(toMicroseconds(t2 - t1));
+
+        GnssEpoch sln = solutionEpoch(ep);
+        if (onSolution)
+            onSolution(t, sln);
+        if (keepEpochs)
+            gMap.add(t, std::move(sln));
+
+        auto t3 = clock::now();
+        latencies[Output].add(toMicroseconds(t3 - t2));
+        latencies[Total].add(toMicroseconds(t3 - received));
+
+        ++numEpochs;
+        return true;
+    }
+
+    void PppStreamSolution::process()
+    {
+        setRealTime(confReader().getValueAsBoolean("realTimePlayback"));
+
+        for (auto &obsFile : data->getObsFiles(opts().SiteRover))
+        {
+            std::cout << obsFile << std::endl;
+            playRinex(obsFile);
+        }
+        printLatency(std::cout);
+    }
+
+    void PppStreamSolution::playRinex(const std::string& path)
+    {
+        //Input observation file stream
+        Rinex3ObsStream rin;
+
+        //Open Rinex observations file in read-only mode
+        rin.open(path, std::ios::in);
+
+        rin.exceptions(std::ios::failbit);
+        Rinex3ObsHeader roh;
+
+        //read the header
+        rin >> roh;
+        gMap.header = roh;
+
+        RinexEpoch gRin;
+        for (;;)
+        {
+            auto t0 = clock::now();
+            if (!(rin >> gRin))
+                break;
+            auto decodeTime = clock::now() - t0;
+
+            processEpoch(gRin, receivedAt(gRin.getHeader().epoch, decodeTime), decodeTime);
+        }
+    }
+
+    void PppStreamSolution::playRtcm(data_source_uptr source, const CommonTime& refTime)
+    {
+        // the orbits and clocks are those of the products:
+        // the ephemeris messages are not decoded
+        Rtcm3Decoder decoder;
+        decoder.addMessage<Rtcm3_1074>().addMessage<Rtcm3_1077>()
+            .addMessage<Rtcm3_1084>().addMessage<Rtcm3_1087>()
+            .addMessage<Rtcm3_1094>().addMessage<Rtcm3_1097>()
+            .addMessage<Rtcm3_1104>().addMessage<Rtcm3_1107>()
+            .addMessage<Rtcm3_1114>().addMessage<Rtcm3_1117>()
+            .addMessage<Rtcm3_1124>().addMessage<Rtcm3_1127>();
+        decoder.setReferenceTime(refTime);
+
+        // decoding time of the current epoch, without the waits for
+        // the data and the processing of the previous epochs
+        clock::time_point decodeStart;
+        clock::duration decodeTime = clock::duration::zero();
+
+        decoder.setEpochReceivedCallback([&](IRinex& gRin)
+        {
+            decodeTime += clock::now() - decodeStart;
+            processEpoch(gRin, receivedAt(gRin.getHeader().epoch, decodeTime), decodeTime);
+
+            decodeTime = clock::duration::zero();
+            decodeStart = clock::now();
+        });
+
+        std::vector<unsigned char> buff(4096);
+        for (;;)
+        {
+            int n = source->read(buff.data(), static_cast<int>(buff.size()));
+            if (n < 0)
+                break;
+            if (n == 0)
+            {
+                // nothing available yet
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            decodeStart = clock::now();
+            decoder.feed(buff.data(), n);
+            decodeTime += clock::now() - decodeStart;
+        }
+        decodeStart = clock::now();
+        decoder.flushEpoch();
+    }
+
+    void PppStreamSolution::printLatency(std::ostream& os) const
+    {
+        LatencyHistogram::printHeader(os);
+        for (int i = 0; i < NumStages; ++i)
+            latencies[i].print(os, stageName(static_cast<Stage>(i)));
+    }
+
+    void PppStreamSolution::clearLatency()
+    {
+        for (auto& it : latencies)
+            it.clear();
+    }
+}
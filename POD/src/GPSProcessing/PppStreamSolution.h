@@ -0,0 +1,165 @@
+#pragma once
+#include "PppFloatSolution.h"
+#include "LatencyHistogram.h"
+#include "IdataSource.hpp"
+
+#include<chrono>
+#include<functional>
+#include<ostream>
+
+namespace pod
+{
+    // Real-time PPP with float ambiguities.
+    // The epochs are processed one by one as they arrive, with the
+    // processing of PppFloatSolution (forward filter only), and the
+    // solution of each epoch is passed to the solution callback as soon
+    // as it is computed.
+    // The epochs come from processEpoch(), e.g. bound to the epoch
+    // callback of an Rtcm3Decoder, or from the playback of a recorded
+    // RINEX or RTCM 3 feed, at the rate of its epochs if real-time
+    // playback is set.
+    // The products are loaded at the first epoch, if they aren't yet,
+    // and new SP3 and clock files of the product directories are loaded
+    // when the epochs approach the end of the products.
+    // The latencies of the stages of the processing of each epoch are
+    // kept in histograms.
+    class PppStreamSolution :
+        public PppFloatSolution
+    {
+    public:
+        typedef std::chrono::steady_clock clock;
+        typedef std::function<void(const gpstk::CommonTime&, const GnssEpoch&)> SolutionCallback;
+
+        // stages of the processing of an epoch
+        enum Stage
+        {
+            // reading and decoding of the epoch data
+            Decode = 0,
+            // corrections, modeling and cycle slip detection
+            Model,
+            // Kalman filter update
+            Filter,
+            // solution output and callback
+            Output,
+            // from the reception of the epoch data to its solution output
+            Total,
+            NumStages
+        };
+
+        static const char* stageName(Stage stage);
+
+        PppStreamSolution(GnssDataStore_sptr data_ptr);
+        PppStreamSolution(GnssDataStore_sptr data_ptr, double max_sigma);
+        virtual ~PppStreamSolution();
+
+        virtual std::string  fileName() const override
+        {
+            return  opts().SiteRover + "_" + slnType2Str.at(desiredSlnType()) + "_RT";
+        }
+
+        // plays back the observation files of the rover site
+        virtual void process() override;
+
+        // Processes an epoch, whose data were received at 'received'
+        // and decoded in 'decodeTime' (not recorded if zero).
+        // Returns true if a solution was computed.
+        bool processEpoch(gpstk::IRinex& gRin, clock::time_point received,
+            clock::duration decodeTime = clock::duration::zero());
+
+        // processes an epoch received now
+        bool processEpoch(gpstk::IRinex& gRin)
+        {
+            return processEpoch(gRin, clock::now());
+        }
+
+        // Plays back a RINEX 3 observation file
+        void playRinex(const std::string& path);
+
+        // Plays back an RTCM 3 feed with MSM observations;
+        // 'refTime' is a time within a few days of the recording, to
+        // resolve the weeks of the message times.
+        void playRtcm(data_source_uptr source, const gpstk::CommonTime& refTime);
+
+        // Sets the function getting the solution of each epoch
+        PppStreamSolution& setSolutionCallback(SolutionCallback func)
+        {
+            onSolution = func;
+            return *this;
+        }
+
+        // Plays back the recorded feeds at the rate of their epochs,
+        // instead of as fast as possible
+        PppStreamSolution& setRealTime(bool realTime)
+        {
+            isRealTime = realTime;
+            return *this;
+        }
+
+        bool getRealTime() const
+        {
+            return isRealTime;
+        }
+
+        // Keeps the solutions in getData(), as the batch solutions do
+        // (the default); a long running session should not.
+        PppStreamSolution& setKeepEpochs(bool keep)
+        {
+            keepEpochs = keep;
+            return *this;
+        }
+
+        const LatencyHistogram& latency(Stage stage) const
+        {
+            return latencies[stage];
+        }
+
+        // the latency statistics of all the stages, as CSV
+        void printLatency(std::ostream& os) const;
+
+        void clearLatency();
+
+        // number of epochs with a solution
+        size_t epochsProcessed() const
+        {
+            return numEpochs;
+        }
+
+    protected:
+        // loads the products, if needed, and creates the processing objects
+        void init();
+
+        // loads the new product files if 't' is near the end of the products
+        void refreshProducts(const gpstk::CommonTime& t);
+
+        // Reception time of the data of epoch 't', decoded in 'decodeTime'.
+        // In real-time playback the data of an epoch are received at the
+        // time of the epoch, relative to the first one, and this waits
+        // until they are decoded.
+        clock::time_point receivedAt(const gpstk::CommonTime& t, clock::duration decodeTime);
+
+        static double toMicroseconds(clock::duration d)
+        {
+            return std::chrono::duration<double, std::micro>(d).count();
+        }
+
+        SolutionCallback onSolution;
+
+        bool isRealTime;
+        bool keepEpochs;
+
+        // start of the real-time playback, and its first epoch
+        bool playbackStarted;
+        clock::time_point playbackStart;
+        gpstk::CommonTime playbackEpoch;
+
+        // product refresh: margin before the end of the products and
+        // minimum interval between two refreshes, s
+        double refreshMargin;
+        double refreshInterval;
+        gpstk::CommonTime lastRefresh;
+
+        size_t numEpochs;
+
+        LatencyHistogram latencies[NumStages];
+    };
+}
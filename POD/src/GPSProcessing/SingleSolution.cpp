@@ -168,7 +168,7 @@ namespace pod
                     auto ep = opts().fullOutput ? GnssEpoch(gRin.getBody()) : GnssEpoch();
                     // updateNomPos(solverFB);
                     printSolution( solver, t, ep);
-                    gMap.data.insert(std::make_pair(t, ep));
+                    gMap.add(t, ep);
                 }
             }
         }
@@ -184,7 +184,7 @@ namespace pod
                 auto ep = opts().fullOutput ? GnssEpoch(gRin.getBody()) : GnssEpoch();
                 //updateNomPos(solverFB);
                 printSolution( solverFb, gRin.getHeader().epoch, ep);
-                gMap.data.insert(std::make_pair(gRin.getHeader().epoch, ep));
+                gMap.add(gRin.getHeader().epoch, ep);
             }
 			std::cout << "measurments rejected: " << solverFb.rejectedMeasurements << std::endl;
         }
@@ -5,11 +5,26 @@
 
 #include"FsUtils.h"
 #include"ComputeStatistic.h"
+#include"SQLiteEpochSink.h"
+#include"ProcessingProfiler.hpp"
+
+#include<fstream>
 using namespace gpstk;
 namespace pod
 {
 	namespace fs = std::experimental::filesystem;
 
+    namespace
+    {
+        // solution values of the statistic file
+        const TypeIDSet statisticTypes{ TypeID::recX,TypeID::recY,TypeID::recZ };
+
+        fs::path resultPath(CustomSolution& solver, const GnssDataStore& data, const char* ext)
+        {
+            return fs::path(data.opts.workingDir + "\\" + solver.fileName() + ext);
+        }
+    }
+
     Solution::Solution(const char* path) :
         BasicFramework("pod",
                        "discr"),
@@ -30,6 +45,9 @@ namespace pod
     {
         try
         {
+            initSpill(solver, *data);
+            ProcessingProfiler::setTraceCapacity(
+                confReader.getValueAsInt("profileTraceEvents", "DEFAULT", 0));
             solver.process();
         }
         catch (gpstk::Exception & e)
@@ -43,34 +61,31 @@ namespace pod
     }
     void Solution::saveStatistic()
     {
-        auto fName = solver.fileName();
+        saveStatistic(solver, *data);
+    }
+
+    void Solution::saveStatistic(CustomSolution& solver, const GnssDataStore& data)
+    {
         auto& gMap = solver.getData();
 
-        fs::path dbPath(data->opts.workingDir + "\\" + fName + ".txt");
-        TypeIDSet typeSet{ TypeID::recX,TypeID::recY,TypeID::recZ };
-        ComputeStatistic st(solver.desiredSlnType(), typeSet);
+        fs::path dbPath = resultPath(solver, data, ".txt");
+
+        // the statistic of the spilled epochs, completed with those left
+        ComputeStatistic st(solver.desiredSlnType(), statisticTypes);
+        auto spilled = gMap.findSink<ComputeStatistic>();
+        if (spilled && spilled->getSlnType() == st.getSlnType())
+            st = *spilled;
+        for (auto && ep : gMap)
+            st.add(ep.first, ep.second);
 
         Vector<double> sln;
         Matrix<double> covar;
-        st.compute(gMap, sln, covar);
-        int summ(0);
-        double avgSvInView(0);
-        double avgSvInUse(0);
-       
-        //calculate number of desired sln types
-        for_each(
-            gMap.begin(),
-            gMap.end(),
-            [&](const auto & ep)
-        {
-            if ((SlnType)(int)ep.second.slnData.getValue(TypeID::recSlnType) == solver.desiredSlnType())
-            {
-                summ++;
-				avgSvInView += ep.second.satData.size();
-				avgSvInUse += ep.second.slnData.at(TypeID::recUsedSV);
-            }
-        }
-        );
+        st.result(sln, covar);
+
+        //number of desired sln types
+        int summ = st.goodEpochs;
+        double avgSvInView = st.svInView;
+        double avgSvInUse = st.svInUse;
 
         //calculate 3D RMS
         double rms3d = sqrt(covar(0, 0) + covar(1, 1) + covar(2, 2));
@@ -107,24 +122,140 @@ namespace pod
         wrt << std::endl;
     }
 
+    void Solution::saveProfile()
+    {
+        saveProfile(solver, *data);
+    }
+
+    void Solution::saveProfile(CustomSolution& solver, const GnssDataStore& data)
+    {
+        if (!ProcessingProfiler::isCompiledIn())
+            return;
+
+        std::ofstream csv(resultPath(solver, data, "_profile.csv"));
+        ProcessingProfiler::printCSV(csv);
+
+        if (data.confReader->getValueAsInt("profileTraceEvents", "DEFAULT", 0) > 0)
+        {
+            std::ofstream trace(resultPath(solver, data, "_trace.json"));
+            ProcessingProfiler::printChromeTrace(trace);
+        }
+    }
+
     void Solution::saveToDb()
+    {
+        saveToDb(solver, *data, dbWriter);
+    }
+
+    void Solution::moveToDb()
+    {
+        moveToDb(solver, *data, dbWriter);
+    }
+
+    void Solution::waitForDb()
+    {
+        dbWriter.wait();
+    }
+
+    void Solution::saveToDb(CustomSolution& solver, const GnssDataStore& data)
     {
         auto fName = solver.fileName();
         auto& gMap = solver.getData();
+
+        // the database has been filled during the processing
+        if (gMap.findSink<SQLiteEpochSink>())
+        {
+            gMap.flush();
+            return;
+        }
+
         gMap.title = fName;
         gMap.updateMetadata();
 
-        fs::path dbPath(data->opts.workingDir + "\\" + fName + ".db");
+        fs::path dbPath = resultPath(solver, data, ".db");
 
         //delete curtrent solution database file, if exists
         //string cmd = "del \"" + dbPath.string() + "\"";
         //system(cmd.c_str());
 
         //insert solution data into DB 
-        SQLiteAdapter db(dbPath.string());
+        SQLiteAdapter db(dbPath.string(), dbSchema(data));
         db.addNewFile(gMap);
     }
 
+    void Solution::saveToDb(CustomSolution& solver, const GnssDataStore& data,
+                            SQLiteWriter& writer, SQLiteWriter::DoneCallback done)
+    {
+        postToDb(solver, data, writer, done, false);
+    }
+
+    void Solution::moveToDb(CustomSolution& solver, const GnssDataStore& data,
+                            SQLiteWriter& writer, SQLiteWriter::DoneCallback done)
+    {
+        postToDb(solver, data, writer, done, true);
+    }
+
+    void Solution::postToDb(CustomSolution& solver, const GnssDataStore& data,
+                            SQLiteWriter& writer, SQLiteWriter::DoneCallback done,
+                            bool move)
+    {
+        auto fName = solver.fileName();
+        auto& gMap = solver.getData();
+
+        // only the last epochs are left: they are written here
+        if (gMap.findSink<SQLiteEpochSink>())
+        {
+            std::exception_ptr error;
+            try
+            {
+                gMap.flush();
+            }
+            catch (...)
+            {
+                if (!done)
+                    throw;
+                error = std::current_exception();
+            }
+            if (done)
+                done(error);
+            return;
+        }
+
+        gMap.title = fName;
+        gMap.updateMetadata();
+
+        fs::path dbPath = resultPath(solver, data, ".db");
+
+        if (move)
+        {
+            writer.post(dbPath.string(), std::move(gMap), dbSchema(data), done);
+            gMap = GnssEpochMap();
+        }
+        else
+            writer.post(dbPath.string(), GnssEpochMap(gMap), dbSchema(data), done);
+    }
+
+    SQLiteAdapter::Schema Solution::dbSchema(const GnssDataStore& data)
+    {
+        return (SQLiteAdapter::Schema)data.confReader->getValueAsInt("dbSchema", "DEFAULT",
+                                                                     SQLiteAdapter::Normalized);
+    }
+
+    void Solution::initSpill(CustomSolution& solver, const GnssDataStore& data)
+    {
+        int maxEpochs = data.confReader->getValueAsInt("maxEpochsInMemory", "DEFAULT", 0);
+        if (maxEpochs <= 0)
+            return;
+
+        auto fName = solver.fileName();
+        auto& gMap = solver.getData();
+        gMap.title = fName;
+        gMap.setMaxEpochs(maxEpochs);
+        gMap.addSink(std::make_shared<ComputeStatistic>(solver.desiredSlnType(), statisticTypes));
+        gMap.addSink(std::make_shared<SQLiteEpochSink>(resultPath(solver, data, ".db").string(),
+                                                       fName, dbSchema(data)));
+    }
+
     void Solution::chekObs()
     {
         data->checkObservable();
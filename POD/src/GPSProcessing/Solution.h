@@ -6,6 +6,7 @@
 
 #include"GnssEpochMap.h"
 #include"CustomSolution.h"
+#include"SQLiteWriter.h"
 
 
 namespace pod
@@ -22,8 +23,47 @@ namespace pod
         }
         virtual void process();
         void chekObs();
+
+        // Saves the results to the database in the background, from a
+        // copy of them. waitForDb() waits until they are saved.
         void saveToDb();
+        // As saveToDb(), but the results are moved out of the solver, which
+        // is left without epochs: for when they aren't needed any more.
+        void moveToDb();
+        void waitForDb();
         void saveStatistic();
+
+        // With GPSTK_PROFILING, saves the timers and counters of the
+        // processing to <result>_profile.csv and the trace events, if any,
+        // to <result>_trace.json
+        void saveProfile();
+
+        // save the results of 'solver', which processed 'data'
+        static void saveToDb(CustomSolution& solver, const GnssDataStore& data);
+        static void saveStatistic(CustomSolution& solver, const GnssDataStore& data);
+        static void saveProfile(CustomSolution& solver, const GnssDataStore& data);
+
+        // Copies the results of 'solver' to 'writer', which saves them in
+        // its thread and then calls 'done'
+        static void saveToDb(CustomSolution& solver, const GnssDataStore& data,
+                             SQLiteWriter& writer,
+                             SQLiteWriter::DoneCallback done = SQLiteWriter::DoneCallback());
+
+        // Moves the results of 'solver' to 'writer', as saveToDb() copies
+        // them; the solver is left without epochs
+        static void moveToDb(CustomSolution& solver, const GnssDataStore& data,
+                             SQLiteWriter& writer,
+                             SQLiteWriter::DoneCallback done = SQLiteWriter::DoneCallback());
+
+        // database layout of the 'dbSchema' configuration value,
+        // Normalized if it isn't set
+        static SQLiteAdapter::Schema dbSchema(const GnssDataStore& data);
+
+        // If 'maxEpochsInMemory' is set, the results of 'solver' are saved
+        // to the database and added to the statistic as it goes, keeping
+        // only the last epochs in memory; saveToDb() and saveStatistic()
+        // then complete them.
+        static void initSpill(CustomSolution& solver, const GnssDataStore& data);
         GnssEpochMap  getData()
         {
             return solver.getData();
@@ -45,6 +85,16 @@ namespace pod
 
         CustomSolution solver;
 
+        // writes the results to the database
+        SQLiteWriter dbWriter;
+
+    private:
+
+        // saveToDb() and moveToDb(): the results are moved if 'move' is set
+        static void postToDb(CustomSolution& solver, const GnssDataStore& data,
+                             SQLiteWriter& writer, SQLiteWriter::DoneCallback done,
+                             bool move);
+
     };
 }
 
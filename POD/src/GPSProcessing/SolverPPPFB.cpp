@@ -65,7 +65,8 @@ namespace pod
        double clkSigma,
        double weightFactor
    )
-       :SolverPPP(isUseAdvClkModel, tropoQ, posSigma, clkSigma, weightFactor), firstIteration(true)
+       :SolverPPP(isUseAdvClkModel, tropoQ, posSigma, clkSigma, weightFactor), firstIteration(true),
+        lastEpoch(0)
    {
 
        // Initialize the counter of processed measurements
@@ -124,7 +125,7 @@ namespace pod
             //gnssRinex gBak(gData.extractTypeID(keepTypeSet));
 
                // Store observation data
-            ObsData.push_back(gData.clone());
+            ObsData.push_back(gData);
 
             // Update the number of processed measurements
             processedMeasurements += gData.getBody().numSats();
@@ -173,10 +174,10 @@ namespace pod
       {
 
             // Backwards iteration. We must do this at least once
-         for ( auto rpos = ObsData.rbegin(); rpos != ObsData.rend(); ++rpos)
+         for (size_t k = ObsData.size(); k-- > 0;)
          {
 
-            SolverPPP::Process( **rpos );
+            processStored(k);
 
          }
 
@@ -185,15 +186,15 @@ namespace pod
          {
 
                // Forwards iteration
-            for (auto pos = ObsData.begin(); pos != ObsData.end(); ++pos)
+            for (size_t k = 0; k < ObsData.size(); k++)
             {
-               SolverPPP::Process(**pos);
+               processStored(k);
             }
 
                // Backwards iteration.
-            for (auto rpos = ObsData.rbegin(); rpos != ObsData.rend(); ++rpos)
+            for (size_t k = ObsData.size(); k-- > 0;)
             {
-               SolverPPP::Process( **rpos );
+               processStored(k);
             }
 
          }  // End of 'for (int i=0; i<(cycles-1), i++)'
@@ -240,8 +241,8 @@ namespace pod
       {
 
             // Backwards iteration. We must do this at least once
-		  for (auto rpos = ObsData.rbegin(); rpos != ObsData.rend(); ++rpos)
-			  SolverPPP::Process(**rpos);
+		  for (size_t k = ObsData.size(); k-- > 0;)
+			  processStored(k);
 
 
             // If both sizes are '0', let's return
@@ -276,29 +277,17 @@ namespace pod
 
 
                // Forwards iteration
-            for (auto pos = ObsData.begin(); pos != ObsData.end(); ++pos)
+            for (size_t k = 0; k < ObsData.size(); k++)
             {
-                  // Let's check limits
-               checkLimits( **pos, codeLimit, phaseLimit );
-               
-               if ((*pos)->getBody().size() == 0)
-               {
-                   Exception e("Rejected all satellites at reprocessing part, check phase and code limits");
-                   GPSTK_THROW(e);
-               }
-                   
-                  // Process data
-			   SolverPPP::Process(**pos);
+                  // Let's check limits and process data
+               processStored(k, true, codeLimit, phaseLimit);
             }
 
                // Backwards iteration.
-            for (auto rpos = ObsData.rbegin(); rpos != ObsData.rend(); ++rpos)
+            for (size_t k = ObsData.size(); k-- > 0;)
             {
-                  // Let's check limits
-               checkLimits( **rpos, codeLimit, phaseLimit );
-
-                  // Process data
-			   SolverPPP::Process(**rpos);
+                  // Let's check limits and process data
+               processStored(k, true, codeLimit, phaseLimit);
             }
 
          }  // End of 'for (int i=0; i<(cycles-1), i++)'
@@ -332,17 +321,15 @@ namespace pod
    {
       try
       {
-            // Keep processing while 'ObsData' is not empty
-         if( !(ObsData.empty()) )
+            // Keep processing while there are stored epochs left
+         if( lastEpoch < ObsData.size() )
          {
 
-               // Get the first data epoch in 'ObsData' and process it. The
+               // Get the next data epoch in 'ObsData' and process it. The
                // result will be stored in 'gData'
-			 gData = SolverPPP::Process(*ObsData.front());
-            // gData = ObsData.front();
-               // Remove the first data epoch in 'ObsData', freeing some
-               // memory and preparing for next epoch
-            ObsData.pop_front();
+            RinexEpoch epoch;
+            ObsData.read(lastEpoch++, epoch);
+			 gData = SolverPPP::Process(epoch);
 
             // Update some inherited fields
             solution = SolverPPP::solution;
@@ -364,10 +351,12 @@ namespace pod
          }
          else
          {
-               // There are no more data
+               // There are no more data, free the log
+            ObsData.clear();
+            lastEpoch = 0;
             return false;
 
-         }  // End of 'if( !(ObsData.empty()) )'
+         }  // End of 'if( lastEpoch < ObsData.size() )'
 
       }
       catch(Exception& u)
@@ -421,4 +410,35 @@ namespace pod
    }  // End of method 'SolverPPPFB::checkLimits()'
 
 
+
+      // Processes stored epoch 'i' and stores the result back.
+   void SolverPPPFB::processStored( size_t i,
+                                    bool checkLim,
+                                    double codeLimit,
+                                    double phaseLimit )
+   {
+
+      RinexEpoch epoch;
+      ObsData.read(i, epoch);
+
+      if( checkLim )
+      {
+            // Let's check limits
+         checkLimits( epoch, codeLimit, phaseLimit );
+
+         if (epoch.getBody().size() == 0)
+         {
+             Exception e("Rejected all satellites at reprocessing part, check phase and code limits");
+             GPSTK_THROW(e);
+         }
+      }
+
+         // Process data
+      SolverPPP::Process(epoch);
+
+      ObsData.write(i, epoch);
+
+   }  // End of method 'SolverPPPFB::processStored()'
+
+
 }  // End of namespace gpstk
@@ -44,6 +44,7 @@
 #define POD_SOLVERPPPFB_HPP
 
 #include "SolverPPP.hpp"
+#include "RinexEpochLog.h"
 #include <list>
 #include <set>
 
@@ -414,6 +415,21 @@ namespace pod
       { limitsPhaseList.clear(); return (*this); };
 
 
+         /** Keeps the data stored for reprocessing in a temporary file
+          *  instead of memory.
+          *
+          * @param spill      True to use a temporary file.
+          */
+      virtual SolverPPPFB& setSpillToDisk( bool spill )
+      { ObsData.setSpillToDisk( spill ); return (*this); };
+
+
+         /// Returns true if the data stored for reprocessing is kept in a
+         /// temporary file.
+      virtual bool getSpillToDisk(void) const
+      { return ObsData.getSpillToDisk(); };
+
+
          /// Returns the number of processed measurements.
       virtual int getProcessedMeasurements(void) const
       { return processedMeasurements; };
@@ -438,8 +454,12 @@ namespace pod
       bool firstIteration;
 
 
-         /// List holding the information regarding every observation.
-      std::list< gpstk::irinex_uptr> ObsData;
+         /// Log holding the information regarding every observation.
+      gpstk::RinexEpochLog ObsData;
+
+
+         /// Next stored epoch returned by 'LastProcess()'.
+      size_t lastEpoch;
 
       std::list< Vector<double>> sols;
       std::list< Vector<double>> ress;
@@ -469,6 +489,16 @@ namespace pod
       void checkLimits(IRinex& gData, double codeLimit, double phaseLimit );
 
 
+         /** Processes stored epoch 'i' and stores the result back.
+          *
+          * @param i          Index of the epoch in 'ObsData'.
+          * @param checkLim   If true, satellites off the limits are
+          *                   removed before processing.
+          */
+      void processStored( size_t i, bool checkLim = false,
+                          double codeLimit = 0.0, double phaseLimit = 0.0 );
+
+
          // Some methods that we want to hide
       virtual int Compute( const Vector<double>& prefitResiduals,
                            const Matrix<double>& designMatrix )
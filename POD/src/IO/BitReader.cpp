@@ -0,0 +1,61 @@
+#include"BitReader.hpp"
+
+namespace pod
+{
+	std::uint64_t BitReader::load(int i) const
+	{
+		std::uint64_t w = 0;
+		if (i + 8 <= nbytes)
+		{
+			const uchar* p = data + i;
+			w = (std::uint64_t(p[0]) << 56) | (std::uint64_t(p[1]) << 48) |
+				(std::uint64_t(p[2]) << 40) | (std::uint64_t(p[3]) << 32) |
+				(std::uint64_t(p[4]) << 24) | (std::uint64_t(p[5]) << 16) |
+				(std::uint64_t(p[6]) << 8) | std::uint64_t(p[7]);
+		}
+		else
+		{
+			for (int k = 0; k < 8; k++)
+				w = (w << 8) | ((i + k < nbytes) ? data[i + k] : 0);
+		}
+		return w;
+	}
+
+	std::uint64_t BitReader::getUint64(int i0, int len) const
+	{
+		if (len <= 0)
+			return 0;
+
+		int shift = i0 & 7;
+		if (shift + len > 64)
+		{
+			// the field covers 9 bytes
+			int lenLo = len - 32;
+			return (getUint64(i0, 32) << lenLo) | getUint64(i0 + 32, lenLo);
+		}
+		return (load(i0 >> 3) << shift) >> (64 - len);
+	}
+
+	std::int64_t BitReader::getInt64(int i0, int len) const
+	{
+		if (len <= 0)
+			return 0;
+
+		std::uint64_t u = getUint64(i0, len) << (64 - len);
+		return static_cast<std::int64_t>(u) >> (64 - len);
+	}
+
+	int BitReader::getSignMag32(int i0, int len) const
+	{
+		int mag = static_cast<int>(getUint64(i0 + 1, len - 1));
+		return getBit(i0) ? -mag : mag;
+	}
+
+	std::string BitReader::getString(int i0, int n) const
+	{
+		std::string s(n, '\0');
+		for (int i = 0; i < n; i++)
+			s[i] = static_cast<char>(getUint64(i0 + 8 * i, 8));
+		return s;
+	}
+}
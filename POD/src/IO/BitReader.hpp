@@ -0,0 +1,62 @@
+#pragma once
+#include"typenames.hpp"
+
+#include<cstdint>
+#include<string>
+
+namespace pod
+{
+	// Reads the bit fields of an RTCM message, most significant bit first.
+	// A field is read with one or two 64-bit loads and shifts, straight
+	// from the message bytes; the bits past the end of the data read as 0.
+	class BitReader
+	{
+	public:
+		BitReader(const uchar* data, int len)
+			:data(data), nbytes(len) {}
+
+		~BitReader() = default;
+
+		// number of bits
+		int size() const
+		{
+			return nbytes * 8;
+		}
+
+		bool getBit(int i0) const
+		{
+			return getUint64(i0, 1) != 0;
+		}
+
+		// unsigned field of up to 32 bits
+		uint getUint32(int i0, int len) const
+		{
+			return static_cast<uint>(getUint64(i0, len));
+		}
+
+		// two's complement field of up to 32 bits
+		int getInt32(int i0, int len) const
+		{
+			return static_cast<int>(getInt64(i0, len));
+		}
+
+		// sign-magnitude field of up to 32 bits, as DF 'intS' of RTCM
+		int getSignMag32(int i0, int len) const;
+
+		// unsigned field of up to 64 bits
+		std::uint64_t getUint64(int i0, int len) const;
+
+		// two's complement field of up to 64 bits
+		std::int64_t getInt64(int i0, int len) const;
+
+		// 'n' characters from bit 'i0'
+		std::string getString(int i0, int n) const;
+
+	private:
+		// the 8 bytes from byte 'i', big-endian
+		std::uint64_t load(int i) const;
+
+		const uchar* data;
+		int nbytes;
+	};
+}
@@ -129,7 +129,7 @@ namespace pod
 	{
 		for (int i = 0; i < bitSet.bits().size(); i++)
 		{
-			if (i % 8 == 0) std::cout << ' ';
+			if (i % 8 == 0) o << ' ';
 			o << bitSet.bits()[i];
 		}
 		return o;
@@ -8,6 +8,8 @@ namespace pod
 	class IdataSource
 	{
 	public:
+		virtual ~IdataSource() = default;
+
 		virtual std::string readLine() = 0;
 		
 		virtual unsigned char readByte()  = 0;
@@ -20,6 +22,17 @@ namespace pod
 
 		virtual void readBytes(unsigned char *buff, int offset, int len) = 0;
 
+		// Reads up to 'len' bytes, as many as are available.
+		// Returns the number of bytes read, 0 if none is available yet,
+		// or -1 at the end of the data.
+		virtual int read(unsigned char *buff, int len)
+		{
+			if (len <= 0)
+				return 0;
+			buff[0] = readByte();
+			return 1;
+		}
+
 	};
 	typedef std::unique_ptr<IdataSource> data_source_uptr;
 }
\ No newline at end of file
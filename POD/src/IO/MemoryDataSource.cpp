@@ -0,0 +1,57 @@
+#include"MemoryDataSource.hpp"
+
+#include<algorithm>
+#include<cstring>
+
+namespace pod
+{
+	std::string MemoryDataSource::readLine()
+	{
+		std::string line;
+		while (pos < bytes.size())
+		{
+			char c = bytes[pos++];
+			if (c == '\n')
+				break;
+			if (c != '\r')
+				line += c;
+		}
+		return line;
+	}
+
+	unsigned char MemoryDataSource::readByte()
+	{
+		return (pos < bytes.size()) ? bytes[pos++] : 0;
+	}
+
+	unsigned short MemoryDataSource::readWord()
+	{
+		unsigned short w = 0;
+		readBytes(reinterpret_cast<unsigned char*>(&w), 0, 2);
+		return w;
+	}
+
+	void MemoryDataSource::readBytes(unsigned char* buff, int offset, int len)
+	{
+		size_t n = std::min<size_t>(len, bytes.size() - pos);
+		std::memcpy(buff + offset, bytes.data() + pos, n);
+		std::memset(buff + offset + n, 0, len - n);
+		pos += n;
+	}
+
+	int MemoryDataSource::read(unsigned char* buff, int len)
+	{
+		if (pos >= bytes.size())
+			return -1;
+
+		stalled = stalls && !stalled;
+		if (stalled)
+			return 0;
+
+		size_t n = std::min<size_t>(std::min<size_t>(len, chunkSize),
+			bytes.size() - pos);
+		std::memcpy(buff, bytes.data() + pos, n);
+		pos += n;
+		return static_cast<int>(n);
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include"IdataSource.hpp"
+
+#include<vector>
+
+namespace pod
+{
+	// Data held in memory, delivered in chunks like the segments of a TCP
+	// stream. With 'stall' set, every other call of read() returns 0, as a
+	// non-blocking socket with no data ready. Used to replay a recorded
+	// stream in tests and benchmarks.
+	class MemoryDataSource :public IdataSource
+	{
+	public:
+		MemoryDataSource(std::vector<unsigned char> data,
+			size_t chunk = 1460, bool stall = false)
+			:bytes(std::move(data)), pos(0), chunkSize(chunk),
+			stalls(stall), stalled(false) {}
+
+		virtual ~MemoryDataSource() = default;
+
+		virtual std::string readLine() override;
+
+		virtual unsigned char readByte() override;
+
+		virtual unsigned short readWord() override;
+
+		virtual void readBytes(unsigned char *buff, int offset, int len) override;
+
+		virtual int read(unsigned char *buff, int len) override;
+
+		// starts again from the first byte
+		void rewind()
+		{
+			pos = 0;
+		}
+
+		size_t size() const
+		{
+			return bytes.size();
+		}
+
+	private:
+		std::vector<unsigned char> bytes;
+		size_t pos;
+		size_t chunkSize;
+		bool stalls;
+		bool stalled;
+	};
+}
@@ -0,0 +1,70 @@
+#include"RingBuffer.hpp"
+
+#include<algorithm>
+#include<cstring>
+
+namespace pod
+{
+	RingBuffer::RingBuffer(size_t capacity)
+		:mask(0), head(0), tail(0)
+	{
+		size_t n = 1;
+		while (n < capacity)
+			n <<= 1;
+		buff.resize(n);
+		mask = n - 1;
+	}
+
+	uchar* RingBuffer::writePtr(size_t& len)
+	{
+		size_t i = tail & mask;
+		len = std::min(space(), buff.size() - i);
+		return &buff[i];
+	}
+
+	void RingBuffer::commit(size_t n)
+	{
+		tail += std::min(n, space());
+	}
+
+	size_t RingBuffer::write(const uchar* data, size_t len)
+	{
+		size_t done = 0;
+		while (done < len)
+		{
+			size_t n;
+			uchar* p = writePtr(n);
+			if (n == 0)
+				break;
+			n = std::min(n, len - done);
+			std::memcpy(p, data + done, n);
+			commit(n);
+			done += n;
+		}
+		return done;
+	}
+
+	const uchar* RingBuffer::readPtr(size_t& len) const
+	{
+		size_t i = head & mask;
+		len = std::min(size(), buff.size() - i);
+		return &buff[i];
+	}
+
+	void RingBuffer::consume(size_t n)
+	{
+		head += std::min(n, size());
+	}
+
+	const uchar* RingBuffer::linear(size_t i, size_t n, uchar* scratch) const
+	{
+		size_t first = (head + i) & mask;
+		if (first + n <= buff.size())
+			return &buff[first];
+
+		size_t n1 = buff.size() - first;
+		std::memcpy(scratch, &buff[first], n1);
+		std::memcpy(scratch + n1, &buff[0], n - n1);
+		return scratch;
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include"typenames.hpp"
+
+#include<cstddef>
+#include<vector>
+
+namespace pod
+{
+	// Byte queue over a fixed buffer, for the data read from a source.
+	// The bytes are written at the back, through writePtr() and commit(),
+	// and consumed from the front. The capacity is a power of 2, so the
+	// positions wrap with a mask.
+	class RingBuffer
+	{
+	public:
+		// 'capacity' is rounded up to a power of 2
+		explicit RingBuffer(size_t capacity = 1 << 16);
+
+		~RingBuffer() = default;
+
+		// number of bytes stored
+		size_t size() const
+		{
+			return tail - head;
+		}
+
+		size_t capacity() const
+		{
+			return buff.size();
+		}
+
+		// number of bytes that can be written
+		size_t space() const
+		{
+			return buff.size() - size();
+		}
+
+		// byte 'i' from the front
+		uchar operator[](size_t i) const
+		{
+			return buff[(head + i) & mask];
+		}
+
+		// Free space at the back, contiguous in memory;
+		// its size is returned in 'len'.
+		uchar* writePtr(size_t& len);
+
+		// adds the 'n' bytes written at writePtr()
+		void commit(size_t n);
+
+		// copies up to 'len' bytes at the back, returns the number copied
+		size_t write(const uchar* data, size_t len);
+
+		// Bytes at the front, contiguous in memory;
+		// their number is returned in 'len'.
+		const uchar* readPtr(size_t& len) const;
+
+		// removes 'n' bytes from the front
+		void consume(size_t n);
+
+		// Returns the 'n' bytes from 'i' as contiguous memory: in place if
+		// they do not wrap, otherwise copied to 'scratch'.
+		const uchar* linear(size_t i, size_t n, uchar* scratch) const;
+
+		void clear()
+		{
+			head = tail = 0;
+		}
+
+	private:
+		std::vector<uchar> buff;
+		size_t mask;
+
+		// positions of the front and of the back, never wrapped
+		size_t head;
+		size_t tail;
+	};
+}
@@ -1,55 +1,152 @@
 #include"Rtcm3Decoder.hpp"
-#include"RtcmUtils.hpp"
-#include"BitSetProxy.hpp"
+#include"BitReader.hpp"
+#include"Rinex3EphemerisStore.hpp"
+#include"Rinex3NavData.hpp"
+#include"GPSWeekSecond.hpp"
+#include"CivilTime.hpp"
+#include"SystemTime.hpp"
+#include"TimeConstants.hpp"
+
+#include<chrono>
+#include<thread>
 
 using namespace gpstk;
 
 namespace pod
 {
-
-	void Rtcm3Decoder::run()
+	Rtcm3Decoder::Rtcm3Decoder()
+		:ephStore(nullptr), numEpochs(0), stopRequested(false)
 	{
-		uchar buff[MAX_MSG_LEN];
+		setReferenceTime(SystemTime().convertToCommonTime());
+	}
 
-		std::map<int, rtcm3_msg_uptr> parsers;
-		for (auto&& it : msgsToParse)
-			parsers[it->getID()] = it->clone();
+	Rtcm3Decoder::Rtcm3Decoder(data_source_uptr ptr)
+		:ephStore(nullptr), source(std::move(ptr)), numEpochs(0),
+		stopRequested(false)
+	{
+		setReferenceTime(SystemTime().convertToCommonTime());
+	}
 
-		while (true)
+	void Rtcm3Decoder::run()
+	{
+		stopRequested = false;
+		while (!stopRequested)
 		{
-			uchar c = source->readByte();
-			if (c == PREAMBLE)
+			size_t len;
+			uchar* buff = frames.buffer().writePtr(len);
+			int n = source->read(buff, static_cast<int>(len));
+			if (n < 0)
+				break;
+			if (n == 0)
 			{
-				std::cout << c <<  std::endl;
-				uchar  lenchars[2];
-				source->readBytes(lenchars, 2);
-				BitSetProxy len_bsp(lenchars, 0, 2);
-				std::cout << len_bsp << std::endl;
-				ushort len = len_bsp.getUint32(6, 10);
-				//std::memcpy(&len, lenchars, 2);
-				
-				//std::cout << (int)(lenchars[0]) <<' '<< (int)lenchars[1] << std::endl;
-				//std::cout << (len) << std::endl;
-				if (len < MAX_MSG_LEN)
-				{
-					source->readBytes(buff, 3, len + 3);
-					buff[0] = PREAMBLE;
-					buff[1] = lenchars[0];
-					buff[2] = lenchars[1];
-
-
-					bool check = RtcmUtils::crc24q_check(buff, len + 6);
-					//std::cout << check << ": " << len << std::endl;
-					if (check)
-					{
-						BitSetProxy msg_bsp(buff, 3, len);
-						int msgId = msg_bsp.getUint32(0, 12);
-						auto msg = parsers.find(msgId);
-						if (msg != parsers.end())
-							msg->second->parse(msg_bsp, *this);
-					}
-				}
+				// nothing available yet
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				continue;
 			}
+			frames.buffer().commit(n);
+			decodeFrames();
+		}
+		flushEpoch();
+	}
+
+	size_t Rtcm3Decoder::feed(const uchar* data, size_t len)
+	{
+		size_t count = 0;
+		while (len > 0)
+		{
+			size_t n = frames.push(data, len);
+			data += n;
+			len -= n;
+			count += decodeFrames();
+		}
+		return count;
+	}
+
+	size_t Rtcm3Decoder::decodeFrames()
+	{
+		size_t count = 0;
+		const uchar* msg;
+		int len;
+		while (frames.next(msg, len))
+		{
+			count++;
+			BitReader reader(msg, len);
+			int msgId = reader.getUint32(0, 12);
+			auto parser = parsers.find(msgId);
+			if (parser != parsers.end())
+				parser->second->parse(reader, *this);
+		}
+		return count;
+	}
+
+	void Rtcm3Decoder::setReferenceTime(const CommonTime& t)
+	{
+		refTime = t;
+		refTime.setTimeSystem(TimeSystem::GPS);
+		CivilTime ct(refTime);
+		leapSec = TimeSystem::getLeapSeconds(ct.year, ct.month, ct.day) - 19;
+	}
+
+	CommonTime Rtcm3Decoder::timeOfWeek(double tow) const
+	{
+		if (tow >= FULLWEEK)
+			tow -= FULLWEEK;
+		GPSWeekSecond ref(refTime);
+		int week = ref.week;
+		double dt = tow - ref.sow;
+		if (dt < -HALFWEEK)
+			week++;
+		else if (dt > HALFWEEK)
+			week--;
+		return GPSWeekSecond(week, tow, TimeSystem::GPS);
+	}
+
+	CommonTime Rtcm3Decoder::utcTimeOfDay(double tod) const
+	{
+		CommonTime utc(refTime);
+		utc -= leapSec;
+		utc.setTimeSystem(TimeSystem::UTC);
+		double dt = tod - utc.getSecondOfDay();
+		if (dt < -SEC_PER_DAY / 2)
+			dt += SEC_PER_DAY;
+		else if (dt > SEC_PER_DAY / 2)
+			dt -= SEC_PER_DAY;
+		return utc + dt;
+	}
+
+	IRinex& Rtcm3Decoder::epochAt(const CommonTime& t)
+	{
+		if (t != currEp.getHeader().epoch)
+		{
+			flushEpoch();
+			currEp.getHeader().epoch = t;
+			currEp.getHeader().epochFlag = 0;
+			refTime = t;
 		}
+		return currEp;
+	}
+
+	void Rtcm3Decoder::flushEpoch()
+	{
+		if (currEp.getRinex().body.empty())
+			return;
+
+		currEp.resetCurrData();
+		numEpochs++;
+		if (onEpochReceived)
+			onEpochReceived(currEp);
+
+		// the header is kept: the next messages may be of the same epoch
+		CommonTime t = currEp.getHeader().epoch;
+		currEp = RinexEpoch();
+		currEp.getHeader().epoch = t;
+	}
+
+	void Rtcm3Decoder::addEphemeris(const Rinex3NavData& nav)
+	{
+		if (ephStore)
+			ephStore->addEphemeris(nav);
+		if (onEphemerisReceived)
+			onEphemerisReceived(nav);
 	}
-}
\ No newline at end of file
+}
@@ -1,46 +1,150 @@
 #pragma once
 #include"IdataSource.hpp"
 #include"RinexEpoch.h"
+#include"Rtcm3Framer.hpp"
 #include"Rtcm3MessageBase.hpp"
 #include"typenames.hpp"
 
+#include"CommonTime.hpp"
+
+#include<atomic>
+#include<functional>
+#include<map>
 #include<memory>
+#include<set>
+
+namespace gpstk
+{
+	class Rinex3NavData;
+	class Rinex3EphemerisStore;
+}
 
 namespace pod
 {
 
     class Rtcm3MessageBase;
 	typedef std::unique_ptr<Rtcm3MessageBase> rtcm3_msg_uptr;
+
+	// Decodes the RTCM 3 messages of a stream.
+	// The bytes are read in blocks to the ring buffer of an Rtcm3Framer,
+	// and each valid frame goes to the parser of its message type.
+	// The decoder can read its own source with run(), or be fed by the
+	// caller with feed(), e.g. to serve many streams from one thread.
+	//
+	// The observation messages of an epoch are gathered in one RinexEpoch,
+	// which is given to the epoch callback when the last message of the
+	// epoch arrives (its 'multiple message' bit is 0) or when a message of
+	// a later epoch arrives. The ephemerides go to the ephemeris store and
+	// callback, if set.
 	class Rtcm3Decoder
 	{
 	public:
-		static const uchar PREAMBLE = 0b11010011;
-		static const int MAX_MSG_LEN = 1024;
+		static const uchar PREAMBLE = Rtcm3Framer::PREAMBLE;
+		static const int MAX_MSG_LEN = Rtcm3Framer::MAX_MSG_LEN;
+
+		typedef std::function<void(gpstk::IRinex&)> EpochCallback;
+		typedef std::function<void(const gpstk::Rinex3NavData&)> EphemerisCallback;
+
+		// decoder fed with feed()
+		Rtcm3Decoder();
+
+		Rtcm3Decoder(data_source_uptr ptr);
 
-		Rtcm3Decoder(data_source_uptr ptr)
-			:source(std::move(ptr)) {}
 		~Rtcm3Decoder() = default;
 
-		// start decoding data from source specific
+		// Decodes the data of the source until its end or a call of stop().
+		// The stop is seen between two reads of the source: a source that
+		// blocks delays it until its read returns.
 		void run();
 
+		// Asks run() to return; may be called from any thread.
+		void stop()
+		{
+			stopRequested = true;
+		}
+
+		// Decodes 'len' bytes received by the caller.
+		// Returns the number of frames decoded.
+		size_t feed(const uchar* data, size_t len);
+
 		//get
 		const std::set<rtcm3_msg_uptr>& messages() const
 		{
 			return msgsToParse;
 		}
 
+		// framing counters: bytes, frames, CRC errors
+		const Rtcm3Framer& framer() const
+		{
+			return frames;
+		}
+
 		template<typename T>	
 		Rtcm3Decoder& addMessage()
 		{
-			static_assert(std::is_base_of<Rtcm3MessageBase, T>::value);
-			msgsToParse.emplace(std::make_unique<T>());
+			static_assert(std::is_base_of<Rtcm3MessageBase, T>::value, "not an RTCM 3 message");
+			auto msg = std::make_unique<T>();
+			parsers[msg->getID()] = msg->clone();
+			msgsToParse.emplace(std::move(msg));
 			return *this;
 		}
 
-		void setEpochReceivedCallback(void(*func)(gpstk::IRinex&))
+		// Sets the function getting the complete epochs,
+		// e.g. the Process() of a processing list.
+		void setEpochReceivedCallback(EpochCallback func)
 		{
-			onEpochReceived =func;
+			onEpochReceived = func;
+		}
+
+		// Sets the function getting the decoded ephemerides.
+		void setEphemerisReceivedCallback(EphemerisCallback func)
+		{
+			onEphemerisReceived = func;
+		}
+
+		// Sets the store the decoded ephemerides are added to;
+		// the store is not owned by the decoder.
+		void setEphemerisStore(gpstk::Rinex3EphemerisStore* store)
+		{
+			ephStore = store;
+		}
+
+		// Sets the time used to resolve the week and day of the message
+		// times; by default it is the system time at construction.
+		// It follows the epochs decoded.
+		void setReferenceTime(const gpstk::CommonTime& t);
+
+		const gpstk::CommonTime& referenceTime() const
+		{
+			return refTime;
+		}
+
+		// GPS - UTC at the reference time (s)
+		double leapSeconds() const
+		{
+			return leapSec;
+		}
+
+		// GPS time with the time of week 'tow', nearest to the reference time
+		gpstk::CommonTime timeOfWeek(double tow) const;
+
+		// UTC time with the time of day 'tod', nearest to the reference time
+		gpstk::CommonTime utcTimeOfDay(double tod) const;
+
+		// Current epoch for the observations at 't'; the data of an earlier
+		// epoch are passed to the epoch callback first.
+		gpstk::IRinex& epochAt(const gpstk::CommonTime& t);
+
+		// Passes the current epoch, if not empty, to the epoch callback.
+		void flushEpoch();
+
+		// Adds an ephemeris decoded to the store and passes it to the callback.
+		void addEphemeris(const gpstk::Rinex3NavData& nav);
+
+		// number of epochs passed to the callback
+		size_t epochsDecoded() const
+		{
+			return numEpochs;
 		}
 		
 		const gpstk::IRinex& currEpoch() const
@@ -55,10 +159,23 @@ namespace pod
 
 	private:
 
-		void(*onEpochReceived)(gpstk::IRinex&);
+		// parses the complete frames of the buffer, returns their number
+		size_t decodeFrames();
+
+		EpochCallback onEpochReceived;
+		EphemerisCallback onEphemerisReceived;
+		gpstk::Rinex3EphemerisStore* ephStore;
 		data_source_uptr source;
 		std::set<rtcm3_msg_uptr> msgsToParse;
+		std::map<int, rtcm3_msg_uptr> parsers;
 		gpstk::RinexEpoch currEp;
+		size_t numEpochs;
+
+		gpstk::CommonTime refTime;
+		double leapSec;
+
+		Rtcm3Framer frames;
+		std::atomic<bool> stopRequested;
 	};
 
 }
@@ -0,0 +1,323 @@
+#include"Rtcm3EphMessage.hpp"
+#include"GNSSconstants.hpp"
+#include"GPSWeekSecond.hpp"
+#include"BDSWeekSecond.hpp"
+
+#include<cmath>
+
+using namespace gpstk;
+
+namespace pod
+{
+	namespace
+	{
+		// semicircles to radians
+		const double SC2RAD = PI;
+
+		// 2^-n
+		inline double p2(int n)
+		{
+			return std::ldexp(1.0, -n);
+		}
+
+		// URA index of GPS and BeiDou to meters
+		double uraToMeters(int ura)
+		{
+			static const double table[] = { 2.4, 3.4, 4.85, 6.85, 9.65, 13.65, 24.0, 48.0,
+				96.0, 192.0, 384.0, 768.0, 1536.0, 3072.0, 6144.0 };
+			return (ura < 0 || ura > 14) ? 6144.0 : table[ura];
+		}
+
+		// Galileo SISA index to meters
+		double sisaToMeters(int sisa)
+		{
+			if (sisa < 50) return sisa * 0.01;
+			if (sisa < 75) return 0.5 + (sisa - 50) * 0.02;
+			if (sisa < 100) return 1.0 + (sisa - 75) * 0.04;
+			if (sisa < 126) return 2.0 + (sisa - 100) * 0.16;
+			return -1.0;
+		}
+
+		// the full week of a week number known modulo 'mod', nearest to 'refWeek'
+		int fullWeek(int week, int mod, int refWeek)
+		{
+			int k = static_cast<int>(std::floor(double(refWeek - week) / mod + 0.5));
+			return week + k * mod;
+		}
+
+		// Sets the transmit time of 'nav': the reference time of the
+		// decoder, or the start of the fit interval if the reference
+		// time is not within a day of the ephemeris epoch.
+		void setTransmitTime(Rinex3NavData& nav, const CommonTime& toe, double dtRef, bool bds)
+		{
+			CommonTime xmit(toe);
+			if (std::abs(dtRef) < SEC_PER_DAY)
+				xmit += dtRef;
+			else
+				xmit -= 7200;
+
+			if (bds)
+			{
+				BDSWeekSecond ws(xmit);
+				nav.weeknum = ws.week;
+				nav.xmitTime = static_cast<long>(ws.sow);
+			}
+			else
+			{
+				GPSWeekSecond ws(xmit);
+				nav.weeknum = ws.week;
+				nav.xmitTime = static_cast<long>(ws.sow);
+			}
+		}
+
+		// reference time of the decoder minus 'toe', in the same time scale
+		double sinceReference(const CommonTime& toe, Rtcm3Decoder& decoder, double offset)
+		{
+			CommonTime ref(decoder.referenceTime());
+			ref += offset;
+			ref.setTimeSystem(toe.getTimeSystem());
+			return ref - toe;
+		}
+	}
+
+	bool Rtcm3_Ephemeris::parse(const BitReader &buffer, Rtcm3Decoder& decoder)
+	{
+		nav = Rinex3NavData();
+		if (!decode(buffer, decoder))
+			return false;
+		decoder.addEphemeris(nav);
+		return true;
+	}
+
+	bool Rtcm3_1019::decode(const BitReader &buffer, Rtcm3Decoder& decoder)
+	{
+		if (buffer.size() < 488)
+			return false;
+
+		int i = 12;
+		int prn = buffer.getUint32(i, 6); i += 6;
+		int week = buffer.getUint32(i, 10); i += 10;
+		int ura = buffer.getUint32(i, 4); i += 4;
+		nav.codeflgs = buffer.getUint32(i, 2); i += 2;
+		nav.idot = buffer.getInt32(i, 14) * p2(43) * SC2RAD; i += 14;
+		nav.IODE = buffer.getUint32(i, 8); i += 8;
+		double toc = buffer.getUint32(i, 16) * 16.0; i += 16;
+		nav.af2 = buffer.getInt32(i, 8) * p2(55); i += 8;
+		nav.af1 = buffer.getInt32(i, 16) * p2(43); i += 16;
+		nav.af0 = buffer.getInt32(i, 22) * p2(31); i += 22;
+		nav.IODC = buffer.getUint32(i, 10); i += 10;
+		nav.Crs = buffer.getInt32(i, 16) * p2(5); i += 16;
+		nav.dn = buffer.getInt32(i, 16) * p2(43) * SC2RAD; i += 16;
+		nav.M0 = buffer.getInt32(i, 32) * p2(31) * SC2RAD; i += 32;
+		nav.Cuc = buffer.getInt32(i, 16) * p2(29); i += 16;
+		nav.ecc = buffer.getUint32(i, 32) * p2(33); i += 32;
+		nav.Cus = buffer.getInt32(i, 16) * p2(29); i += 16;
+		nav.Ahalf = buffer.getUint32(i, 32) * p2(19); i += 32;
+		nav.Toe = buffer.getUint32(i, 16) * 16.0; i += 16;
+		nav.Cic = buffer.getInt32(i, 16) * p2(29); i += 16;
+		nav.OMEGA0 = buffer.getInt32(i, 32) * p2(31) * SC2RAD; i += 32;
+		nav.Cis = buffer.getInt32(i, 16) * p2(29); i += 16;
+		nav.i0 = buffer.getInt32(i, 32) * p2(31) * SC2RAD; i += 32;
+		nav.Crc = buffer.getInt32(i, 16) * p2(5); i += 16;
+		nav.w = buffer.getInt32(i, 32) * p2(31) * SC2RAD; i += 32;
+		nav.OMEGAdot = buffer.getInt32(i, 24) * p2(43) * SC2RAD; i += 24;
+		nav.Tgd = buffer.getInt32(i, 8) * p2(31); i += 8;
+		nav.health = buffer.getUint32(i, 6); i += 6;
+		nav.L2Pdata = buffer.getUint32(i, 1); i += 1;
+		// 0 - 4 hours, 1 - more
+		nav.fitint = buffer.getUint32(i, 1); i += 1;
+
+		if (prn == 0)
+			return false;
+		week = fullWeek(week, 1024, GPSWeekSecond(decoder.referenceTime()).week);
+
+		nav.satSys = "G";
+		nav.PRNID = prn;
+		nav.sat = RinexSatID(prn, SatID::systemGPS);
+		nav.accuracy = uraToMeters(ura);
+		nav.Toc = toc;
+		nav.time = GPSWeekSecond(week, toc, TimeSystem::GPS);
+
+		CommonTime toe = GPSWeekSecond(week, nav.Toe, TimeSystem::GPS);
+		setTransmitTime(nav, toe, sinceReference(toe, decoder, 0), false);
+		return true;
+	}
+
+	bool Rtcm3_1020::decode(const BitReader &buffer, Rtcm3Decoder& decoder)
+	{
+		if (buffer.size() < 360)
+			return false;
+
+		int i = 12;
+		int prn = buffer.getUint32(i, 6); i += 6;
+		int fcn = int(buffer.getUint32(i, 5)) - 7; i += 5;
+		// almanac health and its availability
+		i += 2;
+		i += 2;
+		int tkH = buffer.getUint32(i, 5); i += 5;
+		int tkM = buffer.getUint32(i, 6); i += 6;
+		int tkS = buffer.getUint32(i, 1) * 30; i += 1;
+		int bn = buffer.getUint32(i, 1); i += 1;
+		// P2
+		i += 1;
+		int tb = buffer.getUint32(i, 7); i += 7;
+		nav.vx = buffer.getSignMag32(i, 24) * p2(20); i += 24;
+		nav.px = buffer.getSignMag32(i, 27) * p2(11); i += 27;
+		nav.ax = buffer.getSignMag32(i, 5) * p2(30); i += 5;
+		nav.vy = buffer.getSignMag32(i, 24) * p2(20); i += 24;
+		nav.py = buffer.getSignMag32(i, 27) * p2(11); i += 27;
+		nav.ay = buffer.getSignMag32(i, 5) * p2(30); i += 5;
+		nav.vz = buffer.getSignMag32(i, 24) * p2(20); i += 24;
+		nav.pz = buffer.getSignMag32(i, 27) * p2(11); i += 27;
+		nav.az = buffer.getSignMag32(i, 5) * p2(30); i += 5;
+		// P3
+		i += 1;
+		nav.GammaN = buffer.getSignMag32(i, 11) * p2(40); i += 11;
+		// P and ln
+		i += 3;
+		double taun = buffer.getSignMag32(i, 22) * p2(30); i += 22;
+		// delta tau n
+		i += 5;
+		nav.ageOfInfo = buffer.getUint32(i, 5); i += 5;
+
+		if (prn == 0)
+			return false;
+
+		// tb and tk are Moscow times of the day
+		double tod = tb * 900.0 - 3 * 3600;
+		if (tod < 0)
+			tod += SEC_PER_DAY;
+		CommonTime toe = decoder.utcTimeOfDay(tod);
+		tod = tkH * 3600.0 + tkM * 60.0 + tkS - 3 * 3600;
+		if (tod < 0)
+			tod += SEC_PER_DAY;
+		CommonTime tof = decoder.utcTimeOfDay(tod);
+
+		nav.satSys = "R";
+		nav.PRNID = prn;
+		nav.sat = RinexSatID(prn, SatID::systemGlonass);
+		nav.time = toe;
+		nav.time.setTimeSystem(TimeSystem::GLO);
+		nav.Toc = GPSWeekSecond(toe).sow;
+		nav.MFtime = static_cast<long>(GPSWeekSecond(tof).sow);
+		nav.MFTraw = nav.MFtime;
+		// RINEX keeps -TauN
+		nav.TauN = -taun;
+		nav.health = bn;
+		nav.freqNum = fcn;
+		return true;
+	}
+
+	bool Rtcm3_1042::decode(const BitReader &buffer, Rtcm3Decoder& decoder)
+	{
+		if (buffer.size() < 511)
+			return false;
+
+		int i = 12;
+		int prn = buffer.getUint32(i, 6); i += 6;
+		int week = buffer.getUint32(i, 13); i += 13;
+		int ura = buffer.getUint32(i, 4); i += 4;
+		nav.idot = buffer.getInt32(i, 14) * p2(43) * SC2RAD; i += 14;
+		nav.IODE = buffer.getUint32(i, 5); i += 5;
+		double toc = buffer.getUint32(i, 17) * 8.0; i += 17;
+		nav.af2 = buffer.getInt32(i, 11) * p2(66); i += 11;
+		nav.af1 = buffer.getInt32(i, 22) * p2(50); i += 22;
+		nav.af0 = buffer.getInt32(i, 24) * p2(33); i += 24;
+		nav.IODC = buffer.getUint32(i, 5); i += 5;
+		nav.Crs = buffer.getInt32(i, 18) * p2(6); i += 18;
+		nav.dn = buffer.getInt32(i, 16) * p2(43) * SC2RAD; i += 16;
+		nav.M0 = buffer.getInt32(i, 32) * p2(31) * SC2RAD; i += 32;
+		nav.Cuc = buffer.getInt32(i, 18) * p2(31); i += 18;
+		nav.ecc = buffer.getUint32(i, 32) * p2(33); i += 32;
+		nav.Cus = buffer.getInt32(i, 18) * p2(31); i += 18;
+		nav.Ahalf = buffer.getUint32(i, 32) * p2(19); i += 32;
+		nav.Toe = buffer.getUint32(i, 17) * 8.0; i += 17;
+		nav.Cic = buffer.getInt32(i, 18) * p2(31); i += 18;
+		nav.OMEGA0 = buffer.getInt32(i, 32) * p2(31) * SC2RAD; i += 32;
+		nav.Cis = buffer.getInt32(i, 18) * p2(31); i += 18;
+		nav.i0 = buffer.getInt32(i, 32) * p2(31) * SC2RAD; i += 32;
+		nav.Crc = buffer.getInt32(i, 18) * p2(6); i += 18;
+		nav.w = buffer.getInt32(i, 32) * p2(31) * SC2RAD; i += 32;
+		nav.OMEGAdot = buffer.getInt32(i, 24) * p2(43) * SC2RAD; i += 24;
+		nav.Tgd = buffer.getInt32(i, 10) * 1e-10; i += 10;
+		nav.Tgd2 = buffer.getInt32(i, 10) * 1e-10; i += 10;
+		nav.health = buffer.getUint32(i, 1); i += 1;
+
+		if (prn == 0)
+			return false;
+		// BDT week 0 is GPS week 1356
+		week = fullWeek(week, 8192, GPSWeekSecond(decoder.referenceTime()).week - 1356);
+
+		nav.satSys = "C";
+		nav.PRNID = prn;
+		nav.sat = RinexSatID(prn, SatID::systemBeiDou);
+		nav.accuracy = uraToMeters(ura);
+		nav.Toc = toc;
+		nav.time = BDSWeekSecond(week, toc, TimeSystem::BDT);
+
+		CommonTime toe = BDSWeekSecond(week, nav.Toe, TimeSystem::BDT);
+		// BDT = GPS - 14 s
+		setTransmitTime(nav, toe, sinceReference(toe, decoder, -14), true);
+		return true;
+	}
+
+	bool Rtcm3_1046::decode(const BitReader &buffer, Rtcm3Decoder& decoder)
+	{
+		if (buffer.size() < 504)
+			return false;
+
+		int i = 12;
+		int prn = buffer.getUint32(i, 6); i += 6;
+		int week = buffer.getUint32(i, 12); i += 12;
+		nav.IODnav = buffer.getUint32(i, 10); i += 10;
+		int sisa = buffer.getUint32(i, 8); i += 8;
+		nav.idot = buffer.getInt32(i, 14) * p2(43) * SC2RAD; i += 14;
+		double toc = buffer.getUint32(i, 14) * 60.0; i += 14;
+		nav.af2 = buffer.getInt32(i, 6) * p2(59); i += 6;
+		nav.af1 = buffer.getInt32(i, 21) * p2(46); i += 21;
+		nav.af0 = buffer.getInt32(i, 31) * p2(34); i += 31;
+		nav.Crs = buffer.getInt32(i, 16) * p2(5); i += 16;
+		nav.dn = buffer.getInt32(i, 16) * p2(43) * SC2RAD; i += 16;
+		nav.M0 = buffer.getInt32(i, 32) * p2(31) * SC2RAD; i += 32;
+		nav.Cuc = buffer.getInt32(i, 16) * p2(29); i += 16;
+		nav.ecc = buffer.getUint32(i, 32) * p2(33); i += 32;
+		nav.Cus = buffer.getInt32(i, 16) * p2(29); i += 16;
+		nav.Ahalf = buffer.getUint32(i, 32) * p2(19); i += 32;
+		nav.Toe = buffer.getUint32(i, 14) * 60.0; i += 14;
+		nav.Cic = buffer.getInt32(i, 16) * p2(29); i += 16;
+		nav.OMEGA0 = buffer.getInt32(i, 32) * p2(31) * SC2RAD; i += 32;
+		nav.Cis = buffer.getInt32(i, 16) * p2(29); i += 16;
+		nav.i0 = buffer.getInt32(i, 32) * p2(31) * SC2RAD; i += 32;
+		nav.Crc = buffer.getInt32(i, 16) * p2(5); i += 16;
+		nav.w = buffer.getInt32(i, 32) * p2(31) * SC2RAD; i += 32;
+		nav.OMEGAdot = buffer.getInt32(i, 24) * p2(43) * SC2RAD; i += 24;
+		nav.Tgd = buffer.getInt32(i, 10) * p2(32); i += 10;
+		nav.Tgd2 = buffer.getInt32(i, 10) * p2(32); i += 10;
+		int e5bHs = buffer.getUint32(i, 2); i += 2;
+		int e5bDvs = buffer.getUint32(i, 1); i += 1;
+		int e1Hs = buffer.getUint32(i, 2); i += 2;
+		int e1Dvs = buffer.getUint32(i, 1); i += 1;
+
+		if (prn == 0)
+			return false;
+		// GST week 0 is GPS week 1024; RINEX has the weeks of GPS
+		week = fullWeek(week + 1024, 4096, GPSWeekSecond(decoder.referenceTime()).week);
+
+		nav.satSys = "E";
+		nav.PRNID = prn;
+		nav.sat = RinexSatID(prn, SatID::systemGalileo);
+		nav.accuracy = sisaToMeters(sisa);
+		// RINEX health bits: E1-B DVS, E1-B HS, E5a DVS and HS, E5b DVS and HS
+		nav.health = e1Dvs | (e1Hs << 1) | (e5bDvs << 6) | (e5bHs << 7);
+		// I/NAV E1-B, E5b; clock of E5b,E1
+		nav.datasources = 517;
+		nav.Toc = toc;
+		nav.time = GPSWeekSecond(week, toc, TimeSystem::GPS);
+		nav.time.setTimeSystem(TimeSystem::GAL);
+
+		CommonTime toe = GPSWeekSecond(week, nav.Toe, TimeSystem::GPS);
+		toe.setTimeSystem(TimeSystem::GAL);
+		setTransmitTime(nav, toe, sinceReference(toe, decoder, 0), false);
+		return true;
+	}
+}
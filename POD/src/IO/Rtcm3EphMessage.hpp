@@ -0,0 +1,75 @@
+#pragma once
+#include"Rtcm3MessageBase.hpp"
+#include"Rinex3NavData.hpp"
+
+namespace pod
+{
+	// Broadcast ephemeris messages of RTCM 3.
+	// A message is decoded to the Rinex3NavData of a RINEX navigation
+	// record, which the decoder adds to its ephemeris store
+	// (Rinex3EphemerisStore, i.e. the GPS/Galileo/BeiDou orbit store and
+	// the GLONASS store) and passes to its ephemeris callback.
+	class Rtcm3_Ephemeris : public Rtcm3MessageBase
+	{
+	public:
+		Rtcm3_Ephemeris(int msg_id) :Rtcm3MessageBase(msg_id) {}
+
+		virtual bool parse(const BitReader &buffer, Rtcm3Decoder& decoder) override;
+
+		// the last ephemeris decoded
+		const gpstk::Rinex3NavData& data() const
+		{
+			return nav;
+		}
+
+	protected:
+		// decodes the message to 'nav'
+		virtual bool decode(const BitReader &buffer, Rtcm3Decoder& decoder) = 0;
+
+		gpstk::Rinex3NavData nav;
+	};
+
+	// GPS ephemeris
+	class Rtcm3_1019 : public Rtcm3_Ephemeris
+	{
+	public:
+		Rtcm3_1019() :Rtcm3_Ephemeris(1019) {}
+
+		virtual rtcm3_msg_uptr clone() const override { return std::make_unique<Rtcm3_1019>(); }
+	protected:
+		virtual bool decode(const BitReader &buffer, Rtcm3Decoder& decoder) override;
+	};
+
+	// GLONASS ephemeris
+	class Rtcm3_1020 : public Rtcm3_Ephemeris
+	{
+	public:
+		Rtcm3_1020() :Rtcm3_Ephemeris(1020) {}
+
+		virtual rtcm3_msg_uptr clone() const override { return std::make_unique<Rtcm3_1020>(); }
+	protected:
+		virtual bool decode(const BitReader &buffer, Rtcm3Decoder& decoder) override;
+	};
+
+	// BeiDou ephemeris
+	class Rtcm3_1042 : public Rtcm3_Ephemeris
+	{
+	public:
+		Rtcm3_1042() :Rtcm3_Ephemeris(1042) {}
+
+		virtual rtcm3_msg_uptr clone() const override { return std::make_unique<Rtcm3_1042>(); }
+	protected:
+		virtual bool decode(const BitReader &buffer, Rtcm3Decoder& decoder) override;
+	};
+
+	// Galileo I/NAV ephemeris
+	class Rtcm3_1046 : public Rtcm3_Ephemeris
+	{
+	public:
+		Rtcm3_1046() :Rtcm3_Ephemeris(1046) {}
+
+		virtual rtcm3_msg_uptr clone() const override { return std::make_unique<Rtcm3_1046>(); }
+	protected:
+		virtual bool decode(const BitReader &buffer, Rtcm3Decoder& decoder) override;
+	};
+}
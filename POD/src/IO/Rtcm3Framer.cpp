@@ -0,0 +1,67 @@
+#include"Rtcm3Framer.hpp"
+#include"RtcmUtils.hpp"
+
+#include<cstring>
+
+namespace pod
+{
+	const uchar Rtcm3Framer::PREAMBLE;
+	const int Rtcm3Framer::MAX_MSG_LEN;
+	const int Rtcm3Framer::MAX_FRAME_LEN;
+
+	bool Rtcm3Framer::next(const uchar*& msg, int& len)
+	{
+		ring.consume(pending);
+		numBytes += pending;
+		pending = 0;
+
+		while (ring.size() > 0)
+		{
+			// skip to the next preamble
+			size_t n;
+			const uchar* p = ring.readPtr(n);
+			const void* found = std::memchr(p, PREAMBLE, n);
+			if (found == nullptr)
+			{
+				skip(n);
+				continue;
+			}
+			skip(static_cast<const uchar*>(found) - p);
+
+			if (ring.size() < 3)
+				return false;
+
+			// 6 reserved bits, then the length of the message
+			if (ring[1] & 0xFC)
+			{
+				skip(1);
+				continue;
+			}
+			int msgLen = ((ring[1] & 0x03) << 8) | ring[2];
+			size_t frameLen = msgLen + 6;
+			if (ring.size() < frameLen)
+				return false;
+
+			const uchar* frame = ring.linear(0, frameLen, scratch);
+			if (!RtcmUtils::crc24q_check(frame, frameLen))
+			{
+				numCrcErrors++;
+				skip(1);
+				continue;
+			}
+
+			msg = frame + 3;
+			len = msgLen;
+			pending = frameLen;
+			numFrames++;
+			return true;
+		}
+		return false;
+	}
+
+	void Rtcm3Framer::reset()
+	{
+		ring.clear();
+		pending = 0;
+	}
+}
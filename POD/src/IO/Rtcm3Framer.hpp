@@ -0,0 +1,88 @@
+#pragma once
+#include"RingBuffer.hpp"
+#include"typenames.hpp"
+
+namespace pod
+{
+	// Finds the RTCM 3 frames in a byte stream.
+	// The bytes are pushed to a ring buffer; next() scans it for a preamble,
+	// waits for the whole frame and checks its CRC24Q. Bytes that do not
+	// start a valid frame are skipped one at a time, so a frame is found
+	// again after garbage or a lost byte.
+	class Rtcm3Framer
+	{
+	public:
+		static const uchar PREAMBLE = 0xD3;
+		static const int MAX_MSG_LEN = 1023;
+		// preamble and length (3 bytes), message, CRC (3 bytes)
+		static const int MAX_FRAME_LEN = MAX_MSG_LEN + 6;
+
+		explicit Rtcm3Framer(size_t capacity = 1 << 16)
+			:ring(capacity < 2 * MAX_FRAME_LEN ? 2 * MAX_FRAME_LEN : capacity), pending(0),
+			numBytes(0), numFrames(0), numCrcErrors(0), numSkipped(0) {}
+
+		~Rtcm3Framer() = default;
+
+		// The buffer, to read a source straight into it:
+		// buffer().writePtr(), then buffer().commit().
+		RingBuffer& buffer()
+		{
+			return ring;
+		}
+
+		// copies up to 'len' bytes to the buffer, returns the number copied
+		size_t push(const uchar* data, size_t len)
+		{
+			return ring.write(data, len);
+		}
+
+		// Finds the next frame. 'msg' and 'len' are the message, without
+		// the frame header and the CRC; they are valid until the next call.
+		// Returns false when the buffer holds no complete frame.
+		bool next(const uchar*& msg, int& len);
+
+		// drops the buffered bytes
+		void reset();
+
+		// counters
+		size_t bytesFramed() const
+		{
+			return numBytes;
+		}
+
+		size_t framesFound() const
+		{
+			return numFrames;
+		}
+
+		size_t crcErrors() const
+		{
+			return numCrcErrors;
+		}
+
+		size_t bytesSkipped() const
+		{
+			return numSkipped;
+		}
+
+	private:
+		void skip(size_t n)
+		{
+			ring.consume(n);
+			numSkipped += n;
+		}
+
+		RingBuffer ring;
+
+		// frame returned by the last call of next(), consumed by the next one
+		size_t pending;
+
+		// a frame that wraps around the end of the ring
+		uchar scratch[MAX_FRAME_LEN];
+
+		size_t numBytes;
+		size_t numFrames;
+		size_t numCrcErrors;
+		size_t numSkipped;
+	};
+}
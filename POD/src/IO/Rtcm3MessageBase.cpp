@@ -28,57 +28,61 @@ namespace pod
 	const std::map<int, rtcm3_msg_uptr> Rtcm3MessageBase::id2msg = init_msg_map();
 
 
-	bool Rtcm3_1008::parse(BitSetProxy &buffer, Rtcm3Decoder& decoder)
+	bool Rtcm3_1008::parse(const BitReader &buffer, Rtcm3Decoder& decoder)
 	{
-		int ref_id = buffer.getUint32(12, 12);
+		if (buffer.size() < 32)
+			return false;
+		refId = buffer.getUint32(12, 12);
 		int n = buffer.getUint32(24, 8);
-		auto ant_discr = buffer.getString(32,n*8);
-		std::cout << ref_id << " " << ant_discr << std::endl;
+		if (buffer.size() < 32 + 8 * n)
+			return false;
+		antenna = buffer.getString(32, n);
 		return true;
 	}
 
-	bool Rtcm3_GpsObs::parseHeader(BitSetProxy &buffer, Rtcm3Decoder& decoder)
+	bool Rtcm3_GpsObs::parseHeader(const BitReader &buffer, Rtcm3Decoder& decoder)
 	{
-		int ref_id = buffer.getUint32(12, 12);
-		int tow = buffer.getUint32(24, 30);
-		bool syncFlag = buffer.bits()[54];
+		if (buffer.size() < 64)
+			return false;
+		refId = buffer.getUint32(12, 12);
+		tow = buffer.getUint32(24, 30) * 0.001;
+		syncFlag = buffer.getBit(54);
 		nSats = buffer.getUint32(55, 5);
-		std::cout <<"SyncFlag: "<<syncFlag<< " tow: " << tow << " ngps: " << nSats << std::endl;
 		return true;
 	}
 
-	bool Rtcm3_1004::parse(BitSetProxy &buffer, Rtcm3Decoder& decoder)
+	bool Rtcm3_1004::parse(const BitReader &buffer, Rtcm3Decoder& decoder)
 	{
-		if (parseHeader(buffer, decoder))
-			for (size_t i = 0; i < nSats; i++)
-			{
-				if (!parseSatData(BitSetProxy(buffer.bits(), 64 + 125 * i, 125), decoder))
-					return false;
-			}
-
-		else
+		if (!parseHeader(buffer, decoder))
+			return false;
+		if (buffer.size() < 64 + 125 * int(nSats))
 			return false;
 
+		for (size_t i = 0; i < nSats; i++)
+		{
+			if (!parseSatData(buffer, 64 + 125 * i, decoder))
+				return false;
+		}
 		return true;
 	}
 
-	bool Rtcm3_1004::parseSatData(BitSetProxy &buffer, Rtcm3Decoder& decoder)
+	bool Rtcm3_1004::parseSatData(const BitReader &buffer, int i0, Rtcm3Decoder& decoder)
 	{
-		int id = buffer.getUint32(0, 6);
+		int id = buffer.getUint32(i0, 6);
 		SatID satId(id, SatID::SatelliteSystem::systemGPS);
-		TypeID typeIdL1 = buffer.bits()[6] ? TypeID::P1 : TypeID::C1;
+		TypeID typeIdL1 = buffer.getBit(i0 + 6) ? TypeID::P1 : TypeID::C1;
 
-		int prL1 = buffer.getUint32(7, 24);
-		int dL1phase = buffer.getInt32(31, 20);
-		int L1CodeAmb = buffer.getUint32(58, 8);
-		int cnrL1 = buffer.getUint32(66, 8);
+		int prL1 = buffer.getUint32(i0 + 7, 24);
+		int dL1phase = buffer.getInt32(i0 + 31, 20);
+		int L1CodeAmb = buffer.getUint32(i0 + 58, 8);
+		int cnrL1 = buffer.getUint32(i0 + 66, 8);
 		 
-		int typeL2code = buffer.getUint32(74, 2);
+		int typeL2code = buffer.getUint32(i0 + 74, 2);
 		TypeID typeIdL2 = typeL2code > 0 ? TypeID::P2 : TypeID::C2;
 
-		int dL2code = buffer.getInt32(76, 14);
-		int dL2phase = buffer.getInt32(90, 20);
-		int cnrL2 = buffer.getUint32(117, 8);
+		int dL2code = buffer.getInt32(i0 + 76, 14);
+		int dL2phase = buffer.getInt32(i0 + 90, 20);
+		int cnrL2 = buffer.getUint32(i0 + 117, 8);
 
 		double codeL1 = prL1 * CODE_RES + L1CodeAmb * LIGTH_MS;
 		double phaseL1 = codeL1 + dL1phase* PHASE_RES;
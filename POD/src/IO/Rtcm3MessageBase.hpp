@@ -1,6 +1,6 @@
 #pragma once
 #include"Rtcm3Decoder.hpp"
-#include"BitSetProxy.hpp"
+#include"BitReader.hpp"
 
 #include<memory>
 
@@ -34,7 +34,7 @@ namespace pod
 
 		virtual rtcm3_msg_uptr clone() const = 0;
 
-		virtual bool parse(BitSetProxy &buffer, Rtcm3Decoder& decoder) = 0;
+		virtual bool parse(const BitReader &buffer, Rtcm3Decoder& decoder) = 0;
 
 #pragma region Comparation support
 		bool operator==(const Rtcm3MessageBase& right) const
@@ -86,19 +86,26 @@ namespace pod
 		Rtcm3_1008() :Rtcm3MessageBase(1008) {}
 		//Rtcm3_1008(const Rtcm3MessageBase& othr) :Rtcm3MessageBase(1008) {}
 
-		virtual bool parse(BitSetProxy &buffer, Rtcm3Decoder& decoder) override;
+		virtual bool parse(const BitReader &buffer, Rtcm3Decoder& decoder) override;
 		virtual rtcm3_msg_uptr clone() const override { return std::make_unique<Rtcm3_1008>(); }
+
+		// fields of the last message
+		int refId = 0;
+		std::string antenna;
 	};
 
 	class Rtcm3_GpsObs : public Rtcm3MessageBase
 	{
 	public:
 		 Rtcm3_GpsObs(int msg_id) :Rtcm3MessageBase(msg_id) {};
-		 bool parseHeader(BitSetProxy &buffer, Rtcm3Decoder& decoder);
-		 virtual bool parseSatData(BitSetProxy &buffer, Rtcm3Decoder& decoder) = 0;
+		 bool parseHeader(const BitReader &buffer, Rtcm3Decoder& decoder);
+		 // parses the data of the satellite at bit 'i0'
+		 virtual bool parseSatData(const BitReader &buffer, int i0, Rtcm3Decoder& decoder) = 0;
 	protected:
-		double tow;
-		uint nSats;
+		int refId = 0;
+		double tow = 0;
+		bool syncFlag = false;
+		uint nSats = 0;
 	};
 
 	class Rtcm3_1004 :public Rtcm3_GpsObs
@@ -106,8 +113,8 @@ namespace pod
 	public:
 		Rtcm3_1004() :Rtcm3_GpsObs(1004) {}
 
-		virtual bool parse(BitSetProxy &buffer, Rtcm3Decoder& decoder) override;
-		virtual bool parseSatData(BitSetProxy &buffer, Rtcm3Decoder& decoder)  override;
+		virtual bool parse(const BitReader &buffer, Rtcm3Decoder& decoder) override;
+		virtual bool parseSatData(const BitReader &buffer, int i0, Rtcm3Decoder& decoder)  override;
 		virtual rtcm3_msg_uptr clone() const override { return std::make_unique<Rtcm3_1004>(); }
 	protected:
 		
@@ -0,0 +1,368 @@
+#include"Rtcm3MsmMessage.hpp"
+#include"GNSSconstants.hpp"
+#include"RinexSatID.hpp"
+#include"RinexObsID.hpp"
+
+#include<algorithm>
+#include<array>
+#include<cmath>
+#include<cstring>
+#include<limits>
+
+using namespace gpstk;
+
+namespace pod
+{
+	// range of one light-millisecond (m)
+	const double RANGE_MS = C_MPS * 0.001;
+
+	namespace
+	{
+		const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+		// RINEX attributes of the MSM signal IDs 1..32, per system
+		const char* const GPS_SIGS[] = { "","","1C","1P","1W","","","","2C","2P","2W","","","","","2S","2L","2X",
+			"","","","","5I","5Q","5X","","","","","","1S","1L","1X" };
+		const char* const GLO_SIGS[] = { "","","1C","1P","","","","","2C","2P" };
+		const char* const GAL_SIGS[] = { "","","1C","1A","1B","1X","1Z","","6C","6A","6B","6X","6Z","","7I","7Q","7X",
+			"","8I","8Q","8X","","5I","5Q","5X" };
+		const char* const SBAS_SIGS[] = { "","","1C","","","","","","","","","","","","","","",
+			"","","","","","5I","5Q","5X" };
+		const char* const QZS_SIGS[] = { "","","1C","","","","","","","6S","6L","6X","","","","2S","2L","2X",
+			"","","","","5I","5Q","5X","","","","","","1S","1L","1X" };
+		const char* const BDS_SIGS[] = { "","","2I","2Q","2X","","","","6I","6Q","6X","","","","7I","7Q","7X" };
+
+		// LLI and SSI types of a RINEX band
+		bool flagTypes(int band, TypeID& lli, TypeID& ssi)
+		{
+			switch (band)
+			{
+			case 1: lli = TypeID::LLI1; ssi = TypeID::SSI1; return true;
+			case 2: lli = TypeID::LLI2; ssi = TypeID::SSI2; return true;
+			case 5: lli = TypeID::LLI5; ssi = TypeID::SSI5; return true;
+			case 6: lli = TypeID::LLI6; ssi = TypeID::SSI6; return true;
+			case 7: lli = TypeID::LLI7; ssi = TypeID::SSI7; return true;
+			case 8: lli = TypeID::LLI8; ssi = TypeID::SSI8; return true;
+			default: return false;
+			}
+		}
+
+		typedef std::array<Rtcm3_Msm::Signal, Rtcm3_Msm::MAX_SIGS + 1> SignalTable;
+
+		SignalTable makeTable(SatID::SatelliteSystem sys, const char* const* codes, int n)
+		{
+			SignalTable table;
+			RinexSatID sat(1, sys);
+			std::string sysChar(1, sat.systemChar());
+			for (int i = 1; i < n; i++)
+			{
+				std::string code(codes[i]);
+				if (code.empty())
+					continue;
+
+				Rtcm3_Msm::Signal& s = table[i];
+				try
+				{
+					s.code = ConvertToTypeID(RinexObsID(sysChar + "C" + code), sat);
+					s.phase = ConvertToTypeID(RinexObsID(sysChar + "L" + code), sat);
+					s.doppler = ConvertToTypeID(RinexObsID(sysChar + "D" + code), sat);
+					s.snr = ConvertToTypeID(RinexObsID(sysChar + "S" + code), sat);
+				}
+				catch (Exception&)
+				{
+					continue;
+				}
+				s.band = code[0] - '0';
+				s.valid = s.code != TypeID::Unknown && s.phase != TypeID::Unknown
+					&& flagTypes(s.band, s.lli, s.ssi);
+			}
+			return table;
+		}
+
+		// MSM satellite number to the SatID number of RINEX
+		int satNumber(SatID::SatelliteSystem sys, int i)
+		{
+			// SBAS 1 is PRN 120
+			return (sys == SatID::systemGeosync) ? i + 19 : i;
+		}
+
+		// RINEX SSI of a carrier to noise ratio (dB-Hz)
+		int snrIndicator(double cnr)
+		{
+			int ssi = static_cast<int>(cnr / 6);
+			return std::min(std::max(ssi, 1), 9);
+		}
+	}
+
+	const Rtcm3_Msm::Signal& Rtcm3_Msm::signal(SatID::SatelliteSystem sys, int sig)
+	{
+		// built once, on the first call
+		static const SignalTable gps = makeTable(SatID::systemGPS, GPS_SIGS, sizeof(GPS_SIGS) / sizeof(GPS_SIGS[0]));
+		static const SignalTable glo = makeTable(SatID::systemGlonass, GLO_SIGS, sizeof(GLO_SIGS) / sizeof(GLO_SIGS[0]));
+		static const SignalTable gal = makeTable(SatID::systemGalileo, GAL_SIGS, sizeof(GAL_SIGS) / sizeof(GAL_SIGS[0]));
+		static const SignalTable sbas = makeTable(SatID::systemGeosync, SBAS_SIGS, sizeof(SBAS_SIGS) / sizeof(SBAS_SIGS[0]));
+		static const SignalTable qzs = makeTable(SatID::systemQZSS, QZS_SIGS, sizeof(QZS_SIGS) / sizeof(QZS_SIGS[0]));
+		static const SignalTable bds = makeTable(SatID::systemBeiDou, BDS_SIGS, sizeof(BDS_SIGS) / sizeof(BDS_SIGS[0]));
+		static const Signal none;
+
+		if (sig < 1 || sig > MAX_SIGS)
+			return none;
+
+		switch (sys)
+		{
+		case SatID::systemGPS: return gps[sig];
+		case SatID::systemGlonass: return glo[sig];
+		case SatID::systemGalileo: return gal[sig];
+		case SatID::systemGeosync: return sbas[sig];
+		case SatID::systemQZSS: return qzs[sig];
+		case SatID::systemBeiDou: return bds[sig];
+		default: return none;
+		}
+	}
+
+	Rtcm3_Msm::Rtcm3_Msm(int msg_id)
+		:Rtcm3MessageBase(msg_id), msmType(msg_id % 10)
+	{
+		switch (msg_id / 10)
+		{
+		case 107: system = SatID::systemGPS; break;
+		case 108: system = SatID::systemGlonass; break;
+		case 109: system = SatID::systemGalileo; break;
+		case 110: system = SatID::systemGeosync; break;
+		case 111: system = SatID::systemQZSS; break;
+		case 112: system = SatID::systemBeiDou; break;
+		default: system = SatID::systemUnknown; break;
+		}
+		std::memset(prevLock, 0, sizeof(prevLock));
+	}
+
+	bool Rtcm3_Msm::parse(const BitReader &buffer, Rtcm3Decoder& decoder)
+	{
+		int i = parseHeader(buffer, decoder);
+		if (i == 0)
+			return false;
+
+		if (msmType == 4)
+		{
+			if (buffer.size() < i + 18 * nSats + 48 * nCells)
+				return false;
+			parseMsm4(buffer, i);
+		}
+		else if (msmType == 7)
+		{
+			if (buffer.size() < i + 36 * nSats + 80 * nCells)
+				return false;
+			parseMsm7(buffer, i);
+		}
+		else
+			return false;
+
+		addObservations(decoder);
+
+		// the last message of the epoch
+		if (!multipleMsg)
+			decoder.flushEpoch();
+
+		return true;
+	}
+
+	int Rtcm3_Msm::parseHeader(const BitReader &buffer, Rtcm3Decoder& decoder)
+	{
+		if (system == SatID::systemUnknown || buffer.size() < 169)
+			return 0;
+
+		int i = 12;
+		refId = buffer.getUint32(i, 12); i += 12;
+		if (system == SatID::systemGlonass)
+		{
+			// day of week and time of day (ms) in Moscow time; the
+			// day is taken from the reference time of the decoder
+			i += 3;
+			double tod = buffer.getUint32(i, 27) * 0.001 - 3 * 3600; i += 27;
+			if (tod < 0)
+				tod += SEC_PER_DAY;
+			epoch = decoder.utcTimeOfDay(tod) + decoder.leapSeconds();
+			epoch.setTimeSystem(TimeSystem::GPS);
+		}
+		else
+		{
+			double tow = buffer.getUint32(i, 30) * 0.001; i += 30;
+			// BDT = GPS - 14 s
+			if (system == SatID::systemBeiDou)
+				tow += 14;
+			epoch = decoder.timeOfWeek(tow);
+		}
+		multipleMsg = buffer.getBit(i); i += 1;
+		iods = buffer.getUint32(i, 3); i += 3;
+		i += 7;
+		clockSteering = buffer.getUint32(i, 2); i += 2;
+		clockExt = buffer.getUint32(i, 2); i += 2;
+		// smoothing indicator and interval
+		i += 1 + 3;
+
+		nSats = 0;
+		for (int j = 1; j <= 64; j++, i++)
+			if (buffer.getBit(i))
+				sats[nSats++] = j;
+
+		nSigs = 0;
+		for (int j = 1; j <= 32; j++, i++)
+			if (buffer.getBit(i))
+				sigs[nSigs++] = j;
+
+		if (nSats * nSigs > MAX_CELLS || buffer.size() < i + nSats * nSigs)
+			return 0;
+
+		nCells = 0;
+		for (int s = 0; s < nSats; s++)
+			for (int g = 0; g < nSigs; g++, i++)
+				cellIndex[s][g] = buffer.getBit(i) ? nCells++ : -1;
+
+		return i;
+	}
+
+	void Rtcm3_Msm::parseMsm4(const BitReader &buffer, int i)
+	{
+		for (int s = 0; s < nSats; s++, i += 8)
+		{
+			uint ms = buffer.getUint32(i, 8);
+			roughRange[s] = (ms == 255) ? NaN : ms * RANGE_MS;
+			extInfo[s] = -1;
+			roughRate[s] = NaN;
+		}
+		for (int s = 0; s < nSats; s++, i += 10)
+			roughRange[s] += buffer.getUint32(i, 10) * std::ldexp(RANGE_MS, -10);
+
+		for (int c = 0; c < nCells; c++, i += 15)
+		{
+			int pr = buffer.getInt32(i, 15);
+			pseudorange[c] = (pr == -16384) ? NaN : pr * std::ldexp(RANGE_MS, -24);
+		}
+		for (int c = 0; c < nCells; c++, i += 22)
+		{
+			int cp = buffer.getInt32(i, 22);
+			phaseRange[c] = (cp == -2097152) ? NaN : cp * std::ldexp(RANGE_MS, -29);
+		}
+		for (int c = 0; c < nCells; c++, i += 4)
+			lockTime[c] = buffer.getUint32(i, 4);
+		for (int c = 0; c < nCells; c++, i += 1)
+			halfCycle[c] = buffer.getBit(i);
+		for (int c = 0; c < nCells; c++, i += 6)
+		{
+			cnr[c] = buffer.getUint32(i, 6);
+			phaseRate[c] = NaN;
+		}
+	}
+
+	void Rtcm3_Msm::parseMsm7(const BitReader &buffer, int i)
+	{
+		for (int s = 0; s < nSats; s++, i += 8)
+		{
+			uint ms = buffer.getUint32(i, 8);
+			roughRange[s] = (ms == 255) ? NaN : ms * RANGE_MS;
+		}
+		for (int s = 0; s < nSats; s++, i += 4)
+			extInfo[s] = buffer.getUint32(i, 4);
+		for (int s = 0; s < nSats; s++, i += 10)
+			roughRange[s] += buffer.getUint32(i, 10) * std::ldexp(RANGE_MS, -10);
+		for (int s = 0; s < nSats; s++, i += 14)
+		{
+			int rate = buffer.getInt32(i, 14);
+			roughRate[s] = (rate == -8192) ? NaN : rate;
+		}
+
+		for (int c = 0; c < nCells; c++, i += 20)
+		{
+			int pr = buffer.getInt32(i, 20);
+			pseudorange[c] = (pr == -524288) ? NaN : pr * std::ldexp(RANGE_MS, -29);
+		}
+		for (int c = 0; c < nCells; c++, i += 24)
+		{
+			int cp = buffer.getInt32(i, 24);
+			phaseRange[c] = (cp == -8388608) ? NaN : cp * std::ldexp(RANGE_MS, -31);
+		}
+		for (int c = 0; c < nCells; c++, i += 10)
+			lockTime[c] = buffer.getUint32(i, 10);
+		for (int c = 0; c < nCells; c++, i += 1)
+			halfCycle[c] = buffer.getBit(i);
+		for (int c = 0; c < nCells; c++, i += 10)
+			cnr[c] = buffer.getUint32(i, 10) * 0.0625;
+		for (int c = 0; c < nCells; c++, i += 15)
+		{
+			int rate = buffer.getInt32(i, 15);
+			phaseRate[c] = (rate == -16384) ? NaN : rate * 0.0001;
+		}
+	}
+
+	void Rtcm3_Msm::addObservations(Rtcm3Decoder& decoder)
+	{
+		IRinex& ep = decoder.epochAt(epoch);
+
+		for (int s = 0; s < nSats; s++)
+		{
+			if (std::isnan(roughRange[s]))
+				continue;
+
+			SatID sat(satNumber(system, sats[s]), system);
+
+			// GLONASS frequency channel, for the Doppler: from the
+			// extended info of MSM7, or the table of SatID
+			int fcn = 0;
+			if (system == SatID::systemGlonass)
+			{
+				if (extInfo[s] >= 0 && extInfo[s] < 14)
+					fcn = extInfo[s] - 7;
+				else
+				{
+					try
+					{
+						fcn = sat.getGloFcn();
+					}
+					catch (Exception&)
+					{
+						fcn = 0;
+					}
+				}
+			}
+
+			typeValueMap tvm;
+			for (int g = 0; g < nSigs; g++)
+			{
+				int c = cellIndex[s][g];
+				if (c < 0)
+					continue;
+
+				// the lock time indicator decreases or stays at 0 after a loss of lock
+				std::uint16_t& prev = prevLock[sats[s] - 1][sigs[g] - 1];
+				bool slip = (lockTime[c] == 0 && prev == 0) || lockTime[c] < prev;
+				prev = lockTime[c];
+
+				const Signal& sig = signal(system, sigs[g]);
+				if (!sig.valid)
+					continue;
+
+				// the first signal of the mask is kept for the types shared by
+				// several signals of a band
+				if (!std::isnan(pseudorange[c]))
+					tvm.insert(std::make_pair(sig.code, roughRange[s] + pseudorange[c]));
+				if (!std::isnan(phaseRange[c]) && !tvm.count(sig.phase))
+				{
+					tvm[sig.phase] = roughRange[s] + phaseRange[c];
+					tvm[sig.lli] = (slip ? 1 : 0) | (halfCycle[c] ? 2 : 0);
+					tvm[sig.ssi] = snrIndicator(cnr[c]);
+				}
+				if (sig.doppler != TypeID::Unknown && !std::isnan(phaseRate[c]) && !std::isnan(roughRate[s]))
+				{
+					double wl = getWavelength(sat, sig.band, fcn);
+					if (wl > 0)
+						tvm.insert(std::make_pair(sig.doppler, -(roughRate[s] + phaseRate[c]) / wl));
+				}
+				if (sig.snr != TypeID::Unknown && cnr[c] > 0)
+					tvm.insert(std::make_pair(sig.snr, cnr[c]));
+			}
+
+			if (!tvm.empty())
+				ep.addSv(sat, tvm);
+		}
+	}
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include"Rtcm3MessageBase.hpp"
+#include"TypeID.hpp"
+
+#include<cstdint>
+
+namespace pod
+{
+	// Multiple Signal Message (MSM) of RTCM 3.2, types 4 and 7, of any
+	// satellite system (messages 1074 - 1127).
+	// The fields of a message are decoded to fixed arrays of the parser,
+	// then the observations of each satellite are added to the current
+	// epoch of the decoder as the gnssRinex data of a RINEX file:
+	// code and phase in meters, Doppler in Hz, the signal strength in
+	// dB-Hz, and the LLI and SSI flags of each band.
+	class Rtcm3_Msm : public Rtcm3MessageBase
+	{
+	public:
+		static const int MAX_SATS = 64;
+		static const int MAX_SIGS = 32;
+		static const int MAX_CELLS = 64;
+
+		// observation types of one signal of the signal mask
+		struct Signal
+		{
+			bool valid = false;
+			// RINEX band, for the wavelength and the LLI/SSI types
+			int band = 0;
+			gpstk::TypeID code, phase, doppler, snr, lli, ssi;
+		};
+
+		Rtcm3_Msm(int msg_id);
+
+		virtual bool parse(const BitReader &buffer, Rtcm3Decoder& decoder) override;
+
+		gpstk::SatID::SatelliteSystem getSystem() const
+		{
+			return system;
+		}
+
+		// epoch of the last message, GPS time
+		const gpstk::CommonTime& getEpoch() const
+		{
+			return epoch;
+		}
+
+		// the observation types of signal 'sig' (1..32) of a system
+		static const Signal& signal(gpstk::SatID::SatelliteSystem sys, int sig);
+
+	protected:
+		// decodes the header, returns its length in bits or 0
+		int parseHeader(const BitReader &buffer, Rtcm3Decoder& decoder);
+
+		// decodes the satellite and signal data from bit 'i'
+		void parseMsm4(const BitReader &buffer, int i);
+		void parseMsm7(const BitReader &buffer, int i);
+
+		// adds the observations to the current epoch of the decoder
+		void addObservations(Rtcm3Decoder& decoder);
+
+		gpstk::SatID::SatelliteSystem system;
+		// 4 or 7
+		int msmType;
+
+		// header
+		int refId = 0;
+		gpstk::CommonTime epoch;
+		bool multipleMsg = false;
+		int iods = 0;
+		int clockSteering = 0;
+		int clockExt = 0;
+
+		int nSats = 0, nSigs = 0, nCells = 0;
+		// satellite numbers and signal IDs of the masks, from 1
+		int sats[MAX_SATS];
+		int sigs[MAX_SIGS];
+		// signal 'j' of satellite 'i' is in cell cellIndex[i][j], or -1
+		int cellIndex[MAX_SATS][MAX_SIGS];
+
+		// satellite data: rough range (m), extended info, rough rate (m/s)
+		double roughRange[MAX_SATS];
+		int extInfo[MAX_SATS];
+		double roughRate[MAX_SATS];
+
+		// signal data; NaN for the missing values
+		double pseudorange[MAX_CELLS];
+		double phaseRange[MAX_CELLS];
+		double phaseRate[MAX_CELLS];
+		double cnr[MAX_CELLS];
+		int lockTime[MAX_CELLS];
+		bool halfCycle[MAX_CELLS];
+
+		// lock time indicator of the previous message, per satellite and signal
+		std::uint16_t prevLock[MAX_SATS][MAX_SIGS];
+	};
+
+	// MSM parser of message 'ID'
+	template<int ID>
+	class Rtcm3_MsmN : public Rtcm3_Msm
+	{
+	public:
+		Rtcm3_MsmN() :Rtcm3_Msm(ID) {}
+
+		virtual rtcm3_msg_uptr clone() const override { return std::make_unique<Rtcm3_MsmN<ID>>(); }
+	};
+
+	// GPS
+	typedef Rtcm3_MsmN<1074> Rtcm3_1074;
+	typedef Rtcm3_MsmN<1077> Rtcm3_1077;
+	// GLONASS
+	typedef Rtcm3_MsmN<1084> Rtcm3_1084;
+	typedef Rtcm3_MsmN<1087> Rtcm3_1087;
+	// Galileo
+	typedef Rtcm3_MsmN<1094> Rtcm3_1094;
+	typedef Rtcm3_MsmN<1097> Rtcm3_1097;
+	// SBAS
+	typedef Rtcm3_MsmN<1104> Rtcm3_1104;
+	typedef Rtcm3_MsmN<1107> Rtcm3_1107;
+	// QZSS
+	typedef Rtcm3_MsmN<1114> Rtcm3_1114;
+	typedef Rtcm3_MsmN<1117> Rtcm3_1117;
+	// BeiDou
+	typedef Rtcm3_MsmN<1124> Rtcm3_1124;
+	typedef Rtcm3_MsmN<1127> Rtcm3_1127;
+}
@@ -114,7 +114,7 @@ namespace pod
 		0xFCD11CCE, 0xFD575035, 0xFE5BC9C3, 0xFFDD8538,
 	};
 
-	unsigned RtcmUtils::crc24q_hash(unsigned char *data, int len)
+	unsigned RtcmUtils::crc24q_hash(const unsigned char *data, int len)
 	{
 		int i;
 		unsigned crc = 0;
@@ -139,7 +139,7 @@ namespace pod
 		data[len + 2] = LO(crc);
 	}
 
-	bool RtcmUtils::crc24q_check(unsigned char *data, int len)
+	bool RtcmUtils::crc24q_check(const unsigned char *data, int len)
 	{
 		unsigned crc = crc24q_hash(data, len - 3);
 
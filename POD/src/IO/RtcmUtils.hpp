@@ -6,11 +6,11 @@ namespace pod
 	{
 	public:
 
-		static unsigned crc24q_hash(unsigned char *data, int len);
+		static unsigned crc24q_hash(const unsigned char *data, int len);
 
 		static void crc24q_sign(unsigned char *data, int len);
 
-		static bool crc24q_check(unsigned char *data, int len);
+		static bool crc24q_check(const unsigned char *data, int len);
 
 	};
 }
\ No newline at end of file
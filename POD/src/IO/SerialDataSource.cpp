@@ -25,6 +25,11 @@ namespace pod
 		asio::read(serial, asio::buffer(buff + offset, len));
 	}
 
+	int SerialDataSource::read(unsigned char* buff, int len)
+	{
+		return static_cast<int>(serial.read_some(asio::buffer(buff, len)));
+	}
+
 	std::string SerialDataSource::readLine()
 	{
 		//Reading data char by char, code is optimized for simplicity, not speed
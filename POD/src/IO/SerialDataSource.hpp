@@ -43,6 +43,10 @@ namespace pod
 
 		virtual void readBytes(unsigned char *buff, int offset, int len) override;
 
+		// Blocks until some bytes are received, returns all the bytes
+		// available, up to 'len'.
+		virtual int read(unsigned char *buff, int len) override;
+
 	private:
 		boost::asio::io_service io;
 		boost::asio::serial_port serial;
@@ -0,0 +1,62 @@
+#include"StreamDataSource.hpp"
+
+#include<algorithm>
+
+namespace pod
+{
+	StreamDataSource::StreamDataSource(const std::string& path)
+		:file(path, std::ios::binary), strm(file)
+	{
+		if (!file)
+			throw std::ios_base::failure("Cannot open " + path);
+	}
+
+	std::string StreamDataSource::readLine()
+	{
+		std::string line;
+		std::getline(strm, line);
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		return line;
+	}
+
+	unsigned char StreamDataSource::readByte()
+	{
+		unsigned char c = 0;
+		readBytes(&c, 0, 1);
+		return c;
+	}
+
+	unsigned short StreamDataSource::readWord()
+	{
+		unsigned short w = 0;
+		readBytes(reinterpret_cast<unsigned char*>(&w), 0, 2);
+		return w;
+	}
+
+	void StreamDataSource::readBytes(unsigned char* buff, int offset, int len)
+	{
+		strm.read(reinterpret_cast<char*>(buff + offset), len);
+	}
+
+	int StreamDataSource::read(unsigned char* buff, int len)
+	{
+		if (len <= 0)
+			return 0;
+
+		// one byte, waiting for it if needed, then the buffered ones
+		std::streambuf* sb = strm.rdbuf();
+		std::streambuf::int_type c = sb->sbumpc();
+		if (std::streambuf::traits_type::eq_int_type(c, std::streambuf::traits_type::eof()))
+		{
+			strm.setstate(std::ios::eofbit);
+			return -1;
+		}
+		buff[0] = std::streambuf::traits_type::to_char_type(c);
+
+		std::streamsize n = std::min<std::streamsize>(sb->in_avail(), len - 1);
+		if (n > 0)
+			n = sb->sgetn(reinterpret_cast<char*>(buff + 1), n);
+		return 1 + static_cast<int>(std::max<std::streamsize>(n, 0));
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include"IdataSource.hpp"
+
+#include<fstream>
+#include<istream>
+
+namespace pod
+{
+	// Data from a file or from an input stream, e.g. std::cin fed by a pipe.
+	// read() returns the bytes already buffered by the stream, and blocks
+	// only when there is none.
+	class StreamDataSource :public IdataSource
+	{
+	public:
+		// opens the file 'path';
+		// throws std::ios_base::failure if it cannot be opened
+		explicit StreamDataSource(const std::string& path);
+
+		// reads 'is', which must outlive the source
+		explicit StreamDataSource(std::istream& is)
+			:strm(is) {}
+
+		virtual ~StreamDataSource() = default;
+
+		virtual std::string readLine() override;
+
+		virtual unsigned char readByte() override;
+
+		virtual unsigned short readWord() override;
+
+		virtual void readBytes(unsigned char *buff, int offset, int len) override;
+
+		virtual int read(unsigned char *buff, int len) override;
+
+	private:
+		std::ifstream file;
+		std::istream& strm;
+	};
+}
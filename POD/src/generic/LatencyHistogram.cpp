@@ -0,0 +1,110 @@
+#include"LatencyHistogram.h"
+
+#include<algorithm>
+#include<cmath>
+#include<limits>
+
+namespace pod
+{
+	LatencyHistogram::LatencyHistogram()
+	{
+		clear();
+	}
+
+	void LatencyHistogram::clear()
+	{
+		std::fill(bins, bins + NUM_BINS, 0);
+		n = 0;
+		sum = 0;
+		minVal = std::numeric_limits<double>::infinity();
+		maxVal = -std::numeric_limits<double>::infinity();
+	}
+
+	int LatencyHistogram::bin(double us)
+	{
+		// NaN goes to the first bin too
+		if (!(us >= 1.0))
+			return 0;
+
+		int i = 1 + (int)std::floor(std::log2(us) * BINS_PER_OCTAVE);
+		return std::min(i, NUM_BINS - 1);
+	}
+
+	double LatencyHistogram::binLower(int i)
+	{
+		if (i <= 0)
+			return 0;
+		return std::exp2((double)(i - 1) / BINS_PER_OCTAVE);
+	}
+
+	double LatencyHistogram::binUpper(int i)
+	{
+		if (i >= NUM_BINS - 1)
+			return std::numeric_limits<double>::infinity();
+		return std::exp2((double)i / BINS_PER_OCTAVE);
+	}
+
+	void LatencyHistogram::add(double us)
+	{
+		++bins[bin(us)];
+		++n;
+		sum += us;
+		minVal = std::min(minVal, us);
+		maxVal = std::max(maxVal, us);
+	}
+
+	double LatencyHistogram::min() const
+	{
+		return n ? minVal : std::numeric_limits<double>::quiet_NaN();
+	}
+
+	double LatencyHistogram::max() const
+	{
+		return n ? maxVal : std::numeric_limits<double>::quiet_NaN();
+	}
+
+	double LatencyHistogram::mean() const
+	{
+		return n ? sum / n : std::numeric_limits<double>::quiet_NaN();
+	}
+
+	double LatencyHistogram::percentile(double p) const
+	{
+		if (n == 0)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		p = std::min(std::max(p, 0.0), 1.0);
+		std::uint64_t rank = std::max<std::uint64_t>(1, (std::uint64_t)std::ceil(p * n));
+
+		std::uint64_t c = 0;
+		int i = 0;
+		for (; i < NUM_BINS - 1; ++i)
+		{
+			c += bins[i];
+			if (c >= rank)
+				break;
+		}
+		// the bin limit can't be out of the range of the latencies
+		return std::min(std::max(binUpper(i), minVal), maxVal);
+	}
+
+	void LatencyHistogram::printHeader(std::ostream& os)
+	{
+		os << "stage,count,min_us,mean_us,p50_us,p90_us,p99_us,max_us" << std::endl;
+	}
+
+	void LatencyHistogram::print(std::ostream& os, const std::string& name) const
+	{
+		os << name << ',' << n << ','
+			<< min() << ',' << mean() << ','
+			<< percentile(0.5) << ',' << percentile(0.9) << ',' << percentile(0.99) << ','
+			<< max() << std::endl;
+	}
+
+	void LatencyHistogram::printBins(std::ostream& os, const std::string& name) const
+	{
+		for (int i = 0; i < NUM_BINS; ++i)
+			if (bins[i])
+				os << name << ',' << binLower(i) << ',' << binUpper(i) << ',' << bins[i] << std::endl;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include<cstdint>
+#include<ostream>
+#include<string>
+
+namespace pod
+{
+	// Histogram of latencies, in microseconds.
+	// The bins are logarithmic, BINS_PER_OCTAVE per doubling of the
+	// latency (a resolution of ~19%), from 1 us to 2^32 us (~71 min);
+	// the first bin holds the latencies below 1 us, the last one those
+	// above 2^32 us. Adding a value doesn't allocate.
+	class LatencyHistogram
+	{
+	public:
+		static const int BINS_PER_OCTAVE = 4;
+		static const int NUM_BINS = 32 * BINS_PER_OCTAVE + 2;
+
+		LatencyHistogram();
+
+		// adds a latency, us
+		void add(double us);
+
+		void clear();
+
+		std::uint64_t count() const
+		{
+			return n;
+		}
+
+		// NaN if the histogram is empty
+		double min() const;
+		double max() const;
+		double mean() const;
+
+		// The 'p' quantile (0 <= p <= 1), the upper limit of its bin;
+		// NaN if the histogram is empty
+		double percentile(double p) const;
+
+		// number of latencies of bin 'i', and its limits, us
+		std::uint64_t binCount(int i) const
+		{
+			return bins[i];
+		}
+		static double binLower(int i);
+		static double binUpper(int i);
+
+		// one CSV line: name,count,min,mean,p50,p90,p99,max
+		static void printHeader(std::ostream& os);
+		void print(std::ostream& os, const std::string& name) const;
+
+		// the non-empty bins as CSV lines: name,lower,upper,count
+		void printBins(std::ostream& os, const std::string& name) const;
+
+	private:
+		static int bin(double us);
+
+		std::uint64_t bins[NUM_BINS];
+		std::uint64_t n;
+		double sum;
+		double minVal;
+		double maxVal;
+	};
+}
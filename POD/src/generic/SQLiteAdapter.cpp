@@ -75,6 +75,9 @@ namespace pod
         pragmas.push_back("PRAGMA temp_store = \"2\";");
 
         pragmas.push_back("PRAGMA journal_mode = \"OFF\";");
+        // the bulk writes of the wide layout don't wait for the disk
+        if (schema == Wide)
+            pragmas.push_back("PRAGMA synchronous = \"OFF\";");
         pragmas.push_back((boost::format("PRAGMA schema_version = \"%1%\";") % SCHEMA_VERSION).str());
         
         //tryExecuteNonQuery("BEGIN TRANSACTION;");
@@ -90,60 +93,153 @@ namespace pod
         setPragmas();
         sqlite3_exec(db, createSchemaCommand.c_str(), NULL, NULL, NULL);
        // tryExecuteNonQuery(createSchemaCommand.c_str());
+        if (schema == Wide)
+            createWide();
+
+        prepareStatements();
+    }
+
+    void SQLiteAdapter::createWide()
+    {
+        std::string sql =
+            "BEGIN TRANSACTION;"
+            "CREATE TABLE IF NOT EXISTS `SlnValues` ("
+            "	`EpochID`	INTEGER NOT NULL,"
+            "	`Type`	INTEGER NOT NULL,"
+            "	`Value`	REAL NOT NULL,"
+            "	FOREIGN KEY(`EpochID`) REFERENCES `Epochs`(`ID`)"
+            ");"
+            "CREATE TABLE IF NOT EXISTS `SvValueColumns` ("
+            "	`Name`	TEXT NOT NULL,"
+            "	`TypeId`	INTEGER NOT NULL,"
+            "	PRIMARY KEY(`Name`)"
+            ");"
+            "CREATE TABLE IF NOT EXISTS `SvValues` ("
+            "	`EpochID`	INTEGER NOT NULL,"
+            "	`SV`	INTEGER NOT NULL,";
+
+        int i = 0;
+        for (const auto& it : requaredTypes)
+        {
+            sql += "	`" + columnName(it) + "`	REAL,";
+            svColumns[it] = i++;
+        }
+        sql +=
+            "	FOREIGN KEY(`SV`) REFERENCES `SVS`(`ID`),"
+            "	FOREIGN KEY(`EpochID`) REFERENCES `Epochs`(`ID`)"
+            ");";
+
+        for (const auto& it : requaredTypes)
+            sql += (boost::format("INSERT OR IGNORE INTO `SvValueColumns`(`Name`,`TypeId`) VALUES ('%1%', %2%);")
+                % columnName(it) % it.type).str();
+
+        sql += "COMMIT;";
+        sqlite3_exec(db, sql.c_str(), NULL, NULL, NULL);
     }
 
 #pragma endregion
 
 #pragma region insert methods
 
-    void SQLiteAdapter::addNewFile(const pod::GnssEpochMap & eMap)
+    void SQLiteAdapter::prepareStatements()
     {
-        char* sql = "INSERT INTO `GnssObsFile`(`FullName`,`Title`) VALUES( @Name, @Title);";
-        sqlite3_stmt *comm;
-        sqlite3_prepare_v2(db, sql, -1, &comm, NULL);
-        sqlite3_bind_text(comm, 1, eMap.title.c_str(), -1, 0);
-        sqlite3_bind_text(comm, 2, eMap.title.c_str(), -1, 0);
+        insertFileType = prepare("INSERT INTO `TypeIDsByFiles`(`FileId`,`TypeId`) VALUES( @FileId, @TypeId);");
+        insertSv = prepare("INSERT OR IGNORE INTO `SVS`(`SVID`,`SSID`) VALUES (@SVID, @SSID);");
+        selectSv = prepare("SELECT ID FROM SVS WHERE SVID = @SVID AND SSID = @SSID;");
+        insertEpoch = prepare("INSERT INTO `Epochs`(`Time`,`FileID`,'OccupationID') VALUES(@time, @FileID, @OccupationID);");
 
-        lastFileID =  tryExecuteNonQueryAndGetRowId(comm);
+        if (schema == Wide)
+        {
+            insertSlnValue = prepare("INSERT INTO `SlnValues`(`EpochID`,`Type`,`Value`) VALUES (@EpochID, @Type, @Value);");
+
+            std::string columns, values;
+            for (const auto& it : requaredTypes)
+            {
+                columns += ",`" + columnName(it) + "`";
+                values += ",?";
+            }
+            insertSvValues = prepare("INSERT INTO `SvValues`(`EpochID`,`SV`" + columns + ") VALUES (?,?" + values + ");");
+        }
+        else
+        {
+            insertTypePair = prepare("INSERT INTO `RinexTypePairs`(`Type`,`Value`) VALUES (@Type, @Value);");
+            insertSlnItem = prepare("INSERT INTO `SlnDataItems`(`EpochID`,`DataID`) VALUES (@EpochID, @DataID);");
+            insertSvItem = prepare("INSERT INTO `SvDataItems`(`SV`,`DataID`, `EpochID`) VALUES (@SV, @DataID, @EpochID);");
+        }
+    }
+
+    std::string SQLiteAdapter::columnName(const TypeID& type)
+    {
+        std::string name = gpstk::StringUtils::asString(type);
+        for (auto& c : name)
+            if (!isalnum((unsigned char)c))
+                c = '_';
+        return name;
+    }
+
+    void SQLiteAdapter::addNewFile(const pod::GnssEpochMap & eMap)
+    {
+        beginFile(eMap.title);
 
         // fill the  SV metadata
         tryExecuteNonQuery("BEGIN TRANSACTION;");
         for (const auto& it : eMap.svs)
         {
             //add sv to table of all SV
-           int svid  = addSV(it);
-
+           svRowId(it);
         }
         tryExecuteNonQuery("COMMIT;");
 
-        // fill the  TypeId's metadata
-        tryExecuteNonQuery("BEGIN TRANSACTION;");
-        for (const auto it : eMap.types)
-        {
-            char* sql = "INSERT INTO `TypeIDsByFiles`(`FileId`,`TypeId`) VALUES( @FileId, @TypeId);";
-            sqlite3_stmt *comm;
-            sqlite3_prepare_v2(db, sql, -1, &comm, NULL);
-            sqlite3_bind_int(comm, 1, lastFileID);
-            sqlite3_bind_int(comm, 2, it.type);
-            tryExecuteNonQuery(comm);
-        }
-        tryExecuteNonQuery("COMMIT;");
+        addFileTypes(eMap.types);
 
         for (auto& it : eMap.data)
-            addNewEpoch(it);
+            addNewEpoch(it.first, it.second);
 
         finalizeTransactionsSequence();
     }
 
-    void SQLiteAdapter::addObsData(const std::pair<TypeID, double> & typeValuePair)
+    void SQLiteAdapter::beginFile(const std::string& title)
     {
-        char* sql = "INSERT INTO `RinexTypePairs`(`Type`,`Value`) VALUES (@Type, @Value);";
+        char* sql = "INSERT INTO `GnssObsFile`(`FullName`,`Title`) VALUES( @Name, @Title);";
         sqlite3_stmt *comm;
         sqlite3_prepare_v2(db, sql, -1, &comm, NULL);
-        sqlite3_bind_int(comm, 1, typeValuePair.first.type);
-        sqlite3_bind_double(comm, 2, typeValuePair.second);
+        sqlite3_bind_text(comm, 1, title.c_str(), -1, 0);
+        sqlite3_bind_text(comm, 2, title.c_str(), -1, 0);
+
+        lastFileID =  tryExecuteNonQueryAndGetRowId(comm);
+    }
+
+    void SQLiteAdapter::addEpoch(const CommonTime& t, const pod::GnssEpoch& ep)
+    {
+        // the SVs are added as they appear
+        addNewEpoch(t, ep);
+    }
 
-        lastTypeValuePairID = tryExecuteNonQueryAndGetRowId(comm);
+    void SQLiteAdapter::endFile(const TypeIDSet& types)
+    {
+        finalizeTransactionsSequence();
+        addFileTypes(types);
+    }
+
+    void SQLiteAdapter::addFileTypes(const TypeIDSet& types)
+    {
+        // fill the  TypeId's metadata
+        tryExecuteNonQuery("BEGIN TRANSACTION;");
+        for (const auto it : types)
+        {
+            sqlite3_bind_int(insertFileType, 1, lastFileID);
+            sqlite3_bind_int(insertFileType, 2, it.type);
+            executeStatement(insertFileType);
+        }
+        tryExecuteNonQuery("COMMIT;");
+    }
+
+    void SQLiteAdapter::addObsData(const std::pair<TypeID, double> & typeValuePair)
+    {
+        sqlite3_bind_int(insertTypePair, 1, typeValuePair.first.type);
+        sqlite3_bind_double(insertTypePair, 2, typeValuePair.second);
+
+        lastTypeValuePairID = executeStatementAndGetRowId(insertTypePair);
 
         ++obsItemCounter;
     }
@@ -153,13 +249,10 @@ namespace pod
         for(auto& it : slnData)
         {
             addObsData(it);
-            char* sql = "INSERT INTO `SlnDataItems`(`EpochID`,`DataID`) VALUES (@EpochID, @DataID);";
-            sqlite3_stmt *comm;
-            int rc =  sqlite3_prepare_v2(db, sql, -1, &comm, NULL);
-            
-            sqlite3_bind_int(comm, 1, lastEpochID);
-            sqlite3_bind_int64(comm, 2, lastTypeValuePairID);
-            tryExecuteNonQuery(comm);
+
+            sqlite3_bind_int(insertSlnItem, 1, lastEpochID);
+            sqlite3_bind_int64(insertSlnItem, 2, lastTypeValuePairID);
+            executeStatement(insertSlnItem);
         }
     }
 
@@ -167,60 +260,133 @@ namespace pod
     {
         for (auto& svIt : svData)
         {
-            SatID satId = svIt.first;
+            int sv = svRowId(svIt.first);
             for (auto& it : svIt.second)
             {
                 addObsData(it);
-            
-                char* sql = "INSERT INTO `SvDataItems`(`SV`,`DataID`, `EpochID`) VALUES ((SELECT ID FROM SVS WHERE SVID = @SVID AND SSID = @SSID), @DataID, @EpochID);";
-                sqlite3_stmt *comm;
-                int rc  =  sqlite3_prepare_v2(db, sql, -1, &comm, NULL);
-                sqlite3_bind_int(comm, 1, satId.id);
-                sqlite3_bind_int(comm, 2, satId.system);
-                sqlite3_bind_int64(comm, 3, lastTypeValuePairID);
-                sqlite3_bind_int(comm, 4, lastEpochID);
-
-                tryExecuteNonQuery(comm);
+
+                sqlite3_bind_int(insertSvItem, 1, sv);
+                sqlite3_bind_int64(insertSvItem, 2, lastTypeValuePairID);
+                sqlite3_bind_int(insertSvItem, 3, lastEpochID);
+                executeStatement(insertSvItem);
+            }
+        }
+    }
+
+    void SQLiteAdapter::addWideSlnData(const gpstk::typeValueMap& slnData)
+    {
+        for (auto& it : slnData)
+        {
+            sqlite3_bind_int(insertSlnValue, 1, lastEpochID);
+            sqlite3_bind_int(insertSlnValue, 2, it.first.type);
+            sqlite3_bind_double(insertSlnValue, 3, it.second);
+            executeStatement(insertSlnValue);
+            ++obsItemCounter;
+        }
+    }
+
+    void SQLiteAdapter::addWideSvData(const gpstk::satTypeValueMap& svData)
+    {
+        // the columns without a value of the SV stay NULL
+        for (auto& svIt : svData)
+        {
+            sqlite3_bind_int(insertSvValues, 1, lastEpochID);
+            sqlite3_bind_int(insertSvValues, 2, svRowId(svIt.first));
+            for (auto& it : svIt.second)
+            {
+                auto col = svColumns.find(it.first);
+                if (col == svColumns.end())
+                    continue;
+                sqlite3_bind_double(insertSvValues, col->second + 3, it.second);
+                ++obsItemCounter;
             }
+            executeStatement(insertSvValues);
         }
     }
 
-    void SQLiteAdapter::addNewEpoch(const  std::pair<CommonTime, pod::GnssEpoch>& epoch)
+    void SQLiteAdapter::addNewEpoch(const CommonTime& t, const pod::GnssEpoch& ep)
     {
         updateTransaction();
-        char* sql = "INSERT INTO `Epochs`(`Time`,`FileID`,'OccupationID') VALUES(@time, @FileID, @OccupationID);";
-        sqlite3_stmt *comm;
-        sqlite3_prepare_v2(db, sql, -1, &comm, NULL);
-        
-		std::string occId = StringUtils::formatTime(epoch.first);
-        sqlite3_bind_text(comm, 1, occId.c_str(), -1, 0);
-        sqlite3_bind_int(comm,  2, lastFileID);
-        sqlite3_bind_text(comm, 3, "", - 1, 0);
 
-        lastEpochID = tryExecuteNonQueryAndGetRowId(comm);
+		std::string occId = StringUtils::formatTime(t);
+        sqlite3_bind_text(insertEpoch, 1, occId.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(insertEpoch,  2, lastFileID);
+        sqlite3_bind_text(insertEpoch, 3, "", - 1, 0);
 
-        addSlnData(epoch.second.slnData);
+        lastEpochID = executeStatementAndGetRowId(insertEpoch);
+
+        if (schema == Wide)
+        {
+            addWideSlnData(ep.slnData);
+            addWideSvData(ep.satData);
+            return;
+        }
+
+        addSlnData(ep.slnData);
         //TypeIDSet typeSet;// { TypeID::postfitC };
         //typeSet.insert(TypeID::postfitC);
         
-       addSvData(epoch.second.satData.extractTypeID(requaredTypes));
+       addSvData(ep.satData.extractTypeID(requaredTypes));
     }
 
-    int SQLiteAdapter::addSV(const gpstk::SatID & sv)
+    int SQLiteAdapter::svRowId(const gpstk::SatID & sv)
     {
-        char* sql = "INSERT OR IGNORE INTO `SVS`(`SVID`,`SSID`) VALUES (@SVID, @SSID);";
-        sqlite3_stmt *comm;
-        sqlite3_prepare_v2(db, sql, -1, &comm, NULL);
-        sqlite3_bind_int(comm, 1, sv.id);
-        sqlite3_bind_int(comm, 2, (int)sv.system);
+        auto it = svIds.find(sv);
+        if (it == svIds.end())
+            it = svIds.emplace(sv, addSV(sv)).first;
+        return it->second;
+    }
 
-        return tryExecuteNonQueryAndGetRowId(comm);
+    int SQLiteAdapter::addSV(const gpstk::SatID & sv)
+    {
+        sqlite3_bind_int(insertSv, 1, sv.id);
+        sqlite3_bind_int(insertSv, 2, (int)sv.system);
+        executeStatement(insertSv);
+
+        // the SV may have been inserted for another file
+        sqlite3_bind_int(selectSv, 1, sv.id);
+        sqlite3_bind_int(selectSv, 2, (int)sv.system);
+        int id = -1;
+        if (sqlite3_step(selectSv) == SQLITE_ROW)
+            id = sqlite3_column_int(selectSv, 0);
+        sqlite3_reset(selectSv);
+        sqlite3_clear_bindings(selectSv);
+
+        return id;
     }
 
 #pragma endregion
 
 #pragma region service methods
 
+    sqlite3_stmt * SQLiteAdapter::prepare(const std::string& sql)
+    {
+        sqlite3_stmt *comm;
+        int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &comm, NULL);
+        if (rc != SQLITE_OK)
+        {
+            sqlite3_finalize(comm);
+            errorHandler(rc, "Can't compile SQL command.");
+        }
+        statements.push_back(comm);
+        return comm;
+    }
+
+    void SQLiteAdapter::executeStatement(sqlite3_stmt * comm)
+    {
+        int rc = sqlite3_step(comm);
+        sqlite3_reset(comm);
+        sqlite3_clear_bindings(comm);
+        if (rc != SQLITE_DONE && rc != SQLITE_ROW)
+            errorHandler(rc, "Can't execute SQL command.");
+    }
+
+    sqlite3_int64 SQLiteAdapter::executeStatementAndGetRowId(sqlite3_stmt * comm)
+    {
+        executeStatement(comm);
+        return sqlite3_last_insert_rowid(db);
+    }
+
     void SQLiteAdapter::tryExecuteNonQuery(sqlite3_stmt * comm)
     {
         char * zErrMsg;
@@ -5,6 +5,9 @@
 #include"GnssEpochMap.h"
 #include "sqlite3.h"
 
+#include<map>
+#include<vector>
+
 namespace pod
 {
     class SQLiteAdapter
@@ -15,16 +18,34 @@ namespace pod
     public: static const std::string createSchemaCommand;
     public: static const gpstk::TypeIDSet requaredTypes;
 
+            // layout of the epoch data
+    public: enum Schema
+    {
+        // a row of RinexTypePairs for each value, linked to its epoch
+        // (and SV) by a row of SlnDataItems (SvDataItems)
+        Normalized = 0,
+        // a row of SlnValues for each solution value, and a row of
+        // SvValues for each SV of an epoch, with a column for each of
+        // requaredTypes (see SvValueColumns); the connection runs with
+        // synchronous = OFF, so a crash of the system may corrupt the file
+        Wide = 1,
+    };
+
+            // name of the SvValues column of 'type'
+    public: static std::string columnName(const gpstk::TypeID& type);
+
 #pragma endregion
 
 #pragma region Create methods
 
-    public: SQLiteAdapter(const std::string& spath) :firstTime(true), fileName(spath)
+    public: SQLiteAdapter(const std::string& spath, Schema schema = Normalized)
+        :firstTime(true), fileName(spath), schema(schema)
     {
         initialize();
     }
 
-    public: SQLiteAdapter(char * path) :firstTime(true), fileName(path)
+    public: SQLiteAdapter(char * path, Schema schema = Normalized)
+        :firstTime(true), fileName(path), schema(schema)
     {
         initialize();
     }
@@ -37,17 +58,36 @@ namespace pod
 
     private: void setPragmas();
     private: void create();
+    private: void createWide();
+    private: void prepareStatements();
 
 #pragma endregion
 
 #pragma region Insert methods
 
     public:  void addNewFile(const pod::GnssEpochMap & eMap);
+
+             // Adds a file epoch by epoch, as addNewFile() does at once:
+             // beginFile(), addEpoch() for each epoch, then endFile() with
+             // the types of all the epochs.
+    public:  void beginFile(const std::string& title);
+    public:  void addEpoch(const gpstk::CommonTime& t, const pod::GnssEpoch& ep);
+    public:  void endFile(const gpstk::TypeIDSet& types);
+
     private: void addObsData(const std::pair<gpstk::TypeID, double> & typeValuePair);
     private: void addSlnData(const gpstk::typeValueMap& slnData);
     private: void addSvData(const gpstk::satTypeValueMap& svData);
-    private: void addNewEpoch(const std::pair<gpstk::CommonTime, pod::GnssEpoch>& epoch);
+    private: void addWideSlnData(const gpstk::typeValueMap& slnData);
+    private: void addWideSvData(const gpstk::satTypeValueMap& svData);
+    private: void addNewEpoch(const gpstk::CommonTime& t, const pod::GnssEpoch& ep);
+    private: void addFileTypes(const gpstk::TypeIDSet& types);
     private: int  addSV(const gpstk::SatID& sv);
+    private: int  svRowId(const gpstk::SatID& sv);
+
+    public: Schema getSchema() const
+    {
+        return schema;
+    }
 
 #pragma endregion
 
@@ -61,6 +101,11 @@ namespace pod
     private: int tryExecuteNonQueryAndGetRowId(const char * sql);
     private: int tryExecuteNonQueryAndGetRowId(sqlite3_stmt * stmt);
 
+             // prepared statements, kept until the adapter is destroyed
+    private: sqlite3_stmt * prepare(const std::string& sql);
+    private: void executeStatement(sqlite3_stmt * stmt);
+    private: sqlite3_int64 executeStatementAndGetRowId(sqlite3_stmt * stmt);
+
     private: inline void errorHandler(int errorCode, char *error);
 
     private: void updateTransaction();
@@ -70,6 +115,8 @@ namespace pod
 
     public: ~SQLiteAdapter()
     {
+        for (auto it : statements)
+            sqlite3_finalize(it);
         sqlite3_close(db);
     }
 
@@ -78,9 +125,28 @@ namespace pod
     private: std::string fileName;
     private: sqlite3 *db;
 
+    private: Schema schema;
+
     private: int  lastFileID;
     private: int  lastEpochID;
-    private: long lastTypeValuePairID;
+    private: sqlite3_int64 lastTypeValuePairID;
+
+             // IDs of the SVS rows
+    private: std::map<gpstk::SatID, int> svIds;
+
+             // SvValues column (from 0) of each of requaredTypes
+    private: std::map<gpstk::TypeID, int> svColumns;
+
+    private: std::vector<sqlite3_stmt *> statements;
+    private: sqlite3_stmt * insertFileType = nullptr;
+    private: sqlite3_stmt * insertSv = nullptr;
+    private: sqlite3_stmt * selectSv = nullptr;
+    private: sqlite3_stmt * insertEpoch = nullptr;
+    private: sqlite3_stmt * insertTypePair = nullptr;
+    private: sqlite3_stmt * insertSlnItem = nullptr;
+    private: sqlite3_stmt * insertSvItem = nullptr;
+    private: sqlite3_stmt * insertSlnValue = nullptr;
+    private: sqlite3_stmt * insertSvValues = nullptr;
 
     private: bool  firstTime;
     private: int obsItemCounter = 0;
@@ -0,0 +1,24 @@
+#include"SQLiteEpochSink.h"
+
+namespace pod
+{
+    SQLiteEpochSink::SQLiteEpochSink(const std::string& path, const std::string& title,
+                                     SQLiteAdapter::Schema schema)
+        :db(path, schema)
+    {
+        db.beginFile(title);
+    }
+
+    SQLiteEpochSink::~SQLiteEpochSink()
+    { }
+
+    void SQLiteEpochSink::write(const gpstk::CommonTime& t, const GnssEpoch& ep)
+    {
+        db.addEpoch(t, ep);
+    }
+
+    void SQLiteEpochSink::close(const GnssEpochMap& eMap)
+    {
+        db.endFile(eMap.types);
+    }
+}
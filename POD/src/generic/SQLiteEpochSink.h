@@ -0,0 +1,28 @@
+#ifndef POD_SQLITE_EPOCH_SINK
+#define POD_SQLITE_EPOCH_SINK
+
+#include"SQLiteAdapter.h"
+
+#include<string>
+
+namespace pod
+{
+    // Writes the epochs spilled from a GnssEpochMap to a SQLite database,
+    // as a new file titled 'title'; the file is complete once the sink is
+    // closed (see GnssEpochMap::flush).
+    class SQLiteEpochSink :
+        public GnssEpochSink
+    {
+    public: SQLiteEpochSink(const std::string& path, const std::string& title,
+                            SQLiteAdapter::Schema schema = SQLiteAdapter::Normalized);
+
+    public: virtual ~SQLiteEpochSink();
+
+    public: virtual void write(const gpstk::CommonTime& t, const GnssEpoch& ep) override;
+    public: virtual void close(const GnssEpochMap& eMap) override;
+
+    private: SQLiteAdapter db;
+    };
+}
+
+#endif // !POD_SQLITE_EPOCH_SINK
@@ -0,0 +1,88 @@
+#include"SQLiteWriter.h"
+
+namespace pod
+{
+    SQLiteWriter::SQLiteWriter()
+        :numPending(0), stopping(false)
+    {
+        thread = std::thread(&SQLiteWriter::run, this);
+    }
+
+    SQLiteWriter::~SQLiteWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        thread.join();
+    }
+
+    void SQLiteWriter::post(const std::string& path, GnssEpochMap&& eMap,
+                            SQLiteAdapter::Schema schema, DoneCallback done)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            jobs.push_back(Job{ path, std::move(eMap), schema, done });
+            ++numPending;
+        }
+        cv.notify_all();
+    }
+
+    void SQLiteWriter::wait()
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this] { return numPending == 0; });
+
+        if (error)
+        {
+            auto e = error;
+            error = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+    size_t SQLiteWriter::pending() const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return numPending;
+    }
+
+    void SQLiteWriter::run()
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        for (;;)
+        {
+            // the maps posted are written before stopping
+            cv.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty())
+                break;
+
+            Job job(std::move(jobs.front()));
+            jobs.pop_front();
+            lock.unlock();
+
+            std::exception_ptr e;
+            try
+            {
+                SQLiteAdapter db(job.path, job.schema);
+                db.addNewFile(job.eMap);
+            }
+            catch (...)
+            {
+                e = std::current_exception();
+            }
+            // free the map before the next one
+            job.eMap = GnssEpochMap();
+
+            if (job.done)
+                job.done(e);
+
+            lock.lock();
+            if (e && !job.done && !error)
+                error = e;
+            --numPending;
+            cv.notify_all();
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef POD_SQLITE_WRITER
+#define POD_SQLITE_WRITER
+
+#include"SQLiteAdapter.h"
+
+#include<condition_variable>
+#include<deque>
+#include<exception>
+#include<functional>
+#include<mutex>
+#include<string>
+#include<thread>
+
+namespace pod
+{
+    // Writes GnssEpochMaps to SQLite databases in a background thread,
+    // so that the processing goes on while the results are saved.
+    // The maps are written one at a time, in the order they are posted.
+    class SQLiteWriter
+    {
+    public: typedef std::function<void(std::exception_ptr)> DoneCallback;
+
+    public: SQLiteWriter();
+
+            // waits for the maps posted
+    public: ~SQLiteWriter();
+
+            // Queues 'eMap' to be written to the database 'path'.
+            // 'done' is called by the writer thread once the map is
+            // written, with the exception thrown meanwhile, if any.
+    public: void post(const std::string& path, GnssEpochMap&& eMap,
+                      SQLiteAdapter::Schema schema = SQLiteAdapter::Normalized,
+                      DoneCallback done = DoneCallback());
+
+            // Waits until all the maps posted are written; rethrows the
+            // first exception of a map posted without 'done' callback.
+    public: void wait();
+
+            // number of maps not written yet
+    public: size_t pending() const;
+
+    private: void run();
+
+    private: struct Job
+    {
+        std::string path;
+        GnssEpochMap eMap;
+        SQLiteAdapter::Schema schema;
+        DoneCallback done;
+    };
+
+    private: mutable std::mutex mtx;
+    private: std::condition_variable cv;
+    private: std::deque<Job> jobs;
+    private: size_t numPending;
+    private: bool stopping;
+    private: std::exception_ptr error;
+    private: std::thread thread;
+    };
+}
+
+#endif // !POD_SQLITE_WRITER
@@ -0,0 +1,221 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+/// @file RinCache.cpp
+/// Convert RINEX observation files to the binary cache of
+/// Rinex3ObsCacheStream, and back.
+///
+/// A cache keeps the header as RINEX text and the observations in
+/// compressed binary blocks. It is read with Rinex3ObsCacheStream in
+/// place of Rinex3ObsStream, several times faster than the RINEX file,
+/// with the same records except for the auxiliary headers of the event
+/// epochs.
+
+// System
+#include <iostream>
+#include <string>
+
+// gpstk
+#include "BasicFramework.hpp"
+#include "Rinex3ObsCacheStream.hpp"
+#include "Rinex3ObsMappedReader.hpp"
+#include "StringUtils.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class RinCache : public gpstk::BasicFramework
+{
+public:
+   RinCache(const std::string& applName,
+            const std::string& applDesc) throw();
+   ~RinCache() {}
+   virtual bool initialize(int argc, char *argv[]) throw();
+
+protected:
+   virtual void process();
+
+      /// write the RINEX file 'inFn' to the cache 'outFn'
+   void toCache(const string& inFn, const string& outFn);
+      /// write the cache 'inFn' to the RINEX file 'outFn'
+   void toRinex(const string& inFn, const string& outFn);
+
+   gpstk::CommandOptionWithAnyArg inputOption;
+   gpstk::CommandOptionWithAnyArg outputOption;
+   gpstk::CommandOptionNoArg rinexOption;
+   gpstk::CommandOptionWithNumberArg blockOption;
+};
+
+int main( int argc, char*argv[] )
+{
+   try
+   {
+      RinCache fc("RinCache", "Converts RINEX observation files to a binary"
+                  " cache, read faster with Rinex3ObsCacheStream, or the"
+                  " cache back to RINEX.");
+      if (!fc.initialize(argc, argv)) return(fc.exitCode);
+      fc.run();
+      return fc.exitCode;
+   }
+   catch(gpstk::Exception& exc)
+   {
+      cout << exc << endl;
+      return 1;
+   }
+   catch(...)
+   {
+      cout << "Caught an unnamed exception. Exiting." << endl;
+      return 1;
+   }
+   return 0;
+}
+
+RinCache::RinCache(const std::string& applName,
+                   const std::string& applDesc) throw()
+          :BasicFramework(applName, applDesc),
+           inputOption('i', "input-file", "The name of the input file(s) to read.", true),
+           outputOption('o', "output-file", "The name of the output file(s) to write.", true),
+           rinexOption('r', "to-rinex", "Convert caches to RINEX, instead of RINEX to caches."),
+           blockOption('b', "block-size", "Number of epochs in a block of the cache (default=120).")
+{
+   blockOption.setMaxCount(1);
+}
+
+bool RinCache::initialize(int argc, char *argv[])
+   throw()
+{
+   if (!BasicFramework::initialize(argc, argv)) return false;
+
+   if (inputOption.getCount()!=outputOption.getCount())
+   {
+      cout << "Number of input files (" << inputOption.getCount()
+           <<") and output files (" << outputOption.getCount() << ") must match." << endl;
+      exitCode = OPTION_ERROR;
+      return false;
+   }
+
+   if (blockOption.getCount() &&
+       StringUtils::asInt(blockOption.getValue().front()) <= 0)
+   {
+      cout << "The block size must be positive." << endl;
+      exitCode = OPTION_ERROR;
+      return false;
+   }
+
+   return true;
+}
+
+void RinCache::process()
+{
+   for (int i=0;i<inputOption.getCount();i++)
+   {
+      string inFn = inputOption.getValue()[i];
+      string outFn = outputOption.getValue()[i];
+      try
+      {
+         if (rinexOption.getCount())
+            toRinex(inFn, outFn);
+         else
+            toCache(inFn, outFn);
+      }
+      catch(gpstk::Exception& exc)
+      {
+         cout << "Failed to convert " << inFn << ":" << endl << exc << endl;
+         exitCode = EXIST_ERROR;
+      }
+   }
+}
+
+void RinCache::toCache(const string& inFn, const string& outFn)
+{
+   Rinex3ObsMappedReader reader(inFn);
+
+   Rinex3ObsCacheStream out(outFn.c_str(), ios::out);
+   if (!out)
+   {
+      FileMissingException e("Could not open " + outFn);
+      GPSTK_THROW(e);
+   }
+   out.exceptions(ios::failbit);
+   if (blockOption.getCount())
+      out.setBlockSize(StringUtils::asInt(blockOption.getValue().front()));
+
+   Rinex3ObsHeader hdr(reader.getHeader());
+   out << hdr;
+
+   Rinex3ObsData rod;
+   unsigned long count(0);
+   while (reader.read(rod))
+   {
+      out << rod;
+      count++;
+   }
+   out.close();
+
+   if (verboseLevel)
+      cout << inFn << " -> " << outFn << ": " << count << " epochs" << endl;
+}
+
+void RinCache::toRinex(const string& inFn, const string& outFn)
+{
+   Rinex3ObsCacheStream in(inFn.c_str());
+   if (!in)
+   {
+      FileMissingException e("Could not open " + inFn);
+      GPSTK_THROW(e);
+   }
+   Rinex3ObsStream out(outFn.c_str(), ios::out);
+   if (!out)
+   {
+      FileMissingException e("Could not open " + outFn);
+      GPSTK_THROW(e);
+   }
+   out.exceptions(ios::failbit);
+
+   Rinex3ObsHeader hdr;
+   in >> hdr;
+   out << hdr;
+
+   Rinex3ObsData rod;
+   unsigned long count(0);
+   while (in >> rod)
+   {
+      out << rod;
+      count++;
+   }
+
+   if (verboseLevel)
+      cout << inFn << " -> " << outFn << ": " << count << " epochs" << endl;
+}
@@ -63,6 +63,7 @@
 #include "RinexSatID.hpp"
 #include "RinexObsID.hpp"
 #include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsIndex.hpp"
 #include "Rinex3ObsHeader.hpp"
 #include "Rinex3ObsData.hpp"
 
@@ -177,7 +178,7 @@ private:
       endTime = CommonTime::END_OF_TIME;
       decimate = 0.0;
    
-      help = verbose = outver2 = false;
+      help = verbose = outver2 = useIndex = false;
       debug = -1;
 
       messHDdc = messHDda = false;
@@ -191,7 +192,7 @@ public:
    string Title;                 // id line printed to screen and log
 
       // start command line input
-   bool help, verbose, outver2;
+   bool help, verbose, outver2, useIndex;
    int debug;
    string cfgfile;
 
@@ -575,6 +576,10 @@ int processFiles(void) throw(Exception)
             RHout.dump(LOGstrm);
          }
 
+            // skip the epochs before the start time, with the index
+         if(C.useIndex && !Rinex3ObsIndex::seek(istrm, C.beginTime, true))
+            LOG(WARNING) << "Warning : could not index file " << filename;
+
             // loop over epochs ---------------------------------------------
          LOG(INFO) << "Reading observations...";
          while(1)
@@ -1169,6 +1174,8 @@ string Configuration::buildCommandLine(void) throw()
             "Start time: Reject data before this time");
    opts.Add(0, "TE", "t[:f]", false, false, &stopStr, "",
             "Stop  time: Reject data after this time");
+   opts.Add(0, "index", "", false, false, &useIndex, "",
+            "Seek to the start time with index file <file>.idx [made if needed]");
    opts.Add(0, "TT", "dt", false, false, &timetol, "",
             "Tolerance in comparing times, in seconds");
    opts.Add(0, "TN", "dt", false, false, &decimate, "",
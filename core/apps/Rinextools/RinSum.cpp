@@ -64,6 +64,7 @@
 #include "RinexSatID.hpp"
 #include "RinexObsID.hpp"
 #include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsIndex.hpp"
 #include "Rinex3ObsHeader.hpp"
 #include "Rinex3ObsData.hpp"
 #include "RinexUtilities.hpp"
@@ -111,7 +112,7 @@ private:
       endTime.setTimeSystem(TimeSystem::Any);
       userfmt = gpsfmt;
       help = verbose = brief = nohead = notab = gpstime = sorttime = vistab
-         = dogaps = doms = ycode = quiet = false;
+         = dogaps = doms = ycode = quiet = useIndex = false;
       debug = -1;
       dt = -1.0;
       vres = 0;
@@ -126,7 +127,7 @@ public:
 
       // start command line input
    bool help, verbose, brief, nohead, notab, gpstime, sorttime, dogaps, doms,
-      vistab, ycode, quiet;
+      vistab, ycode, quiet, useIndex;
    int debug, vres;
    double dt;
    string cfgfile, userfmt;
@@ -456,6 +457,8 @@ string Configuration::BuildCommandLine(void) throw()
             "Start processing data at this epoch");
    opts.Add(0, "stop", "t[:f]", false, false, &stopStr, "",
             "Stop processing data at this epoch");
+   opts.Add(0, "index", "", false, false, &useIndex, "",
+            "Seek to the start with index file <file>.idx [made if needed]");
    opts.Add(0, "exSat", "sat", true, false, &exSats, "",
             "Exclude satellite (or system) <sat> e.g. G24,R");
    opts.Add(0, "onlySat", "sat", true, false, &onlySats, "",
@@ -854,6 +857,10 @@ int ProcessFiles(void) throw(Exception)
          if(pLOGstrm == &cout && !C.brief)
             LOG(INFO) << "\nReading the observation data...";
 
+            // skip the epochs before the start time, with the index
+         if(C.useIndex && !Rinex3ObsIndex::seek(istrm, C.beginTime, true))
+            LOG(WARNING) << "Warning : could not index file " << filename;
+
             // loop over epochs ---------------------------------------------
          while(1)
          {
@@ -0,0 +1,143 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file MappedFile.cpp
+ * Read-only memory mapping of a whole file.
+ */
+
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gpstk
+{
+   MappedFile ::
+   MappedFile(const std::string& fn)
+      throw(FileMissingException)
+         : filename(fn), addr(0), len(0)
+   {
+#ifdef _WIN32
+      mapHandle = 0;
+      fileHandle = CreateFileA(fn.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+                               OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+      if (fileHandle == INVALID_HANDLE_VALUE)
+      {
+         FileMissingException e("Could not open file " + fn);
+         GPSTK_THROW(e);
+      }
+      LARGE_INTEGER fileSize;
+      if (!GetFileSizeEx(fileHandle, &fileSize))
+      {
+         CloseHandle(fileHandle);
+         FileMissingException e("Could not get the size of file " + fn);
+         GPSTK_THROW(e);
+      }
+      len = static_cast<size_t>(fileSize.QuadPart);
+         // an empty file can't be mapped
+      if (len == 0)
+         return;
+      mapHandle = CreateFileMappingA(fileHandle, 0, PAGE_READONLY, 0, 0, 0);
+      if (mapHandle != 0)
+         addr = static_cast<const char*>(
+            MapViewOfFile(mapHandle, FILE_MAP_READ, 0, 0, 0));
+      if (addr == 0)
+      {
+         if (mapHandle != 0)
+            CloseHandle(mapHandle);
+         CloseHandle(fileHandle);
+         FileMissingException e("Could not map file " + fn);
+         GPSTK_THROW(e);
+      }
+#else
+      int fd = open(fn.c_str(), O_RDONLY);
+      if (fd < 0)
+      {
+         FileMissingException e("Could not open file " + fn);
+         GPSTK_THROW(e);
+      }
+      struct stat st;
+      if (fstat(fd, &st) != 0)
+      {
+         close(fd);
+         FileMissingException e("Could not get the size of file " + fn);
+         GPSTK_THROW(e);
+      }
+      len = static_cast<size_t>(st.st_size);
+         // an empty file can't be mapped
+      if (len == 0)
+      {
+         close(fd);
+         return;
+      }
+      void* p = mmap(0, len, PROT_READ, MAP_PRIVATE, fd, 0);
+         // the mapping stays valid once the file is closed
+      close(fd);
+      if (p == MAP_FAILED)
+      {
+         FileMissingException e("Could not map file " + fn);
+         GPSTK_THROW(e);
+      }
+         // the file is read from start to end
+      madvise(p, len, MADV_SEQUENTIAL);
+      addr = static_cast<const char*>(p);
+#endif
+   }
+
+
+   MappedFile ::
+   ~MappedFile()
+   {
+#ifdef _WIN32
+      if (addr != 0)
+         UnmapViewOfFile(addr);
+      if (mapHandle != 0)
+         CloseHandle(mapHandle);
+      CloseHandle(fileHandle);
+#else
+      if (addr != 0)
+         munmap(const_cast<char*>(addr), len);
+#endif
+   }
+
+} // namespace gpstk
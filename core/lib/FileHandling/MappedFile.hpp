@@ -0,0 +1,104 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file MappedFile.hpp
+ * Read-only memory mapping of a whole file.
+ */
+
+#ifndef GPSTK_MAPPEDFILE_HPP
+#define GPSTK_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "Exception.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * Maps a file into memory, read-only, for the parsers that scan
+       * their input in place instead of reading it line by line
+       * through a stream. The mapping is released by the destructor.
+       *
+       * @sa Rinex3ObsMappedReader
+       */
+   class MappedFile
+   {
+   public:
+         /** Map the file \a fn.
+          * @throw FileMissingException if the file can't be opened or
+          *   mapped. */
+      MappedFile(const std::string& fn)
+         throw(FileMissingException);
+
+         /// Unmap the file.
+      ~MappedFile();
+
+         /// First byte of the file; 0 for an empty file.
+      const char* data() const throw()
+      { return addr; }
+
+         /// Size of the file, in bytes.
+      size_t size() const throw()
+      { return len; }
+
+         /// Name of the mapped file.
+      const std::string& getFilename() const throw()
+      { return filename; }
+
+   private:
+         // a mapping can't be shared
+      MappedFile(const MappedFile&);
+      MappedFile& operator=(const MappedFile&);
+
+      std::string filename;
+      const char* addr;
+      size_t len;
+#ifdef _WIN32
+      void* fileHandle;
+      void* mapHandle;
+#endif
+   }; // class MappedFile
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_MAPPEDFILE_HPP
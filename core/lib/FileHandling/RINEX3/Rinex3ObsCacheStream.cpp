@@ -0,0 +1,663 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file Rinex3ObsCacheStream.cpp
+ * Binary cache of decoded RINEX observation data.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <map>
+
+#include "gpstkplatform.h"
+#include "Rinex3ObsCacheStream.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   namespace
+   {
+         // first bytes of every block
+      const char blockMagic[4] = { 'O', 'B', 'C', '1' };
+
+         // the resolution of the RINEX observations
+      const double scale = 1000.0;
+
+         // LLI or SSI code of a blank
+      const unsigned blankCode = 15;
+
+         // kinds of the values of a column
+      enum ValueKind { blankValue = 0, scaledValue = 1, rawValue = 2 };
+
+         // flags of the epochs
+      enum EpochBits { hasFsod = 1, newTimeSystem = 2, hasClockOffset = 4 };
+
+         // the block encoding is little-endian
+      void putU8(string& b, unsigned v)
+      { b += static_cast<char>(v & 0xff); }
+
+      void putU32(string& b, uint32_t v)
+      {
+         for (int i = 0; i < 4; i++)
+            b += static_cast<char>((v >> 8*i) & 0xff);
+      }
+
+      void putF64(string& b, double v)
+      {
+         uint64_t u;
+         memcpy(&u, &v, 8);
+         for (int i = 0; i < 8; i++)
+            b += static_cast<char>((u >> 8*i) & 0xff);
+      }
+
+         // variable length unsigned integer, 7 bits per byte
+      void putVar(string& b, uint64_t v)
+      {
+         while (v >= 0x80)
+         {
+            b += static_cast<char>((v & 0x7f) | 0x80);
+            v >>= 7;
+         }
+         b += static_cast<char>(v);
+      }
+
+         // variable length signed integer, zigzag encoded
+      void putSVar(string& b, int64_t v)
+      { putVar(b, (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63)); }
+
+         // bounds checked reading of a block
+      class Cursor
+      {
+      public:
+         Cursor(const char* b, const char* e) : p(b), end(e) {}
+
+            /// the next byte to read
+         const char* here() const
+         { return p; }
+
+         const char* bytes(size_t n)
+         {
+            need(n);
+            const char* r = p;
+            p += n;
+            return r;
+         }
+
+         unsigned u8()
+         { return static_cast<unsigned char>(*bytes(1)); }
+
+         uint32_t u32()
+         {
+            const unsigned char* b =
+               reinterpret_cast<const unsigned char*>(bytes(4));
+            return b[0] | (b[1] << 8) | (b[2] << 16) | (uint32_t(b[3]) << 24);
+         }
+
+         double f64()
+         {
+            const unsigned char* b =
+               reinterpret_cast<const unsigned char*>(bytes(8));
+            uint64_t u(0);
+            for (int i = 7; i >= 0; i--)
+               u = (u << 8) | b[i];
+            double v;
+            memcpy(&v, &u, 8);
+            return v;
+         }
+
+         uint64_t var()
+         {
+            uint64_t v(0);
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+               unsigned b = u8();
+               v |= static_cast<uint64_t>(b & 0x7f) << shift;
+               if (!(b & 0x80))
+                  return v;
+            }
+            FFStreamError e("Invalid integer in cache block");
+            GPSTK_THROW(e);
+         }
+
+         int64_t svar()
+         {
+            uint64_t v = var();
+            return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+         }
+
+      private:
+         void need(size_t n)
+         {
+            if (static_cast<size_t>(end - p) < n)
+            {
+               FFStreamError e("Truncated cache block");
+               GPSTK_THROW(e);
+            }
+         }
+
+         const char* p;
+         const char* end;
+      };
+
+         // LLI or SSI code, blankCode if blank
+      unsigned indicatorCode(short value, bool blank)
+         throw(FFStreamError)
+      {
+         if (blank)
+            return blankCode;
+         if (value < 0 || value >= short(blankCode))
+         {
+            FFStreamError e("LLI or SSI out of range: " +
+                            StringUtils::asString(value));
+            GPSTK_THROW(e);
+         }
+         return value;
+      }
+   } // anonymous namespace
+
+
+   Rinex3ObsCacheStream ::
+   Rinex3ObsCacheStream()
+         : file(0), pos(0), numRecords(0), nextRecord(0),
+           epochData(0), epochEnd(0), blockSize(120)
+   {
+   }
+
+
+   Rinex3ObsCacheStream ::
+   Rinex3ObsCacheStream(const char* fn, std::ios::openmode mode)
+         : Rinex3ObsStream(fn, mode | std::ios::binary),
+           file(0), pos(0), numRecords(0), nextRecord(0),
+           epochData(0), epochEnd(0), blockSize(120)
+   {
+   }
+
+
+   Rinex3ObsCacheStream ::
+   ~Rinex3ObsCacheStream()
+   {
+      try
+      {
+         writeBlock();
+      }
+      catch (...)
+      {
+      }
+      delete file;
+   }
+
+
+   void Rinex3ObsCacheStream ::
+   open(const char* fn, std::ios::openmode mode)
+   {
+      reset();
+      headerRead = false;
+      header = Rinex3ObsHeader();
+      Rinex3ObsStream::open(fn, mode | std::ios::binary);
+   }
+
+
+   void Rinex3ObsCacheStream ::
+   open(const std::string& fn, std::ios::openmode mode)
+   {
+      open(fn.c_str(), mode);
+   }
+
+
+   void Rinex3ObsCacheStream ::
+   close()
+   {
+      writeBlock();
+      Rinex3ObsStream::close();
+      reset();
+   }
+
+
+   void Rinex3ObsCacheStream ::
+   reset()
+   {
+      pending.clear();
+      satellites.clear();
+      columns.clear();
+      numRecords = nextRecord = 0;
+      epochData = epochEnd = 0;
+      pos = 0;
+      delete file;
+      file = 0;
+   }
+
+
+   bool Rinex3ObsCacheStream ::
+   isCacheFile(const std::string& fn)
+   {
+      try
+      {
+         Rinex3ObsCacheStream strm(fn.c_str());
+         if (!strm)
+            return false;
+         Rinex3ObsHeader hdr;
+         strm >> hdr;
+         if (!strm)
+            return false;
+         char magic[4];
+         strm.read(magic, 4);
+            // a cache with no epoch is only a header
+         if (strm.gcount() == 0)
+            return true;
+         return (strm.gcount() == 4 && memcmp(magic, blockMagic, 4) == 0);
+      }
+      catch (...)
+      {
+         return false;
+      }
+   }
+
+
+   bool Rinex3ObsCacheStream ::
+   putObsData(const Rinex3ObsData& rod)
+   {
+      pending.push_back(Epoch());
+      Epoch& epoch = pending.back();
+      epoch.time = rod.time;
+      epoch.epochFlag = rod.epochFlag;
+         // the auxiliary header records are not kept
+      epoch.numSVs = (rod.epochFlag >= 2 && rod.epochFlag <= 5) ? 0
+                                                                : rod.numSVs;
+      epoch.clockOffset = rod.clockOffset;
+      epoch.obs = rod.obs;
+
+      if (pending.size() >= blockSize)
+         writeBlock();
+      return true;
+   }
+
+
+   void Rinex3ObsCacheStream ::
+   writeBlock()
+      throw(FFStreamError)
+   {
+      if (pending.empty())
+         return;
+
+      string buf;
+      putU32(buf, pending.size());
+
+         // the epochs
+      long prevDay(0), prevMsod(0);
+      TimeSystem prevSys(TimeSystem::Unknown);
+      for (size_t e = 0; e < pending.size(); e++)
+      {
+         const Epoch& epoch = pending[e];
+         long day, msod;
+         double fsod;
+         TimeSystem sys;
+         epoch.time.getInternal(day, msod, fsod, sys);
+
+         unsigned bits(0);
+         if (fsod != 0.)
+            bits |= hasFsod;
+         if (sys != prevSys)
+            bits |= newTimeSystem;
+         if (epoch.clockOffset != 0.)
+            bits |= hasClockOffset;
+
+         putU8(buf, bits);
+         putSVar(buf, day - prevDay);
+         putSVar(buf, msod - prevMsod);
+         if (bits & hasFsod)
+            putF64(buf, fsod);
+         if (bits & newTimeSystem)
+            putU8(buf, sys.getTimeSystem());
+         if (bits & hasClockOffset)
+            putF64(buf, epoch.clockOffset);
+         putU8(buf, epoch.epochFlag);
+         putSVar(buf, epoch.numSVs);
+
+         prevDay = day;
+         prevMsod = msod;
+         prevSys = sys;
+      }
+
+         // the satellites of the block, with their number of observations
+      map<RinexSatID, size_t> sats;
+      for (size_t e = 0; e < pending.size(); e++)
+      {
+         Rinex3ObsData::DataMap::const_iterator it;
+         for (it = pending[e].obs.begin(); it != pending[e].obs.end(); ++it)
+         {
+            size_t& n = sats[it->first];
+            n = std::max(n, it->second.size());
+         }
+      }
+
+      putVar(buf, sats.size());
+      string kinds, codes, values;
+      vector<const vector<RinexDatum>*> present;
+      for (map<RinexSatID, size_t>::const_iterator st = sats.begin();
+           st != sats.end(); ++st)
+      {
+         const RinexSatID& sat = st->first;
+         putU8(buf, sat.systemChar());
+         putSVar(buf, sat.id);
+         putVar(buf, st->second);
+
+            // the epochs where the satellite is present
+         present.clear();
+         string bitmap((pending.size() + 7) / 8, '\0');
+         for (size_t e = 0; e < pending.size(); e++)
+         {
+            Rinex3ObsData::DataMap::const_iterator it =
+               pending[e].obs.find(sat);
+            if (it != pending[e].obs.end())
+            {
+               bitmap[e/8] |= static_cast<char>(1 << (e % 8));
+               present.push_back(&it->second);
+            }
+         }
+         buf += bitmap;
+
+            // one column per observation type
+         for (size_t j = 0; j < st->second; j++)
+         {
+            kinds.clear();
+            codes.clear();
+            values.clear();
+            int64_t prev(0);
+            for (size_t k = 0; k < present.size(); k++)
+            {
+               RinexDatum d;
+               if (j < present[k]->size())
+                  d = (*present[k])[j];
+
+               putU8(codes, (indicatorCode(d.lli, d.lliBlank) << 4) |
+                            indicatorCode(d.ssi, d.ssiBlank));
+
+               if (d.dataBlank)
+               {
+                  putU8(kinds, blankValue);
+                  continue;
+               }
+
+                  // the scaled integer must give back the same bits
+               double m = std::floor(d.data * scale + 0.5);
+               if (std::fabs(m) < 9.0e15 && m / scale == d.data &&
+                   !(d.data == 0. && std::signbit(d.data)))
+               {
+                  int64_t i = static_cast<int64_t>(m);
+                  putU8(kinds, scaledValue);
+                  putSVar(values, i - prev);
+                  prev = i;
+               }
+               else
+               {
+                  putU8(kinds, rawValue);
+                  putF64(values, d.data);
+               }
+            }
+            buf += kinds;
+            buf += codes;
+            buf += values;
+         }
+      }
+
+      pending.clear();
+
+      string frame(blockMagic, 4);
+      putU32(frame, buf.size());
+      write(frame.data(), frame.size());
+      write(buf.data(), buf.size());
+      if (!good())
+      {
+         FFStreamError e("Could not write cache block in " + filename);
+         GPSTK_THROW(e);
+      }
+   }
+
+
+   bool Rinex3ObsCacheStream ::
+   getObsData(Rinex3ObsData& rod)
+   {
+      if (nextRecord >= numRecords)
+      {
+         if (file == 0)
+         {
+               // the blocks start after the header
+            pos = tellg();
+            file = new MappedFile(filename);
+         }
+         if (pos >= file->size())
+         {
+               // set eof and fail, as the text streams do at the end of
+               // the file, before leaving
+            try
+            {
+               seekg(0, std::ios::end);
+               get();
+            }
+            catch (std::exception&)
+            {
+            }
+            EndOfFile err("EOF encountered");
+            GPSTK_THROW(err);
+         }
+         readBlock();
+      }
+
+      decodeEpoch(rod);
+      if (rod.auxHeader.valid != 0)
+         rod.auxHeader.clear();
+      return true;
+   }
+
+
+   void Rinex3ObsCacheStream ::
+   readBlock()
+      throw(FFStreamError)
+   {
+      Cursor frame(file->data() + pos, file->data() + file->size());
+      if (memcmp(frame.bytes(4), blockMagic, 4) != 0)
+      {
+         FFStreamError e("Not a cache block at offset " +
+                         StringUtils::asString(pos));
+         GPSTK_THROW(e);
+      }
+      size_t size = frame.u32();
+      const char* begin = frame.bytes(size);
+      pos += 8 + size;
+      Cursor c(begin, begin + size);
+
+         // the epochs, skipped until they are decoded
+      numRecords = c.u32();
+      nextRecord = 0;
+      epochData = c.here();
+      for (size_t e = 0; e < numRecords; e++)
+      {
+         unsigned bits = c.u8();
+         c.var();
+         c.var();
+         if (bits & hasFsod)
+            c.f64();
+         if (bits & newTimeSystem)
+            c.u8();
+         if (bits & hasClockOffset)
+            c.f64();
+         c.u8();
+         c.var();
+      }
+      epochEnd = c.here();
+      day = msod = 0;
+      timeSystem = TimeSystem::Unknown;
+
+         // the satellites, and where their columns start
+      size_t numSats = c.var();
+      satellites.resize(numSats);
+      columns.clear();
+      for (size_t s = 0; s < numSats; s++)
+      {
+         Satellite& sat = satellites[s];
+         try
+         {
+            sat.sat.fromString(string(1, static_cast<char>(c.u8())));
+         }
+         catch (Exception& exc)
+         {
+            FFStreamError e(exc);
+            GPSTK_THROW(e);
+         }
+         sat.sat.id = c.svar();
+         sat.numObs = c.var();
+         sat.bitmap = c.bytes((numRecords + 7) / 8);
+         sat.firstColumn = columns.size();
+
+         size_t present(0);
+         for (size_t e = 0; e < numRecords; e++)
+         {
+            if (sat.bitmap[e/8] & (1 << (e % 8)))
+               present++;
+         }
+
+         for (size_t j = 0; j < sat.numObs; j++)
+         {
+            Column col;
+            col.kinds = c.bytes(present);
+            col.codes = c.bytes(present);
+            col.values = c.here();
+            col.prev = 0;
+            col.next = 0;
+            for (size_t k = 0; k < present; k++)
+            {
+               switch (col.kinds[k])
+               {
+                  case blankValue:
+                     break;
+                  case scaledValue:
+                     c.var();
+                     break;
+                  case rawValue:
+                     c.f64();
+                     break;
+                  default:
+                     FFStreamError e("Invalid value in cache block");
+                     GPSTK_THROW(e);
+               }
+            }
+            col.end = c.here();
+            columns.push_back(col);
+         }
+      }
+   }
+
+
+   void Rinex3ObsCacheStream ::
+   decodeEpoch(Rinex3ObsData& rod)
+      throw(FFStreamError)
+   {
+      size_t e = nextRecord++;
+
+      Cursor c(epochData, epochEnd);
+      unsigned bits = c.u8();
+      day += c.svar();
+      msod += c.svar();
+      double fsod = (bits & hasFsod) ? c.f64() : 0.;
+      if (bits & newTimeSystem)
+         timeSystem = TimeSystem(static_cast<int>(c.u8()));
+      try
+      {
+         rod.time.setInternal(day, msod, fsod, timeSystem);
+      }
+      catch (Exception& exc)
+      {
+         FFStreamError e(exc);
+         GPSTK_THROW(e);
+      }
+      rod.clockOffset = (bits & hasClockOffset) ? c.f64() : 0.;
+      rod.epochFlag = c.u8();
+      rod.numSVs = c.svar();
+      epochData = c.here();
+
+         // the satellites come in order: the entries of the previous
+         // record are reused while they are the same satellites
+      Rinex3ObsData::DataMap::iterator it = rod.obs.begin();
+      for (size_t s = 0; s < satellites.size(); s++)
+      {
+         const Satellite& sat = satellites[s];
+         if (!(sat.bitmap[e/8] & (1 << (e % 8))))
+            continue;
+
+         while (it != rod.obs.end() && it->first < sat.sat)
+            rod.obs.erase(it++);
+         if (it == rod.obs.end() || sat.sat < it->first)
+            it = rod.obs.insert(it, make_pair(sat.sat,
+                                              vector<RinexDatum>()));
+         vector<RinexDatum>& data = (it++)->second;
+         data.resize(sat.numObs);
+         for (size_t j = 0; j < sat.numObs; j++)
+         {
+            Column& col = columns[sat.firstColumn + j];
+            RinexDatum& d = data[j];
+            unsigned code = static_cast<unsigned char>(col.codes[col.next]);
+            d.lliBlank = ((code >> 4) == blankCode);
+            d.lli = d.lliBlank ? 0 : (code >> 4);
+            d.ssiBlank = ((code & 0xf) == blankCode);
+            d.ssi = d.ssiBlank ? 0 : (code & 0xf);
+
+               // the kinds were checked by readBlock()
+            Cursor v(col.values, col.end);
+            switch (col.kinds[col.next++])
+            {
+               case blankValue:
+                  d.data = 0.;
+                  d.dataBlank = true;
+                  break;
+               case scaledValue:
+                  col.prev += v.svar();
+                  d.data = static_cast<double>(col.prev) / scale;
+                  d.dataBlank = false;
+                  break;
+               default:
+                  d.data = v.f64();
+                  d.dataBlank = false;
+                  break;
+            }
+            col.values = v.here();
+         }
+      }
+      rod.obs.erase(it, rod.obs.end());
+   }
+
+} // namespace gpstk
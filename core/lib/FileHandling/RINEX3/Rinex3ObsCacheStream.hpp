@@ -0,0 +1,209 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file Rinex3ObsCacheStream.hpp
+ * Binary cache of decoded RINEX observation data.
+ */
+
+#ifndef RINEX3OBSCACHESTREAM_HPP
+#define RINEX3OBSCACHESTREAM_HPP
+
+#include <string>
+#include <vector>
+
+#include "gpstkplatform.h"
+#include "MappedFile.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsData.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * This class reads and writes a compact binary form of RINEX
+       * observation files, meant as a cache of the decoded data for the
+       * files that are processed many times: reading it parses no text.
+       *
+       * It is used like Rinex3ObsStream, with Rinex3ObsHeader and
+       * Rinex3ObsData, also through a Rinex3ObsStream reference:
+       * @code
+       * Rinex3ObsCacheStream ostrm("site0010.15obc", ios::out);
+       * ostrm << header;
+       * while (...)
+       *    ostrm << rod;
+       * ostrm.close();
+       *
+       * Rinex3ObsCacheStream istrm("site0010.15obc");
+       * istrm >> header;
+       * while (istrm >> rod)
+       *    ...
+       * @endcode
+       *
+       * The file is the RINEX header, as text, followed by blocks of
+       * epochs. Inside a block the data are stored by column: the
+       * epoch times, delta-encoded, then for every satellite the epochs
+       * where it is present and, for every observation type, the
+       * LLI/SSI and the values. The values are stored as integers in
+       * units of 0.001, the resolution of RINEX, delta-encoded within
+       * the column; the values that can't be restored exactly this way
+       * are stored as doubles. Reading gives the same records, to the
+       * bit, as the ones that were written.
+       *
+       * The records are decoded from a memory mapping of the file when
+       * they are read: reading a block only finds where its columns
+       * start, and every record is then decoded from the columns. They
+       * are written one block at a time: the last block is written by
+       * close(), by the destructor or by writeBlock().
+       *
+       * Event records (epoch flags 2 to 5) keep their time and flag,
+       * but not their auxiliary header records.
+       */
+   class Rinex3ObsCacheStream : public Rinex3ObsStream
+   {
+   public:
+         /// Default constructor
+      Rinex3ObsCacheStream();
+
+         /** Common constructor.
+          * @param[in] fn the cache file to open
+          * @param[in] mode how to open \a fn; it is always binary. */
+      Rinex3ObsCacheStream(const char* fn,
+                           std::ios::openmode mode = std::ios::in);
+
+         /// Write the pending epochs, if any.
+      virtual ~Rinex3ObsCacheStream();
+
+         /// Overrides open to reset the header and the blocks
+      virtual void open(const char* fn, std::ios::openmode mode);
+
+         /// Overrides open to reset the header and the blocks
+      virtual void open(const std::string& fn, std::ios::openmode mode);
+
+         /// Write the pending epochs, then close the file.
+      void close();
+
+         /** Write the pending epochs as a block.
+          * @throw FFStreamError if an epoch can't be stored. */
+      void writeBlock()
+         throw(FFStreamError);
+
+         /// Set the number of epochs of the blocks written (default 120).
+      void setBlockSize(size_t n)
+      { blockSize = (n > 0 ? n : 1); }
+
+         /// True if \a fn is a cache file.
+      static bool isCacheFile(const std::string& fn);
+
+         /// Read the next record of the cache.
+      virtual bool getObsData(Rinex3ObsData& rod);
+
+         /// Add \a rod to the block being written.
+      virtual bool putObsData(const Rinex3ObsData& rod);
+
+   private:
+         /// An epoch of a block; a Rinex3ObsData without its auxHeader.
+      struct Epoch
+      {
+         CommonTime time;
+         short epochFlag;
+         short numSVs;
+         double clockOffset;
+         Rinex3ObsData::DataMap obs;
+      };
+
+         /// Where the next value of an observation column is.
+      struct Column
+      {
+         const char* kinds;   ///< kind of every value of the column
+         const char* codes;   ///< LLI and SSI of every value
+         const char* values;  ///< next encoded value
+         const char* end;     ///< end of the values
+         int64_t prev;        ///< last scaled value decoded
+         size_t next;         ///< index of the next value
+      };
+
+         /// A satellite of the block being read.
+      struct Satellite
+      {
+         RinexSatID sat;
+         size_t numObs;        ///< number of observation columns
+         const char* bitmap;   ///< epochs where the satellite is present
+         size_t firstColumn;   ///< index of its first column in 'columns'
+      };
+
+         /** Index the next block of the mapping: find its epochs, its
+          * satellites and the start of every column. */
+      void readBlock()
+         throw(FFStreamError);
+
+         /// Decode the next epoch of the block into  rod.
+      void decodeEpoch(Rinex3ObsData& rod)
+         throw(FFStreamError);
+
+         /// Clear the blocks and the mapping.
+      void reset();
+
+         /// The file, mapped once the header is read.
+      MappedFile* file;
+         /// Offset of the next block in the mapping.
+      size_t pos;
+
+         /// Epochs of the block being read, and where the next one is.
+      size_t numRecords;
+      size_t nextRecord;
+      const char* epochData;
+      const char* epochEnd;
+         /// Time of the last epoch decoded.
+      long day, msod;
+      TimeSystem timeSystem;
+
+         /// Satellites and columns of the block being read.
+      std::vector<Satellite> satellites;
+      std::vector<Column> columns;
+
+         /// Records of the block being written.
+      std::vector<Epoch> pending;
+      size_t blockSize;
+   }; // class Rinex3ObsCacheStream
+
+      //@}
+
+} // namespace gpstk
+
+#endif // RINEX3OBSCACHESTREAM_HPP
@@ -288,6 +288,9 @@ namespace gpstk
 
       Rinex3ObsStream& strm = dynamic_cast<Rinex3ObsStream&>(ffs);
 
+         // records that are not RINEX text, e.g. Rinex3ObsCacheStream
+      if(strm.putObsData(*this)) return;
+
          // call the version for RINEX ver 2
       if(strm.header.version < 3)
       {
@@ -581,6 +584,9 @@ namespace gpstk
          // If the header hasn't been read, read it.
       if(!strm.headerRead) strm >> strm.header;
 
+         // records that are not RINEX text, e.g. Rinex3ObsCacheStream
+      if(strm.getObsData(*this)) return;
+
          // call the version for RINEX ver 2
       if(strm.header.version < 3)
       {
@@ -0,0 +1,248 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file Rinex3ObsIndex.cpp
+ * Index of the epoch records of a RINEX observation file.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "Rinex3ObsMappedReader.hpp"
+#include "Rinex3ObsIndex.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   namespace
+   {
+         // first line of the index files
+      const char* indexMagic = "RINEXOBSINDEX 1";
+
+         // size and modification time of 'fn'; false if it is missing
+      bool fileStat(const string& fn, size_t& size, long long& mtime)
+      {
+         struct stat st;
+         if (stat(fn.c_str(), &st) != 0)
+            return false;
+         size = st.st_size;
+         mtime = st.st_mtime;
+         return true;
+      }
+
+      bool timeLess(const Rinex3ObsIndex::Entry& e, const CommonTime& t)
+      { return e.time < t; }
+
+      bool lessTime(const CommonTime& t, const Rinex3ObsIndex::Entry& e)
+      { return t < e.time; }
+   }
+
+
+   Rinex3ObsIndex ::
+   Rinex3ObsIndex()
+         : fileSize(0), endOffset(0), fileTime(-1)
+   {
+   }
+
+
+   void Rinex3ObsIndex ::
+   build(const std::string& fn)
+      throw(FileMissingException, FFStreamError)
+   {
+      Rinex3ObsMappedReader reader(fn);
+
+      filename = fn;
+      if (!fileStat(fn, fileSize, fileTime))
+         fileTime = -1;
+      fileSize = reader.size();
+      entries.clear();
+
+      CommonTime prev(CommonTime::BEGINNING_OF_TIME);
+      Entry entry;
+      try
+      {
+         for (;;)
+         {
+            entry.offset = reader.getPosition();
+            if (!reader.skip(entry.time))
+               break;
+            if (entry.time == CommonTime::BEGINNING_OF_TIME)
+               entry.time = prev;
+            prev = entry.time;
+            entries.push_back(entry);
+         }
+      }
+      catch (FFStreamError& e)
+      {
+            // the records from here on are left to the readers, which
+            // will find the error again
+      }
+      endOffset = reader.getPosition();
+   }
+
+
+   bool Rinex3ObsIndex ::
+   load(const std::string& fn, const std::string& idxFile)
+   {
+      ifstream ifs(idxFile.c_str());
+      string magic;
+      if (!getline(ifs, magic) || magic != indexMagic)
+         return false;
+
+      size_t size, end, count, fnSize;
+      long long mtime, fnTime;
+      ifs >> size >> mtime >> end >> count;
+      if (!ifs || !fileStat(fn, fnSize, fnTime) ||
+          size != fnSize || mtime != fnTime)
+         return false;
+
+      vector<Entry> tmp(count);
+      for (size_t i = 0; i < count; i++)
+      {
+         long day, msod;
+         double fsod;
+         int sys;
+         ifs >> tmp[i].offset >> day >> msod >> fsod >> sys;
+         if (!ifs)
+            return false;
+         tmp[i].time.setInternal(day, msod, fsod, TimeSystem(sys));
+      }
+
+      filename = fn;
+      fileSize = size;
+      fileTime = mtime;
+      endOffset = end;
+      entries.swap(tmp);
+      return true;
+   }
+
+
+   void Rinex3ObsIndex ::
+   save(const std::string& idxFile) const
+      throw(FileMissingException)
+   {
+      ofstream ofs(idxFile.c_str());
+      if (!ofs)
+      {
+         FileMissingException e("Could not open file " + idxFile);
+         GPSTK_THROW(e);
+      }
+
+      ofs << indexMagic << endl
+          << fileSize << " " << fileTime << " " << endOffset << " "
+          << entries.size() << endl
+          << setprecision(17);
+      for (size_t i = 0; i < entries.size(); i++)
+      {
+         long day, msod;
+         double fsod;
+         TimeSystem sys;
+         entries[i].time.getInternal(day, msod, fsod, sys);
+         ofs << entries[i].offset << " " << day << " " << msod << " "
+             << fsod << " " << static_cast<int>(sys.getTimeSystem()) << endl;
+      }
+
+      if (!ofs)
+      {
+         FileMissingException e("Could not write file " + idxFile);
+         GPSTK_THROW(e);
+      }
+   }
+
+
+   void Rinex3ObsIndex ::
+   open(const std::string& fn)
+      throw(FileMissingException, FFStreamError)
+   {
+      string idxFile = sidecarName(fn);
+      if (load(fn, idxFile))
+         return;
+
+      build(fn);
+      try
+      {
+         save(idxFile);
+      }
+      catch (FileMissingException& e)
+      {
+            // a read-only directory only costs the scan next time
+      }
+   }
+
+
+   bool Rinex3ObsIndex ::
+   seek(Rinex3ObsStream& strm, const CommonTime& t, bool useSidecar)
+   {
+      try
+      {
+         Rinex3ObsIndex index;
+         if (useSidecar)
+            index.open(strm.filename);
+         else
+            index.build(strm.filename);
+         size_t i = index.lowerBound(t);
+         strm.clear();
+         strm.seekg(i < index.size() ? index[i].offset : index.getEndOffset());
+         return true;
+      }
+      catch (Exception& e)
+      {
+         return false;
+      }
+   }
+
+
+   size_t Rinex3ObsIndex ::
+   lowerBound(const CommonTime& t) const
+   {
+      return std::lower_bound(entries.begin(), entries.end(), t, timeLess)
+         - entries.begin();
+   }
+
+
+   size_t Rinex3ObsIndex ::
+   upperBound(const CommonTime& t) const
+   {
+      return std::upper_bound(entries.begin(), entries.end(), t, lessTime)
+         - entries.begin();
+   }
+
+} // namespace gpstk
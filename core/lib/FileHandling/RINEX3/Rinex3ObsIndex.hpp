@@ -0,0 +1,170 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file Rinex3ObsIndex.hpp
+ * Index of the epoch records of a RINEX observation file.
+ */
+
+#ifndef RINEX3OBSINDEX_HPP
+#define RINEX3OBSINDEX_HPP
+
+#include <string>
+#include <vector>
+
+#include "CommonTime.hpp"
+#include "Exception.hpp"
+#include "FFStreamError.hpp"
+
+namespace gpstk
+{
+   class Rinex3ObsStream;
+
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * The time and the offset in the file of every epoch record of a
+       * RINEX observation file. With it, the records can be decoded in
+       * any order (see Rinex3ObsParallelReader), and the first record of
+       * a time window is found by a binary search instead of reading
+       * the file from the start (see Rinex3ObsMappedReader::setPosition).
+       *
+       * The index of a RINEX 3 file is built by scanning its epoch lines
+       * in a memory mapping of the file; RINEX 2 files are read through
+       * the stream. It can be saved in a sidecar file, by default the
+       * name of the observation file plus ".idx", which is used as long
+       * as the size and the modification time of the observation file
+       * don't change.
+       *
+       * The epochs with no time (event records) get the time of the
+       * previous epoch, so the times are sorted as long as the epochs
+       * of the file are.
+       */
+   class Rinex3ObsIndex
+   {
+   public:
+         /// One epoch record
+      struct Entry
+      {
+         CommonTime time;     ///< time of the epoch
+         size_t offset;       ///< offset of the epoch line in the file
+      };
+
+         /// An empty index
+      Rinex3ObsIndex();
+
+         /** Index the file \a fn by scanning it.
+          * The scan stops at the first record that is not valid, see
+          * getEndOffset().
+          * @throw FileMissingException if the file can't be opened.
+          * @throw FFStreamError if the header is not valid. */
+      void build(const std::string& fn)
+         throw(FileMissingException, FFStreamError);
+
+         /** Read the index of the file \a fn saved in \a idxFile.
+          * @return false if \a idxFile can't be read or is out of date
+          *   with respect to \a fn. */
+      bool load(const std::string& fn, const std::string& idxFile);
+
+         /** Save the index in \a idxFile.
+          * @throw FileMissingException if \a idxFile can't be written. */
+      void save(const std::string& idxFile) const
+         throw(FileMissingException);
+
+         /** Load the index of \a fn from its sidecar file or, if it is
+          * missing or out of date, build it and try to save it there.
+          * @throw FileMissingException if the file can't be opened.
+          * @throw FFStreamError if the header is not valid. */
+      void open(const std::string& fn)
+         throw(FileMissingException, FFStreamError);
+
+         /** Move \a strm, whose header has been read, to the first
+          * epoch at or after \a t, using the index of its file.
+          * @param[in] useSidecar load the index from its sidecar file,
+          *   or save it there, see open()
+          * @return false if the file could not be indexed or \a t
+          *   can't be compared with its times; \a strm is then left
+          *   where it was. */
+      static bool seek(Rinex3ObsStream& strm, const CommonTime& t,
+                       bool useSidecar = false);
+
+         /// Name of the sidecar index file of \a fn.
+      static std::string sidecarName(const std::string& fn)
+      { return fn + ".idx"; }
+
+         /// Name of the indexed file.
+      const std::string& getFilename() const throw()
+      { return filename; }
+
+         /// Number of epoch records.
+      size_t size() const throw()
+      { return entries.size(); }
+
+         /// Epoch record \a i.
+      const Entry& operator[](size_t i) const throw()
+      { return entries[i]; }
+
+         /** Index of the first epoch at or after \a t, size() if none.
+          * The time system of \a t must be the one of the file, or Any. */
+      size_t lowerBound(const CommonTime& t) const;
+
+         /// Index of the first epoch after \a t, size() if none.
+      size_t upperBound(const CommonTime& t) const;
+
+         /// Size of the indexed file.
+      size_t getFileSize() const throw()
+      { return fileSize; }
+
+         /** Offset where the scan stopped: the size of the file, or the
+          * offset of its first record that is not valid. */
+      size_t getEndOffset() const throw()
+      { return endOffset; }
+
+   private:
+      std::string filename;
+      std::vector<Entry> entries;
+      size_t fileSize;
+      size_t endOffset;
+         /// modification time of the file, seconds since 1970
+      long long fileTime;
+   }; // class Rinex3ObsIndex
+
+      //@}
+
+} // namespace gpstk
+
+#endif // RINEX3OBSINDEX_HPP
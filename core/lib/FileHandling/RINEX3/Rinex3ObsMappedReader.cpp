@@ -0,0 +1,545 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file Rinex3ObsMappedReader.cpp
+ * Fast reader of RINEX 3 observation files, parsing a memory-mapped file
+ * in place.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "CivilTime.hpp"
+#include "StringUtils.hpp"
+#include "Rinex3ObsMappedReader.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   namespace
+   {
+         // powers of ten that are exact doubles
+      const double exactPow10[] =
+      { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18 };
+
+         // largest integer such that all the smaller ones are exact doubles
+      const unsigned long long maxExactInt = 1ULL << 53;
+
+      inline bool isDigit(char c)
+      { return c >= '0' && c <= '9'; }
+
+         // strtol() of the 'w' characters at 'p'
+      long parseInt(const char* p, size_t w)
+      {
+         const char* end = p + w;
+         while (p < end && (*p == ' ' || *p == '\t'))
+            p++;
+         bool neg(false);
+         if (p < end && (*p == '-' || *p == '+'))
+            neg = (*p++ == '-');
+         long v(0);
+         while (p < end && isDigit(*p))
+            v = 10*v + (*p++ - '0');
+         return neg ? -v : v;
+      }
+
+         // strtod() of the 'w' characters at 'p'.
+         // The fixed point numbers of the RINEX files are decoded here
+         // as an integer divided by a power of ten: both are exact
+         // doubles, so the quotient is the correctly rounded value that
+         // strtod() would return. Anything else goes to strtod().
+      double parseDouble(const char* p, size_t w)
+      {
+         const char* s = p;
+         const char* end = p + w;
+         while (s < end && *s == ' ')
+            s++;
+         bool neg(false);
+         if (s < end && (*s == '-' || *s == '+'))
+            neg = (*s++ == '-');
+         unsigned long long mant(0);
+         int numDigits(0), numDecimals(0);
+         while (s < end && isDigit(*s))
+         {
+            mant = 10*mant + (*s++ - '0');
+            numDigits++;
+         }
+         if (s < end && *s == '.')
+         {
+            s++;
+            while (s < end && isDigit(*s))
+            {
+               mant = 10*mant + (*s++ - '0');
+               numDigits++;
+               numDecimals++;
+            }
+         }
+         if (numDigits > 0 && numDigits <= 18 && mant < maxExactInt &&
+             (s == end || *s == ' '))
+         {
+            double v = static_cast<double>(mant) / exactPow10[numDecimals];
+            return neg ? -v : v;
+         }
+
+         char buf[64];
+         w = std::min(w, sizeof(buf) - 1);
+         memcpy(buf, p, w);
+         buf[w] = 0;
+         return strtod(buf, 0);
+      }
+
+         // RinexDatum::fromString() of the 'n' (at most 16) characters
+         // at 'p', followed by blanks
+      void parseDatum(const char* p, size_t n, RinexDatum& d)
+      {
+         size_t w = std::min(n, size_t(14));
+         d.dataBlank = true;
+         for (size_t i = 0; i < w; i++)
+         {
+            if (p[i] != ' ')
+            {
+               d.dataBlank = false;
+               break;
+            }
+         }
+         d.data = d.dataBlank ? 0. : parseDouble(p, w);
+
+         d.lliBlank = (n <= 14 || p[14] == ' ');
+         d.lli = (!d.lliBlank && isDigit(p[14])) ? p[14] - '0' : 0;
+         d.ssiBlank = (n <= 15 || p[15] == ' ');
+         d.ssi = (!d.ssiBlank && isDigit(p[15])) ? p[15] - '0' : 0;
+      }
+
+         // RinexSatID of the first 3 of the 'n' characters at 'p'
+      RinexSatID parseSat(const char* p, size_t n)
+         throw(FFStreamError)
+      {
+         if (n >= 3 && (p[1] == ' ' || isDigit(p[1])) && isDigit(p[2]))
+         {
+            SatID::SatelliteSystem sys(SatID::systemUnknown);
+            switch (p[0])
+            {
+               case 'G': case 'g': sys = SatID::systemGPS;     break;
+               case 'R': case 'r': sys = SatID::systemGlonass; break;
+               case 'E': case 'e': sys = SatID::systemGalileo; break;
+               case 'C': case 'c': sys = SatID::systemBeiDou;  break;
+               case 'J': case 'j': sys = SatID::systemQZSS;    break;
+               case 'S': case 's': sys = SatID::systemGeosync; break;
+               case 'I': case 'i': sys = SatID::systemIRNSS;   break;
+               case 'T': case 't': sys = SatID::systemTransit; break;
+               case 'M': case 'm': sys = SatID::systemMixed;   break;
+            }
+            if (sys != SatID::systemUnknown)
+            {
+               int id = (p[1] == ' ' ? 0 : 10*(p[1] - '0')) + (p[2] - '0');
+               return RinexSatID(id > 0 ? id : -1, sys);
+            }
+         }
+
+            // any other form is left to RinexSatID
+         try
+         {
+            return RinexSatID(string(p, std::min(n, size_t(3))));
+         }
+         catch (Exception& e)
+         {
+            FFStreamError ffse(e);
+            GPSTK_THROW(ffse);
+         }
+      }
+
+         // Rinex3ObsData::parseTime() of the epoch line 'line'
+      CommonTime parseTime(const char* line, const TimeSystem& ts)
+         throw(FFStreamError)
+      {
+         if ( (line[ 1] != ' ') || (line[ 6] != ' ') || (line[ 9] != ' ') ||
+              (line[12] != ' ') || (line[15] != ' ') || (line[18] != ' ') ||
+              (line[29] != ' ') || (line[30] != ' '))
+         {
+            FFStreamError e("Invalid time format");
+            GPSTK_THROW(e);
+         }
+
+            // if there's no time, just return a bad time
+         bool blank(true);
+         for (int i = 2; i < 29 && blank; i++)
+            blank = (line[i] == ' ');
+         if (blank)
+            return CommonTime::BEGINNING_OF_TIME;
+
+         try
+         {
+            int year  = parseInt(line + 2, 4);
+            int month = parseInt(line + 7, 2);
+            int day   = parseInt(line + 10, 2);
+            int hour  = parseInt(line + 13, 2);
+            int min   = parseInt(line + 16, 2);
+            double sec = parseDouble(line + 19, 11);
+
+               // Real Rinex has epochs 'yy mm dd hr 59 60.0' surprisingly
+               // often.
+            double ds = 0;
+            if (sec >= 60.)
+            {
+               ds = sec;
+               sec = 0.0;
+            }
+
+            CommonTime rv =
+               CivilTime(year,month,day,hour,min,sec).convertToCommonTime();
+            if (ds != 0) rv += ds;
+
+            rv.setTimeSystem(ts);
+
+            return rv;
+         }
+         catch (gpstk::Exception& e)
+         {
+            FFStreamError err(e);
+            GPSTK_THROW(err);
+         }
+      }
+
+         // the fields of the epoch line 'line' of 'len' characters
+      void parseEpochLine(const char* line, size_t len, const TimeSystem& ts,
+                          short& epochFlag, CommonTime& time, short& numSVs,
+                          double& clockOffset)
+         throw(FFStreamError)
+      {
+            // Check for epoch marker ('>') and following space.
+         if (len < 32 || line[0] != '>' || line[1] != ' ')
+         {
+            FFStreamError e("Bad epoch line: >" + string(line, len) + "<");
+            GPSTK_THROW(e);
+         }
+
+         epochFlag = parseInt(line + 31, 1);
+         if (epochFlag < 0 || epochFlag > 6)
+         {
+            FFStreamError e("Invalid epoch flag: " +
+                            StringUtils::asString(epochFlag));
+            GPSTK_THROW(e);
+         }
+
+         time = parseTime(line, ts);
+         numSVs = parseInt(line + 32, std::min(len - 32, size_t(3)));
+         if (len > 41)
+            clockOffset = parseDouble(line + 41,
+                                      std::min(len - 41, size_t(15)));
+         else
+            clockOffset = 0.0;
+      }
+   } // anonymous namespace
+
+
+   Rinex3ObsMappedReader ::
+   Rinex3ObsMappedReader(const std::string& fn)
+      throw(FileMissingException, FFStreamError)
+         : file(0), dataStart(0), fileSize(0), pos(0)
+   {
+      strm.open(fn.c_str(), ios::in);
+      if (!strm)
+      {
+         FileMissingException e("Could not open file " + fn);
+         GPSTK_THROW(e);
+      }
+
+      strm >> header;
+      if (!strm)
+      {
+         FFStreamError e(strm.mostRecentException);
+         e.addText("Could not read the header of " + fn);
+         GPSTK_THROW(e);
+      }
+      timesystem = strm.timesystem;
+      dataStart = pos = strm.tellg();
+
+      std::fill(numObs, numObs + 128, 0);
+      for (map<string, vector<RinexObsID> >::const_iterator it =
+              header.mapObsTypes.begin();
+           it != header.mapObsTypes.end(); ++it)
+      {
+         if (it->first.size() == 1)
+            numObs[it->first[0] & 0x7f] = it->second.size();
+      }
+
+         // RINEX 2 records are read by the stream
+      if (header.version < 3)
+      {
+         strm.seekg(0, ios::end);
+         fileSize = strm.tellg();
+         strm.seekg(dataStart);
+         return;
+      }
+
+      strm.close();
+      file = new MappedFile(fn);
+      fileSize = file->size();
+   }
+
+
+   Rinex3ObsMappedReader ::
+   ~Rinex3ObsMappedReader()
+   {
+      delete file;
+   }
+
+
+   bool Rinex3ObsMappedReader ::
+   read(Rinex3ObsData& rod)
+      throw(FFStreamError)
+   {
+      if (file == 0)
+      {
+         strm >> rod;
+         if (strm)
+            return true;
+         if (strm.eof())
+            return false;
+         FFStreamError e(strm.mostRecentException);
+         GPSTK_THROW(e);
+      }
+
+      if (pos >= fileSize)
+         return false;
+
+      size_t start(pos);
+      try
+      {
+         parseRecord(rod);
+      }
+      catch (FFStreamError& e)
+      {
+            // the next read starts again with this record
+         pos = start;
+         e.addText("In file " + file->getFilename() + " at offset " +
+                   StringUtils::asString(start));
+         GPSTK_RETHROW(e);
+      }
+      return true;
+   }
+
+
+   bool Rinex3ObsMappedReader ::
+   skip(CommonTime& time)
+      throw(FFStreamError)
+   {
+      if (file == 0)
+      {
+         if (!read(skipped))
+            return false;
+         time = skipped.time;
+         return true;
+      }
+
+      if (pos >= fileSize)
+         return false;
+
+      size_t start(pos);
+      try
+      {
+         const char* line;
+         size_t len;
+         short epochFlag, numSVs;
+         double clockOffset;
+         nextLine(line, len);
+         parseEpochLine(line, len, timesystem, epochFlag, time, numSVs,
+                        clockOffset);
+         for (int i = 0; i < numSVs; i++)
+         {
+            if (!nextLine(line, len))
+            {
+               FFStreamError e("Unexpected EOF encountered");
+               GPSTK_THROW(e);
+            }
+         }
+      }
+      catch (FFStreamError& e)
+      {
+         pos = start;
+         e.addText("In file " + file->getFilename() + " at offset " +
+                   StringUtils::asString(start));
+         GPSTK_RETHROW(e);
+      }
+      return true;
+   }
+
+
+   size_t Rinex3ObsMappedReader ::
+   getPosition()
+   {
+      if (file == 0)
+         return strm.tellg();
+      return pos;
+   }
+
+
+   void Rinex3ObsMappedReader ::
+   setPosition(size_t p)
+      throw(InvalidRequest)
+   {
+      if (p < dataStart || p > fileSize)
+      {
+         InvalidRequest e("Position " + StringUtils::asString(p) +
+                          " is not in the records of the file");
+         GPSTK_THROW(e);
+      }
+      if (file == 0)
+      {
+         strm.clear();
+         strm.seekg(p);
+      }
+      pos = p;
+   }
+
+
+   bool Rinex3ObsMappedReader ::
+   nextLine(const char*& line, size_t& lineLen)
+      throw()
+   {
+      if (pos >= fileSize)
+         return false;
+
+      line = file->data() + pos;
+      const char* eol = static_cast<const char*>(
+         memchr(line, '\n', fileSize - pos));
+      if (eol == 0)
+      {
+         lineLen = fileSize - pos;
+         pos = fileSize;
+      }
+      else
+      {
+         lineLen = eol - line;
+         pos += lineLen + 1;
+      }
+
+      while (lineLen > 0 &&
+             (line[lineLen-1] == ' ' || line[lineLen-1] == '\r'))
+         lineLen--;
+      return true;
+   }
+
+
+   void Rinex3ObsMappedReader ::
+   parseRecord(Rinex3ObsData& rod)
+      throw(FFStreamError)
+   {
+      const char* line;
+      size_t len;
+
+         // read the first (epoch) line
+      nextLine(line, len);
+      parseEpochLine(line, len, timesystem, rod.epochFlag, rod.time,
+                     rod.numSVs, rod.clockOffset);
+
+         // the auxiliary header records are only kept for their epochs
+      if (rod.auxHeader.valid != 0)
+         rod.auxHeader.clear();
+
+         // Read the observations: SV ID and data
+      if (rod.epochFlag == 0 || rod.epochFlag == 1 || rod.epochFlag == 6)
+      {
+         sats.resize(std::max(rod.numSVs, short(0)));
+         for (int isv = 0; isv < rod.numSVs; isv++)
+         {
+            if (!nextLine(line, len))
+            {
+               FFStreamError e("Unexpected EOF encountered");
+               GPSTK_THROW(e);
+            }
+
+            RinexSatID sat = parseSat(line, len);
+            sats[isv] = sat;
+
+               // the missing observations at the end of the line are
+               // blanks
+            vector<RinexDatum>& data = rod.obs[sat];
+            data.resize(numObs[sat.systemChar() & 0x7f]);
+            for (size_t i = 0; i < data.size(); i++)
+            {
+               size_t col = 3 + 16*i;
+               if (col < len)
+                  parseDatum(line + col, std::min(len - col, size_t(16)),
+                             data[i]);
+               else
+                  parseDatum(line, 0, data[i]);
+            }
+         }
+
+            // remove the satellites of the previous epochs
+         std::sort(sats.begin(), sats.end());
+         Rinex3ObsData::DataMap::iterator it = rod.obs.begin();
+         while (it != rod.obs.end())
+         {
+            if (std::binary_search(sats.begin(), sats.end(), it->first))
+               ++it;
+            else
+               rod.obs.erase(it++);
+         }
+      }
+
+         // ... or the auxiliary header information
+      else
+      {
+         rod.obs.clear();
+         for (int i = 0; i < rod.numSVs; i++)
+         {
+            if (!nextLine(line, len))
+            {
+               FFStreamError e("Unexpected EOF encountered");
+               GPSTK_THROW(e);
+            }
+            string hline(line, len);
+            StringUtils::stripTrailing(hline);
+            try
+            {
+               rod.auxHeader.parseHeaderRecord(hline);
+            }
+            catch (StringUtils::StringException& e)
+            {
+               FFStreamError ffse(e);
+               GPSTK_THROW(ffse);
+            }
+         }
+      }
+   }
+
+} // namespace gpstk
@@ -0,0 +1,170 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file Rinex3ObsMappedReader.hpp
+ * Fast reader of RINEX 3 observation files, parsing a memory-mapped file
+ * in place.
+ */
+
+#ifndef RINEX3OBSMAPPEDREADER_HPP
+#define RINEX3OBSMAPPEDREADER_HPP
+
+#include <string>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsData.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * This class reads the records of a RINEX observation file, like
+       * Rinex3ObsStream, but much faster for the large files.
+       *
+       * The header is read with Rinex3ObsStream. For a RINEX 3 file the
+       * records are then parsed directly from a memory mapping of the
+       * file: the fixed-width fields are decoded in place, without
+       * copying the lines to strings, and the Rinex3ObsData given to
+       * read() is filled in place, so that reading every epoch into the
+       * same object only allocates memory when a new satellite appears.
+       * The result is the same as the one of Rinex3ObsData::getRecord(),
+       * except that lines of non-text data are not rejected.
+       *
+       * RINEX 2 files are read through the stream.
+       *
+       * @code
+       * Rinex3ObsMappedReader reader("site0010.15o");
+       * Rinex3ObsData rod;
+       * while (reader.read(rod))
+       * {
+       *    ...
+       * }
+       * @endcode
+       *
+       * @sa Rinex3ObsStream and Rinex3ObsData.
+       */
+   class Rinex3ObsMappedReader
+   {
+   public:
+         /** Open the file \a fn and read its header.
+          * @throw FileMissingException if the file can't be opened.
+          * @throw FFStreamError if the header is not valid. */
+      Rinex3ObsMappedReader(const std::string& fn)
+         throw(FileMissingException, FFStreamError);
+
+         /// Destructor
+      ~Rinex3ObsMappedReader();
+
+         /// The header of the file.
+      const Rinex3ObsHeader& getHeader() const throw()
+      { return header; }
+
+         /// Time system of the epochs of the file.
+      TimeSystem getTimeSystem() const throw()
+      { return timesystem; }
+
+         /** Read the next record into \a rod.
+          * @return false at the end of the file, true otherwise.
+          * @throw FFStreamError if the record is not valid. */
+      bool read(Rinex3ObsData& rod)
+         throw(FFStreamError);
+
+         /** Skip the next record, only decoding the time of its epoch
+          * line. This is how Rinex3ObsIndex scans a file.
+          * @return false at the end of the file, true otherwise.
+          * @throw FFStreamError if the epoch line is not valid. */
+      bool skip(CommonTime& time)
+         throw(FFStreamError);
+
+         /** Offset in the file of the next record to read. Records can
+          * be read again from any such offset with setPosition(). */
+      size_t getPosition();
+
+         /// Offset in the file of the first record.
+      size_t getDataStart() const throw()
+      { return dataStart; }
+
+         /// Read the next record at offset \a pos.
+      void setPosition(size_t pos)
+         throw(InvalidRequest);
+
+         /// Size of the file, in bytes.
+      size_t size() const throw()
+      { return fileSize; }
+
+   private:
+         /// Parse the record starting at 'pos', which is moved past it.
+      void parseRecord(Rinex3ObsData& rod)
+         throw(FFStreamError);
+
+         /** Bounds of the next line, without its end of line and its
+          * trailing blanks; moves 'pos' to the next line.
+          * @return false at the end of the file. */
+      bool nextLine(const char*& line, size_t& lineLen) throw();
+
+         /// The stream of the header, and of the records of RINEX 2 files.
+      Rinex3ObsStream strm;
+
+         /// The mapping of a RINEX 3 file; 0 for RINEX 2 files.
+      MappedFile* file;
+
+      Rinex3ObsHeader header;
+      TimeSystem timesystem;
+
+      size_t dataStart;
+      size_t fileSize;
+      size_t pos;
+
+         /// Number of observations per satellite, by system character.
+      int numObs[128];
+
+         /// Satellites of the current epoch.
+      std::vector<RinexSatID> sats;
+
+         /// The records skipped in RINEX 2 files.
+      Rinex3ObsData skipped;
+   }; // class Rinex3ObsMappedReader
+
+      //@}
+
+} // namespace gpstk
+
+#endif // RINEX3OBSMAPPEDREADER_HPP
@@ -0,0 +1,291 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file Rinex3ObsParallelReader.cpp
+ * Reader of RINEX observation files decoding the epochs on several
+ * threads.
+ */
+
+#include <algorithm>
+
+#include "Rinex3ObsParallelReader.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   namespace
+   {
+         // move the record 'from' to 'to', without copying its data
+      void takeRecord(Rinex3ObsData& from, Rinex3ObsData& to)
+      {
+         to.time = from.time;
+         to.epochFlag = from.epochFlag;
+         to.numSVs = from.numSVs;
+         to.clockOffset = from.clockOffset;
+         to.obs.swap(from.obs);
+         if (from.auxHeader.valid != 0 || to.auxHeader.valid != 0)
+            to.auxHeader = from.auxHeader;
+      }
+   }
+
+
+   Rinex3ObsParallelReader ::
+   Rinex3ObsParallelReader(const std::string& fn, unsigned numThreads,
+                           bool useSidecar)
+      throw(FileMissingException, FFStreamError)
+         : tail(fn), first(0), last(0), chunkSize(64), numChunks(0),
+           nextChunk(0), readChunk(0), stopping(false), nextRecord(0),
+           started(false), inTail(false), failed(false),
+           errorPending(false), windowSet(false)
+   {
+      if (useSidecar)
+         index.open(fn);
+      else
+         index.build(fn);
+      last = index.size();
+
+      if (numThreads == 0)
+         numThreads = std::thread::hardware_concurrency();
+      if (numThreads == 0)
+         numThreads = 1;
+      for (unsigned i = 0; i < numThreads; i++)
+         readers.push_back(
+            std::unique_ptr<Rinex3ObsMappedReader>(
+               new Rinex3ObsMappedReader(fn)));
+   }
+
+
+   Rinex3ObsParallelReader ::
+   ~Rinex3ObsParallelReader()
+   {
+      stop();
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   setWindow(const CommonTime& begin, const CommonTime& end)
+      throw(InvalidRequest)
+   {
+      if (started)
+      {
+         InvalidRequest e("The reading has started");
+         GPSTK_THROW(e);
+      }
+      first = index.lowerBound(begin);
+      last = std::max(first, index.upperBound(end));
+      windowSet = true;
+      windowBegin = begin;
+      windowEnd = end;
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   setChunkSize(size_t n)
+      throw(InvalidRequest)
+   {
+      if (started || n == 0)
+      {
+         InvalidRequest e("Invalid chunk size, or the reading has started");
+         GPSTK_THROW(e);
+      }
+      chunkSize = n;
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   start()
+   {
+      started = true;
+      numChunks = (last - first + chunkSize - 1) / chunkSize;
+      size_t n = std::min(readers.size(), numChunks);
+      slots.resize(4 * std::max(n, size_t(1)));
+      for (unsigned i = 0; i < n; i++)
+         workers.push_back(std::thread(&Rinex3ObsParallelReader::work,
+                                       this, i));
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   stop()
+   {
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         stopping = true;
+      }
+      cond.notify_all();
+      for (size_t i = 0; i < workers.size(); i++)
+         workers[i].join();
+      workers.clear();
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   work(unsigned id)
+   {
+      Rinex3ObsMappedReader& reader = *readers[id];
+      for (;;)
+      {
+         size_t c;
+         {
+            std::unique_lock<std::mutex> lock(mutex);
+               // at most slots.size() chunks ahead of the one delivered
+            while (!stopping && nextChunk < numChunks &&
+                   nextChunk >= readChunk + slots.size())
+               cond.wait(lock);
+            if (stopping || nextChunk >= numChunks)
+               return;
+            c = nextChunk++;
+         }
+
+         Chunk chunk;
+         size_t b = first + c*chunkSize;
+         size_t e = std::min(b + chunkSize, last);
+         chunk.records.resize(e - b);
+         size_t n(0);
+         try
+         {
+            reader.setPosition(index[b].offset);
+            while (n < chunk.records.size() && reader.read(chunk.records[n]))
+               n++;
+         }
+         catch (Exception& err)
+         {
+            chunk.failed = true;
+            chunk.error = FFStreamError(err);
+         }
+         chunk.records.resize(n);
+
+         {
+            std::lock_guard<std::mutex> lock(mutex);
+            Chunk& slot = slots[c % slots.size()];
+            slot.records.swap(chunk.records);
+            slot.failed = chunk.failed;
+            slot.error = chunk.error;
+            slot.done = true;
+         }
+         cond.notify_all();
+      }
+   }
+
+
+   bool Rinex3ObsParallelReader ::
+   read(Rinex3ObsData& rod)
+      throw(FFStreamError)
+   {
+      if (failed)
+         GPSTK_THROW(error);
+      if (!started)
+         start();
+
+      for (;;)
+      {
+         if (nextRecord < records.size())
+         {
+            takeRecord(records[nextRecord++], rod);
+            return true;
+         }
+
+            // the error of a chunk comes after its good records
+         if (errorPending)
+         {
+            failed = true;
+            GPSTK_THROW(error);
+         }
+
+         if (inTail)
+            break;
+
+         if (readChunk >= numChunks)
+         {
+               // the records after the end of the index, if any, are
+               // read one by one
+            if (last < index.size() ||
+                index.getEndOffset() >= index.getFileSize())
+               return false;
+            tail.setPosition(index.getEndOffset());
+            inTail = true;
+            break;
+         }
+
+         {
+            std::unique_lock<std::mutex> lock(mutex);
+            Chunk& slot = slots[readChunk % slots.size()];
+            while (!slot.done)
+               cond.wait(lock);
+            records.swap(slot.records);
+            slot.records.clear();
+            slot.done = false;
+            errorPending = slot.failed;
+            error = slot.error;
+            readChunk++;
+         }
+         cond.notify_all();
+         nextRecord = 0;
+      }
+
+      try
+      {
+         while (tail.read(rod))
+         {
+            if (!windowSet || rod.time == CommonTime::BEGINNING_OF_TIME)
+               return true;
+            if (rod.time > windowEnd)
+               break;
+            if (rod.time >= windowBegin)
+               return true;
+         }
+      }
+      catch (FFStreamError& e)
+      {
+         failed = true;
+         error = e;
+         GPSTK_RETHROW(e);
+      }
+      return false;
+   }
+
+
+   Rinex3ObsParallelReader::iterator Rinex3ObsParallelReader ::
+   begin()
+   {
+      if (!read(current))
+         return end();
+      return iterator(this);
+   }
+
+} // namespace gpstk
@@ -0,0 +1,231 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file Rinex3ObsParallelReader.hpp
+ * Reader of RINEX observation files decoding the epochs on several
+ * threads.
+ */
+
+#ifndef RINEX3OBSPARALLELREADER_HPP
+#define RINEX3OBSPARALLELREADER_HPP
+
+#include <condition_variable>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Rinex3ObsIndex.hpp"
+#include "Rinex3ObsMappedReader.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * This class reads the records of a RINEX observation file in
+       * order, like Rinex3ObsMappedReader, but decodes them ahead on
+       * worker threads.
+       *
+       * The file is indexed first (see Rinex3ObsIndex), then the epochs
+       * are split in chunks of consecutive records, each one decoded by
+       * a worker with its own Rinex3ObsMappedReader. The chunks are
+       * delivered in the order of the file; the number of chunks
+       * decoded ahead is bounded, so the memory used doesn't depend on
+       * the size of the file. A record that is not valid is reported
+       * by read() when its turn comes, after all the records before it.
+       *
+       * @code
+       * Rinex3ObsParallelReader reader("site0010.15o");
+       * reader.setWindow(start, stop);
+       * for (Rinex3ObsParallelReader::iterator it = reader.begin();
+       *      it != reader.end(); ++it)
+       * {
+       *    const Rinex3ObsData& rod = *it;
+       *    ...
+       * }
+       * @endcode
+       */
+   class Rinex3ObsParallelReader
+   {
+   public:
+         /** Open and index the file \a fn.
+          * @param[in] fn the RINEX file to read
+          * @param[in] numThreads number of worker threads, 0 for one per
+          *   hardware thread
+          * @param[in] useSidecar load the index from its sidecar file,
+          *   or save it there, see Rinex3ObsIndex::open()
+          * @throw FileMissingException if the file can't be opened.
+          * @throw FFStreamError if the header is not valid. */
+      Rinex3ObsParallelReader(const std::string& fn,
+                              unsigned numThreads = 0,
+                              bool useSidecar = true)
+         throw(FileMissingException, FFStreamError);
+
+         /// Stop the workers.
+      ~Rinex3ObsParallelReader();
+
+         /// The header of the file.
+      const Rinex3ObsHeader& getHeader() const throw()
+      { return tail.getHeader(); }
+
+         /// The index of the file.
+      const Rinex3ObsIndex& getIndex() const throw()
+      { return index; }
+
+         /** Only read the epochs from \a begin to \a end, included.
+          * Both are found in the index, without reading the file.
+          * @throw InvalidRequest if the reading has started. */
+      void setWindow(const CommonTime& begin, const CommonTime& end)
+         throw(InvalidRequest);
+
+         /** Set the number of epochs decoded by a worker at once.
+          * @throw InvalidRequest if the reading has started. */
+      void setChunkSize(size_t n)
+         throw(InvalidRequest);
+
+         /** Read the next record into \a rod.
+          * @return false at the end of the file or of the window.
+          * @throw FFStreamError if the record is not valid. */
+      bool read(Rinex3ObsData& rod)
+         throw(FFStreamError);
+
+         /// Input iterator over the records, see begin().
+      class iterator
+         : public std::iterator<std::input_iterator_tag, Rinex3ObsData>
+      {
+      public:
+         iterator() : reader(0) {}
+         const Rinex3ObsData& operator*() const
+         { return reader->current; }
+         const Rinex3ObsData* operator->() const
+         { return &reader->current; }
+            /// @throw FFStreamError if the next record is not valid.
+         iterator& operator++()
+         { if (!reader->read(reader->current)) reader = 0; return *this; }
+         bool operator==(const iterator& right) const
+         { return reader == right.reader; }
+         bool operator!=(const iterator& right) const
+         { return reader != right.reader; }
+      private:
+         friend class Rinex3ObsParallelReader;
+         explicit iterator(Rinex3ObsParallelReader* r) : reader(r) {}
+         Rinex3ObsParallelReader* reader;
+      };
+
+         /** Iterator on the first record. The records are read by the
+          * iterators, and can only be iterated once.
+          * @throw FFStreamError if the first record is not valid. */
+      iterator begin();
+
+         /// Iterator past the last record.
+      iterator end()
+      { return iterator(); }
+
+   private:
+         /// Records decoded by a worker.
+      struct Chunk
+      {
+         Chunk() : done(false), failed(false) {}
+         std::vector<Rinex3ObsData> records;
+         bool done;
+         bool failed;
+         FFStreamError error;
+      };
+
+         /// Start the workers.
+      void start();
+
+         /// Stop and join the workers.
+      void stop();
+
+         /// Decode the chunks, with the reader 'id'.
+      void work(unsigned id);
+
+      Rinex3ObsIndex index;
+
+         /** Reader of the records that the index doesn't cover, and of
+          * the header. */
+      Rinex3ObsMappedReader tail;
+
+      std::vector<std::unique_ptr<Rinex3ObsMappedReader> > readers;
+      std::vector<std::thread> workers;
+
+         /// Index entries to read, [first, last)
+      size_t first, last;
+      size_t chunkSize;
+      size_t numChunks;
+
+         /// Chunks in flight, chunk i in slot i % slots.size()
+      std::vector<Chunk> slots;
+
+      std::mutex mutex;
+      std::condition_variable cond;
+         /// Next chunk to decode
+      size_t nextChunk;
+         /// Chunk being delivered
+      size_t readChunk;
+      bool stopping;
+
+         /// Records of the chunk being delivered, and the next one.
+      std::vector<Rinex3ObsData> records;
+      size_t nextRecord;
+
+      bool started;
+         /// True once the tail reader is used.
+      bool inTail;
+         /// Set once a record has failed; thrown by every later read().
+      bool failed;
+         /// True if 'records' is followed by the failed record 'error'.
+      bool errorPending;
+      FFStreamError error;
+
+      bool windowSet;
+      CommonTime windowBegin, windowEnd;
+
+         /// The record of the iterators.
+      Rinex3ObsData current;
+   }; // class Rinex3ObsParallelReader
+
+      //@}
+
+} // namespace gpstk
+
+#endif // RINEX3OBSPARALLELREADER_HPP
@@ -52,6 +52,8 @@
 
 namespace gpstk
 {
+   class Rinex3ObsData;
+
       /// @ingroup FileHandling
       //@{
 
@@ -113,6 +115,20 @@ namespace gpstk
          /// Check if the input stream is the kind of Rinex3ObsStream
       static bool isRinex3ObsStream(std::istream& i);
 
+         /** Read the next record into \a rod, for the streams whose
+          * records are not RINEX text (see Rinex3ObsCacheStream).
+          * Called by Rinex3ObsData once the header is read.
+          * @return false to parse the record as RINEX text.
+          * @throw EndOfFile at the end of the records. */
+      virtual bool getObsData(Rinex3ObsData& rod)
+      { return false; }
+
+         /** Write \a rod, for the streams whose records are not RINEX
+          * text; see getObsData().
+          * @return false to write the record as RINEX text. */
+      virtual bool putObsData(const Rinex3ObsData& rod)
+      { return false; }
+
    private:
          /// Initialize internal data structures.
       void init();
@@ -77,51 +77,80 @@ namespace gpstk
          ClockRecord rec;
          DataTableIterator it1, it2, kt;        // cf. TabularSatStore.hpp
 
-         isExact = getTableInterval(sat, ttag, Nhalf, it1, it2, haveClockDrift);
-         if(isExact && haveClockDrift) {
-            rec = it1->second;
-            return rec;
-         }
-
-         // pull data out of the data table
          size_t n,Nlow(Nhalf-1),Nhi(Nhalf),Nmatch(Nhalf);
-         CommonTime ttag0(it1->first);
-         vector<double> times,biases,drifts,accels,sig_biases,sig_drifts,sig_accels;
+         vector<double> times, buff[6];         // hold unfrozen data
+         const double *T,*biases,*drifts,*accels,*sig_biases,*sig_drifts,*sig_accels;
+         double dt;                             // time, in the units of T
+
+         if(frozen) {
+            size_t i1, i2, k;
+            isExact = getFrozenInterval(sat, ttag, Nhalf, i1, i2, haveClockDrift);
+            if(isExact && haveClockDrift)
+               return thawRecord(i1);
+
+            // point into the frozen columns
+            dt = frozenOffset(ttag);
+            n = i2-i1+1;
+            T = &frozenEpoch[i1];                            // sec
+            for(k=0; k<n; k++) {
+               if(isExact && ABS(T[k] - dt) < 1.e-8)
+                  Nmatch = k;
+            }
+            biases = &colBias[i1];        sig_biases = &colSigBias[i1];
+            drifts = &colDrift[i1];       sig_drifts = &colSigDrift[i1];
+            accels = &colAccel[i1];       sig_accels = &colSigAccel[i1];
+         }
+         else {
+            isExact = getTableInterval(sat, ttag, Nhalf, it1, it2, haveClockDrift);
+            if(isExact && haveClockDrift) {
+               rec = it1->second;
+               return rec;
+            }
 
-         kt=it1; n=0;
-         while(1) {
-            // find index of matching time tag
-            if(isExact && ABS(kt->first-ttag) < 1.e-8) Nmatch = n;
-            times.push_back(kt->first - ttag0);    // sec
-            biases.push_back(kt->second.bias);     // sec
-            drifts.push_back(kt->second.drift);    // sec/sec
-            accels.push_back(kt->second.accel);    // sec/sec^2
-            sig_biases.push_back(kt->second.sig_bias);     // sec
-            sig_drifts.push_back(kt->second.sig_drift);    // sec/sec
-            sig_accels.push_back(kt->second.sig_accel);    // sec/sec^2
-            if(kt == it2) break;
-            ++kt;
-            ++n;
-         };
+            // pull data out of the data table
+            CommonTime ttag0(it1->first);
+            dt = ttag - ttag0;
+
+            kt=it1; n=0;
+            while(1) {
+               // find index of matching time tag
+               if(isExact && ABS(kt->first-ttag) < 1.e-8) Nmatch = n;
+               times.push_back(kt->first - ttag0);    // sec
+               buff[0].push_back(kt->second.bias);     // sec
+               buff[1].push_back(kt->second.drift);    // sec/sec
+               buff[2].push_back(kt->second.accel);    // sec/sec^2
+               buff[3].push_back(kt->second.sig_bias);     // sec
+               buff[4].push_back(kt->second.sig_drift);    // sec/sec
+               buff[5].push_back(kt->second.sig_accel);    // sec/sec^2
+               if(kt == it2) break;
+               ++kt;
+               ++n;
+            };
+            n = times.size();
+            T = &times[0];
+            biases = &buff[0][0];         sig_biases = &buff[3][0];
+            drifts = &buff[1][0];         sig_drifts = &buff[4][0];
+            accels = &buff[2][0];         sig_accels = &buff[5][0];
+         }
 
          if(isExact && Nmatch == (int)(Nhalf-1)) { Nlow++; Nhi++; }
 
          // interpolate
          rec.accel = rec.sig_accel = 0.0;              // defaults
-         double dt(ttag-ttag0), err, slope;
+         double err, slope;
          if(haveClockDrift) {
             if(interpType == 2) {
                // Lagrange interpolation
-               rec.bias = LagrangeInterpolation(times,biases,dt,err);      // sec
-               rec.drift = LagrangeInterpolation(times,drifts,dt,err);     // sec/sec
+               rec.bias = LagrangeInterpolation(T,biases,n,dt,err);      // sec
+               rec.drift = LagrangeInterpolation(T,drifts,n,dt,err);     // sec/sec
             }
             else {
                // linear interpolation
                slope = (biases[Nhi]-biases[Nlow]) /
-                                   (times[Nhi]-times[Nlow]);               // sec/sec
-               rec.bias = biases[Nlow] + slope*(dt-times[Nlow]);           // sec
-               slope = (drifts[Nhi]-drifts[Nlow])/(times[Nhi]-times[Nlow]);
-               rec.drift = drifts[Nlow] + slope*(dt-times[Nlow]);          // sec/sec
+                                   (T[Nhi]-T[Nlow]);               // sec/sec
+               rec.bias = biases[Nlow] + slope*(dt-T[Nlow]);           // sec
+               slope = (drifts[Nhi]-drifts[Nlow])/(T[Nhi]-T[Nlow]);
+               rec.drift = drifts[Nlow] + slope*(dt-T[Nlow]);          // sec/sec
             }
 
             // sigmas
@@ -134,13 +163,13 @@ namespace gpstk
          else {                              // must interpolate biases to get drift
             if(interpType == 2) {
                // Lagrange interpolation
-               LagrangeInterpolation(times,biases,dt,rec.bias,rec.drift);
+               LagrangeInterpolation(T,biases,n,dt,rec.bias,rec.drift);
             }
             else {
                // linear interpolation
                rec.drift = (biases[Nhi]-biases[Nlow]) /
-                                   (times[Nhi]-times[Nlow]);            // sec/sec^2
-               rec.bias = biases[Nlow] + (dt-times[Nlow])*rec.drift;    // sec/sec
+                                   (T[Nhi]-T[Nlow]);            // sec/sec^2
+               rec.bias = biases[Nlow] + (dt-T[Nlow])*rec.drift;    // sec/sec
             }
 
             // sigmas
@@ -149,19 +178,19 @@ namespace gpstk
             else
                rec.sig_bias = RSS(sig_biases[Nhi],sig_biases[Nlow]);
             // TD ?
-            rec.sig_drift = rec.sig_bias/(times[Nhi]-times[Nlow]);
+            rec.sig_drift = rec.sig_bias/(T[Nhi]-T[Nlow]);
          }
 
          if(haveClockAccel) {
             if(interpType == 2) {
                // Lagrange interpolation
-               rec.accel = LagrangeInterpolation(times,accels,dt,err);  // sec/sec^2
+               rec.accel = LagrangeInterpolation(T,accels,n,dt,err);  // sec/sec^2
             }
             else {
                // linear interpolation
                slope = (drifts[Nhi]-drifts[Nlow]) /
-                                   (times[Nhi]-times[Nlow]);            // sec/sec^2
-               rec.accel = accels[Nlow] + slope*(dt-times[Nlow]);       // sec/sec^2
+                                   (T[Nhi]-T[Nlow]);            // sec/sec^2
+               rec.accel = accels[Nlow] + slope*(dt-T[Nlow]);       // sec/sec^2
             }
 
             // sigma
@@ -173,15 +202,15 @@ namespace gpstk
          else if(haveClockDrift) {              // must interpolate drift to get accel
             if(interpType == 2) {
                // Lagrange interpolation  (err is a dummy here)
-               LagrangeInterpolation(times,drifts,dt,err,rec.accel);
+               LagrangeInterpolation(T,drifts,n,dt,err,rec.accel);
             }
             else {
                // linear interpolation                                  // sec/sec^2
-               rec.accel = (drifts[Nhi]-drifts[Nlow]) / (times[Nhi]-times[Nlow]);
+               rec.accel = (drifts[Nhi]-drifts[Nlow]) / (T[Nhi]-T[Nlow]);
             }
 
             // sigmas  TD is there a better way?
-            rec.sig_accel = rec.sig_drift/(times[Nhi]-times[Nlow]);
+            rec.sig_accel = rec.sig_drift/(T[Nhi]-T[Nlow]);
          }
          // else zero
 
@@ -204,6 +233,22 @@ namespace gpstk
       try {
          checkTimeSystem(ttag.getTimeSystem());
 
+         if(frozen) {
+            size_t i1, i2;
+            if(getFrozenInterval(sat, ttag, Nhalf, i1, i2, true))
+               return colBias[i1];
+
+            // interpolate the frozen column in place
+            const double *T(&frozenEpoch[i1]), *biases(&colBias[i1]);
+            double dt(frozenOffset(ttag)), err, slope;
+            if(interpType == 2)                    // Lagrange interpolation
+               return LagrangeInterpolation(T, biases, i2-i1+1, dt, err); // sec
+
+            // linear interpolation
+            slope = (biases[Nhalf]-biases[Nhalf-1])/(T[Nhalf]-T[Nhalf-1]);
+            return biases[Nhalf-1] + slope*(dt-T[Nhalf-1]);          // sec
+         }
+
          DataTableIterator it1, it2, kt;
          if(getTableInterval(sat, ttag, Nhalf, it1, it2, true)) {
             // exact match
@@ -253,6 +298,8 @@ namespace gpstk
       try {
          checkTimeSystem(ttag.getTimeSystem());
 
+         if(frozen) return getValue(sat,ttag).drift;
+
          DataTableIterator it1, it2, kt;
          bool isExact(getTableInterval(sat, ttag, Nhalf, it1, it2, haveClockDrift));
          if(isExact && haveClockDrift) {
@@ -317,6 +364,7 @@ namespace gpstk
       throw(InvalidRequest)
    {
       try {
+         checkNotFrozen();
          checkTimeSystem(ttag.getTimeSystem());
 
          if(rec.drift != 0.0) haveClockDrift = true;
@@ -349,6 +397,7 @@ namespace gpstk
       throw(InvalidRequest)
    {
       try {
+         checkNotFrozen();
          checkTimeSystem(ttag.getTimeSystem());
 
          if(tables.find(sat) != tables.end() &&
@@ -377,6 +426,7 @@ namespace gpstk
       throw(InvalidRequest)
    {
       try {
+         checkNotFrozen();
          checkTimeSystem(ttag.getTimeSystem());
 
          haveClockDrift = true;
@@ -407,6 +457,7 @@ namespace gpstk
       throw(InvalidRequest)
    {
       try {
+         checkNotFrozen();
          checkTimeSystem(ttag.getTimeSystem());
 
          haveClockAccel = true;
@@ -431,4 +482,44 @@ namespace gpstk
       catch(InvalidRequest& ir) { GPSTK_RETHROW(ir); }
    }
 
+   // Append a record to the frozen columns
+   void ClockSatStore::freezeRecord(const ClockRecord& rec) throw()
+   {
+      colBias.push_back(rec.bias);
+      colSigBias.push_back(rec.sig_bias);
+      colDrift.push_back(rec.drift);
+      colSigDrift.push_back(rec.sig_drift);
+      colAccel.push_back(rec.accel);
+      colSigAccel.push_back(rec.sig_accel);
+   }
+
+   // Rebuild record i from the frozen columns
+   ClockRecord ClockSatStore::thawRecord(size_t i) const throw()
+   {
+      ClockRecord rec;
+      rec.bias = colBias[i];
+      rec.sig_bias = colSigBias[i];
+      rec.drift = colDrift[i];
+      rec.sig_drift = colSigDrift[i];
+      rec.accel = colAccel[i];
+      rec.sig_accel = colSigAccel[i];
+      return rec;
+   }
+
+   // Reserve room for n records in the frozen columns
+   void ClockSatStore::reserveFrozenRecords(size_t n) throw()
+   {
+      colBias.reserve(n); colSigBias.reserve(n);
+      colDrift.reserve(n); colSigDrift.reserve(n);
+      colAccel.reserve(n); colSigAccel.reserve(n);
+   }
+
+   // Remove all records from the frozen columns
+   void ClockSatStore::clearFrozenRecords() throw()
+   {
+      vector<double>().swap(colBias); vector<double>().swap(colSigBias);
+      vector<double>().swap(colDrift); vector<double>().swap(colSigDrift);
+      vector<double>().swap(colAccel); vector<double>().swap(colSigAccel);
+   }
+
 }  // End of namespace gpstk
@@ -45,6 +45,7 @@
 #define GPSTK_CLOCK_SAT_STORE_INCLUDE
 
 #include <map>
+#include <vector>
 #include <iostream>
 
 #include "Exception.hpp"
@@ -119,6 +120,24 @@ namespace gpstk
          /// Flag to reject bad clock data; default true
       bool rejectBadClockFlag;
 
+         /** Columns of the frozen tables (see TabularSatStore::freeze()),
+          * indexed as TabularSatStore::frozenSec. */
+      std::vector<double> colBias, colSigBias;
+      std::vector<double> colDrift, colSigDrift;
+      std::vector<double> colAccel, colSigAccel;
+
+         /// Append a record to the frozen columns
+      virtual void freezeRecord(const ClockRecord& rec) throw();
+
+         /// Rebuild record i from the frozen columns
+      virtual ClockRecord thawRecord(std::size_t i) const throw();
+
+         /// Reserve room for n records in the frozen columns
+      virtual void reserveFrozenRecords(std::size_t n) throw();
+
+         /// Remove all records from the frozen columns
+      virtual void clearFrozenRecords() throw();
+
          // member functions
    public:
 
@@ -95,6 +95,45 @@ namespace gpstk
             // We are done, let's return
          return sv;
 
+      }
+
+         // If enabled, continue from the states already integrated for
+         // this ephemeris instead of starting again from 'ephTime'
+      if ( useCache )
+      {
+
+         PZ90Ellipsoid pz90;
+         double we( pz90.angVelocity() );
+
+         double dt( epoch - ephTime );
+         double state[6];
+         double s0, sod;
+         {
+            std::lock_guard<std::mutex> lock( cacheMutex.m );
+            cachedState( dt, state );
+            s0 = cacheS0;
+            sod = cacheSod;
+         }
+
+            // Rotate back from the absolute coordinate system to PZ-90
+         double s( s0 + we*( sod + dt ) );
+         double cs( std::cos(s) );
+         double ss( std::sin(s) );
+
+         sv.x[0] = 1000.0*( state[0]*cs + state[2]*ss );   // X coordinate
+         sv.x[1] = 1000.0*(-state[0]*ss + state[2]*cs );   // Y coordinate
+         sv.x[2] = 1000.0*state[4];                        // Z coordinate
+         sv.v[0] = 1000.0*( state[1]*cs + state[3]*ss + we*(sv.x[1]/1000.0) );
+         sv.v[1] = 1000.0*(-state[1]*ss + state[3]*cs - we*(sv.x[0]/1000.0) );
+         sv.v[2] = 1000.0*state[5];
+
+         sv.relcorr = sv.computeRelativityCorrection();
+         sv.clkbias = clkbias + clkdrift * dt - sv.relcorr;
+         sv.clkdrift = clkdrift;
+         sv.frame = ReferenceFrame::PZ90;
+
+         return sv;
+
       }
 
          // Get the data out of the GloRecord structure
@@ -397,6 +436,9 @@ namespace gpstk
 
       step = rkStep;
 
+         // Previously integrated states belong to the old data
+      clearPropagationCache();
+
          // Set this object as valid
       valid = true;
 
@@ -444,19 +486,39 @@ namespace gpstk
       const
    {
 
+      double in[6], acc[3], out[6];
+      for( int j = 0; j < 6; ++j )
+         in[j] = inState(j);
+      for( int j = 0; j < 3; ++j )
+         acc[j] = accel(j);
+
+      derivative( in, acc, out );
+
+      Vector<double> dxt(6, 0.0);
+      for( int j = 0; j < 6; ++j )
+         dxt(j) = out[j];
+
+      return dxt;
+
+   }  // End of method 'GloEphemeris::derivative()'
+
+
+      // Allocation-free version of derivative().
+   void GloEphemeris::derivative( const double* inState,
+                                  const double* accel,
+                                  double* dxt ) const
+   {
+
          // We will need some important PZ90 ellipsoid values
       PZ90Ellipsoid pz90;
       const double j20( pz90.j20() );
       const double mu( pz90.gm_km() );
       const double ae( pz90.a_km() );
 
-         // Let's start getting the current satellite position and velocity
-      double  x( inState(0) );          // X coordinate
-      //double vx( inState(1) );          // X velocity
-      double  y( inState(2) );          // Y coordinate
-      //double vy( inState(3) );          // Y velocity
-      double  z( inState(4) );          // Z coordinate
-      //double vz( inState(5) );          // Z velocity
+         // Let's start getting the current satellite position
+      double  x( inState[0] );          // X coordinate
+      double  y( inState[2] );          // Y coordinate
+      double  z( inState[4] );          // Z coordinate
 
       double r2( x*x + y*y + z*z );
       double r( std::sqrt(r2) );
@@ -471,27 +533,225 @@ namespace gpstk
       double cmz( k1*(3.0-5.0*zr2) );
       double k2(cm-xmu);
 
-      double gloAx( k2*xr + accel(0) );
-      double gloAy( k2*yr + accel(1) );
-      double gloAz( (cmz-xmu)*zr + accel(2) );
+      dxt[0] = inState[1];                      // Set X'  = Vx
+      dxt[1] = k2*xr + accel[0];                // Set Vx' = gloAx
+      dxt[2] = inState[3];                      // Set Y'  = Vy
+      dxt[3] = k2*yr + accel[1];                // Set Vy' = gloAy
+      dxt[4] = inState[5];                      // Set Z'  = Vz
+      dxt[5] = (cmz-xmu)*zr + accel[2];         // Set Vz' = gloAz
 
-      Vector<double> dxt(6, 0.0);
+   }  // End of method 'GloEphemeris::derivative()'
 
-         // Let's insert data related to X coordinates
-      dxt(0) = inState(1);       // Set X'  = Vx
-      dxt(1) = gloAx;            // Set Vx' = gloAx
 
-         // Let's insert data related to Y coordinates
-      dxt(2) = inState(3);       // Set Y'  = Vy
-      dxt(3) = gloAy;            // Set Vy' = gloAy
+      // Number of integration steps between stored checkpoints.
+   const long GloEphemeris::checkpointSteps = 60;
 
-         // Let's insert data related to Z coordinates
-      dxt(4) = inState(5);       // Set Z'  = Vz
-      dxt(5) = gloAz;            // Set Vz' = gloAz
 
-      return dxt;
+      // Compute luni-solar accelerations in the absolute frame.
+   void GloEphemeris::absAccel( double tod, double* accel ) const
+   {
 
-   }  // End of method 'GloEphemeris::derivative()'
+      PZ90Ellipsoid pz90;
+      double s( cacheS0 + pz90.angVelocity()*tod );
+      double cs( std::cos(s) );
+      double ss( std::sin(s) );
+
+      accel[0] = a[0]*cs - a[1]*ss;
+      accel[1] = a[0]*ss + a[1]*cs;
+      accel[2] = a[2];
+
+   }  // End of method 'GloEphemeris::absAccel()'
+
+
+      // Perform a single Runge-Kutta step of size 'h'.
+   void GloEphemeris::rkStep( const PropNode& in,
+                              double h,
+                              double tEnd,
+                              PropNode& out ) const
+   {
+
+         // As in svXvtOverrideFit(), accelerations are computed once per
+         // step, at the end of the step
+      double accel[3], dxt1[6], dxt2[6], dxt3[6], dxt4[6], tempRes[6];
+      absAccel( tEnd, accel );
+
+      derivative( in.state, accel, dxt1 );
+      for( int j = 0; j < 6; ++j )
+         tempRes[j] = in.state[j] + h*dxt1[j]/2.0;
+
+      derivative( tempRes, accel, dxt2 );
+      for( int j = 0; j < 6; ++j )
+         tempRes[j] = in.state[j] + h*dxt2[j]/2.0;
+
+      derivative( tempRes, accel, dxt3 );
+      for( int j = 0; j < 6; ++j )
+         tempRes[j] = in.state[j] + h*dxt3[j];
+
+      derivative( tempRes, accel, dxt4 );
+      for( int j = 0; j < 6; ++j )
+         out.state[j] = in.state[j] + h * ( dxt1[j]
+                      + 2.0 * ( dxt2[j] + dxt3[j] ) + dxt4[j] ) / 6.0;
+
+         // Keep the derivative at the node for the dense output
+      derivative( out.state, accel, out.deriv );
+
+   }  // End of method 'GloEphemeris::rkStep()'
+
+
+      // Return the integrated state at step 'k' in the given direction.
+   const GloEphemeris::PropNode& GloEphemeris::getNode( PropCache& cache,
+                                                        long k,
+                                                        double h ) const
+   {
+
+      if ( k == 0 )
+         return cache.checkpoints[0];
+
+         // Do we have it from the last step?
+      if ( cache.loIdx == k )
+         return cache.lo;
+
+      if ( cache.loIdx + 1 == k )
+         return cache.hi;
+
+         // Start from the nearest checkpoint before 'k', or from the end of
+         // the last step, whatever is closer
+      long cpIdx( k / checkpointSteps );
+      if ( cpIdx >= static_cast<long>(cache.checkpoints.size()) )
+         cpIdx = static_cast<long>(cache.checkpoints.size()) - 1;
+
+      long idx( cpIdx * checkpointSteps );
+      if ( idx == k )
+         return cache.checkpoints[cpIdx];
+
+      PropNode current( cache.checkpoints[cpIdx] );
+
+      if ( cache.loIdx >= 0 && (cache.loIdx + 1) < k &&
+           (cache.loIdx + 1) > idx )
+      {
+         idx = cache.loIdx + 1;
+         current = cache.hi;
+      }
+
+      PropNode next;
+      while ( idx < k )
+      {
+
+         rkStep( current, h, cacheSod + (idx+1)*h, next );
+         ++idx;
+
+            // Store a new checkpoint if we just reached one
+         if ( (idx % checkpointSteps) == 0 &&
+              (idx / checkpointSteps) ==
+                  static_cast<long>(cache.checkpoints.size()) )
+         {
+            cache.checkpoints.push_back(next);
+         }
+
+         if ( idx == k )
+         {
+            cache.lo = current;
+            cache.hi = next;
+            cache.loIdx = k - 1;
+         }
+
+         current = next;
+
+      }  // End of 'while ( idx < k )'
+
+      return cache.hi;
+
+   }  // End of method 'GloEphemeris::getNode()'
+
+
+      // Compute satellite state (absolute frame) through the cache.
+   void GloEphemeris::cachedState( double dt, double* state ) const
+   {
+
+         // Set up the reference node the first time we are called
+      if ( !cacheReady )
+      {
+
+         PZ90Ellipsoid pz90;
+         double we( pz90.angVelocity() );
+
+         cacheS0 = getSidTime( ephTime )*PI/12.0;
+         YDSTime ytime( ephTime );
+         cacheSod = ytime.sod;
+
+         double s( cacheS0 + we*cacheSod );
+         double cs( std::cos(s) );
+         double ss( std::sin(s) );
+
+            // Rotate from PZ-90 to an absolute coordinate system, exactly as
+            // svXvtOverrideFit() does
+         PropNode node0;
+         node0.state[0] = x[0]*cs - x[1]*ss;
+         node0.state[2] = x[0]*ss + x[1]*cs;
+         node0.state[4] = x[2];
+         node0.state[1] = v[0]*cs - v[1]*ss - we*node0.state[2];
+         node0.state[3] = v[0]*ss + v[1]*cs + we*node0.state[0];
+         node0.state[5] = v[2];
+
+         double accel[3];
+         absAccel( cacheSod, accel );
+         derivative( node0.state, accel, node0.deriv );
+
+         fwdCache = PropCache();
+         bwdCache = PropCache();
+         fwdCache.checkpoints.push_back(node0);
+         bwdCache.checkpoints.push_back(node0);
+
+         cacheReady = true;
+
+      }  // End of 'if ( !cacheReady )'
+
+      double h( step );
+      PropCache* cache( &fwdCache );
+      if ( dt < 0.0 )
+      {
+         h = -step;
+         cache = &bwdCache;
+      }
+
+      double ad( std::fabs(dt) );
+      long k( static_cast<long>( std::floor(ad/step) ) );
+      double frac( ad - k*step );
+
+         // Requests on (or very close to) an integration node
+      const double tolerance( 1e-9 );
+      if ( frac < tolerance || (step - frac) < tolerance )
+      {
+         if ( frac >= tolerance ) ++k;
+
+         const PropNode& node( getNode( *cache, k, h ) );
+         for( int j = 0; j < 6; ++j )
+            state[j] = node.state[j];
+
+         return;
+      }
+
+         // Otherwise, use cubic Hermite interpolation between the two
+         // surrounding nodes. Node 'k' is requested first, so that getting
+         // node 'k+1' afterwards costs at most one extra step.
+      PropNode n0( getNode( *cache, k, h ) );
+      const PropNode& n1( getNode( *cache, k+1, h ) );
+
+      double t( frac/step );
+      double t2( t*t );
+      double t3( t2*t );
+      double h00(  2.0*t3 - 3.0*t2 + 1.0 );
+      double h10(      t3 - 2.0*t2 + t   );
+      double h01( -2.0*t3 + 3.0*t2       );
+      double h11(      t3 -     t2       );
+
+      for( int j = 0; j < 6; ++j )
+      {
+         state[j] = h00*n0.state[j] + h10*h*n0.deriv[j]
+                  + h01*n1.state[j] + h11*h*n1.deriv[j];
+      }
+
+   }  // End of method 'GloEphemeris::cachedState()'
 
 
       // Output the contents of this ephemeris to the given stream.
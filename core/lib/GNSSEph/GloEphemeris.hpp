@@ -42,6 +42,8 @@
 #define GPSTK_GLOEPHEMERIS_HPP
 
 #include <iostream>
+#include <mutex>
+#include <vector>
 #include "Triple.hpp"
 #include "Xvt.hpp"
 #include "CommonTime.hpp"
@@ -66,7 +68,8 @@ namespace gpstk
 
          /// Default constructor
       GloEphemeris()
-            : valid(false), step(1.0)
+            : valid(false), step(1.0), useCache(true),
+              cacheS0(0.0), cacheSod(0.0), cacheReady(false)
       {};
 
 
@@ -153,7 +156,34 @@ namespace gpstk
           * @param rkStep  Runge-Kutta integration step in seconds.
           */
       GloEphemeris& setIntegrationStep( double rkStep )
-      { step = rkStep; return (*this); };
+      { step = rkStep; clearPropagationCache(); return (*this); };
+
+
+         /// Get whether integrated states are kept between calls.
+      bool getPropagationCache() const
+      { return useCache; };
+
+
+         /** Set whether integrated states are kept between calls.
+          *
+          * When enabled (the default), svXvt() continues the Runge-Kutta
+          * integration from the nearest state already computed for this
+          * ephemeris, and epochs falling between two integration steps are
+          * obtained with a cubic Hermite (dense output) interpolator. When
+          * disabled, every call integrates from the reference epoch.
+          *
+          * @param use  Enable or disable the propagation cache.
+          */
+      GloEphemeris& setPropagationCache( bool use )
+      { useCache = use; clearPropagationCache(); return (*this); };
+
+
+         /// Discard all the integrated states kept by this object.
+      void clearPropagationCache() const
+      {
+         std::lock_guard<std::mutex> lock( cacheMutex.m );
+         fwdCache = PropCache(); bwdCache = PropCache(); cacheReady = false;
+      };
 
 
          /// Get the acceleration vector.
@@ -246,6 +276,84 @@ namespace gpstk
       double step;
 
 
+         /// Flag indicating that integrated states are kept between calls.
+      bool useCache;
+
+
+         /// Integrated satellite state at a multiple of the integration step.
+      struct PropNode
+      {
+            /// Position and velocity in the absolute frame [km, km/s]
+         double state[6];
+            /// Time derivative of 'state' at the node epoch
+         double deriv[6];
+      };
+
+
+         /// Integrated states kept for one integration direction.
+      struct PropCache
+      {
+         PropCache() : lo(), hi(), loIdx(-1) {};
+
+            /// States every 'checkpointSteps' steps, starting at the reference
+         std::vector<PropNode> checkpoints;
+            /// Last integrated step: states at steps 'loIdx' and 'loIdx+1'
+         PropNode lo, hi;
+            /// Step index of 'lo', or -1 if no step was integrated yet
+         long loIdx;
+      };
+
+
+         /// Number of integration steps between stored checkpoints.
+      static const long checkpointSteps;
+
+
+         /// Sidereal angle at 0h UT and seconds of day of the reference epoch.
+      mutable double cacheS0, cacheSod;
+
+         /// Flag indicating that 'cacheS0', 'cacheSod' and node 0 are set.
+      mutable bool cacheReady;
+
+         /// Integrated states forward and backward from the reference epoch.
+      mutable PropCache fwdCache, bwdCache;
+
+
+         /// Mutex serializing the use of the cache, so that svXvt() may be
+         /// called from several threads at once. A copy of the object gets
+         /// a mutex of its own.
+      struct CacheMutex
+      {
+         CacheMutex() {};
+         CacheMutex( const CacheMutex& ) {};
+         CacheMutex& operator=( const CacheMutex& ) { return (*this); };
+
+         std::mutex m;
+      };
+
+      mutable CacheMutex cacheMutex;
+
+
+         /// Compute satellite state (absolute frame) through the cache.
+         /// The caller holds 'cacheMutex'.
+      void cachedState( double dt, double* state ) const;
+
+
+         /** Return the integrated state at step 'k' (k >= 0) in the given
+          *  direction, continuing from the nearest state already available.
+          */
+      const PropNode& getNode( PropCache& cache, long k, double h ) const;
+
+
+         /// Perform a single Runge-Kutta step from 'in' to 'out', of size
+         /// 'h', ending 'tEnd' seconds after 0h UT of the reference day.
+      void rkStep( const PropNode& in, double h, double tEnd,
+                   PropNode& out ) const;
+
+
+         /// Compute accelerations due to luni-solar perturbations, rotated
+         /// to the absolute frame at 'tod' seconds after 0h UT.
+      void absAccel( double tod, double* accel ) const;
+
          /// Compute true sidereal time (in hours) at Greenwich at 0 hours UT.
       double getSidTime( const CommonTime& time ) const;
 
@@ -255,6 +363,12 @@ namespace gpstk
                                  const Vector<double>& accel ) const;
 
 
+         /// Allocation-free version of derivative(), used by the cache.
+      void derivative( const double* inState,
+                       const double* accel,
+                       double* dxt ) const;
+
+
 
 
          /// Output the contents of this ephemeris to the given stream.
@@ -63,11 +63,12 @@ namespace gpstk
          t.setTimeSystem(TimeSystem::GLO);   // must be GLONASS time
 
          SatID sat( data.sat );
+         gloEphem.setIntegrationStep(step);
          pe[sat][t] = gloEphem; // find or add entry
 
          if (t < initialTime)
             initialTime = t;
-         else if (t > finalTime)
+         if (t > finalTime)
             finalTime = t;
 
          return true;
@@ -156,12 +157,21 @@ namespace gpstk
          GPSTK_THROW(e);
       }
 
-         // We now have the proper reference data record. Let's use it
-      GloEphemeris data( i->second );
+         // We now have the proper reference data record. Use it in place,
+         // so that its propagation cache is kept between calls.
+      const GloEphemeris& data( i->second );
 
-      data.setIntegrationStep(step);
          // Compute the satellite position, velocity and clock offset
-      sv = data.svXvt( epoch );
+      if ( data.getIntegrationStep() == step )
+      {
+         sv = data.svXvt( epoch );
+      }
+      else
+      {
+         GloEphemeris other( data );
+         other.setIntegrationStep(step);
+         sv = other.svXvt( epoch );
+      }
 
          // We are done, let's return
       return sv;
@@ -169,6 +179,32 @@ namespace gpstk
    }; // End of method 'GloEphemerisStore::getXvt()'
 
 
+      /* Set integration step for Runge-Kutta algorithm. The step is also
+       * stored in every ephemeris already loaded, so that their propagation
+       * caches are built with it.
+       *
+       * @param rkStep  Runge-Kutta integration step in seconds.
+       */
+   GloEphemerisStore& GloEphemerisStore::setIntegrationStep( double rkStep )
+   {
+
+      step = rkStep;
+
+      for( GloEphMap::iterator svIt = pe.begin(); svIt != pe.end(); ++svIt )
+      {
+         for( TimeGloMap::iterator it = svIt->second.begin();
+              it != svIt->second.end();
+              ++it )
+         {
+            it->second.setIntegrationStep(step);
+         }
+      }
+
+      return (*this);
+
+   }; // End of method 'GloEphemerisStore::setIntegrationStep()'
+
+
       /* A debugging function that outputs in human readable form,
        * all data stored in this object.
        *
@@ -72,7 +72,7 @@ namespace gpstk
       GloEphemerisStore()
             : initialTime(CommonTime::END_OF_TIME),
               finalTime(CommonTime::BEGINNING_OF_TIME),
-              step(1.0)
+              step(1.0), validInterval(900.0)
       {
             setCheckHealthFlag(false);
       }
@@ -123,8 +123,7 @@ namespace gpstk
           *
           * @param rkStep  Runge-Kutta integration step in seconds.
           */
-      GloEphemerisStore& setIntegrationStep( double rkStep )
-      { step = rkStep; return (*this); };
+      GloEphemerisStore& setIntegrationStep( double rkStep );
 
          /// Get whether satellite health bit will be used or not.
       bool getCheckHealthFlag() const
@@ -149,7 +149,7 @@ namespace gpstk
           CommonTime initialTime = CommonTime::END_OF_TIME;
           initialTime.setTimeSystem(timeSystem);
 
-          auto &it = satTables.find(sat);
+          SatTableMap::const_iterator it = satTables.find(sat);
           if (it == satTables.end())
               return initialTime;
 
@@ -164,12 +164,11 @@ namespace gpstk
           CommonTime finalTime = CommonTime::BEGINNING_OF_TIME;
           finalTime.setTimeSystem(timeSystem);
 
-          auto &it = satTables.find(id);
+          SatTableMap::const_iterator it = satTables.find(id);
           if (it == satTables.end())
               return finalTime;
 
-          auto &last = (it->second).end();
-          return (--last)->first;
+          return (it->second).rbegin()->first;
       }
 
          /// Return true if velocity data is present in the store
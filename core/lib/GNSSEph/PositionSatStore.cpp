@@ -99,53 +99,86 @@ namespace gpstk
          PositionRecord rec;
          DataTableIterator it1, it2, kt;        // cf. TabularSatStore.hpp
 
-         isExact = getTableInterval(sat, ttag, Nhalf, it1, it2, haveVelocity);
-         if(isExact && haveVelocity) {
-            rec = it1->second;
-            return rec;
-         }
-
-         // pull data out of the data table
          size_t n,Nlow(Nhalf-1),Nhi(Nhalf),Nmatch(Nhalf);
-         CommonTime ttag0(it1->first);
-         vector<double> times,P[3],V[3],A[3],sigP[3],sigV[3],sigA[3];
+         vector<double> times, buff[18];        // hold unfrozen data
+         const double *T,*P[3],*V[3],*A[3],*sigP[3],*sigV[3],*sigA[3];
+         double dt;                             // time, in the units of T
+
+         if(frozen) {
+            size_t i1, i2, k;
+            isExact = getFrozenInterval(sat, ttag, Nhalf, i1, i2, haveVelocity);
+            if(isExact && haveVelocity)
+               return thawRecord(i1);
+
+            // point into the frozen columns
+            dt = frozenOffset(ttag);
+            n = i2-i1+1;
+            T = &frozenEpoch[i1];                            // sec
+            for(k=0; k<n; k++) {
+               if(isExact && ABS(T[k] - dt) < 1.e-8)
+                  Nmatch = k;
+            }
+            for(i=0; i<3; i++) {
+               P[i] = &colPos[i][i1];       sigP[i] = &colSigPos[i][i1];
+               V[i] = &colVel[i][i1];       sigV[i] = &colSigVel[i][i1];
+               A[i] = &colAcc[i][i1];       sigA[i] = &colSigAcc[i][i1];
+            }
+         }
+         else {
+            isExact = getTableInterval(sat, ttag, Nhalf, it1, it2, haveVelocity);
+            if(isExact && haveVelocity) {
+               rec = it1->second;
+               return rec;
+            }
 
-         kt = it1; n=0;
-         while(1) {
-            // find index matching ttag
-            if(isExact && ABS(kt->first - ttag) < 1.e-8)
-               Nmatch = n;
-            times.push_back(kt->first - ttag0);          // sec
+            // pull data out of the data table
+            CommonTime ttag0(it1->first);
+            dt = ttag - ttag0;
+
+            kt = it1; n=0;
+            while(1) {
+               // find index matching ttag
+               if(isExact && ABS(kt->first - ttag) < 1.e-8)
+                  Nmatch = n;
+               times.push_back(kt->first - ttag0);          // sec
+               for(i=0; i<3; i++) {
+                  buff[i].push_back(kt->second.Pos[i]);
+                  buff[3+i].push_back(kt->second.Vel[i]);
+                  buff[6+i].push_back(kt->second.Acc[i]);
+                  buff[9+i].push_back(kt->second.sigPos[i]);
+                  buff[12+i].push_back(kt->second.sigVel[i]);
+                  buff[15+i].push_back(kt->second.sigAcc[i]);
+               }
+               if(kt == it2) break;
+               ++kt;
+               ++n;
+            };
+            n = times.size();
+            T = &times[0];
             for(i=0; i<3; i++) {
-               P[i].push_back(kt->second.Pos[i]);
-               V[i].push_back(kt->second.Vel[i]);
-               A[i].push_back(kt->second.Acc[i]);
-               sigP[i].push_back(kt->second.sigPos[i]);
-               sigV[i].push_back(kt->second.sigVel[i]);
-               sigA[i].push_back(kt->second.sigAcc[i]);
+               P[i] = &buff[i][0];          sigP[i] = &buff[9+i][0];
+               V[i] = &buff[3+i][0];        sigV[i] = &buff[12+i][0];
+               A[i] = &buff[6+i][0];        sigA[i] = &buff[15+i][0];
             }
-            if(kt == it2) break;
-            ++kt;
-            ++n;
-         };
+         }
 
          if(isExact && Nmatch == (int)(Nhalf-1)) { Nlow++; Nhi++; }
 
          // Lagrange interpolation
          rec.sigAcc = rec.Acc = Triple(0,0,0);        // default
-         double dt(ttag-ttag0), err;           // dt in seconds
+         double err;
          if(haveVelocity) {
             for(i=0; i<3; i++) {
                // interpolate the positions
-               rec.Pos[i] = LagrangeInterpolation(times,P[i],dt,err);
+               rec.Pos[i] = LagrangeInterpolation(T,P[i],n,dt,err);
                if(haveAcceleration) {
                   // interpolate velocities and acclerations
-                  rec.Vel[i] = LagrangeInterpolation(times,V[i],dt,err);
-                  rec.Acc[i] = LagrangeInterpolation(times,A[i],dt,err);
+                  rec.Vel[i] = LagrangeInterpolation(T,V[i],n,dt,err);
+                  rec.Acc[i] = LagrangeInterpolation(T,A[i],n,dt,err);
                }
                else {
                   // interpolate velocities(dm/s) to get V and A
-                  LagrangeInterpolation(times,V[i],dt,rec.Vel[i],rec.Acc[i]);
+                  LagrangeInterpolation(T,V[i],n,dt,rec.Vel[i],rec.Acc[i]);
                   rec.Acc[i] *= 0.1;      // dm/s/s -> m/s/s
                }
 
@@ -167,7 +200,7 @@ namespace gpstk
          else {               // no V data - must interpolate position to get velocity
             for(i=0; i<3; i++) {
                // interpolate positions(km) to get P and V
-               LagrangeInterpolation(times,P[i],dt,rec.Pos[i],rec.Vel[i]);
+               LagrangeInterpolation(T,P[i],n,dt,rec.Pos[i],rec.Vel[i]);
                rec.Vel[i] *= 10000.;         // km/sec -> dm/sec
 
                if(isExact) {
@@ -198,6 +231,22 @@ namespace gpstk
    {
       try {
          int i;
+         if(frozen) {
+            size_t i1, i2;
+            if(getFrozenInterval(sat, ttag, Nhalf, i1, i2, true))
+               return Triple(colPos[0][i1], colPos[1][i1], colPos[2][i1]);
+
+            // interpolate the frozen columns in place
+            const double *T(&frozenEpoch[i1]);
+            const size_t n(i2-i1+1);
+            double dt(frozenOffset(ttag)), err;
+            Triple pos;
+            for(i=0; i<3; i++)
+               pos[i] = LagrangeInterpolation(T, &colPos[i][i1],
+                                              n, dt, err);
+            return pos;
+         }
+
          DataTableIterator it1, it2, kt;
 
          if(getTableInterval(sat, ttag, Nhalf, it1, it2, true)) {
@@ -243,6 +292,31 @@ namespace gpstk
    {
       try {
          int i;
+         if(frozen) {
+            size_t i1, i2;
+            if(getFrozenInterval(sat, ttag, Nhalf, i1, i2, haveVelocity)
+                  && haveVelocity)
+               return Triple(colVel[0][i1], colVel[1][i1], colVel[2][i1]);
+
+            // interpolate the frozen columns in place
+            const double *T(&frozenEpoch[i1]);
+            const size_t n(i2-i1+1);
+            double dt(frozenOffset(ttag)), err;
+            Triple Vel;
+            for(i=0; i<3; i++) {
+               if(haveVelocity)
+                  Vel[i] = LagrangeInterpolation(T, &colVel[i][i1],
+                                                 n, dt, err);
+               else {
+                  // interpolate positions(km) to get velocity // err is dummy
+                  LagrangeInterpolation(T, &colPos[i][i1],
+                                        n, dt, err, Vel[i]);
+                  Vel[i] *= 10000.;                               // km/s -> dm/s
+               }
+            }
+            return Vel;
+         }
+
          DataTableIterator it1, it2, kt;
 
          bool isExact(getTableInterval(sat, ttag, Nhalf, it1, it2, haveVelocity));
@@ -302,6 +376,30 @@ namespace gpstk
 
       try {
          int i;
+         if(frozen) {
+            size_t i1, i2;
+            if(getFrozenInterval(sat, ttag, Nhalf, i1, i2, haveAcceleration)
+                  && haveAcceleration)
+               return Triple(colAcc[0][i1], colAcc[1][i1], colAcc[2][i1]);
+
+            // interpolate the frozen columns in place
+            const double *T(&frozenEpoch[i1]);
+            const size_t n(i2-i1+1);
+            double dt(frozenOffset(ttag)), err;
+            Triple Acc;
+            for(i=0; i<3; i++) {
+               if(haveAcceleration)
+                  Acc[i] = LagrangeInterpolation(T, &colAcc[i][i1],
+                                                 n, dt, err);
+               else {
+                  LagrangeInterpolation(T, &colVel[i][i1],
+                                        n, dt, err, Acc[i]);
+                  Acc[i] *= 0.1;                               // dm/s/s -> m/s/s
+               }
+            }
+            return Acc;
+         }
+
          DataTableIterator it1, it2, kt;
 
          bool isExact(getTableInterval(sat,ttag,Nhalf,it1,it2,haveAcceleration));
@@ -348,6 +446,7 @@ namespace gpstk
       throw(InvalidRequest)
    {
       try {
+         checkNotFrozen();
          checkTimeSystem(ttag.getTimeSystem());
 
          int i;
@@ -380,6 +479,7 @@ namespace gpstk
       throw(InvalidRequest)
    {
       try {
+         checkNotFrozen();
          checkTimeSystem(ttag.getTimeSystem());
 
          if(tables.find(sat) != tables.end() &&
@@ -407,6 +507,7 @@ namespace gpstk
       throw(InvalidRequest)
    {
       try {
+         checkNotFrozen();
          checkTimeSystem(ttag.getTimeSystem());
 
          haveVelocity = true;
@@ -436,6 +537,7 @@ namespace gpstk
        throw(InvalidRequest)
    {
       try {
+         checkNotFrozen();
          checkTimeSystem(ttag.getTimeSystem());
 
          haveAcceleration = true;
@@ -459,6 +561,52 @@ namespace gpstk
       catch(InvalidRequest& ir) { GPSTK_RETHROW(ir); }
    }
 
+   // Append a record to the frozen columns
+   void PositionSatStore::freezeRecord(const PositionRecord& rec) throw()
+   {
+      for(int i=0; i<3; i++) {
+         colPos[i].push_back(rec.Pos[i]);
+         colSigPos[i].push_back(rec.sigPos[i]);
+         colVel[i].push_back(rec.Vel[i]);
+         colSigVel[i].push_back(rec.sigVel[i]);
+         colAcc[i].push_back(rec.Acc[i]);
+         colSigAcc[i].push_back(rec.sigAcc[i]);
+      }
+   }
+
+   // Rebuild record i from the frozen columns
+   PositionRecord PositionSatStore::thawRecord(size_t i) const throw()
+   {
+      PositionRecord rec;
+      rec.Pos = Triple(colPos[0][i], colPos[1][i], colPos[2][i]);
+      rec.sigPos = Triple(colSigPos[0][i], colSigPos[1][i], colSigPos[2][i]);
+      rec.Vel = Triple(colVel[0][i], colVel[1][i], colVel[2][i]);
+      rec.sigVel = Triple(colSigVel[0][i], colSigVel[1][i], colSigVel[2][i]);
+      rec.Acc = Triple(colAcc[0][i], colAcc[1][i], colAcc[2][i]);
+      rec.sigAcc = Triple(colSigAcc[0][i], colSigAcc[1][i], colSigAcc[2][i]);
+      return rec;
+   }
+
+   // Reserve room for n records in the frozen columns
+   void PositionSatStore::reserveFrozenRecords(size_t n) throw()
+   {
+      for(int i=0; i<3; i++) {
+         colPos[i].reserve(n); colSigPos[i].reserve(n);
+         colVel[i].reserve(n); colSigVel[i].reserve(n);
+         colAcc[i].reserve(n); colSigAcc[i].reserve(n);
+      }
+   }
+
+   // Remove all records from the frozen columns
+   void PositionSatStore::clearFrozenRecords() throw()
+   {
+      for(int i=0; i<3; i++) {
+         vector<double>().swap(colPos[i]); vector<double>().swap(colSigPos[i]);
+         vector<double>().swap(colVel[i]); vector<double>().swap(colSigVel[i]);
+         vector<double>().swap(colAcc[i]); vector<double>().swap(colSigAcc[i]);
+      }
+   }
+
    //@}
 
 }  // End of namespace gpstk
@@ -43,6 +43,7 @@
 #define GPSTK_POSITION_SAT_STORE_INCLUDE
 
 #include <map>
+#include <vector>
 #include <iostream>
 
 #include "TabularSatStore.hpp"
@@ -117,6 +118,24 @@ namespace gpstk
          /// Store half the interpolation order, for convenience
       unsigned int Nhalf;
 
+         /** Columns of the frozen tables (see TabularSatStore::freeze()),
+          * one per component, indexed as TabularSatStore::frozenSec. */
+      std::vector<double> colPos[3], colSigPos[3];
+      std::vector<double> colVel[3], colSigVel[3];
+      std::vector<double> colAcc[3], colSigAcc[3];
+
+         /// Append a record to the frozen columns
+      virtual void freezeRecord(const PositionRecord& rec) throw();
+
+         /// Rebuild record i from the frozen columns
+      virtual PositionRecord thawRecord(std::size_t i) const throw();
+
+         /// Reserve room for n records in the frozen columns
+      virtual void reserveFrozenRecords(std::size_t n) throw();
+
+         /// Remove all records from the frozen columns
+      virtual void clearFrozenRecords() throw();
+
          // member functions
    public:
 
@@ -320,6 +320,23 @@ namespace gpstk
       virtual void clearClock(void) throw()
       { clkStore.clear(); }
 
+         /** Move the position and clock data into flat, per-satellite
+          * arrays (see TabularSatStore::freeze()); this should be
+          * called once all the files have been loaded, and makes
+          * getXvt() faster and the store much smaller. No more data
+          * can be loaded until thaw() is called. */
+      void freeze(void) throw()
+      { posStore.freeze(); clkStore.freeze(); }
+
+         /** Undo freeze(), moving the data back into the std::map
+          * tables so that more data may be loaded. */
+      void thaw(void) throw()
+      { posStore.thaw(); clkStore.thaw(); }
+
+         /// Return true if freeze() was called (and not undone)
+      bool isFrozen(void) const throw()
+      { return posStore.isFrozen(); }
+
    
          /** Choose to load the clock data tables from RINEX clock
           * files. This will clear the clock store; loadFile() or
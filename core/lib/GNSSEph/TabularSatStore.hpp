@@ -43,6 +43,7 @@
 #define GPSTK_TABULAR_SAT_STORE_INCLUDE
 
 #include <map>
+#include <vector>
 #include <iostream>
 #include <cmath>
 
@@ -128,6 +129,44 @@ namespace gpstk
 
       typedef typename DataTable::const_iterator DataTableIterator;
 
+         /** Range of one satellite in the frozen (flat) tables: records
+          * begin..end-1 of the frozen columns, and the nominal time
+          * step used to compute an O(1) first guess of an index. */
+      typedef struct FrozenRangeStruct
+      {
+         std::size_t begin, end;   ///< indexes into the frozen columns
+         double step;              ///< nominal time step (seconds)
+      } FrozenRange;
+
+         /// std::map with key=SatID, value=FrozenRange
+      typedef std::map<SatID, FrozenRange> FrozenSatTable;
+
+         /** Flag indicating that the data were moved out of 'tables'
+          * into flat, per-satellite arrays by freeze(). */
+      bool frozen;
+
+         /// Reference time of the frozen epochs (earliest time in the store)
+      CommonTime frozenRef;
+
+         /// Integer seconds of day of frozenRef, and its day.
+      long frozenRefDay, frozenRefSod;
+
+         /// Fractional seconds of day of frozenRef.
+      double frozenRefFsod;
+
+         /** Frozen epochs, as whole and fractional (in [0,1)) seconds
+          * since frozenRef; sorted by satellite, then by time. */
+      std::vector<long> frozenSec;
+      std::vector<double> frozenFrac;
+
+         /** The same epochs as seconds since frozenRef, the abscissae
+          * of the interpolation: the window i1..i2 of a satellite is
+          * the contiguous array starting at frozenEpoch[i1]. */
+      std::vector<double> frozenEpoch;
+
+         /// Per-satellite ranges in the frozen arrays
+      FrozenSatTable frozenTables;
+
          // member functions
    public:
          /// Default constructor
@@ -135,7 +174,7 @@ namespace gpstk
       : storeTimeSystem(TimeSystem::Any),
          havePosition(false), haveVelocity(false),
          haveClockBias(false), haveClockDrift(false),
-         checkDataGap(false), checkInterval(false)
+         checkDataGap(false), checkInterval(false), frozen(false)
       {}
          /// Destructor
       virtual ~TabularSatStore() {}
@@ -561,6 +600,349 @@ namespace gpstk
          }
       }
 
+         /** Move all data out of the std::map tables into flat,
+          * per-satellite arrays, which are faster to search and much
+          * smaller in memory. This is meant to be called once, after
+          * all the data have been loaded; data cannot be added to a
+          * frozen store (call thaw() first). Interpolation results
+          * are the same as with the std::map tables.
+          * @note the record data themselves are stored by the
+          *   deriving class, through freezeRecord(). */
+      void freeze() throw()
+      {
+         if(frozen) return;
+
+         frozenRef = getInitialTime();
+         if(frozenRef == CommonTime::END_OF_TIME)
+            frozenRef = CommonTime::BEGINNING_OF_TIME;
+         frozenRef.get(frozenRefDay, frozenRefSod, frozenRefFsod);
+
+         std::size_t n(ndata());
+         frozenSec.clear();
+         frozenFrac.clear();
+         frozenEpoch.clear();
+         frozenSec.reserve(n);
+         frozenFrac.reserve(n);
+         frozenEpoch.reserve(n);
+         frozenTables.clear();
+         clearFrozenRecords();
+         reserveFrozenRecords(n);
+
+         typename SatTable::const_iterator it;
+         for(it=tables.begin(); it!=tables.end(); ++it)
+         {
+            if(it->second.empty()) continue;
+
+            FrozenRange& range(frozenTables[it->first]);
+            range.step = nomTimeStep(it->first);
+            range.begin = frozenSec.size();
+
+            typename DataTable::const_iterator jt;
+            for(jt=it->second.begin(); jt!=it->second.end(); ++jt)
+            {
+               long sec;
+               double frac;
+               frozenSeconds(jt->first, sec, frac);
+               frozenSec.push_back(sec);
+               frozenFrac.push_back(frac);
+               frozenEpoch.push_back(sec + frac);
+               freezeRecord(jt->second);
+            }
+
+            range.end = frozenSec.size();
+         }
+
+            // release the std::map storage
+         tables.clear();
+         frozen = true;
+      }
+
+         /** Move the data back from the flat arrays into the std::map
+          * tables, so that the store may be modified again. */
+      void thaw() throw()
+      {
+         if(!frozen) return;
+
+         typename FrozenSatTable::const_iterator it;
+         for(it=frozenTables.begin(); it!=frozenTables.end(); ++it)
+         {
+            DataTable& dtable(tables[it->first]);
+            for(std::size_t i=it->second.begin; i<it->second.end; i++)
+               dtable[frozenTime(i)] = thawRecord(i);
+         }
+
+         frozenSec.clear();
+         frozenFrac.clear();
+         frozenEpoch.clear();
+         frozenTables.clear();
+         clearFrozenRecords();
+         frozen = false;
+      }
+
+         /// Return true if the data were moved into the flat arrays.
+      bool isFrozen() const throw()
+      { return frozen; }
+
+         /** Frozen-mode equivalent of getTableInterval(): locate the
+          * given time in the flat arrays for the given satellite, and
+          * return the indexes i1 and i2 (i1<i2) of the range of
+          * 2*nhalf points, nhalf on each side of the given time. The
+          * index of the first guess is computed in O(1) from the
+          * nominal time step. Return value, exceptions and the
+          * meaning of exactReturn are those of getTableInterval().
+          * @param[in] sat satellite of interest
+          * @param[in] ttag time of interest
+          * @param[in] nhalf number of table points desired on each
+          *   side of ttag
+          * @param[out] i1 index of the interval begin
+          * @param[out] i2 index of the interval end
+          * @param[in] exactReturn if true and exact match is found,
+          *   return immediately, with the matching time at i1. */
+      bool getFrozenInterval(const SatID& sat,
+                             const CommonTime& ttag,
+                             const int& nhalf,
+                             std::size_t& i1,
+                             std::size_t& i2,
+                             bool exactReturn=true)
+         const throw(InvalidRequest)
+      {
+         static const char *fmt=
+            " at time %F/%.3g %4Y/%02m/%02d %2H:%02M:%.3f %P";
+
+         checkTimeSystem(ttag.getTimeSystem());
+
+            // find the range for this sat
+         typename FrozenSatTable::const_iterator satit(frozenTables.find(sat));
+         if(satit == frozenTables.end())
+         {
+            InvalidRequest
+               ie("Satellite " + gpstk::StringUtils::asString(sat) +
+                  " not found.");
+            GPSTK_THROW(ie);
+         }
+         const std::size_t b(satit->second.begin), e(satit->second.end);
+
+            // cannot interpolate with one point
+         if(e - b < 2)
+         {
+            InvalidRequest ie("Inadequate data (size < 2) for satellite " +
+                              gpstk::StringUtils::asString(sat) +
+                              printTime(ttag,fmt));
+            GPSTK_THROW(ie);
+         }
+
+         long sec;
+         double frac;
+         frozenSeconds(ttag, sec, frac);
+
+            // first guess from the nominal time step, then move to the
+            // first element with time >= ttag (cf. lower_bound)
+         std::size_t k(b);
+         double step(satit->second.step);
+         if(step > 0.0)
+         {
+            double del((sec - frozenSec[b]) + (frac - frozenFrac[b]));
+            if(del > 0.0)
+            {
+               double guess(std::ceil(del/step));
+               k = (guess >= double(e-b) ? e-1 : b + std::size_t(guess));
+            }
+         }
+         while(k < e && compareFrozen(k, sec, frac) < 0) ++k;
+         while(k > b && compareFrozen(k-1, sec, frac) >= 0) --k;
+
+         bool exactMatch(k < e && compareFrozen(k, sec, frac) == 0);
+         if(exactMatch && exactReturn)
+         {
+            i1 = k;
+            return true;
+         }
+
+         if(k == e)
+         {
+            InvalidRequest ie("No data in time range for satellite " +
+                              gpstk::StringUtils::asString(sat) +
+                              printTime(ttag,fmt));
+            GPSTK_THROW(ie);
+         }
+
+         i1 = i2 = k;
+
+            // ttag is <= first time in table
+         if(i1 == b)
+         {
+            if(exactMatch && nhalf==1)
+            {
+               i2 = i1 + 1;
+               return exactMatch;
+            }
+            InvalidRequest ie("Inadequate data before(1) requested time for"
+                              " satellite " +
+                              gpstk::StringUtils::asString(sat) +
+                              printTime(ttag,fmt));
+            GPSTK_THROW(ie);
+         }
+
+            // move i1 down by one
+         if(--i1 == b)
+         {
+            if(nhalf==1)
+            {
+               i2 = i1 + 1;
+               return exactMatch;
+            }
+            InvalidRequest ie("Inadequate data before(2) requested time for"
+                              " satellite " +
+                              gpstk::StringUtils::asString(sat) +
+                              printTime(ttag,fmt));
+            GPSTK_THROW(ie);
+         }
+
+            // check for gap between the two entries surrounding ttag
+         if(checkDataGap && frozenDiff(i2, i1) > gapInterval)
+         {
+            InvalidRequest ie("Gap at interpolation time for satellite " +
+                              gpstk::StringUtils::asString(sat) +
+                              printTime(ttag,fmt));
+            GPSTK_THROW(ie);
+         }
+
+            // now expand the interval to include 2*nhalf timesteps
+         for(int j=0; j<nhalf-1; j++)
+         {
+            bool last(j==nhalf-2);
+            if(--i1 == b && !last)
+            {
+               InvalidRequest
+                  ie("Inadequate data before(3) requested time for"
+                     " satellite " + gpstk::StringUtils::asString(sat) +
+                     printTime(ttag,fmt));
+               GPSTK_THROW(ie);
+            }
+
+            if(++i2 == e)
+            {
+               if(exactMatch && last && i1 != b)
+               {
+                  i2--;
+                  i1--;
+               }
+               else
+               {
+                  InvalidRequest
+                     ie("Inadequate data after(2) requested time for"
+                        " satellite " + gpstk::StringUtils::asString(sat) +
+                        printTime(ttag,fmt));
+                  GPSTK_THROW(ie);
+               }
+            }
+         }
+
+            // check that the interval is not too large
+         if(checkInterval && frozenDiff(i2, i1) > maxInterval)
+         {
+            InvalidRequest ie("Interpolation interval too large for"
+                              " satellite " +
+                              gpstk::StringUtils::asString(sat) +
+                              printTime(ttag,fmt));
+            GPSTK_THROW(ie);
+         }
+
+         return exactMatch;
+      }
+
+         /// Time difference (seconds) between frozen records i and j.
+      double frozenDiff(std::size_t i, std::size_t j) const throw()
+      { return (frozenSec[i] - frozenSec[j]) + (frozenFrac[i] - frozenFrac[j]); }
+
+         /// Time difference (seconds) between ttag and frozen record j.
+      double frozenDiff(const CommonTime& ttag, std::size_t j) const throw()
+      {
+         long sec;
+         double frac;
+         frozenSeconds(ttag, sec, frac);
+         return (sec - frozenSec[j]) + (frac - frozenFrac[j]);
+      }
+
+         /// Time tag of frozen record i.
+      CommonTime frozenTime(std::size_t i) const throw()
+      {
+         CommonTime t(frozenRef);
+         t.addSeconds(frozenSec[i]);
+         t.addSeconds(frozenFrac[i]);
+         return t;
+      }
+
+         /// Time ttag in the units of frozenEpoch (seconds since frozenRef).
+      double frozenOffset(const CommonTime& ttag) const throw()
+      {
+         long sec;
+         double frac;
+         frozenSeconds(ttag, sec, frac);
+         return sec + frac;
+      }
+
+   protected:
+
+         /** Append one record to the frozen columns; called by
+          * freeze() once per record, sorted by satellite and time.
+          * The default stores the whole DataRecord in a contiguous
+          * array; deriving classes should store the individual
+          * quantities in separate columns instead. */
+      virtual void freezeRecord(const DataRecord& rec) throw()
+      { frozenRecords.push_back(rec); }
+
+         /// Rebuild record i from the frozen columns.
+      virtual DataRecord thawRecord(std::size_t i) const throw()
+      { return frozenRecords[i]; }
+
+         /// Reserve room for n records in the frozen columns.
+      virtual void reserveFrozenRecords(std::size_t n) throw()
+      { frozenRecords.reserve(n); }
+
+         /// Remove all records from the frozen columns.
+      virtual void clearFrozenRecords() throw()
+      { std::vector<DataRecord>().swap(frozenRecords); }
+
+         /// Throw if the store is frozen, i.e. cannot be modified.
+      void checkNotFrozen() const throw(InvalidRequest)
+      {
+         if(frozen)
+         {
+            InvalidRequest ir("Store is frozen; call thaw() to add data");
+            GPSTK_THROW(ir);
+         }
+      }
+
+   private:
+
+         /// Records used by the default freezeRecord()/thawRecord()
+      std::vector<DataRecord> frozenRecords;
+
+         /// Convert ttag to whole and fractional seconds since frozenRef.
+      void frozenSeconds(const CommonTime& ttag, long& sec, double& frac)
+         const throw()
+      {
+         long day, sod;
+         double fsod;
+         ttag.get(day, sod, fsod);
+         sec = (day - frozenRefDay)*86400L + (sod - frozenRefSod);
+         frac = fsod - frozenRefFsod;
+         if(frac < 0.0) { frac += 1.0; --sec; }
+      }
+
+         /// Compare frozen record i with the time (sec,frac): -1, 0 or 1.
+      int compareFrozen(std::size_t i, long sec, double frac) const throw()
+      {
+         if(frozenSec[i] != sec)
+            return (frozenSec[i] < sec ? -1 : 1);
+         double del(frozenFrac[i] - frac);
+         if(std::fabs(del) < CommonTime::eps) return 0;
+         return (del < 0.0 ? -1 : 1);
+      }
+
+   public:
+
          // interface like that of XvtStore
 
          /** Dump information about the object to an ostream.
@@ -612,7 +994,32 @@ namespace gpstk
                   << std::fixed << std::setprecision(2) << maxInterval;
             os << std::endl;
 
-            if(detail > 0)
+            if(detail > 0 && frozen)
+            {
+               typename FrozenSatTable::const_iterator it;
+               for(it=frozenTables.begin(); it!=frozenTables.end(); it++)
+               {
+                  os << "   Sat " << it->first << " : "
+                     << (it->second.end - it->second.begin)
+                     << " records (frozen).";
+
+                  if(detail == 1)
+                  {
+                     os << std::endl;
+                     continue;
+                  }
+
+                  os << "   Data:" << std::endl;
+                  for(std::size_t i=it->second.begin; i<it->second.end; i++)
+                  {
+                     os << " " << printTime(frozenTime(i),fmt)
+                        << " " << gpstk::StringUtils::asString(it->first)
+                        << " " << thawRecord(i)
+                        << std::endl;
+                  }
+               }
+            }
+            else if(detail > 0)
             {
                typename SatTable::const_iterator it;
                for(it=tables.begin(); it!=tables.end(); it++)
@@ -651,6 +1058,10 @@ namespace gpstk
                 const CommonTime& tmax = CommonTime::END_OF_TIME)
          throw()
       {
+            // edit the std::map tables, then rebuild the flat arrays
+         bool wasFrozen(frozen);
+         thaw();
+
             // loop over satellites
          typename SatTable::iterator it;
          for(it=tables.begin(); it!=tables.end(); it++)
@@ -671,6 +1082,9 @@ namespace gpstk
             if(jt != dtab.begin() && --jt != dtab.begin())
                dtab.erase(dtab.begin(),jt);
          }
+
+         if(wasFrozen)
+            freeze();
       }
 
          // remaining functions are not virtual
@@ -682,11 +1096,22 @@ namespace gpstk
          for(satit=tables.begin(); satit!=tables.end(); ++satit)
             satit->second.clear();
          tables.clear();
+
+         frozenSec.clear();
+         frozenFrac.clear();
+         frozenEpoch.clear();
+         frozenTables.clear();
+         clearFrozenRecords();
+         frozen = false;
       }
 
          /// Return true if the given SatID is present in the store
       virtual bool isPresent(const SatID& sat) const throw()
-      { return (tables.find(sat) != tables.end()); }
+      {
+         if(frozen)
+            return (frozenTables.find(sat) != frozenTables.end());
+         return (tables.find(sat) != tables.end());
+      }
 
          /** Determine if the input TimeSystem conflicts with the
           * stored TimeSystem.
@@ -710,6 +1135,8 @@ namespace gpstk
       CommonTime getInitialTime() const throw()
       {
          CommonTime initialTime(CommonTime::END_OF_TIME);
+         if(frozen)
+            return (frozenTables.empty() ? initialTime : frozenRef);
          if(tables.size() == 0) return initialTime;
 
             // loop over satellites
@@ -734,6 +1161,21 @@ namespace gpstk
       CommonTime getFinalTime() const throw()
       {
          CommonTime finalTime(CommonTime::BEGINNING_OF_TIME);
+         if(frozen)
+         {
+            typename FrozenSatTable::const_iterator it;
+            std::size_t last(0);
+            for(it=frozenTables.begin(); it!=frozenTables.end(); it++)
+            {
+               if(finalTime == CommonTime::BEGINNING_OF_TIME ||
+                  frozenDiff(it->second.end-1, last) > 0.0)
+               {
+                  last = it->second.end-1;
+                  finalTime = frozenTime(last);
+               }
+            }
+            return finalTime;
+         }
          if(tables.size() == 0)
             return finalTime;
 
@@ -764,6 +1206,13 @@ namespace gpstk
       CommonTime getInitialTime(const SatID& sat) const throw()
       {
          CommonTime initialTime(CommonTime::END_OF_TIME);
+         if(frozen)
+         {
+            typename FrozenSatTable::const_iterator fit(frozenTables.find(sat));
+            if(fit == frozenTables.end())
+               return initialTime;
+            return frozenTime(fit->second.begin);
+         }
          if(tables.size() == 0)
             return initialTime;
 
@@ -779,6 +1228,13 @@ namespace gpstk
       CommonTime getFinalTime(const SatID& sat) const throw()
       {
          CommonTime finalTime(CommonTime::BEGINNING_OF_TIME);
+         if(frozen)
+         {
+            typename FrozenSatTable::const_iterator fit(frozenTables.find(sat));
+            if(fit == frozenTables.end())
+               return finalTime;
+            return frozenTime(fit->second.end-1);
+         }
          if(tables.size() == 0)
             return finalTime;
 
@@ -825,6 +1281,13 @@ namespace gpstk
       std::vector<SatID> getSatList(void) const throw()
       {
          std::vector<SatID> satlist;
+         if(frozen)
+         {
+            typename FrozenSatTable::const_iterator fit;
+            for(fit=frozenTables.begin(); fit != frozenTables.end(); ++fit)
+               satlist.push_back(fit->first);
+            return satlist;
+         }
          typename SatTable::const_iterator it;
          for(it=tables.begin(); it != tables.end(); ++it)
          {
@@ -837,6 +1300,8 @@ namespace gpstk
          /// Get the total number of data records in the store
       inline int ndata(void) const throw()
       {
+         if(frozen)
+            return frozenSec.size();
          int n(0);
          typename SatTable::const_iterator sit;
          for(sit=tables.begin(); sit != tables.end(); ++sit)
@@ -849,6 +1314,13 @@ namespace gpstk
          /// Get the number of data records for the given sat
       inline int ndata(const SatID& sat) const throw()
       {
+         if(frozen)
+         {
+            typename FrozenSatTable::const_iterator fit(frozenTables.find(sat));
+            if(fit == frozenTables.end())
+               return 0;
+            return (fit->second.end - fit->second.begin);
+         }
          typename SatTable::const_iterator it(tables.find(sat));
          if(it == tables.end())
          {
@@ -864,6 +1336,16 @@ namespace gpstk
       inline int ndata(const SatID::SatelliteSystem& sys) const throw()
       {
          int n(0);
+         if(frozen)
+         {
+            typename FrozenSatTable::const_iterator fit;
+            for(fit=frozenTables.begin(); fit != frozenTables.end(); ++fit)
+            {
+               if(fit->first.system == sys)
+                  n += (fit->second.end - fit->second.begin);
+            }
+            return n;
+         }
          typename SatTable::const_iterator sit;
          for(sit=tables.begin(); sit != tables.end(); ++sit)
          {
@@ -882,6 +1364,13 @@ namespace gpstk
           *   timestep in seconds. */
       double nomTimeStep(const SatID& sat) const throw()
       {
+            // computed once by freeze()
+         if(frozen)
+         {
+            typename FrozenSatTable::const_iterator fit(frozenTables.find(sat));
+            return (fit == frozenTables.end() ? 0.0 : fit->second.step);
+         }
+
             // get the table for this sat
          typename SatTable::const_iterator it(tables.find(sat));
 
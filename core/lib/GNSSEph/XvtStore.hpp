@@ -57,6 +57,12 @@ namespace gpstk
     /// Abstract base class for storing and accessing an object's position, 
     /// velocity, and clock data. Also defines a simple interface to remove
     /// data that had been added.
+    ///
+    /// Once loaded, a store may be shared by several threads: the const
+    /// methods, getXvt() in particular, don't modify the store, or, like
+    /// the propagation cache of GloEphemeris, serialize their changes.
+    /// Loading, editing and changing the settings of a store must not
+    /// overlap with any other call on it.
     template <class IndexType>
     class XvtStore
     {
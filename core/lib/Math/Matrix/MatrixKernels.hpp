@@ -0,0 +1,488 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+/**
+ * @file MatrixKernels.hpp
+ * In-place, allocation-free kernels for the symmetric matrix operations of
+ * sequential estimators (covariance propagation, normal equations, Cholesky
+ * solution and inverse). Results are written into caller-supplied matrices,
+ * which are only reallocated when they have to grow (see Vector::resize()),
+ * so that a filter can keep them as members and reuse them at every epoch.
+ */
+
+#ifndef GPSTK_MATRIX_KERNELS_HPP
+#define GPSTK_MATRIX_KERNELS_HPP
+
+#include "Matrix.hpp"
+
+namespace gpstk
+{
+      /// @ingroup MathGroup
+      //@{
+
+      /**
+       * Compute y = A*x into y, without temporaries.
+       * @throw MatrixException if the dimensions do not agree.
+       */
+   template <class T>
+   void multiplyInto(const Matrix<T>& A, const Vector<T>& x, Vector<T>& y)
+      throw(MatrixException)
+   {
+      if (A.cols() != x.size() || &x == &y)
+      {
+         MatrixException e("Incompatible arguments for multiplyInto()");
+         GPSTK_THROW(e);
+      }
+
+      const size_t m(A.rows()), n(A.cols());
+      y.resize(m);
+      y = T(0);
+      const T* a(A.begin());
+      for (size_t k = 0; k < n; k++)
+      {
+         const T xk(x[k]);
+         if (xk == T(0)) continue;
+         const T* ak(a + k*m);         // column k (column major storage)
+         for (size_t i = 0; i < m; i++)
+            y[i] += ak[i]*xk;
+      }
+   }
+
+      /**
+       * Covariance propagation Pout = Phi*P*Phi^T + Q, for symmetric P and
+       * Q. Only one triangle of the result is computed, and zero elements
+       * of Phi (usually most of them) are skipped.  Pout may be the same
+       * object as P.
+       * @param work workspace matrix, resized as needed
+       * @throw MatrixException if the dimensions do not agree.
+       */
+   template <class T>
+   void propagateCovariance(const Matrix<T>& Phi, const Matrix<T>& P,
+                            const Matrix<T>& Q, Matrix<T>& Pout,
+                            Matrix<T>& work)
+      throw(MatrixException)
+   {
+      const size_t n(P.rows());
+      if (!P.isSquare() || Phi.rows() != n || Phi.cols() != n ||
+          Q.rows() != n || Q.cols() != n ||
+          &work == &P || &work == &Phi || &work == &Pout || &Pout == &Phi)
+      {
+         MatrixException e("Incompatible arguments for propagateCovariance()");
+         GPSTK_THROW(e);
+      }
+
+         // work = P*Phi^T, column j is P times row j of Phi
+      work.resize(n, n);
+      work = T(0);
+      const T* p(P.begin());
+      const T* phi(Phi.begin());
+      T* w(work.begin());
+      size_t i, j, k;
+      for (j = 0; j < n; j++)
+      {
+         T* wj(w + j*n);
+         for (k = 0; k < n; k++)
+         {
+            const T f(phi[j + k*n]);
+            if (f == T(0)) continue;
+            const T* pk(p + k*n);
+            for (i = 0; i < n; i++)
+               wj[i] += pk[i]*f;
+         }
+      }
+
+         // Pout = Phi*work + Q, upper triangle, column j is Phi times
+         // column j of work
+      Pout.resize(n, n);
+      T* po(Pout.begin());
+      const T* q(Q.begin());
+      for (j = 0; j < n; j++)
+      {
+         T* pj(po + j*n);
+         const T* qj(q + j*n);
+         for (i = 0; i <= j; i++)
+            pj[i] = qj[i];
+         const T* wj(w + j*n);
+         for (k = 0; k < n; k++)
+         {
+            const T f(wj[k]);
+            if (f == T(0)) continue;
+            const T* phik(phi + k*n);
+            for (i = 0; i <= j; i++)
+               pj[i] += phik[i]*f;
+         }
+      }
+      for (j = 0; j < n; j++)
+         for (i = j+1; i < n; i++)
+            po[i + j*n] = po[j + i*n];
+   }
+
+      /**
+       * Accumulate the normal equations of the observations y = H*x with
+       * weight matrix W: N += H^T*W*H and b += H^T*W*y.  Only one triangle
+       * of H^T*W*H is computed, and zero elements of W (e.g. the whole
+       * off-diagonal part of a diagonal W) are skipped.
+       * @param work workspace matrix, resized as needed
+       * @throw MatrixException if the dimensions do not agree.
+       */
+   template <class T>
+   void accumulateNormals(const Matrix<T>& H, const Matrix<T>& W,
+                          const Vector<T>& y, Matrix<T>& N, Vector<T>& b,
+                          Matrix<T>& work)
+      throw(MatrixException)
+   {
+      const size_t m(H.rows()), n(H.cols());
+      if (W.rows() != m || W.cols() != m || y.size() != m ||
+          N.rows() != n || N.cols() != n || b.size() != n ||
+          &work == &H || &work == &W || &work == &N)
+      {
+         MatrixException e("Incompatible arguments for accumulateNormals()");
+         GPSTK_THROW(e);
+      }
+
+         // work = W*H, column j is W times column j of H
+      work.resize(m, n);
+      work = T(0);
+      const T* h(H.begin());
+      const T* wt(W.begin());
+      T* w(work.begin());
+      size_t i, j, k;
+      for (j = 0; j < n; j++)
+      {
+         T* wj(w + j*m);
+         const T* hj(h + j*m);
+         for (k = 0; k < m; k++)
+         {
+            const T f(hj[k]);
+            if (f == T(0)) continue;
+            const T* wk(wt + k*m);
+            for (i = 0; i < m; i++)
+               wj[i] += wk[i]*f;
+         }
+      }
+
+         // N(i,j) += H(:,i)^T * work(:,j), upper triangle;
+         // b(j) += work(:,j)^T * y, since W is symmetric
+      T* nn(N.begin());
+      for (j = 0; j < n; j++)
+      {
+         const T* wj(w + j*m);
+         T sum(0);
+         for (k = 0; k < m; k++)
+            sum += wj[k]*y[k];
+         b[j] += sum;
+
+         for (i = 0; i <= j; i++)
+         {
+            const T* hi(h + i*m);
+            sum = T(0);
+            for (k = 0; k < m; k++)
+               sum += hi[k]*wj[k];
+            nn[i + j*n] += sum;
+         }
+      }
+      for (j = 0; j < n; j++)
+         for (i = j+1; i < n; i++)
+            nn[i + j*n] = nn[j + i*n];
+   }
+
+      /**
+       * Kalman measurement update processing the observations y = H*x one
+       * at a time, for a diagonal weight matrix W (W(k,k) = 1/variance of
+       * y(k); a zero weight drops the observation). On input x and P are
+       * the predicted state and covariance, on output the updated ones.
+       * The covariance is updated in the Joseph form
+       *    P = (I-K*h)*P*(I-K*h)^T + K*r*K^T
+       * for each observation, h being its row of H and r its variance,
+       * evaluated as B = P - K*(h*P), P = B - (B*h^T)*K^T + r*K*K^T and
+       * symmetrized: unlike P - K*h*P, the result stays symmetric positive
+       * definite when P is ill-conditioned, being insensitive to first
+       * order to round-off in the gain K. Zero elements of each row of H
+       * are skipped, so that the cost is O(m*n^2) at most, instead of the
+       * O(n^3) of the information form.
+       * @param work workspace vector, resized as needed
+       * @throw MatrixException if the dimensions do not agree, if W is not
+       *   diagonal or has a negative weight, or if an innovation variance
+       *   is not positive.
+       */
+   template <class T>
+   void sequentialUpdate(const Matrix<T>& H, const Matrix<T>& W,
+                         const Vector<T>& y, Vector<T>& x, Matrix<T>& P,
+                         Vector<T>& work)
+      throw(MatrixException)
+   {
+      const size_t m(H.rows()), n(H.cols());
+      if (W.rows() != m || W.cols() != m || y.size() != m ||
+          x.size() != n || P.rows() != n || P.cols() != n ||
+          &work == &x || &work == &y)
+      {
+         MatrixException e("Incompatible arguments for sequentialUpdate()");
+         GPSTK_THROW(e);
+      }
+
+      const T* h(H.begin());
+      const T* wt(W.begin());
+      size_t i, j, k;
+      for (j = 0; j < m; j++)
+         for (i = 0; i < m; i++)
+            if (i != j && wt[i + j*m] != T(0))
+            {
+               MatrixException e("sequentialUpdate requires diagonal weights");
+               GPSTK_THROW(e);
+            }
+
+      work.resize(2*n);
+      T* p(P.begin());
+      T* u(work.begin());                  // P*h^T
+      T* v(u + n);                         // B*h^T
+      for (k = 0; k < m; k++)
+      {
+         const T wk(wt[k + k*m]);
+         if (wk < T(0))
+         {
+            MatrixException e("sequentialUpdate: negative weight");
+            GPSTK_THROW(e);
+         }
+         if (wk == T(0)) continue;
+
+            // u = P*h^T and the innovation, h = row k of H
+         T innov(y[k]);
+         for (i = 0; i < n; i++)
+            u[i] = T(0);
+         for (j = 0; j < n; j++)
+         {
+            const T f(h[k + j*m]);
+            if (f == T(0)) continue;
+            innov -= f*x[j];
+            const T* pj(p + j*n);
+            for (i = 0; i < n; i++)
+               u[i] += pj[i]*f;
+         }
+         const T r(T(1)/wk);
+         T s(r);
+         for (j = 0; j < n; j++)
+         {
+            const T f(h[k + j*m]);
+            if (f != T(0)) s += f*u[j];
+         }
+         if (!(s > T(0)))
+         {
+            MatrixException e("sequentialUpdate: innovation variance <= 0");
+            GPSTK_THROW(e);
+         }
+
+            // gain K = u/s, kept in u; x += K*innov
+         for (i = 0; i < n; i++)
+            u[i] /= s;
+         for (i = 0; i < n; i++)
+            x[i] += u[i]*innov;
+
+            // B = (I-K*h)*P = P - K*(h*P), h*P being u^T before scaling
+         for (j = 0; j < n; j++)
+         {
+            const T hpj(u[j]*s);
+            T* pj(p + j*n);
+            for (i = 0; i < n; i++)
+               pj[i] -= u[i]*hpj;
+         }
+
+            // v = B*h^T
+         for (i = 0; i < n; i++)
+            v[i] = T(0);
+         for (j = 0; j < n; j++)
+         {
+            const T f(h[k + j*m]);
+            if (f == T(0)) continue;
+            const T* pj(p + j*n);
+            for (i = 0; i < n; i++)
+               v[i] += pj[i]*f;
+         }
+
+            // P = B*(I-K*h)^T + r*K*K^T = B - v*K^T + r*K*K^T
+         for (j = 0; j < n; j++)
+         {
+            T* pj(p + j*n);
+            for (i = 0; i < n; i++)
+               pj[i] += (r*u[i] - v[i])*u[j];
+         }
+
+            // symmetric up to round-off: average the two triangles
+         for (j = 0; j < n; j++)
+            for (i = j+1; i < n; i++)
+               p[i + j*n] = p[j + i*n] = (p[i + j*n] + p[j + i*n])/T(2);
+      }
+   }
+
+      /**
+       * Cholesky decomposition A = L*L^T of a symmetric positive definite
+       * matrix, in place: the lower triangle of A is replaced by L (the
+       * upper triangle is not referenced). Same algorithm as CholeskyCrout.
+       * @throw MatrixException if A is not square or not positive definite.
+       */
+   template <class T>
+   void choleskyFactor(Matrix<T>& A)
+      throw(MatrixException)
+   {
+      if (!A.isSquare())
+      {
+         MatrixException e("choleskyFactor requires a square matrix");
+         GPSTK_THROW(e);
+      }
+
+      const size_t n(A.rows());
+      T* a(A.begin());
+      size_t i, j, k;
+      for (j = 0; j < n; j++)
+      {
+         T* aj(a + j*n);
+         T sum(aj[j]);
+         for (k = 0; k < j; k++)
+            sum -= a[j + k*n]*a[j + k*n];
+         if (!(sum > T(0)))
+         {
+            MatrixException e("choleskyFactor fails - eigenvalue <= 0");
+            GPSTK_THROW(e);
+         }
+         aj[j] = SQRT(sum);
+
+            // column j below the diagonal
+         for (k = 0; k < j; k++)
+         {
+            const T f(a[j + k*n]);
+            if (f == T(0)) continue;
+            const T* ak(a + k*n);
+            for (i = j+1; i < n; i++)
+               aj[i] -= ak[i]*f;
+         }
+         const T d(aj[j]);
+         for (i = j+1; i < n; i++)
+            aj[i] /= d;
+      }
+   }
+
+      /**
+       * Solve A*x = b in place (b is replaced by x), given the Cholesky
+       * factor of A from choleskyFactor().
+       * @throw MatrixException if the dimensions do not agree.
+       */
+   template <class T>
+   void choleskySolve(const Matrix<T>& L, Vector<T>& b)
+      throw(MatrixException)
+   {
+      const size_t n(L.rows());
+      if (!L.isSquare() || b.size() != n)
+      {
+         MatrixException e("Incompatible arguments for choleskySolve()");
+         GPSTK_THROW(e);
+      }
+
+      const T* l(L.begin());
+      size_t i, k;
+         // forward substitution, L*z = b
+      for (k = 0; k < n; k++)
+      {
+         const T* lk(l + k*n);
+         b[k] /= lk[k];
+         const T f(b[k]);
+         if (f == T(0)) continue;
+         for (i = k+1; i < n; i++)
+            b[i] -= lk[i]*f;
+      }
+         // back substitution, L^T*x = z
+      for (k = n; k-- > 0; )
+      {
+         const T* lk(l + k*n);
+         T sum(b[k]);
+         for (i = k+1; i < n; i++)
+            sum -= lk[i]*b[i];
+         b[k] = sum/lk[k];
+      }
+   }
+
+      /**
+       * Replace the Cholesky factor L of A (from choleskyFactor()) by the
+       * full, symmetric inverse of A, in place.
+       * @throw MatrixException if L is not square.
+       */
+   template <class T>
+   void choleskyInvert(Matrix<T>& L)
+      throw(MatrixException)
+   {
+      if (!L.isSquare())
+      {
+         MatrixException e("choleskyInvert requires a square matrix");
+         GPSTK_THROW(e);
+      }
+
+      const size_t n(L.rows());
+      T* l(L.begin());
+      size_t i, j, k;
+
+         // L^-1 in place, row by row
+      for (i = 0; i < n; i++)
+      {
+         const T d(T(1)/l[i + i*n]);
+         for (j = 0; j < i; j++)
+         {
+            T sum(0);
+            for (k = j; k < i; k++)
+               sum += l[i + k*n]*l[k + j*n];
+            l[i + j*n] = -sum*d;
+         }
+         l[i + i*n] = d;
+      }
+
+         // A^-1 = L^-T * L^-1, lower triangle in place, row by row; the
+         // diagonal element is needed by the rest of the row, so do it last
+      for (i = 0; i < n; i++)
+      {
+         for (j = 0; j <= i; j++)
+         {
+            T sum(0);
+            for (k = i; k < n; k++)
+               sum += l[k + i*n]*l[k + j*n];
+            l[i + j*n] = sum;
+         }
+      }
+      for (j = 0; j < n; j++)
+         for (i = j+1; i < n; i++)
+            l[j + i*n] = l[i + j*n];
+   }
+
+      //@}
+
+}  // namespace gpstk
+
+#endif
@@ -42,6 +42,7 @@
 #ifndef GPSTK_MISCMATH_HPP
 #define GPSTK_MISCMATH_HPP
 
+#include <algorithm>
 #include <cstring>   // for size_t
 #include <vector>
 #include "MathBase.hpp"
@@ -81,45 +82,67 @@ namespace gpstk
       return Yx;
    }  // end T LagrangeInterpolation(const vector, const vector, const T)
 
-      /// Lagrange interpolation on data (X[i],Y[i]), i=0,N-1 to compute Y(x).
-      /// Also return an estimate of the estimation error in 'err'.
-      /// This routine assumes that N=X.size() is even and that x is centered on the
-      /// interval, that is X[N/2-1] <= x <= X[N/2].
-      /// @note This routine will work for N as small as 4, however tests with satellite
-      /// ephemerides have shown that N=4 yields m-level errors, N=6 cm-level,
-      /// N=8 ~0.1mm level and N=10 ~numerical noise errors; best to use N>=8.
+      /// Largest N for which the pointer versions of LagrangeInterpolation()
+      /// work in arrays on the stack; they allocate for larger ones.
+   const std::size_t LAGRANGE_STACK_N = 20;
+
+      /// Lagrange interpolation on data (X[i],Y[i]), i=0,N-1 to compute Y(x), as
+      /// LagrangeInterpolation(X,Y,x,err) below; X and Y may point into longer
+      /// tables, e.g. the window of a table that need not be copied.
    template <class T>
-   T LagrangeInterpolation(const std::vector<T>& X, const std::vector<T>& Y,
+   T LagrangeInterpolation(const T *X, const T *Y, std::size_t N,
                            const T& x, T& err) throw(Exception)
    {
-      if(Y.size() < X.size() || X.size() < 4) {
-         GPSTK_THROW(Exception("Input vectors must be of same length, at least 4"));
+      if(N < 4) {
+         GPSTK_THROW(Exception("Input length must be at least 4"));
       }
 
       std::size_t i,j,k;
       T y,del;
-      std::vector<T> D,Q;
+      T Dbuf[LAGRANGE_STACK_N],Qbuf[LAGRANGE_STACK_N],*D(Dbuf),*Q(Qbuf);
+      std::vector<T> Dv,Qv;
 
       err = T(0);
-      k = X.size()/2;
+      k = N/2;
       if(x == X[k]) return Y[k];
       if(x == X[k-1]) return Y[k-1];
       if(ABS(x-X[k-1]) < ABS(x-X[k])) k=k-1;
-      for(i=0; i<X.size(); i++) {
-         Q.push_back(Y[i]);
-         D.push_back(Y[i]);
+      if(N > LAGRANGE_STACK_N) {
+         Dv.resize(N); D = &Dv[0];
+         Qv.resize(N); Q = &Qv[0];
+      }
+      for(i=0; i<N; i++) {
+         Q[i] = Y[i];
+         D[i] = Y[i];
       }
       y = Y[k--];
-      for(j=1; j<X.size(); j++) {
-         for(i=0; i<X.size()-j; i++) {
+      for(j=1; j<N; j++) {
+         for(i=0; i<N-j; i++) {
             del = (Q[i+1]-D[i])/(X[i]-X[i+j]);
             D[i] = (X[i+j]-x)*del;
             Q[i] = (X[i]-x)*del;
          }
-         err = (2*(k+1) < X.size()-j ? Q[k+1] : D[k--]);    // NOT 2*k
+         err = (2*(k+1) < N-j ? Q[k+1] : D[k--]);    // NOT 2*k
          y += err;
       }
       return y;
+   }  // end T LagrangeInterpolation(const T*, const T*, size_t, const T, T&)
+
+      /// Lagrange interpolation on data (X[i],Y[i]), i=0,N-1 to compute Y(x).
+      /// Also return an estimate of the estimation error in 'err'.
+      /// This routine assumes that N=X.size() is even and that x is centered on the
+      /// interval, that is X[N/2-1] <= x <= X[N/2].
+      /// @note This routine will work for N as small as 4, however tests with satellite
+      /// ephemerides have shown that N=4 yields m-level errors, N=6 cm-level,
+      /// N=8 ~0.1mm level and N=10 ~numerical noise errors; best to use N>=8.
+   template <class T>
+   T LagrangeInterpolation(const std::vector<T>& X, const std::vector<T>& Y,
+                           const T& x, T& err) throw(Exception)
+   {
+      if(Y.size() < X.size() || X.size() < 4) {
+         GPSTK_THROW(Exception("Input vectors must be of same length, at least 4"));
+      }
+      return LagrangeInterpolation(&X[0], &Y[0], X.size(), x, err);
    }  // end T LagrangeInterpolation(vector, vector, const T, T&)
 
       // The following is a
@@ -136,22 +159,30 @@ namespace gpstk
       // Qij is symmetric, there are only N(N+1)/2 - N of them, so store them
       // in a vector of length N(N+1)/2, where Qij==Q[i+j*(j+1)/2] (ignore i=j).
 
-      /// Perform Lagrange interpolation on the data (X[i],Y[i]), i=1,N (N=X.size()),
-      /// returning the value of Y(x) and dY(x)/dX.
-      /// Assumes that x is between X[k-1] and X[k], where k=N/2 and N > 2;
-      /// Warning: for use with the precise (SP3) ephemeris only when velocity is not
-      /// available; estimates of velocity, and especially clock drift, not as accurate.
+      /// Lagrange interpolation on the N values at X and Y, returning Y(x) and
+      /// dY(x)/dX, as LagrangeInterpolation(X,Y,x,y,dydx) below.
    template <class T>
-   void LagrangeInterpolation(const std::vector<T>& X, const std::vector<T>& Y,
+   void LagrangeInterpolation(const T *X, const T *Y, std::size_t N,
                               const T& x, T& y, T& dydx) throw(Exception)
    {
-      if(Y.size() < X.size() || X.size() < 4) {
-         GPSTK_THROW(Exception("Input vectors must be of same length, at least 4"));
+      if(N < 4) {
+         GPSTK_THROW(Exception("Input length must be at least 4"));
       }
 
-      std::size_t i,j,k,N=X.size(),M;
+      std::size_t i,j,k,M;
       M = (N*(N+1))/2;
-      std::vector<T> P(N,T(1)),Q(M,T(1)),D(N,T(1));
+      T Pbuf[LAGRANGE_STACK_N],Dbuf[LAGRANGE_STACK_N],
+        Qbuf[(LAGRANGE_STACK_N*(LAGRANGE_STACK_N+1))/2];
+      T *P(Pbuf),*Q(Qbuf),*D(Dbuf);
+      std::vector<T> Pv,Qv,Dv;
+      if(N > LAGRANGE_STACK_N) {
+         Pv.resize(N); P = &Pv[0];
+         Qv.resize(M); Q = &Qv[0];
+         Dv.resize(N); D = &Dv[0];
+      }
+      std::fill(P, P+N, T(1));
+      std::fill(Q, Q+M, T(1));
+      std::fill(D, D+N, T(1));
       for(i=0; i<N; i++) {
          for(j=0; j<N; j++) {
             if(i != j) {
@@ -176,6 +207,21 @@ namespace gpstk
             }
          dydx += Y[i]*S;
       }
+   }  // end void LagrangeInterpolation(const T*, const T*, size_t, const T, T&, T&)
+
+      /// Perform Lagrange interpolation on the data (X[i],Y[i]), i=1,N (N=X.size()),
+      /// returning the value of Y(x) and dY(x)/dX.
+      /// Assumes that x is between X[k-1] and X[k], where k=N/2 and N > 2;
+      /// Warning: for use with the precise (SP3) ephemeris only when velocity is not
+      /// available; estimates of velocity, and especially clock drift, not as accurate.
+   template <class T>
+   void LagrangeInterpolation(const std::vector<T>& X, const std::vector<T>& Y,
+                              const T& x, T& y, T& dydx) throw(Exception)
+   {
+      if(Y.size() < X.size() || X.size() < 4) {
+         GPSTK_THROW(Exception("Input vectors must be of same length, at least 4"));
+      }
+      LagrangeInterpolation(&X[0], &Y[0], X.size(), x, y, dydx);
    }  // end void LagrangeInterpolation(vector, vector, const T, T&, T&)
 
 
@@ -79,10 +79,10 @@ namespace gpstk
       typedef const T* const_iterator;
 
          /// Default constructor
-      Vector() : v(NULL), s(0)
+      Vector() : v(NULL), s(0), cap(0)
       {}
          /// Constructor given an initial size.
-      Vector(size_t siz) : v(NULL), s(siz)
+      Vector(size_t siz) : v(NULL), s(siz), cap(siz)
       {
          if (siz>0)
          {
@@ -97,7 +97,7 @@ namespace gpstk
           * Constructor given an initial size and default value for
           * all elements.
           */
-      Vector(size_t siz, const T defaultValue) : v(NULL), s(siz)
+      Vector(size_t siz, const T defaultValue) : v(NULL), s(siz), cap(siz)
       {
          if (siz>0)
          {
@@ -113,7 +113,7 @@ namespace gpstk
           * Copy constructor from a ConstVectorBase type.
           */
       template <class E>
-      Vector(const ConstVectorBase<T, E>& r) : v(NULL), s(r.size())
+      Vector(const ConstVectorBase<T, E>& r) : v(NULL), s(r.size()), cap(r.size())
       {
          if (r.size()>0)
          {
@@ -128,7 +128,7 @@ namespace gpstk
          /**
           * Copy constructor.
           */
-      Vector(const Vector& r) : v(NULL), s(r.s)
+      Vector(const Vector& r) : v(NULL), s(r.s), cap(r.s)
       {
          if (r.s>0)
          {
@@ -143,7 +143,7 @@ namespace gpstk
          /**
           * Valarray constructor
           */
-      Vector(const std::valarray<T>& r) : v(NULL), s(r.size())
+      Vector(const std::valarray<T>& r) : v(NULL), s(r.size()), cap(r.size())
       {
          if (r.size())
          {
@@ -160,7 +160,7 @@ namespace gpstk
       template <class E>
       Vector(const ConstVectorBase<T, E>& vec,
              size_t top,
-             size_t num) : v(NULL), s(0)
+             size_t num) : v(NULL), s(0), cap(0)
       {
             // sanity checks...
          if ( top >= vec.size() || 
@@ -179,7 +179,7 @@ namespace gpstk
             size_t i;
             for(i = 0; i < num; i++)
                v[i] = vec(top+i);
-            s = num;
+            s = cap = num;
          }
       }
    
@@ -268,11 +268,13 @@ namespace gpstk
          return (*this); 
       }
 
-         /// Resizes the vector.  if index > size, the vector will be
-         /// erased and the contents destroyed.
+         /// Resizes the vector.  if index > capacity(), the vector will be
+         /// erased and the contents destroyed; otherwise the storage is
+         /// reused, so that working vectors cost no allocation once they
+         /// have reached their largest size.
       Vector& resize(const size_t index)
       { 
-         if (index > s)
+         if (index > cap)
          {
             if (v)
                delete [] v;
@@ -281,11 +283,28 @@ namespace gpstk
                VectorException e("Vector.resize(size_t) failed to allocate");
                GPSTK_THROW(e);
             }
+            cap = index;
          }
          s = index;
          return *this;
       }
 
+         /// Make room for at least n elements, without changing size().
+         /// The contents are destroyed if the storage has to grow.
+      Vector& reserve(const size_t n)
+      {
+         if (n > cap)
+         {
+            size_t siz(s);
+            resize(n);
+            s = siz;
+         }
+         return *this;
+      }
+
+         /// Number of elements the storage can hold without reallocation.
+      size_t capacity() const { return cap; }
+
          /// resize with new default value
       Vector& resize(const size_t index, const T defaultValue)
       {
@@ -381,6 +400,8 @@ namespace gpstk
       T* v;
          /// The size of the vector.
       size_t s;
+         /// The number of elements allocated, >= s.
+      size_t cap;
    };
       // end class Vector<T>
 
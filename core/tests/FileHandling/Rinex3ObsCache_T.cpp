@@ -0,0 +1,324 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Rinex3ObsCacheStream.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsData.hpp"
+#include "build_config.h"
+
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+   /// Check that the records written to a Rinex3ObsCacheStream are read
+   /// back unchanged.
+class Rinex3ObsCache_T
+{
+public:
+   Rinex3ObsCache_T()
+   {
+      dataFilePath = getPathData() + getFileSep();
+      tempFilePath = getPathTestTemp() + getFileSep();
+   }
+
+      /// write and read back RINEX 3 and RINEX 2 files
+   unsigned roundTripTest();
+      /// values that are not multiples of 0.001, and blanks
+   unsigned valueTest();
+      /// truncated caches and files that are not caches
+   unsigned errorTest();
+
+private:
+      /** Write the records of 'file' to a cache with blocks of
+       * 'blockSize' epochs, read them back and compare them.
+       * @return the number of records */
+   unsigned roundTrip(TestUtil& testFramework, const string& file,
+                      size_t blockSize);
+
+      /// true if 'a' and 'b' are the same record
+   bool sameRecord(const Rinex3ObsData& a, const Rinex3ObsData& b);
+
+   string dataFilePath;
+   string tempFilePath;
+};
+
+
+bool Rinex3ObsCache_T ::
+sameRecord(const Rinex3ObsData& a, const Rinex3ObsData& b)
+{
+   if (a.time != b.time || a.epochFlag != b.epochFlag ||
+       a.clockOffset != b.clockOffset || a.obs.size() != b.obs.size())
+      return false;
+      // the auxiliary headers of the events are not kept
+   if ((a.epochFlag < 2 || a.epochFlag > 5) && a.numSVs != b.numSVs)
+      return false;
+
+   Rinex3ObsData::DataMap::const_iterator ia = a.obs.begin();
+   Rinex3ObsData::DataMap::const_iterator ib = b.obs.begin();
+   for (; ia != a.obs.end(); ++ia, ++ib)
+   {
+      if (ia->first != ib->first || ia->second.size() != ib->second.size())
+         return false;
+      for (size_t i = 0; i < ia->second.size(); i++)
+      {
+         const RinexDatum& da = ia->second[i];
+         const RinexDatum& db = ib->second[i];
+            // the values must be the same bits, not only close
+         if (da.data != db.data ||
+             std::signbit(da.data) != std::signbit(db.data) ||
+             da.dataBlank != db.dataBlank ||
+             da.lli != db.lli || da.lliBlank != db.lliBlank ||
+             da.ssi != db.ssi || da.ssiBlank != db.ssiBlank)
+            return false;
+      }
+   }
+   return true;
+}
+
+
+unsigned Rinex3ObsCache_T ::
+roundTrip(TestUtil& testFramework, const string& file, size_t blockSize)
+{
+   string cache = tempFilePath + "test_output_rinex3_obs_cache.obc";
+
+   vector<Rinex3ObsData> records;
+   Rinex3ObsHeader hdr;
+   {
+      Rinex3ObsStream strm(file.c_str());
+      strm >> hdr;
+      Rinex3ObsData rod;
+      while (strm >> rod)
+         records.push_back(rod);
+   }
+
+   {
+      Rinex3ObsCacheStream out(cache.c_str(), ios::out);
+      out.setBlockSize(blockSize);
+      out << hdr;
+      for (size_t i = 0; i < records.size(); i++)
+         out << records[i];
+   }
+   TUASSERT(Rinex3ObsCacheStream::isCacheFile(cache));
+   TUASSERT(!Rinex3ObsCacheStream::isCacheFile(file));
+
+      // read through a reference to the base class, as the tools do
+   Rinex3ObsCacheStream cacheStrm(cache.c_str());
+   Rinex3ObsStream& in = cacheStrm;
+   Rinex3ObsHeader cacheHdr;
+   in >> cacheHdr;
+   TUASSERTFE(hdr.version, cacheHdr.version);
+   TUASSERTE(size_t, hdr.mapObsTypes.size(), cacheHdr.mapObsTypes.size());
+
+   Rinex3ObsData rod;
+   unsigned count(0), mismatches(0);
+   while (in >> rod)
+   {
+      if (count >= records.size())
+      {
+         TUFAIL("Extra record in the cache of " + file);
+         break;
+      }
+      if (!sameRecord(records[count], rod))
+         mismatches++;
+      count++;
+   }
+   TUASSERT(in.eof());
+   TUASSERTE(size_t, records.size(), count);
+   TUASSERTE(unsigned, 0, mismatches);
+
+   return count;
+}
+
+
+unsigned Rinex3ObsCache_T ::
+roundTripTest()
+{
+   TUDEF("Rinex3ObsCacheStream", "getObsData");
+
+   const char* files[] = { "test_input_rinex3_76193040.14o",
+                           "test_input_rinex3_obs_RinexObsFile.15o",
+                           "test_input_rinex3_obs_SystemMixed.15o",
+                           "test_input_rinex2_obs_RinexObsFile.06o" };
+   for (unsigned f = 0; f < 4; f++)
+   {
+      string file = dataFilePath + files[f];
+      TUASSERT(roundTrip(testFramework, file, 1) > 0);
+      TUASSERT(roundTrip(testFramework, file, 7) > 0);
+      TUASSERT(roundTrip(testFramework, file, 120) > 0);
+   }
+
+      // the cache must be smaller than the RINEX file
+   string file = dataFilePath + "test_input_rinex3_76193040.14o";
+   string cache = tempFilePath + "test_output_rinex3_obs_cache.obc";
+   roundTrip(testFramework, file, 120);
+   ifstream ifsFile(file.c_str(), ios::binary | ios::ate);
+   ifstream ifsCache(cache.c_str(), ios::binary | ios::ate);
+   TUASSERT(ifsCache.tellg() < ifsFile.tellg() / 2);
+
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsCache_T ::
+valueTest()
+{
+   TUDEF("Rinex3ObsCacheStream", "putObsData");
+
+   string file = dataFilePath + "test_input_rinex3_76193040.14o";
+   string cache = tempFilePath + "test_output_rinex3_obs_cache_values.obc";
+
+   Rinex3ObsStream strm(file.c_str());
+   Rinex3ObsHeader hdr;
+   Rinex3ObsData rod;
+   strm >> hdr;
+   strm >> rod;
+
+      // replace the values of the first satellite
+   const double values[] = { 1.0/3.0, -0.0, 1.0e20, -123456789.123,
+                             0.0005, 1.0e-300 };
+   const unsigned numValues = sizeof(values) / sizeof(values[0]);
+   vector<RinexDatum>& data = rod.obs.begin()->second;
+   for (size_t i = 0; i < data.size(); i++)
+   {
+      data[i].dataBlank = (i == 2);
+         // blanks are read as zero, as from RINEX
+      data[i].data = data[i].dataBlank ? 0. : values[i % numValues];
+      data[i].lliBlank = (i % 2 == 0);
+      data[i].lli = data[i].lliBlank ? 0 : 1;
+      data[i].ssiBlank = (i % 3 == 0);
+      data[i].ssi = data[i].ssiBlank ? 0 : 9;
+   }
+   rod.clockOffset = 1.25e-4;
+
+   {
+      Rinex3ObsCacheStream out(cache.c_str(), ios::out);
+      out << hdr;
+      out << rod;
+   }
+
+   Rinex3ObsCacheStream in(cache.c_str());
+   Rinex3ObsHeader cacheHdr;
+   Rinex3ObsData cacheRod;
+   in >> cacheHdr;
+   in >> cacheRod;
+   TUASSERT(in.good());
+   TUASSERT(sameRecord(rod, cacheRod));
+   TUASSERT(!(in >> cacheRod));
+
+      // an LLI that does not fit in the cache
+   data[0].lliBlank = false;
+   data[0].lli = 16;
+   Rinex3ObsCacheStream out(cache.c_str(), ios::out);
+   out << hdr;
+   try
+   {
+      out << rod;
+      out.writeBlock();
+      TUFAIL("no exception for an LLI out of range");
+   }
+   catch (FFStreamError&)
+   {
+      TUPASS("LLI out of range");
+   }
+
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsCache_T ::
+errorTest()
+{
+   TUDEF("Rinex3ObsCacheStream", "getObsData");
+
+   string file = dataFilePath + "test_input_rinex3_76193040.14o";
+   string cache = tempFilePath + "test_output_rinex3_obs_cache.obc";
+   string cut = tempFilePath + "test_output_rinex3_obs_cache_cut.obc";
+   roundTrip(testFramework, file, 120);
+
+      // cut the last block in half
+   {
+      ifstream ifs(cache.c_str(), ios::binary);
+      string bytes((istreambuf_iterator<char>(ifs)),
+                   istreambuf_iterator<char>());
+      ofstream ofs(cut.c_str(), ios::binary);
+      ofs.write(bytes.data(), bytes.size() - 100);
+   }
+
+   Rinex3ObsCacheStream in(cut.c_str());
+   in.exceptions(ios::failbit);
+   Rinex3ObsHeader hdr;
+   Rinex3ObsData rod;
+   in >> hdr;
+   bool threw(false);
+   try
+   {
+      while (in >> rod)
+         ;
+   }
+   catch (FFStreamError&)
+   {
+      threw = true;
+   }
+   TUASSERT(threw);
+
+   TUASSERT(!Rinex3ObsCacheStream::isCacheFile(dataFilePath +
+                                               "no_such_file.obc"));
+
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   Rinex3ObsCache_T testClass;
+
+   errorTotal += testClass.roundTripTest();
+   errorTotal += testClass.valueTest();
+   errorTotal += testClass.errorTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return( errorTotal );
+}
@@ -0,0 +1,303 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Rinex3ObsMappedReader.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsData.hpp"
+#include "build_config.h"
+
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+   /// Check that Rinex3ObsMappedReader reads the same records as
+   /// Rinex3ObsStream.
+class Rinex3ObsMapped_T
+{
+public:
+   Rinex3ObsMapped_T()
+   {
+      dataFilePath = getPathData() + getFileSep();
+      tempFilePath = getPathTestTemp() + getFileSep();
+   }
+
+      /// read RINEX 3 and RINEX 2 files with both readers
+   unsigned compareTest();
+      /// the same file with CR LF line ends
+   unsigned crlfTest();
+      /// errors in the records
+   unsigned errorTest();
+      /// reading again from a saved position
+   unsigned positionTest();
+
+private:
+      /// compare all the records of 'file', return the number of records
+   unsigned compareFile(TestUtil& testFramework, const string& file);
+
+      /// true if 'a' and 'b' are the same record
+   bool sameRecord(const Rinex3ObsData& a, const Rinex3ObsData& b);
+
+   string dataFilePath;
+   string tempFilePath;
+};
+
+
+bool Rinex3ObsMapped_T ::
+sameRecord(const Rinex3ObsData& a, const Rinex3ObsData& b)
+{
+   if (a.time != b.time || a.epochFlag != b.epochFlag ||
+       a.numSVs != b.numSVs || a.clockOffset != b.clockOffset ||
+       a.obs.size() != b.obs.size() ||
+       a.auxHeader.valid != b.auxHeader.valid)
+      return false;
+
+   Rinex3ObsData::DataMap::const_iterator ia = a.obs.begin();
+   Rinex3ObsData::DataMap::const_iterator ib = b.obs.begin();
+   for (; ia != a.obs.end(); ++ia, ++ib)
+   {
+      if (ia->first != ib->first || ia->second.size() != ib->second.size())
+         return false;
+      for (size_t i = 0; i < ia->second.size(); i++)
+      {
+         const RinexDatum& da = ia->second[i];
+         const RinexDatum& db = ib->second[i];
+            // the values must be the same bits, not only close
+         if (da.data != db.data || da.dataBlank != db.dataBlank ||
+             da.lli != db.lli || da.lliBlank != db.lliBlank ||
+             da.ssi != db.ssi || da.ssiBlank != db.ssiBlank)
+            return false;
+      }
+   }
+   return true;
+}
+
+
+unsigned Rinex3ObsMapped_T ::
+compareFile(TestUtil& testFramework, const string& file)
+{
+   Rinex3ObsStream strm(file.c_str());
+   Rinex3ObsHeader hdr;
+   strm >> hdr;
+   Rinex3ObsMappedReader reader(file);
+   TUASSERTFE(hdr.version, reader.getHeader().version);
+
+   Rinex3ObsData rodStrm, rodMapped;
+   unsigned count(0), mismatches(0);
+   while (strm >> rodStrm)
+   {
+      if (!reader.read(rodMapped))
+      {
+         TUFAIL("Missing record " + StringUtils::asString(count) +
+                " in " + file);
+         return count;
+      }
+      if (!sameRecord(rodStrm, rodMapped))
+         mismatches++;
+      count++;
+   }
+   TUASSERT(!reader.read(rodMapped));
+   TUASSERTE(unsigned, 0, mismatches);
+   return count;
+}
+
+
+unsigned Rinex3ObsMapped_T ::
+compareTest()
+{
+   TUDEF("Rinex3ObsMappedReader", "read");
+
+   TUASSERT(compareFile(testFramework,
+      dataFilePath + "test_input_rinex3_76193040.14o") > 0);
+   TUASSERT(compareFile(testFramework,
+      dataFilePath + "test_input_rinex3_obs_RinexObsFile.15o") > 0);
+   TUASSERT(compareFile(testFramework,
+      dataFilePath + "test_input_rinex3_obs_SystemMixed.15o") > 0);
+      // RINEX 2, read by the stream
+   TUASSERT(compareFile(testFramework,
+      dataFilePath + "test_input_rinex2_obs_RinexObsFile.06o") > 0);
+
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsMapped_T ::
+crlfTest()
+{
+   TUDEF("Rinex3ObsMappedReader", "read");
+
+   string in = dataFilePath + "test_input_rinex3_76193040.14o";
+   string out = tempFilePath + "test_output_rinex3_obs_mapped_crlf.14o";
+   {
+      ifstream ifs(in.c_str());
+      ofstream ofs(out.c_str(), ios::binary);
+      string line;
+      while (getline(ifs, line))
+         ofs << line << "\r\n";
+   }
+
+   Rinex3ObsStream strm(in.c_str());
+   Rinex3ObsMappedReader reader(out);
+   Rinex3ObsData rodStrm, rodMapped;
+   unsigned mismatches(0);
+   while (strm >> rodStrm)
+   {
+      TUASSERT(reader.read(rodMapped));
+      if (!sameRecord(rodStrm, rodMapped))
+         mismatches++;
+   }
+   TUASSERT(!reader.read(rodMapped));
+   TUASSERTE(unsigned, 0, mismatches);
+
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsMapped_T ::
+errorTest()
+{
+   TUDEF("Rinex3ObsMappedReader", "read");
+
+   const char* files[] = { "test_input_rinex3_obs_BadEpochFlag.15o",
+                           "test_input_rinex3_obs_InvalidTimeFormat.15o" };
+   for (unsigned f = 0; f < 2; f++)
+   {
+      string file = dataFilePath + files[f];
+
+         // number of records read by the stream before the error
+      Rinex3ObsStream strm(file.c_str());
+      Rinex3ObsData rod;
+      unsigned numGood(0);
+      while (strm >> rod)
+         numGood++;
+      TUASSERT(!strm.eof());
+
+      Rinex3ObsMappedReader reader(file);
+      unsigned numRead(0);
+      bool threw(false);
+      try
+      {
+         while (reader.read(rod))
+            numRead++;
+      }
+      catch (FFStreamError&)
+      {
+         threw = true;
+      }
+      TUASSERT(threw);
+      TUASSERTE(unsigned, numGood, numRead);
+   }
+
+   try
+   {
+      Rinex3ObsMappedReader reader(dataFilePath + "no_such_file.15o");
+      TUFAIL("no exception for a missing file");
+   }
+   catch (FileMissingException&)
+   {
+      TUPASS("missing file");
+   }
+
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsMapped_T ::
+positionTest()
+{
+   TUDEF("Rinex3ObsMappedReader", "setPosition");
+
+   Rinex3ObsMappedReader reader(dataFilePath +
+                                "test_input_rinex3_76193040.14o");
+   TUASSERTE(size_t, reader.getDataStart(), reader.getPosition());
+
+   vector<size_t> positions;
+   vector<Rinex3ObsData> records;
+   Rinex3ObsData rod;
+   for (;;)
+   {
+      size_t p = reader.getPosition();
+      if (!reader.read(rod))
+         break;
+      positions.push_back(p);
+      records.push_back(rod);
+   }
+   TUASSERTE(size_t, reader.size(), reader.getPosition());
+
+      // backwards, every record on its own
+   unsigned mismatches(0);
+   for (size_t i = positions.size(); i-- > 0; )
+   {
+      reader.setPosition(positions[i]);
+      TUASSERT(reader.read(rod));
+      if (!sameRecord(records[i], rod))
+         mismatches++;
+   }
+   TUASSERTE(unsigned, 0, mismatches);
+
+   try
+   {
+      reader.setPosition(reader.size() + 1);
+      TUFAIL("no exception for a position past the end");
+   }
+   catch (InvalidRequest&)
+   {
+      TUPASS("position past the end");
+   }
+
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   Rinex3ObsMapped_T testClass;
+
+   errorTotal += testClass.compareTest();
+   errorTotal += testClass.crlfTest();
+   errorTotal += testClass.errorTest();
+   errorTotal += testClass.positionTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return( errorTotal );
+}
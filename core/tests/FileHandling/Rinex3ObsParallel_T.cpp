@@ -0,0 +1,360 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Rinex3ObsIndex.hpp"
+#include "Rinex3ObsParallelReader.hpp"
+#include "Rinex3ObsMappedReader.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsData.hpp"
+#include "build_config.h"
+
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+   /// Check the index and the records of Rinex3ObsParallelReader against
+   /// a sequential read of the same file.
+class Rinex3ObsParallel_T
+{
+public:
+   Rinex3ObsParallel_T()
+   {
+      dataFilePath = getPathData() + getFileSep();
+      tempFilePath = getPathTestTemp() + getFileSep();
+   }
+
+      /// offsets and times of the index, and its sidecar file
+   unsigned indexTest();
+      /// all the records, with several threads and chunk sizes
+   unsigned readTest();
+      /// time windows
+   unsigned windowTest();
+      /// a record that is not valid
+   unsigned errorTest();
+
+private:
+      /// all the records of 'file', read sequentially
+   void readAll(const string& file, vector<Rinex3ObsData>& records);
+
+      /// true if 'a' and 'b' are the same record
+   bool sameRecord(const Rinex3ObsData& a, const Rinex3ObsData& b);
+
+      /// number of 'records' from 'b' differing from what 'reader' reads
+   unsigned compare(Rinex3ObsParallelReader& reader,
+                    const vector<Rinex3ObsData>& records, size_t b,
+                    size_t& count);
+
+   string dataFilePath;
+   string tempFilePath;
+};
+
+
+bool Rinex3ObsParallel_T ::
+sameRecord(const Rinex3ObsData& a, const Rinex3ObsData& b)
+{
+   if (a.time != b.time || a.epochFlag != b.epochFlag ||
+       a.numSVs != b.numSVs || a.clockOffset != b.clockOffset ||
+       a.obs.size() != b.obs.size())
+      return false;
+
+   Rinex3ObsData::DataMap::const_iterator ia = a.obs.begin();
+   Rinex3ObsData::DataMap::const_iterator ib = b.obs.begin();
+   for (; ia != a.obs.end(); ++ia, ++ib)
+   {
+      if (ia->first != ib->first || ia->second.size() != ib->second.size())
+         return false;
+      for (size_t i = 0; i < ia->second.size(); i++)
+      {
+         if (ia->second[i].data != ib->second[i].data ||
+             ia->second[i].lli != ib->second[i].lli ||
+             ia->second[i].ssi != ib->second[i].ssi)
+            return false;
+      }
+   }
+   return true;
+}
+
+
+void Rinex3ObsParallel_T ::
+readAll(const string& file, vector<Rinex3ObsData>& records)
+{
+   Rinex3ObsMappedReader reader(file);
+   Rinex3ObsData rod;
+   while (reader.read(rod))
+      records.push_back(rod);
+}
+
+
+unsigned Rinex3ObsParallel_T ::
+compare(Rinex3ObsParallelReader& reader,
+        const vector<Rinex3ObsData>& records, size_t b, size_t& count)
+{
+   unsigned mismatches(0);
+   count = 0;
+   for (Rinex3ObsParallelReader::iterator it = reader.begin();
+        it != reader.end(); ++it)
+   {
+      if (b + count >= records.size() || !sameRecord(records[b+count], *it))
+         mismatches++;
+      count++;
+   }
+   return mismatches;
+}
+
+
+unsigned Rinex3ObsParallel_T ::
+indexTest()
+{
+   TUDEF("Rinex3ObsIndex", "build");
+
+   string file = dataFilePath + "test_input_rinex3_76193040.14o";
+   Rinex3ObsIndex index;
+   index.build(file);
+
+   Rinex3ObsMappedReader reader(file);
+   Rinex3ObsData rod;
+   vector<size_t> offsets;
+   vector<CommonTime> times;
+   for (size_t p = reader.getPosition(); reader.read(rod);
+        p = reader.getPosition())
+   {
+      offsets.push_back(p);
+      times.push_back(rod.time);
+   }
+   TUASSERTE(size_t, offsets.size(), index.size());
+   unsigned mismatches(0);
+   for (size_t i = 0; i < offsets.size() && i < index.size(); i++)
+   {
+      if (index[i].offset != offsets[i] || index[i].time != times[i])
+         mismatches++;
+   }
+   TUASSERTE(unsigned, 0, mismatches);
+   TUASSERTE(size_t, reader.size(), index.getEndOffset());
+
+   TUASSERTE(size_t, 0, index.lowerBound(CommonTime::BEGINNING_OF_TIME));
+   TUASSERTE(size_t, index.size(), index.upperBound(CommonTime::END_OF_TIME));
+   TUASSERTE(size_t, 10, index.lowerBound(times[10]));
+   TUASSERTE(size_t, 11, index.upperBound(times[10]));
+
+      // seeking a stream
+   testFramework.changeSourceMethod("seek");
+   Rinex3ObsStream strm(file.c_str());
+   Rinex3ObsHeader hdr;
+   strm >> hdr;
+   TUASSERT(Rinex3ObsIndex::seek(strm, times[10]));
+   strm >> rod;
+   TUASSERTE(CommonTime, times[10], rod.time);
+
+      // the sidecar of a copy of the file
+   testFramework.changeSourceMethod("open");
+   string copy = tempFilePath + "test_output_rinex3_obs_index.14o";
+   {
+      ifstream ifs(file.c_str(), ios::binary);
+      ofstream ofs(copy.c_str(), ios::binary);
+      ofs << ifs.rdbuf();
+   }
+   remove(Rinex3ObsIndex::sidecarName(copy).c_str());
+   Rinex3ObsIndex built;
+   built.open(copy);
+   TUASSERT(ifstream(Rinex3ObsIndex::sidecarName(copy).c_str()).good());
+   Rinex3ObsIndex loaded;
+   TUASSERT(loaded.load(copy, Rinex3ObsIndex::sidecarName(copy)));
+   TUASSERTE(size_t, index.size(), loaded.size());
+   TUASSERTE(size_t, index.getEndOffset(), loaded.getEndOffset());
+   mismatches = 0;
+   for (size_t i = 0; i < index.size() && i < loaded.size(); i++)
+   {
+      if (loaded[i].offset != index[i].offset ||
+          loaded[i].time != index[i].time)
+         mismatches++;
+   }
+   TUASSERTE(unsigned, 0, mismatches);
+
+      // out of date once the file changes
+   {
+      ofstream ofs(copy.c_str(), ios::app);
+      ofs << endl;
+   }
+   TUASSERT(!loaded.load(copy, Rinex3ObsIndex::sidecarName(copy)));
+
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsParallel_T ::
+readTest()
+{
+   TUDEF("Rinex3ObsParallelReader", "read");
+
+   const char* files[] = { "test_input_rinex3_76193040.14o",
+                           "test_input_rinex3_obs_RinexObsFile.15o",
+                           "test_input_rinex2_obs_RinexObsFile.06o" };
+   const unsigned threads[] = { 1, 2, 4 };
+   const size_t chunks[] = { 1, 7, 64, 1000 };
+
+   for (unsigned f = 0; f < 3; f++)
+   {
+      string file = dataFilePath + files[f];
+      vector<Rinex3ObsData> records;
+      readAll(file, records);
+      TUASSERT(records.size() > 0);
+
+      for (unsigned t = 0; t < 3; t++)
+      {
+         for (unsigned c = 0; c < 4; c++)
+         {
+            Rinex3ObsParallelReader reader(file, threads[t], false);
+            reader.setChunkSize(chunks[c]);
+            size_t count;
+            TUASSERTE(unsigned, 0, compare(reader, records, 0, count));
+            TUASSERTE(size_t, records.size(), count);
+         }
+      }
+   }
+
+      // stopped before the end
+   {
+      Rinex3ObsParallelReader reader(dataFilePath +
+                                     "test_input_rinex3_76193040.14o", 4,
+                                     false);
+      reader.setChunkSize(3);
+      Rinex3ObsData rod;
+      TUASSERT(reader.read(rod));
+      TUASSERT(reader.read(rod));
+   }
+
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsParallel_T ::
+windowTest()
+{
+   TUDEF("Rinex3ObsParallelReader", "setWindow");
+
+   string file = dataFilePath + "test_input_rinex3_76193040.14o";
+   vector<Rinex3ObsData> records;
+   readAll(file, records);
+
+   Rinex3ObsParallelReader reader(file, 2, false);
+   reader.setChunkSize(10);
+   reader.setWindow(records[100].time, records[200].time);
+   size_t count;
+   TUASSERTE(unsigned, 0, compare(reader, records, 100, count));
+   TUASSERTE(size_t, 101, count);
+
+   try
+   {
+      reader.setWindow(records[0].time, records[1].time);
+      TUFAIL("no exception once the reading has started");
+   }
+   catch (InvalidRequest&)
+   {
+      TUPASS("window set after the start");
+   }
+
+      // nothing in the window
+   Rinex3ObsParallelReader empty(file, 2, false);
+   empty.setWindow(CommonTime::END_OF_TIME, CommonTime::END_OF_TIME);
+   TUASSERT(empty.begin() == empty.end());
+
+   TURETURN();
+}
+
+
+unsigned Rinex3ObsParallel_T ::
+errorTest()
+{
+   TUDEF("Rinex3ObsParallelReader", "read");
+
+   string file = dataFilePath + "test_input_rinex3_obs_BadEpochFlag.15o";
+
+   Rinex3ObsMappedReader seq(file);
+   Rinex3ObsData rod;
+   unsigned numGood(0);
+   try
+   {
+      while (seq.read(rod))
+         numGood++;
+      TUFAIL("no error in " + file);
+   }
+   catch (FFStreamError&)
+   {
+   }
+
+      // the index stops at the error, then the tail reader finds it
+   Rinex3ObsParallelReader reader(file, 2, false);
+   reader.setChunkSize(2);
+   TUASSERT(reader.getIndex().getEndOffset() <
+            reader.getIndex().getFileSize());
+   unsigned numRead(0);
+   bool threw(false);
+   try
+   {
+      while (reader.read(rod))
+         numRead++;
+   }
+   catch (FFStreamError&)
+   {
+      threw = true;
+   }
+   TUASSERT(threw);
+   TUASSERTE(unsigned, numGood, numRead);
+
+   TURETURN();
+}
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   Rinex3ObsParallel_T testClass;
+
+   errorTotal += testClass.indexTest();
+   errorTotal += testClass.readTest();
+   errorTotal += testClass.windowTest();
+   errorTotal += testClass.errorTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return( errorTotal );
+}
@@ -0,0 +1,144 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+#include "GloEphemeris.hpp"
+#include "CivilTime.hpp"
+#include "TestUtil.hpp"
+
+using namespace gpstk;
+
+
+class GloEphemeris_T
+{
+public:
+      /// set the fields to some plausible values
+   void fill(GloEphemeris& eph);
+   unsigned propagationCacheTest();
+   unsigned monotonicTest();
+
+private:
+      /// Compare Xvt computed with and without the propagation cache
+   void compare(TestUtil& testFramework, const GloEphemeris& cached,
+                const CommonTime& t);
+};
+
+
+void GloEphemeris_T ::
+fill(GloEphemeris& eph)
+{
+   CommonTime t = CivilTime(2015, 7, 19, 0, 15, 0.0, TimeSystem::GLO);
+   eph.setRecord("R", 1, t,
+                 Triple(15000.0, -10000.0, 18000.0),  // km
+                 Triple(-2.0, 1.5, 2.5),              // km/s
+                 Triple(1.9e-9, -2.8e-9, -9.3e-10),   // km/s^2
+                 -6.2e-5, 0.0, 345600, 0, 1, 0.0);
+}
+
+
+void GloEphemeris_T ::
+compare(TestUtil& testFramework, const GloEphemeris& cached,
+        const CommonTime& t)
+{
+   GloEphemeris reference(cached);
+   reference.setPropagationCache(false);
+   Xvt exp = reference.svXvt(t);
+   Xvt got = cached.svXvt(t);
+   for (int i = 0; i < 3; i++)
+   {
+         // sub-millimetre position, sub-micron/s velocity
+      TUASSERTFEPS(exp.x[i], got.x[i], 1e-4);
+      TUASSERTFEPS(exp.v[i], got.v[i], 1e-6);
+   }
+   TUASSERTFEPS(exp.clkbias, got.clkbias, 1e-15);
+}
+
+
+unsigned GloEphemeris_T ::
+propagationCacheTest()
+{
+   TUDEF("GloEphemeris", "svXvt");
+   GloEphemeris eph;
+   fill(eph);
+   TUASSERTE(bool, true, eph.getPropagationCache());
+   CommonTime t0(eph.getEphemerisEpoch());
+      // integration nodes, between nodes, backward, and random jumps
+   double offsets[] = { 300.0, 123.4, 899.0, -450.0, -77.25, 61.5,
+                        0.0, 600.0000000001, -899.5, 1.0, 60.0, -0.3 };
+   for (unsigned i = 0; i < sizeof(offsets)/sizeof(offsets[0]); i++)
+   {
+      compare(testFramework, eph, t0 + offsets[i]);
+   }
+      // a different step size must discard previous nodes
+   eph.setIntegrationStep(10.0);
+   compare(testFramework, eph, t0 + 455.0);
+   compare(testFramework, eph, t0 - 123.0);
+   TURETURN();
+}
+
+
+unsigned GloEphemeris_T ::
+monotonicTest()
+{
+   TUDEF("GloEphemeris", "svXvt");
+   GloEphemeris eph;
+   fill(eph);
+   CommonTime t0(eph.getEphemerisEpoch());
+      // 1 Hz and 0.2 Hz forward, as done by a typical processing run
+   for (double dt = -900.0; dt < 900.0; dt += 17.5)
+   {
+      compare(testFramework, eph, t0 + dt);
+   }
+   for (double dt = 0.5; dt < 30.0; dt += 1.0)
+   {
+      compare(testFramework, eph, t0 + dt);
+   }
+   TURETURN();
+}
+
+
+int main() //Main function to initialize and run all tests above
+{
+   using namespace std;
+   GloEphemeris_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.propagationCacheTest();
+   errorTotal += testClass.monotonicTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; // Return the total number of errors
+}
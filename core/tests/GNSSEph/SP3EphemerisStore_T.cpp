@@ -34,6 +34,7 @@
 //                           release, distribution is unlimited.
 //
 //=============================================================================
+#include <cmath>
 #include <list>
 #include <string>
 #include <iostream>
@@ -510,6 +511,153 @@ public:
       return testFramework.countFails();
    }
 
+//=============================================================================
+// Test for freeze
+// Tests that a frozen SP3EphemerisStore gives the same results as the
+// std::map based one, both at and between the tabular epochs
+//=============================================================================
+   int freezeTest (void)
+   {
+      TUDEF( "SP3EphemerisStore", "freeze" );
+
+      try
+      {
+         SP3EphemerisStore store, frozenStore;
+         store.loadFile(inputSP3Data);
+         frozenStore.loadFile(inputSP3Data);
+         frozenStore.freeze();
+
+         TUASSERTE(bool, true, frozenStore.isFrozen());
+         TUASSERTE(int, store.ndata(), frozenStore.ndata());
+         TUASSERTE(CommonTime, store.getInitialTime(),
+                   frozenStore.getInitialTime());
+         TUASSERTE(CommonTime, store.getFinalTime(),
+                   frozenStore.getFinalTime());
+
+         std::vector<SatID> sats(store.getSatList());
+         CommonTime tBeg(store.getInitialTime() + 7200.0);
+         CommonTime tEnd(store.getFinalTime() - 7200.0);
+         for (int i = 0; i < sats.size(); i++)
+         {
+            for (CommonTime t = tBeg; t < tEnd; t += 433.5)
+            {
+               Xvt exp(store.getXvt(sats[i], t));
+               Xvt got(frozenStore.getXvt(sats[i], t));
+               for (int j = 0; j < 3; j++)
+               {
+                  TUASSERTFEPS(exp.x[j], got.x[j], epsilon);
+                  TUASSERTFEPS(exp.v[j], got.v[j], epsilon);
+               }
+               TUASSERTFEPS(exp.clkbias, got.clkbias, epsilon);
+               TUASSERTFEPS(exp.clkdrift, got.clkdrift, epsilon);
+            }
+               // exactly on a tabular epoch
+            Xvt exp(store.getXvt(sats[i], tBeg));
+            Xvt got(frozenStore.getXvt(sats[i], tBeg));
+            TUASSERTFEPS(exp.x[0], got.x[0], epsilon);
+            TUASSERTFEPS(exp.clkbias, got.clkbias, epsilon);
+         }
+
+            // no data may be added to a frozen store
+         try
+         {
+            frozenStore.loadFile(inputSP3Data);
+            TUFAIL("No exception thrown when loading into a frozen store");
+         }
+         catch (Exception& e)
+         {
+            TUPASS("Expected exception thrown when loading into a frozen"
+                   " store");
+         }
+
+         frozenStore.thaw();
+         TUASSERTE(bool, false, frozenStore.isFrozen());
+         TUASSERTE(int, store.ndata(), frozenStore.ndata());
+         Xvt exp(store.getXvt(sats[0], tBeg + 100.0));
+         Xvt got(frozenStore.getXvt(sats[0], tBeg + 100.0));
+         TUASSERTFEPS(exp.x[1], got.x[1], epsilon);
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+
+      return testFramework.countFails();
+   }
+
+//=============================================================================
+// Test for the single quantities of frozen tables
+// Tests that getPosition, getVelocity and getClockBias interpolate the
+// frozen columns as they interpolate the std::map tables, on a smooth
+// synthetic orbit and clock tabulated every 900 s
+//=============================================================================
+   int frozenQuantityTest (void)
+   {
+      TUDEF( "PositionSatStore", "getPosition" );
+
+      try
+      {
+         PositionSatStore pos, frozenPos;
+         ClockSatStore clk, frozenClk;
+         SatID sat(5, SatID::systemGPS);
+         CommonTime t0(CivilTime(2015, 7, 19, 0, 0, 0.0, TimeSystem::GPS));
+         const double w(2.0 * M_PI / 43082.0);      // rad/s
+
+         for (int k = 0; k < 96; k++)
+         {
+            double t(900.0 * k);
+            PositionRecord prec;
+            prec.Pos = Triple(26560.0 * cos(w * t), 26560.0 * sin(w * t),
+                              1000.0 * sin(0.5 * w * t));              // km
+            prec.Vel = Triple(0.0, 0.0, 0.0);
+            prec.Acc = prec.sigAcc = prec.sigVel = Triple(0.0, 0.0, 0.0);
+            prec.sigPos = Triple(0.01, 0.01, 0.01);
+            pos.addPositionRecord(sat, t0 + t, prec);
+            frozenPos.addPositionRecord(sat, t0 + t, prec);
+
+            ClockRecord crec = { 1.e-4 + 1.e-9 * t + 1.e-14 * t * t, 1.e-10,
+                                 0.0, 0.0, 0.0, 0.0 };
+            clk.addClockRecord(sat, t0 + t, crec);
+            frozenClk.addClockRecord(sat, t0 + t, crec);
+         }
+         frozenPos.freeze();
+         frozenClk.freeze();
+
+         for (double t = 7250.0; t < 80000.0; t += 433.5)
+         {
+            Triple expPos(pos.getPosition(sat, t0 + t));
+            Triple gotPos(frozenPos.getPosition(sat, t0 + t));
+            Triple expVel(pos.getVelocity(sat, t0 + t));
+            Triple gotVel(frozenPos.getVelocity(sat, t0 + t));
+            PositionRecord rec(frozenPos.getValue(sat, t0 + t));
+            for (int j = 0; j < 3; j++)
+            {
+               TUASSERTFEPS(expPos[j], gotPos[j], epsilon);
+               TUASSERTFEPS(expVel[j], gotVel[j], epsilon);
+               TUASSERTFEPS(rec.Pos[j], gotPos[j], 1.e-9);        // 1 um
+            }
+            TUASSERTFEPS(clk.getClockBias(sat, t0 + t),
+                         frozenClk.getClockBias(sat, t0 + t), epsilon);
+            TUASSERTFEPS(frozenClk.getValue(sat, t0 + t).bias,
+                         frozenClk.getClockBias(sat, t0 + t), epsilon);
+         }
+
+            // exactly on a tabular epoch: the tabulated values
+         CommonTime t(t0 + 9000.0);
+         Triple gotPos(frozenPos.getPosition(sat, t));
+         TUASSERTFE(26560.0 * cos(w * 9000.0), gotPos[0]);
+         TUASSERTFE(1000.0 * sin(0.5 * w * 9000.0), gotPos[2]);
+         TUASSERTFE(1.e-4 + 1.e-9 * 9000.0 + 1.e-14 * 9000.0 * 9000.0,
+                    frozenClk.getClockBias(sat, t));
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+
+      return testFramework.countFails();
+   }
+
 private:
    double epsilon; // Floating point error threshold
    std::string dataFilePath;
@@ -539,6 +687,8 @@ int main() // Main function to initialize and run all tests above
    errorTotal += testClass.getFinalTimeTest();
    errorTotal += testClass.getPositionTest();
    errorTotal += testClass.getVelocityTest();
+   errorTotal += testClass.freezeTest();
+   errorTotal += testClass.frozenQuantityTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
 
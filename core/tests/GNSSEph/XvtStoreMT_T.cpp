@@ -0,0 +1,337 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+   /// Concurrent getXvt() calls on shared, loaded stores, checked against
+   /// the results of a single thread, and their throughput for 1 to 8
+   /// threads.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CivilTime.hpp"
+#include "GloEphemerisStore.hpp"
+#include "Rinex3EphemerisStore.hpp"
+#include "Rinex3NavData.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "TestUtil.hpp"
+
+using namespace gpstk;
+using namespace std;
+
+
+class XvtStoreMT_T
+{
+public:
+
+   struct Query
+   {
+      SatID sat;
+      CommonTime t;
+   };
+
+   XvtStoreMT_T()
+   {
+      numThreads = 8;
+      dataFilePath = getPathData();
+   }
+
+   unsigned sp3Test();
+   unsigned rinex3Test();
+   unsigned gloTest();
+
+private:
+
+      /// queries for every satellite, from 'begin' to 'end'
+   vector<Query> makeQueries(const vector<SatID>& sats,
+                             const CommonTime& begin, const CommonTime& end,
+                             double interval);
+
+      /** Run 'queries' with 'numThreads' threads, each one in its own
+       * order, and count the results differing from a single thread run
+       * on 'refStore', an identically loaded store. */
+   void concurrentReads(TestUtil& testFramework,
+                        const XvtStore<SatID>& store,
+                        const XvtStore<SatID>& refStore,
+                        const vector<Query>& queries);
+
+      /// print the time per getXvt() call for 1, 2, 4 and 8 threads
+   void benchmark(const string& name, const XvtStore<SatID>& store,
+                  const vector<Query>& queries);
+
+      /// fill a GLONASS store with records every 30 minutes
+   void fillGlo(GloEphemerisStore& store);
+
+   unsigned numThreads;
+   string dataFilePath;
+};
+
+
+vector<XvtStoreMT_T::Query> XvtStoreMT_T ::
+makeQueries(const vector<SatID>& sats, const CommonTime& begin,
+            const CommonTime& end, double interval)
+{
+   vector<Query> queries;
+   for (CommonTime t = begin; t <= end; t += interval)
+   {
+      for (unsigned i = 0; i < sats.size(); i++)
+      {
+         Query q = { sats[i], t };
+         queries.push_back(q);
+      }
+   }
+   return queries;
+}
+
+
+void XvtStoreMT_T ::
+concurrentReads(TestUtil& testFramework, const XvtStore<SatID>& store,
+                const XvtStore<SatID>& refStore, const vector<Query>& queries)
+{
+   vector<Xvt> ref(queries.size());
+   vector<char> refValid(queries.size(), 0);
+   unsigned numValid(0);
+   for (unsigned i = 0; i < queries.size(); i++)
+   {
+      try
+      {
+         ref[i] = refStore.getXvt(queries[i].sat, queries[i].t);
+         refValid[i] = 1;
+         numValid++;
+      }
+      catch (InvalidRequest&)
+      {
+      }
+   }
+   TUASSERT(numValid > queries.size()/2);
+
+   atomic<unsigned> mismatches(0);
+   vector<thread> pool;
+   for (unsigned k = 0; k < numThreads; k++)
+   {
+      pool.push_back(thread([&, k]()
+      {
+            // every thread walks the queries in its own order, so that
+            // they keep asking for the same records at the same time
+         vector<unsigned> order(queries.size());
+         for (unsigned i = 0; i < order.size(); i++)
+            order[i] = i;
+         if (k % 2)
+            reverse(order.begin(), order.end());
+         if (k >= 2)
+            shuffle(order.begin(), order.end(), mt19937(k));
+
+         for (unsigned i : order)
+         {
+            bool valid(false);
+            Xvt xvt;
+            try
+            {
+               xvt = store.getXvt(queries[i].sat, queries[i].t);
+               valid = true;
+            }
+            catch (InvalidRequest&)
+            {
+            }
+            if (valid != bool(refValid[i]) ||
+                (valid && (!(xvt.x == ref[i].x) || !(xvt.v == ref[i].v) ||
+                           xvt.clkbias != ref[i].clkbias ||
+                           xvt.clkdrift != ref[i].clkdrift)))
+            {
+               mismatches++;
+            }
+         }
+      }));
+   }
+   for (auto& th : pool)
+      th.join();
+
+   TUASSERTE(unsigned, 0, mismatches.load());
+}
+
+
+void XvtStoreMT_T ::
+benchmark(const string& name, const XvtStore<SatID>& store,
+          const vector<Query>& queries)
+{
+   for (unsigned n = 1; n <= numThreads; n *= 2)
+   {
+      auto t1 = chrono::steady_clock::now();
+      vector<thread> pool;
+      for (unsigned k = 0; k < n; k++)
+      {
+         pool.push_back(thread([&]()
+         {
+            for (auto& q : queries)
+            {
+               try
+               {
+                  store.getXvt(q.sat, q.t);
+               }
+               catch (InvalidRequest&)
+               {
+               }
+            }
+         }));
+      }
+      for (auto& th : pool)
+         th.join();
+      chrono::duration<double> dt = chrono::steady_clock::now() - t1;
+
+         // n threads did n times the work
+      cout << "XvtStoreMT benchmark, " << name << ", " << n << " threads, "
+           << (dt.count() * 1e9 / (n * queries.size())) << " ns/getXvt"
+           << endl;
+   }
+}
+
+
+void XvtStoreMT_T ::
+fillGlo(GloEphemerisStore& store)
+{
+   CommonTime t0 = CivilTime(2015, 7, 19, 0, 15, 0.0, TimeSystem::GLO);
+   for (short prn = 1; prn <= 6; prn++)
+   {
+      for (int k = 0; k < 4; k++)
+      {
+         GloEphemeris eph;
+         double a(0.4*prn + 0.7*k);
+         eph.setRecord("R", prn, t0 + 1800.0*k,
+                       Triple(15000.0*cos(a), -10000.0*sin(a), 18000.0),
+                       Triple(-2.0*sin(a), 1.5*cos(a), 2.5),
+                       Triple(1.9e-9, -2.8e-9, -9.3e-10),
+                       -6.2e-5, 0.0, 345600, 0, prn, 0.0);
+         store.addEphemeris(Rinex3NavData(eph));
+      }
+   }
+}
+
+
+unsigned XvtStoreMT_T ::
+sp3Test()
+{
+   TUDEF("SP3EphemerisStore", "getXvt");
+   string file = dataFilePath + "/test_input_sp3_nav_ephemerisData.sp3";
+
+   SP3EphemerisStore store, refStore;
+   store.loadFile(file);
+   refStore.loadFile(file);
+
+   vector<Query> queries(makeQueries(store.getSatList(),
+      store.getInitialTime(), store.getFinalTime(), 451.0));
+
+   concurrentReads(testFramework, store, refStore, queries);
+   store.freeze();
+   refStore.freeze();
+   concurrentReads(testFramework, store, refStore, queries);
+   benchmark("SP3EphemerisStore", store, queries);
+
+   TURETURN();
+}
+
+
+unsigned XvtStoreMT_T ::
+rinex3Test()
+{
+   TUDEF("Rinex3EphemerisStore", "getXvt");
+   string file = dataFilePath + "/test_input_rinex3_nav_RinexNavExample.15n";
+
+   Rinex3EphemerisStore store, refStore;
+   store.loadFile(file);
+   refStore.loadFile(file);
+
+      // the satellites of the file, which covers about 6 hours
+   const int prns[] = { 5, 15, 18, 21, 22, 24, 26, 27, 29 };
+   vector<SatID> sats;
+   for (unsigned i = 0; i < sizeof(prns)/sizeof(prns[0]); i++)
+      sats.push_back(SatID(prns[i], SatID::systemGPS));
+   CommonTime begin(store.getInitialTime());
+   begin.setTimeSystem(TimeSystem::GPS);
+   vector<Query> queries(makeQueries(sats, begin, begin + 6*3600.0, 97.0));
+
+   concurrentReads(testFramework, store, refStore, queries);
+   store.SearchNear();
+   refStore.SearchNear();
+   concurrentReads(testFramework, store, refStore, queries);
+   benchmark("Rinex3EphemerisStore", store, queries);
+
+   TURETURN();
+}
+
+
+unsigned XvtStoreMT_T ::
+gloTest()
+{
+   TUDEF("GloEphemerisStore", "getXvt");
+
+      // the records of 'store' start with empty propagation caches, which
+      // are then filled by all the threads at once
+   GloEphemerisStore store, refStore;
+   fillGlo(store);
+   fillGlo(refStore);
+
+   vector<SatID> sats;
+   for (int prn = 1; prn <= 6; prn++)
+      sats.push_back(SatID(prn, SatID::systemGlonass));
+   vector<Query> queries(makeQueries(sats,
+      store.getInitialTime() - 600.0, store.getFinalTime() + 600.0, 7.3));
+
+   concurrentReads(testFramework, store, refStore, queries);
+   benchmark("GloEphemerisStore", store, queries);
+
+   TURETURN();
+}
+
+
+int main() //Main function to initialize and run all tests above
+{
+   XvtStoreMT_T testClass;
+   unsigned errorTotal = 0;
+
+   errorTotal += testClass.sp3Test();
+   errorTotal += testClass.rinex3Test();
+   errorTotal += testClass.gloTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal; // Return the total number of errors
+}
@@ -0,0 +1,362 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+#include <iostream>
+
+#include "Matrix.hpp"
+#include "MatrixKernels.hpp"
+#include "Vector.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class Matrix_Kernels_T
+{
+public:
+   Matrix_Kernels_T() : eps(1e-9) {}
+
+      /// deterministic symmetric positive definite n x n matrix
+   Matrix<double> spd(size_t n, double seed)
+   {
+      Matrix<double> A(n, n);
+      for (size_t i = 0; i < n; i++)
+         for (size_t j = 0; j < n; j++)
+            A(i,j) = std::sin(seed*(i+1) + 0.37*(j+1)*(j+2));
+      Matrix<double> P(A * transpose(A));
+      for (size_t i = 0; i < n; i++)
+         P(i,i) += n;
+      return P;
+   }
+
+   int capacityTest();
+   int propagateTest();
+   int normalsTest();
+   int choleskyTest();
+   int sequentialTest();
+   int josephTest();
+
+private:
+   double eps;
+};
+
+
+int Matrix_Kernels_T ::
+capacityTest()
+{
+   TUDEF("Vector", "resize");
+
+   Vector<double> v(10, 1.0);
+   const double *storage = v.begin();
+   v.resize(4);
+   TUASSERTE(size_t, 4, v.size());
+   TUASSERTE(size_t, 10, v.capacity());
+   v.resize(10);
+      // growing back within the capacity must not reallocate
+   TUASSERTE(bool, true, storage == v.begin());
+   v.reserve(25);
+   TUASSERTE(size_t, 10, v.size());
+   TUASSERTE(size_t, 25, v.capacity());
+
+   Matrix<double> m(6, 6, 2.0), w;
+   w = m;
+   storage = w.begin();
+   w.resize(3, 5);
+   w = m;
+   TUASSERTE(bool, true, storage == w.begin());
+   TUASSERTE(size_t, 6, w.rows());
+   TUASSERTFE(2.0, w(5,5));
+
+   TURETURN();
+}
+
+
+int Matrix_Kernels_T ::
+propagateTest()
+{
+   TUDEF("MatrixKernels", "propagateCovariance");
+
+   const size_t n(12);
+   Matrix<double> P(spd(n, 0.3)), Q(spd(n, 1.7)), Phi(n, n, 0.0);
+   for (size_t i = 0; i < n; i++)
+   {
+      Phi(i,i) = 1.0;
+      if (i > 2) Phi(i,i-3) = 0.25*i;     // some coupling
+   }
+   Phi(0,n-1) = -0.5;
+
+   Matrix<double> exp(Phi * P * transpose(Phi) + Q), got, work;
+   propagateCovariance(Phi, P, Q, got, work);
+   TUASSERTFEPS(exp, got, eps);
+
+      // in place, and with a different size in the workspace
+   work.resize(3, 3);
+   propagateCovariance(Phi, P, Q, P, work);
+   TUASSERTFEPS(exp, P, eps);
+
+   try
+   {
+      propagateCovariance(Phi, P, Q, got, P);
+      TUFAIL("Aliased workspace accepted");
+   }
+   catch (MatrixException& e)
+   {
+      TUPASS("Aliased workspace rejected");
+   }
+
+   TURETURN();
+}
+
+
+int Matrix_Kernels_T ::
+normalsTest()
+{
+   TUDEF("MatrixKernels", "accumulateNormals");
+
+   const size_t m(9), n(5);
+   Matrix<double> H(m, n), W(spd(m, 0.9)), work;
+   Vector<double> y(m);
+   for (size_t i = 0; i < m; i++)
+   {
+      y(i) = 0.1*i - 0.4;
+      for (size_t j = 0; j < n; j++)
+         H(i,j) = std::cos(0.5*i + 1.3*j);
+   }
+
+   Matrix<double> N(spd(n, 2.2));
+   Vector<double> b(n, 1.0);
+   Matrix<double> expN(transpose(H) * W * H + N);
+   Vector<double> expb(transpose(H) * W * y + b);
+
+   accumulateNormals(H, W, y, N, b, work);
+   TUASSERTFEPS(expN, N, eps);
+   TUASSERTFEPS(expb, b, eps);
+
+      // diagonal weights
+   Matrix<double> D(m, m, 0.0);
+   for (size_t i = 0; i < m; i++)
+      D(i,i) = 1.0 + i;
+   N.resize(n, n, 0.0);
+   b.resize(n, 0.0);
+   accumulateNormals(H, D, y, N, b, work);
+   TUASSERTFEPS(transpose(H) * D * H, N, eps);
+   TUASSERTFEPS(Vector<double>(transpose(H) * D * y), b, eps);
+
+   TURETURN();
+}
+
+
+int Matrix_Kernels_T ::
+choleskyTest()
+{
+   TUDEF("MatrixKernels", "choleskyFactor");
+
+   const size_t n(15);
+   Matrix<double> A(spd(n, 0.11));
+   Vector<double> x(n);
+   for (size_t i = 0; i < n; i++)
+      x(i) = 1.0 - 0.2*i;
+   Vector<double> b(A * x);
+
+   Matrix<double> L(A);
+   choleskyFactor(L);
+   choleskySolve(L, b);
+   TUASSERTFEPS(x, b, eps);
+
+   testFramework.changeSourceMethod("choleskyInvert");
+   choleskyInvert(L);
+   TUASSERTFEPS(inverseChol(A), L, eps);
+   TUASSERTFEPS(ident<double>(n), Matrix<double>(A * L), eps);
+
+   testFramework.changeSourceMethod("choleskyFactor");
+   Matrix<double> bad(n, n, 1.0);
+   try
+   {
+      choleskyFactor(bad);
+      TUFAIL("Singular matrix accepted");
+   }
+   catch (MatrixException& e)
+   {
+      TUPASS("Singular matrix rejected");
+   }
+
+   TURETURN();
+}
+
+
+int Matrix_Kernels_T ::
+sequentialTest()
+{
+   TUDEF("MatrixKernels", "sequentialUpdate");
+
+      // sparse rows, as in PPP: a few common parameters plus one
+      // ambiguity per observation
+   const size_t m(10), n(14);
+   Matrix<double> H(m, n, 0.0), W(m, m, 0.0), P(spd(n, 0.6));
+   Vector<double> y(m), x(n), work;
+   for (size_t i = 0; i < m; i++)
+   {
+      W(i,i) = 1.0/(0.5 + 0.1*i);
+      y(i) = std::sin(1.1*i);
+      for (size_t j = 0; j < 4; j++)
+         H(i,j) = std::cos(0.7*i + 1.9*j);
+      H(i,4+i) = 1.0;
+   }
+   for (size_t j = 0; j < n; j++)
+      x(j) = 0.05*j;
+
+      // information form reference
+   Matrix<double> invP(inverseChol(P));
+   Matrix<double> expP(inverseChol(transpose(H) * W * H + invP));
+   Vector<double> expx(expP * (transpose(H) * W * y + invP * x));
+
+   sequentialUpdate(H, W, y, x, P, work);
+   TUASSERTFEPS(expP, P, eps);
+   TUASSERTFEPS(expx, x, eps);
+   TUASSERTFEPS(Matrix<double>(transpose(P)), P, eps);
+
+      // a zero weight drops the observation
+   Matrix<double> P0(spd(n, 0.6)), W0(m, m, 0.0);
+   Vector<double> x0(n, 0.0);
+   sequentialUpdate(H, W0, y, x0, P0, work);
+   TUASSERTFEPS(Matrix<double>(spd(n, 0.6)), P0, eps);
+   TUASSERTFEPS(Vector<double>(n, 0.0), x0, eps);
+
+   W(0,1) = W(1,0) = 0.1;
+   try
+   {
+      sequentialUpdate(H, W, y, x0, P0, work);
+      TUFAIL("Non-diagonal weights accepted");
+   }
+   catch (MatrixException& e)
+   {
+      TUPASS("Non-diagonal weights rejected");
+   }
+
+   TURETURN();
+}
+
+
+int Matrix_Kernels_T ::
+josephTest()
+{
+   TUDEF("MatrixKernels", "sequentialUpdate");
+
+      // new ambiguities (variance 1e10) observed by precise phases (1 mm):
+      // the plain update P - K*h*P loses positive definiteness here
+   const size_t m(8), n(6);
+   Matrix<double> H(m, n, 0.0), W(m, m, 0.0), P(n, n);
+   for (size_t i = 0; i < n; i++)
+      for (size_t j = 0; j < n; j++)
+         P(i,j) = (i == j) ? 1.0 : 0.3*std::cos(1.0+i+2.0*j)*std::cos(1.0+j+2.0*i);
+   for (size_t i = 3; i < n; i++)
+      P(i,i) = 1e10;
+   for (size_t k = 0; k < m; k++)
+   {
+      for (size_t j = 0; j < 3; j++)
+         H(k,j) = std::cos(0.9*k + 1.3*j);
+      H(k,3+k%3) = 1.0;
+      W(k,k) = 1e6;
+   }
+
+      // information form reference
+   Matrix<double> invP(inverseChol(P));
+   Matrix<double> expP(inverseChol(Matrix<double>(transpose(H) * W * H + invP)));
+
+      // plain update, one observation at a time
+   Matrix<double> plainP(P);
+   for (size_t k = 0; k < m; k++)
+   {
+      Vector<double> hp(n, 0.0);
+      for (size_t j = 0; j < n; j++)
+         for (size_t i = 0; i < n; i++)
+            hp(j) += H(k,i)*plainP(i,j);
+      double s(1.0/W(k,k));
+      for (size_t j = 0; j < n; j++)
+         s += hp(j)*H(k,j);
+      Matrix<double> KhP(n, n);
+      for (size_t i = 0; i < n; i++)
+         for (size_t j = 0; j < n; j++)
+            KhP(i,j) = hp(i)/s*hp(j);
+      plainP -= KhP;
+   }
+   try
+   {
+      Matrix<double> L(plainP);
+      choleskyFactor(L);
+      TUFAIL("Plain update positive definite: the test case is too easy");
+   }
+   catch (MatrixException& e)
+   {
+      TUPASS("Plain update not positive definite");
+   }
+
+   Vector<double> y(m, 0.0), x(n, 0.0), work;
+   sequentialUpdate(H, W, y, x, P, work);
+   TUASSERTFEPS(expP, P, 1e-8);
+   TUASSERTFEPS(Matrix<double>(transpose(P)), P, 1e-15);
+   try
+   {
+      Matrix<double> L(P);
+      choleskyFactor(L);
+      TUPASS("Joseph update positive definite");
+   }
+   catch (MatrixException& e)
+   {
+      TUFAIL("Joseph update not positive definite");
+   }
+
+   TURETURN();
+}
+
+
+int main()
+{
+   int errorCounter = 0;
+   Matrix_Kernels_T testClass;
+
+   errorCounter += testClass.capacityTest();
+   errorCounter += testClass.propagateTest();
+   errorCounter += testClass.normalsTest();
+   errorCounter += testClass.choleskyTest();
+   errorCounter += testClass.sequentialTest();
+   errorCounter += testClass.josephTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorCounter << std::endl;
+
+   return errorCounter; //Return the total number of errors
+}
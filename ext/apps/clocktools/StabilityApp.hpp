@@ -0,0 +1,107 @@
+#pragma ident "$Id$"
+/**********************************************
+/ GPSTk: Clock Tools
+/ StabilityApp.hpp
+/
+/ Common main of the frequency stability tools
+/ (oallandev, mallandev, ohadamarddev, tdev, tallandev)
+**********************************************/
+
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 2.1 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2009, The University of Texas at Austin
+//
+//============================================================================
+
+#ifndef CLOCKTOOLS_STABILITYAPP_HPP
+#define CLOCKTOOLS_STABILITYAPP_HPP
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FrequencyStability.hpp"
+
+// Reads "time phase" lines from the standard input and prints the
+// "tau deviation" lines of statistic 'st'. The zero phase values and
+// the missing epochs are gaps.
+// Options: -o (octave spacing of tau), -d (decade spacing),
+//          -j N (threads, 0 for one per core)
+inline int runStability(gpstk::FrequencyStability::Statistic st,
+                        const char* name, const char* title,
+                        int argc, char **argv)
+{
+    gpstk::FrequencyStability::Spacing spacing = gpstk::FrequencyStability::All;
+    unsigned threads = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string str = argv[i];
+        if ((str == "-h") || (str == "--help"))
+        {
+            std::cout << name << ": Computes the " << title << " from the standard input." << std::endl
+                      << "options: -o octave spacing of tau, -d decade spacing (1, 2, 5),"
+                      << " -j N number of threads (0: one per core)" << std::endl;
+            return 1;
+        }
+        else if (str == "-o")
+            spacing = gpstk::FrequencyStability::Octave;
+        else if (str == "-d")
+            spacing = gpstk::FrequencyStability::Decade;
+        else if (str == "-j" && i + 1 < argc)
+            threads = atoi(argv[++i]);
+    }
+
+    // All of the time and clock phase data is read in from the standard input
+    std::vector<double> timeArray, phaseArray;
+    double time, phase;
+    while (std::cin >> time >> phase)
+    {
+        timeArray.push_back(time);
+        phaseArray.push_back(phase);
+    }
+
+    try
+    {
+        double tau0;
+        std::vector<double> x =
+            gpstk::FrequencyStability::regularize(timeArray, phaseArray, tau0, true);
+
+        gpstk::FrequencyStability fs(x, tau0);
+        fs.setSpacing(spacing).setThreads(threads);
+
+        std::vector<gpstk::FrequencyStability::Point> curve = fs.compute(st);
+        for (size_t i = 0; i < curve.size(); i++)
+            if (curve[i].terms > 0)
+                fprintf(stdout, "%.1f %.4e \n", curve[i].tau, curve[i].deviation); // outputs results to the standard output
+    }
+    catch (gpstk::Exception& e)
+    {
+        std::cout << "Not Enough Points to Calculate Tau0" << std::endl;
+        std::cerr << e.getText() << std::endl;
+        return 1;
+    }
+
+    return(0);
+}
+
+#endif
@@ -0,0 +1,301 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+#include <math.h>
+#include <algorithm>
+#include <thread>
+
+#include "Exception.hpp"
+#include "StringUtils.hpp"
+#include "GNSSconstants.hpp"
+
+#include "CCReplica.hpp"
+#include "CACodeGenerator.hpp"
+
+#include "Acquisition.hpp"
+
+using namespace std;
+
+namespace
+{
+   // samples whose carrier is computed from the same sincos
+   const int carrierChunk = 64;
+
+   // fftw_malloc'ed arrays, freed on scope exit
+   struct FFTWBuffer
+   {
+      FFTWBuffer(int n)
+         : p((fftw_complex*) fftw_malloc(sizeof(fftw_complex) * n)) {}
+      ~FFTWBuffer() {fftw_free(p);}
+      fftw_complex* p;
+   private:
+      FFTWBuffer(const FFTWBuffer&);
+      FFTWBuffer& operator=(const FFTWBuffer&);
+   };
+}
+
+
+Acquisition::Config::Config()
+   : sampleRate(20e6), interFreq(0.42e6),
+     searchWidth(20000), binWidth(200),
+     coherentPeriods(1), nonCoherentSums(1),
+     threads(0), planFlags(FFTW_MEASURE)
+{}
+
+
+Acquisition::Acquisition(const Config& config)
+   : cfg(config),
+     numSamples(floor(config.sampleRate * 1e-3 * config.coherentPeriods + 0.5)),
+     bins(config.searchWidth / config.binWidth + 1),
+     kernels(AcquisitionKernels::best()),
+     forward(0), backward(0), nextBin(0)
+{
+   if (numSamples < 1 || cfg.nonCoherentSums < 1 || bins < 1)
+   {
+      gpstk::InvalidParameter e("Invalid acquisition parameters");
+      GPSTK_THROW(e);
+   }
+
+   if (!cfg.wisdomFile.empty())
+      fftw_import_wisdom_from_filename(cfg.wisdomFile.c_str());
+
+   // the plans are executed on other arrays of the same alignment,
+   // those of fftw_malloc
+   FFTWBuffer in(numSamples), out(numSamples);
+   forward = fftw_plan_dft_1d(numSamples, in.p, out.p,
+                              FFTW_FORWARD, cfg.planFlags);
+   backward = fftw_plan_dft_1d(numSamples, in.p, out.p,
+                               FFTW_BACKWARD, cfg.planFlags);
+   if (!forward || !backward)
+   {
+      if (forward) fftw_destroy_plan(forward);
+      if (backward) fftw_destroy_plan(backward);
+      gpstk::Exception e("FFTW planning failed");
+      GPSTK_THROW(e);
+   }
+
+   if (!cfg.wisdomFile.empty())
+      fftw_export_wisdom_to_filename(cfg.wisdomFile.c_str());
+}
+
+
+Acquisition::~Acquisition()
+{
+   for (map<int, fftw_complex*>::iterator i = codeCache.begin();
+        i != codeCache.end(); i++)
+      fftw_free(i->second);
+   fftw_destroy_plan(forward);
+   fftw_destroy_plan(backward);
+}
+
+
+const fftw_complex* Acquisition::codeSpectrum(int prn)
+{
+   map<int, fftw_complex*>::const_iterator i = codeCache.find(prn);
+   if (i != codeCache.end())
+      return i->second;
+
+   FFTWBuffer code(numSamples);
+   CCReplica cc(1/cfg.sampleRate, gpstk::CA_CHIP_FREQ_GPS, 0,
+                new gpstk::CACodeGenerator(prn));
+   cc.reset();
+   for (int k = 0; k < numSamples; k++)
+   {
+      code.p[k][0] = cc.getCode() ? 1 : -1;
+      code.p[k][1] = 0;
+      cc.tick();
+   }
+
+   fftw_complex* spec = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
+   fftw_execute_dft(forward, code.p, spec);
+
+   // The forward and the backward FFTs and the magnitude of the
+   // correlation are each scaled by 1/sqrt(N), as acquire always did,
+   // so that the heights don't depend on the sample rate much.
+   const double scale = 1 / (numSamples * sqrt((double)numSamples));
+   for (int k = 0; k < numSamples; k++)
+   {
+      spec[k][0] *= scale;
+      spec[k][1] *= scale;
+   }
+
+   codeCache[prn] = spec;
+   return spec;
+}
+
+
+void Acquisition::searchBins(const fftw_complex* input,
+                             const vector<const fftw_complex*>& codes,
+                             vector<Result>& best)
+{
+   const int n = numSamples;
+   const int prns = codes.size();
+
+   FFTWBuffer wiped(n), spec(n), prod(n), corr(n);
+   vector<double> power(prns * n);
+   vector< complex<double> > step(carrierChunk), carrier(carrierChunk);
+
+   for (int bin = nextBin++; bin < bins; bin = nextBin++)
+   {
+      // The carrier is exp(-j*2*pi*f*t); the phase of the first sample
+      // of each chunk is computed anew, so that it doesn't drift.
+      const double cyclesPerSample = (cfg.interFreq + binDoppler(bin)) / cfg.sampleRate;
+      for (int i = 0; i < carrierChunk; i++)
+         step[i] = polar(1.0, -2 * gpstk::PI * cyclesPerSample * i);
+
+      fill(power.begin(), power.end(), 0.0);
+      for (int block = 0; block < cfg.nonCoherentSums; block++)
+      {
+         const fftw_complex* x = input + block * n;
+         for (int k = 0; k < n; k += carrierChunk)
+         {
+            const int len = min(carrierChunk, n - k);
+            double cycles = cyclesPerSample * (block * n + k);
+            complex<double> start = polar(1.0, -2 * gpstk::PI * (cycles - floor(cycles)));
+            for (int i = 0; i < len; i++)
+               carrier[i] = start * step[i];
+            kernels.mulComplex(x[k], reinterpret_cast<const double*>(&carrier[0]),
+                       wiped.p[k], len);
+         }
+         fftw_execute_dft(forward, wiped.p, spec.p);
+
+         for (int p = 0; p < prns; p++)
+         {
+            kernels.mulConj(spec.p[0], codes[p][0], prod.p[0], n);
+            fftw_execute_dft(backward, prod.p, corr.p);
+            kernels.addPower(corr.p[0], &power[p * n], n);
+         }
+      }
+
+      for (int p = 0; p < prns; p++)
+      {
+         const double* pw = &power[p * n];
+         const int shift = max_element(pw, pw + n) - pw;
+         const double peak = pw[shift] / cfg.nonCoherentSums;
+         if (peak <= best[p].height * best[p].height)
+            continue;
+
+         double sum = 0;
+         for (int k = 0; k < n; k++)
+            sum += pw[k];
+         best[p].bin = bin;
+         best[p].shift = shift;
+         best[p].height = sqrt(peak);
+         best[p].ratio = sum > 0 ? pw[shift] * n / sum : 0;
+      }
+   }
+}
+
+
+vector<Acquisition::Result> Acquisition::acquire(const vector< complex<float> >& samples,
+                                                 const vector<int>& prns)
+{
+   const int needed = samplesNeeded();
+   if ((int)samples.size() < needed)
+   {
+      gpstk::InvalidParameter e("Not enough samples to acquire: "
+                                + gpstk::StringUtils::asString(samples.size())
+                                + " of "
+                                + gpstk::StringUtils::asString(needed));
+      GPSTK_THROW(e);
+   }
+
+   // the code FFTs are computed before the threads share them
+   vector<const fftw_complex*> codes;
+   for (size_t i = 0; i < prns.size(); i++)
+      codes.push_back(codeSpectrum(prns[i]));
+
+   FFTWBuffer input(needed);
+   for (int k = 0; k < needed; k++)
+   {
+      input.p[k][0] = real(samples[k]);
+      input.p[k][1] = imag(samples[k]);
+   }
+
+   Result none;
+   none.prn = 0;
+   none.bin = 0;
+   none.doppler = 0;
+   none.shift = 0;
+   none.codeOffset = 0;
+   none.height = 0;
+   none.ratio = 0;
+
+   unsigned threads = cfg.threads ? cfg.threads : thread::hardware_concurrency();
+   threads = max(1u, min(threads, (unsigned)bins));
+   vector< vector<Result> > best(threads, vector<Result>(prns.size(), none));
+
+   nextBin = 0;
+   vector<thread> pool;
+   for (unsigned t = 1; t < threads; t++)
+      pool.push_back(thread(&Acquisition::searchBins, this, input.p,
+                            cref(codes), ref(best[t])));
+   searchBins(input.p, codes, best[0]);
+   for (size_t t = 0; t < pool.size(); t++)
+      pool[t].join();
+
+   // the best bin of each PRN over the threads, the lowest bin on a tie
+   const double samplesPerPeriod = cfg.sampleRate * 1e-3;
+   vector<Result> results(prns.size());
+   for (size_t p = 0; p < prns.size(); p++)
+   {
+      Result& r = results[p];
+      r = best[0][p];
+      for (unsigned t = 1; t < threads; t++)
+      {
+         const Result& o = best[t][p];
+         if (o.height > r.height || (o.height == r.height && o.bin < r.bin))
+            r = o;
+      }
+
+      // the code phase within the first C/A period
+      while (r.shift >= samplesPerPeriod)
+         r.shift = r.shift - samplesPerPeriod;
+
+      r.prn = prns[p];
+      r.doppler = binDoppler(r.bin);
+      r.codeOffset = r.shift * 1000 / samplesPerPeriod;
+   }
+   return results;
+}
+
+
+Acquisition::Result Acquisition::acquire(const vector< complex<float> >& samples,
+                                         int prn)
+{
+   return acquire(samples, vector<int>(1, prn)).front();
+}
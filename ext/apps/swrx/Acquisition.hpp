@@ -0,0 +1,146 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+#ifndef ACQUISITION_HPP
+#define ACQUISITION_HPP
+
+#include <atomic>
+#include <complex>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <fftw3.h>
+
+#include "AcquisitionKernels.hpp"
+
+
+//-----------------------------------------------------------------------------
+// FFT based acquisition of the C/A code (parallel code phase search).
+//
+// The FFT plans are made once, when the object is created, with the FFTW
+// wisdom of the wisdom file, if any, and are shared by all the searches.
+// A search runs all the Doppler bins over a pool of threads. For each bin
+// the carrier is wiped off the samples and their FFT is computed once and
+// correlated with the code FFT of every PRN searched, the code FFTs being
+// computed once per PRN and kept for the next searches.
+//
+// Each FFT spans coherentPeriods C/A periods; the correlation powers of
+// nonCoherentSums consecutive blocks are added.
+//-----------------------------------------------------------------------------
+class Acquisition
+{
+public:
+   struct Config
+   {
+      Config();
+
+      double sampleRate;    // Hz
+      double interFreq;     // Hz
+      double searchWidth;   // Hz, the search is from -searchWidth/2
+      double binWidth;      // Hz
+      int coherentPeriods;  // C/A periods (ms) of each FFT
+      int nonCoherentSums;  // blocks whose correlation powers are added
+      unsigned threads;     // 0: one per core
+      std::string wisdomFile; // read, and updated after planning, if set
+      unsigned planFlags;   // FFTW planner flags, FFTW_MEASURE by default
+   };
+
+   struct Result
+   {
+      int prn;
+      int bin;
+      double doppler;     // Hz
+      int shift;          // samples, within the first C/A period
+      double codeOffset;  // us
+      double height;      // correlation amplitude
+      double ratio;       // peak power over the mean power of its bin
+   };
+
+   Acquisition(const Config& config);
+   ~Acquisition();
+
+   const Config& config() const {return cfg;}
+
+   int samplesPerBlock() const {return numSamples;}
+
+   // the samples needed by a search
+   int samplesNeeded() const {return numSamples * cfg.nonCoherentSums;}
+
+   int numBins() const {return bins;}
+
+   // the instruction set of the products and power sums
+   AcquisitionKernels::Isa isa() const {return kernels.isa;}
+
+   double binDoppler(int bin) const
+   {return -cfg.searchWidth/2 + bin * cfg.binWidth;}
+
+   // Searches all the PRNs of 'prns' in 'samples', which must hold at
+   // least samplesNeeded() samples. The results are in the order of 'prns'.
+   std::vector<Result> acquire(const std::vector< std::complex<float> >& samples,
+                               const std::vector<int>& prns);
+
+   Result acquire(const std::vector< std::complex<float> >& samples, int prn);
+
+private:
+   Acquisition(const Acquisition&);
+   Acquisition& operator=(const Acquisition&);
+
+   // the code FFT of 'prn', scaled by the FFT gains; computed on first use
+   const fftw_complex* codeSpectrum(int prn);
+
+   // searches the bins taken from nextBin; run by every thread
+   void searchBins(const fftw_complex* input,
+                   const std::vector<const fftw_complex*>& codes,
+                   std::vector<Result>& best);
+
+   Config cfg;
+   int numSamples;
+   int bins;
+
+   const AcquisitionKernels& kernels;
+
+   fftw_plan forward;
+   fftw_plan backward;
+
+   std::map<int, fftw_complex*> codeCache;
+
+   // next bin to search, shared by the threads of a search
+   std::atomic<int> nextBin;
+};
+
+#endif
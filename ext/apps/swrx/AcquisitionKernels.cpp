@@ -0,0 +1,209 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+#include "AcquisitionKernels.hpp"
+
+#if !defined(SWRX_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define ACQ_SIMD
+#include <immintrin.h>
+#endif
+
+namespace
+{
+   void mulComplexScalar(const double* a, const double* b, double* out, int n)
+   {
+      for (int i = 0; i < n; i++)
+      {
+         double re = a[2*i] * b[2*i] - a[2*i+1] * b[2*i+1];
+         double im = a[2*i] * b[2*i+1] + a[2*i+1] * b[2*i];
+         out[2*i] = re;
+         out[2*i+1] = im;
+      }
+   }
+
+   void mulConjScalar(const double* a, const double* b, double* out, int n)
+   {
+      for (int i = 0; i < n; i++)
+      {
+         double re = a[2*i] * b[2*i] + a[2*i+1] * b[2*i+1];
+         double im = a[2*i] * b[2*i+1] - a[2*i+1] * b[2*i];
+         out[2*i] = re;
+         out[2*i+1] = im;
+      }
+   }
+
+   void addPowerScalar(const double* a, double* acc, int n)
+   {
+      for (int i = 0; i < n; i++)
+         acc[i] += a[2*i] * a[2*i] + a[2*i+1] * a[2*i+1];
+   }
+
+#ifdef ACQ_SIMD
+   __attribute__((target("sse3")))
+   void mulComplexSSE3(const double* a, const double* b, double* out, int n)
+   {
+      for (int i = 0; i < n; i++)
+      {
+         __m128d va = _mm_loadu_pd(a + 2*i);
+         __m128d vb = _mm_loadu_pd(b + 2*i);
+         __m128d re = _mm_mul_pd(va, _mm_movedup_pd(vb));
+         __m128d im = _mm_mul_pd(_mm_shuffle_pd(va, va, 1),
+                                 _mm_unpackhi_pd(vb, vb));
+         _mm_storeu_pd(out + 2*i, _mm_addsub_pd(re, im));
+      }
+   }
+
+   __attribute__((target("sse3")))
+   void mulConjSSE3(const double* a, const double* b, double* out, int n)
+   {
+      const __m128d conj = _mm_set_pd(-0.0, 0.0);
+      for (int i = 0; i < n; i++)
+      {
+         __m128d va = _mm_xor_pd(_mm_loadu_pd(a + 2*i), conj);
+         __m128d vb = _mm_loadu_pd(b + 2*i);
+         __m128d re = _mm_mul_pd(va, _mm_movedup_pd(vb));
+         __m128d im = _mm_mul_pd(_mm_shuffle_pd(va, va, 1),
+                                 _mm_unpackhi_pd(vb, vb));
+         _mm_storeu_pd(out + 2*i, _mm_addsub_pd(re, im));
+      }
+   }
+
+   __attribute__((target("sse3")))
+   void addPowerSSE3(const double* a, double* acc, int n)
+   {
+      int i = 0;
+      for (; i + 2 <= n; i += 2)
+      {
+         __m128d v0 = _mm_loadu_pd(a + 2*i);
+         __m128d v1 = _mm_loadu_pd(a + 2*i + 2);
+         __m128d p = _mm_hadd_pd(_mm_mul_pd(v0, v0), _mm_mul_pd(v1, v1));
+         _mm_storeu_pd(acc + i, _mm_add_pd(_mm_loadu_pd(acc + i), p));
+      }
+      addPowerScalar(a + 2*i, acc + i, n - i);
+   }
+
+   __attribute__((target("avx")))
+   void mulComplexAVX(const double* a, const double* b, double* out, int n)
+   {
+      int i = 0;
+      for (; i + 2 <= n; i += 2)
+      {
+         __m256d va = _mm256_loadu_pd(a + 2*i);
+         __m256d vb = _mm256_loadu_pd(b + 2*i);
+         __m256d re = _mm256_mul_pd(va, _mm256_movedup_pd(vb));
+         __m256d im = _mm256_mul_pd(_mm256_permute_pd(va, 0x5),
+                                    _mm256_permute_pd(vb, 0xF));
+         _mm256_storeu_pd(out + 2*i, _mm256_addsub_pd(re, im));
+      }
+      mulComplexScalar(a + 2*i, b + 2*i, out + 2*i, n - i);
+   }
+
+   __attribute__((target("avx")))
+   void mulConjAVX(const double* a, const double* b, double* out, int n)
+   {
+      int i = 0;
+      const __m256d conj = _mm256_set_pd(-0.0, 0.0, -0.0, 0.0);
+      for (; i + 2 <= n; i += 2)
+      {
+         __m256d va = _mm256_xor_pd(_mm256_loadu_pd(a + 2*i), conj);
+         __m256d vb = _mm256_loadu_pd(b + 2*i);
+         __m256d re = _mm256_mul_pd(va, _mm256_movedup_pd(vb));
+         __m256d im = _mm256_mul_pd(_mm256_permute_pd(va, 0x5),
+                                    _mm256_permute_pd(vb, 0xF));
+         _mm256_storeu_pd(out + 2*i, _mm256_addsub_pd(re, im));
+      }
+      mulConjScalar(a + 2*i, b + 2*i, out + 2*i, n - i);
+   }
+#endif
+
+   const AcquisitionKernels kernels[] =
+   {
+      {AcquisitionKernels::Scalar,
+       mulComplexScalar, mulConjScalar, addPowerScalar},
+#ifdef ACQ_SIMD
+      {AcquisitionKernels::SSE3,
+       mulComplexSSE3, mulConjSSE3, addPowerSSE3},
+      // the power sums gain nothing from AVX: those of SSE3
+      {AcquisitionKernels::AVX,
+       mulComplexAVX, mulConjAVX, addPowerSSE3},
+#endif
+   };
+}
+
+
+bool AcquisitionKernels::supported(Isa isa)
+{
+   switch (isa)
+   {
+      case Scalar:
+         return true;
+#ifdef ACQ_SIMD
+      case SSE3:
+         return __builtin_cpu_supports("sse3");
+      case AVX:
+         return __builtin_cpu_supports("avx");
+#endif
+      default:
+         return false;
+   }
+}
+
+
+const AcquisitionKernels& AcquisitionKernels::get(Isa isa)
+{
+   return supported(isa) ? kernels[isa] : kernels[Scalar];
+}
+
+
+const AcquisitionKernels& AcquisitionKernels::best()
+{
+   static const AcquisitionKernels& chosen =
+      supported(AVX) ? get(AVX) : get(SSE3);
+   return chosen;
+}
+
+
+const char* AcquisitionKernels::name(Isa isa)
+{
+   switch (isa)
+   {
+      case SSE3: return "SSE3";
+      case AVX: return "AVX";
+      default: return "scalar";
+   }
+}
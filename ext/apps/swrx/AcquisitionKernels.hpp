@@ -0,0 +1,74 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+#ifndef ACQUISITIONKERNELS_HPP
+#define ACQUISITIONKERNELS_HPP
+
+//-----------------------------------------------------------------------------
+// The complex products and the power sums of Acquisition, over arrays of
+// interleaved real and imaginary parts.
+//
+// Each has a scalar version and, on x86 with GCC or clang, SSE3 and AVX
+// versions, compiled for their instruction set whatever the flags of the
+// build; the best one the CPU supports is chosen at run time. Defining
+// SWRX_NO_SIMD (the SWRX_SIMD CMake option) leaves only the scalar ones.
+//-----------------------------------------------------------------------------
+struct AcquisitionKernels
+{
+   enum Isa {Scalar, SSE3, AVX};
+
+   typedef void (*Product)(const double* a, const double* b, double* out, int n);
+   typedef void (*Power)(const double* a, double* acc, int n);
+
+   Isa isa;
+   Product mulComplex;  // out = a * b, over n complex values
+   Product mulConj;     // out = conj(a) * b, over n complex values
+   Power addPower;      // acc += |a|^2, over n complex values
+
+   // true if the kernels of 'isa' are compiled in and the CPU runs them
+   static bool supported(Isa isa);
+
+   // the kernels of 'isa'; those of Scalar if it isn't supported
+   static const AcquisitionKernels& get(Isa isa);
+
+   // the kernels of the best instruction set supported
+   static const AcquisitionKernels& best();
+
+   static const char* name(Isa isa);
+};
+
+#endif
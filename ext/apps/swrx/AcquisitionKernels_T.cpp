@@ -0,0 +1,167 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/// @file AcquisitionKernels_T.cpp
+/// The SSE3 and AVX kernels of Acquisition against the scalar ones, on the
+/// instruction sets the CPU supports: each product and the correlation
+/// power they make together, over lengths with and without an odd tail.
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "AcquisitionKernels.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+
+namespace
+{
+   // n complex values, uniform in [-1, 1)
+   vector<double> randomComplex(int n)
+   {
+      vector<double> v(2*n + 1);
+      for (int i = 0; i < 2*n + 1; i++)
+         v[i] = 2.0 * rand() / RAND_MAX - 1;
+      return v;
+   }
+
+   // largest difference of 'got' from 'exp', relative to the largest 'exp'
+   double relDiff(const vector<double>& exp, const vector<double>& got)
+   {
+      double d = 0, m = 0;
+      for (size_t i = 0; i < exp.size(); i++)
+      {
+         d = max(d, fabs(got[i] - exp[i]));
+         m = max(m, fabs(exp[i]));
+      }
+      return m > 0 ? d / m : d;
+   }
+
+   // the power of the correlation of 'x' with the code 'c' after the
+   // carrier 'w' is wiped off, added over 'sums' blocks, as Acquisition
+   // computes it with 'k'
+   vector<double> correlation(const AcquisitionKernels& k,
+                              const vector<double>& x, const vector<double>& w,
+                              const vector<double>& c, int n, int sums)
+   {
+      vector<double> wiped(2*n + 1), prod(2*n + 1), power(n + 1);
+      for (int s = 0; s < sums; s++)
+      {
+         k.mulComplex(&x[0], &w[0], &wiped[0], n);
+         k.mulConj(&wiped[0], &c[0], &prod[0], n);
+         k.addPower(&prod[0], &power[0], n);
+      }
+      return power;
+   }
+}
+
+
+class AcquisitionKernels_T
+{
+public:
+   int kernelsTest()
+   {
+      TUDEF("AcquisitionKernels", "kernels");
+
+      const AcquisitionKernels& scalar = AcquisitionKernels::get(AcquisitionKernels::Scalar);
+      TUASSERTE(int, AcquisitionKernels::Scalar, scalar.isa);
+      TUASSERT(AcquisitionKernels::supported(AcquisitionKernels::best().isa));
+
+      const int lengths[] = {0, 1, 2, 3, 63, 64, 65, 5001};
+      const AcquisitionKernels::Isa simd[] = {AcquisitionKernels::SSE3,
+                                              AcquisitionKernels::AVX};
+      srand(20);
+      for (int j = 0; j < 2; j++)
+      {
+         if (!AcquisitionKernels::supported(simd[j]))
+         {
+            cout << AcquisitionKernels::name(simd[j])
+                 << " not supported here, not tested" << endl;
+            continue;
+         }
+         const AcquisitionKernels& k = AcquisitionKernels::get(simd[j]);
+         TUASSERTE(int, simd[j], k.isa);
+
+         for (int l = 0; l < 8; l++)
+         {
+            // the last value past the n is a guard: it must stay as it is
+            const int n = lengths[l];
+            vector<double> a(randomComplex(n)), b(randomComplex(n));
+            vector<double> exp(randomComplex(n)), got(exp);
+
+            scalar.mulComplex(&a[0], &b[0], &exp[0], n);
+            k.mulComplex(&a[0], &b[0], &got[0], n);
+            TUASSERT(relDiff(exp, got) <= 1e-15);
+            TUASSERTFE(exp[2*n], got[2*n]);
+
+            scalar.mulConj(&a[0], &b[0], &exp[0], n);
+            k.mulConj(&a[0], &b[0], &got[0], n);
+            TUASSERT(relDiff(exp, got) <= 1e-15);
+            TUASSERTFE(exp[2*n], got[2*n]);
+
+            vector<double> pexp(n + 1, 1.0), pgot(pexp);
+            scalar.addPower(&a[0], &pexp[0], n);
+            k.addPower(&a[0], &pgot[0], n);
+            TUASSERT(relDiff(pexp, pgot) <= 1e-15);
+            TUASSERTFE(1.0, pgot[n]);
+
+            vector<double> w(randomComplex(n)), c(randomComplex(n));
+            TUASSERT(relDiff(correlation(scalar, a, w, c, n, 3),
+                             correlation(k, a, w, c, n, 3)) <= 1e-14);
+         }
+      }
+
+      TURETURN();
+   }
+};
+
+
+int main()
+{
+   int errorCounter = 0;
+   AcquisitionKernels_T testClass;
+
+   cout << "kernels used: "
+        << AcquisitionKernels::name(AcquisitionKernels::best().isa) << endl;
+   errorCounter += testClass.kernelsTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorCounter << std::endl;
+
+   return errorCounter; //Return the total number of errors
+}
@@ -0,0 +1,238 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/// @file acquireBench.cpp
+/// Time of the search of all the 32 C/A codes in an IQ file by Acquisition,
+/// with one thread and with 'threads' threads, and by the per bin replica
+/// FFTs acquire used before Acquisition, single threaded and coherent only.
+/// The IQ file is float samples of 'bands' bands, as gpsSim writes them.
+/// The results are printed as CSV: method, prns, bins, samples, threads,
+/// seconds, detected; the seconds are those of one search, the planning
+/// of Acquisition being on its own line. A PRN is detected when its
+/// correlation height is at least 40, the default of acquire.
+///
+/// Usage: acquireBench file rateMHz ifMHz [bands [periods [sums [threads [repeats]]]]]
+///
+/// e.g. gpsSim -x 1.25 -r 5 -c c:1:21:50:13100:0 -c c:1:7:300:-2100:0 -t 4 -o iq.bin
+///      acquireBench iq.bin 5 1.25 2 1 5 4
+
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "GNSSconstants.hpp"
+
+#include "Acquisition.hpp"
+#include "CACodeGenerator.hpp"
+#include "CCReplica.hpp"
+#include "IQStream.hpp"
+
+using namespace std;
+
+namespace
+{
+   const double minHeight = 40;
+
+   double since(chrono::steady_clock::time_point t1)
+   {
+      return chrono::duration<double>(chrono::steady_clock::now() - t1).count();
+   }
+
+   void report(const string& method, int bins, int samples, unsigned threads,
+               double seconds, int detected)
+   {
+      cout << method << "," << 32 << "," << bins << ","
+           << samples << "," << threads << ","
+           << seconds << "," << detected << endl;
+   }
+
+   // The search as acquire did it: for each PRN, the code and carrier
+   // replica of each bin, its FFT, planned each time, and the inverse
+   // FFT of its product with the conjugated FFT of the samples.
+   int legacySearch(const Acquisition::Config& cfg, int numSamples,
+                    const vector< complex<float> >& samples)
+   {
+      const int bins = cfg.searchWidth / cfg.binWidth + 1;
+      fftw_complex* in = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
+      fftw_complex* IN = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
+      fftw_complex* l = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
+      fftw_complex* L = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
+      fftw_complex* fin = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
+      for (int k = 0; k < numSamples; k++)
+      {
+         in[k][0] = real(samples[k]);
+         in[k][1] = imag(samples[k]);
+      }
+
+      int detected = 0;
+      for (int prn = 1; prn <= 32; prn++)
+      {
+         fftw_plan p = fftw_plan_dft_1d(numSamples, in, IN, FFTW_FORWARD, FFTW_ESTIMATE);
+         fftw_execute(p);
+         fftw_destroy_plan(p);
+
+         double max = 0;
+         for (int i = 0; i < bins; i++)
+         {
+            CCReplica cc(1/cfg.sampleRate, gpstk::CA_CHIP_FREQ_GPS,
+                         cfg.interFreq - cfg.searchWidth/2 + i * cfg.binWidth,
+                         new gpstk::CACodeGenerator(prn));
+            cc.reset();
+            for (int k = 0; k < numSamples; k++)
+            {
+               complex<double> r = cc.getCarrier() * (cc.getCode() ? 1.0 : -1.0);
+               l[k][0] = real(r);
+               l[k][1] = imag(r);
+               cc.tick();
+            }
+            p = fftw_plan_dft_1d(numSamples, l, L, FFTW_FORWARD, FFTW_ESTIMATE);
+            fftw_execute(p);
+            fftw_destroy_plan(p);
+
+            for (int k = 0; k < numSamples; k++)
+            {
+               complex<double> m = complex<double>(L[k][0], L[k][1])
+                  * conj(complex<double>(IN[k][0], IN[k][1])) / (double)numSamples;
+               L[k][0] = real(m);
+               L[k][1] = imag(m);
+            }
+            p = fftw_plan_dft_1d(numSamples, L, fin, FFTW_BACKWARD, FFTW_ESTIMATE);
+            fftw_execute(p);
+            fftw_destroy_plan(p);
+
+            for (int k = 0; k < numSamples; k++)
+               max = std::max(max, abs(complex<double>(fin[k][0], fin[k][1]))
+                              / sqrt((double)numSamples));
+         }
+         if (max >= minHeight)
+            detected++;
+      }
+
+      fftw_free(in); fftw_free(IN); fftw_free(l); fftw_free(L); fftw_free(fin);
+      return detected;
+   }
+}
+
+
+int main(int argc, char* argv[])
+{
+   if (argc < 4)
+   {
+      cerr << "Usage: " << argv[0]
+           << " file rateMHz ifMHz [bands [periods [sums [threads [repeats]]]]]"
+           << endl;
+      return 1;
+   }
+
+   try
+   {
+      Acquisition::Config cfg;
+      cfg.sampleRate = atof(argv[2]) * 1e6;
+      cfg.interFreq = atof(argv[3]) * 1e6;
+      int bands = argc > 4 ? atoi(argv[4]) : 2;
+      cfg.coherentPeriods = argc > 5 ? atoi(argv[5]) : 1;
+      cfg.nonCoherentSums = argc > 6 ? atoi(argv[6]) : 1;
+      unsigned threads = argc > 7 ? atoi(argv[7]) : 0;
+      int repeats = argc > 8 ? atoi(argv[8]) : 3;
+      if (threads == 0)
+         threads = max(1u, thread::hardware_concurrency());
+
+      cfg.threads = 1;
+      chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+      Acquisition acq(cfg);
+      double planTime = since(t1);
+
+      gpstk::IQFloatStream input;
+      input.open(argv[1]);
+      vector< complex<float> > samples;
+      complex<float> s;
+      while ((int)samples.size() < acq.samplesNeeded() && input >> s)
+      {
+         samples.push_back(s);
+         for (int i = 1; i < bands; i++)
+            input >> s;
+      }
+      if ((int)samples.size() < acq.samplesNeeded())
+      {
+         cerr << argv[1] << " has " << samples.size() << " of the "
+              << acq.samplesNeeded() << " samples needed" << endl;
+         return 1;
+      }
+
+      vector<int> prns;
+      for (int prn = 1; prn <= 32; prn++)
+         prns.push_back(prn);
+
+      cout << "method,prns,bins,samples,threads,seconds,detected" << endl;
+      report("plan", acq.numBins(), acq.samplesNeeded(), 1, planTime, 0);
+
+      vector<unsigned> counts(1, 1u);
+      if (threads > 1)
+         counts.push_back(threads);
+      for (size_t c = 0; c < counts.size(); c++)
+      {
+         cfg.threads = counts[c];
+         Acquisition engine(cfg);
+
+         // the first search computes the code FFTs
+         int detected = 0;
+         vector<Acquisition::Result> results = engine.acquire(samples, prns);
+         for (size_t i = 0; i < results.size(); i++)
+            if (results[i].height >= minHeight)
+               detected++;
+
+         t1 = chrono::steady_clock::now();
+         for (int r = 0; r < repeats; r++)
+            engine.acquire(samples, prns);
+         report("engine", engine.numBins(), engine.samplesNeeded(), counts[c], since(t1) / repeats, detected);
+      }
+
+      t1 = chrono::steady_clock::now();
+      int detected = legacySearch(cfg, acq.samplesPerBlock(), samples);
+      report("legacy", acq.numBins(), acq.samplesPerBlock(), 1, since(t1), detected);
+   }
+   catch (gpstk::Exception& e)
+   {
+      cerr << e << endl;
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,243 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/// @file PipelinedProcessing_bench.cpp
+/// Epochs per second of the PPP example (example8) chain, without the
+/// Kalman filter, run serially and as a PipelinedProcessingList whose
+/// stages are the reading of the RINEX file, the cycle slip detection,
+/// the modeling and the prefit residuals, with 1, 4 and 16 epochs
+/// between two stages. The file is read 'repeats' times per run.
+/// The runs are printed as CSV: queue size (0 for the serial run),
+/// epochs, seconds, epochs/s, speedup over the serial run, and the sum
+/// of the prefit residuals, which must be the same for all the runs.
+/// Then come the statistics of the stages of the last reading of the
+/// file, as printed by PipelinedProcessingList::printStats(): the stage
+/// with the highest occupancy bounds the throughput.
+///
+/// Usage: PipelinedProcessing_bench obsFile antexFile sp3File [sp3File...]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "Rinex3ObsStream.hpp"
+#include "RinexEpoch.h"
+#include "SP3EphemerisStore.hpp"
+#include "PipelinedProcessingList.hpp"
+#include "RequireObservables.hpp"
+#include "LICSDetector2.hpp"
+#include "MWCSDetector.hpp"
+#include "SatArcMarker.hpp"
+#include "SatGeometryCache.hpp"
+#include "BasicModel.hpp"
+#include "EclipsedSatFilter.hpp"
+#include "GravitationalDelay.hpp"
+#include "ComputeSatPCenter.hpp"
+#include "CorrectObservables.hpp"
+#include "ComputeWindUp.hpp"
+#include "NeillTropModel.hpp"
+#include "ComputeTropModel.hpp"
+#include "LinearCombinations.hpp"
+#include "ComputeLinear.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+namespace
+{
+      /// Processes 'obsFile' 'repeats' times, serially if 'queueSize' is
+      /// 0; returns the sum of the prefit residuals and the number of
+      /// epochs processed
+   double processFile(const string& obsFile, int repeats, size_t queueSize,
+                      XvtStore<SatID>& eph, AntexReader& antex,
+                      unsigned long& numEpochs, PipelinedProcessingList& pList)
+   {
+      double sum(0.0);
+      numEpochs = 0;
+      for (int i = 0; i < repeats; i++)
+      {
+         Rinex3ObsStream rin(obsFile.c_str());
+         rin.exceptions(ios::failbit);
+         Rinex3ObsHeader roh;
+         rin >> roh;
+         Position nominalPos(roh.antennaPosition);
+
+         RequireObservables requireObs;
+         requireObs.addRequiredType(TypeID::P1);
+         requireObs.addRequiredType(TypeID::P2);
+         requireObs.addRequiredType(TypeID::L1);
+         requireObs.addRequiredType(TypeID::L2);
+
+         LinearCombinations comb;
+         ComputeLinear linear1(comb.pdeltaCombination);
+         linear1.addLinear(comb.ldeltaCombination);
+         linear1.addLinear(comb.mwubbenaCombination);
+         linear1.addLinear(comb.liCombination);
+         LICSDetector2 markCSLI;
+         MWCSDetector markCSMW;
+         SatArcMarker markArc;
+         markArc.setDeleteUnstableSats(true);
+         markArc.setUnstablePeriod(151.0);
+
+            // the cache and the objects using it are in the same stage
+         SatGeometryCache geometry(nominalPos, eph);
+         BasicModel basic(nominalPos, eph);
+         basic.setGeometryCache(geometry);
+         EclipsedSatFilter eclipsedSV;
+         eclipsedSV.setGeometryCache(geometry);
+         GravitationalDelay grDelay(nominalPos);
+         grDelay.setGeometryCache(geometry);
+         ComputeSatPCenter svPcenter(nominalPos, antex);
+         svPcenter.setGeometryCache(geometry);
+         CorrectObservables corr(eph);
+         corr.setNominalPosition(nominalPos);
+         ComputeWindUp windup(eph, nominalPos);
+         windup.setGeometryCache(geometry);
+         NeillTropModel neillTM( nominalPos.getAltitude(),
+                                 nominalPos.getGeodeticLatitude(), 224 );
+         ComputeTropModel computeTropo(neillTM);
+
+         ComputeLinear linear2(comb.pcCombination);
+         linear2.addLinear(comb.lcCombination);
+         ComputeLinear linear3(comb.pcPrefit);
+         linear3.addLinear(comb.lcPrefit);
+
+         pList = PipelinedProcessingList(queueSize);
+         pList.addStage(requireObs, "cycle slips").add(linear1)
+            .add(markCSLI).add(markCSMW).add(markArc);
+         pList.addStage(geometry, "model").add(basic).add(eclipsedSV)
+            .add(grDelay).add(svPcenter).add(corr).add(windup)
+            .add(computeTropo);
+         pList.addStage(linear2, "prefit").add(linear3);
+
+         const CommonTime first(eph.getInitialTime()),
+                          last(eph.getFinalTime());
+         auto source = [&]() -> irinex_uptr
+         {
+            unique_ptr<RinexEpoch> gRin(new RinexEpoch);
+            while (rin >> *gRin)
+            {
+               if (gRin->getHeader().epoch >= first &&
+                   gRin->getHeader().epoch <= last)
+                  return irinex_uptr(gRin.release());
+            }
+            return irinex_uptr();
+         };
+         auto sink = [&](irinex_uptr gRin)
+         {
+            ++numEpochs;
+            for (const auto& sv : gRin->getBody())
+               sum += sv.second->get_value()(TypeID::prefitC);
+         };
+
+         if (queueSize > 0)
+         {
+            pList.run(source, sink);
+         }
+         else
+         {
+            irinex_uptr gRin;
+            while ((gRin = source()))
+            {
+               pList.Process(*gRin);
+               sink(std::move(gRin));
+            }
+         }
+      }
+      return sum;
+   }
+}
+
+
+int main(int argc, char* argv[])
+{
+   if (argc < 4)
+   {
+      cerr << "Usage: " << argv[0]
+           << " obsFile antexFile sp3File [sp3File...]" << endl;
+      return 1;
+   }
+   int repeats = getenv("BENCH_REPEATS") ? atoi(getenv("BENCH_REPEATS")) : 3;
+
+   try
+   {
+      SP3EphemerisStore sp3;
+      sp3.rejectBadPositions(true);
+      sp3.rejectBadClocks(true);
+      for (int i = 3; i < argc; i++)
+         sp3.loadFile(argv[i]);
+
+      AntexReader antex;
+      antex.open(argv[2]);
+
+      cout << "queue,epochs,seconds,epochs_per_s,speedup,prefit_sum" << endl;
+
+      PipelinedProcessingList pList;
+      double serialRate(0.0);
+      size_t queueSizes[] = { 0, 1, 4, 16 };
+      for (size_t n : queueSizes)
+      {
+         unsigned long numEpochs(0);
+
+         auto t1 = chrono::steady_clock::now();
+         double sum = processFile(argv[1], repeats, n, sp3, antex,
+                                  numEpochs, pList);
+         chrono::duration<double> dt = chrono::steady_clock::now() - t1;
+
+         double rate = numEpochs / dt.count();
+         if (n == 0)
+            serialRate = rate;
+
+         cout.precision(6);
+         cout << n << "," << numEpochs << "," << dt.count() << ","
+              << rate << "," << rate / serialRate << ",";
+         cout.precision(15);
+         cout << sum << endl;
+      }
+
+      cout << endl;
+      cout.precision(6);
+      pList.printStats(cout);
+   }
+   catch (Exception& e)
+   {
+      cerr << e << endl;
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,208 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+/// @file ProcessingThreads_bench.cpp
+/// Epochs per second of the modeling chain of the PPP example (example8)
+/// with the parallel-safe objects (BasicModel, GravitationalDelay,
+/// ComputeSatPCenter and ComputeTropModel) processing the satellites of
+/// each epoch on 1, 2, 4 and 8 threads of a ProcessingThreadPool; the
+/// other objects of the chain run serially. The epochs are read first,
+/// and each run models copies of them 'repeats' times; the cycle slip
+/// detection and the Kalman filter are left out.
+/// The results are printed as CSV: threads, epochs, satellites per
+/// epoch, seconds, epochs/s, speedup over one thread, and the sum of
+/// the prefit residuals, which must not depend on the threads.
+///
+/// Usage: ProcessingThreads_bench obsFile antexFile sp3File [sp3File...]
+///
+/// e.g. with the data of the examples:
+///    ProcessingThreads_bench onsa2240.05o igs05.atx igs13354.sp3 igs13355.sp3
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Rinex3ObsStream.hpp"
+#include "RinexEpoch.h"
+#include "SP3EphemerisStore.hpp"
+#include "ProcessingThreadPool.hpp"
+#include "RequireObservables.hpp"
+#include "BasicModel.hpp"
+#include "EclipsedSatFilter.hpp"
+#include "GravitationalDelay.hpp"
+#include "ComputeSatPCenter.hpp"
+#include "CorrectObservables.hpp"
+#include "ComputeWindUp.hpp"
+#include "NeillTropModel.hpp"
+#include "ComputeTropModel.hpp"
+#include "LinearCombinations.hpp"
+#include "ComputeLinear.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+namespace
+{
+      /// Models 'epochs' 'repeats' times; returns the sum of the prefit
+      /// residuals and the number of satellites modeled
+   double modelEpochs(const vector<RinexEpoch>& epochs, int repeats,
+                      XvtStore<SatID>& eph, AntexReader& antex,
+                      const Position& nominalPos, ProcessingThreadPool* pool,
+                      unsigned long& numSats)
+   {
+      RequireObservables requireObs;
+      requireObs.addRequiredType(TypeID::P1);
+      requireObs.addRequiredType(TypeID::P2);
+      requireObs.addRequiredType(TypeID::L1);
+      requireObs.addRequiredType(TypeID::L2);
+
+      BasicModel basic(nominalPos, eph);
+      EclipsedSatFilter eclipsedSV;
+      GravitationalDelay grDelay(nominalPos);
+      ComputeSatPCenter svPcenter(nominalPos, antex);
+      CorrectObservables corr(eph);
+      corr.setNominalPosition(nominalPos);
+      ComputeWindUp windup(eph, nominalPos);
+      NeillTropModel neillTM( nominalPos.getAltitude(),
+                              nominalPos.getGeodeticLatitude(), 224 );
+      ComputeTropModel computeTropo(neillTM);
+
+      LinearCombinations comb;
+      ComputeLinear linear2(comb.pcCombination);
+      linear2.addLinear(comb.lcCombination);
+      ComputeLinear linear3(comb.pcPrefit);
+      linear3.addLinear(comb.lcPrefit);
+
+      basic.setThreadPool(pool);
+      grDelay.setThreadPool(pool);
+      svPcenter.setThreadPool(pool);
+      computeTropo.setThreadPool(pool);
+
+      double sum(0.0);
+      numSats = 0;
+      for (int i = 0; i < repeats; i++)
+      {
+         for (const auto& it : epochs)
+         {
+            RinexEpoch gRin(it);
+            gRin >> requireObs >> basic >> eclipsedSV >> grDelay
+                 >> svPcenter >> corr >> windup >> computeTropo
+                 >> linear2 >> linear3;
+
+            numSats += gRin.getBody().numSats();
+            for (const auto& sv : gRin.getBody())
+               sum += sv.second->get_value()(TypeID::prefitC);
+         }
+      }
+      return sum;
+   }
+}
+
+
+int main(int argc, char* argv[])
+{
+   if (argc < 4)
+   {
+      cerr << "Usage: " << argv[0]
+           << " obsFile antexFile sp3File [sp3File...]" << endl;
+      return 1;
+   }
+   int repeats = getenv("BENCH_REPEATS") ? atoi(getenv("BENCH_REPEATS")) : 5;
+
+   try
+   {
+      SP3EphemerisStore sp3;
+      sp3.rejectBadPositions(true);
+      sp3.rejectBadClocks(true);
+      for (int i = 3; i < argc; i++)
+         sp3.loadFile(argv[i]);
+
+      AntexReader antex;
+      antex.open(argv[2]);
+
+      Rinex3ObsStream rin(argv[1]);
+      rin.exceptions(ios::failbit);
+      Rinex3ObsHeader roh;
+      rin >> roh;
+      Position nominalPos(roh.antennaPosition);
+
+      vector<RinexEpoch> epochs;
+      RinexEpoch gRin;
+      while (rin >> gRin)
+      {
+         if (gRin.getHeader().epoch < sp3.getInitialTime() ||
+             gRin.getHeader().epoch > sp3.getFinalTime())
+            continue;
+         epochs.push_back(gRin);
+      }
+
+      cout << "threads,epochs,sats_per_epoch,seconds,epochs_per_s,speedup,"
+           << "prefit_sum" << endl;
+
+      double serialRate(0.0);
+      unsigned threads[] = { 1, 2, 4, 8 };
+      for (unsigned n : threads)
+      {
+         ProcessingThreadPool pool(n);
+         unsigned long numSats(0);
+
+         auto t1 = chrono::steady_clock::now();
+         double sum = modelEpochs(epochs, repeats, sp3, antex, nominalPos,
+                                  &pool, numSats);
+         chrono::duration<double> dt = chrono::steady_clock::now() - t1;
+
+         double numEpochs = double(epochs.size()) * repeats;
+         double rate = numEpochs / dt.count();
+         if (n == 1)
+            serialRate = rate;
+
+         cout.precision(6);
+         cout << n << "," << (unsigned long)numEpochs << ","
+              << numSats / numEpochs << "," << dt.count() << ","
+              << rate << "," << rate / serialRate << ",";
+         cout.precision(15);
+         cout << sum << endl;
+      }
+   }
+   catch (Exception& e)
+   {
+      cerr << e << endl;
+      return 1;
+   }
+
+   return 0;
+}
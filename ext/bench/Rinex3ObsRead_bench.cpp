@@ -0,0 +1,151 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/// @file Rinex3ObsRead_bench.cpp
+/// Read throughput of a RINEX observation file with Rinex3ObsStream and
+/// with Rinex3ObsMappedReader, and of its Rinex3ObsCacheStream cache.
+/// The file is read 'repeats' times by each reader and the results are
+/// printed as CSV: reader, epochs, MB, MB/s. The MB are those of the
+/// RINEX file for all the readers, so that the rates compare.
+///
+/// Usage: Rinex3ObsRead_bench file [repeats [cache]]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "Rinex3ObsCacheStream.hpp"
+#include "Rinex3ObsMappedReader.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsData.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+namespace
+{
+   void report(const string& name, unsigned long epochs, double bytes,
+               chrono::steady_clock::time_point t1)
+   {
+      chrono::duration<double> dt = chrono::steady_clock::now() - t1;
+      double mb = bytes / 1e6;
+      cout << name << "," << epochs << "," << mb << "," << mb/dt.count()
+           << endl;
+   }
+}
+
+
+int main(int argc, char* argv[])
+{
+   if (argc < 2)
+   {
+      cerr << "Usage: " << argv[0] << " file [repeats [cache]]" << endl;
+      return 1;
+   }
+   string file = argv[1];
+   int repeats = argc > 2 ? atoi(argv[2]) : 10;
+   string cache = argc > 3 ? argv[3] : "Rinex3ObsRead_bench.obc";
+
+   try
+   {
+      double bytes(0);
+      unsigned long epochs(0);
+      Rinex3ObsData rod;
+
+      cout << "reader,epochs,MB,MB_per_s" << endl;
+
+      chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+      for (int i = 0; i < repeats; i++)
+      {
+         Rinex3ObsStream strm(file.c_str());
+         strm.exceptions(ios::failbit);
+         Rinex3ObsHeader hdr;
+         strm >> hdr;
+         while (strm >> rod)
+            epochs++;
+         strm.clear();
+         strm.seekg(0, ios::end);
+         bytes += strm.tellg();
+      }
+      report("Rinex3ObsStream", epochs, bytes, t1);
+
+      bytes = 0;
+      epochs = 0;
+      t1 = chrono::steady_clock::now();
+      for (int i = 0; i < repeats; i++)
+      {
+         Rinex3ObsMappedReader reader(file);
+         while (reader.read(rod))
+            epochs++;
+         bytes += reader.size();
+      }
+      report("Rinex3ObsMappedReader", epochs, bytes, t1);
+
+      {
+         Rinex3ObsMappedReader reader(file);
+         Rinex3ObsCacheStream out(cache.c_str(), ios::out);
+         out.exceptions(ios::failbit);
+         Rinex3ObsHeader hdr(reader.getHeader());
+         out << hdr;
+         while (reader.read(rod))
+            out << rod;
+      }
+
+      double rinexBytes = bytes / repeats;
+      bytes = 0;
+      epochs = 0;
+      t1 = chrono::steady_clock::now();
+      for (int i = 0; i < repeats; i++)
+      {
+         Rinex3ObsCacheStream strm(cache.c_str());
+         strm.exceptions(ios::failbit);
+         Rinex3ObsHeader hdr;
+         strm >> hdr;
+         while (strm >> rod)
+            epochs++;
+         bytes += rinexBytes;
+      }
+      report("Rinex3ObsCacheStream", epochs, bytes, t1);
+   }
+   catch (Exception& e)
+   {
+      cerr << e << endl;
+      return 1;
+   }
+
+   return 0;
+}
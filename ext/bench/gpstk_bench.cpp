@@ -0,0 +1,844 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/// @file gpstk_bench.cpp
+/// Benchmark suite of the hot paths of the toolkit, to follow their
+/// performance from release to release:
+///
+/// - CommonTime arithmetic and conversions;
+/// - Rinex3ObsStream reading, in MB/s;
+/// - getXvt of SP3EphemerisStore, thawed and frozen, and of
+///   GPSEphemerisStore, and svXvt of GloEphemeris, with and without its
+///   propagation cache;
+/// - Matrix multiplication and inverseChol;
+/// - PRSolution::RAIMCompute;
+/// - a PPP epoch: the modeling chain of example8 and the cycle slip
+///   detection, followed by a reference float PPP filter written here
+///   with the kernels of KalmanSolver (not KalmanSolver itself, which
+///   is in POD).
+///
+/// Each benchmark runs until it has taken at least BENCH_MIN_TIME
+/// seconds (0.5 by default). The results are printed as CSV: benchmark,
+/// iterations, seconds, ns per iteration, rate and its unit, and a
+/// checksum of the results, the same from one build to the next for the
+/// same number of iterations.
+/// A benchmark whose data are missing is reported on stderr and skipped.
+///
+/// The data are those of the source tree (data/ and examples/).
+///
+/// Usage: gpstk_bench [name...]
+///    runs the benchmarks whose name contains one of the arguments,
+///    or all of them.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "build_config.h"
+
+#include "CommonTime.hpp"
+#include "CivilTime.hpp"
+#include "GPSWeekSecond.hpp"
+#include "MJD.hpp"
+#include "YDSTime.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsData.hpp"
+#include "Rinex3NavStream.hpp"
+#include "Rinex3NavData.hpp"
+#include "SP3EphemerisStore.hpp"
+#include "GPSEphemerisStore.hpp"
+#include "GloEphemeris.hpp"
+#include "Matrix.hpp"
+#include "MatrixKernels.hpp"
+#include "PRSolution.hpp"
+#include "GGTropModel.hpp"
+
+#include "RinexEpoch.h"
+#include "RequireObservables.hpp"
+#include "LinearCombinations.hpp"
+#include "ComputeLinear.hpp"
+#include "LICSDetector2.hpp"
+#include "MWCSDetector.hpp"
+#include "SatArcMarker.hpp"
+#include "BasicModel.hpp"
+#include "EclipsedSatFilter.hpp"
+#include "GravitationalDelay.hpp"
+#include "ComputeSatPCenter.hpp"
+#include "CorrectObservables.hpp"
+#include "ComputeWindUp.hpp"
+#include "NeillTropModel.hpp"
+#include "ComputeTropModel.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+namespace
+{
+      /** Runs 'n' iterations of a benchmark; returns a checksum of the
+       *  results, and adds the work done (bytes, calls, ...) to 'work'.
+       */
+   typedef function<double(unsigned long n, double& work)> BenchFunc;
+
+   struct Benchmark
+   {
+      string name;
+
+         /// unit of the rate: the work done per second
+      string unit;
+
+      BenchFunc run;
+
+         /// if set, called with the number of iterations before each
+         /// timed run, to prepare their data
+      function<void(unsigned long n)> prepare;
+   };
+
+
+   string dataFile(const string& name)
+   {
+      return getPathData() + getFileSep() + name;
+   }
+
+   string exampleFile(const string& name)
+   {
+      return getPathSrc() + getFileSep() + "examples" + getFileSep() + name;
+   }
+
+   double fileSize(const string& path)
+   {
+      ifstream f(path.c_str(), ios::binary | ios::ate);
+      if (!f)
+      {
+         FileMissingException e("Cannot open " + path);
+         GPSTK_THROW(e);
+      }
+      return (double)f.tellg();
+   }
+
+
+      /// Runs 'b' until it takes 'minTime' s, and prints its results
+   void runBenchmark(const Benchmark& b, double minTime)
+   {
+      typedef chrono::steady_clock Clock;
+
+      unsigned long n(1);
+      for (;;)
+      {
+         double work(0.0);
+         if (b.prepare)
+            b.prepare(n);
+         Clock::time_point t1 = Clock::now();
+         double check = b.run(n, work);
+         chrono::duration<double> dt = Clock::now() - t1;
+         double s = dt.count();
+
+         if (s >= minTime)
+         {
+            cout.precision(6);
+            cout << b.name << "," << n << "," << s << "," << s * 1e9 / n
+                 << "," << work / s << "," << b.unit << ",";
+            cout.precision(15);
+            cout << check << endl;
+            return;
+         }
+
+            // aim at 1.2 times the minimum time, at most 10 times more
+         double f = (s > 0.0) ? 1.2 * minTime / s : 10.0;
+         n = (unsigned long)(n * min(max(f, 2.0), 10.0));
+      }
+   }
+
+
+   //---------------------------------------------------------------------
+   // CommonTime
+
+   void addTimeBenchmarks(vector<Benchmark>& benches)
+   {
+      const CommonTime t0 = CivilTime(2015, 7, 19, 0, 0, 0.0, TimeSystem::GPS);
+
+      benches.push_back(Benchmark{ "CommonTime::addSeconds", "ops/s",
+         [t0](unsigned long n, double& work)
+         {
+            CommonTime t(t0);
+            for (unsigned long i = 0; i < n; i++)
+               t.addSeconds(0.25);
+            work += n;
+            return t - t0;
+         } });
+
+      benches.push_back(Benchmark{ "CommonTime::difference", "ops/s",
+         [t0](unsigned long n, double& work)
+         {
+            CommonTime t(t0);
+            double sum(0.0);
+            for (unsigned long i = 0; i < n; i++)
+            {
+               t += 30.0;
+               sum += t - t0;
+            }
+            work += n;
+            return sum;
+         } });
+
+      benches.push_back(Benchmark{ "CommonTime->CivilTime", "ops/s",
+         [t0](unsigned long n, double& work)
+         {
+            CommonTime t(t0);
+            double sum(0.0);
+            for (unsigned long i = 0; i < n; i++)
+            {
+               t += 30.0;
+               CivilTime ct(t);
+               sum += ct.hour + ct.second;
+            }
+            work += n;
+            return sum;
+         } });
+
+      benches.push_back(Benchmark{ "CivilTime->CommonTime", "ops/s",
+         [](unsigned long n, double& work)
+         {
+            double sum(0.0);
+            for (unsigned long i = 0; i < n; i++)
+            {
+               CivilTime ct(2015, 7, 19, i % 24, i % 60, 0.5 * (i % 120),
+                            TimeSystem::GPS);
+               sum += ct.convertToCommonTime().getSecondOfDay();
+            }
+            work += n;
+            return sum;
+         } });
+
+      benches.push_back(Benchmark{ "CommonTime->GPSWeekSecond", "ops/s",
+         [t0](unsigned long n, double& work)
+         {
+            CommonTime t(t0);
+            double sum(0.0);
+            for (unsigned long i = 0; i < n; i++)
+            {
+               t += 30.0;
+               GPSWeekSecond ws(t);
+               sum += ws.sow;
+            }
+            work += n;
+            return sum;
+         } });
+
+      benches.push_back(Benchmark{ "GPSWeekSecond->CommonTime", "ops/s",
+         [](unsigned long n, double& work)
+         {
+            double sum(0.0);
+            for (unsigned long i = 0; i < n; i++)
+            {
+               GPSWeekSecond ws(1850, 30.0 * (i % 20160), TimeSystem::GPS);
+               sum += ws.convertToCommonTime().getSecondOfDay();
+            }
+            work += n;
+            return sum;
+         } });
+
+      benches.push_back(Benchmark{ "CommonTime->MJD", "ops/s",
+         [t0](unsigned long n, double& work)
+         {
+            CommonTime t(t0);
+            double sum(0.0);
+            for (unsigned long i = 0; i < n; i++)
+            {
+               t += 30.0;
+               sum += (double)(MJD(t).mjd - 57000.0L);
+            }
+            work += n;
+            return sum;
+         } });
+   }
+
+
+   //---------------------------------------------------------------------
+   // Rinex3ObsStream
+
+   void addRinexBenchmarks(vector<Benchmark>& benches)
+   {
+      const char* files[][2] = {
+         { "Rinex3ObsStream RINEX 2.11", "examples/madr1480.08o" },
+         { "Rinex3ObsStream RINEX 3", "data/test_input_rinex3_76193040.14o" } };
+
+      for (const auto& it : files)
+      {
+         string path = getPathSrc() + getFileSep() + it[1];
+         double bytes = fileSize(path);
+
+         benches.push_back(Benchmark{ it[0], "MB/s",
+            [path, bytes](unsigned long n, double& work)
+            {
+               double sum(0.0);
+               Rinex3ObsData rod;
+               for (unsigned long i = 0; i < n; i++)
+               {
+                  Rinex3ObsStream strm(path.c_str());
+                  strm.exceptions(ios::failbit);
+                  Rinex3ObsHeader hdr;
+                  strm >> hdr;
+                  while (strm >> rod)
+                     sum += rod.numSVs;
+               }
+               work += n * bytes * 1e-6;
+               return sum;
+            } });
+      }
+   }
+
+
+   //---------------------------------------------------------------------
+   // Ephemerides
+
+      /// 'n' getXvt calls of 'eph', for 'sats' from 't1' on, 'step' s
+      /// apart, wrapping at 't2'
+   double xvtLoop( const XvtStore<SatID>& eph, const vector<SatID>& sats,
+                   const CommonTime& t1, const CommonTime& t2, double step,
+                   unsigned long n )
+   {
+      double sum(0.0);
+      CommonTime t(t1);
+      size_t i(0);
+      for (unsigned long k = 0; k < n; k++)
+      {
+         try
+         {
+            Xvt xvt = eph.getXvt(sats[i], t);
+            sum += xvt.x[0] * 1e-6 + xvt.clkbias;
+         }
+         catch (InvalidRequest&)
+         {
+         }
+
+         if (++i == sats.size())
+         {
+            i = 0;
+            t += step;
+            if (t > t2)
+               t = t1;
+         }
+      }
+      return sum;
+   }
+
+   void addEphemerisBenchmarks(vector<Benchmark>& benches)
+   {
+      const char* sp3Files[] = { "igs14811.sp3", "igs14812.sp3", "igs14813.sp3" };
+      for (bool frozen : { false, true })
+      {
+         auto sp3 = make_shared<SP3EphemerisStore>();
+         for (const char* f : sp3Files)
+            sp3->loadFile(exampleFile(f));
+         if (frozen)
+            sp3->freeze();
+
+         auto sp3Sats = make_shared<vector<SatID> >(sp3->getSatList());
+            // the middle day, away from the ends of the interpolation
+         CommonTime sp3Start = sp3->getInitialTime() + 86400.0;
+         benches.push_back(Benchmark{ frozen ? "SP3EphemerisStore::getXvt frozen"
+                                             : "SP3EphemerisStore::getXvt",
+                                      "calls/s",
+            [sp3, sp3Sats, sp3Start](unsigned long n, double& work)
+            {
+               work += n;
+               return xvtLoop(*sp3, *sp3Sats, sp3Start, sp3Start + 86400.0,
+                              30.0, n);
+            } });
+      }
+
+      auto gps = make_shared<GPSEphemerisStore>();
+      auto gpsSats = make_shared<vector<SatID> >();
+      {
+         Rinex3NavStream strm(dataFile("arlm2000.15n").c_str());
+         strm.exceptions(ios::failbit);
+         Rinex3NavHeader hdr;
+         Rinex3NavData rnd;
+         strm >> hdr;
+         while (strm >> rnd)
+         {
+            if (rnd.satSys != "G")
+               continue;
+            gps->addEphemeris(GPSEphemeris(rnd));
+            SatID sat(rnd.PRNID, SatID::systemGPS);
+            if (find(gpsSats->begin(), gpsSats->end(), sat) == gpsSats->end())
+               gpsSats->push_back(sat);
+         }
+      }
+      CommonTime gpsStart = gps->getInitialTime() + 7200.0;
+      CommonTime gpsEnd = gps->getFinalTime() - 7200.0;
+      benches.push_back(Benchmark{ "GPSEphemerisStore::getXvt", "calls/s",
+         [gps, gpsSats, gpsStart, gpsEnd](unsigned long n, double& work)
+         {
+            work += n;
+            return xvtLoop(*gps, *gpsSats, gpsStart, gpsEnd, 30.0, n);
+         } });
+
+         // a record as in the GloEphemeris test, and 1 s steps through
+         // its 30 min validity
+      for (bool cache : { true, false })
+      {
+         auto glo = make_shared<GloEphemeris>();
+         CommonTime t = CivilTime(2015, 7, 19, 0, 15, 0.0, TimeSystem::GLO);
+         glo->setRecord("R", 1, t,
+                        Triple(15000.0, -10000.0, 18000.0),
+                        Triple(-2.0, 1.5, 2.5),
+                        Triple(1.9e-9, -2.8e-9, -9.3e-10),
+                        -6.2e-5, 0.0, 345600, 0, 1, 0.0);
+         glo->setPropagationCache(cache);
+
+         benches.push_back(Benchmark{ cache ? "GloEphemeris::svXvt"
+                                            : "GloEphemeris::svXvt no cache",
+                                      "calls/s",
+            [glo, t](unsigned long n, double& work)
+            {
+               double sum(0.0);
+               for (unsigned long i = 0; i < n; i++)
+               {
+                  Xvt xvt = glo->svXvt(t + (double)(i % 1800) - 900.0);
+                  sum += xvt.x[0] * 1e-6;
+               }
+               work += n;
+               return sum;
+            } });
+      }
+   }
+
+
+   //---------------------------------------------------------------------
+   // Matrix
+
+      /// Symmetric positive definite matrix of dimension 'n'
+   Matrix<double> spdMatrix(size_t n)
+   {
+      Matrix<double> a(n, n);
+      for (size_t i = 0; i < n; i++)
+         for (size_t j = 0; j < n; j++)
+            a(i, j) = 1.0 / (1.0 + i + j) + (i == j ? n : 0.0);
+      return a;
+   }
+
+   void addMatrixBenchmarks(vector<Benchmark>& benches)
+   {
+      for (size_t dim : { 8, 32, 128 })
+      {
+         auto a = make_shared<Matrix<double> >(spdMatrix(dim));
+         string d = StringUtils::asString(dim);
+
+         benches.push_back(Benchmark{ "Matrix multiply " + d, "Mflop/s",
+            [a, dim](unsigned long n, double& work)
+            {
+               double sum(0.0);
+               for (unsigned long i = 0; i < n; i++)
+               {
+                  Matrix<double> c = (*a) * (*a);
+                  sum += c(i % dim, 0);
+               }
+               work += 2e-6 * dim * dim * dim * n;
+               return sum;
+            } });
+
+         benches.push_back(Benchmark{ "inverseChol " + d, "ops/s",
+            [a, dim](unsigned long n, double& work)
+            {
+               double sum(0.0);
+               for (unsigned long i = 0; i < n; i++)
+               {
+                  Matrix<double> inv = inverseChol(*a);
+                  sum += inv(i % dim, 0);
+               }
+               work += n;
+               return sum;
+            } });
+      }
+   }
+
+
+   //---------------------------------------------------------------------
+   // PRSolution
+
+   struct PREpoch
+   {
+      CommonTime time;
+      vector<SatID> sats;
+      vector<double> ranges;
+   };
+
+   void addPRSolutionBenchmarks(vector<Benchmark>& benches)
+   {
+      auto eph = make_shared<GPSEphemerisStore>();
+      {
+         Rinex3NavStream strm(dataFile("arlm2000.15n").c_str());
+         strm.exceptions(ios::failbit);
+         Rinex3NavHeader hdr;
+         Rinex3NavData rnd;
+         strm >> hdr;
+         while (strm >> rnd)
+         {
+            if (rnd.satSys == "G")
+               eph->addEphemeris(GPSEphemeris(rnd));
+         }
+      }
+
+      auto epochs = make_shared<vector<PREpoch> >();
+      {
+         Rinex3ObsStream strm(dataFile("arlm200a.15o").c_str());
+         strm.exceptions(ios::failbit);
+         Rinex3ObsHeader hdr;
+         Rinex3ObsData rod;
+         strm >> hdr;
+         while (strm >> rod)
+         {
+            PREpoch ep;
+            ep.time = rod.time;
+            for (const auto& it : rod.obs)
+            {
+               if (it.first.system != SatID::systemGPS)
+                  continue;
+               double c1 = rod.getObs(it.first, "C1", hdr).data;
+               if (c1 == 0.0)
+                  continue;
+               ep.sats.push_back(it.first);
+               ep.ranges.push_back(c1);
+            }
+            if (ep.sats.size() > 5)
+               epochs->push_back(ep);
+         }
+      }
+      if (epochs->empty())
+      {
+         Exception e("No epoch with enough satellites");
+         GPSTK_THROW(e);
+      }
+
+      benches.push_back(Benchmark{ "PRSolution::RAIMCompute", "solutions/s",
+         [eph, epochs](unsigned long n, double& work)
+         {
+            GGTropModel trop;
+            PRSolution prs;
+               // each epoch from scratch, without a priori solution
+            prs.hasMemory = false;
+            Matrix<double> invMC;
+            double sum(0.0);
+            for (unsigned long i = 0; i < n; i++)
+            {
+               const PREpoch& ep((*epochs)[i % epochs->size()]);
+               vector<SatID> sats(ep.sats);
+               vector<SatID::SatelliteSystem> systems(1, SatID::systemGPS);
+               int iret = prs.RAIMCompute(ep.time, sats, systems, ep.ranges,
+                                          invMC, eph.get(), &trop);
+               if (iret >= 0)
+                  sum += prs.Solution(3) * 1e-3;
+            }
+            work += n;
+            return sum;
+         } });
+   }
+
+
+   //---------------------------------------------------------------------
+   // PPP epoch
+
+      /** Reference float PPP filter of a static receiver with GPS
+       *  satellites: position, clock, zenith wet delay and an ambiguity
+       *  per PRN, updated with the prefit residuals of PC and LC by the
+       *  kernels of the KalmanSolver of POD. It stands for the filter
+       *  step in this benchmark; it is not KalmanSolver.
+       */
+   class PppFilter
+   {
+   public:
+      static const int MAX_PRN = 32;
+      static const int NUM_STATES = 5 + MAX_PRN;
+
+      PppFilter()
+         : x(NUM_STATES, 0.0), P(NUM_STATES, NUM_STATES, 0.0),
+           Q(NUM_STATES, NUM_STATES, 0.0),
+           Phi(NUM_STATES, NUM_STATES, 0.0), arcs(MAX_PRN + 1, -1.0)
+      {
+         for (int i = 0; i < NUM_STATES; i++)
+         {
+            P(i, i) = 1e8;
+            Phi(i, i) = 1.0;
+         }
+         P(4, 4) = 0.25;
+      }
+
+      double update(IRinex& gData)
+      {
+            // white noise clock, random walk troposphere
+         Q(3, 3) = 9e10;
+         Q(4, 4) = 3e-8 * 30.0;
+         P(3, 3) = 0.0;
+
+         const SatTypePtrMap& body(gData.getBody());
+         size_t m = 2 * body.size();
+         H.resize(m, NUM_STATES, 0.0);
+         W.resize(m, m, 0.0);
+         y.resize(m);
+         int row(0);
+         for (const auto& it : body)
+         {
+            int prn = it.first.id;
+            if (it.first.system != SatID::systemGPS || prn > MAX_PRN)
+               continue;
+            const typeValueMap& tv(it.second->get_value());
+
+               // new arc: new ambiguity
+            int a = 4 + prn;
+            double arc = tv.getValue(TypeID::satArc);
+            if (arc != arcs[prn])
+            {
+               arcs[prn] = arc;
+               x[a] = 0.0;
+               for (int i = 0; i < NUM_STATES; i++)
+                  P(a, i) = P(i, a) = 0.0;
+               P(a, a) = 1e8;
+            }
+
+            for (int k = 0; k < 2; k++, row++)
+            {
+               H(row, 0) = tv.getValue(TypeID::dx);
+               H(row, 1) = tv.getValue(TypeID::dy);
+               H(row, 2) = tv.getValue(TypeID::dz);
+               H(row, 3) = 1.0;
+               H(row, 4) = tv.getValue(TypeID::wetMap);
+               H(row, a) = (k == 1) ? 1.0 : 0.0;
+               y[row] = tv.getValue(k == 0 ? TypeID::prefitC : TypeID::prefitL);
+               W(row, row) = (k == 0) ? 1.0 : 1e4;
+            }
+         }
+         H.resize(row, NUM_STATES);
+         W.resize(row, row);
+         y.resize(row);
+
+         propagateCovariance(Phi, P, Q, pMinus, work);
+         multiplyInto(Phi, x, xMinus);
+
+            // information form, as KalmanSolver
+         info = pMinus;
+         choleskyFactor(info);
+         choleskyInvert(info);
+         multiplyInto(info, xMinus, b);
+         accumulateNormals(H, W, y, info, b, work);
+         choleskyFactor(info);
+         x = b;
+         choleskySolve(info, x);
+         choleskyInvert(info);
+         P = info;
+
+         return x[0] + x[1] + x[2];
+      }
+
+   private:
+      Vector<double> x, xMinus, y, b;
+      Matrix<double> P, Q, Phi, pMinus, info, H, W, work;
+      vector<double> arcs;
+   };
+
+      /// The processing objects of the PPP of example8
+   struct PppChain
+   {
+      PppChain(XvtStore<SatID>& eph, AntexReader& antex, const Position& pos)
+         : basic(pos, eph), grDelay(pos), svPcenter(pos, antex),
+           corr(eph), windup(eph, pos),
+           neillTM(pos.getAltitude(), pos.getGeodeticLatitude(), 148),
+           computeTropo(neillTM),
+           linear1(comb.pdeltaCombination), linear2(comb.pcCombination),
+           linear3(comb.pcPrefit)
+      {
+         requireObs.addRequiredType(TypeID::P1);
+         requireObs.addRequiredType(TypeID::P2);
+         requireObs.addRequiredType(TypeID::L1);
+         requireObs.addRequiredType(TypeID::L2);
+         linear1.addLinear(comb.ldeltaCombination);
+         linear1.addLinear(comb.mwubbenaCombination);
+         linear1.addLinear(comb.liCombination);
+         markArc.setDeleteUnstableSats(true);
+         markArc.setUnstablePeriod(151.0);
+         corr.setNominalPosition(pos);
+         linear2.addLinear(comb.lcCombination);
+         linear3.addLinear(comb.lcPrefit);
+      }
+
+      double process(IRinex& gRin)
+      {
+         gRin >> requireObs >> linear1 >> markCSLI >> markCSMW >> markArc
+              >> basic >> eclipsedSV >> grDelay >> svPcenter >> corr
+              >> windup >> computeTropo >> linear2 >> linear3;
+         return filter.update(gRin);
+      }
+
+      RequireObservables requireObs;
+      LinearCombinations comb;
+      LICSDetector2 markCSLI;
+      MWCSDetector markCSMW;
+      SatArcMarker markArc;
+      BasicModel basic;
+      EclipsedSatFilter eclipsedSV;
+      GravitationalDelay grDelay;
+      ComputeSatPCenter svPcenter;
+      CorrectObservables corr;
+      ComputeWindUp windup;
+      NeillTropModel neillTM;
+      ComputeTropModel computeTropo;
+      ComputeLinear linear1, linear2, linear3;
+      PppFilter filter;
+   };
+
+   void addPppBenchmarks(vector<Benchmark>& benches)
+   {
+      auto sp3 = make_shared<SP3EphemerisStore>();
+      sp3->rejectBadPositions(true);
+      sp3->rejectBadClocks(true);
+      const char* sp3Files[] = { "igs14811.sp3", "igs14812.sp3", "igs14813.sp3" };
+      for (const char* f : sp3Files)
+         sp3->loadFile(exampleFile(f));
+
+      auto antex = make_shared<AntexReader>();
+      antex->open(exampleFile("igs05.atx"));
+
+      auto epochs = make_shared<vector<RinexEpoch> >();
+      Rinex3ObsStream rin(exampleFile("madr1480.08o").c_str());
+      rin.exceptions(ios::failbit);
+      Rinex3ObsHeader roh;
+      rin >> roh;
+      Position pos(roh.antennaPosition);
+      RinexEpoch gRin;
+      while (rin >> gRin)
+      {
+         if (gRin.getHeader().epoch >= sp3->getInitialTime() &&
+             gRin.getHeader().epoch <= sp3->getFinalTime())
+            epochs->push_back(gRin);
+      }
+
+         // the filter and the detectors go on from one run to the next,
+         // and start over when the epochs do
+      auto chain = make_shared<unique_ptr<PppChain> >();
+      auto next = make_shared<size_t>(0);
+
+         // the epochs of a run, copied before it as they are modified
+      auto batch = make_shared<vector<RinexEpoch> >();
+
+      benches.push_back(Benchmark{ "PPP model chain + reference float filter",
+                                   "epochs/s",
+         [sp3, antex, batch, pos, chain, next, epochs](unsigned long n,
+                                                        double& work)
+         {
+            double sum(0.0);
+            for (unsigned long i = 0; i < n; i++)
+            {
+               if (*next == 0 || !*chain)
+                  chain->reset(new PppChain(*sp3, *antex, pos));
+
+               sum += (*chain)->process((*batch)[i]);
+               *next = (*next + 1) % epochs->size();
+            }
+            work += n;
+            return sum;
+         },
+         [epochs, next, batch](unsigned long n)
+         {
+            batch->clear();
+            batch->reserve(n);
+            for (unsigned long i = 0; i < n; i++)
+               batch->push_back((*epochs)[(*next + i) % epochs->size()]);
+         } });
+   }
+}
+
+
+int main(int argc, char* argv[])
+{
+   double minTime = getenv("BENCH_MIN_TIME") ? atof(getenv("BENCH_MIN_TIME"))
+                                             : 0.5;
+
+   vector<Benchmark> benches;
+   typedef void (*AddFunc)(vector<Benchmark>&);
+   pair<const char*, AddFunc> groups[] = {
+      make_pair("CommonTime", addTimeBenchmarks),
+      make_pair("Rinex3ObsStream", addRinexBenchmarks),
+      make_pair("ephemeris", addEphemerisBenchmarks),
+      make_pair("Matrix", addMatrixBenchmarks),
+      make_pair("PRSolution", addPRSolutionBenchmarks),
+      make_pair("PPP", addPppBenchmarks) };
+
+   for (const auto& it : groups)
+   {
+      try
+      {
+         it.second(benches);
+      }
+      catch (Exception& e)
+      {
+         cerr << it.first << " benchmarks skipped: " << e.getText() << endl;
+      }
+      catch (std::exception& e)
+      {
+         cerr << it.first << " benchmarks skipped: " << e.what() << endl;
+      }
+   }
+
+   cout << "benchmark,iterations,seconds,ns_per_iteration,rate,unit,checksum"
+        << endl;
+
+   for (const auto& b : benches)
+   {
+      bool selected = (argc < 2);
+      for (int i = 1; i < argc && !selected; i++)
+         selected = (b.name.find(argv[i]) != string::npos);
+      if (!selected)
+         continue;
+
+      try
+      {
+         runBenchmark(b, minTime);
+      }
+      catch (Exception& e)
+      {
+         cerr << b.name << " failed: " << e.getText() << endl;
+      }
+   }
+
+   return 0;
+}
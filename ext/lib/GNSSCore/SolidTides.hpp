@@ -101,6 +101,20 @@ namespace gpstk
             throw(InvalidRequest);
 
 
+         /** Returns the effect of solid Earth tides (meters) at the given
+          * position, in the Up-East-North (UEN) reference frame, given the
+          * Sun and Moon positions (ECEF, meters) at the epoch of interest,
+          * e.g. those of the SatGeometryCache of the epoch.
+          *
+          * @param[in] p         Position of interest
+          * @param[in] sunPos    Sun position
+          * @param[in] moonPos   Moon position
+          */
+         Triple getSolidTide(const Position& p,
+                             const Triple& sunPos,
+                             const Triple& moonPos) const;
+
+
    private:
 
          /// Love numbers
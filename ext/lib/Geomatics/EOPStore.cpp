@@ -261,7 +261,7 @@ namespace gpstk
    // @throw InvalidRequest if the integer MJD falls outside the store,
    //   or if the store contains fewer than 4 entries
    // @return EarthOrientation EOPs at mjd.
-   EarthOrientation EOPStore::getEOP(const double& mjd, const IERSConvention& conv)
+   EarthOrientation EOPStore::getEOP(const double& mjd, const IERSConvention& conv) const
       throw(InvalidRequest)
    {
       if(mapMJD_EOP.size() < 4) {
@@ -279,7 +279,7 @@ namespace gpstk
       double mjdUTC(mjd);
 
       // find 4 points surrounding the time of interest ----------------
-      map<int,EarthOrientation>::iterator lowit,hiit,it;
+      map<int,EarthOrientation>::const_iterator lowit,hiit,it;
       it = lowit = mapMJD_EOP.find(int(mjdUTC));
       (hiit = it)++;
       if(lowit == mapMJD_EOP.end() || hiit == mapMJD_EOP.end()) {
@@ -145,7 +145,7 @@ namespace gpstk {
       /// @throw InvalidRequest if the integer MJD falls outside the store,
       ///   or if the store contains fewer than 4 entries
       /// @return EarthOrientation EOPs at mjd.
-      EarthOrientation getEOP(const double& mjd, const IERSConvention& conv)
+      EarthOrientation getEOP(const double& mjd, const IERSConvention& conv) const
          throw(InvalidRequest);
 
    };    // end class EOPStore
@@ -35,7 +35,7 @@
 //=============================================================================
 
 /**
- * @file AlanDeviation.hpp
+ * @file AllanDeviation.hpp
  * Computes the overlapping Allan variance of a pair of vectors.
  */
  
@@ -44,9 +44,11 @@
 
 #include <vector>
 #include <cmath>
+#include <limits>
 #include <ostream>
 
 #include "Exception.hpp"
+#include "FrequencyStability.hpp"
 
 namespace gpstk
 {
@@ -54,7 +56,9 @@ namespace gpstk
    //@{
 
    
-   /// Compute the overlapping Allan variance of the phase data provided.
+   /// Compute the overlapping Allan variance of the phase data provided,
+   /// at every averaging factor. The zero phase values are gaps.
+   /// See FrequencyStability for the other statistics and tau spacings.
    class AllanDeviation
    {
    public:
@@ -67,32 +71,24 @@ namespace gpstk
             GPSTK_THROW(e);
          }
 
-         // Actual Overlapping Allan Deviation Calculation is done here
-         // The Overlapping Allan Deviation is calculated as follows
-         //  Sigma^2(Tau) = 1 / (2*(N-2*m)*Tau^2) * Sum(X[i+2*m]-2*X[i+m]+X[i], i=1, i=N-2*m)
-         //  Where Tau is the averaging time, N is the total number of points, and Tau = m*Tau0
-         //  Where Tau0 is the basic measurement interval	
-         double sum, sigma;
-         for(int m = 1; m <= (N-1)/2; m++)
+            // no averaging factor with 2 points
+         if (N < 2)
+            return;
+
+         std::vector<double> x(phase);
+         for (size_t i = 0; i < x.size(); i++)
+            if (x[i] == 0)
+               x[i] = std::numeric_limits<double>::quiet_NaN();
+
+         FrequencyStability fs(x, tau0);
+         numGaps = fs.numGaps();
+
+         std::vector<FrequencyStability::Point> curve =
+            fs.compute(FrequencyStability::OverlappingAllan);
+         for (size_t i = 0; i < curve.size(); i++)
          {
-            double tau = m*tau0;
-            sigma = 0;
-            
-            for(int i = 0; i < (N-2*m); i++)
-            {
-               sum = 0;
-               if((phase[i+2*m]==0 ||  phase[i+m]==0 || phase[i]==0) 
-                  && i!=0 && i!=(N-2*m-1))
-                  numGaps++;
-               else
-                  sum = phase[i+2*m] - 2*phase[i+m] + phase[i];
-               sigma += sum * sum;
-            }
-		
-            sigma = sigma / (2.0*((double)N-(double)numGaps-0-2.0*(double)m)*tau*tau);
-            sigma = sqrt(sigma);
-            deviation.push_back(sigma);
-            time.push_back(tau);
+            deviation.push_back(curve[i].deviation);
+            time.push_back(curve[i].tau);
          }
       }
 
@@ -108,7 +104,7 @@ namespace gpstk
       int numGaps;
    };
 
-   std::ostream& operator<<(std::ostream& s, const AllanDeviation& a)
+   inline std::ostream& operator<<(std::ostream& s, const AllanDeviation& a)
    {
       a.dump(s);
       return s;
@@ -0,0 +1,348 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/**
+ * @file FrequencyStability.cpp
+ * Frequency stability statistics of clock phase data.
+ */
+
+#include "FrequencyStability.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace gpstk
+{
+   namespace
+   {
+      const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+         // the curve is computed on threads only beyond this number of points
+      const size_t minPointsPerThread = 1000;
+   }
+
+   FrequencyStability::FrequencyStability(const std::vector<double>& phase,
+                                          double tau0)
+      throw(Exception)
+      : x(phase), tau0(tau0), spacing(All), numThreads(1)
+   {
+      if (x.size() < 3)
+      {
+         Exception e("Need at least 3 points to compute a frequency stability.");
+         GPSTK_THROW(e);
+      }
+
+         // remove the line through the first and the last points present
+      size_t first(0), last(x.size() - 1);
+      while (first < x.size() && std::isnan(x[first]))
+         first++;
+      while (last > first && std::isnan(x[last]))
+         last--;
+      if (first < x.size())
+      {
+         double x0(x[first]);
+         double slope = last > first ? (x[last] - x0) / (last - first) : 0.0;
+         for (size_t i = 0; i < x.size(); i++)
+            x[i] -= x0 + slope * ((double)i - (double)first);
+      }
+
+      cum.resize(x.size() + 1);
+      gaps.resize(x.size() + 1);
+      cum[0] = 0;
+      gaps[0] = 0;
+      for (size_t i = 0; i < x.size(); i++)
+      {
+         bool missing = std::isnan(x[i]);
+         cum[i+1] = cum[i] + (missing ? 0.0 : x[i]);
+         gaps[i+1] = gaps[i] + (missing ? 1 : 0);
+      }
+   }
+
+   std::vector<double> FrequencyStability::regularize(
+      const std::vector<double>& time,
+      const std::vector<double>& phase,
+      double& tau0,
+      bool zeroIsGap)
+      throw(Exception)
+   {
+      if (time.size() != phase.size() || time.size() < 2)
+      {
+         Exception e("Need at least 2 time tagged points.");
+         GPSTK_THROW(e);
+      }
+
+      tau0 = 0;
+      for (size_t i = 1; i < time.size(); i++)
+      {
+         double dt = time[i] - time[i-1];
+         if (!(dt > 0))
+         {
+            Exception e("The time tags must be increasing.");
+            GPSTK_THROW(e);
+         }
+         if (tau0 == 0 || dt < tau0)
+            tau0 = dt;
+      }
+
+      double span = (time.back() - time.front()) / tau0;
+      if (span > 100.0 * time.size())
+      {
+         Exception e("The time tags are too irregular.");
+         GPSTK_THROW(e);
+      }
+
+      std::vector<double> x((size_t)std::floor(span + 0.5) + 1, NaN);
+      for (size_t i = 0; i < time.size(); i++)
+      {
+         if (zeroIsGap && phase[i] == 0)
+            continue;
+         size_t k = (size_t)std::floor((time[i] - time.front()) / tau0 + 0.5);
+         x[std::min(k, x.size() - 1)] = phase[i];
+      }
+      return x;
+   }
+
+   size_t FrequencyStability::maxFactor(Statistic st) const throw()
+   {
+      size_t n = x.size();
+      switch (st)
+      {
+         case OverlappingAllan: return (n - 1) / 2;
+         case ModifiedAllan:
+         case Time:             return n / 3;
+         case Hadamard:         return (n - 1) / 3;
+         case Total:            return n - 1;
+      }
+      return 0;
+   }
+
+   std::vector<size_t> FrequencyStability::factors(Statistic st) const throw()
+   {
+      std::vector<size_t> fs;
+      size_t last = maxFactor(st);
+      if (spacing == All)
+      {
+         for (size_t m = 1; m <= last; m++)
+            fs.push_back(m);
+      }
+      else if (spacing == Octave)
+      {
+         for (size_t m = 1; m <= last; m *= 2)
+            fs.push_back(m);
+      }
+      else
+      {
+         for (size_t decade = 1; decade <= last; decade *= 10)
+            for (size_t k : { 1, 2, 5 })
+               if (k * decade <= last)
+                  fs.push_back(k * decade);
+      }
+      return fs;
+   }
+
+   FrequencyStability::Point FrequencyStability::compute(Statistic st,
+                                                         size_t m) const
+      throw()
+   {
+      if (m < 1 || m > maxFactor(st))
+      {
+         Point p = { m * tau0, NaN, 0 };
+         return p;
+      }
+
+      switch (st)
+      {
+         case OverlappingAllan: return overlappingAllan(m);
+         case ModifiedAllan:    return modifiedAllan(m);
+         case Hadamard:         return hadamard(m);
+         case Total:            return total(m);
+         case Time:
+         {
+            Point p = modifiedAllan(m);
+            p.deviation *= p.tau / std::sqrt(3.0);
+            return p;
+         }
+      }
+      Point p = { m * tau0, NaN, 0 };
+      return p;
+   }
+
+   std::vector<FrequencyStability::Point> FrequencyStability::compute(
+      Statistic st) const
+   {
+      std::vector<size_t> fs = factors(st);
+      std::vector<Point> curve(fs.size());
+
+      unsigned n = numThreads ? numThreads : std::thread::hardware_concurrency();
+      n = std::max(1u, std::min<unsigned>(n, (unsigned)fs.size()));
+      if (x.size() < minPointsPerThread * n)
+         n = std::max<size_t>(1, x.size() / minPointsPerThread);
+
+         // every thread takes the next factor to compute
+      std::atomic<size_t> next(0);
+      auto work = [&]()
+      {
+         for (size_t i = next++; i < fs.size(); i = next++)
+            curve[i] = compute(st, fs[i]);
+      };
+
+      std::vector<std::thread> pool;
+      for (unsigned i = 1; i < n; i++)
+         pool.push_back(std::thread(work));
+      work();
+      for (auto& it : pool)
+         it.join();
+
+      return curve;
+   }
+
+   const char* FrequencyStability::name(Statistic st) throw()
+   {
+      switch (st)
+      {
+         case OverlappingAllan: return "OADEV";
+         case ModifiedAllan:    return "MDEV";
+         case Hadamard:         return "HDEV";
+         case Time:             return "TDEV";
+         case Total:            return "TOTDEV";
+      }
+      return "";
+   }
+
+      // sigma^2 = sum((x[i+2m] - 2x[i+m] + x[i])^2) / (2 K tau^2),
+      // i = 0 .. N-2m-1, K the number of terms
+   FrequencyStability::Point FrequencyStability::overlappingAllan(size_t m) const
+   {
+      const size_t n = x.size();
+      double s(0);
+      size_t k(0);
+      for (size_t i = 0; i + 2*m < n; i++)
+      {
+         double d = x[i+2*m] - 2*x[i+m] + x[i];
+         if (std::isnan(d))
+            continue;
+         s += d * d;
+         k++;
+      }
+
+      Point p = { m * tau0, NaN, k };
+      if (k)
+         p.deviation = std::sqrt(s / (2.0 * k)) / p.tau;
+      return p;
+   }
+
+      // sigma^2 = sum(w[j]^2) / (2 m^2 K tau^2), j = 0 .. N-3m, with
+      // w[j] = sum(x[i+2m] - 2x[i+m] + x[i], i = j .. j+m-1), i.e. the
+      // second difference of the sums of m points
+   FrequencyStability::Point FrequencyStability::modifiedAllan(size_t m) const
+   {
+      const size_t n = x.size();
+      long double s(0);
+      size_t k(0);
+      for (size_t j = 0; j + 3*m <= n; j++)
+      {
+         if (!present(j, j + 3*m))
+            continue;
+         long double w = sum(j + 2*m, j + 3*m) - 2 * sum(j + m, j + 2*m) + sum(j, j + m);
+         s += w * w;
+         k++;
+      }
+
+      Point p = { m * tau0, NaN, k };
+      if (k)
+         p.deviation = std::sqrt((double)s / (2.0 * k)) / (m * p.tau);
+      return p;
+   }
+
+      // sigma^2 = sum((x[i+3m] - 3x[i+2m] + 3x[i+m] - x[i])^2) / (6 K tau^2),
+      // i = 0 .. N-3m-1
+   FrequencyStability::Point FrequencyStability::hadamard(size_t m) const
+   {
+      const size_t n = x.size();
+      double s(0);
+      size_t k(0);
+      for (size_t i = 0; i + 3*m < n; i++)
+      {
+         double d = x[i+3*m] - 3*x[i+2*m] + 3*x[i+m] - x[i];
+         if (std::isnan(d))
+            continue;
+         s += d * d;
+         k++;
+      }
+
+      Point p = { m * tau0, NaN, k };
+      if (k)
+         p.deviation = std::sqrt(s / (6.0 * k)) / p.tau;
+      return p;
+   }
+
+      // sigma^2 = sum((x*[i-m] - 2x*[i] + x*[i+m])^2) / (2 K tau^2),
+      // i = 1 .. N-2, x* being the phase extended at both ends by odd
+      // reflection: x*[-j] = 2x[0] - x[j], x*[N-1+j] = 2x[N-1] - x[N-1-j]
+   FrequencyStability::Point FrequencyStability::total(size_t m) const
+   {
+      const long n = (long)x.size();
+      auto ext = [&](long j)
+      {
+         if (j < 0)
+            return 2*x[0] - x[-j];
+         if (j > n - 1)
+            return 2*x[n-1] - x[2*(n-1) - j];
+         return x[j];
+      };
+
+      double s(0);
+      size_t k(0);
+      for (long i = 1; i < n - 1; i++)
+      {
+         double d = ext(i - (long)m) - 2*x[i] + ext(i + (long)m);
+         if (std::isnan(d))
+            continue;
+         s += d * d;
+         k++;
+      }
+
+      Point p = { m * tau0, NaN, k };
+      if (k)
+         p.deviation = std::sqrt(s / (2.0 * k)) / p.tau;
+      return p;
+   }
+
+}  // namespace gpstk
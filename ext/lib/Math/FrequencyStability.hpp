@@ -0,0 +1,212 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/**
+ * @file FrequencyStability.hpp
+ * Frequency stability statistics of clock phase data.
+ */
+
+#ifndef GPSTK_FREQUENCYSTABILITY_HPP
+#define GPSTK_FREQUENCYSTABILITY_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "Exception.hpp"
+
+namespace gpstk
+{
+      /// @ingroup math
+      //@{
+
+      /**
+       * Computes the frequency stability statistics of clock phase
+       * data (time error, in seconds) sampled every tau0 seconds.
+       *
+       * Every statistic is computed in O(N) for one averaging factor m
+       * (tau = m*tau0): the modified Allan and time deviations use
+       * cumulative sums of the phase instead of summing the m second
+       * differences of each window. With octave or decade spacing of
+       * the averaging factors, the whole curve costs O(N log N); with
+       * all the averaging factors it's O(N^2), but without the extra
+       * factor m of the direct modified Allan computation. The
+       * averaging factors may be computed on several threads.
+       *
+       * Missing points are NaN. A term of a statistic using a missing
+       * point is dropped, and the sum of the terms is normalized by the
+       * number of terms left.
+       *
+       * Since the statistics only use differences of second (third, for
+       * the Hadamard deviation) order, a straight line is removed from
+       * the phase first, which keeps the cumulative sums small.
+       *
+       * @code
+       * FrequencyStability fs(phase, 1.0);
+       * fs.setSpacing(FrequencyStability::Octave).setThreads(4);
+       * std::vector<FrequencyStability::Point> curve =
+       *    fs.compute(FrequencyStability::ModifiedAllan);
+       * @endcode
+       */
+   class FrequencyStability
+   {
+   public:
+         /// the statistics
+      enum Statistic
+      {
+         OverlappingAllan,   ///< overlapping Allan deviation
+         ModifiedAllan,      ///< modified Allan deviation
+         Hadamard,           ///< overlapping Hadamard deviation
+         Time,               ///< time deviation, tau/sqrt(3) * MDEV
+         Total               ///< total deviation (reflected data)
+      };
+
+         /// spacing of the averaging factors
+      enum Spacing
+      {
+         All,                ///< m = 1, 2, 3, ...
+         Octave,             ///< m = 1, 2, 4, 8, ...
+         Decade              ///< m = 1, 2, 5, 10, 20, 50, ...
+      };
+
+         /// a point of a stability curve
+      struct Point
+      {
+         double tau;
+         double deviation;
+            /// number of terms averaged
+         size_t terms;
+      };
+
+         /**
+          * @param phase phase data, one point every tau0 seconds,
+          *    missing points being NaN
+          * @param tau0 sampling interval, seconds
+          * @throw Exception if there are less than 3 points
+          */
+      FrequencyStability(const std::vector<double>& phase, double tau0)
+         throw(Exception);
+
+         /**
+          * Builds the regularly spaced phase of time tagged data: the
+          * sampling interval is the smallest interval between two time
+          * tags, and the epochs without data are missing points.
+          * @param time time tags, seconds, increasing
+          * @param phase phase at the time tags
+          * @param tau0 returns the sampling interval
+          * @param zeroIsGap also treat the zero phase values as missing
+          */
+      static std::vector<double> regularize(const std::vector<double>& time,
+                                            const std::vector<double>& phase,
+                                            double& tau0,
+                                            bool zeroIsGap = false)
+         throw(Exception);
+
+      FrequencyStability& setSpacing(Spacing s)
+      { spacing = s; return *this; }
+
+      Spacing getSpacing() const
+      { return spacing; }
+
+         /// Number of threads computing the averaging factors
+         /// (1 by default, 0 for one per core).
+      FrequencyStability& setThreads(unsigned n)
+      { numThreads = n; return *this; }
+
+      unsigned getThreads() const
+      { return numThreads; }
+
+         /// number of points, including the missing ones
+      size_t size() const
+      { return x.size(); }
+
+         /// number of missing points
+      size_t numGaps() const
+      { return gaps.back(); }
+
+      double getTau0() const
+      { return tau0; }
+
+         /// Largest averaging factor of statistic 'st'.
+      size_t maxFactor(Statistic st) const throw();
+
+         /// Averaging factors of statistic 'st', with the spacing set.
+      std::vector<size_t> factors(Statistic st) const throw();
+
+         /// Statistic 'st' at averaging factor 'm'; the deviation is
+         /// NaN if no term can be computed.
+      Point compute(Statistic st, size_t m) const throw();
+
+         /// The curve of statistic 'st', at factors(st).
+      std::vector<Point> compute(Statistic st) const;
+
+         /// Short name of statistic 'st' (e.g. "MDEV").
+      static const char* name(Statistic st) throw();
+
+   private:
+
+         /// sum of x[a] .. x[b-1]
+      long double sum(size_t a, size_t b) const
+      { return cum[b] - cum[a]; }
+
+         /// true if x[a] .. x[b-1] are all present
+      bool present(size_t a, size_t b) const
+      { return gaps[b] == gaps[a]; }
+
+      Point overlappingAllan(size_t m) const;
+      Point modifiedAllan(size_t m) const;
+      Point hadamard(size_t m) const;
+      Point total(size_t m) const;
+
+         /// phase, with a straight line removed
+      std::vector<double> x;
+
+         /// cumulative sums of the phase (missing points as zero) and
+         /// cumulative count of the missing points; cum[i] is the sum of
+         /// x[0] .. x[i-1]
+      std::vector<long double> cum;
+      std::vector<size_t> gaps;
+
+      double tau0;
+      Spacing spacing;
+      unsigned numThreads;
+   };
+
+      //@}
+
+}  // namespace gpstk
+
+#endif
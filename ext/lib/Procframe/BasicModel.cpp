@@ -80,7 +80,7 @@ namespace gpstk
                            ReferenceFrame frame )
        : minElev(10.0), defaultObservable(TypeID::C1), useTGD(false), addTGD(false),
        useCdtDot(false), isFirstTime(false), currTime(CommonTime::END_OF_TIME),
-       prevTime(CommonTime::BEGINNING_OF_TIME), defInterval(30)
+       prevTime(CommonTime::BEGINNING_OF_TIME), defInterval(30), currInterval(30), pGeometry(NULL)
    {
 
       pDefaultEphemeris = NULL;
@@ -94,7 +94,7 @@ namespace gpstk
    BasicModel::BasicModel(const Position& RxCoordinates)
        : minElev(10.0), defaultObservable(TypeID::C1), useTGD(false), addTGD(false),
        useCdtDot(false), isFirstTime(false), currTime(CommonTime::END_OF_TIME),
-       prevTime(CommonTime::BEGINNING_OF_TIME), defInterval(30)
+       prevTime(CommonTime::BEGINNING_OF_TIME), defInterval(30), currInterval(30), pGeometry(NULL)
    {
 
       pDefaultEphemeris = NULL;
@@ -123,7 +123,7 @@ namespace gpstk
                            const bool& isaddTGD)
        : minElev(10.0), defaultObservable(dObservable), useTGD(applyTGD), addTGD(isaddTGD),
        useCdtDot(false), isFirstTime(false), currTime(CommonTime::END_OF_TIME),
-       prevTime(CommonTime::BEGINNING_OF_TIME), defInterval(30)
+       prevTime(CommonTime::BEGINNING_OF_TIME), defInterval(30), currInterval(30), pGeometry(NULL)
    {
 
       setInitialRxPosition(RxCoordinates);
@@ -149,132 +149,21 @@ namespace gpstk
       {
           prevTime = currTime;
           currTime = time;
-          double dt = isFirstTime ? defInterval : std::abs(currTime - prevTime);
-         
-          SatIDSet satRejectedSet;
-          int numGLN(0);
+          currInterval = isFirstTime ? defInterval : std::abs(currTime - prevTime);
 
-            // Loop through all the satellites
-         for(auto stv = gData.begin(); stv != gData.end(); ++stv )
-         {
-               // Scalar to hold temporal value
-            double observable( (*stv).second->get_value()(defaultObservable) );
-
-               // A lot of the work is done by a CorrectedEphemerisRange object
-            CorrectedEphemerisRange cerange;
-
-            try
-            {
-                  // Compute most of the parameters
-               cerange.ComputeAtTransmitTime( time,
-                                              observable,
-                                              rxPos,
-                                              (*stv).first,
-                                              *(getDefaultEphemeris()) );
-            }
-            catch(InvalidRequest& e)
-            {
-#if _DEBUG
-				//std::cout << e << std::endl;
-#endif // DEBUG
-
-                  // If some problem appears, then schedule this satellite
-                  // for removal
-               satRejectedSet.insert( (*stv).first );
-
-               continue;    // Skip this SV if problems arise
-
-            }
-            double el = rxPos.elevationGeodetic(cerange.svPosVel);
-               // Let's test if satellite has enough elevation over horizon
-            if (el < minElev )
-            {
-
-                  // Mark this satellite if it doesn't have enough elevation
-               satRejectedSet.insert( (*stv).first );
-
-               continue;
+            // Process the satellites
+         SatIDSet satRejectedSet( processSats(time, gData) );
 
-            }
-
-           
-
-               // Now we have to add the new values to the data structure
-            (*stv).second->get_value()[TypeID::dtSat] = cerange.svclkbias;
-
-               // Now, lets insert the geometry matrix
-            (*stv).second->get_value()[TypeID::dx] = cerange.cosines[0];
-            (*stv).second->get_value()[TypeID::dy] = cerange.cosines[1];
-            (*stv).second->get_value()[TypeID::dz] = cerange.cosines[2];
-
-            (*stv).second->get_value()[TypeID::dSatX] = -cerange.cosines[0];
-            (*stv).second->get_value()[TypeID::dSatY] = -cerange.cosines[1];
-            (*stv).second->get_value()[TypeID::dSatZ] = -cerange.cosines[2];
-
-               // When using pseudorange method, this is 1.0
-            (*stv).second->get_value()[TypeID::cdt] = 1.0;
-
-            //Glonass-spacific bias(ISB)
-            double cdtGLO (0.0);
+            // Remove satellites with missing data
+         gData.removeSatID(satRejectedSet);
 
+         int numGLN(0);
+         for(auto stv = gData.begin(); stv != gData.end(); ++stv )
+         {
             if (stv->first.system == SatID::SatelliteSystem::systemGlonass)
-            {
-                cdtGLO = 1;
                 numGLN++;
-            }
-            if (useCdtDot)
-                (*stv).second->get_value()[TypeID::recCdtdot] = dt;
-
-            (*stv).second->get_value()[TypeID::recISB_GLN] = cdtGLO;
-               // Now we have to add the new values to the data structure
-            (*stv).second->get_value()[TypeID::rho] = cerange.rawrange;
-            (*stv).second->get_value()[TypeID::rel] = -cerange.relativity;
-            (*stv).second->get_value()[TypeID::elevation] = cerange.elevationGeodetic;
-            (*stv).second->get_value()[TypeID::azimuth] = cerange.azimuthGeodetic;
-
-               // Let's insert satellite position at transmission time
-            (*stv).second->get_value()[TypeID::satX] = cerange.svPosVel.x[0];
-            (*stv).second->get_value()[TypeID::satY] = cerange.svPosVel.x[1];
-            (*stv).second->get_value()[TypeID::satZ] = cerange.svPosVel.x[2];
-
-               // Let's insert satellite velocity at transmission time
-            (*stv).second->get_value()[TypeID::satVX] = cerange.svPosVel.v[0];
-            (*stv).second->get_value()[TypeID::satVY] = cerange.svPosVel.v[1];
-            (*stv).second->get_value()[TypeID::satVZ] = cerange.svPosVel.v[2];
-
-               // Let's insert receiver position 
-            (*stv).second->get_value()[TypeID::recX] = rxPos.X();
-            (*stv).second->get_value()[TypeID::recY] = rxPos.Y();
-            (*stv).second->get_value()[TypeID::recZ] = rxPos.Z();
-
-               // Let's insert receiver velocity 
-            (*stv).second->get_value()[TypeID::recVX] = 0.0;
-            (*stv).second->get_value()[TypeID::recVY] = 0.0;
-            (*stv).second->get_value()[TypeID::recVZ] = 0.0;
-
-            if (addTGD)
-            {
-                // Computing Total Group Delay (TGD - meters), if possible
-                double tempTGD = getTGDCorrections(time, (*pDefaultEphemeris), (*stv).first);
-
-                // Apply correction to C1 observable, if appropriate
-                if (useTGD)
-                {
-                    // Look for C1
-                    if ((*stv).second->get_value().find(TypeID::C1) != (*stv).second->get_value().end())
-                    {
-                        (*stv).second->get_value()[TypeID::C1] =
-                            (*stv).second->get_value()[TypeID::C1] - tempTGD;
-                    };
-                };
-
-                (*stv).second->get_value()[TypeID::instC1] = tempTGD;
-            }
-         } // End of loop for(stv = gData.begin()...
+         }
 
-            // Remove satellites with missing data
-         gData.removeSatID(satRejectedSet);
-       
          if (numGLN < 2)
          {
              gData.removeSatSyst(SatID::SatelliteSystem::systemGlonass);
@@ -298,6 +187,150 @@ namespace gpstk
    }  // End of method 'BasicModel::Process()'
 
 
+      /* Computes the model of satellite 'sat' of the epoch 'time'.
+       *
+       * @param time      Epoch.
+       * @param sat       Satellite.
+       * @param tvMap     Data of the satellite.
+       *
+       * @return false if the satellite must be removed.
+       */
+   bool BasicModel::processSat( const CommonTime& time,
+                                const SatID& sat,
+                                typeValueMap& tvMap )
+   {
+
+         // Scalar to hold temporal value
+      double observable( tvMap(defaultObservable) );
+
+         // A lot of the work is done by a CorrectedEphemerisRange object
+      CorrectedEphemerisRange cerange;
+
+         // Take it from the geometry cache of this epoch, if any
+      if( pGeometry != NULL && pGeometry->isCurrent(time) )
+      {
+         const CorrectedEphemerisRange* cached =
+            pGeometry->find( sat, time );
+
+         if( cached == NULL )
+         {
+               // No ephemeris for this satellite
+            return false;
+         }
+
+         cerange = *cached;
+      }
+      else
+      {
+         try
+         {
+               // Compute most of the parameters
+            cerange.ComputeAtTransmitTime( time,
+                                           observable,
+                                           rxPos,
+                                           sat,
+                                           *(getDefaultEphemeris()) );
+         }
+         catch(InvalidRequest& e)
+         {
+#if _DEBUG
+					//std::cout << e << std::endl;
+#endif // DEBUG
+
+               // If some problem appears, then schedule this satellite
+               // for removal
+            return false;
+
+         }
+      }
+      double el = cerange.elevationGeodetic;
+         // Let's test if satellite has enough elevation over horizon
+      if (el < minElev )
+      {
+
+            // Mark this satellite if it doesn't have enough elevation
+         return false;
+
+      }
+
+        
+
+         // Now we have to add the new values to the data structure
+      tvMap[TypeID::dtSat] = cerange.svclkbias;
+
+         // Now, lets insert the geometry matrix
+      tvMap[TypeID::dx] = cerange.cosines[0];
+      tvMap[TypeID::dy] = cerange.cosines[1];
+      tvMap[TypeID::dz] = cerange.cosines[2];
+
+      tvMap[TypeID::dSatX] = -cerange.cosines[0];
+      tvMap[TypeID::dSatY] = -cerange.cosines[1];
+      tvMap[TypeID::dSatZ] = -cerange.cosines[2];
+
+         // When using pseudorange method, this is 1.0
+      tvMap[TypeID::cdt] = 1.0;
+
+      //Glonass-spacific bias(ISB)
+      double cdtGLO (0.0);
+
+      if (sat.system == SatID::SatelliteSystem::systemGlonass)
+      {
+          cdtGLO = 1;
+      }
+      if (useCdtDot)
+          tvMap[TypeID::recCdtdot] = currInterval;
+
+      tvMap[TypeID::recISB_GLN] = cdtGLO;
+         // Now we have to add the new values to the data structure
+      tvMap[TypeID::rho] = cerange.rawrange;
+      tvMap[TypeID::rel] = -cerange.relativity;
+      tvMap[TypeID::elevation] = cerange.elevationGeodetic;
+      tvMap[TypeID::azimuth] = cerange.azimuthGeodetic;
+
+         // Let's insert satellite position at transmission time
+      tvMap[TypeID::satX] = cerange.svPosVel.x[0];
+      tvMap[TypeID::satY] = cerange.svPosVel.x[1];
+      tvMap[TypeID::satZ] = cerange.svPosVel.x[2];
+
+         // Let's insert satellite velocity at transmission time
+      tvMap[TypeID::satVX] = cerange.svPosVel.v[0];
+      tvMap[TypeID::satVY] = cerange.svPosVel.v[1];
+      tvMap[TypeID::satVZ] = cerange.svPosVel.v[2];
+
+         // Let's insert receiver position 
+      tvMap[TypeID::recX] = rxPos.X();
+      tvMap[TypeID::recY] = rxPos.Y();
+      tvMap[TypeID::recZ] = rxPos.Z();
+
+         // Let's insert receiver velocity 
+      tvMap[TypeID::recVX] = 0.0;
+      tvMap[TypeID::recVY] = 0.0;
+      tvMap[TypeID::recVZ] = 0.0;
+
+      if (addTGD)
+      {
+          // Computing Total Group Delay (TGD - meters), if possible
+          double tempTGD = getTGDCorrections(time, (*pDefaultEphemeris), sat);
+
+          // Apply correction to C1 observable, if appropriate
+          if (useTGD)
+          {
+              // Look for C1
+              if (tvMap.find(TypeID::C1) != tvMap.end())
+              {
+                  tvMap[TypeID::C1] =
+                      tvMap[TypeID::C1] - tempTGD;
+              };
+          };
+
+          tvMap[TypeID::instC1] = tempTGD;
+      }
+
+      return true;
+
+   }  // End of method 'BasicModel::processSat()'
+
+
 
       /* Method to set the initial (a priori) position of receiver.
        * @return
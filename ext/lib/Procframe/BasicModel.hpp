@@ -50,6 +50,7 @@
 #include "EngEphemeris.hpp"
 #include "XvtStore.hpp"
 #include "GPSEphemerisStore.hpp"
+#include "SatGeometryCache.hpp"
 
 
 namespace gpstk
@@ -120,7 +121,8 @@ namespace gpstk
            : minElev(10.0), pDefaultEphemeris(NULL),
            defaultObservable(TypeID::C1), useTGD(false), addTGD(false),
            useCdtDot(false),isFirstTime(false), currTime(CommonTime::END_OF_TIME),
-           prevTime(CommonTime::BEGINNING_OF_TIME), defInterval(30)
+           prevTime(CommonTime::BEGINNING_OF_TIME), defInterval(30),
+           currInterval(30), pGeometry(NULL)
       { setInitialRxPosition(); };
 
 
@@ -249,10 +251,27 @@ namespace gpstk
       { pDefaultEphemeris = &ephem; return (*this); };
 
 
+         /** Method to set the geometry cache of the epochs. When the cache
+          *  holds the epoch processed, the satellite positions, ranges and
+          *  corrections are taken from it instead of being computed.
+          *
+          * @param geometry  SatGeometryCache object, processing the epochs
+          *                  before this object
+          */
+      virtual BasicModel& setGeometryCache(SatGeometryCache& geometry)
+      { pGeometry = &geometry; return (*this); };
+
+
          /// Either estimated or "a priori" position of receiver
       Position rxPos;
 
 
+         /// The satellites are modeled independently: they may be
+         /// processed concurrently.
+      virtual bool isParallelSafe() const
+      { return true; };
+
+
          /// Returns a string identifying this object.
       virtual std::string getClassName(void) const;
 
@@ -295,6 +314,17 @@ namespace gpstk
 
       double defInterval;
 
+         /// Interval since the previous epoch processed
+      double currInterval;
+
+         /// Geometry cache of the epochs, if any
+      SatGeometryCache* pGeometry;
+
+         /// Computes the model of a satellite of the epoch.
+      virtual bool processSat( const CommonTime& time,
+                               const SatID& sat,
+                               typeValueMap& tvMap );
+
          /** Method to set the initial (a priori) position of receiver.
           * @return
           *  0 if OK
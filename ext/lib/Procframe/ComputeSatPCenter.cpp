@@ -68,99 +68,210 @@ namespace gpstk
 
             // Compute Sun position at this epoch
          SunPosition sunPosition;
-         Triple sunPos(sunPosition.getPosition(time));
+         sunPos = (pGeometry != NULL) ? pGeometry->getSunPosition(time)
+                                      : sunPosition.getPosition(time);
 
-            // Define a Triple that will hold satellite position, in ECEF
-         Triple svPos(0.0, 0.0, 0.0);
+            // Look up the satellite antennas before processing the
+            // satellites, possibly concurrently
+         if( pAntexReader != NULL && pAntexReader->isAbsolute() )
+         {
+            updateSatAntennas(time, gData);
+         }
 
-         SatIDSet satRejectedSet;
+            // Process the satellites
+         SatIDSet satRejectedSet( processSats(time, gData) );
 
-            // Loop through all the satellites
-         for (auto it = gData.begin(); it != gData.end(); ++it)
-         {
+            // Remove satellites with missing data
+         gData.removeSatID(satRejectedSet);
 
-               // Use ephemeris if satellite position is not already computed
-            if( ( (*it).second->get_value().find(TypeID::satX) == (*it).second->get_value().end() ) ||
-                ( (*it).second->get_value().find(TypeID::satY) == (*it).second->get_value().end() ) ||
-                ( (*it).second->get_value().find(TypeID::satZ) == (*it).second->get_value().end() ) )
-            {
+         rejectedSatsTable[time] = satRejectedSet;
+
+         return gData;
+
+      }
+      catch(Exception& u)
+      {
+
+            // Throw an exception if something unexpected happens
+         ProcessingException e( getClassName() + ":"
+                                + u.what() );
+
+         GPSTK_THROW(e);
+
+      }
+
+   }  // End of method 'ComputeSatPCenter::Process()'
 
-               if(pEphemeris==NULL)
-               {
 
-                     // If ephemeris is missing, then remove all satellites
-                  satRejectedSet.insert( (*it).first );
+      /* Computes the satellite antenna phase correction of satellite 'sat'
+       * of the epoch 'time'.
+       *
+       * @param time      Epoch.
+       * @param sat       Satellite.
+       * @param tvMap     Data of the satellite.
+       *
+       * @return false if the satellite must be removed.
+       */
+   bool ComputeSatPCenter::processSat( const CommonTime& time,
+                                       const SatID& sat,
+                                       typeValueMap& tvMap )
+   {
 
-                  continue;
-               }
-               else
-               {
+         // Define a Triple that will hold satellite position, in ECEF
+      Triple svPos(0.0, 0.0, 0.0);
 
-                     // Try to get satellite position
-                     // if it is not already computed
-                  try
-                  {
-                        // For our purposes, position at receive time
-                        // is fine enough
-                     Xvt svPosVel(pEphemeris->getXvt( (*it).first, time ));
+         // Take satellite position from the geometry cache, if any
+      const CorrectedEphemerisRange* cached = (pGeometry != NULL) ?
+         pGeometry->find( sat, time ) : NULL;
 
-                        // If everything is OK, then continue processing.
-                     svPos[0] = svPosVel.x.theArray[0];
-                     svPos[1] = svPosVel.x.theArray[1];
-                     svPos[2] = svPosVel.x.theArray[2];
+      if( cached != NULL )
+      {
+         svPos = cached->svPosVel.x;
+      }
+         // Use ephemeris if satellite position is not already computed
+      else if( ( tvMap.find(TypeID::satX) == tvMap.end() ) ||
+               ( tvMap.find(TypeID::satY) == tvMap.end() ) ||
+               ( tvMap.find(TypeID::satZ) == tvMap.end() ) )
+      {
 
-                  }
-                  catch(...)
-                  {
+         if(pEphemeris==NULL)
+         {
 
-                        // If satellite is missing, then schedule it
-                        // for removal
-                     satRejectedSet.insert( (*it).first );
+               // If ephemeris is missing, then remove all satellites
+            return false;
+         }
+         else
+         {
 
-                     continue;
-                  }
+               // Try to get satellite position
+               // if it is not already computed
+            try
+            {
+                  // For our purposes, position at receive time
+                  // is fine enough
+               Xvt svPosVel(pEphemeris->getXvt( sat, time ));
 
-               }
+                  // If everything is OK, then continue processing.
+               svPos[0] = svPosVel.x.theArray[0];
+               svPos[1] = svPosVel.x.theArray[1];
+               svPos[2] = svPosVel.x.theArray[2];
 
             }
-            else
+            catch(...)
             {
 
-                  // Get satellite position out of GDS
-               svPos[0] = (*it).second->get_value()[TypeID::satX];
-               svPos[1] = (*it).second->get_value()[TypeID::satY];
-               svPos[2] = (*it).second->get_value()[TypeID::satZ];
+                  // If satellite is missing, then schedule it
+                  // for removal
+               return false;
+            }
 
-            }  // End of 'if( ( (*it).second->get_value().find(TypeID::satX) == ...'
+         }
 
+      }
+      else
+      {
 
-               // Let's get the satellite antenna phase correction value in
-               // meters, and insert it in the GNSS data structure.
-            (*it).second->get_value()[TypeID::satPCenter] =
-               getSatPCenter((*it).first, time, svPos, sunPos);
+            // Get satellite position out of GDS
+         svPos[0] = tvMap[TypeID::satX];
+         svPos[1] = tvMap[TypeID::satY];
+         svPos[2] = tvMap[TypeID::satZ];
 
-         }  // End of 'for (it = gData.begin(); it != gData.end(); ++it)'
+      }  // End of 'if( ( tvMap.find(TypeID::satX) == ...'
 
-            // Remove satellites with missing data
-         gData.removeSatID(satRejectedSet);
 
-         rejectedSatsTable[time] = satRejectedSet;
+         // Let's get the satellite antenna phase correction value in
+         // meters, and insert it in the GNSS data structure.
+      tvMap[TypeID::satPCenter] =
+         getSatPCenter(sat, time, svPos, sunPos);
 
-         return gData;
+      return true;
 
-      }
-      catch(Exception& u)
+   }  // End of method 'ComputeSatPCenter::processSat()'
+
+
+      /* Looks up the antennas of the GPS and Glonass satellites of 'gData'
+       * valid at 'time' in the Antex file, unless they were already.
+       *
+       * @param time      Epoch.
+       * @param gData     Data object holding the data.
+       */
+   void ComputeSatPCenter::updateSatAntennas( const CommonTime& time,
+                                              const SatTypePtrMap& gData )
+   {
+
+      for (auto it = gData.begin(); it != gData.end(); ++it)
       {
 
-            // Throw an exception if something unexpected happens
-         ProcessingException e( getClassName() + ":"
-                                + u.what() );
+         const SatID& sat( (*it).first );
 
-         GPSTK_THROW(e);
+         std::stringstream name;
+         if( sat.system == SatID::systemGPS )
+         {
+            name << "G";
+         }
+         else if( sat.system == SatID::systemGlonass )
+         {
+            name << "R";
+         }
+         else
+         {
+            continue;
+         }
+
+         auto ant = satAntennas.find(sat);
+         if( ant != satAntennas.end() )
+         {
+            if( time >= (*ant).second.getAntennaValidFrom() &&
+                time <= (*ant).second.getAntennaValidUntil() )
+            {
+               continue;
+            }
 
+            satAntennas.erase(ant);
+         }
+
+         if( sat.id < 10 )
+         {
+            name << "0";
+         }
+         name << sat.id;
+
+         try
+         {
+            satAntennas[sat] = pAntexReader->getAntenna( name.str(), time );
+         }
+         catch(ObjectNotFound& e)
+         {
+               // Reported if the satellite is processed
+         }
+
+      }  // End of 'for (auto it = gData.begin(); it != gData.end(); ++it)'
+
+   }  // End of method 'ComputeSatPCenter::updateSatAntennas()'
+
+
+      /* Returns the antenna of satellite 'satid' valid at 'time', looked up
+       * by updateSatAntennas().
+       *
+       * @param satid     Satellite ID.
+       * @param time      Epoch.
+       */
+   const Antenna& ComputeSatPCenter::getSatAntenna( const SatID& satid,
+                                                    const CommonTime& time ) const
+   {
+
+      auto ant = satAntennas.find(satid);
+      if( ant == satAntennas.end() ||
+          time < (*ant).second.getAntennaValidFrom() ||
+          time > (*ant).second.getAntennaValidUntil() )
+      {
+         ObjectNotFound notFound("Antenna not found in Antex file.");
+         GPSTK_THROW(notFound);
       }
 
-   }  // End of method 'ComputeSatPCenter::Process()'
+      return (*ant).second;
+
+   }  // End of method 'ComputeSatPCenter::getSatAntenna()'
 
 
 
@@ -250,16 +361,9 @@ namespace gpstk
             // only works for GPS and Glonass.
          if( satid.system == SatID::systemGPS )
          {
-            std::stringstream sat;
-            sat << "G";
-            if( satid.id < 10 )
-            {
-               sat << "0";
-            }
-            sat << satid.id;
-
-               // Get satellite antenna information out of AntexReader object
-            Antenna antenna( pAntexReader->getAntenna( sat.str(), time ) );
+               // Get satellite antenna information, looked up in the Antex
+               // file before processing the satellites
+            const Antenna& antenna( getSatAntenna( satid, time ) );
 
                // Get antenna eccentricity for frequency "G01" (L1), in
                // satellite reference system.
@@ -284,16 +388,9 @@ namespace gpstk
                // Check if this satellite belongs to Glonass system
             if( satid.system == SatID::systemGlonass )
             {
-               std::stringstream sat;
-               sat << "R";
-               if( satid.id < 10 )
-               {
-                  sat << "0";
-               }
-               sat << satid.id;
-
-                  // Get satellite antenna information out of AntexReader object
-               Antenna antenna( pAntexReader->getAntenna( sat.str(), time ) );
+                  // Get satellite antenna information, looked up in the Antex
+                  // file before processing the satellites
+               const Antenna& antenna( getSatAntenna( satid, time ) );
 
                   // Get antenna offset for frequency "R01" (Glonass), in
                   // satellite reference system.
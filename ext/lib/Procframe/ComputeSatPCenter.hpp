@@ -44,6 +44,7 @@
 #define GPSTK_COMPUTESATPCENTER_HPP
 
 #include <cmath>
+#include <map>
 #include <string>
 #include <sstream>
 #include "ProcessingClass.hpp"
@@ -53,6 +54,7 @@
 #include "XvtStore.hpp"
 #include "SatDataReader.hpp"
 #include "AntexReader.hpp"
+#include "SatGeometryCache.hpp"
 #include "GNSSconstants.hpp"
 #include "StringUtils.hpp"
 
@@ -115,7 +117,8 @@ namespace gpstk
          /// Default constructor
       ComputeSatPCenter()
          : pEphemeris(NULL), nominalPos(0.0, 0.0, 0.0),
-           satData("PRN_GPS"), fileData("PRN_GPS"), pAntexReader(NULL)
+           satData("PRN_GPS"), fileData("PRN_GPS"), pAntexReader(NULL),
+           pGeometry(NULL)
       { };
 
 
@@ -133,7 +136,7 @@ namespace gpstk
                          const Position& stapos,
                          std::string filename="PRN_GPS" )
          : pEphemeris(&ephem), nominalPos(stapos), satData(filename),
-           fileData(filename), pAntexReader(NULL)
+           fileData(filename), pAntexReader(NULL), pGeometry(NULL)
       { };
 
 
@@ -149,7 +152,7 @@ namespace gpstk
       ComputeSatPCenter( const Position& stapos,
                          std::string filename="PRN_GPS" )
          : pEphemeris(NULL), nominalPos(stapos), satData(filename),
-           fileData(filename), pAntexReader(NULL)
+           fileData(filename), pAntexReader(NULL), pGeometry(NULL)
       { };
 
 
@@ -166,7 +169,8 @@ namespace gpstk
       ComputeSatPCenter( XvtStore<SatID>& ephem,
                          const Position& stapos,
                          AntexReader& antexObj )
-         : pEphemeris(&ephem), nominalPos(stapos), pAntexReader(&antexObj)
+         : pEphemeris(&ephem), nominalPos(stapos), pAntexReader(&antexObj),
+           pGeometry(NULL)
       { };
 
 
@@ -181,7 +185,8 @@ namespace gpstk
           */
       ComputeSatPCenter( const Position& stapos,
                          AntexReader& antexObj )
-         : pEphemeris(NULL), nominalPos(stapos), pAntexReader(&antexObj)
+         : pEphemeris(NULL), nominalPos(stapos), pAntexReader(&antexObj),
+           pGeometry(NULL)
       { };
 
 
@@ -255,7 +260,23 @@ namespace gpstk
           *                  antenna data.
           */
       virtual ComputeSatPCenter& setAntexReader(AntexReader& antexObj)
-      { pAntexReader = &antexObj; return (*this); };
+      { pAntexReader = &antexObj; satAntennas.clear(); return (*this); };
+
+
+         /** Sets the geometry cache of the epochs, giving the satellite
+          *  positions and the Sun position computed once per epoch.
+          *
+          * @param geometry  SatGeometryCache object
+          */
+      virtual ComputeSatPCenter& setGeometryCache(SatGeometryCache& geometry)
+      { pGeometry = &geometry; return (*this); };
+
+
+         /// The satellites are processed independently, the satellite
+         /// antennas being looked up first: they may be processed
+         /// concurrently.
+      virtual bool isParallelSafe() const
+      { return true; };
 
 
          /// Returns a string identifying this object.
@@ -289,6 +310,36 @@ namespace gpstk
       AntexReader* pAntexReader;
 
 
+         /// Geometry cache of the epochs, if any
+      SatGeometryCache* pGeometry;
+
+
+         /// Sun position of the epoch processed
+      Triple sunPos;
+
+
+         /// Antennas of the satellites, looked up in the Antex file
+      std::map<SatID, Antenna> satAntennas;
+
+
+         /// Computes the phase correction of a satellite of the epoch.
+      virtual bool processSat( const CommonTime& time,
+                               const SatID& sat,
+                               typeValueMap& tvMap );
+
+
+         /// Looks up the antennas of the satellites of 'gData' valid at
+         /// 'time' that are not known yet.
+      void updateSatAntennas( const CommonTime& time,
+                              const SatTypePtrMap& gData );
+
+
+         /// Returns the antenna of a satellite valid at 'time'.
+         /// @throw ObjectNotFound if it was not found in the Antex file.
+      const Antenna& getSatAntenna( const SatID& satid,
+                                    const CommonTime& time ) const;
+
+
          /** Compute the value of satellite antenna phase correction, in meters
           * @param satid     Satellite ID
           * @param time      Epoch of interest
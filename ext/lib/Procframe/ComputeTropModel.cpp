@@ -68,81 +68,8 @@ namespace gpstk
       try
       {
 
-         SatIDSet satRejectedSet;
-
-            // Loop through all the satellites
-         for(auto stv = gData.begin(); stv != gData.end(); ++stv) 
-         {
-
-            // First check if TropModel was set
-            if(pTropModel==NULL)
-            {
-                  // If TropModel is missing, then remove all satellites
-               satRejectedSet.insert( (*stv).first );
-               continue;
-            }
-
-               // If satellite elevation is missing, remove satellite
-            if( (*stv).second->get_value().find(TypeID::elevation) == (*stv).second->get_value().end() )
-            {
-               satRejectedSet.insert( (*stv).first );
-               continue;
-            }
-            else
-            {
-
-                  // Scalar to hold satellite elevation
-               double elevation( (*stv).second->get_value()(TypeID::elevation) );
-               double azimuth( (*stv).second->get_value()(TypeID::azimuth) );
-               double tropoCorr(0.0), dryZDelay(0.0), wetZDelay(0.0);
-               double dryMap(0.0), wetMap(0.0), gradientMap(0.0);
-
-               try
-               {
-                     // Compute tropospheric slant correction
-                  tropoCorr = pTropModel->correction(elevation);
-                  dryZDelay = pTropModel->dry_zenith_delay();
-                  wetZDelay = pTropModel->wet_zenith_delay();
-                  dryMap = pTropModel->dry_mapping_function(elevation);
-                  wetMap = pTropModel->wet_mapping_function(elevation);
-				  gradientMap = pTropModel->gradient_mapping_function(elevation);
-
-                     // Check validity
-                  if( !(pTropModel->isValid()) )
-                  {
-                     tropoCorr = 0.0;
-                     dryZDelay = 0.0;
-                     wetZDelay = 0.0;
-                     dryMap    = 0.0;
-                     wetMap    = 0.0;
-					 gradientMap = 0.0;
-                  }
-
-               }
-               catch(InvalidTropModel& e)
-               {
-                     // If some problem appears, then schedule this
-                     // satellite for removal
-                  satRejectedSet.insert( (*stv).first );
-                  continue;    // Skip this SV if problems arise
-               };
-
-                  // Now we have to add the new values to the data structure
-               (*stv).second->get_value()[TypeID::tropoSlant] = tropoCorr;
-               (*stv).second->get_value()[TypeID::dryTropo] = dryZDelay;
-               (*stv).second->get_value()[TypeID::wetTropo] = wetZDelay;
-               (*stv).second->get_value()[TypeID::dryMap] = dryMap;
-               (*stv).second->get_value()[TypeID::wetMap] = wetMap;
-			   
-			   if (useGraients)
-			   {
-				   (*stv).second->get_value()[TypeID::wetMapNorth] = gradientMap* ::cos(azimuth*DEG_TO_RAD);
-				   (*stv).second->get_value()[TypeID::wetMapEast] = gradientMap * ::sin(azimuth*DEG_TO_RAD);
-			   }
-
-            }
-
-         }  // End of loop 'for(stv = gData.begin()...'
+            // Process the satellites
+         SatIDSet satRejectedSet( processSats(time, gData) );
 
             // Remove satellites with missing data
          gData.removeSatID(satRejectedSet);
@@ -163,4 +90,88 @@ namespace gpstk
    } // End ComputeTropModel::Process()
 
 
+      /* Computes the tropospheric model of satellite 'sat' of the epoch
+       * 'time'.
+       *
+       * @param time      Epoch.
+       * @param sat       Satellite.
+       * @param tvMap     Data of the satellite.
+       *
+       * @return false if the satellite must be removed.
+       */
+   bool ComputeTropModel::processSat( const CommonTime& time,
+                                      const SatID& sat,
+                                      typeValueMap& tvMap )
+   {
+
+         // First check if TropModel was set
+      if(pTropModel==NULL)
+      {
+            // If TropModel is missing, then remove all satellites
+         return false;
+      }
+
+         // If satellite elevation is missing, remove satellite
+      if( tvMap.find(TypeID::elevation) == tvMap.end() )
+      {
+         return false;
+      }
+      else
+      {
+
+            // Scalar to hold satellite elevation
+         double elevation( tvMap(TypeID::elevation) );
+         double azimuth( tvMap(TypeID::azimuth) );
+         double tropoCorr(0.0), dryZDelay(0.0), wetZDelay(0.0);
+         double dryMap(0.0), wetMap(0.0), gradientMap(0.0);
+
+         try
+         {
+               // Compute tropospheric slant correction
+            tropoCorr = pTropModel->correction(elevation);
+            dryZDelay = pTropModel->dry_zenith_delay();
+            wetZDelay = pTropModel->wet_zenith_delay();
+            dryMap = pTropModel->dry_mapping_function(elevation);
+            wetMap = pTropModel->wet_mapping_function(elevation);
+				  gradientMap = pTropModel->gradient_mapping_function(elevation);
+
+               // Check validity
+            if( !(pTropModel->isValid()) )
+            {
+               tropoCorr = 0.0;
+               dryZDelay = 0.0;
+               wetZDelay = 0.0;
+               dryMap    = 0.0;
+               wetMap    = 0.0;
+					 gradientMap = 0.0;
+            }
+
+         }
+         catch(InvalidTropModel& e)
+         {
+               // If some problem appears, then schedule this
+               // satellite for removal
+            return false;
+         };
+
+            // Now we have to add the new values to the data structure
+         tvMap[TypeID::tropoSlant] = tropoCorr;
+         tvMap[TypeID::dryTropo] = dryZDelay;
+         tvMap[TypeID::wetTropo] = wetZDelay;
+         tvMap[TypeID::dryMap] = dryMap;
+         tvMap[TypeID::wetMap] = wetMap;
+			   
+			   if (useGraients)
+			   {
+				   tvMap[TypeID::wetMapNorth] = gradientMap* ::cos(azimuth*DEG_TO_RAD);
+				   tvMap[TypeID::wetMapEast] = gradientMap * ::sin(azimuth*DEG_TO_RAD);
+			   }
+
+      }
+
+      return true;
+
+   }  // End of method 'ComputeTropModel::processSat()'
+
+
 } // End of namespace gpstk
@@ -174,6 +174,12 @@ namespace gpstk
       { pTropModel = &tropoModel; return (*this); };
 
 
+         /// The satellites are processed independently, with the const
+         /// methods of the TropModel: they may be processed concurrently.
+      virtual bool isParallelSafe() const
+      { return true; };
+
+
          /// Returns a string identifying this object.
       virtual std::string getClassName(void) const;
 
@@ -182,6 +188,15 @@ namespace gpstk
       virtual ~ComputeTropModel() {};
 
 
+   protected:
+
+
+         /// Computes the tropospheric model of a satellite of the epoch.
+      virtual bool processSat( const CommonTime& time,
+                               const SatID& sat,
+                               typeValueMap& tvMap );
+
+
    private:
 
 
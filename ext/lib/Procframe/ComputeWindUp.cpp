@@ -69,7 +69,8 @@ namespace gpstk
 
             // Compute Sun position at this epoch
          SunPosition sunPosition;
-         Triple sunPos(sunPosition.getPosition(time));
+         Triple sunPos( (pGeometry != NULL) ? pGeometry->getSunPosition(time)
+                                            : sunPosition.getPosition(time) );
 
             // Define a Triple that will hold satellite position, in ECEF
          Triple svPos(0.0, 0.0, 0.0);
@@ -105,10 +106,18 @@ namespace gpstk
             }
 
 
+               // Take satellite position from the geometry cache, if any
+            const CorrectedEphemerisRange* cached = (pGeometry != NULL) ?
+               pGeometry->find( (*it).first, time ) : NULL;
+
+            if( cached != NULL )
+            {
+               svPos = cached->svPosVel.x;
+            }
                // Use ephemeris if satellite position is not already computed
-            if( ( (*it).second->get_value().find(TypeID::satX) == (*it).second->get_value().end() ) ||
-                ( (*it).second->get_value().find(TypeID::satY) == (*it).second->get_value().end() ) ||
-                ( (*it).second->get_value().find(TypeID::satZ) == (*it).second->get_value().end() ) )
+            else if( ( (*it).second->get_value().find(TypeID::satX) == (*it).second->get_value().end() ) ||
+                     ( (*it).second->get_value().find(TypeID::satY) == (*it).second->get_value().end() ) ||
+                     ( (*it).second->get_value().find(TypeID::satZ) == (*it).second->get_value().end() ) )
             {
 
                if(pEphemeris==NULL)
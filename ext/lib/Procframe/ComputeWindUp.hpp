@@ -50,6 +50,7 @@
 #include "SunPosition.hpp"
 #include "XvtStore.hpp"
 #include "SatDataReader.hpp"
+#include "SatGeometryCache.hpp"
 #include "GNSSconstants.hpp"
 
 
@@ -115,13 +116,13 @@ namespace gpstk
          /// Default constructor
       ComputeWindUp()
          : pEphemeris(NULL), nominalPos(0.0, 0.0, 0.0),
-           satData("PRN_GPS"), fileData("PRN_GPS")
+           satData("PRN_GPS"), fileData("PRN_GPS"), pGeometry(NULL)
       { };
 
       ComputeWindUp(XvtStore<SatID>& ephem,
           std::string filename = "PRN_GPS")
           : pEphemeris(&ephem), nominalPos(0.0, 0.0, 0.0), satData(filename),
-          fileData(filename)
+          fileData(filename), pGeometry(NULL)
       { };
 
          /** Common constructor
@@ -138,7 +139,7 @@ namespace gpstk
                      const Position& stapos,
                      std::string filename="PRN_GPS" )
          : pEphemeris(&ephem), nominalPos(stapos), satData(filename),
-           fileData(filename)
+           fileData(filename), pGeometry(NULL)
       { };
 
 
@@ -200,6 +201,15 @@ namespace gpstk
       { pEphemeris = &ephem; return (*this); };
 
 
+         /** Sets the geometry cache of the epochs, giving the satellite
+          *  positions and the Sun position computed once per epoch.
+          *
+          * @param geometry  SatGeometryCache object
+          */
+      virtual ComputeWindUp& setGeometryCache(SatGeometryCache& geometry)
+      { pGeometry = &geometry; return (*this); };
+
+
          /// Returns a string identifying this object.
       virtual std::string getClassName(void) const;
 
@@ -227,6 +237,10 @@ namespace gpstk
       std::string fileData;
 
 
+         /// Geometry cache of the epochs, if any
+      SatGeometryCache* pGeometry;
+
+
          /// A structure used to store phase data.
       struct phaseData
       {
@@ -115,7 +115,8 @@ namespace gpstk
 
             // Compute Sun position at this epoch, and store it in a Triple
          SunPosition sunPosition;
-         Triple sunPos(sunPosition.getPosition(epoch));
+         Triple sunPos( (pGeometry != NULL) ? pGeometry->getSunPosition(epoch)
+                                            : sunPosition.getPosition(epoch) );
 
             // Define a Triple that will hold satellite position, in ECEF
          Triple svPos(0.0, 0.0, 0.0);
@@ -123,10 +124,18 @@ namespace gpstk
             // Loop through all the satellites
          for (auto it = gData.begin(); it != gData.end(); ++it) 
          {
+               // Take satellite position from the geometry cache, if any
+            const CorrectedEphemerisRange* cached = (pGeometry != NULL) ?
+               pGeometry->find( (*it).first, epoch ) : NULL;
+
+            if( cached != NULL )
+            {
+               svPos = cached->svPosVel.x;
+            }
                // Check if satellite position is not already computed
-            if( ( (*it).second->get_value().find(TypeID::satX) == (*it).second->get_value().end() ) ||
-                ( (*it).second->get_value().find(TypeID::satY) == (*it).second->get_value().end() ) ||
-                ( (*it).second->get_value().find(TypeID::satZ) == (*it).second->get_value().end() ) )
+            else if( ( (*it).second->get_value().find(TypeID::satX) == (*it).second->get_value().end() ) ||
+                     ( (*it).second->get_value().find(TypeID::satY) == (*it).second->get_value().end() ) ||
+                     ( (*it).second->get_value().find(TypeID::satZ) == (*it).second->get_value().end() ) )
             {
 
                   // If satellite position is missing, then schedule this 
@@ -48,6 +48,7 @@
 #include "SunPosition.hpp"
 #include "Position.hpp"
 #include "ProcessingClass.hpp"
+#include "SatGeometryCache.hpp"
 #include "GNSSconstants.hpp"                   // DEG_TO_RAD
 
 
@@ -114,7 +115,8 @@ namespace gpstk
       public:
 
          /// Default constructor.
-      EclipsedSatFilter() : coneAngle(30.0), postShadowPeriod(1800.0)
+      EclipsedSatFilter() : coneAngle(30.0), postShadowPeriod(1800.0),
+         pGeometry(NULL)
       { };
 
 
@@ -126,7 +128,7 @@ namespace gpstk
           */
       EclipsedSatFilter( const double angle,
                          const double pShTime )
-         : coneAngle(angle), postShadowPeriod(pShTime)
+         : coneAngle(angle), postShadowPeriod(pShTime), pGeometry(NULL)
       { };
 
 
@@ -178,6 +180,15 @@ namespace gpstk
       virtual EclipsedSatFilter& setPostShadowPeriod(const double pShTime);
 
 
+         /** Sets the geometry cache of the epochs, giving the satellite
+          *  positions and the Sun position computed once per epoch.
+          *
+          * @param geometry  SatGeometryCache object
+          */
+      virtual EclipsedSatFilter& setGeometryCache(SatGeometryCache& geometry)
+      { pGeometry = &geometry; return (*this); };
+
+
          /// Returns a string identifying this object.
       virtual std::string getClassName(void) const;
 
@@ -199,6 +210,10 @@ namespace gpstk
          /// Map holding the time information about every satellite in eclipse
       std::map<SatID, CommonTime> shadowEpoch;
 
+
+         /// Geometry cache of the epochs, if any
+      SatGeometryCache* pGeometry;
+
    }; // End of class 'EclipsedSatFilter'
 
       //@}
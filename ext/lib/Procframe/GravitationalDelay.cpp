@@ -76,79 +76,99 @@ namespace gpstk
       try
       {
 
-         SatIDSet satRejectedSet;
+            // Process the satellites
+         SatIDSet satRejectedSet( processSats(epoch, gData) );
 
-            // Define a Triple that will hold satellite position, in ECEF
-         Triple svPos(0.0, 0.0, 0.0);
+            // Remove satellites with missing data
+         gData.removeSatID(satRejectedSet);
+         rejectedSatsTable[epoch] = satRejectedSet;
+         return gData;
 
-            // Loop through all the satellites
-         for (auto it = gData.begin(); it != gData.end(); ++it)
-         {
-               // Check if satellite position is not already computed
-            if( ( (*it).second->get_value().find(TypeID::satX) == (*it).second->get_value().end() ) ||
-                ( (*it).second->get_value().find(TypeID::satY) == (*it).second->get_value().end() ) ||
-                ( (*it).second->get_value().find(TypeID::satZ) == (*it).second->get_value().end() ) )
-            {
+      }
+      catch(Exception& u)
+      {
+            // Throw an exception if something unexpected happens
+         ProcessingException e( getClassName() + ":"
+                                + u.what() );
 
-                  // If satellite position is missing, then schedule this 
-                  // satellite for removal
-               satRejectedSet.insert( (*it).first );
+         GPSTK_THROW(e);
 
-               continue;
+      }
 
-            }
-            else
-            {
+   }  // End of method 'GravitationalDelay::Process()'
 
-                  // Get satellite position out of GDS
-               svPos[0] = (*it).second->get_value()[TypeID::satX];
-               svPos[1] = (*it).second->get_value()[TypeID::satY];
-               svPos[2] = (*it).second->get_value()[TypeID::satZ];
 
-            }  // End of 'if( ( (*it).second.find(TypeID::satX) == ...'
+      /* Computes the gravitational delay of satellite 'sat' of the epoch
+       * 'epoch'.
+       *
+       * @param epoch     Epoch.
+       * @param sat       Satellite.
+       * @param tvMap     Data of the satellite.
+       *
+       * @return false if the satellite must be removed.
+       */
+   bool GravitationalDelay::processSat( const CommonTime& epoch,
+                                        const SatID& sat,
+                                        typeValueMap& tvMap )
+   {
 
-               // Get magnitude of satellite position vector
-            double r2(svPos.mag());
+         // Define a Triple that will hold satellite position, in ECEF
+      Triple svPos(0.0, 0.0, 0.0);
 
-               // Get vector from Earth mass center to receiver
-            Triple rxPos(nominalPos.X(), nominalPos.Y(), nominalPos.Z());
+         // Take satellite position from the geometry cache, if any
+      const CorrectedEphemerisRange* cached = (pGeometry != NULL) ?
+         pGeometry->find( sat, epoch ) : NULL;
 
-               // Compute magnitude of receiver position vector
-            double r1(rxPos.mag());
+      if( cached != NULL )
+      {
+         svPos = cached->svPosVel.x;
+      }
+         // Check if satellite position is not already computed
+      else if( ( tvMap.find(TypeID::satX) == tvMap.end() ) ||
+               ( tvMap.find(TypeID::satY) == tvMap.end() ) ||
+               ( tvMap.find(TypeID::satZ) == tvMap.end() ) )
+      {
 
-               // Compute the difference vector between satellite and
-               // receiver positions
-            Position difPos(svPos - rxPos);
+            // If satellite position is missing, then schedule this 
+            // satellite for removal
+         return false;
 
-               // Compute magnitude of the diference between rxPos and svPos
-            double r12( difPos.mag() );
+      }
+      else
+      {
 
-               // Compute gravitational delay correction
-            double gravDel( K*std::log( (r1+r2+r12)/(r1+r2-r12) ) );
+            // Get satellite position out of GDS
+         svPos[0] = tvMap[TypeID::satX];
+         svPos[1] = tvMap[TypeID::satY];
+         svPos[2] = tvMap[TypeID::satZ];
 
-               // Get the correction into the GDS
-            (*it).second->get_value()[TypeID::gravDelay] = gravDel;
+      }  // End of 'if( ( tvMap.find(TypeID::satX) == ...'
 
-         }  // End of 'for (it = gData.begin(); it != gData.end(); ++it)'
+         // Get magnitude of satellite position vector
+      double r2(svPos.mag());
 
+         // Get vector from Earth mass center to receiver
+      Triple rxPos(nominalPos.X(), nominalPos.Y(), nominalPos.Z());
 
-            // Remove satellites with missing data
-         gData.removeSatID(satRejectedSet);
-         rejectedSatsTable[epoch] = satRejectedSet;
-         return gData;
+         // Compute magnitude of receiver position vector
+      double r1(rxPos.mag());
 
-      }
-      catch(Exception& u)
-      {
-            // Throw an exception if something unexpected happens
-         ProcessingException e( getClassName() + ":"
-                                + u.what() );
+         // Compute the difference vector between satellite and
+         // receiver positions
+      Position difPos(svPos - rxPos);
 
-         GPSTK_THROW(e);
+         // Compute magnitude of the diference between rxPos and svPos
+      double r12( difPos.mag() );
 
-      }
+         // Compute gravitational delay correction
+      double gravDel( K*std::log( (r1+r2+r12)/(r1+r2-r12) ) );
 
-   }  // End of method 'GravitationalDelay::Process()'
+         // Get the correction into the GDS
+      tvMap[TypeID::gravDelay] = gravDel;
+
+      return true;
+
+   }  // End of method 'GravitationalDelay::processSat()'
 
 
 
@@ -46,6 +46,7 @@
 #include <math.h>
 #include "Position.hpp"
 #include "ProcessingClass.hpp"
+#include "SatGeometryCache.hpp"
 
 
 
@@ -118,7 +119,7 @@ namespace gpstk
       public:
 
          /// Default constructor.
-      GravitationalDelay() : nominalPos(0.0, 0.0, 0.0)
+      GravitationalDelay() : nominalPos(0.0, 0.0, 0.0), pGeometry(NULL)
       { };
 
 
@@ -126,7 +127,8 @@ namespace gpstk
           *
           * @param stapos    Nominal position of receiver station.
           */
-      GravitationalDelay(const Position& stapos) : nominalPos(stapos)
+      GravitationalDelay(const Position& stapos)
+         : nominalPos(stapos), pGeometry(NULL)
       { };
 
 
@@ -163,6 +165,21 @@ namespace gpstk
         { nominalPos = stapos; return (*this); };
 
 
+         /** Sets the geometry cache of the epochs, giving the satellite
+          *  positions computed once per epoch.
+          *
+          * @param geometry  SatGeometryCache object
+          */
+      virtual GravitationalDelay& setGeometryCache(SatGeometryCache& geometry)
+      { pGeometry = &geometry; return (*this); };
+
+
+         /// The satellites are processed independently: they may be
+         /// processed concurrently.
+      virtual bool isParallelSafe() const
+      { return true; };
+
+
          /// Returns a string identifying this object.
       virtual std::string getClassName(void) const;
 
@@ -178,6 +195,16 @@ namespace gpstk
       Position nominalPos;
 
 
+         /// Geometry cache of the epochs, if any
+      SatGeometryCache* pGeometry;
+
+
+         /// Computes the gravitational delay of a satellite of the epoch.
+      virtual bool processSat( const CommonTime& epoch,
+                               const SatID& sat,
+                               typeValueMap& tvMap );
+
+
    }; // End of class 'GravitationalDelay'
 
       //@}
@@ -78,6 +78,7 @@ namespace gpstk
    {
 
       minElev = 10.0;
+      pGeometry = NULL;
       useTGD = true;
       pDefaultIonoModel = NULL;
       pDefaultTropoModel = NULL;
@@ -96,6 +97,7 @@ namespace gpstk
    {
 
       minElev = 10.0;
+      pGeometry = NULL;
       useTGD = true;
       pDefaultIonoModel = NULL;
       pDefaultTropoModel = NULL;
@@ -130,6 +132,7 @@ namespace gpstk
    {
 
       minElev = 10.0;
+      pGeometry = NULL;
       InitializeValues();
       setInitialRxPosition(RxCoordinates);
       setDefaultIonoModel(dIonoModel);
@@ -163,6 +166,7 @@ namespace gpstk
    {
 
       minElev = 10.0;
+      pGeometry = NULL;
       pDefaultTropoModel = NULL;
       InitializeValues();
       setInitialRxPosition(RxCoordinates);
@@ -196,6 +200,7 @@ namespace gpstk
    {
 
       minElev = 10.0;
+      pGeometry = NULL;
       pDefaultIonoModel = NULL;
       InitializeValues();
       setInitialRxPosition(RxCoordinates);
@@ -227,6 +232,7 @@ namespace gpstk
    {
 
       minElev = 10.0;
+      pGeometry = NULL;
       pDefaultIonoModel = NULL;
       pDefaultTropoModel = NULL;
       InitializeValues();
@@ -270,28 +276,49 @@ namespace gpstk
                // A lot of the work is done by a CorrectedEphemerisRange object
             CorrectedEphemerisRange cerange;
 
-            try
+               // Take it from the geometry cache of this epoch, if any
+            if( pGeometry != NULL && pGeometry->isCurrent(time) )
             {
-                  // Compute most of the parameters
-               tempPR = cerange.ComputeAtTransmitTime( time,
-                                                       observable,
-                                                       rxPos,
-                                                       (*stv).first,
-                                                    *(getDefaultEphemeris()) );
+               const CorrectedEphemerisRange* cached =
+                  pGeometry->find( (*stv).first, time );
+
+               if( cached == NULL )
+               {
+                     // No ephemeris for this satellite
+                  satRejectedSet.insert( (*stv).first );
+
+                  continue;
+               }
+
+               cerange = *cached;
+               tempPR = cerange.rawrange - cerange.svclkbias
+                        - cerange.relativity;
             }
-            catch(InvalidRequest& e)
+            else
             {
+               try
+               {
+                     // Compute most of the parameters
+                  tempPR = cerange.ComputeAtTransmitTime( time,
+                                                          observable,
+                                                          rxPos,
+                                                          (*stv).first,
+                                                    *(getDefaultEphemeris()) );
+               }
+               catch(InvalidRequest& e)
+               {
 
-                  // If some problem appears, then schedule this satellite
-                  // for removal
-               satRejectedSet.insert( (*stv).first );
+                     // If some problem appears, then schedule this satellite
+                     // for removal
+                  satRejectedSet.insert( (*stv).first );
 
-               continue;    // Skip this SV if problems arise
+                  continue;    // Skip this SV if problems arise
 
+               }
             }
 
                // Let's test if satellite has enough elevation over horizon
-            if ( rxPos.elevationGeodetic(cerange.svPosVel) < minElev )
+            if ( cerange.elevationGeodetic < minElev )
             {
 
                   // Mark this satellite if it doesn't have enough elevation
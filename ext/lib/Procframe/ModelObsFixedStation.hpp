@@ -51,6 +51,7 @@
 #include "GPSEphemerisStore.hpp"
 #include "TropModel.hpp"
 #include "IonoModelStore.hpp"
+#include "SatGeometryCache.hpp"
 
 
 namespace gpstk
@@ -115,7 +116,7 @@ namespace gpstk
       ModelObsFixedStation()
          : minElev(10.0), useTGD(true), pDefaultIonoModel(NULL),
            pDefaultTropoModel(NULL), defaultObservable(TypeID::C1),
-           pDefaultEphemeris(NULL)
+           pDefaultEphemeris(NULL), pGeometry(NULL)
       { InitializeValues(); };
 
 
@@ -331,6 +332,17 @@ namespace gpstk
       { pDefaultEphemeris = &ephem; return (*this); };
 
 
+         /** Method to set the geometry cache of the epochs. When the cache
+          *  holds the epoch processed, the satellite positions, ranges and
+          *  corrections are taken from it instead of being computed.
+          *
+          * @param geometry  SatGeometryCache object, processing the epochs
+          *                  before this object
+          */
+      virtual ModelObsFixedStation& setGeometryCache(SatGeometryCache& geometry)
+      { pGeometry = &geometry; return (*this); };
+
+
          /// Either estimated or "a priori" position of receiver
       Position rxPos;
 
@@ -394,6 +406,9 @@ namespace gpstk
          /// data structures.
       XvtStore<SatID>* pDefaultEphemeris;
 
+         /// Geometry cache of the epochs, if any
+      SatGeometryCache* pGeometry;
+
          /// Initialization method
       virtual void InitializeValues()
       { setInitialRxPosition(); };
@@ -0,0 +1,327 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file PipelinedProcessingList.cpp
+ * List of ProcessingClass objects whose stages process successive epochs
+ * at the same time, each on its own thread.
+ */
+
+#include "PipelinedProcessingList.hpp"
+#include "Decimate.hpp"
+
+#include <chrono>
+#include <exception>
+#include <thread>
+
+
+namespace gpstk
+{
+
+   namespace
+   {
+      typedef std::chrono::steady_clock Clock;
+
+      double seconds(Clock::duration d)
+      { return std::chrono::duration<double>(d).count(); }
+   }
+
+
+      // Returns a string identifying this object.
+   std::string PipelinedProcessingList::getClassName() const
+   { return "PipelinedProcessingList"; }
+
+
+
+      /* Starts a new stage, with 'pClass' as its first object.
+       *
+       * @param pClass     Processing object to be added.
+       * @param name       Name of the stage in the statistics; the
+       *                   class name of 'pClass' if empty.
+       */
+   PipelinedProcessingList::StageAdder
+      PipelinedProcessingList::addStage( ProcessingClass& pClass,
+                                         const std::string& name )
+   {
+
+      Stage stage;
+      stage.name = name.empty() ? pClass.getClassName() : name;
+      stage.objects.push_back(&pClass);
+      stages.push_back(stage);
+
+      return StageAdder(*this);
+
+   }  // End of method 'PipelinedProcessingList::addStage()'
+
+
+
+      // Adds 'pClass' to the last stage, or starts the first one.
+   void PipelinedProcessingList::push_back(ProcessingClass& pClass)
+   {
+
+      if (stages.empty())
+         addStage(pClass);
+      else
+         stages.back().objects.push_back(&pClass);
+
+   }  // End of method 'PipelinedProcessingList::push_back()'
+
+
+
+      /* Processing method: applies all the objects, stage by stage,
+       * on the calling thread.
+       *
+       * @param gData    Data object holding the data.
+       */
+   IRinex& PipelinedProcessingList::Process(IRinex& gData)
+   {
+
+      for (const auto& stage : stages)
+      {
+         for (ProcessingClass* pClass : stage.objects)
+         {
+            gData >> (*pClass);
+         }
+      }
+
+      return gData;
+
+   }  // End of method 'PipelinedProcessingList::Process()'
+
+
+
+      // Runs stage 'i' between the queues 'in' and 'out'.
+   void PipelinedProcessingList::runStage( size_t i,
+                                           EpochQueue& in,
+                                           EpochQueue& out,
+                                           StageStats& st )
+   {
+
+      const std::vector<ProcessingClass*>& objects(stages[i].objects);
+
+      irinex_uptr gData;
+      for (;;)
+      {
+         Clock::time_point t0 = Clock::now();
+         if (!in.pop(gData))
+            break;
+         Clock::time_point t1 = Clock::now();
+
+         bool dropped(false);
+         try
+         {
+            for (ProcessingClass* pClass : objects)
+            {
+               (*gData) >> (*pClass);
+            }
+         }
+         catch (DecimateEpoch&)
+         {
+            dropped = true;
+         }
+         Clock::time_point t2 = Clock::now();
+
+         ++st.epochs;
+         st.waitIn += seconds(t1 - t0);
+         st.busy += seconds(t2 - t1);
+
+         if (dropped)
+         {
+            ++st.dropped;
+            continue;
+         }
+
+         bool ok = out.push(gData);
+         st.waitOut += seconds(Clock::now() - t2);
+         if (!ok)
+            break;
+      }
+
+      out.finish();
+
+   }  // End of method 'PipelinedProcessingList::runStage()'
+
+
+
+      /* Processes all the epochs of 'source' and hands them over to
+       * 'sink', with the stages running on their own threads.
+       */
+   unsigned long PipelinedProcessingList::run( EpochSource source,
+                                               EpochSink sink )
+   {
+
+      const size_t n(stages.size());
+
+         // queues[i] feeds stage i; queues[n] feeds the sink
+      std::vector<std::unique_ptr<EpochQueue> > queues;
+      for (size_t i = 0; i <= n; i++)
+      {
+         queues.push_back(
+            std::unique_ptr<EpochQueue>(new EpochQueue(queueCapacity)) );
+      }
+
+      stats.assign(n + 2, StageStats());
+      stats.front().name = "read";
+      for (size_t i = 0; i < n; i++)
+      {
+         stats[i + 1].name = stages[i].name;
+      }
+      stats.back().name = "output";
+
+         // The first exception stops everything
+      std::mutex errorMtx;
+      std::exception_ptr error;
+      auto fail = [&]()
+      {
+         {
+            std::lock_guard<std::mutex> lock(errorMtx);
+            if (!error)
+               error = std::current_exception();
+         }
+         for (auto& q : queues)
+         {
+            q->abort();
+         }
+      };
+
+      Clock::time_point start = Clock::now();
+
+      std::vector<std::thread> threads;
+
+      threads.push_back(std::thread([&]()
+      {
+         StageStats& st(stats.front());
+         EpochQueue& out(*queues.front());
+         try
+         {
+            for (;;)
+            {
+               Clock::time_point t0 = Clock::now();
+               irinex_uptr gData(source());
+               Clock::time_point t1 = Clock::now();
+               st.busy += seconds(t1 - t0);
+               if (!gData)
+                  break;
+
+               ++st.epochs;
+               bool ok = out.push(gData);
+               st.waitOut += seconds(Clock::now() - t1);
+               if (!ok)
+                  break;
+            }
+            out.finish();
+         }
+         catch (...)
+         {
+            fail();
+         }
+      }));
+
+      for (size_t i = 0; i < n; i++)
+      {
+         threads.push_back(std::thread([&, i]()
+         {
+            try
+            {
+               runStage(i, *queues[i], *queues[i + 1], stats[i + 1]);
+            }
+            catch (...)
+            {
+               fail();
+            }
+         }));
+      }
+
+         // The sink runs here
+      StageStats& st(stats.back());
+      try
+      {
+         irinex_uptr gData;
+         for (;;)
+         {
+            Clock::time_point t0 = Clock::now();
+            if (!queues.back()->pop(gData))
+               break;
+            Clock::time_point t1 = Clock::now();
+            sink(std::move(gData));
+            ++st.epochs;
+            st.waitIn += seconds(t1 - t0);
+            st.busy += seconds(Clock::now() - t1);
+         }
+      }
+      catch (...)
+      {
+         fail();
+      }
+
+      for (auto& t : threads)
+      {
+         t.join();
+      }
+
+      double wallTime = seconds(Clock::now() - start);
+      for (auto& it : stats)
+      {
+         it.wallTime = wallTime;
+      }
+
+      if (error)
+         std::rethrow_exception(error);
+
+      return st.epochs;
+
+   }  // End of method 'PipelinedProcessingList::run()'
+
+
+
+      // Prints the statistics of the last run as CSV.
+   void PipelinedProcessingList::printStats(std::ostream& os) const
+   {
+
+      os << "stage,epochs,dropped,busy_s,wait_in_s,wait_out_s,occupancy,"
+         << "epochs_per_s" << std::endl;
+
+      for (const auto& it : stats)
+      {
+         os << it.name << ',' << it.epochs << ',' << it.dropped << ','
+            << it.busy << ',' << it.waitIn << ',' << it.waitOut << ','
+            << it.occupancy() << ',' << it.throughput() << std::endl;
+      }
+
+   }  // End of method 'PipelinedProcessingList::printStats()'
+
+
+}  // End of namespace gpstk
@@ -0,0 +1,359 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file PipelinedProcessingList.hpp
+ * List of ProcessingClass objects whose stages process successive epochs
+ * at the same time, each on its own thread.
+ */
+
+#ifndef GPSTK_PIPELINEDPROCESSINGLIST_HPP
+#define GPSTK_PIPELINEDPROCESSINGLIST_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "ProcessingClass.hpp"
+#include "RinexEpoch.h"
+
+
+namespace gpstk
+{
+
+      /// @ingroup GPSsolutions
+      //@{
+
+
+      /** Bounded first-in first-out queue between two threads.
+       *
+       * push() waits while the queue is full and pop() while it is empty.
+       * The producer calls finish() after its last item; abort() makes
+       * both sides give up at once.
+       */
+   template <class T>
+   class BoundedQueue
+   {
+   public:
+
+         /// Queue holding up to 'capacity' items (at least one).
+      explicit BoundedQueue(size_t capacity)
+         : maxSize(capacity > 0 ? capacity : 1),
+           finished(false), aborted(false)
+      { };
+
+
+         /// Adds 'item'; returns false, leaving 'item', if aborted.
+      bool push(T& item)
+      {
+         std::unique_lock<std::mutex> lock(mtx);
+         notFull.wait(lock, [this]
+            { return (aborted || items.size() < maxSize); });
+         if (aborted)
+            return false;
+
+         items.push_back(std::move(item));
+         notEmpty.notify_one();
+         return true;
+      };
+
+
+         /** Takes the oldest item; returns false once the queue is
+          *  finished and empty, or aborted.
+          */
+      bool pop(T& item)
+      {
+         std::unique_lock<std::mutex> lock(mtx);
+         notEmpty.wait(lock, [this]
+            { return (aborted || finished || !items.empty()); });
+         if (aborted || items.empty())
+            return false;
+
+         item = std::move(items.front());
+         items.pop_front();
+         notFull.notify_one();
+         return true;
+      };
+
+
+         /// No more items will be pushed.
+      void finish()
+      {
+         std::lock_guard<std::mutex> lock(mtx);
+         finished = true;
+         notEmpty.notify_all();
+      };
+
+
+         /// Wakes up both sides, and drops the items queued.
+      void abort()
+      {
+         std::lock_guard<std::mutex> lock(mtx);
+         aborted = true;
+         items.clear();
+         notEmpty.notify_all();
+         notFull.notify_all();
+      };
+
+
+   private:
+
+      BoundedQueue(const BoundedQueue&);
+      BoundedQueue& operator=(const BoundedQueue&);
+
+      std::mutex mtx;
+      std::condition_variable notEmpty, notFull;
+      std::deque<T> items;
+      size_t maxSize;
+      bool finished;
+      bool aborted;
+
+   }; // End of class 'BoundedQueue'
+
+
+
+      /** List of ProcessingClass objects whose stages process successive
+       *  epochs at the same time.
+       *
+       * The objects are grouped in stages; each stage runs on its own
+       * thread and hands the epochs over to the next one through a
+       * bounded queue of 'irinex_uptr'. While the filter processes an
+       * epoch, the modeling stage may model the next one and the reader
+       * read the one after.
+       *
+       * Every stage sees all the epochs in the order they are read, on
+       * the same thread, so the objects keeping state from epoch to epoch
+       * (cycle slip detectors, solvers, ...) work as in a ProcessingList.
+       * An object must not be shared between two stages, nor used
+       * elsewhere while the list runs.
+       *
+       * The same holds for the state objects share through pointers and
+       * references: a SatGeometryCache and all the objects given it with
+       * setGeometryCache() must be in the same stage, after the cache, or
+       * the objects of a later stage would read the geometry of another
+       * epoch while the cache computes it. Likewise an object reading a
+       * nominal position held by reference must be in the stage of the
+       * object updating that position. The list cannot check this.
+       *
+       * @code
+       *   basic.setGeometryCache(geometry);
+       *   windup.setGeometryCache(geometry);
+       *
+       *   PipelinedProcessingList pList;
+       *   pList.addStage(requireObs, "filter").add(codeFilter);
+       *   pList.addStage(geometry, "model").add(basic).add(windup)
+       *      .add(computeTropo).add(linear);
+       *   pList.addStage(markCSLI, "cycle slips").add(markCSMW);
+       *   pList.addStage(pppSolver, "solver");
+       *
+       *   pList.run( [&]() -> irinex_uptr
+       *      {
+       *         RinexEpoch gRin;
+       *         if (rin >> gRin)
+       *            return gRin.clone();
+       *         return irinex_uptr();
+       *      },
+       *      [&](irinex_uptr gRin)
+       *      {
+       *         // gRin has gone through all the stages
+       *      } );
+       *
+       *   pList.printStats(std::cout);
+       * @endcode
+       *
+       * The epochs for which an object throws DecimateEpoch are dropped;
+       * any other exception stops the list and is rethrown by run().
+       *
+       * Process() applies all the objects to one epoch, on the calling
+       * thread, as a ProcessingList does.
+       */
+   class PipelinedProcessingList : public ProcessingClass
+   {
+   public:
+
+         /// Returns the next epoch, or an empty pointer at the end.
+      typedef std::function<irinex_uptr()> EpochSource;
+
+         /// Takes an epoch processed by all the stages.
+      typedef std::function<void(irinex_uptr)> EpochSink;
+
+
+         /// Statistics of a stage of the last run.
+      struct StageStats
+      {
+         StageStats()
+            : epochs(0), dropped(0), busy(0.0), waitIn(0.0), waitOut(0.0),
+              wallTime(0.0)
+         {};
+
+            /// Fraction of the run spent processing.
+         double occupancy() const
+         { return (wallTime > 0.0 ? busy/wallTime : 0.0); };
+
+            /// Epochs per second the stage sustains when never waiting.
+         double throughput() const
+         { return (busy > 0.0 ? epochs/busy : 0.0); };
+
+         std::string name;
+
+            /// Epochs processed, including the dropped ones.
+         unsigned long epochs;
+         unsigned long dropped;
+
+            /// Seconds spent processing, waiting for an epoch, and
+            /// waiting for room in the next queue.
+         double busy;
+         double waitIn;
+         double waitOut;
+
+            /// Seconds of the run.
+         double wallTime;
+      };
+
+
+         /** Common constructor.
+          *
+          * @param queueSize     Epochs held between two stages.
+          */
+      explicit PipelinedProcessingList(size_t queueSize = 4)
+         : queueCapacity(queueSize)
+      { };
+
+
+         /// Processing object added to the last stage.
+      class StageAdder
+      {
+      public:
+         StageAdder& add(ProcessingClass& pClass)
+         { list.stages.back().objects.push_back(&pClass); return *this; };
+
+      private:
+         friend class PipelinedProcessingList;
+         explicit StageAdder(PipelinedProcessingList& l) : list(l) {};
+         PipelinedProcessingList& list;
+      };
+
+
+         /** Starts a new stage, with 'pClass' as its first object.
+          *
+          * @param pClass     Processing object to be added.
+          * @param name       Name of the stage in the statistics; the
+          *                   class name of 'pClass' if empty.
+          */
+      StageAdder addStage( ProcessingClass& pClass,
+                           const std::string& name = "" );
+
+
+         /// Adds 'pClass' to the last stage, or starts the first one.
+      virtual void push_back(ProcessingClass& pClass);
+
+
+         /// Returns the number of stages.
+      size_t numStages() const
+      { return stages.size(); };
+
+
+         /// Removes all the stages.
+      virtual void clear()
+      { stages.clear(); stats.clear(); };
+
+
+         /** Processes all the epochs of 'source' and hands them over to
+          *  'sink', with the stages running on their own threads.
+          *
+          * 'source' runs on a thread of its own, 'sink' on the calling
+          * thread. Returns the number of epochs handed over to 'sink'.
+          */
+      unsigned long run(EpochSource source, EpochSink sink);
+
+
+         /** Statistics of the last run: the reading ("read"), each stage,
+          *  and the sink ("output").
+          */
+      const std::vector<StageStats>& getStats() const
+      { return stats; };
+
+
+         /// Prints the statistics of the last run as CSV.
+      void printStats(std::ostream& os) const;
+
+
+         /** Processing method: applies all the objects, stage by stage,
+          *  on the calling thread.
+          *
+          * @param gData    Data object holding the data.
+          */
+      virtual IRinex& Process(IRinex& gData);
+
+
+         /// Returns a string identifying this object.
+      virtual std::string getClassName(void) const;
+
+
+         /// Destructor
+      virtual ~PipelinedProcessingList() {};
+
+
+   private:
+
+      struct Stage
+      {
+         std::string name;
+         std::vector<ProcessingClass*> objects;
+      };
+
+      typedef BoundedQueue<irinex_uptr> EpochQueue;
+
+         /// Runs stage 'i' between the queues 'in' and 'out'.
+      void runStage( size_t i, EpochQueue& in, EpochQueue& out,
+                     StageStats& st );
+
+      std::vector<Stage> stages;
+
+      std::vector<StageStats> stats;
+
+      size_t queueCapacity;
+
+   }; // End of class 'PipelinedProcessingList'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_PIPELINEDPROCESSINGLIST_HPP
@@ -0,0 +1,103 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/**
+ * @file ProcessingClass.cpp
+ * This is an abstract base class for objects processing GNSS Data Structures.
+ */
+
+#include "ProcessingClass.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+
+      /* Calls processSat() for every satellite of 'gData', on the thread
+       * pool if the object has one and is parallel-safe.
+       *
+       * @return the satellites rejected by processSat(); they are not
+       * removed from 'gData'.
+       */
+   SatIDSet ProcessingClass::processSats( const CommonTime& time,
+                                          SatTypePtrMap& gData )
+   {
+
+      SatIDSet satRejectedSet;
+
+      if( pThreadPool == NULL || !isParallelSafe() )
+      {
+         for (auto it = gData.begin(); it != gData.end(); ++it)
+         {
+            if( !processSat(time, (*it).first, (*it).second->get_value()) )
+            {
+               satRejectedSet.insert( (*it).first );
+            }
+         }
+
+         return satRejectedSet;
+      }
+
+         // The satellites are taken by index by the threads
+      vector<SatTypePtrMap::iterator> sats;
+      sats.reserve( gData.size() );
+      for (auto it = gData.begin(); it != gData.end(); ++it)
+      {
+         sats.push_back(it);
+      }
+
+      vector<char> accepted( sats.size(), 1 );
+      pThreadPool->parallelFor( sats.size(),
+         [&](size_t i)
+         {
+            accepted[i] =
+               processSat(time, (*sats[i]).first, (*sats[i]).second->get_value());
+         } );
+
+      for (size_t i = 0; i < sats.size(); ++i)
+      {
+         if( !accepted[i] )
+         {
+            satRejectedSet.insert( (*sats[i]).first );
+         }
+      }
+
+      return satRejectedSet;
+
+   }  // End of method 'ProcessingClass::processSats()'
+
+}  // End of namespace gpstk
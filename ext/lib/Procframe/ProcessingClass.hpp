@@ -46,6 +46,8 @@
 #include "StringUtils.hpp"
 #include "DataStructures.hpp"
 #include "RinexEpoch.h"
+#include "ProcessingThreadPool.hpp"
+#include "ProcessingProfiler.hpp"
 
 
 namespace gpstk
@@ -89,6 +91,12 @@ namespace gpstk
 	   * - getClassName(): This method should return a string identifying the
 	   *   class the object belongs to.
 	   *
+	   * Objects whose work on a satellite doesn't depend on the other
+	   * satellites of the epoch may be declared parallel-safe: they do this
+	   * work in processSat(), called through processSats(), and the
+	   * satellites are then processed concurrently if the object is given
+	   * a ProcessingThreadPool with setThreadPool().
+	   *
 	   */
 
 
@@ -107,6 +115,11 @@ namespace gpstk
 			UsedInPVT = 1
 		};
 
+
+		ProcessingClass()
+			: pThreadPool(NULL)
+		{};
+
 	
 		 /** Abstract method. It returns a RinexEpoch object.
 		  *
@@ -124,22 +137,75 @@ namespace gpstk
 			return rejectedSatsTable;
 		};
 
+		/// Returns true if the satellites of an epoch may be processed
+		/// concurrently, with processSat().
+		virtual bool isParallelSafe() const
+		{
+			return false;
+		};
+
+		/// Sets the threads processing the satellites of an epoch, if the
+		/// object is parallel-safe; NULL (the default) to process them
+		/// serially.
+		virtual ProcessingClass& setThreadPool(ProcessingThreadPool* pool)
+		{
+			pThreadPool = pool;
+			return (*this);
+		};
+
+		/// Returns the threads processing the satellites of an epoch.
+		virtual ProcessingThreadPool* getThreadPool() const
+		{
+			return pThreadPool;
+		};
+
 		/// Destructor
 		virtual ~ProcessingClass() {};
 
 	protected:
 
+		/** Work of a parallel-safe object on satellite 'sat' of the epoch
+		 *  'time', whose data are 'tvMap'.
+		 *
+		 * It may run concurrently for several satellites: it must not
+		 * change the object, whose state for the epoch is set by
+		 * Process() before calling processSats().
+		 *
+		 * @return false if the satellite must be removed.
+		 */
+		virtual bool processSat(const CommonTime& time,
+			const SatID& sat,
+			typeValueMap& tvMap)
+		{
+			return true;
+		};
+
+		/** Calls processSat() for every satellite of 'gData', on the
+		 *  thread pool if the object has one and is parallel-safe.
+		 *
+		 * @return the satellites rejected by processSat(); they are
+		 * not removed from 'gData'.
+		 */
+		SatIDSet processSats(const CommonTime& time, SatTypePtrMap& gData);
+
 		std::map<CommonTime, SatIDSet> rejectedSatsTable;
 
+		ProcessingThreadPool* pThreadPool;
+
 
 	}; // End of class 'ProcessingClass'
 
 
 	/// Input operator from gnssRinex to ProcessingClass.
+	/// With GPSTK_PROFILING, the processing is timed by ProcessingProfiler.
 	inline IRinex& operator>>(IRinex& gData,
 		ProcessingClass& procClass)
 	{
+#ifdef GPSTK_PROFILING
+		return ProcessingProfiler::process(procClass, gData);
+#else
 		procClass.Process(gData); return gData;
+#endif
 	}
 
 	//@}
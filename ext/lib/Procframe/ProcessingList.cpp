@@ -63,7 +63,7 @@ namespace gpstk
          std::list<ProcessingClass*>::const_iterator pos;
          for (pos = proclist.begin(); pos != proclist.end(); ++pos)
          {
-            (*pos)->Process(gData);
+            gData >> (**pos);
          }
 
          return gData;
@@ -0,0 +1,544 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file ProcessingProfiler.cpp
+ * Timers, counters and histograms of the processing objects, compiled in
+ * with GPSTK_PROFILING only.
+ */
+
+#include "ProcessingProfiler.hpp"
+#include "ProcessingClass.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+
+namespace
+{
+      // Memory allocations of this thread, not counting those of the
+      // profiler itself
+   thread_local std::uint64_t allocCount = 0;
+   thread_local bool inProfiler = false;
+
+      // Marks the work of the profiler, whose allocations aren't counted
+   class ProfilerWork
+   {
+   public:
+      ProfilerWork() : prev(inProfiler) { inProfiler = true; }
+      ~ProfilerWork() { inProfiler = prev; }
+   private:
+      bool prev;
+   };
+}
+
+
+#ifdef GPSTK_PROFILING
+
+   // The allocations are counted by the global operator new
+
+void* operator new(std::size_t size)
+{
+   if (!inProfiler)
+      ++allocCount;
+
+   void* p = std::malloc(size > 0 ? size : 1);
+   if (p == NULL)
+      throw std::bad_alloc();
+   return p;
+}
+
+void* operator new[](std::size_t size)
+{ return operator new(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+   try
+   {
+      return operator new(size);
+   }
+   catch (...)
+   {
+      return NULL;
+   }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& nt) noexcept
+{ return operator new(size, nt); }
+
+void operator delete(void* p) noexcept
+{ std::free(p); }
+
+void operator delete[](void* p) noexcept
+{ std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept
+{ std::free(p); }
+
+void operator delete[](void* p, std::size_t) noexcept
+{ std::free(p); }
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{ std::free(p); }
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{ std::free(p); }
+
+#endif
+
+
+namespace gpstk
+{
+
+   namespace
+   {
+      typedef ProcessingProfiler::Site Site;
+
+      const std::chrono::steady_clock::time_point startTime =
+         std::chrono::steady_clock::now();
+
+      struct TraceEvent
+      {
+         const Site* site;
+         std::uint64_t start;
+         std::uint64_t duration;
+      };
+
+         // Trace events of a thread. The events are recorded by their
+         // thread, and cleared or printed by any other, under 'mtx'.
+      struct ThreadTrace
+      {
+         unsigned id;
+         std::mutex mtx;
+         std::vector<TraceEvent> events;
+      };
+
+      struct Registry
+      {
+         Registry() : traceCapacity(0), nextThreadId(1) {}
+
+         std::mutex mtx;
+         std::map<std::string, std::unique_ptr<Site> > sites;
+         std::vector<std::shared_ptr<ThreadTrace> > traces;
+         std::atomic<std::size_t> traceCapacity;
+         unsigned nextThreadId;
+      };
+
+         // Never destroyed: the sites may be used until the end of the
+         // program
+      Registry& registry()
+      {
+         static Registry* r = new Registry;
+         return *r;
+      }
+
+      thread_local std::shared_ptr<ThreadTrace> threadTrace;
+
+         // Histogram bin of a duration
+      int bin(std::uint64_t ns)
+      {
+         if (ns < 1)
+            return 0;
+
+         int i = 1 + (int)std::floor( std::log2((double)ns)
+                                      * ProcessingProfiler::BINS_PER_OCTAVE );
+         return std::min(i, ProcessingProfiler::NUM_BINS - 1);
+      }
+
+      double binUpper(int i)
+      {
+         if (i >= ProcessingProfiler::NUM_BINS - 1)
+            return std::numeric_limits<double>::infinity();
+         return std::exp2((double)i / ProcessingProfiler::BINS_PER_OCTAVE);
+      }
+
+         // 's' as a JSON string
+      std::string jsonString(const std::string& s)
+      {
+         std::string r("\"");
+         for (char c : s)
+         {
+            if (c == '"' || c == '\\')
+               r += '\\';
+            if ((unsigned char)c >= 0x20)
+               r += c;
+         }
+         return r + '"';
+      }
+   }
+
+
+
+   ProcessingProfiler::Site::Site( const std::string& siteName,
+                                   const std::string& siteCategory )
+      : name(siteName), category(siteCategory)
+   {
+      clear();
+   }
+
+
+
+      // Clears the values.
+   void ProcessingProfiler::Site::clear()
+   {
+
+      numCalls = 0;
+      sum = 0;
+      totalTime = 0;
+      maxTime = 0;
+      satsIn = 0;
+      satsRejected = 0;
+      numAllocs = 0;
+      numThrows = 0;
+      for (auto& it : bins)
+      {
+         it = 0;
+      }
+
+   }  // End of method 'ProcessingProfiler::Site::clear()'
+
+
+
+      // Records a call of 'ns' nanoseconds.
+   void ProcessingProfiler::Site::addTime(std::uint64_t ns)
+   {
+
+      ++numCalls;
+      totalTime += ns;
+      ++bins[bin(ns)];
+
+      std::uint64_t m(maxTime);
+      while (ns > m && !maxTime.compare_exchange_weak(m, ns))
+      {
+      }
+
+   }  // End of method 'ProcessingProfiler::Site::addTime()'
+
+
+
+      // Estimate of the duration percentile 'p' (0 to 1), ns.
+   double ProcessingProfiler::Site::percentileNs(double p) const
+   {
+
+      std::uint64_t n(0);
+      for (const auto& it : bins)
+      {
+         n += it;
+      }
+      if (n == 0)
+         return std::numeric_limits<double>::quiet_NaN();
+
+      p = std::min(std::max(p, 0.0), 1.0);
+      std::uint64_t rank =
+         std::max<std::uint64_t>(1, (std::uint64_t)std::ceil(p * n));
+
+      std::uint64_t c(0);
+      int i(0);
+      for (; i < NUM_BINS - 1; ++i)
+      {
+         c += bins[i];
+         if (c >= rank)
+            break;
+      }
+
+         // The bin limit can't be above the longest duration
+      return std::min(binUpper(i), (double)maxTime);
+
+   }  // End of method 'ProcessingProfiler::Site::percentileNs()'
+
+
+
+      /* Returns the site named 'name', created in 'category' if it
+       * doesn't exist.
+       */
+   ProcessingProfiler::Site& ProcessingProfiler::site(
+                                          const std::string& name,
+                                          const std::string& category )
+   {
+
+      ProfilerWork work;
+      Registry& r(registry());
+      std::lock_guard<std::mutex> lock(r.mtx);
+
+      std::unique_ptr<Site>& s(r.sites[name]);
+      if (!s)
+      {
+         s.reset(new Site(name, category));
+      }
+
+      return *s;
+
+   }  // End of method 'ProcessingProfiler::site()'
+
+
+
+      // Returns the site named 'name', or NULL.
+   const ProcessingProfiler::Site* ProcessingProfiler::find(
+                                                   const std::string& name )
+   {
+
+      ProfilerWork work;
+      Registry& r(registry());
+      std::lock_guard<std::mutex> lock(r.mtx);
+
+      auto it = r.sites.find(name);
+      return (it == r.sites.end()) ? NULL : it->second.get();
+
+   }  // End of method 'ProcessingProfiler::find()'
+
+
+
+      // Applies 'pClass' to 'gData', timed in the site of its class.
+   IRinex& ProcessingProfiler::process(ProcessingClass& pClass, IRinex& gData)
+   {
+
+      thread_local std::unordered_map<std::type_index, Site*> classSites;
+
+      Site* pSite;
+      auto it = classSites.find(std::type_index(typeid(pClass)));
+      if (it != classSites.end())
+      {
+         pSite = it->second;
+      }
+      else
+      {
+         ProfilerWork work;
+         pSite = &site(pClass.getClassName(), "ProcessingClass");
+         classSites[std::type_index(typeid(pClass))] = pSite;
+      }
+
+      ScopedTimer timer(*pSite);
+      std::uint64_t numSats(gData.getBody().size());
+      pClass.Process(gData);
+      timer.setSats(numSats, gData.getBody().size());
+
+      return gData;
+
+   }  // End of method 'ProcessingProfiler::process()'
+
+
+
+      // Sets the number of events each thread keeps for the Chrome trace.
+   void ProcessingProfiler::setTraceCapacity(std::size_t eventsPerThread)
+   {
+      registry().traceCapacity = eventsPerThread;
+   }
+
+
+
+      // Clears the values of all the sites, and the trace events.
+   void ProcessingProfiler::reset()
+   {
+
+      ProfilerWork work;
+      Registry& r(registry());
+      std::lock_guard<std::mutex> lock(r.mtx);
+
+      for (auto& it : r.sites)
+      {
+         it.second->clear();
+      }
+      for (auto& it : r.traces)
+      {
+         std::lock_guard<std::mutex> traceLock(it->mtx);
+         it->events.clear();
+      }
+
+   }  // End of method 'ProcessingProfiler::reset()'
+
+
+
+      // Prints the values of all the sites as CSV.
+   void ProcessingProfiler::printCSV(std::ostream& os)
+   {
+
+      ProfilerWork work;
+      Registry& r(registry());
+      std::lock_guard<std::mutex> lock(r.mtx);
+
+         // The longest first
+      std::vector<const Site*> sites;
+      for (const auto& it : r.sites)
+      {
+         sites.push_back(it.second.get());
+      }
+      std::stable_sort( sites.begin(), sites.end(),
+                        [](const Site* a, const Site* b)
+                        { return a->totalNs() > b->totalNs(); } );
+
+      os << "name,category,calls,value,total_ms,mean_us,p50_us,p90_us,"
+         << "p99_us,max_us,satellites,rejected,allocations,throws"
+         << std::endl;
+
+      for (const Site* s : sites)
+      {
+         double n(s->calls());
+         os << s->getName() << ',' << s->getCategory() << ','
+            << s->calls() << ',' << s->value() << ','
+            << s->totalNs() * 1e-6 << ','
+            << (n > 0 ? s->totalNs() * 1e-3 / n : 0.0) << ','
+            << s->percentileNs(0.5) * 1e-3 << ','
+            << s->percentileNs(0.9) * 1e-3 << ','
+            << s->percentileNs(0.99) * 1e-3 << ','
+            << s->maxNs() * 1e-3 << ','
+            << s->satellites() << ',' << s->rejected() << ','
+            << s->allocations() << ',' << s->throws() << std::endl;
+      }
+
+   }  // End of method 'ProcessingProfiler::printCSV()'
+
+
+
+      // Prints the trace events in the Chrome trace event format.
+   void ProcessingProfiler::printChromeTrace(std::ostream& os)
+   {
+
+      ProfilerWork work;
+      Registry& r(registry());
+      std::lock_guard<std::mutex> lock(r.mtx);
+
+      std::streamsize prec = os.precision(3);
+      std::ios::fmtflags flags = os.setf(std::ios::fixed);
+
+      os << "{\"traceEvents\":[";
+      const char* sep = "\n";
+      std::vector<TraceEvent> events;
+      for (const auto& trace : r.traces)
+      {
+            // Copied, so that the thread isn't held while printing
+         {
+            std::lock_guard<std::mutex> traceLock(trace->mtx);
+            events = trace->events;
+         }
+
+         for (const TraceEvent& e : events)
+         {
+            os << sep << "{\"name\":" << jsonString(e.site->getName())
+               << ",\"cat\":" << jsonString(e.site->getCategory())
+               << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << trace->id
+               << ",\"ts\":" << e.start * 1e-3
+               << ",\"dur\":" << e.duration * 1e-3 << '}';
+            sep = ",\n";
+         }
+      }
+      os << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+
+      os.precision(prec);
+      os.flags(flags);
+
+   }  // End of method 'ProcessingProfiler::printChromeTrace()'
+
+
+
+      // Nanoseconds since the start of the program.
+   std::uint64_t ProcessingProfiler::now()
+   {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now() - startTime ).count();
+   }
+
+
+
+      // Number of memory allocations made by this thread.
+   std::uint64_t ProcessingProfiler::threadAllocations()
+   {
+      return allocCount;
+   }
+
+
+
+      // Records a trace event of 'site', if there is room left.
+   void ProcessingProfiler::recordEvent( const Site& site,
+                                         std::uint64_t start,
+                                         std::uint64_t duration )
+   {
+
+      Registry& r(registry());
+      std::size_t capacity(r.traceCapacity);
+      if (capacity == 0)
+         return;
+
+      ProfilerWork work;
+      if (!threadTrace)
+      {
+         threadTrace = std::make_shared<ThreadTrace>();
+         std::lock_guard<std::mutex> lock(r.mtx);
+         threadTrace->id = r.nextThreadId++;
+         r.traces.push_back(threadTrace);
+      }
+
+      std::lock_guard<std::mutex> lock(threadTrace->mtx);
+      if (threadTrace->events.size() < capacity)
+      {
+         TraceEvent e = { &site, start, duration };
+         threadTrace->events.push_back(e);
+      }
+
+   }  // End of method 'ProcessingProfiler::recordEvent()'
+
+
+
+   ScopedTimer::~ScopedTimer()
+   {
+
+      std::uint64_t end(ProcessingProfiler::now());
+      std::uint64_t numAllocs(ProcessingProfiler::threadAllocations() - allocs);
+
+      site.addTime(end - start);
+      if (satsIn > 0)
+         site.addSats(satsIn, satsOut);
+      if (numAllocs > 0)
+         site.addAllocations(numAllocs);
+      if (std::uncaught_exception())
+         site.addThrow();
+
+      ProcessingProfiler::recordEvent(site, start, end - start);
+
+   }  // End of destructor 'ScopedTimer::~ScopedTimer()'
+
+
+}  // End of namespace gpstk
@@ -0,0 +1,332 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file ProcessingProfiler.hpp
+ * Timers, counters and histograms of the processing objects, compiled in
+ * with GPSTK_PROFILING only.
+ */
+
+#ifndef GPSTK_PROCESSINGPROFILER_HPP
+#define GPSTK_PROCESSINGPROFILER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+
+namespace gpstk
+{
+
+   class IRinex;
+   class ProcessingClass;
+
+
+      /// @ingroup GPSsolutions
+      //@{
+
+      /** Timers, counters and histograms of the processing objects.
+       *
+       * When the toolkit is built with GPSTK_PROFILING defined (CMake
+       * option PROFILING_SWITCH):
+       *
+       * - every 'gData >> object' (and so every object of a
+       *   ProcessingList or PipelinedProcessingList) is timed, with the
+       *   satellites it gets and rejects, the memory allocations made
+       *   and the exceptions thrown; the objects of a same class are
+       *   aggregated under their class name;
+       * - GPSTK_PROFILE_SCOPE(name) times the rest of its block, e.g.
+       *   a step of a solver;
+       * - GPSTK_PROFILE_COUNT(name, n) adds 'n' to a counter.
+       *
+       * Otherwise the hook and the macros are empty, and nothing is
+       * recorded.
+       *
+       * @code
+       *   ProcessingProfiler::setTraceCapacity(100000);
+       *
+       *   while(rin >> gRin)
+       *   {
+       *      GPSTK_PROFILE_COUNT("epochs read", 1);
+       *      gRin >> basic >> computeTropo >> pppSolver;
+       *   }
+       *
+       *   std::ofstream csv("profile.csv"), trace("trace.json");
+       *   ProcessingProfiler::printCSV(csv);
+       *   ProcessingProfiler::printChromeTrace(trace);
+       * @endcode
+       *
+       * The durations are kept in histograms with four bins per octave,
+       * from which the percentiles are estimated. The timers are
+       * inclusive: a ProcessingList includes its objects.
+       *
+       * The values may be recorded from any thread. With a trace
+       * capacity set, each thread also keeps up to that many events for
+       * the Chrome trace (chrome://tracing, Perfetto). The values and
+       * the trace may be printed or reset while the processing runs.
+       */
+   class ProcessingProfiler
+   {
+   public:
+
+         /// Number of bins of the duration histograms.
+      static const int NUM_BINS = 160;
+
+         /// Bins per octave of the duration histograms.
+      static const int BINS_PER_OCTAVE = 4;
+
+
+         /// Values recorded at one place: a timer or a counter.
+      class Site
+      {
+      public:
+
+         Site(const std::string& siteName, const std::string& siteCategory);
+
+            /// Records a call of 'ns' nanoseconds.
+         void addTime(std::uint64_t ns);
+
+            /// Adds 'n' to the value of a counter.
+         void add(std::uint64_t n)
+         { ++numCalls; sum += n; };
+
+            /// Records the satellites of a call.
+         void addSats(std::uint64_t in, std::uint64_t out)
+         {
+            satsIn += in;
+            if (out < in)
+               satsRejected += in - out;
+         };
+
+         void addAllocations(std::uint64_t n)
+         { numAllocs += n; };
+
+         void addThrow()
+         { ++numThrows; };
+
+            /// Clears the values.
+         void clear();
+
+         const std::string& getName() const
+         { return name; };
+
+         const std::string& getCategory() const
+         { return category; };
+
+            /// Number of calls, or of additions to a counter.
+         std::uint64_t calls() const
+         { return numCalls; };
+
+            /// Value of a counter.
+         std::uint64_t value() const
+         { return sum; };
+
+            /// Total and longest duration, ns.
+         std::uint64_t totalNs() const
+         { return totalTime; };
+
+         std::uint64_t maxNs() const
+         { return maxTime; };
+
+            /// Estimate of the duration percentile 'p' (0 to 1), ns.
+         double percentileNs(double p) const;
+
+         std::uint64_t satellites() const
+         { return satsIn; };
+
+         std::uint64_t rejected() const
+         { return satsRejected; };
+
+         std::uint64_t allocations() const
+         { return numAllocs; };
+
+         std::uint64_t throws() const
+         { return numThrows; };
+
+      private:
+
+         Site(const Site&);
+         Site& operator=(const Site&);
+
+         std::string name;
+         std::string category;
+
+         std::atomic<std::uint64_t> numCalls;
+         std::atomic<std::uint64_t> sum;
+         std::atomic<std::uint64_t> totalTime;
+         std::atomic<std::uint64_t> maxTime;
+         std::atomic<std::uint64_t> satsIn;
+         std::atomic<std::uint64_t> satsRejected;
+         std::atomic<std::uint64_t> numAllocs;
+         std::atomic<std::uint64_t> numThrows;
+         std::atomic<std::uint64_t> bins[NUM_BINS];
+      };
+
+
+         /// True if the toolkit is built with GPSTK_PROFILING.
+      static bool isCompiledIn()
+      {
+#ifdef GPSTK_PROFILING
+         return true;
+#else
+         return false;
+#endif
+      };
+
+
+         /** Returns the site named 'name', created in 'category' if it
+          *  doesn't exist. The sites live until the end of the program.
+          */
+      static Site& site( const std::string& name,
+                         const std::string& category );
+
+
+         /// Returns the site named 'name', or NULL.
+      static const Site* find(const std::string& name);
+
+
+         /// Applies 'pClass' to 'gData', timed in the site of its class.
+      static IRinex& process(ProcessingClass& pClass, IRinex& gData);
+
+
+         /** Sets the number of events each thread keeps for the Chrome
+          *  trace; 0 (the default) for none.
+          */
+      static void setTraceCapacity(std::size_t eventsPerThread);
+
+
+         /// Clears the values of all the sites, and the trace events.
+      static void reset();
+
+
+         /// Prints the values of all the sites as CSV.
+      static void printCSV(std::ostream& os);
+
+
+         /// Prints the trace events in the Chrome trace event format.
+      static void printChromeTrace(std::ostream& os);
+
+
+         /// Nanoseconds since the start of the program.
+      static std::uint64_t now();
+
+
+         /** Number of memory allocations made by this thread; always 0
+          *  without GPSTK_PROFILING.
+          */
+      static std::uint64_t threadAllocations();
+
+
+         /// Records a trace event of 'site', if there is room left.
+      static void recordEvent( const Site& site,
+                               std::uint64_t start,
+                               std::uint64_t duration );
+
+   }; // End of class 'ProcessingProfiler'
+
+
+
+      /** Times its scope in a ProcessingProfiler site, with the memory
+       *  allocations made meanwhile and the exceptions leaving it.
+       */
+   class ScopedTimer
+   {
+   public:
+
+      explicit ScopedTimer(ProcessingProfiler::Site& s)
+         : site(s), satsIn(0), satsOut(0),
+           allocs(ProcessingProfiler::threadAllocations()),
+           start(ProcessingProfiler::now())
+      { };
+
+
+         /// Records the satellites got and kept in the scope.
+      void setSats(std::uint64_t in, std::uint64_t out)
+      { satsIn = in; satsOut = out; };
+
+
+      ~ScopedTimer();
+
+
+   private:
+
+      ScopedTimer(const ScopedTimer&);
+      ScopedTimer& operator=(const ScopedTimer&);
+
+      ProcessingProfiler::Site& site;
+      std::uint64_t satsIn;
+      std::uint64_t satsOut;
+      std::uint64_t allocs;
+      std::uint64_t start;
+
+   }; // End of class 'ScopedTimer'
+
+      //@}
+
+}  // End of namespace gpstk
+
+
+#define GPSTK_PROFILE_CAT2(a, b) a##b
+#define GPSTK_PROFILE_CAT(a, b) GPSTK_PROFILE_CAT2(a, b)
+
+#ifdef GPSTK_PROFILING
+
+   /// Times the rest of the block in the site 'name'.
+#define GPSTK_PROFILE_SCOPE(name)                                           \
+   static gpstk::ProcessingProfiler::Site&                                  \
+      GPSTK_PROFILE_CAT(gpstkProfileSite, __LINE__) =                       \
+         gpstk::ProcessingProfiler::site(name, "scope");                    \
+   gpstk::ScopedTimer GPSTK_PROFILE_CAT(gpstkProfileTimer, __LINE__)        \
+      (GPSTK_PROFILE_CAT(gpstkProfileSite, __LINE__))
+
+   /// Adds 'n' to the counter 'name'.
+#define GPSTK_PROFILE_COUNT(name, n)                                        \
+   do                                                                       \
+   {                                                                        \
+      static gpstk::ProcessingProfiler::Site& gpstkProfileCounter =         \
+         gpstk::ProcessingProfiler::site(name, "counter");                  \
+      gpstkProfileCounter.add(n);                                           \
+   } while (0)
+
+#else
+
+#define GPSTK_PROFILE_SCOPE(name) do {} while (0)
+#define GPSTK_PROFILE_COUNT(name, n) do {} while (0)
+
+#endif
+
+#endif   // GPSTK_PROCESSINGPROFILER_HPP
@@ -0,0 +1,222 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/**
+ * @file ProcessingThreadPool.cpp
+ * Pool of threads running the per-satellite work of the processing
+ * objects declared parallel-safe.
+ */
+
+#include "ProcessingThreadPool.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+
+      // Starts the workers.
+   ProcessingThreadPool::ProcessingThreadPool(unsigned numThreads)
+      : pFunc(NULL), numIndexes(0), nextIndex(0), generation(0),
+        numBusy(0), accepting(false), running(false), stopping(false)
+   {
+
+      if (numThreads == 0)
+      {
+         numThreads = thread::hardware_concurrency();
+      }
+
+         // The calling thread takes part in the loops
+      for (unsigned i = 1; i < numThreads; ++i)
+      {
+         workers.push_back( thread(&ProcessingThreadPool::run, this) );
+      }
+
+   }  // End of constructor 'ProcessingThreadPool::ProcessingThreadPool()'
+
+
+      // Stops the workers.
+   ProcessingThreadPool::~ProcessingThreadPool()
+   {
+
+      {
+         lock_guard<mutex> lock(mtx);
+         stopping = true;
+      }
+      startCond.notify_all();
+
+      for (auto& it : workers)
+      {
+         it.join();
+      }
+
+   }  // End of destructor 'ProcessingThreadPool::~ProcessingThreadPool()'
+
+
+      /* Calls 'func' for every index from 0 to 'n'-1, on the threads of
+       * the pool, and returns when all the calls are done.
+       *
+       * @param n       Number of indexes.
+       * @param func    Function called with each index.
+       */
+   void ProcessingThreadPool::parallelFor( size_t n,
+                                           const function<void(size_t)>& func )
+   {
+
+         // Run serially if there is nothing to share, or if the pool is
+         // already running a loop
+      bool expected(false);
+      if( n < 2 || workers.empty() ||
+          !running.compare_exchange_strong(expected, true) )
+      {
+         for (size_t i = 0; i < n; ++i)
+         {
+            func(i);
+         }
+
+         return;
+      }
+
+      {
+         lock_guard<mutex> lock(mtx);
+         pFunc = &func;
+         numIndexes = n;
+         nextIndex = 0;
+         numBusy = 0;
+         accepting = true;
+         ++generation;
+      }
+      startCond.notify_all();
+
+      exception_ptr e( work() );
+
+         // All the indexes are taken: the workers not started yet are not
+         // waited for
+      unique_lock<mutex> lock(mtx);
+      accepting = false;
+      doneCond.wait(lock, [this] { return (numBusy == 0); });
+
+      if (!e)
+      {
+         e = error;
+      }
+      error = nullptr;
+      pFunc = NULL;
+      lock.unlock();
+
+      running = false;
+
+      if (e)
+      {
+         rethrow_exception(e);
+      }
+
+   }  // End of method 'ProcessingThreadPool::parallelFor()'
+
+
+      // Calls 'func' for the indexes left; returns the first exception.
+   exception_ptr ProcessingThreadPool::work()
+   {
+
+      exception_ptr e;
+
+      for (;;)
+      {
+         size_t i( nextIndex.fetch_add(1) );
+         if (i >= numIndexes)
+         {
+            break;
+         }
+
+         try
+         {
+            (*pFunc)(i);
+         }
+         catch(...)
+         {
+            if (!e)
+            {
+               e = current_exception();
+            }
+         }
+      }
+
+      return e;
+
+   }  // End of method 'ProcessingThreadPool::work()'
+
+
+      // Work of the workers.
+   void ProcessingThreadPool::run()
+   {
+
+      unsigned long seen(0);
+
+      unique_lock<mutex> lock(mtx);
+      for (;;)
+      {
+         startCond.wait( lock,
+                         [&] { return (stopping || generation != seen); } );
+         if (stopping)
+         {
+            break;
+         }
+
+         seen = generation;
+         if (!accepting)
+         {
+            continue;
+         }
+
+         ++numBusy;
+         lock.unlock();
+
+         exception_ptr e( work() );
+
+         lock.lock();
+         if (e && !error)
+         {
+            error = e;
+         }
+         if (--numBusy == 0)
+         {
+            doneCond.notify_all();
+         }
+      }
+
+   }  // End of method 'ProcessingThreadPool::run()'
+
+}  // End of namespace gpstk
@@ -0,0 +1,162 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/**
+ * @file ProcessingThreadPool.hpp
+ * Pool of threads running the per-satellite work of the processing
+ * objects declared parallel-safe.
+ */
+
+#ifndef GPSTK_PROCESSINGTHREADPOOL_HPP
+#define GPSTK_PROCESSINGTHREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace gpstk
+{
+
+      /// @ingroup GPSsolutions 
+      //@{
+
+      /** Pool of threads running the per-satellite work of the processing
+       *  objects declared parallel-safe (see
+       *  ProcessingClass::isParallelSafe()).
+       *
+       * One pool is meant to be shared by all the objects of a processing
+       * chain: the objects run one after the other, so the threads are
+       * never idle waiting for another object.
+       *
+       * @code
+       *   ProcessingThreadPool pool(4);
+       *   BasicModel model(nominalPos, sp3Eph);
+       *   model.setThreadPool(&pool);
+       *   ComputeTropModel computeTropo(neillModel);
+       *   computeTropo.setThreadPool(&pool);
+       *
+       *   while(rin >> gRin)
+       *   {
+       *      gRin >> model >> computeTropo;
+       *   }
+       * @endcode
+       *
+       * The calling thread takes part in the loops, so a pool of N threads
+       * starts N-1 workers. A loop started while another one runs, from
+       * another thread or from within the loop, is run serially by its
+       * calling thread.
+       */
+   class ProcessingThreadPool
+   {
+   public:
+
+         /** Starts the workers.
+          *
+          * @param numThreads    Number of threads running the loops,
+          *                      including the calling thread; 0 for one
+          *                      per hardware thread.
+          */
+      explicit ProcessingThreadPool(unsigned numThreads = 0);
+
+
+         /// Stops the workers.
+      ~ProcessingThreadPool();
+
+
+         /// Returns the number of threads running the loops.
+      unsigned getNumThreads() const
+      { return (workers.size() + 1); };
+
+
+         /** Calls 'func' for every index from 0 to 'n'-1, on the threads of
+          *  the pool, and returns when all the calls are done.
+          *
+          * If some of the calls throw, the first exception is rethrown
+          * here once all the calls are done.
+          *
+          * @param n       Number of indexes.
+          * @param func    Function called with each index.
+          */
+      void parallelFor( size_t n,
+                        const std::function<void(size_t)>& func );
+
+
+   private:
+
+      ProcessingThreadPool(const ProcessingThreadPool&);
+      ProcessingThreadPool& operator=(const ProcessingThreadPool&);
+
+         /// Work of the workers.
+      void run();
+
+         /// Calls 'func' for the indexes left; returns the first exception.
+      std::exception_ptr work();
+
+      std::vector<std::thread> workers;
+
+         /// Protects the state of the loop below.
+      std::mutex mtx;
+      std::condition_variable startCond, doneCond;
+
+         /// Current loop, started at each new generation; the workers
+         /// join it while it is accepting them.
+      const std::function<void(size_t)>* pFunc;
+      size_t numIndexes;
+      std::atomic<size_t> nextIndex;
+      unsigned long generation;
+      unsigned numBusy;
+      bool accepting;
+      std::exception_ptr error;
+
+         /// True while a loop runs
+      std::atomic<bool> running;
+
+      bool stopping;
+
+
+   }; // End of class 'ProcessingThreadPool'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_PROCESSINGTHREADPOOL_HPP
@@ -59,7 +59,7 @@ namespace gpstk
       try
       {
          for (auto && it :procvector)
-            it->Process(gData);
+            gData >> (*it);
 
 		 return gData;
       }
@@ -79,6 +79,12 @@ namespace gpstk
             return rinex.header;
         }
 
+		//whole data of the epoch, including satellites removed from the body only
+		const gnssRinex& getRinex() const
+		{
+			return rinex;
+		}
+
 		std::istream& read(std::istream& i);
 
 
@@ -0,0 +1,377 @@
+#include "RinexEpochLog.h"
+
+#include<cstring>
+
+#ifdef _WIN32
+#define EPOCHLOG_FSEEK _fseeki64
+#else
+#define EPOCHLOG_FSEEK fseeko
+#endif
+
+using namespace std;
+
+namespace gpstk
+{
+	namespace
+	{
+		template<typename T>
+		void put(vector<char>& buf, T value)
+		{
+			size_t pos = buf.size();
+			buf.resize(pos + sizeof(T));
+			memcpy(&buf[pos], &value, sizeof(T));
+		}
+
+		void putString(vector<char>& buf, const string& s)
+		{
+			put<uint32_t>(buf, s.size());
+			buf.insert(buf.end(), s.begin(), s.end());
+		}
+
+		// sequential reader of a record
+		class Cursor
+		{
+		public:
+			Cursor(const vector<char>& buf)
+				:pos(buf.data()), end(buf.data() + buf.size())
+			{}
+
+			template<typename T>
+			T get()
+			{
+				T value;
+				memcpy(&value, next(sizeof(T)), sizeof(T));
+				return value;
+			}
+
+			string getString()
+			{
+				size_t n = get<uint32_t>();
+				const char* p = next(n);
+				return string(p, n);
+			}
+
+			const char* next(size_t count)
+			{
+				if (size_t(end - pos) < count)
+				{
+					Exception e("RinexEpochLog: corrupted record");
+					GPSTK_THROW(e);
+				}
+				const char* p = pos;
+				pos += count;
+				return p;
+			}
+
+		private:
+			const char* pos;
+			const char* end;
+		};
+
+		void fileWrite(FILE* f, size_t offset, const char* src, size_t count)
+		{
+			if (EPOCHLOG_FSEEK(f, offset, SEEK_SET) != 0 ||
+				fwrite(src, 1, count, f) != count)
+			{
+				Exception e("RinexEpochLog: can't write temporary file");
+				GPSTK_THROW(e);
+			}
+		}
+
+		void fileRead(FILE* f, size_t offset, char* dst, size_t count)
+		{
+			if (EPOCHLOG_FSEEK(f, offset, SEEK_SET) != 0 ||
+				fread(dst, 1, count, f) != count)
+			{
+				Exception e("RinexEpochLog: can't read temporary file");
+				GPSTK_THROW(e);
+			}
+		}
+	}
+
+	RinexEpochLog::
+		RinexEpochLog()
+		:file(nullptr), length(0), used(0)
+	{}
+
+	RinexEpochLog::
+		~RinexEpochLog()
+	{
+		if (file)
+			fclose(file);
+	}
+
+	RinexEpochLog& RinexEpochLog::
+		setSpillToDisk(bool spill)
+	{
+		if (spill == getSpillToDisk())
+			return *this;
+
+		FILE* target(nullptr);
+		if (spill)
+		{
+			target = tmpfile();
+			if (!target)
+			{
+				Exception e("RinexEpochLog: can't create temporary file");
+				GPSTK_THROW(e);
+			}
+		}
+		moveTo(target);
+
+		return *this;
+	}
+
+	void RinexEpochLog::
+		push_back(const IRinex& gRin)
+	{
+		encode(dynamic_cast<const RinexEpoch&>(gRin));
+
+		Slot slot{ length, buffer.size(), buffer.size() };
+		store(slot.offset, buffer.data(), slot.size);
+		slots.push_back(slot);
+		length += slot.size;
+		used += slot.size;
+	}
+
+	void RinexEpochLog::
+		write(size_t i, const IRinex& gRin)
+	{
+		Slot& slot = slots.at(i);
+		encode(dynamic_cast<const RinexEpoch&>(gRin));
+
+		used -= slot.size;
+		slot.size = buffer.size();
+		used += slot.size;
+
+		// keep the record in place if it fits, otherwise move it to the end
+		if (slot.size > slot.capacity)
+		{
+			slot.offset = length;
+			slot.capacity = slot.size;
+			length += slot.size;
+		}
+		store(slot.offset, buffer.data(), slot.size);
+
+		if (length - used > used)
+			compact();
+	}
+
+	void RinexEpochLog::
+		read(size_t i, IRinex& gRin) const
+	{
+		const Slot& slot = slots.at(i);
+		buffer.resize(slot.size);
+		load(slot.offset, buffer.data(), slot.size);
+
+		gnssRinex g;
+		SatIDSet removed;
+		decode(g, removed);
+		gRin = RinexEpoch(g);
+		gRin.getBody().removeSatID(removed);
+	}
+
+	void RinexEpochLog::
+		clear()
+	{
+		slots.clear();
+		data.clear();
+		length = 0;
+		used = 0;
+		if (file)
+			rewind(file);
+	}
+
+	// Record layout (native byte order):
+	//   int32 day, int32 sod, double fsod, int32 time system
+	//   int32 source type, string source name, string antenna type,
+	//   3 x double antenna position, int16 epoch flag
+	//   uint32 number of satellites, then int16 id and int8 system per satellite
+	//   bitmap of the satellites in the body (one bit per satellite)
+	//   uint32 number of types, then per type:
+	//     int32 type, bitmap of the satellites having it (one bit per
+	//     satellite, in the order above), double values of these satellites
+	// Strings are stored as uint32 length and characters.
+	void RinexEpochLog::
+		encode(const RinexEpoch& gRin)
+	{
+		buffer.clear();
+
+		const sourceEpochRinexHeader& header = gRin.getHeader();
+		long day, sod;
+		double fsod;
+		TimeSystem ts;
+		header.epoch.get(day, sod, fsod, ts);
+		put<int32_t>(buffer, day);
+		put<int32_t>(buffer, sod);
+		put<double>(buffer, fsod);
+		put<int32_t>(buffer, ts.getTimeSystem());
+
+		put<int32_t>(buffer, header.source.type);
+		putString(buffer, header.source.sourceName);
+		putString(buffer, header.antennaType);
+		for (int k = 0; k < 3; k++)
+			put<double>(buffer, header.antennaPosition[k]);
+		put<int16_t>(buffer, header.epochFlag);
+
+		const satTypeValueMap& body = gRin.getRinex().body;
+		put<uint32_t>(buffer, body.size());
+		std::map<TypeID, size_t> types;
+		for (auto&& it : body)
+		{
+			put<int16_t>(buffer, it.first.id);
+			put<int8_t>(buffer, it.first.system);
+			for (auto&& tv : it.second)
+				types[tv.first]++;
+		}
+
+		size_t bitmapSize = (body.size() + 7) / 8;
+		size_t inBody = buffer.size();
+		buffer.resize(inBody + bitmapSize, 0);
+		size_t k(0);
+		for (auto&& it : body)
+		{
+			if (gRin.getBody().count(it.first))
+				buffer[inBody + k / 8] |= char(1 << (k % 8));
+			k++;
+		}
+
+		put<uint32_t>(buffer, types.size());
+		for (auto&& type : types)
+		{
+			put<int32_t>(buffer, type.first.type);
+
+			size_t bitmap = buffer.size();
+			buffer.resize(bitmap + bitmapSize, 0);
+			size_t values = buffer.size();
+			buffer.resize(values + type.second * sizeof(double));
+
+			k = 0;
+			for (auto&& it : body)
+			{
+				const typeValueMap& tvm = it.second;
+				auto itv = tvm.find(type.first);
+				if (itv != tvm.end())
+				{
+					buffer[bitmap + k / 8] |= char(1 << (k % 8));
+					memcpy(&buffer[values], &itv->second, sizeof(double));
+					values += sizeof(double);
+				}
+				k++;
+			}
+		}
+	}
+
+	void RinexEpochLog::
+		decode(gnssRinex& gRin, SatIDSet& removed) const
+	{
+		Cursor c(buffer);
+
+		sourceEpochRinexHeader& header = gRin.header;
+		long day = c.get<int32_t>();
+		long sod = c.get<int32_t>();
+		double fsod = c.get<double>();
+		TimeSystem ts(TimeSystem::Systems(c.get<int32_t>()));
+		header.epoch.set(day, sod, fsod, ts);
+
+		header.source.type = SourceID::SourceType(c.get<int32_t>());
+		header.source.sourceName = c.getString();
+		header.antennaType = c.getString();
+		for (int k = 0; k < 3; k++)
+			header.antennaPosition[k] = c.get<double>();
+		header.epochFlag = c.get<int16_t>();
+
+		size_t nSat = c.get<uint32_t>();
+		std::vector<SatID> sv(nSat);
+		std::vector<typeValueMap*> sats(nSat);
+		for (size_t k = 0; k < nSat; k++)
+		{
+			int id = c.get<int16_t>();
+			int system = c.get<int8_t>();
+			sv[k] = SatID(id, SatID::SatelliteSystem(system));
+			sats[k] = &gRin.body[sv[k]];
+		}
+
+		size_t bitmapSize = (nSat + 7) / 8;
+		const char* inBody = c.next(bitmapSize);
+
+		size_t nType = c.get<uint32_t>();
+		for (size_t t = 0; t < nType; t++)
+		{
+			TypeID type(TypeID::ValueType(c.get<int32_t>()));
+			const char* bitmap = c.next(bitmapSize);
+			for (size_t k = 0; k < nSat; k++)
+				if (bitmap[k / 8] & (1 << (k % 8)))
+					(*sats[k])[type] = c.get<double>();
+		}
+
+		removed.clear();
+		for (size_t k = 0; k < nSat; k++)
+			if (!(inBody[k / 8] & (1 << (k % 8))))
+				removed.insert(sv[k]);
+	}
+
+	void RinexEpochLog::
+		store(size_t offset, const char* src, size_t count)
+	{
+		if (file)
+			fileWrite(file, offset, src, count);
+		else
+		{
+			if (data.size() < offset + count)
+				data.resize(offset + count);
+			std::copy(src, src + count, data.begin() + offset);
+		}
+	}
+
+	void RinexEpochLog::
+		load(size_t offset, char* dst, size_t count) const
+	{
+		if (file)
+			fileRead(file, offset, dst, count);
+		else
+			std::copy(data.begin() + offset, data.begin() + offset + count, dst);
+	}
+
+	void RinexEpochLog::
+		compact()
+	{
+		FILE* target(nullptr);
+		if (file)
+		{
+			target = tmpfile();
+			if (!target)
+			{
+				Exception e("RinexEpochLog: can't create temporary file");
+				GPSTK_THROW(e);
+			}
+		}
+		moveTo(target);
+	}
+
+	void RinexEpochLog::
+		moveTo(FILE* target)
+	{
+		// copy the records, in epoch order, one after another
+		vector<char> newData;
+		size_t offset(0);
+		for (auto& slot : slots)
+		{
+			buffer.resize(slot.size);
+			load(slot.offset, buffer.data(), slot.size);
+			if (target)
+				fileWrite(target, offset, buffer.data(), slot.size);
+			else
+				newData.insert(newData.end(), buffer.begin(), buffer.end());
+			slot.offset = offset;
+			slot.capacity = slot.size;
+			offset += slot.size;
+		}
+
+		if (file)
+			fclose(file);
+		file = target;
+		data.swap(newData);
+		length = offset;
+	}
+}
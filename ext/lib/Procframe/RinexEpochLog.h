@@ -0,0 +1,118 @@
+#pragma once
+#include"RinexEpoch.h"
+
+#include<cstdio>
+#include<vector>
+
+namespace gpstk
+{
+    /// Compact store of the epochs of a forward-backward solver.
+    ///
+    /// Every epoch is serialized into one binary record: the header fields,
+    /// the list of satellites and, type by type, a bitmap of the satellites
+    /// having that type followed by the values of these satellites. This is
+    /// a few times smaller than a cloned RinexEpoch, which keeps a map node
+    /// per satellite and per type. The records are kept in memory or, for
+    /// long arcs, in a temporary file, so that the backward and repeated
+    /// passes read them one by one.
+    ///
+    /// The epochs must be RinexEpoch objects. As with RinexEpoch::clone(),
+    /// the whole epoch is stored, including satellites removed only from
+    /// its body; these are removed again from the body of the epoch read.
+    ///
+    /// A record may be replaced after reprocessing; a record that doesn't
+    /// fit in its old place is moved to the end of the log, and the log is
+    /// compacted once the unused space exceeds the used one.
+    class RinexEpochLog
+    {
+    public:
+
+        RinexEpochLog();
+
+        virtual ~RinexEpochLog();
+
+        RinexEpochLog(const RinexEpochLog&) = delete;
+        RinexEpochLog& operator=(const RinexEpochLog&) = delete;
+
+        /// Keep the records in a temporary file instead of memory.
+        /// The records stored so far are kept.
+        RinexEpochLog& setSpillToDisk(bool spill);
+
+        bool getSpillToDisk() const
+        {
+            return file != nullptr;
+        }
+
+        /// Number of epochs stored.
+        size_t size() const
+        {
+            return slots.size();
+        }
+
+        bool empty() const
+        {
+            return slots.empty();
+        }
+
+        /// Size of the stored records, in bytes.
+        size_t getUsedBytes() const
+        {
+            return used;
+        }
+
+        /// Append an epoch.
+        void push_back(const IRinex& gRin);
+
+        /// Replace epoch 'i'.
+        void write(size_t i, const IRinex& gRin);
+
+        /// Restore epoch 'i' into 'gRin'.
+        void read(size_t i, IRinex& gRin) const;
+
+        /// Remove all epochs.
+        void clear();
+
+    private:
+
+        struct Slot
+        {
+            size_t offset;
+            size_t size;
+            size_t capacity;
+        };
+
+        /// serialize 'gRin' into 'buffer'
+        void encode(const RinexEpoch& gRin);
+
+        /// deserialize 'buffer' into 'gRin'; 'removed' gets the
+        /// satellites not in the body of the epoch
+        void decode(gnssRinex& gRin, SatIDSet& removed) const;
+
+        /// write/read 'count' bytes at 'offset' of the log
+        void store(size_t offset, const char* src, size_t count);
+        void load(size_t offset, char* dst, size_t count) const;
+
+        /// drop the unused space of the log
+        void compact();
+
+        /// copy the records to 'target', or to memory if it is null,
+        /// and make it the storage of the log
+        void moveTo(std::FILE* target);
+
+        /// start, size and room of every record, in bytes
+        std::vector<Slot> slots;
+
+        /// in-memory log, used if there is no temporary file
+        std::vector<char> data;
+
+        /// log file, if the records are spilled to disk
+        std::FILE* file;
+
+        /// log length and bytes used by the records
+        size_t length;
+        size_t used;
+
+        /// record being encoded or decoded
+        mutable std::vector<char> buffer;
+    };
+}
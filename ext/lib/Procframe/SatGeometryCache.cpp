@@ -0,0 +1,238 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/**
+ * @file SatGeometryCache.cpp
+ * This class computes the satellite geometry of an epoch once, for the
+ * modeling objects processing that epoch.
+ */
+
+#include "SatGeometryCache.hpp"
+#include "SunPosition.hpp"
+#include "MoonPosition.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+
+      // Returns a string identifying this object.
+   std::string SatGeometryCache::getClassName() const
+   { return "SatGeometryCache"; }
+
+
+      // Default constructor.
+   SatGeometryCache::SatGeometryCache()
+      : rxPos(0.0, 0.0, 0.0), pEphemeris(NULL),
+        defaultObservable(TypeID::C1),
+        epoch(CommonTime::BEGINNING_OF_TIME),
+        hasSun(false), hasMoon(false), numComputed(0)
+   {}
+
+
+      /* Common constructor.
+       *
+       * @param rxCoordinates Receiver position.
+       * @param ephemeris     Ephemeris to be used.
+       * @param observable    Observable used for the transmission time.
+       */
+   SatGeometryCache::SatGeometryCache( const Position& rxCoordinates,
+                                       XvtStore<SatID>& ephemeris,
+                                       const TypeID& observable )
+      : rxPos(rxCoordinates), pEphemeris(&ephemeris),
+        defaultObservable(observable),
+        epoch(CommonTime::BEGINNING_OF_TIME),
+        hasSun(false), hasMoon(false), numComputed(0)
+   {}
+
+
+      // Discards the geometry cached.
+   void SatGeometryCache::clear()
+   {
+      epoch = CommonTime::BEGINNING_OF_TIME;
+      satGeometry.clear();
+      satFailed.clear();
+      hasSun = false;
+      hasMoon = false;
+   }
+
+
+      /* Computes the geometry of the satellites of the GDS not computed
+       * yet for this epoch and inserts it in the GDS.
+       *
+       * @param time      Epoch.
+       * @param gData     Data object holding the data.
+       */
+   SatTypePtrMap& SatGeometryCache::Process( const CommonTime& time,
+                                             SatTypePtrMap& gData )
+      throw(ProcessingException)
+   {
+
+      try
+      {
+
+         if (pEphemeris == NULL)
+         {
+            ProcessingException e("No ephemeris set");
+            GPSTK_THROW(e);
+         }
+
+            // A new epoch, or a new receiver position: start again
+         Triple rx(rxPos.X(), rxPos.Y(), rxPos.Z());
+         if ( epoch != time || !(cachedRxPos == rx) )
+         {
+            clear();
+            epoch = time;
+            cachedRxPos = rx;
+         }
+
+         for (auto stv = gData.begin(); stv != gData.end(); ++stv)
+         {
+            const SatID& sat = stv->first;
+
+            auto it = satGeometry.find(sat);
+            if (it == satGeometry.end())
+            {
+               if (satFailed.find(sat) != satFailed.end())
+                  continue;
+
+               typeValueMap& tvMap = stv->second->get_value();
+               if (tvMap.find(defaultObservable) == tvMap.end())
+                  continue;
+
+               CorrectedEphemerisRange cerange;
+               try
+               {
+                  cerange.ComputeAtTransmitTime( time,
+                                                 tvMap(defaultObservable),
+                                                 rxPos,
+                                                 sat,
+                                                 *pEphemeris );
+               }
+               catch(InvalidRequest& e)
+               {
+                  satFailed.insert(sat);
+                  continue;
+               }
+
+               it = satGeometry.insert(make_pair(sat, cerange)).first;
+               ++numComputed;
+            }
+
+               // Insert the geometry in the GDS
+            const CorrectedEphemerisRange& geo = it->second;
+            typeValueMap& tvMap = stv->second->get_value();
+            tvMap[TypeID::satX] = geo.svPosVel.x[0];
+            tvMap[TypeID::satY] = geo.svPosVel.x[1];
+            tvMap[TypeID::satZ] = geo.svPosVel.x[2];
+            tvMap[TypeID::satVX] = geo.svPosVel.v[0];
+            tvMap[TypeID::satVY] = geo.svPosVel.v[1];
+            tvMap[TypeID::satVZ] = geo.svPosVel.v[2];
+            tvMap[TypeID::rho] = geo.rawrange;
+            tvMap[TypeID::rel] = -geo.relativity;
+            tvMap[TypeID::dtSat] = geo.svclkbias;
+            tvMap[TypeID::elevation] = geo.elevationGeodetic;
+            tvMap[TypeID::azimuth] = geo.azimuthGeodetic;
+
+         }  // End of 'for (auto stv = gData.begin(); ...'
+
+         return gData;
+
+      }   // End of try...
+      catch(Exception& u)
+      {
+            // Throw an exception if something unexpected happens
+         ProcessingException e( getClassName() + ":" + u.what() );
+
+         GPSTK_THROW(e);
+
+      }
+
+   }  // End of method 'SatGeometryCache::Process()'
+
+
+      // Returns the geometry of 'sat' at 'time', or NULL if it is not
+      // in the cache.
+   const CorrectedEphemerisRange* SatGeometryCache::find( const SatID& sat,
+                                                          const CommonTime& time ) const
+   {
+      if (epoch != time)
+         return NULL;
+
+      auto it = satGeometry.find(sat);
+      return (it == satGeometry.end()) ? NULL : &it->second;
+   }
+
+
+      // Returns the Sun position at 'time'.
+   const Triple& SatGeometryCache::getSunPosition(const CommonTime& time)
+   {
+      if (epoch != time)
+      {
+         clear();
+         epoch = time;
+      }
+
+      if (!hasSun)
+      {
+         SunPosition sunPosition;
+         sunPos = sunPosition.getPosition(time);
+         hasSun = true;
+      }
+      return sunPos;
+   }
+
+
+      // Returns the Moon position at 'time'.
+   const Triple& SatGeometryCache::getMoonPosition(const CommonTime& time)
+   {
+      if (epoch != time)
+      {
+         clear();
+         epoch = time;
+      }
+
+      if (!hasMoon)
+      {
+         MoonPosition moonPosition;
+         moonPos = moonPosition.getPosition(time);
+         hasMoon = true;
+      }
+      return moonPos;
+   }
+
+}  // End of namespace gpstk
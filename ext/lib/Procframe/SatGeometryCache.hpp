@@ -0,0 +1,246 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/**
+ * @file SatGeometryCache.hpp
+ * This class computes the satellite geometry of an epoch once, for the
+ * modeling objects processing that epoch.
+ */
+
+#ifndef GPSTK_SATGEOMETRYCACHE_HPP
+#define GPSTK_SATGEOMETRYCACHE_HPP
+
+#include <map>
+#include "ProcessingClass.hpp"
+#include "Position.hpp"
+#include "EphemerisRange.hpp"
+#include "XvtStore.hpp"
+
+
+namespace gpstk
+{
+
+      /// @ingroup GPSsolutions 
+      //@{
+
+
+      /** This class computes the satellite geometry of an epoch once, for
+       *  the modeling objects processing that epoch.
+       *
+       * For every satellite of the GDS it computes the position and
+       * velocity at transmission time (with the light-time iteration of
+       * CorrectedEphemerisRange), the geometric range, the relativity and
+       * satellite clock corrections, the line-of-sight vector and the
+       * elevation and azimuth, and it computes the Sun and Moon positions
+       * of the epoch when first asked for. These are kept until the next
+       * epoch, or until the receiver position changes, and inserted in
+       * the GDS (satX, satY, satZ, satVX, satVY, satVZ, rho, rel, dtSat,
+       * elevation and azimuth).
+       *
+       * Objects such as BasicModel, ModelObs, ComputeSatPCenter,
+       * ComputeWindUp, GravitationalDelay and EclipsedSatFilter take the
+       * geometry from the cache, when they are given one, instead of
+       * computing it again:
+       *
+       * @code
+       *   SatGeometryCache geometry(nominalPos, sp3Eph);
+       *   BasicModel model(nominalPos, sp3Eph);
+       *   model.setGeometryCache(geometry);
+       *   ComputeWindUp windup(sp3Eph, nominalPos, "PRN_GPS");
+       *   windup.setGeometryCache(geometry);
+       *
+       *   while(rin >> gRin)
+       *   {
+       *      gRin >> geometry >> model >> windup;
+       *   }
+       * @endcode
+       *
+       * The receiver position, ephemeris and observable must be those of
+       * the objects using the cache. Satellites without ephemeris are left
+       * in the GDS, without geometry; the objects using the cache reject
+       * them as they would if they had computed the geometry themselves.
+       */
+   class SatGeometryCache : public ProcessingClass
+   {
+   public:
+
+         /// Default constructor. Observable C1 is used for the
+         /// transmission time.
+      SatGeometryCache();
+
+
+         /** Common constructor.
+          *
+          * @param rxCoordinates Receiver position.
+          * @param ephemeris     Ephemeris to be used.
+          * @param observable    Observable used for the transmission time.
+          */
+      SatGeometryCache( const Position& rxCoordinates,
+                        XvtStore<SatID>& ephemeris,
+                        const TypeID& observable = TypeID::C1 );
+
+
+         /** Computes the geometry of the satellites of the GDS not
+          *  computed yet for this epoch and inserts it in the GDS.
+          *
+          * @param time      Epoch.
+          * @param gData     Data object holding the data.
+          */
+      virtual SatTypePtrMap& Process( const CommonTime& time,
+                                      SatTypePtrMap& gData )
+         throw(ProcessingException);
+
+
+         /** Computes the geometry of the satellites of the GDS not
+          *  computed yet for this epoch and inserts it in the GDS.
+          *
+          * @param gData    Data object holding the data.
+          */
+      virtual IRinex& Process(IRinex& gData)
+         throw(ProcessingException)
+      { Process(gData.getHeader().epoch, gData.getBody()); return gData; };
+
+
+         /// Returns true if the cache holds the geometry of epoch 'time'
+      bool isCurrent(const CommonTime& time) const
+      { return (epoch == time); };
+
+
+         /** Returns the geometry of 'sat' at 'time', as computed by
+          *  CorrectedEphemerisRange::ComputeAtTransmitTime(), or NULL if it
+          *  is not in the cache, e.g. because there is no ephemeris for it.
+          */
+      const CorrectedEphemerisRange* find( const SatID& sat,
+                                           const CommonTime& time ) const;
+
+
+         /// Returns the Sun position (ECEF, meters) at 'time'; it is
+         /// computed once per epoch.
+      const Triple& getSunPosition(const CommonTime& time);
+
+
+         /// Returns the Moon position (ECEF, meters) at 'time'; it is
+         /// computed once per epoch.
+      const Triple& getMoonPosition(const CommonTime& time);
+
+
+         /// Returns the receiver position.
+      virtual Position getNominalPosition(void) const
+      { return rxPos; };
+
+
+         /** Sets the receiver position. The geometry computed with a
+          *  different position is discarded at the next Process().
+          */
+      virtual SatGeometryCache& setNominalPosition(const Position& stapos)
+      { rxPos = stapos; return (*this); };
+
+
+         /// Returns a pointer to the ephemeris used.
+      virtual XvtStore<SatID>* getDefaultEphemeris() const
+      { return pEphemeris; };
+
+
+         /// Sets the ephemeris to be used.
+      virtual SatGeometryCache& setDefaultEphemeris(XvtStore<SatID>& ephem)
+      { pEphemeris = &ephem; clear(); return (*this); };
+
+
+         /// Returns the observable used for the transmission time.
+      virtual TypeID getDefaultObservable() const
+      { return defaultObservable; };
+
+
+         /// Sets the observable used for the transmission time.
+      virtual SatGeometryCache& setDefaultObservable(const TypeID& type)
+      { defaultObservable = type; clear(); return (*this); };
+
+
+         /// Discards the geometry cached.
+      virtual void clear();
+
+
+         /// Number of satellite geometries computed since the object was
+         /// created.
+      unsigned long getNumComputed() const
+      { return numComputed; };
+
+
+         /// Returns a string identifying this object.
+      virtual std::string getClassName(void) const;
+
+
+         /// Destructor.
+      virtual ~SatGeometryCache() {};
+
+
+   private:
+
+
+         /// Receiver position
+      Position rxPos;
+
+         /// Ephemeris used
+      XvtStore<SatID>* pEphemeris;
+
+         /// Observable used for the transmission time
+      TypeID defaultObservable;
+
+         /// Epoch of the geometry cached, and receiver position used
+      CommonTime epoch;
+      Triple cachedRxPos;
+
+         /// Geometry of the satellites of the epoch
+      std::map<SatID, CorrectedEphemerisRange> satGeometry;
+
+         /// Satellites of the epoch whose geometry couldn't be computed
+      SatIDSet satFailed;
+
+         /// Sun and Moon positions of the epoch, if computed
+      bool hasSun, hasMoon;
+      Triple sunPos, moonPos;
+
+      unsigned long numComputed;
+
+
+   }; // End of class 'SatGeometryCache'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_SATGEOMETRYCACHE_HPP
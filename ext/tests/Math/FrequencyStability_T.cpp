@@ -0,0 +1,246 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+#include "FrequencyStability.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class FrequencyStability_T
+{
+public:
+   FrequencyStability_T()
+   {
+         // random walk frequency and white phase noise, with an offset
+         // and a frequency offset
+      srand(7);
+      double y(1.0e-9), p(1.0e-3);
+      for (int i = 0; i < 300; i++)
+      {
+         y += 1.0e-12 * noise();
+         p += y + 1.0e-11 * noise();
+         phase.push_back(p);
+      }
+   }
+
+      /// uniform noise in [-1, 1]
+   static double noise()
+   {
+      return 2.0 * rand() / RAND_MAX - 1.0;
+   }
+
+      /// the definition of the statistics, term by term
+   double direct(const vector<double>& x, FrequencyStability::Statistic st,
+                 size_t m, double tau0)
+   {
+      const size_t n = x.size();
+      double tau = m * tau0, s(0);
+      size_t k(0);
+      if (st == FrequencyStability::OverlappingAllan)
+      {
+         for (size_t i = 0; i + 2*m < n; i++)
+         {
+            double d = x[i+2*m] - 2*x[i+m] + x[i];
+            if (d == d) { s += d*d; k++; }
+         }
+         return sqrt(s / (2.0 * k)) / tau;
+      }
+      if (st == FrequencyStability::Hadamard)
+      {
+         for (size_t i = 0; i + 3*m < n; i++)
+         {
+            double d = x[i+3*m] - 3*x[i+2*m] + 3*x[i+m] - x[i];
+            if (d == d) { s += d*d; k++; }
+         }
+         return sqrt(s / (6.0 * k)) / tau;
+      }
+         // modified Allan
+      for (size_t j = 0; j + 3*m <= n; j++)
+      {
+         double w(0);
+         for (size_t i = j; i < j + m; i++)
+            w += x[i+2*m] - 2*x[i+m] + x[i];
+         if (w == w) { s += w*w; k++; }
+      }
+      double mdev = sqrt(s / (2.0 * k)) / (m * tau);
+      return st == FrequencyStability::Time ? mdev * tau / sqrt(3.0) : mdev;
+   }
+
+      /// relative difference of the curve and the direct computation
+   double maxError(const vector<double>& x, FrequencyStability::Statistic st)
+   {
+      FrequencyStability fs(x, 30.0);
+      vector<FrequencyStability::Point> curve = fs.compute(st);
+      double err(0);
+      for (size_t i = 0; i < curve.size(); i++)
+      {
+         size_t m = i + 1;
+         double ref = direct(x, st, m, 30.0);
+         if (curve[i].terms == 0)
+         {
+            if (ref == ref)
+               return 1.0;
+            continue;
+         }
+         err = max(err, std::abs(curve[i].deviation / ref - 1.0));
+      }
+      return err;
+   }
+
+   int directTest()
+   {
+      TUDEF("FrequencyStability", "compute");
+
+      FrequencyStability::Statistic sts[] =
+      { FrequencyStability::OverlappingAllan, FrequencyStability::ModifiedAllan,
+        FrequencyStability::Hadamard, FrequencyStability::Time };
+      for (auto st : sts)
+         TUASSERT(maxError(phase, st) < 1.0e-6);
+
+      FrequencyStability fs(phase, 30.0);
+      TUASSERTE(size_t, 149, fs.maxFactor(FrequencyStability::OverlappingAllan));
+      TUASSERTE(size_t, 100, fs.maxFactor(FrequencyStability::ModifiedAllan));
+      TUASSERTE(size_t, 99, fs.maxFactor(FrequencyStability::Hadamard));
+      TUASSERTE(size_t, 299, fs.maxFactor(FrequencyStability::Total));
+      TUASSERTE(size_t, 300 - 2*7, fs.compute(FrequencyStability::OverlappingAllan, 7).terms);
+      TUASSERT(std::isnan(fs.compute(FrequencyStability::ModifiedAllan, 101).deviation));
+
+         // the total deviation of a straight line is zero
+      vector<double> line;
+      for (int i = 0; i < 50; i++)
+         line.push_back(1.0e-6 + 1.0e-9 * i);
+      FrequencyStability fl(line, 1.0);
+      TUASSERTFE(0.0, fl.compute(FrequencyStability::Total, 30).deviation);
+
+      TURETURN();
+   }
+
+   int gapTest()
+   {
+      TUDEF("FrequencyStability", "gaps");
+
+      vector<double> x(phase);
+      x[0] = x[57] = x[58] = x[200] = numeric_limits<double>::quiet_NaN();
+
+      FrequencyStability fs(x, 30.0);
+      TUASSERTE(size_t, 4, fs.numGaps());
+      TUASSERT(maxError(x, FrequencyStability::OverlappingAllan) < 1.0e-6);
+      TUASSERT(maxError(x, FrequencyStability::ModifiedAllan) < 1.0e-6);
+      TUASSERT(maxError(x, FrequencyStability::Hadamard) < 1.0e-6);
+
+         // the terms using a missing point are dropped
+      TUASSERTE(size_t, 298 - 1 - 4 - 3,
+                fs.compute(FrequencyStability::OverlappingAllan, 1).terms);
+
+         // missing epochs and zero values of time tagged data
+      vector<double> time, ph;
+      for (int i = 0; i < 20; i++)
+      {
+         if (i == 5) continue;
+         time.push_back(10.0 + 2.0 * i);
+         ph.push_back(i == 9 ? 0.0 : 1.0 + i);
+      }
+      double tau0;
+      vector<double> reg = FrequencyStability::regularize(time, ph, tau0, true);
+      TUASSERTFE(2.0, tau0);
+      TUASSERTE(size_t, 20, reg.size());
+      TUASSERT(std::isnan(reg[5]));
+      TUASSERT(std::isnan(reg[9]));
+      TUASSERTFE(11.0, reg[10]);
+
+      TURETURN();
+   }
+
+   int spacingTest()
+   {
+      TUDEF("FrequencyStability", "spacing");
+
+      FrequencyStability fs(phase, 1.0);
+      fs.setSpacing(FrequencyStability::Octave);
+      vector<size_t> oct = fs.factors(FrequencyStability::OverlappingAllan);
+      TUASSERTE(size_t, 8, oct.size());
+      TUASSERTE(size_t, 128, oct.back());
+
+      fs.setSpacing(FrequencyStability::Decade);
+      vector<size_t> dec = fs.factors(FrequencyStability::OverlappingAllan);
+      TUASSERTE(size_t, 7, dec.size());
+      TUASSERTE(size_t, 5, dec[2]);
+      TUASSERTE(size_t, 100, dec.back());
+
+         // the threads give the same curve
+      vector<double> x;
+      for (int i = 0; i < 20000; i++)
+         x.push_back(1.0e-9 * noise());
+      FrequencyStability f1(x, 1.0), f4(x, 1.0);
+      f1.setSpacing(FrequencyStability::Octave);
+      f4.setSpacing(FrequencyStability::Octave).setThreads(4);
+      vector<FrequencyStability::Point> c1 = f1.compute(FrequencyStability::ModifiedAllan);
+      vector<FrequencyStability::Point> c4 = f4.compute(FrequencyStability::ModifiedAllan);
+      TUASSERTE(size_t, c1.size(), c4.size());
+      bool same(true);
+      for (size_t i = 0; i < c1.size(); i++)
+         same = same && c1[i].deviation == c4[i].deviation;
+      TUASSERT(same);
+
+      TURETURN();
+   }
+
+private:
+   vector<double> phase;
+};
+
+
+int main()
+{
+   int errorCounter = 0;
+   FrequencyStability_T testClass;
+
+   errorCounter += testClass.directTest();
+   errorCounter += testClass.gapTest();
+   errorCounter += testClass.spacingTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorCounter << std::endl;
+
+   return errorCounter; //Return the total number of errors
+}
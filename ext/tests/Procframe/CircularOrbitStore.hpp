@@ -0,0 +1,107 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+#ifndef EXT_TESTS_PROCFRAME_CIRCULARORBITSTORE_HPP
+#define EXT_TESTS_PROCFRAME_CIRCULARORBITSTORE_HPP
+
+#include <atomic>
+#include <cmath>
+#include <ostream>
+
+#include "XvtStore.hpp"
+#include "SatID.hpp"
+#include "CivilTime.hpp"
+
+   /// Ephemeris of the Procframe tests: circular orbits, one per PRN and
+   /// system, whose inclination depends on the system; the satellites
+   /// of PRN above maxPrn have no ephemeris. getXvt() may be called from
+   /// several threads; numCalls counts its calls.
+class CircularOrbitStore : public gpstk::XvtStore<gpstk::SatID>
+{
+public:
+   CircularOrbitStore(int maxPrn)
+      : t0(gpstk::CivilTime(2020, 6, 1, 0, 0, 0.0, gpstk::TimeSystem::GPS)),
+        numCalls(0), maxPrn(maxPrn)
+   {}
+
+   gpstk::Xvt getXvt(const gpstk::SatID& id, const gpstk::CommonTime& t) const
+   {
+      ++numCalls;
+      if (!isPresent(id))
+      {
+         gpstk::InvalidRequest e("No ephemeris");
+         GPSTK_THROW(e);
+      }
+      const double r = 26.56e6, w = 1.4585e-4;
+      double a = w * (t - t0) + 0.6 * id.id + 0.1 * id.system;
+      double i = 0.3 + 0.2 * id.system;
+      gpstk::Xvt xvt;
+      xvt.x = gpstk::Triple(r * std::cos(a), r * std::sin(a) * std::cos(i),
+                            r * std::sin(a) * std::sin(i));
+      xvt.v = gpstk::Triple(-r * w * std::sin(a), r * w * std::cos(a) * std::cos(i),
+                            r * w * std::cos(a) * std::sin(i));
+      xvt.clkbias = 1.0e-5 * id.id;
+      xvt.clkdrift = 0.0;
+      xvt.computeRelativityCorrection();
+      return xvt;
+   }
+
+   void dump(std::ostream& s, short detail) const {}
+   void edit(const gpstk::CommonTime& tmin, const gpstk::CommonTime& tmax) {}
+   void clear() {}
+   gpstk::TimeSystem getTimeSystem() const
+   { return gpstk::TimeSystem::GPS; }
+   gpstk::CommonTime getInitialTime() const
+   { return gpstk::CommonTime::BEGINNING_OF_TIME; }
+   gpstk::CommonTime getInitialTime(const gpstk::SatID&) const
+   { return gpstk::CommonTime::BEGINNING_OF_TIME; }
+   gpstk::CommonTime getFinalTime() const
+   { return gpstk::CommonTime::END_OF_TIME; }
+   gpstk::CommonTime getFinalTime(const gpstk::SatID&) const
+   { return gpstk::CommonTime::END_OF_TIME; }
+   bool hasVelocity() const { return true; }
+   bool isPresent(const gpstk::SatID& id) const { return id.id <= maxPrn; }
+      /// the satellites with ephemeris, of one system
+   unsigned size() const { return maxPrn; }
+
+   gpstk::CommonTime t0;
+   mutable std::atomic<int> numCalls;
+
+private:
+   int maxPrn;
+};
+
+#endif
@@ -0,0 +1,279 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "PipelinedProcessingList.hpp"
+#include "ProcessingList.hpp"
+#include "Decimate.hpp"
+#include "RinexEpoch.h"
+#include "CivilTime.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+   /// Adds 'step' to the C1 of all the satellites and checks that the
+   /// epochs come in order; throws at epoch 'failAt', if any.
+class StepObject : public ProcessingClass
+{
+public:
+   explicit StepObject(double s, int fail = -1)
+      : step(s), failAt(fail), numEpochs(0), inOrder(true),
+        lastEpoch(CommonTime::BEGINNING_OF_TIME)
+   {}
+
+   IRinex& Process(IRinex& gData)
+   {
+      const CommonTime& t(gData.getHeader().epoch);
+      inOrder = inOrder && (t > lastEpoch);
+      lastEpoch = t;
+      if (numEpochs++ == failAt)
+      {
+         InvalidRequest e("Failed");
+         GPSTK_THROW(e);
+      }
+      for (auto&& it : gData.getBody())
+         it.second->get_value()[TypeID::C1] += step;
+      return gData;
+   }
+
+   std::string getClassName() const
+   { return "StepObject"; }
+
+   double step;
+   int failAt;
+   int numEpochs;
+   bool inOrder;
+   CommonTime lastEpoch;
+};
+
+
+class PipelinedProcessingList_T
+{
+public:
+   PipelinedProcessingList_T()
+      : t0(CivilTime(2020, 6, 1, 0, 0, 0.0, TimeSystem::GPS))
+   {}
+
+      /// 'n' epochs 30 s apart, with 8 satellites
+   vector<RinexEpoch> makeEpochs(int n)
+   {
+      vector<RinexEpoch> epochs;
+      for (int k = 0; k < n; k++)
+      {
+         gnssRinex g;
+         g.header.epoch = t0 + 30.0 * k;
+         for (int prn = 1; prn <= 8; prn++)
+            g.body[SatID(prn, SatID::systemGPS)][TypeID::C1] = k;
+         epochs.push_back(RinexEpoch(g));
+      }
+      return epochs;
+   }
+
+   PipelinedProcessingList::EpochSource sourceOf(const vector<RinexEpoch>& e)
+   {
+      auto next = make_shared<size_t>(0);
+      return [&e, next]() -> irinex_uptr
+      {
+         if (*next >= e.size())
+            return irinex_uptr();
+         return e[(*next)++].clone();
+      };
+   }
+
+   int runTest();
+   int processTest();
+   int exceptionTest();
+
+   CommonTime t0;
+};
+
+
+int PipelinedProcessingList_T::runTest()
+{
+   TUDEF("PipelinedProcessingList", "run");
+
+   vector<RinexEpoch> epochs(makeEpochs(200));
+
+   for (size_t queueSize = 1; queueSize <= 8; queueSize *= 2)
+   {
+      StepObject a(1.0), b(10.0), c(100.0);
+      Decimate decimate(60.0, 1.0, CommonTime::BEGINNING_OF_TIME);
+
+      PipelinedProcessingList pList(queueSize);
+      pList.addStage(a, "first").add(b);
+      pList.addStage(decimate);
+      pList.addStage(c);
+      TUASSERTE(size_t, 3, pList.numStages());
+
+      vector<CommonTime> times;
+      bool ok = true;
+      unsigned long n = pList.run(sourceOf(epochs), [&](irinex_uptr gData)
+      {
+         const CommonTime& t(gData->getHeader().epoch);
+         times.push_back(t);
+         double k = (t - t0) / 30.0;
+         for (auto&& it : gData->getBody())
+            ok = ok && (it.second->get_value()(TypeID::C1) == k + 111.0);
+      });
+
+         // every other epoch decimated, the others in order
+      TUASSERTE(unsigned long, 100, n);
+      TUASSERTE(size_t, 100, times.size());
+      for (size_t i = 0; i < times.size(); i++)
+         ok = ok && (times[i] == t0 + 60.0 * i);
+      TUASSERT(ok);
+      TUASSERT(a.inOrder && b.inOrder && c.inOrder);
+      TUASSERTE(int, 200, a.numEpochs);
+      TUASSERTE(int, 100, c.numEpochs);
+
+      const vector<PipelinedProcessingList::StageStats>& st(pList.getStats());
+      TUASSERTE(size_t, 5, st.size());
+      TUASSERTE(string, "read", st[0].name);
+      TUASSERTE(string, "first", st[1].name);
+      TUASSERTE(string, "Decimate", st[2].name);
+      TUASSERTE(string, "output", st[4].name);
+      TUASSERTE(unsigned long, 200, st[0].epochs);
+      TUASSERTE(unsigned long, 200, st[2].epochs);
+      TUASSERTE(unsigned long, 100, st[2].dropped);
+      TUASSERTE(unsigned long, 100, st[3].epochs);
+      TUASSERTE(unsigned long, 100, st[4].epochs);
+      for (const auto& it : st)
+         ok = ok && (it.occupancy() >= 0.0) && (it.occupancy() <= 1.0);
+      TUASSERT(ok);
+   }
+
+      // an empty list hands the epochs over as they are
+   PipelinedProcessingList empty;
+   unsigned long n = empty.run(sourceOf(epochs), [](irinex_uptr) {});
+   TUASSERTE(unsigned long, 200, n);
+
+   ostringstream os;
+   empty.printStats(os);
+   TUASSERT(os.str().find("output,200,0,") != string::npos);
+
+   TURETURN();
+}
+
+
+int PipelinedProcessingList_T::processTest()
+{
+   TUDEF("PipelinedProcessingList", "Process");
+
+   StepObject a(1.0), b(10.0), c(100.0);
+   PipelinedProcessingList pList;
+   pList.push_back(a);
+   pList.push_back(b);
+   pList.addStage(c);
+   TUASSERTE(size_t, 2, pList.numStages());
+
+   RinexEpoch gRin(makeEpochs(1).front());
+   gRin >> pList;
+   for (auto&& it : gRin.getBody())
+      TUASSERTFE(111.0, it.second->get_value()(TypeID::C1));
+
+   TURETURN();
+}
+
+
+int PipelinedProcessingList_T::exceptionTest()
+{
+   TUDEF("PipelinedProcessingList", "run");
+
+   vector<RinexEpoch> epochs(makeEpochs(200));
+
+      // an exception of a stage stops the list and is rethrown
+   StepObject a(1.0), b(10.0, 57), c(100.0);
+   PipelinedProcessingList pList(2);
+   pList.addStage(a);
+   pList.addStage(b);
+   pList.addStage(c);
+
+   unsigned long received = 0;
+   try
+   {
+      pList.run(sourceOf(epochs), [&](irinex_uptr) { ++received; });
+      TUFAIL("Exception not rethrown");
+   }
+   catch (InvalidRequest& e)
+   {
+      TUPASS("InvalidRequest rethrown");
+   }
+   TUASSERT(received <= 57);
+   TUASSERT(c.numEpochs <= 57);
+
+      // and so does an exception of the sink
+   StepObject d(1.0);
+   PipelinedProcessingList pList2(2);
+   pList2.addStage(d);
+   try
+   {
+      pList2.run(sourceOf(epochs), [&](irinex_uptr gData)
+      {
+         if (gData->getHeader().epoch == t0 + 300.0)
+         {
+            InvalidParameter e("Sink failed");
+            GPSTK_THROW(e);
+         }
+      });
+      TUFAIL("Exception not rethrown");
+   }
+   catch (InvalidParameter& e)
+   {
+      TUPASS("InvalidParameter rethrown");
+   }
+
+   TURETURN();
+}
+
+
+int main()
+{
+   int errorCounter = 0;
+   PipelinedProcessingList_T testClass;
+
+   errorCounter += testClass.runTest();
+   errorCounter += testClass.processTest();
+   errorCounter += testClass.exceptionTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorCounter << std::endl;
+
+   return errorCounter; //Return the total number of errors
+}
@@ -0,0 +1,303 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "ProcessingProfiler.hpp"
+#include "ProcessingList.hpp"
+#include "RinexEpoch.h"
+#include "CivilTime.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+   /// Rejects the satellite of lowest PRN, allocates, and throws when
+   /// there is one satellite left.
+class RejectFirst : public ProcessingClass
+{
+public:
+   IRinex& Process(IRinex& gData)
+   {
+      if (gData.getBody().size() == 1)
+      {
+         ProcessingException e("Last satellite");
+         GPSTK_THROW(e);
+      }
+      vector<double>* v = new vector<double>(10);
+      delete v;
+      gData.getBody().erase(gData.getBody().begin());
+      return gData;
+   }
+
+   std::string getClassName() const
+   { return "RejectFirst"; }
+};
+
+
+class ProcessingProfiler_T
+{
+public:
+
+   int siteTest();
+   int macroTest();
+   int processTest();
+   int printTest();
+   int concurrentTest();
+};
+
+
+int ProcessingProfiler_T::siteTest()
+{
+   TUDEF("ProcessingProfiler", "Site");
+
+   ProcessingProfiler::Site& s(ProcessingProfiler::site("test site", "test"));
+   TUASSERT(&s == &ProcessingProfiler::site("test site", "other"));
+   TUASSERT(ProcessingProfiler::find("test site") == &s);
+   TUASSERT(ProcessingProfiler::find("no site") == NULL);
+   TUASSERTE(string, "test", s.getCategory());
+
+      // 90 calls of 1 us and 10 of 1 ms
+   for (int i = 0; i < 90; i++)
+      s.addTime(1000);
+   for (int i = 0; i < 10; i++)
+      s.addTime(1000000);
+   s.addSats(10, 7);
+   s.addSats(5, 6);
+
+   TUASSERTE(uint64_t, 100, s.calls());
+   TUASSERTE(uint64_t, 10090000, s.totalNs());
+   TUASSERTE(uint64_t, 1000000, s.maxNs());
+   TUASSERTE(uint64_t, 15, s.satellites());
+   TUASSERTE(uint64_t, 3, s.rejected());
+
+      // within a bin, a quarter of an octave
+   TUASSERT(s.percentileNs(0.5) >= 1000 && s.percentileNs(0.5) < 1190);
+   TUASSERT(s.percentileNs(0.9) >= 1000 && s.percentileNs(0.9) < 1190);
+   TUASSERTFE(1000000.0, s.percentileNs(0.99));
+
+   ProcessingProfiler::Site& c(ProcessingProfiler::site("test counter", "counter"));
+   c.add(3);
+   c.add(4);
+   TUASSERTE(uint64_t, 2, c.calls());
+   TUASSERTE(uint64_t, 7, c.value());
+
+   ProcessingProfiler::reset();
+   TUASSERTE(uint64_t, 0, s.calls());
+   TUASSERTE(uint64_t, 0, c.value());
+   TUASSERT(s.percentileNs(0.5) != s.percentileNs(0.5));
+
+   TURETURN();
+}
+
+
+int ProcessingProfiler_T::macroTest()
+{
+   TUDEF("ProcessingProfiler", "GPSTK_PROFILE_SCOPE");
+
+   for (int i = 0; i < 5; i++)
+   {
+      GPSTK_PROFILE_SCOPE("test scope");
+      GPSTK_PROFILE_COUNT("test count", 2);
+   }
+
+   const ProcessingProfiler::Site* s = ProcessingProfiler::find("test scope");
+   const ProcessingProfiler::Site* c = ProcessingProfiler::find("test count");
+   if (ProcessingProfiler::isCompiledIn())
+   {
+      TUASSERT(s != NULL && c != NULL);
+      TUASSERTE(uint64_t, 5, s->calls());
+      TUASSERTE(uint64_t, 10, c->value());
+   }
+   else
+   {
+         // compiled out
+      TUASSERT(s == NULL && c == NULL);
+   }
+
+   TURETURN();
+}
+
+
+int ProcessingProfiler_T::processTest()
+{
+   TUDEF("ProcessingProfiler", "process");
+
+   gnssRinex g;
+   g.header.epoch = CivilTime(2020, 6, 1, 0, 0, 0.0, TimeSystem::GPS);
+   for (int prn = 1; prn <= 4; prn++)
+      g.body[SatID(prn, SatID::systemGPS)][TypeID::C1] = 2.0e7;
+   RinexEpoch gRin(g);
+
+   RejectFirst reject;
+   ProcessingList pList;
+   pList.push_back(reject);
+
+   gRin >> reject;
+   gRin >> pList;
+   TUASSERTE(size_t, 2, gRin.getBody().size());
+   gRin >> reject;
+   try
+   {
+      gRin >> reject;
+      TUFAIL("Exception not thrown");
+   }
+   catch (ProcessingException& e)
+   {
+      TUPASS("ProcessingException thrown");
+   }
+
+   const ProcessingProfiler::Site* s = ProcessingProfiler::find("RejectFirst");
+   const ProcessingProfiler::Site* l =
+      ProcessingProfiler::find("ProcessingList");
+   if (ProcessingProfiler::isCompiledIn())
+   {
+      TUASSERT(s != NULL && l != NULL);
+      TUASSERTE(uint64_t, 4, s->calls());
+      TUASSERTE(uint64_t, 4 + 3 + 2, s->satellites());
+      TUASSERTE(uint64_t, 3, s->rejected());
+      TUASSERTE(uint64_t, 1, s->throws());
+      TUASSERT(s->allocations() >= 3);
+      TUASSERTE(uint64_t, 1, l->calls());
+      TUASSERTE(string, "ProcessingClass", s->getCategory());
+   }
+   else
+   {
+      TUASSERT(s == NULL && l == NULL);
+   }
+
+   TURETURN();
+}
+
+
+int ProcessingProfiler_T::printTest()
+{
+   TUDEF("ProcessingProfiler", "printCSV");
+
+   ProcessingProfiler::reset();
+   ProcessingProfiler::setTraceCapacity(100);
+
+   ProcessingProfiler::Site& s(ProcessingProfiler::site("print \"site\"", "test"));
+   for (int i = 0; i < 3; i++)
+   {
+      ScopedTimer timer(s);
+   }
+   TUASSERTE(uint64_t, 3, s.calls());
+
+   ostringstream csv;
+   ProcessingProfiler::printCSV(csv);
+   TUASSERT(csv.str().find("name,category,calls,value,total_ms") == 0);
+   TUASSERT(csv.str().find("\nprint \"site\",test,3,0,") != string::npos);
+
+   ostringstream trace;
+   ProcessingProfiler::printChromeTrace(trace);
+   TUASSERT(trace.str().find("{\"traceEvents\":[") == 0);
+   TUASSERT(trace.str().find("{\"name\":\"print \\\"site\\\"\",\"cat\":\"test\",\"ph\":\"X\"")
+            != string::npos);
+   TUASSERT(trace.str().find("],\"displayTimeUnit\":\"ms\"}") != string::npos);
+
+   ProcessingProfiler::setTraceCapacity(0);
+   ProcessingProfiler::reset();
+
+   TURETURN();
+}
+
+
+int ProcessingProfiler_T::concurrentTest()
+{
+   TUDEF("ProcessingProfiler", "printChromeTrace");
+
+   ProcessingProfiler::reset();
+   ProcessingProfiler::setTraceCapacity(1000);
+
+      // Printed and reset while two threads record
+   ProcessingProfiler::Site& s(ProcessingProfiler::site("concurrent", "test"));
+   atomic<bool> done(false);
+   auto work = [&]()
+   {
+      while (!done)
+      {
+         ScopedTimer timer(s);
+      }
+   };
+   thread t1(work), t2(work);
+
+   for (int i = 0; i < 200; i++)
+   {
+      ostringstream csv, trace;
+      ProcessingProfiler::printCSV(csv);
+      ProcessingProfiler::printChromeTrace(trace);
+      TUASSERT(trace.str().find("],\"displayTimeUnit\":\"ms\"}")
+               != string::npos);
+      if (i % 10 == 0)
+      {
+         ProcessingProfiler::reset();
+         ProcessingProfiler::setTraceCapacity(1000 + i);
+      }
+   }
+
+   done = true;
+   t1.join();
+   t2.join();
+   TUASSERT(s.calls() > 0);
+
+   ProcessingProfiler::setTraceCapacity(0);
+   ProcessingProfiler::reset();
+
+   TURETURN();
+}
+
+
+int main()
+{
+   int errorCounter = 0;
+   ProcessingProfiler_T testClass;
+
+   errorCounter += testClass.siteTest();
+   errorCounter += testClass.macroTest();
+   errorCounter += testClass.processTest();
+   errorCounter += testClass.printTest();
+   errorCounter += testClass.concurrentTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorCounter << std::endl;
+
+   return errorCounter; //Return the total number of errors
+}
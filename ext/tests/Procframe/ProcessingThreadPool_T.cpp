@@ -0,0 +1,240 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ProcessingThreadPool.hpp"
+#include "BasicModel.hpp"
+#include "GravitationalDelay.hpp"
+#include "ComputeTropModel.hpp"
+#include "NeillTropModel.hpp"
+#include "RinexEpoch.h"
+#include "CivilTime.hpp"
+#include "CircularOrbitStore.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class ProcessingThreadPool_T
+{
+public:
+   ProcessingThreadPool_T()
+      : rxPos(3370658.5419, 711877.1496, 5349786.9542), eph(30)
+   {}
+
+      /// epoch 'k' with 'n' satellites of each of GPS, Glonass, Galileo
+      /// and BeiDou
+   RinexEpoch makeEpoch(int k, int n)
+   {
+      gnssRinex g;
+      g.header.epoch = eph.t0 + 30.0 * k;
+      SatID::SatelliteSystem sys[] = { SatID::systemGPS,
+                                       SatID::systemGlonass,
+                                       SatID::systemGalileo,
+                                       SatID::systemBeiDou };
+      for (int s = 0; s < 4; s++)
+         for (int prn = 1; prn <= n; prn++)
+            g.body[SatID(prn, sys[s])][TypeID::C1] = 2.2e7 + 1000.0 * prn;
+      return RinexEpoch(g);
+   }
+
+   int loopTest();
+   int exceptionTest();
+   int modelTest();
+
+   Position rxPos;
+   CircularOrbitStore eph;
+};
+
+
+int ProcessingThreadPool_T::loopTest()
+{
+   TUDEF("ProcessingThreadPool", "parallelFor");
+
+   for (unsigned threads = 1; threads <= 4; threads++)
+   {
+      ProcessingThreadPool pool(threads);
+      TUASSERTE(unsigned, threads, pool.getNumThreads());
+
+      for (size_t n = 0; n < 200; n += 7)
+      {
+         vector<atomic<int> > count(n);
+         for (auto& it : count)
+            it = 0;
+         pool.parallelFor(n, [&](size_t i) { ++count[i]; });
+
+         bool ok = true;
+         for (auto& it : count)
+            ok = ok && (it == 1);
+         TUASSERT(ok);
+      }
+   }
+
+   ProcessingThreadPool pool(4);
+
+      // a loop started from within a loop runs serially
+   atomic<int> inner(0);
+   pool.parallelFor(10, [&](size_t i)
+   {
+      pool.parallelFor(10, [&](size_t j) { ++inner; });
+   });
+   TUASSERTE(int, 100, inner);
+
+      // loops started by several threads at once all run
+   atomic<int> total(0);
+   vector<thread> callers;
+   for (int c = 0; c < 4; c++)
+      callers.push_back(thread([&]
+      {
+         for (int k = 0; k < 50; k++)
+            pool.parallelFor(20, [&](size_t i) { ++total; });
+      }));
+   for (auto& it : callers)
+      it.join();
+   TUASSERTE(int, 4 * 50 * 20, total);
+
+   TURETURN();
+}
+
+
+int ProcessingThreadPool_T::exceptionTest()
+{
+   TUDEF("ProcessingThreadPool", "parallelFor");
+
+   ProcessingThreadPool pool(3);
+   atomic<int> count(0);
+   try
+   {
+      pool.parallelFor(100, [&](size_t i)
+      {
+         ++count;
+         if (i == 37)
+            throw runtime_error("37");
+      });
+      TUFAIL("Exception not rethrown");
+   }
+   catch (runtime_error& e)
+   {
+      TUASSERTE(string, "37", e.what());
+   }
+   TUASSERTE(int, 100, count);
+
+      // the pool is still usable
+   count = 0;
+   pool.parallelFor(100, [&](size_t i) { ++count; });
+   TUASSERTE(int, 100, count);
+
+   TURETURN();
+}
+
+
+int ProcessingThreadPool_T::modelTest()
+{
+   TUDEF("ProcessingThreadPool", "Process");
+
+   NeillTropModel neill( rxPos.getAltitude(),
+                         rxPos.getGeodeticLatitude(), 153 );
+   BasicModel model(rxPos, eph);
+   GravitationalDelay grDelay(rxPos);
+   ComputeTropModel tropo(neill);
+
+   TUASSERT(model.isParallelSafe());
+   TUASSERT(grDelay.isParallelSafe());
+   TUASSERT(tropo.isParallelSafe());
+
+   ProcessingThreadPool pool(4);
+   BasicModel pModel(rxPos, eph);
+   GravitationalDelay pGrDelay(rxPos);
+   ComputeTropModel pTropo(neill);
+   pModel.setThreadPool(&pool);
+   pGrDelay.setThreadPool(&pool);
+   pTropo.setThreadPool(&pool);
+   TUASSERT(pModel.getThreadPool() == &pool);
+
+      // the same satellites and values, including the satellites
+      // rejected (no ephemeris, low elevation)
+   bool ok = true;
+   size_t numSats = 0;
+   for (int k = 0; k < 10; k++)
+   {
+      RinexEpoch a(makeEpoch(k, 34)), b(makeEpoch(k, 34));
+      a >> model >> grDelay >> tropo;
+      b >> pModel >> pGrDelay >> pTropo;
+
+      ok = ok && (a.getBody().numSats() == b.getBody().numSats());
+      numSats += a.getBody().numSats();
+      for (auto&& it : a.getBody())
+      {
+         if (b.getBody().count(it.first) == 0)
+         {
+            ok = false;
+            continue;
+         }
+         typeValueMap& ta = it.second->get_value();
+         typeValueMap& tb = b.getBody()(it.first);
+         ok = ok && (ta.size() == tb.size());
+         for (auto&& tv : ta)
+            ok = ok && (tb.count(tv.first) == 1) && (tv.second == tb(tv.first));
+      }
+   }
+   TUASSERT(ok);
+   TUASSERT(numSats > 0 && numSats < 10 * 4 * 34);
+   TUASSERT(model.getRejSats() == pModel.getRejSats());
+
+   TURETURN();
+}
+
+
+int main()
+{
+   int errorCounter = 0;
+   ProcessingThreadPool_T testClass;
+
+   errorCounter += testClass.loopTest();
+   errorCounter += testClass.exceptionTest();
+   errorCounter += testClass.modelTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorCounter << std::endl;
+
+   return errorCounter; //Return the total number of errors
+}
@@ -0,0 +1,249 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+#include <iostream>
+
+#include "RinexEpochLog.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class RinexEpochLog_T
+{
+public:
+   RinexEpochLog_T() {}
+
+      /// epoch 'k' with 'nSat' satellites, every third one missing P2
+   RinexEpoch makeEpoch(int k, int nSat)
+   {
+      gnssRinex g;
+      g.header.epoch = CommonTime(TimeSystem::GPS) + 30.0 * k + 0.125;
+      g.header.source = SourceID(SourceID::LEO, "GRCA");
+      g.header.antennaType = "TRM59800.00     NONE";
+      g.header.antennaPosition = Triple(1.5, -2.5, 3.25);
+      g.header.epochFlag = k % 2;
+      for (int s = 0; s < nSat; s++)
+      {
+         SatID sv(s + 1, s % 3 == 2 ? SatID::systemGlonass : SatID::systemGPS);
+         typeValueMap& tv = g.body[sv];
+         tv[TypeID::C1] = 2.0e7 + 1000.0 * s + k;
+         tv[TypeID::L1] = 1.1e8 + 0.001 * s - k;
+         if (s % 3 != 0)
+            tv[TypeID::P2] = 2.1e7 + s;
+      }
+      return RinexEpoch(g);
+   }
+
+      /// compare the header and data of two epochs
+   bool same(const IRinex& a, const IRinex& b)
+   {
+      const sourceEpochRinexHeader& ha = a.getHeader();
+      const sourceEpochRinexHeader& hb = b.getHeader();
+      if (ha.epoch != hb.epoch || !(ha.source == hb.source) ||
+          ha.antennaType != hb.antennaType ||
+          ha.antennaPosition[0] != hb.antennaPosition[0] ||
+          ha.antennaPosition[1] != hb.antennaPosition[1] ||
+          ha.antennaPosition[2] != hb.antennaPosition[2] ||
+          ha.epochFlag != hb.epochFlag)
+         return false;
+
+      if (a.getBody().size() != b.getBody().size())
+         return false;
+      auto itb = b.getBody().begin();
+      for (auto&& ita : a.getBody())
+      {
+         if (!(ita.first == itb->first) ||
+             ita.second->get_value() != itb->second->get_value())
+            return false;
+         ++itb;
+      }
+      return true;
+   }
+
+   int roundTripTest(bool spill);
+   int rewriteTest(bool spill);
+};
+
+
+int RinexEpochLog_T::roundTripTest(bool spill)
+{
+   TUDEF("RinexEpochLog", spill ? "read (disk)" : "read (memory)");
+
+   RinexEpochLog log;
+   log.setSpillToDisk(spill);
+   TUASSERTE(bool, spill, log.getSpillToDisk());
+
+   for (int k = 0; k < 20; k++)
+      log.push_back(makeEpoch(k, 4 + k % 9));
+   TUASSERTE(size_t, 20, log.size());
+
+   bool ok = true;
+   RinexEpoch ep;
+   for (int k = 19; k >= 0; k--)
+   {
+      log.read(k, ep);
+      ok = ok && same(ep, makeEpoch(k, 4 + k % 9));
+   }
+   TUASSERT(ok);
+
+      // the epoch read is usable through its body
+   log.read(3, ep);
+   TUASSERTE(size_t, 7, ep.getBody().numSats());
+
+      // an epoch without satellites
+   RinexEpoch empty(makeEpoch(5, 0));
+   log.push_back(empty);
+   log.read(20, ep);
+   TUASSERT(same(ep, empty));
+
+      // moving the records between memory and disk keeps them
+   log.setSpillToDisk(!spill);
+   ok = true;
+   for (int k = 0; k < 20; k++)
+   {
+      log.read(k, ep);
+      ok = ok && same(ep, makeEpoch(k, 4 + k % 9));
+   }
+   TUASSERT(ok);
+
+      // as with clone(), satellites removed from the body only are kept
+   log.read(0, ep);
+   SatID removed = ep.getBody().begin()->first;
+   ep.getBody().erase(removed);
+   log.write(0, ep);
+   log.read(0, ep);
+   TUASSERTE(size_t, 3, ep.getBody().numSats());
+   TUASSERTE(size_t, 1, ep.getRinex().body.count(removed));
+   TUASSERT(same(RinexEpoch(ep.getRinex()), makeEpoch(0, 4)));
+
+   try
+   {
+      log.read(21, ep);
+      TUFAIL("Read past the end of the log");
+   }
+   catch (std::out_of_range&)
+   {
+      TUPASS("Read past the end of the log rejected");
+   }
+
+   log.clear();
+   TUASSERTE(size_t, 0, log.size());
+   TUASSERTE(size_t, 0, log.getUsedBytes());
+
+   TURETURN();
+}
+
+
+int RinexEpochLog_T::rewriteTest(bool spill)
+{
+   TUDEF("RinexEpochLog", spill ? "write (disk)" : "write (memory)");
+
+   RinexEpochLog log;
+   log.setSpillToDisk(spill);
+
+   const int n = 30;
+   for (int k = 0; k < n; k++)
+      log.push_back(makeEpoch(k, 8));
+   size_t initial = log.getUsedBytes();
+
+      // grow every record, as when postfit residuals are added,
+      // then shrink them, as when satellites are rejected
+   for (int pass = 0; pass < 4; pass++)
+   {
+      for (int k = n - 1; k >= 0; k--)
+      {
+         RinexEpoch ep;
+         log.read(k, ep);
+         for (auto&& it : ep.getBody())
+            if (pass % 2 == 0)
+               it.second->get_value()[TypeID::postfitL] = 0.01 * k;
+            else
+               it.second->get_value().erase(TypeID::postfitL);
+         if (pass == 3)
+         {
+            SatIDSet keep = ep.getBody().getSatID();
+            keep.erase(keep.begin());
+            ep.keepOnlySatID(keep);
+         }
+         log.write(k, ep);
+      }
+   }
+
+   bool ok = true;
+   for (int k = 0; k < n; k++)
+   {
+      RinexEpoch ep, ref(makeEpoch(k, 8));
+      log.read(k, ep);
+      ref.getBody().erase(ref.getBody().begin());
+      ok = ok && same(ep, ref);
+   }
+   TUASSERT(ok);
+   TUASSERT(log.getUsedBytes() < initial);
+
+      // shrinking most of the records makes the log compact itself
+   for (int k = 0; k < n; k += 2)
+      log.write(k, makeEpoch(k, 1));
+   ok = true;
+   for (int k = 0; k < n; k++)
+   {
+      RinexEpoch ep, ref(makeEpoch(k, k % 2 ? 8 : 1));
+      log.read(k, ep);
+      if (k % 2)
+         ref.getBody().erase(ref.getBody().begin());
+      ok = ok && same(ep, ref);
+   }
+   TUASSERT(ok);
+
+   TURETURN();
+}
+
+
+int main()
+{
+   int errorCounter = 0;
+   RinexEpochLog_T testClass;
+
+   errorCounter += testClass.roundTripTest(false);
+   errorCounter += testClass.roundTripTest(true);
+   errorCounter += testClass.rewriteTest(false);
+   errorCounter += testClass.rewriteTest(true);
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorCounter << std::endl;
+
+   return errorCounter; //Return the total number of errors
+}
@@ -0,0 +1,207 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+#include <iostream>
+#include <cmath>
+
+#include "SatGeometryCache.hpp"
+#include "BasicModel.hpp"
+#include "RinexEpoch.h"
+#include "SunPosition.hpp"
+#include "CivilTime.hpp"
+#include "CircularOrbitStore.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class SatGeometryCache_T
+{
+public:
+   SatGeometryCache_T()
+      : rxPos(6.378e6, 0.0, 0.0), eph(10)
+   {}
+
+      /// epoch 'k' with PRNs 1, 2, 3 and 12 (no ephemeris)
+   RinexEpoch makeEpoch(int k)
+   {
+      gnssRinex g;
+      g.header.epoch = eph.t0 + 30.0 * k;
+      int prn[] = { 1, 2, 3, 12 };
+      for (int s = 0; s < 4; s++)
+      {
+         SatID sv(prn[s], SatID::systemGPS);
+         g.body[sv][TypeID::C1] = 2.2e7 + 1000.0 * s;
+      }
+      return RinexEpoch(g);
+   }
+
+   int cacheTest();
+   int modelTest();
+
+   Position rxPos;
+   CircularOrbitStore eph;
+};
+
+
+int SatGeometryCache_T::cacheTest()
+{
+   TUDEF("SatGeometryCache", "Process");
+
+   SatGeometryCache geometry(rxPos, eph);
+   RinexEpoch ep(makeEpoch(1));
+   const CommonTime& t = ep.getHeader().epoch;
+
+   geometry.Process(ep);
+   TUASSERTE(unsigned long, 3, geometry.getNumComputed());
+   TUASSERT(geometry.isCurrent(t));
+
+   SatID sv1(1, SatID::systemGPS), sv12(12, SatID::systemGPS);
+   const CorrectedEphemerisRange* geo = geometry.find(sv1, t);
+   TUASSERT(geo != NULL);
+   TUASSERT(geometry.find(sv12, t) == NULL);
+   TUASSERT(geometry.find(sv1, t + 30.0) == NULL);
+
+      // the same geometry as computed directly
+   CorrectedEphemerisRange cerange;
+   cerange.ComputeAtTransmitTime(t, 2.2e7, rxPos, sv1, eph);
+   TUASSERTFE(cerange.rawrange, geo->rawrange);
+   TUASSERTFE(cerange.elevationGeodetic, geo->elevationGeodetic);
+
+      // and in the GDS; the satellite without ephemeris is left there
+   typeValueMap& tv = ep.getBody()(sv1);
+   TUASSERTFE(geo->rawrange, tv(TypeID::rho));
+   TUASSERTFE(geo->svPosVel.x[0], tv(TypeID::satX));
+   TUASSERTFE(-geo->relativity, tv(TypeID::rel));
+   TUASSERTE(size_t, 4, ep.getBody().numSats());
+   TUASSERTE(size_t, 0, ep.getBody()(sv12).count(TypeID::rho));
+
+      // processing the epoch again computes nothing, not even the
+      // satellites without ephemeris
+   int calls = eph.numCalls;
+   RinexEpoch again(makeEpoch(1));
+   geometry.Process(again);
+   TUASSERTE(unsigned long, 3, geometry.getNumComputed());
+   TUASSERTE(int, calls, eph.numCalls);
+   TUASSERTFE(geo->rawrange, again.getBody()(sv1)(TypeID::rho));
+
+      // a new receiver position, then a new epoch, start again
+   geometry.setNominalPosition(Position(0.0, 6.378e6, 0.0));
+   geometry.Process(again);
+   TUASSERTE(unsigned long, 6, geometry.getNumComputed());
+
+   RinexEpoch next(makeEpoch(2));
+   geometry.Process(next);
+   TUASSERTE(unsigned long, 9, geometry.getNumComputed());
+   TUASSERT(!geometry.isCurrent(t));
+   TUASSERT(geometry.find(sv1, t) == NULL);
+
+      // the Sun position is computed once per epoch
+   const CommonTime& t2 = next.getHeader().epoch;
+   SunPosition sun;
+   Triple s = sun.getPosition(t2);
+   TUASSERTFE(s[0], geometry.getSunPosition(t2)[0]);
+   TUASSERTFE(s[2], geometry.getSunPosition(t2)[2]);
+   TUASSERT(geometry.find(sv1, t2) != NULL);
+
+   try
+   {
+      SatGeometryCache empty;
+      empty.Process(next);
+      TUFAIL("Processing without ephemeris");
+   }
+   catch (ProcessingException&)
+   {
+      TUPASS("Processing without ephemeris rejected");
+   }
+
+   TURETURN();
+}
+
+
+int SatGeometryCache_T::modelTest()
+{
+   TUDEF("SatGeometryCache", "BasicModel");
+
+   SatGeometryCache geometry(rxPos, eph);
+   BasicModel model(rxPos, eph);
+   model.setMinElev(-90.0);
+   BasicModel cachedModel(rxPos, eph);
+   cachedModel.setMinElev(-90.0);
+   cachedModel.setGeometryCache(geometry);
+
+   bool ok = true;
+   for (int k = 0; k < 5; k++)
+   {
+      RinexEpoch a(makeEpoch(k)), b(makeEpoch(k));
+      model.Process(a);
+      geometry.Process(b);
+      int calls = eph.numCalls;
+      cachedModel.Process(b);
+      ok = ok && (eph.numCalls == calls);
+
+      ok = ok && (a.getBody().numSats() == b.getBody().numSats());
+      for (auto&& it : a.getBody())
+      {
+         typeValueMap& ta = it.second->get_value();
+         typeValueMap& tb = b.getBody()(it.first);
+         ok = ok && (ta.size() == tb.size());
+         for (auto&& tv : ta)
+            ok = ok && (tb.count(tv.first) == 1) &&
+                 std::abs(tv.second - tb(tv.first)) <= 1e-9 * (1.0 + std::abs(tv.second));
+      }
+   }
+      // the model gives the same results with the cache, without
+      // computing the geometry again
+   TUASSERT(ok);
+
+   TURETURN();
+}
+
+
+int main()
+{
+   int errorCounter = 0;
+   SatGeometryCache_T testClass;
+
+   errorCounter += testClass.cacheTest();
+   errorCounter += testClass.modelTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorCounter << std::endl;
+
+   return errorCounter; //Return the total number of errors
+}
@@ -0,0 +1,265 @@
+// Check of the Rauch-Tung-Striebel smoother of KalmanSmoother against the
+// batch least-squares solution of the same problem.
+//
+// Usage: KalmanSmoother_check
+//
+// A receiver position component, a clock and the float ambiguities of
+// three satellites are constant over 12 epochs and observed by code and
+// phase. The ambiguity of G02 disappears after epoch 5 and that of G03
+// appears at epoch 4. Every unknown has a prior of 0 +- 10 when it first
+// appears. A Kalman filter with identity transition and no process noise
+// logs into a KalmanSmoother, in memory and spilled to disk; after
+// smooth() every epoch must hold the batch solution of all the epochs,
+// restricted to its unknowns.
+//
+// Prints, per storage, the largest differences of the filtered and of the
+// smoothed states and covariances from the batch ones, relative to the
+// largest batch values, as CSV. Exits with 1 if a smoothed one exceeds
+// 1e-10; the filter, in information form, is good to about 1e-12.
+
+#include"KalmanSmoother.h"
+#include"MatrixOperators.hpp"
+#include"CommonTime.hpp"
+
+#include<algorithm>
+#include<cmath>
+#include<iostream>
+#include<map>
+#include<vector>
+
+using namespace std;
+using namespace gpstk;
+using namespace pod;
+
+namespace
+{
+    const int numEpochs = 12;
+    const double priorVariance = 100.0;
+    const double codeWeight = 1.0;
+    const double phaseWeight = 1.0e4;
+
+    FilterParameter ambiguity(int prn)
+    {
+        return FilterParameter(TypeID::BLC, SatID(prn, SatID::systemGPS));
+    }
+
+    // satellites tracked at epoch 'k'
+    vector<int> tracked(int k)
+    {
+        vector<int> prns(1, 1);
+        if (k <= 5)
+            prns.push_back(2);
+        if (k >= 4)
+            prns.push_back(3);
+        return prns;
+    }
+
+    // unknowns of epoch 'k'
+    ParametersSet unknowns(int k)
+    {
+        ParametersSet pars;
+        pars.insert(FilterParameter(TypeID::dx));
+        pars.insert(FilterParameter(TypeID::cdt));
+        for (int prn : tracked(k))
+            pars.insert(ambiguity(prn));
+        return pars;
+    }
+
+    // one observation: coefficients of the unknowns, value and weight
+    struct Observation
+    {
+        map<FilterParameter, double> h;
+        double z;
+        double w;
+    };
+
+    // code and phase observations of epoch 'k'
+    vector<Observation> observations(int k)
+    {
+        const double truth[] = { 1.5, -20.0, 3.2, -7.7, 12.1 };
+
+        vector<Observation> obs;
+        for (int prn : tracked(k))
+        {
+            double a = cos(0.35 * k + 1.1 * prn);
+            double noise = 0.3 * sin(1.7 * k + prn);
+            double range = a * truth[0] + truth[1];
+
+            Observation code;
+            code.h[FilterParameter(TypeID::dx)] = a;
+            code.h[FilterParameter(TypeID::cdt)] = 1.0;
+            code.z = range + noise;
+            code.w = codeWeight;
+            obs.push_back(code);
+
+            Observation phase(code);
+            phase.h[ambiguity(prn)] = 1.0;
+            phase.z = range + truth[1 + prn] + 0.01 * noise;
+            phase.w = phaseWeight;
+            obs.push_back(phase);
+        }
+        return obs;
+    }
+
+    // index of every unknown of 'pars', in the set order
+    map<FilterParameter, size_t> indices(const ParametersSet& pars)
+    {
+        map<FilterParameter, size_t> index;
+        for (const auto& par : pars)
+        {
+            size_t i = index.size();
+            index[par] = i;
+        }
+        return index;
+    }
+
+    // adds the normal equations of 'obs' to N and b
+    void addNormals(const vector<Observation>& obs,
+                    const map<FilterParameter, size_t>& index,
+                    Matrix<double>& N, Vector<double>& b)
+    {
+        for (const auto& o : obs)
+            for (const auto& hi : o.h)
+            {
+                size_t i = index.at(hi.first);
+                b(i) += hi.second * o.w * o.z;
+                for (const auto& hj : o.h)
+                    N(i, index.at(hj.first)) += hi.second * o.w * hj.second;
+            }
+    }
+
+    // runs the filter into 'smoother'
+    void filter(KalmanSmoother& smoother)
+    {
+        ParametersSet lastPars;
+        Vector<double> x;
+        Matrix<double> P;
+
+        for (int k = 0; k < numEpochs; k++)
+        {
+            ParametersSet pars(unknowns(k));
+            map<FilterParameter, size_t> index(indices(pars)),
+                lastIndex(indices(lastPars));
+            size_t n = pars.size();
+
+            // prediction: carried unknowns keep their value, the new ones
+            // get the prior
+            Vector<double> xp(n, 0.0);
+            Matrix<double> Pp(n, n, 0.0), phi(n, n, 0.0);
+            EquationComposer::FilterState carried;
+            for (const auto& pi : index)
+            {
+                phi(pi.second, pi.second) = 1.0;
+                auto li = lastIndex.find(pi.first);
+                if (li == lastIndex.end())
+                {
+                    Pp(pi.second, pi.second) = priorVariance;
+                    continue;
+                }
+                carried[pi.first].value = x(li->second);
+                xp(pi.second) = x(li->second);
+                for (const auto& pj : index)
+                {
+                    auto lj = lastIndex.find(pj.first);
+                    if (lj != lastIndex.end())
+                        Pp(pi.second, pj.second) = P(li->second, lj->second);
+                }
+            }
+
+            CommonTime t;
+            t.set(58000 + k / 2880, 30 * (k % 2880), 0.0, TimeSystem::GPS);
+            smoother.stagePrediction(t, pars, carried, k > 0, phi, xp, Pp);
+
+            // update, in information form
+            Matrix<double> N(inverse(Pp));
+            Vector<double> b(N * xp);
+            addNormals(observations(k), index, N, b);
+            P = inverse(N);
+            x = P * b;
+
+            smoother.commitUpdate(x, P);
+            lastPars = pars;
+        }
+    }
+
+    // largest differences of the states and covariances of 'smoother'
+    // from 'xb' and 'Q'
+    void compare(const KalmanSmoother& smoother,
+                 const map<FilterParameter, size_t>& allIndex,
+                 const Vector<double>& xb, const Matrix<double>& Q,
+                 double& dx, double& dq)
+    {
+        dx = dq = 0.0;
+        for (size_t k = 0; k < smoother.size(); k++)
+        {
+            ParametersSet pars;
+            Vector<double> x;
+            Matrix<double> P;
+            smoother.getState(k, pars, x, P);
+
+            vector<size_t> g;
+            for (const auto& par : pars)
+                g.push_back(allIndex.at(par));
+
+            for (size_t i = 0; i < g.size(); i++)
+            {
+                dx = max(dx, fabs(x(i) - xb(g[i])));
+                for (size_t j = 0; j < g.size(); j++)
+                    dq = max(dq, fabs(P(i, j) - Q(g[i], g[j])));
+            }
+        }
+    }
+}
+
+int main()
+{
+    // batch solution of all the epochs
+    ParametersSet all;
+    for (int k = 0; k < numEpochs; k++)
+    {
+        ParametersSet pars(unknowns(k));
+        all.insert(pars.begin(), pars.end());
+    }
+    map<FilterParameter, size_t> allIndex(indices(all));
+
+    size_t n = all.size();
+    Matrix<double> N(n, n, 0.0);
+    Vector<double> b(n, 0.0);
+    for (size_t i = 0; i < n; i++)
+        N(i, i) = 1.0 / priorVariance;
+    for (int k = 0; k < numEpochs; k++)
+        addNormals(observations(k), allIndex, N, b);
+    Matrix<double> Q(inverse(N));
+    Vector<double> xb(Q * b);
+
+    double maxX(0.0), maxQ(0.0);
+    for (size_t i = 0; i < n; i++)
+    {
+        maxX = max(maxX, fabs(xb(i)));
+        for (size_t j = 0; j < n; j++)
+            maxQ = max(maxQ, fabs(Q(i, j)));
+    }
+
+    cout << "storage,epochs,filtered_state_diff,filtered_covariance_diff,"
+         << "smoothed_state_diff,smoothed_covariance_diff" << endl;
+
+    bool ok(true);
+    for (bool spill : { false, true })
+    {
+        KalmanSmoother smoother;
+        smoother.setSpillToDisk(spill);
+        filter(smoother);
+
+        double fx, fq, dx, dq;
+        compare(smoother, allIndex, xb, Q, fx, fq);
+        smoother.smooth();
+        compare(smoother, allIndex, xb, Q, dx, dq);
+
+        cout << (spill ? "disk" : "memory") << "," << smoother.size() << ","
+             << fx / maxX << "," << fq / maxQ << ","
+             << dx / maxX << "," << dq / maxQ << endl;
+        ok = ok && dx <= 1e-10 * maxX && dq <= 1e-10 * maxQ;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,296 @@
+// Check of the measurement updates of KalmanSolver, and of the log it
+// keeps for KalmanSmoother, against the batch least-squares solution of
+// the same problem.
+//
+// Usage: KalmanSolver_check
+//
+// Six GPS satellites are observed by code and phase (prefitC, prefitLC)
+// over 20 epochs. The unknowns are those of PositionEquations, with a
+// constant position, ClockBiasEquations, with a white noise clock, and
+// AmbiguitiesEquations for BLC. The phase of G01 has an outlier at epoch
+// 9: KalmanSolver rejects G01 there, restarts its ambiguity and updates
+// the epoch again without it, which it reports on the standard output.
+//
+// KalmanSolver processes the epochs once per update type, logging into a
+// KalmanSmoother. At the last epoch its state must hold the batch solution
+// of all the epochs, whose priors are the default state and covariance of
+// the equations; after smooth() every epoch must hold it.
+//
+// Prints, per update type, the largest differences of the final and of the
+// smoothed states and covariances from the batch ones, relative to the
+// largest batch values, as CSV. Exits with 1 if one exceeds 1e-8; the
+// information form is good to about 1e-11 and the sequential one to about
+// 1e-9, from the priors of the equations (1e9 m^2 for the position, 4e14
+// m^2 for the ambiguities). The smoothed covariances of an epoch are
+// relative to the largest of the batch values and the filtered variances
+// of the epoch instead: the backward pass subtracts from the filtered
+// covariance, which is 4e14 m^2 for the ambiguity restarted at epoch 9.
+
+#include"KalmanSolver.h"
+#include"KalmanSmoother.h"
+#include"PositionEquations.h"
+#include"ClockBiasEquations.h"
+#include"AmbiguitiesEquations.h"
+#include"MatrixOperators.hpp"
+#include"CivilTime.hpp"
+
+#include<algorithm>
+#include<cmath>
+#include<iostream>
+#include<map>
+#include<vector>
+
+using namespace std;
+using namespace gpstk;
+using namespace pod;
+
+namespace
+{
+    const int numEpochs = 20;
+    const int numSats = 6;
+    const int rejectedEpoch = 9;
+
+    // variances of the default state of the equations
+    const double positionVariance = 1e9;
+    const double clockVariance = 3e5 * 3e5;
+    const double ambiguityVariance = AmbiguitiesEquations::sigma *
+                                     AmbiguitiesEquations::sigma;
+
+    // weight factors of EquationComposer
+    const double codeWeight = 1.0;
+    const double phaseWeight = 1.0e4;
+
+    SatID satellite(int j)
+    {
+        return SatID(j + 1, SatID::systemGPS);
+    }
+
+    // unit vector from the receiver to satellite 'j' at epoch 'k'
+    Triple lineOfSight(int j, int k)
+    {
+        double az = 2.0 * M_PI * j / numSats + 0.004 * k;
+        double el = 0.25 + 0.2 * j + 0.002 * k;
+        return Triple(cos(el) * sin(az), cos(el) * cos(az), sin(el));
+    }
+
+    // epoch 'k' as KalmanSolver gets it
+    RinexEpoch epoch(int k)
+    {
+        const double dx[] = { 1.2, -0.7, 2.5 };
+
+        RinexEpoch gRin;
+        gRin.getHeader().epoch = CivilTime(2017, 9, 4, 1, 0, 0.0,
+                                           TimeSystem::GPS);
+        gRin.getHeader().epoch += 30.0 * k;
+        for (int j = 0; j < numSats; j++)
+        {
+            Triple u(lineOfSight(j, k));
+            double clock = 10.0 * sin(0.7 * k);
+            double range = -(u[0] * dx[0] + u[1] * dx[1] + u[2] * dx[2]) +
+                           clock;
+            double noise = 0.3 * sin(1.7 * k + 2.3 * j);
+
+            typeValueMap tvMap;
+            tvMap[TypeID::dx] = -u[0];
+            tvMap[TypeID::dy] = -u[1];
+            tvMap[TypeID::dz] = -u[2];
+            tvMap[TypeID::prefitC] = range + noise;
+            tvMap[TypeID::prefitLC] = range + 3.3 * j - 7.0 + 0.01 * noise;
+            if (j == 0 && k == rejectedEpoch)
+                tvMap[TypeID::prefitLC] += 300.0;
+            tvMap[TypeID::satArc] = 1.0;
+            gRin.addSv(satellite(j), tvMap);
+        }
+        gRin.resetCurrData();
+        return gRin;
+    }
+
+    // the parameters of the batch solution: the position, the clock of
+    // every epoch and the ambiguities, with a second one for G01 from the
+    // rejected epoch on
+    int clockIndex(int k)
+    {
+        return 3 + k;
+    }
+
+    int ambiguityIndex(int j, int k)
+    {
+        if (j == 0 && k >= rejectedEpoch)
+            return 3 + numEpochs + numSats;
+        return 3 + numEpochs + j;
+    }
+
+    // batch solution of all the epochs: 'xb' and its covariance 'Q'
+    void batch(Vector<double>& xb, Matrix<double>& Q)
+    {
+        size_t n = 3 + numEpochs + numSats + 1;
+        Matrix<double> N(n, n, 0.0);
+        Vector<double> b(n, 0.0);
+        for (int i = 0; i < 3; i++)
+            N(i, i) = 1.0 / positionVariance;
+        for (int k = 0; k < numEpochs; k++)
+            N(clockIndex(k), clockIndex(k)) = 1.0 / clockVariance;
+        for (size_t i = 3 + numEpochs; i < n; i++)
+            N(i, i) = 1.0 / ambiguityVariance;
+
+        for (int k = 0; k < numEpochs; k++)
+        {
+            RinexEpoch gRin(epoch(k));
+            for (const auto& sv : gRin.getBody())
+            {
+                int j = sv.first.id - 1;
+                const typeValueMap& obs = sv.second->get_value();
+                if (j == 0 && k == rejectedEpoch)
+                    continue;
+
+                for (bool phase : { false, true })
+                {
+                    Vector<double> h(n, 0.0);
+                    h(0) = obs.at(TypeID::dx);
+                    h(1) = obs.at(TypeID::dy);
+                    h(2) = obs.at(TypeID::dz);
+                    h(clockIndex(k)) = 1.0;
+                    if (phase)
+                        h(ambiguityIndex(j, k)) = 1.0;
+                    double z = obs.at(phase ? TypeID::prefitLC
+                                            : TypeID::prefitC);
+                    double w = phase ? phaseWeight : codeWeight;
+
+                    for (size_t r = 0; r < n; r++)
+                    {
+                        if (h(r) == 0.0)
+                            continue;
+                        b(r) += h(r) * w * z;
+                        for (size_t c = 0; c < n; c++)
+                            N(r, c) += h(r) * w * h(c);
+                    }
+                }
+            }
+        }
+        Q = inverse(N);
+        xb = Q * b;
+    }
+
+    // index in the batch solution of an unknown of epoch 'k'
+    int batchIndex(const FilterParameter& par, int k)
+    {
+        if (par.type == TypeID::dx) return 0;
+        if (par.type == TypeID::dy) return 1;
+        if (par.type == TypeID::dz) return 2;
+        if (par.type == TypeID::cdt) return clockIndex(k);
+        return ambiguityIndex(par.sv.id - 1, k);
+    }
+
+    // runs a KalmanSolver with update type 'uType' over all the epochs,
+    // logging into 'smoother'
+    EquationComposer::FilterState filter(EquationComposer::UpdateType uType,
+                                         KalmanSmoother& smoother)
+    {
+        eqComposer_sptr equations(std::make_shared<EquationComposer>());
+        equations->setSlnType(SlnType::PD_Float);
+        equations->setUpdateType(uType);
+
+        std::unique_ptr<PositionEquations> position(
+            std::make_unique<PositionEquations>());
+        position->setStochasicModel(std::make_shared<ConstantModel>());
+        equations->addEquation(std::move(position));
+        equations->addEquation(std::make_unique<ClockBiasEquations>());
+        equations->addEquation(
+            std::make_unique<AmbiguitiesEquations>(TypeID::BLC));
+
+        equations->measTypes().insert(TypeID::prefitC);
+        equations->measTypes().insert(TypeID::prefitLC);
+        equations->residTypes().insert(TypeID::postfitC);
+        equations->residTypes().insert(TypeID::postfitLC);
+
+        KalmanSolver solver(equations);
+        solver.setMinSatNumber(4);
+        solver.setSmoother(&smoother);
+        for (int k = 0; k < numEpochs; k++)
+        {
+            RinexEpoch gRin(epoch(k));
+            solver.Process(gRin);
+        }
+        return solver.getState();
+    }
+}
+
+int main()
+{
+    Vector<double> xb;
+    Matrix<double> Q;
+    batch(xb, Q);
+
+    double maxX(0.0), maxQ(0.0);
+    for (size_t i = 0; i < xb.size(); i++)
+    {
+        maxX = max(maxX, fabs(xb(i)));
+        for (size_t j = 0; j < xb.size(); j++)
+            maxQ = max(maxQ, fabs(Q(i, j)));
+    }
+
+    cout << "update,epochs,state_diff,covariance_diff,"
+         << "smoothed_state_diff,smoothed_covariance_diff" << endl;
+
+    bool ok(true);
+    for (auto uType : { EquationComposer::Information,
+                        EquationComposer::Sequential })
+    {
+        KalmanSmoother smoother;
+        EquationComposer::FilterState state(filter(uType, smoother));
+
+        double fx(0.0), fq(0.0);
+        for (const auto& it : state)
+        {
+            int i = batchIndex(it.first, numEpochs - 1);
+            fx = max(fx, fabs(it.second.value - xb(i)));
+            for (const auto& jt : it.second.valCov)
+                fq = max(fq, fabs(jt.second -
+                                  Q(i, batchIndex(jt.first, numEpochs - 1))));
+        }
+
+        // scale of the smoothed covariances of every epoch
+        vector<double> scale;
+        for (size_t k = 0; k < smoother.size(); k++)
+        {
+            ParametersSet pars;
+            Vector<double> x;
+            Matrix<double> P;
+            smoother.getState(k, pars, x, P);
+            scale.push_back(maxQ);
+            for (size_t i = 0; i < P.rows(); i++)
+                scale[k] = max(scale[k], P(i, i));
+        }
+
+        smoother.smooth();
+        double dx(0.0), dq(0.0);
+        for (size_t k = 0; k < smoother.size(); k++)
+        {
+            ParametersSet pars;
+            Vector<double> x;
+            Matrix<double> P;
+            smoother.getState(k, pars, x, P);
+
+            vector<int> g;
+            for (const auto& par : pars)
+                g.push_back(batchIndex(par, k));
+
+            for (size_t i = 0; i < g.size(); i++)
+            {
+                dx = max(dx, fabs(x(i) - xb(g[i])));
+                for (size_t j = 0; j < g.size(); j++)
+                    dq = max(dq, fabs(P(i, j) - Q(g[i], g[j])) / scale[k]);
+            }
+        }
+
+        cout << (uType == EquationComposer::Information ? "information"
+                                                        : "sequential")
+             << "," << smoother.size() << "," << fx / maxX << ","
+             << fq / maxQ << "," << dx / maxX << "," << dq << endl;
+        ok = ok && smoother.size() == numEpochs &&
+             fx <= 1e-8 * maxX && fq <= 1e-8 * maxQ &&
+             dx <= 1e-8 * maxX && dq <= 1e-8;
+    }
+
+    return ok ? 0 : 1;
+}
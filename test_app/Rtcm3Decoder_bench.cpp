@@ -0,0 +1,313 @@
+// Throughput of the RTCM 3 decoding, on a recorded capture or, without
+// one, on a synthetic stream of 1004 and 1008 messages with garbage
+// between the frames and some corrupted frames.
+//
+// Usage: Rtcm3Decoder_bench [capture [repeats]]
+//
+// The stream is decoded 'repeats' times by each method and the results
+// are printed as CSV: method, frames, crc_errors, MB, MB_per_s.
+//   bytewise - the former loop: readByte() and a dynamic_bitset per frame
+//   run      - Rtcm3Decoder::run() on a source giving 1460-byte segments
+//   feed     - Rtcm3Decoder::feed() with 1460-byte segments
+//   msm7     - feed() of a synthetic stream of GPS and Galileo MSM7
+//              messages, decoded to epochs
+
+#include"Rtcm3Decoder.hpp"
+#include"Rtcm3MsmMessage.hpp"
+#include"MemoryDataSource.hpp"
+#include"BitSetProxy.hpp"
+#include"RtcmUtils.hpp"
+
+#include<chrono>
+#include<cstdlib>
+#include<fstream>
+#include<iostream>
+#include<iterator>
+#include<vector>
+
+using namespace std;
+using namespace pod;
+
+namespace
+{
+	// appends 'len' bits of 'value' to 'bits', most significant first
+	void putBits(vector<bool>& bits, unsigned long long value, int len)
+	{
+		for (int i = len - 1; i >= 0; i--)
+			bits.push_back((value >> i) & 1);
+	}
+
+	// appends the frame of the message 'bits' to 'out'
+	void putFrame(vector<uchar>& out, const vector<bool>& bits)
+	{
+		vector<uchar> frame(3 + (bits.size() + 7) / 8, 0);
+		for (size_t i = 0; i < bits.size(); i++)
+			if (bits[i])
+				frame[3 + i / 8] |= 0x80 >> (i % 8);
+		size_t len = frame.size() - 3;
+		frame[0] = Rtcm3Framer::PREAMBLE;
+		frame[1] = (len >> 8) & 0x03;
+		frame[2] = len & 0xff;
+		frame.resize(frame.size() + 3);
+		RtcmUtils::crc24q_sign(frame.data(), static_cast<int>(len + 3));
+		out.insert(out.end(), frame.begin(), frame.end());
+	}
+
+	// Synthetic stream: one 1004 with 12 satellites per epoch, a 1008
+	// every 10 epochs, garbage after every 7th frame and a corrupted
+	// frame every 50 epochs. Returns the number of valid frames.
+	size_t makeStream(vector<uchar>& out, int epochs, size_t& numCorrupted)
+	{
+		size_t numFrames = 0;
+		numCorrupted = 0;
+		srand(1);
+		for (int e = 0; e < epochs; e++)
+		{
+			vector<bool> bits;
+			putBits(bits, 1004, 12);
+			putBits(bits, 100, 12);
+			putBits(bits, e * 1000, 30);
+			putBits(bits, 0, 1);
+			putBits(bits, 12, 5);
+			putBits(bits, 0, 4);
+			for (int s = 1; s <= 12; s++)
+			{
+				putBits(bits, s, 6);
+				putBits(bits, 0, 1);
+				putBits(bits, rand() & 0xffffff, 24);
+				putBits(bits, rand() & 0xfffff, 20);
+				putBits(bits, 127, 7);
+				putBits(bits, 70, 8);
+				putBits(bits, 180, 8);
+				putBits(bits, 3, 2);
+				putBits(bits, rand() & 0x3fff, 14);
+				putBits(bits, rand() & 0xfffff, 20);
+				putBits(bits, 127, 7);
+				putBits(bits, 160, 8);
+			}
+			size_t start = out.size();
+			putFrame(out, bits);
+			if (e % 50 == 49)
+			{
+				out[start + 20] ^= 0x10;
+				numCorrupted++;
+			}
+			else
+				numFrames++;
+
+			if (e % 10 == 0)
+			{
+				bits.clear();
+				putBits(bits, 1008, 12);
+				putBits(bits, 100, 12);
+				const string ant = "TRM59800.00     NONE";
+				putBits(bits, ant.size(), 8);
+				for (char c : ant)
+					putBits(bits, uchar(c), 8);
+				putBits(bits, 0, 8);
+				putBits(bits, 0, 8);
+				putFrame(out, bits);
+				numFrames++;
+			}
+
+			if (e % 7 == 0)
+			{
+				const uchar junk[] = { 0xD3, 0x00, 0x05, 0x42, 0xD3, 0xff, 0x13 };
+				out.insert(out.end(), junk, junk + sizeof(junk));
+			}
+		}
+		return numFrames;
+	}
+
+	// Synthetic MSM7 stream: per epoch, a 1077 with 12 satellites and
+	// a 1097 with 8 satellites, both with 2 signals.
+	void makeMsmStream(vector<uchar>& out, int epochs)
+	{
+		srand(2);
+		for (int e = 0; e < epochs; e++)
+		{
+			for (int sys = 0; sys < 2; sys++)
+			{
+				const int nSats = sys == 0 ? 12 : 8;
+				const int nCells = nSats * 2;
+				vector<bool> bits;
+				putBits(bits, sys == 0 ? 1077 : 1097, 12);
+				putBits(bits, 100, 12);
+				putBits(bits, 345600000 + e * 1000, 30);
+				// multiple message bit: Galileo ends the epoch
+				putBits(bits, sys == 0, 1);
+				putBits(bits, 0, 3 + 7 + 2 + 2 + 1 + 3);
+				putBits(bits, ((1ULL << nSats) - 1) << (64 - nSats - 1), 64);
+				putBits(bits, sys == 0 ? 0x40010000 : 0x40020000, 32);
+				putBits(bits, (1ULL << nCells) - 1, nCells);
+				for (int i = 0; i < nSats; i++)
+					putBits(bits, 70 + rand() % 10, 8);
+				for (int i = 0; i < nSats; i++)
+					putBits(bits, 0, 4);
+				for (int i = 0; i < nSats; i++)
+					putBits(bits, rand() & 0x3ff, 10);
+				for (int i = 0; i < nSats; i++)
+					putBits(bits, rand() & 0xfff, 14);
+				for (int i = 0; i < nCells; i++)
+					putBits(bits, rand() & 0x7ffff, 20);
+				for (int i = 0; i < nCells; i++)
+					putBits(bits, rand() & 0x7fffff, 24);
+				for (int i = 0; i < nCells; i++)
+					putBits(bits, 100 + e, 10);
+				for (int i = 0; i < nCells; i++)
+					putBits(bits, 0, 1);
+				for (int i = 0; i < nCells; i++)
+					putBits(bits, 45 * 16, 10);
+				for (int i = 0; i < nCells; i++)
+					putBits(bits, rand() & 0x3fff, 15);
+				putFrame(out, bits);
+			}
+		}
+	}
+
+	// The loop of Rtcm3Decoder::run() before the framing layer, without
+	// its printing; the 1004 fields are read as Rtcm3_1004 read them.
+	size_t bytewise(IdataSource& source, size_t size)
+	{
+		const int maxLen = 1024;
+		uchar buff[maxLen + 6];
+		size_t count = 0;
+		size_t done = 0;
+		long long sum = 0;
+		while (done < size)
+		{
+			uchar c = source.readByte();
+			done++;
+			if (c != Rtcm3Framer::PREAMBLE)
+				continue;
+			uchar lenchars[2];
+			source.readBytes(lenchars, 2);
+			done += 2;
+			BitSetProxy len_bsp(lenchars, 0, 2);
+			ushort len = len_bsp.getUint32(6, 10);
+			if (len >= maxLen)
+				continue;
+			source.readBytes(buff, 3, len + 3);
+			done += len + 3;
+			buff[0] = Rtcm3Framer::PREAMBLE;
+			buff[1] = lenchars[0];
+			buff[2] = lenchars[1];
+			if (!RtcmUtils::crc24q_check(buff, len + 6))
+				continue;
+			count++;
+			BitSetProxy msg_bsp(buff, 3, len);
+			if (msg_bsp.getUint32(0, 12) != 1004)
+				continue;
+			int nSats = msg_bsp.getUint32(55, 5);
+			for (int i = 0; i < nSats; i++)
+			{
+				BitSetProxy sat(msg_bsp.bits(), 64 + 125 * i, 125);
+				sum += sat.getUint32(0, 6) + sat.getUint32(7, 24) +
+					sat.getInt32(31, 20) + sat.getUint32(58, 8) +
+					sat.getInt32(76, 14) + sat.getInt32(90, 20);
+			}
+		}
+		if (sum == 42)
+			cerr << "";
+		return count;
+	}
+
+	void report(const string& name, size_t frames, size_t crcErrors,
+		double bytes, chrono::steady_clock::time_point t1)
+	{
+		chrono::duration<double> dt = chrono::steady_clock::now() - t1;
+		double mb = bytes / 1e6;
+		cout << name << "," << frames << "," << crcErrors << "," << mb << ","
+			<< mb / dt.count() << endl;
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	vector<uchar> stream;
+	size_t expected = 0, corrupted = 0;
+	if (argc > 1)
+	{
+		ifstream ifs(argv[1], ios::binary);
+		if (!ifs)
+		{
+			cerr << "Cannot open " << argv[1] << endl;
+			return 1;
+		}
+		stream.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+	}
+	else
+		expected = makeStream(stream, 20000, corrupted);
+	int repeats = argc > 2 ? atoi(argv[2]) : 5;
+
+	cout << "method,frames,crc_errors,MB,MB_per_s" << endl;
+	size_t frames = 0;
+
+	auto t1 = chrono::steady_clock::now();
+	for (int i = 0; i < repeats; i++)
+	{
+		MemoryDataSource source(stream);
+		frames = bytewise(source, stream.size());
+	}
+	report("bytewise", frames, 0, double(stream.size()) * repeats, t1);
+
+	size_t crcErrors = 0;
+	t1 = chrono::steady_clock::now();
+	for (int i = 0; i < repeats; i++)
+	{
+		Rtcm3Decoder decoder(std::make_unique<MemoryDataSource>(stream));
+		decoder.addMessage<Rtcm3_1008>();
+		decoder.addMessage<Rtcm3_1004>();
+		decoder.run();
+		frames = decoder.framer().framesFound();
+		crcErrors = decoder.framer().crcErrors();
+	}
+	report("run", frames, crcErrors, double(stream.size()) * repeats, t1);
+	if (expected && (frames != expected || crcErrors < corrupted))
+	{
+		cerr << "Expected " << expected << " frames and " << corrupted
+			<< " CRC errors" << endl;
+		return 1;
+	}
+
+	t1 = chrono::steady_clock::now();
+	for (int i = 0; i < repeats; i++)
+	{
+		Rtcm3Decoder decoder;
+		decoder.addMessage<Rtcm3_1008>();
+		decoder.addMessage<Rtcm3_1004>();
+		frames = 0;
+		for (size_t pos = 0; pos < stream.size(); pos += 1460)
+			frames += decoder.feed(stream.data() + pos,
+				std::min<size_t>(1460, stream.size() - pos));
+		crcErrors = decoder.framer().crcErrors();
+	}
+	report("feed", frames, crcErrors, double(stream.size()) * repeats, t1);
+
+	vector<uchar> msm;
+	const int msmEpochs = 5000;
+	makeMsmStream(msm, msmEpochs);
+	size_t epochs = 0;
+	t1 = chrono::steady_clock::now();
+	for (int i = 0; i < repeats; i++)
+	{
+		Rtcm3Decoder decoder;
+		decoder.addMessage<Rtcm3_1077>();
+		decoder.addMessage<Rtcm3_1097>();
+		frames = 0;
+		for (size_t pos = 0; pos < msm.size(); pos += 1460)
+			frames += decoder.feed(msm.data() + pos,
+				std::min<size_t>(1460, msm.size() - pos));
+		crcErrors = decoder.framer().crcErrors();
+		epochs = decoder.epochsDecoded();
+	}
+	report("msm7", frames, crcErrors, double(msm.size()) * repeats, t1);
+	if (epochs != msmEpochs)
+	{
+		cerr << "Expected " << msmEpochs << " epochs, decoded " << epochs << endl;
+		return 1;
+	}
+
+	return 0;
+}
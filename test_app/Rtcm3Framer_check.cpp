@@ -0,0 +1,291 @@
+// Check of the framing of the RTCM 3 streams by Rtcm3Framer and
+// Rtcm3Decoder::feed(), and of the field extraction of BitReader.
+//
+// Usage: Rtcm3Framer_check
+//
+//   sync      - frames back to back are all found, with their messages
+//   crc       - a frame with a flipped bit is rejected as a CRC error,
+//               and the next frame is found
+//   resync    - garbage between the frames, with false preambles, bad
+//               reserved bits and lengths running into the next frame,
+//               is skipped
+//   split     - a stream pushed in pieces of 1 to 1460 bytes gives the
+//               same frames, also when they wrap around the ring
+//   feed      - Rtcm3Decoder::feed() counts the same frames for any
+//               piece size
+//   bitreader - unsigned, two's complement and sign-magnitude fields at
+//               every bit offset, across the byte boundaries, up to 64
+//               bits, and the bits past the end
+//
+// Prints the result of every check as CSV; exits with 1 if one fails.
+
+#include"Rtcm3Decoder.hpp"
+#include"Rtcm3Framer.hpp"
+#include"BitReader.hpp"
+#include"RtcmUtils.hpp"
+
+#include<cstdint>
+#include<cstdlib>
+#include<iostream>
+#include<string>
+#include<vector>
+
+using namespace std;
+using namespace pod;
+
+namespace
+{
+	typedef vector<uchar> Bytes;
+
+	// the frame of 'msg'
+	Bytes frame(const Bytes& msg)
+	{
+		Bytes f(3 + msg.size() + 3, 0);
+		f[0] = Rtcm3Framer::PREAMBLE;
+		f[1] = (msg.size() >> 8) & 0x03;
+		f[2] = msg.size() & 0xff;
+		copy(msg.begin(), msg.end(), f.begin() + 3);
+		RtcmUtils::crc24q_sign(f.data(), static_cast<int>(msg.size() + 3));
+		return f;
+	}
+
+	// message 'k', of 'len' bytes: the type 1005, then a pattern
+	Bytes message(int k, size_t len)
+	{
+		Bytes msg(len);
+		for (size_t i = 0; i < len; i++)
+			msg[i] = static_cast<uchar>(k * 31 + i * 7);
+		msg[0] = 1005 >> 4;
+		msg[1] = (1005 & 0x0f) << 4;
+		return msg;
+	}
+
+	void append(Bytes& out, const Bytes& in)
+	{
+		out.insert(out.end(), in.begin(), in.end());
+	}
+
+	// the messages found by 'framer' in its buffer
+	void collect(Rtcm3Framer& framer, vector<Bytes>& found)
+	{
+		const uchar* msg;
+		int len;
+		while (framer.next(msg, len))
+			found.push_back(Bytes(msg, msg + len));
+	}
+
+	// the messages found in 'stream', pushed in pieces of 'piece' bytes
+	// to a framer with a buffer of 'capacity' bytes
+	vector<Bytes> frames(const Bytes& stream, size_t piece, size_t capacity,
+		size_t& crcErrors)
+	{
+		Rtcm3Framer framer(capacity);
+		vector<Bytes> found;
+		for (size_t pos = 0; pos < stream.size();)
+		{
+			size_t n = framer.push(stream.data() + pos,
+				min(piece, stream.size() - pos));
+			pos += n;
+			collect(framer, found);
+		}
+		crcErrors = framer.crcErrors();
+		return found;
+	}
+
+	bool report(const string& name, bool ok)
+	{
+		cout << name << "," << (ok ? "ok" : "FAILED") << endl;
+		return ok;
+	}
+
+	// messages of lengths from 2 bytes to the largest
+	vector<Bytes> messages()
+	{
+		const size_t lengths[] = { 2, 3, 19, 255, 256, 700,
+			size_t(Rtcm3Framer::MAX_MSG_LEN) };
+		vector<Bytes> msgs;
+		for (int k = 0; k < 40; k++)
+			msgs.push_back(message(k, lengths[k % 7]));
+		return msgs;
+	}
+
+	bool syncCheck()
+	{
+		vector<Bytes> msgs(messages());
+		Bytes stream;
+		for (const auto& m : msgs)
+			append(stream, frame(m));
+
+		size_t crcErrors;
+		vector<Bytes> found(frames(stream, stream.size(), stream.size(),
+			crcErrors));
+		return found == msgs && crcErrors == 0;
+	}
+
+	bool crcCheck()
+	{
+		Bytes stream, bad(frame(message(1, 100)));
+		bad[50] ^= 0x04;
+		append(stream, bad);
+		append(stream, frame(message(2, 100)));
+		// the CRC itself corrupted
+		bad = frame(message(3, 30));
+		bad.back() ^= 0x80;
+		append(stream, bad);
+		append(stream, frame(message(4, 30)));
+
+		size_t crcErrors;
+		vector<Bytes> found(frames(stream, stream.size(), 1 << 16, crcErrors));
+		return found.size() == 2 && found[0] == message(2, 100) &&
+			found[1] == message(4, 30) && crcErrors == 2;
+	}
+
+	bool resyncCheck()
+	{
+		vector<Bytes> msgs(messages());
+		Bytes stream;
+		srand(3);
+		for (const auto& m : msgs)
+		{
+			// random bytes, a preamble with reserved bits set, one whose
+			// length runs into the next frame, a lone preamble
+			for (int i = rand() % 50; i > 0; i--)
+				stream.push_back(static_cast<uchar>(rand()));
+			const uchar junk[] = { 0xD3, 0xFC, 0x05, 0x42, 0xD3, 0x00, 0x08,
+				0x11, 0xD3 };
+			stream.insert(stream.end(), junk, junk + sizeof(junk));
+			append(stream, frame(m));
+		}
+
+		size_t crcErrors;
+		return frames(stream, stream.size(), 1 << 16, crcErrors) == msgs;
+	}
+
+	bool splitCheck()
+	{
+		vector<Bytes> msgs;
+		Bytes stream;
+		for (int k = 0; k < 200; k++)
+		{
+			msgs.push_back(message(k, 1 + (k * 97) % Rtcm3Framer::MAX_MSG_LEN));
+			append(stream, frame(msgs.back()));
+			stream.push_back(0xD3);
+		}
+
+		// the smallest buffer: the frames wrap around it
+		const size_t pieces[] = { 1, 2, 3, 5, 64, 1000, 1460 };
+		for (size_t piece : pieces)
+		{
+			size_t crcErrors;
+			if (frames(stream, piece, 0, crcErrors) != msgs)
+				return false;
+		}
+		return true;
+	}
+
+	bool feedCheck()
+	{
+		const size_t n = 100;
+		Bytes stream;
+		for (size_t k = 0; k < n; k++)
+		{
+			append(stream, frame(message(k, 1 + (k * 53) % 400)));
+			const uchar junk[] = { 0x00, 0xD3, 0xFF };
+			stream.insert(stream.end(), junk, junk + sizeof(junk));
+		}
+
+		const size_t pieces[] = { 1, 7, 1460 };
+		for (size_t piece : pieces)
+		{
+			Rtcm3Decoder decoder;
+			size_t count = 0;
+			for (size_t pos = 0; pos < stream.size(); pos += piece)
+				count += decoder.feed(stream.data() + pos,
+					min(piece, stream.size() - pos));
+			if (count != n || decoder.framer().framesFound() != n)
+				return false;
+		}
+		return true;
+	}
+
+	// the bits of 'bytes', most significant first
+	vector<bool> bitsOf(const Bytes& bytes)
+	{
+		vector<bool> bits;
+		for (uchar b : bytes)
+			for (int i = 7; i >= 0; i--)
+				bits.push_back((b >> i) & 1);
+		return bits;
+	}
+
+	// the field of 'len' bits at 'i0', read one bit at a time
+	uint64_t field(const vector<bool>& bits, int i0, int len)
+	{
+		uint64_t v = 0;
+		for (int i = i0; i < i0 + len; i++)
+			v = (v << 1) | (i < int(bits.size()) && bits[i]);
+		return v;
+	}
+
+	bool bitReaderCheck()
+	{
+		Bytes data(23);
+		srand(4);
+		for (auto& b : data)
+			b = static_cast<uchar>(rand());
+		vector<bool> bits(bitsOf(data));
+		BitReader reader(data.data(), static_cast<int>(data.size()));
+		if (reader.size() != int(data.size()) * 8)
+			return false;
+
+		// every offset and length, the last fields past the end
+		for (int i0 = 0; i0 < reader.size(); i0++)
+			for (int len = 1; len <= 64; len++)
+			{
+				uint64_t u = field(bits, i0, len);
+				int64_t s = static_cast<int64_t>(u << (64 - len)) >> (64 - len);
+				if (reader.getUint64(i0, len) != u ||
+					reader.getInt64(i0, len) != s)
+					return false;
+				if (len > 32)
+					continue;
+
+				int mag = static_cast<int>(field(bits, i0 + 1, len - 1));
+				if (reader.getUint32(i0, len) != u ||
+					reader.getInt32(i0, len) != static_cast<int>(s) ||
+					reader.getSignMag32(i0, len) != (bits[i0] ? -mag : mag) ||
+					reader.getBit(i0) != bits[i0])
+					return false;
+			}
+
+		// known values: 12-bit type, negative two's complement and
+		// sign-magnitude fields straddling the bytes, a 40-bit field
+		const uchar msg[] = { 0x3F, 0xD8, 0x01, 0xFF, 0xF0, 0x28, 0xC0,
+			0x00, 0x00, 0x00, 0x07, 'A', 'B' };
+		BitReader known(msg, sizeof(msg));
+		return reader.getUint64(0, 0) == 0 &&
+			known.getUint32(0, 12) == 1021 &&
+			known.getInt32(12, 4) == -8 &&
+			known.getInt32(23, 9) == -1 &&
+			known.getUint32(32, 8) == 0xF0 &&
+			known.getSignMag32(40, 6) == 10 &&
+			known.getSignMag32(46, 2) == 0 &&
+			known.getUint64(48, 40) == ((uint64_t(0xC0) << 32) | 0x07) &&
+			known.getInt64(48, 40) == static_cast<int64_t>(
+				(uint64_t(0xC0) << 56 | uint64_t(0x07) << 24)) >> 24 &&
+			known.getString(88, 2) == "AB" &&
+			known.getUint32(96, 16) == 0x4200;
+	}
+}
+
+int main()
+{
+	cout << "check,result" << endl;
+	bool ok = report("sync", syncCheck());
+	ok = report("crc", crcCheck()) && ok;
+	ok = report("resync", resyncCheck()) && ok;
+	ok = report("split", splitCheck()) && ok;
+	ok = report("feed", feedCheck()) && ok;
+	ok = report("bitreader", bitReaderCheck()) && ok;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,597 @@
+// Check of the decoding of the RTCM 3 observation and ephemeris messages
+// against reference values.
+//
+// Usage: Rtcm3Message_check
+//
+// The frames are built field by field from the data fields (DF) of RTCM
+// 10403.3, then fed to an Rtcm3Decoder:
+//   msm7 - a 1077 with two GPS satellites and signals 1C and 2L, one cell
+//          missing and invalid fine pseudorange and phase rate values,
+//          then a 1077 of the next epoch with a lock time that dropped;
+//          the code, phase, Doppler, CNR and LLI/SSI are compared to the
+//          values computed by hand from the fields
+//   msm4 - the same for a 1094 with a Galileo satellite and signals 1C
+//          and 5Q; MSM4 has no Doppler
+//   1019, 1020, 1042, 1046 - the GPS, GLONASS, BeiDou and Galileo
+//          ephemerides of reference records, quantized to the resolution
+//          of their fields; every element decoded must be the reference
+//          one within half its resolution, and the times must be the
+//          reference ones. The GPS record is the G02 record of
+//          data/arlm2000.15n.
+//
+// Prints the result of every check as CSV, and the mismatches on the
+// standard error; exits with 1 if one fails.
+
+#include"Rtcm3Decoder.hpp"
+#include"Rtcm3MsmMessage.hpp"
+#include"Rtcm3EphMessage.hpp"
+#include"RtcmUtils.hpp"
+#include"RinexEpoch.h"
+
+#include"Rinex3EphemerisStore.hpp"
+#include"GNSSconstants.hpp"
+#include"GPSWeekSecond.hpp"
+#include"BDSWeekSecond.hpp"
+#include"CivilTime.hpp"
+
+#include<cmath>
+#include<iostream>
+#include<string>
+#include<vector>
+
+using namespace std;
+using namespace gpstk;
+using namespace pod;
+
+namespace
+{
+	// range of one light-millisecond (m)
+	const double RANGE_MS = C_MPS * 0.001;
+
+	bool failed;
+
+	void check(bool ok, const string& what)
+	{
+		if (!ok)
+		{
+			cerr << "mismatch: " << what << endl;
+			failed = true;
+		}
+	}
+
+	void checkValue(double value, double expected, double tol, const string& what)
+	{
+		check(fabs(value - expected) <= tol, what + " = " + to_string(value) +
+			", expected " + to_string(expected));
+	}
+
+	// the fields of a message, most significant bit first
+	class Message
+	{
+	public:
+		explicit Message(int type)
+		{
+			put(type, 12);
+		}
+
+		// unsigned or two's complement field: the 'len' low bits of 'value'
+		Message& put(long long value, int len)
+		{
+			for (int i = len - 1; i >= 0; i--)
+				bits.push_back((value >> i) & 1);
+			return *this;
+		}
+
+		// sign-magnitude field of GLONASS
+		Message& putSignMag(long long value, int len)
+		{
+			put(value < 0, 1);
+			return put(llabs(value), len - 1);
+		}
+
+		size_t size() const
+		{
+			return bits.size();
+		}
+
+		// the frame of the message
+		vector<uchar> frame() const
+		{
+			vector<uchar> f(3 + (bits.size() + 7) / 8 + 3, 0);
+			for (size_t i = 0; i < bits.size(); i++)
+				if (bits[i])
+					f[3 + i / 8] |= 0x80 >> (i % 8);
+			size_t len = f.size() - 6;
+			f[0] = Rtcm3Framer::PREAMBLE;
+			f[1] = (len >> 8) & 0x03;
+			f[2] = len & 0xff;
+			RtcmUtils::crc24q_sign(f.data(), static_cast<int>(len + 3));
+			return f;
+		}
+
+	private:
+		vector<bool> bits;
+	};
+
+	// header of an MSM of one epoch, up to the cell mask
+	Message msmHeader(int type, long long epochMs, bool multiple,
+		const vector<int>& sats, const vector<int>& sigs)
+	{
+		Message m(type);
+		m.put(7, 12).put(epochMs, 30).put(multiple, 1);
+		// IODS, reserved, clock steering and extended clock, smoothing
+		m.put(0, 3).put(0, 7).put(0, 2).put(0, 2).put(0, 1).put(0, 3);
+		unsigned long long satMask = 0;
+		for (int s : sats)
+			satMask |= 1ULL << (64 - s);
+		unsigned long long sigMask = 0;
+		for (int s : sigs)
+			sigMask |= 1ULL << (32 - s);
+		m.put(satMask, 64).put(sigMask, 32);
+		return m;
+	}
+
+	// the satellites of the epochs decoded
+	vector<satTypeValueMap> decodeEpochs(const vector<Message>& msgs,
+		const CommonTime& refTime, vector<CommonTime>& times)
+	{
+		Rtcm3Decoder decoder;
+		decoder.setReferenceTime(refTime);
+		decoder.addMessage<Rtcm3_1077>().addMessage<Rtcm3_1094>();
+		vector<satTypeValueMap> epochs;
+		decoder.setEpochReceivedCallback([&](IRinex& ep)
+		{
+			gnssRinex g(dynamic_cast<RinexEpoch&>(ep).getRinex());
+			epochs.push_back(g.body);
+			times.push_back(g.header.epoch);
+		});
+		for (const auto& m : msgs)
+		{
+			vector<uchar> f(m.frame());
+			decoder.feed(f.data(), f.size());
+		}
+		return epochs;
+	}
+
+	// value of 'type' of 'sat', NaN if missing
+	double obs(const satTypeValueMap& epoch, const SatID& sat, const TypeID& type)
+	{
+		auto it = epoch.find(sat);
+		if (it == epoch.end())
+			return NAN;
+		auto jt = it->second.find(type);
+		return jt == it->second.end() ? NAN : jt->second;
+	}
+
+	bool msm7Check()
+	{
+		failed = false;
+		const SatID g05(5, SatID::systemGPS), g12(12, SatID::systemGPS);
+		const CommonTime ref = GPSWeekSecond(1854, 3600.0, TimeSystem::GPS);
+		const long long towMs = 3630000;
+
+		// G05 with signals 2 (1C) and 16 (2L), G12 with signal 2 only
+		Message m = msmHeader(1077, towMs, false, { 5, 12 }, { 2, 16 });
+		m.put(1, 1).put(1, 1).put(1, 1).put(0, 1);
+		// DF397 rough range (ms), extended info, DF398 (2^-10 ms),
+		// DF399 rough phase range rate (m/s)
+		m.put(72, 8).put(80, 8);
+		m.put(0, 4).put(0, 4);
+		m.put(300, 10).put(1000, 10);
+		m.put(-512, 14).put(711, 14);
+		// cells: G05 1C, G05 2L, G12 1C
+		// DF405 fine pseudorange (2^-29 ms); -524288 is invalid
+		m.put(-12345, 20).put(54321, 20).put(-524288, 20);
+		// DF406 fine phase range (2^-31 ms)
+		m.put(1234567, 24).put(-2000000, 24).put(4000000, 24);
+		// DF407 lock time, DF420 half cycle
+		m.put(600, 10).put(600, 10).put(0, 10);
+		m.put(0, 1).put(1, 1).put(0, 1);
+		// DF408 CNR (2^-4 dB-Hz)
+		m.put(723, 10).put(600, 10).put(500, 10);
+		// DF404 fine phase range rate (0.0001 m/s); -16384 is invalid
+		m.put(2345, 15).put(-16384, 15).put(-5000, 15);
+
+		// next epoch: the lock time of G05 1C dropped
+		Message n = msmHeader(1077, towMs + 1000, false, { 5 }, { 2 });
+		n.put(1, 1);
+		n.put(72, 8).put(0, 4).put(300, 10).put(-512, 14);
+		n.put(0, 20).put(0, 24).put(100, 10).put(0, 1).put(723, 10).put(0, 15);
+
+		vector<CommonTime> times;
+		vector<satTypeValueMap> epochs(decodeEpochs({ m, n }, ref, times));
+		check(epochs.size() == 2, "number of epochs");
+		if (epochs.size() != 2)
+			return false;
+		const satTypeValueMap& e = epochs[0];
+
+		check(times[0] == CommonTime(GPSWeekSecond(1854, 3630.0, TimeSystem::GPS)),
+			"epoch");
+		check(e.size() == 2, "number of satellites");
+		checkValue(obs(e, g05, TypeID::C1), 21672879.904145669, 1e-6, "G05 C1");
+		checkValue(obs(e, g05, TypeID::C2), 21672917.130904578, 1e-6, "G05 C2");
+		checkValue(obs(e, g05, TypeID::L1), 21673059.145383399, 1e-6, "G05 L1");
+		checkValue(obs(e, g05, TypeID::L2), 21672607.59419585, 1e-6, "G05 L2");
+		checkValue(obs(e, g05, TypeID::D1), 2689.3458540908323, 1e-6, "G05 D1");
+		check(std::isnan(obs(e, g05, TypeID::D2)), "G05 D2 of an invalid rate");
+		checkValue(obs(e, g05, TypeID::S1), 45.1875, 0.0, "G05 S1");
+		checkValue(obs(e, g05, TypeID::S2), 37.5, 0.0, "G05 S2");
+		checkValue(obs(e, g05, TypeID::LLI1), 0, 0.0, "G05 LLI1");
+		checkValue(obs(e, g05, TypeID::LLI2), 2, 0.0, "G05 LLI2, half cycle");
+		checkValue(obs(e, g05, TypeID::SSI1), 7, 0.0, "G05 SSI1");
+		checkValue(obs(e, g05, TypeID::SSI2), 6, 0.0, "G05 SSI2");
+
+		check(std::isnan(obs(e, g12, TypeID::C1)), "G12 C1 of an invalid range");
+		check(std::isnan(obs(e, g12, TypeID::L2)), "G12 L2 of a missing cell");
+		checkValue(obs(e, g12, TypeID::L1), 24276721.119233292, 1e-6, "G12 L1");
+		checkValue(obs(e, g12, TypeID::D1), -3733.7027004195015, 1e-6, "G12 D1");
+		checkValue(obs(e, g12, TypeID::S1), 31.25, 0.0, "G12 S1");
+		checkValue(obs(e, g12, TypeID::LLI1), 1, 0.0, "G12 LLI1, no lock");
+		checkValue(obs(e, g12, TypeID::SSI1), 5, 0.0, "G12 SSI1");
+
+		check(times[1] == CommonTime(GPSWeekSecond(1854, 3631.0, TimeSystem::GPS)),
+			"second epoch");
+		checkValue(obs(epochs[1], g05, TypeID::LLI1), 1, 0.0,
+			"G05 LLI1 after the lock time dropped");
+		return !failed;
+	}
+
+	bool msm4Check()
+	{
+		failed = false;
+		const SatID e11(11, SatID::systemGalileo);
+		const CommonTime ref = GPSWeekSecond(1854, 3600.0, TimeSystem::GPS);
+
+		// E11 with signals 2 (1C) and 23 (5Q)
+		Message m = msmHeader(1094, 3630000, false, { 11 }, { 2, 23 });
+		m.put(1, 1).put(1, 1);
+		// DF397 rough range (ms), DF398 (2^-10 ms)
+		m.put(75, 8).put(512, 10);
+		// DF400 fine pseudorange (2^-24 ms), DF401 fine phase range
+		// (2^-29 ms), DF402 lock time, DF420 half cycle, DF403 CNR (dB-Hz)
+		m.put(-5000, 15).put(16383, 15);
+		m.put(100000, 22).put(-100000, 22);
+		m.put(9, 4).put(9, 4);
+		m.put(0, 1).put(0, 1);
+		m.put(41, 6).put(38, 6);
+
+		vector<CommonTime> times;
+		vector<satTypeValueMap> epochs(decodeEpochs({ m }, ref, times));
+		check(epochs.size() == 1, "number of epochs");
+		if (epochs.size() != 1)
+			return false;
+		const satTypeValueMap& e = epochs[0];
+
+		check(times[0] == CommonTime(GPSWeekSecond(1854, 3630.0, TimeSystem::GPS)),
+			"epoch");
+		checkValue(obs(e, e11, TypeID::C1), 22634241.233885173, 1e-6, "E11 C1");
+		checkValue(obs(e, e11, TypeID::C5), 22634623.32720324, 1e-6, "E11 C5");
+		checkValue(obs(e, e11, TypeID::L1), 22634386.419696767, 1e-6, "E11 L1");
+		checkValue(obs(e, e11, TypeID::L5), 22634274.738303233, 1e-6, "E11 L5");
+		checkValue(obs(e, e11, TypeID::S1), 41, 0.0, "E11 S1");
+		checkValue(obs(e, e11, TypeID::S5), 38, 0.0, "E11 S5");
+		checkValue(obs(e, e11, TypeID::LLI1), 0, 0.0, "E11 LLI1");
+		check(std::isnan(obs(e, e11, TypeID::D1)), "E11 D1 in MSM4");
+		return !failed;
+	}
+
+	// an element of an ephemeris: its field and its reference value
+	struct Element
+	{
+		const char* name;
+		double Rinex3NavData::* member;
+		double value;
+		int len;
+		// resolution of the field
+		double lsb;
+		// 'u' unsigned, 's' two's complement, 'm' sign-magnitude
+		char kind;
+	};
+
+	double p2(int n)
+	{
+		return ldexp(1.0, -n);
+	}
+
+	// adds the fields of 'elements' to 'm'
+	void putElements(Message& m, const vector<Element>& elements)
+	{
+		for (const auto& el : elements)
+		{
+			long long raw = llround(el.value / el.lsb);
+			if (el.kind == 'm')
+				m.putSignMag(raw, el.len);
+			else
+				m.put(raw, el.len);
+		}
+	}
+
+	// the ephemeris decoded from 'm'
+	Rinex3NavData decodeEphemeris(const Message& m, Rinex3EphemerisStore& store)
+	{
+		Rtcm3Decoder decoder;
+		decoder.setReferenceTime(GPSWeekSecond(1854, 3600.0, TimeSystem::GPS));
+		decoder.setEphemerisStore(&store);
+		decoder.addMessage<Rtcm3_1019>().addMessage<Rtcm3_1020>()
+			.addMessage<Rtcm3_1042>().addMessage<Rtcm3_1046>();
+		Rinex3NavData nav;
+		size_t count = 0;
+		decoder.setEphemerisReceivedCallback([&](const Rinex3NavData& n)
+		{
+			nav = n;
+			count++;
+		});
+		vector<uchar> f(m.frame());
+		decoder.feed(f.data(), f.size());
+		check(count == 1, "number of ephemerides");
+		return nav;
+	}
+
+	void checkElements(const Rinex3NavData& nav, const vector<Element>& elements)
+	{
+		for (const auto& el : elements)
+			if (el.member != nullptr)
+				checkValue(nav.*el.member, el.value, el.lsb / 2, el.name);
+	}
+
+	// the orbit of 'nav' is in the store and its radius is plausible
+	void checkOrbit(const Rinex3EphemerisStore& store, const Rinex3NavData& nav)
+	{
+		try
+		{
+			Xvt xvt = store.getXvt(nav.sat, nav.time + 300.0);
+			double r = xvt.x.mag();
+			check(r > 19e6 && r < 45e6, "radius of the orbit " + to_string(r));
+		}
+		catch (Exception& e)
+		{
+			check(false, "orbit: " + e.getText());
+		}
+	}
+
+	bool gpsCheck()
+	{
+		failed = false;
+		// G02 of data/arlm2000.15n
+		const double sc = p2(31) * PI;
+		vector<Element> el1 = {
+			{ "idot", &Rinex3NavData::idot, .789318592573e-10, 14, p2(43) * PI, 's' },
+			{ "IODE", &Rinex3NavData::IODE, 7, 8, 1, 'u' },
+			{ "Toc", &Rinex3NavData::Toc, 7168, 16, 16, 'u' },
+			{ "af2", &Rinex3NavData::af2, 0, 8, p2(55), 's' },
+			{ "af1", &Rinex3NavData::af1, .227373675443e-11, 16, p2(43), 's' },
+			{ "af0", &Rinex3NavData::af0, .579084269702e-03, 22, p2(31), 's' },
+			{ "IODC", &Rinex3NavData::IODC, 7, 10, 1, 'u' },
+			{ "Crs", &Rinex3NavData::Crs, -64.625, 16, p2(5), 's' },
+			{ "dn", &Rinex3NavData::dn, .489591822036e-08, 16, p2(43) * PI, 's' },
+			{ "M0", &Rinex3NavData::M0, -1.36404614938, 32, sc, 's' },
+			{ "Cuc", &Rinex3NavData::Cuc, -.324845314026e-05, 16, p2(29), 's' },
+			{ "ecc", &Rinex3NavData::ecc, .146582192974e-01, 32, p2(33), 'u' },
+			{ "Cus", &Rinex3NavData::Cus, .101532787085e-04, 16, p2(29), 's' },
+			{ "Ahalf", &Rinex3NavData::Ahalf, 5153.59719276, 32, p2(19), 'u' },
+			{ "Toe", &Rinex3NavData::Toe, 7168, 16, 16, 'u' },
+			{ "Cic", &Rinex3NavData::Cic, .320374965668e-06, 16, p2(29), 's' },
+			{ "OMEGA0", &Rinex3NavData::OMEGA0, -2.96605403382, 32, sc, 's' },
+			{ "Cis", &Rinex3NavData::Cis, .117346644402e-06, 16, p2(29), 's' },
+			{ "i0", &Rinex3NavData::i0, .941587707856, 32, sc, 's' },
+			{ "Crc", &Rinex3NavData::Crc, 168.96875, 16, p2(5), 's' },
+			{ "w", &Rinex3NavData::w, -2.24753761329, 32, sc, 's' },
+			{ "OMEGAdot", &Rinex3NavData::OMEGAdot, -.804390648956e-08, 24, p2(43) * PI, 's' },
+			{ "Tgd", &Rinex3NavData::Tgd, -.204890966415e-07, 8, p2(31), 's' },
+		};
+
+		Message m(1019);
+		// DF009 satellite, DF076 week (mod 1024), DF077 URA, DF078 L2 codes
+		m.put(2, 6).put(1854 % 1024, 10).put(0, 4).put(1, 2);
+		putElements(m, el1);
+		// DF102 health, DF103 L2 P data, DF137 fit interval
+		m.put(0, 6).put(0, 1).put(0, 1);
+		check(m.size() == 488, "1019 length");
+
+		Rinex3EphemerisStore store;
+		Rinex3NavData nav(decodeEphemeris(m, store));
+		checkElements(nav, el1);
+		check(nav.sat == RinexSatID(2, SatID::systemGPS), "satellite");
+		check(nav.time == CommonTime(GPSWeekSecond(1854, 7168.0, TimeSystem::GPS)),
+			"time of clock");
+		check(nav.weeknum == 1854 && nav.xmitTime == 3600, "transmit time");
+		checkValue(nav.accuracy, 2.4, 0.0, "accuracy");
+		check(nav.codeflgs == 1 && nav.health == 0 && nav.fitint == 0,
+			"codes, health, fit interval");
+		checkOrbit(store, nav);
+		return !failed;
+	}
+
+	bool glonassCheck()
+	{
+		failed = false;
+		// R07 at 12:15 UTC, 15:15 Moscow time
+		vector<Element> el1 = {
+			{ "vx", &Rinex3NavData::vx, 1.234567, 24, p2(20), 'm' },
+			{ "px", &Rinex3NavData::px, -14869.33, 27, p2(11), 'm' },
+			{ "ax", &Rinex3NavData::ax, 2.79396772385e-09, 5, p2(30), 'm' },
+			{ "vy", &Rinex3NavData::vy, -2.876543, 24, p2(20), 'm' },
+			{ "py", &Rinex3NavData::py, 7643.21, 27, p2(11), 'm' },
+			{ "ay", &Rinex3NavData::ay, -1.86264514923e-09, 5, p2(30), 'm' },
+			{ "vz", &Rinex3NavData::vz, 0.54321, 24, p2(20), 'm' },
+			{ "pz", &Rinex3NavData::pz, 19988.06, 27, p2(11), 'm' },
+			{ "az", &Rinex3NavData::az, -9.31322574615e-10, 5, p2(30), 'm' },
+		};
+		vector<Element> el2 = {
+			{ "GammaN", &Rinex3NavData::GammaN, 9.09494701773e-13, 11, p2(40), 'm' },
+		};
+
+		Message m(1020);
+		// DF038 satellite, DF040 channel + 7, DF104, DF105, DF106
+		m.put(7, 6).put(5 + 7, 5).put(0, 1).put(0, 1).put(0, 2);
+		// DF107 tk: 15:14:30, DF108 Bn, DF109 P2, DF110 tb (15 min)
+		m.put(15, 5).put(14, 6).put(1, 1).put(0, 1).put(0, 1).put(61, 7);
+		putElements(m, el1);
+		// DF114 P3
+		m.put(0, 1);
+		putElements(m, el2);
+		// DF116 P, DF117 ln, DF118 tau, DF119 delta tau, DF120 En
+		m.put(0, 2).put(0, 1).putSignMag(llround(-1.1e-4 / p2(30)), 22)
+			.put(0, 5).put(3, 5);
+		// DF121 - DF130, reserved
+		m.put(0, 1).put(0, 4).put(0, 11).put(0, 2).put(0, 1).put(0, 11)
+			.put(0, 32).put(0, 5).put(0, 22).put(0, 1).put(0, 7);
+		check(m.size() == 360, "1020 length");
+
+		Rinex3EphemerisStore store;
+		Rinex3NavData nav(decodeEphemeris(m, store));
+		checkElements(nav, el1);
+		checkElements(nav, el2);
+		check(nav.sat == RinexSatID(7, SatID::systemGlonass), "satellite");
+		check(nav.freqNum == 5, "frequency channel");
+		CommonTime toe = CivilTime(2015, 7, 19, 12, 15, 0.0, TimeSystem::GLO);
+		check(nav.time == toe, "ephemeris time");
+		check(nav.MFtime == 12 * 3600 + 14 * 60 + 30, "message frame time");
+		// RINEX keeps -tau
+		checkValue(nav.TauN, 1.1e-4, p2(31), "TauN");
+		checkValue(nav.ageOfInfo, 3, 0.0, "age of information");
+		check(nav.health == 0, "health");
+		checkOrbit(store, nav);
+		return !failed;
+	}
+
+	// the orbital elements of the BeiDou and Galileo ephemerides, with
+	// the lengths and resolutions of their fields
+	vector<Element> keplerElements(double ahalf, int toeLen, double toeLsb,
+		int harmonicLen, double harmonicLsb, int crLen, double crLsb)
+	{
+		const double sc = p2(31) * PI;
+		return {
+			{ "Crs", &Rinex3NavData::Crs, -30.5, crLen, crLsb, 's' },
+			{ "dn", &Rinex3NavData::dn, 1.2e-09, 16, p2(43) * PI, 's' },
+			{ "M0", &Rinex3NavData::M0, 0.85, 32, sc, 's' },
+			{ "Cuc", &Rinex3NavData::Cuc, -8.7e-06, harmonicLen, harmonicLsb, 's' },
+			{ "ecc", &Rinex3NavData::ecc, 0.0054, 32, p2(33), 'u' },
+			{ "Cus", &Rinex3NavData::Cus, 1.9e-05, harmonicLen, harmonicLsb, 's' },
+			{ "Ahalf", &Rinex3NavData::Ahalf, ahalf, 32, p2(19), 'u' },
+			{ "Toe", &Rinex3NavData::Toe, 7200, toeLen, toeLsb, 'u' },
+			{ "Cic", &Rinex3NavData::Cic, -2.4e-08, harmonicLen, harmonicLsb, 's' },
+			{ "OMEGA0", &Rinex3NavData::OMEGA0, -2.9, 32, sc, 's' },
+			{ "Cis", &Rinex3NavData::Cis, 4.1e-08, harmonicLen, harmonicLsb, 's' },
+			{ "i0", &Rinex3NavData::i0, 0.96, 32, sc, 's' },
+			{ "Crc", &Rinex3NavData::Crc, -250.3, crLen, crLsb, 's' },
+			{ "w", &Rinex3NavData::w, -2.5, 32, sc, 's' },
+			{ "OMEGAdot", &Rinex3NavData::OMEGAdot, -1.6e-09, 24, p2(43) * PI, 's' },
+		};
+	}
+
+	bool beidouCheck()
+	{
+		failed = false;
+		// C06, inclined geosynchronous; BDT week 498 is GPS week 1854
+		vector<Element> el1 = {
+			{ "idot", &Rinex3NavData::idot, 2.8e-10, 14, p2(43) * PI, 's' },
+			{ "IODE", &Rinex3NavData::IODE, 1, 5, 1, 'u' },
+			{ "Toc", &Rinex3NavData::Toc, 7200, 17, 8, 'u' },
+			{ "af2", &Rinex3NavData::af2, 0, 11, p2(66), 's' },
+			{ "af1", &Rinex3NavData::af1, -2.1e-11, 22, p2(50), 's' },
+			{ "af0", &Rinex3NavData::af0, 3.2e-04, 24, p2(33), 's' },
+			{ "IODC", &Rinex3NavData::IODC, 1, 5, 1, 'u' },
+		};
+		vector<Element> el2 = keplerElements(6493.4, 17, 8, 18, p2(31), 18, p2(6));
+		vector<Element> el3 = {
+			{ "Tgd", &Rinex3NavData::Tgd, 4.8e-09, 10, 1e-10, 's' },
+			{ "Tgd2", &Rinex3NavData::Tgd2, -2.1e-09, 10, 1e-10, 's' },
+		};
+
+		Message m(1042);
+		// DF488 satellite, DF489 week, DF490 URA index
+		m.put(6, 6).put(498, 13).put(2, 4);
+		putElements(m, el1);
+		putElements(m, el2);
+		putElements(m, el3);
+		// DF515 health
+		m.put(0, 1);
+		check(m.size() == 511, "1042 length");
+
+		Rinex3EphemerisStore store;
+		Rinex3NavData nav(decodeEphemeris(m, store));
+		checkElements(nav, el1);
+		checkElements(nav, el2);
+		checkElements(nav, el3);
+		check(nav.sat == RinexSatID(6, SatID::systemBeiDou), "satellite");
+		check(nav.time == CommonTime(BDSWeekSecond(498, 7200.0, TimeSystem::BDT)),
+			"time of clock");
+		// the reference time in BDT: 3600 - 14 s
+		check(nav.weeknum == 498 && nav.xmitTime == 3586, "transmit time");
+		checkValue(nav.accuracy, 4.85, 0.0, "accuracy");
+		check(nav.health == 0, "health");
+		checkOrbit(store, nav);
+		return !failed;
+	}
+
+	bool galileoCheck()
+	{
+		failed = false;
+		// E11; GST week 830 is GPS week 1854
+		vector<Element> el1 = {
+			{ "IODnav", &Rinex3NavData::IODnav, 12, 10, 1, 'u' },
+		};
+		vector<Element> el2 = {
+			{ "idot", &Rinex3NavData::idot, -2.4e-10, 14, p2(43) * PI, 's' },
+			{ "Toc", &Rinex3NavData::Toc, 7200, 14, 60, 'u' },
+			{ "af2", &Rinex3NavData::af2, 0, 6, p2(59), 's' },
+			{ "af1", &Rinex3NavData::af1, -6.48015114712e-12, 21, p2(46), 's' },
+			{ "af0", &Rinex3NavData::af0, -6.40284013934e-04, 31, p2(34), 's' },
+		};
+		vector<Element> el3 = keplerElements(5440.61580086, 14, 60, 16, p2(29), 16, p2(5));
+		vector<Element> el4 = {
+			{ "Tgd", &Rinex3NavData::Tgd, -5.122e-09, 10, p2(32), 's' },
+			{ "Tgd2", &Rinex3NavData::Tgd2, -5.588e-09, 10, p2(32), 's' },
+		};
+
+		Message m(1046);
+		// DF252 satellite, DF289 week
+		m.put(11, 6).put(830, 12);
+		putElements(m, el1);
+		// DF286 SISA index
+		m.put(107, 8);
+		putElements(m, el2);
+		putElements(m, el3);
+		putElements(m, el4);
+		// DF316, DF317 E5b health and validity, DF287, DF288 E1-B, reserved
+		m.put(0, 2).put(0, 1).put(0, 2).put(1, 1).put(0, 2);
+		check(m.size() == 504, "1046 length");
+
+		Rinex3EphemerisStore store;
+		Rinex3NavData nav(decodeEphemeris(m, store));
+		checkElements(nav, el1);
+		checkElements(nav, el2);
+		checkElements(nav, el3);
+		checkElements(nav, el4);
+		check(nav.sat == RinexSatID(11, SatID::systemGalileo), "satellite");
+		CommonTime toc = GPSWeekSecond(1854, 7200.0, TimeSystem::GPS);
+		toc.setTimeSystem(TimeSystem::GAL);
+		check(nav.time == toc, "time of clock");
+		check(nav.weeknum == 1854 && nav.xmitTime == 3600, "transmit time");
+		// SISA 107: 2 m + 7 * 0.16 m
+		checkValue(nav.accuracy, 3.12, 1e-12, "accuracy");
+		// E1-B data validity, bit 0 of the RINEX health
+		check(nav.health == 1, "health");
+		checkOrbit(store, nav);
+		return !failed;
+	}
+
+	bool report(const string& name, bool ok)
+	{
+		cout << name << "," << (ok ? "ok" : "FAILED") << endl;
+		return ok;
+	}
+}
+
+int main()
+{
+	cout << "check,result" << endl;
+	bool ok = report("msm7", msm7Check());
+	ok = report("msm4", msm4Check()) && ok;
+	ok = report("1019", gpsCheck()) && ok;
+	ok = report("1020", glonassCheck()) && ok;
+	ok = report("1042", beidouCheck()) && ok;
+	ok = report("1046", galileoCheck()) && ok;
+	return ok ? 0 : 1;
+}
@@ -1,9 +1,12 @@
 #include "Rinex3EphemerisStore.hpp"
 #include"Solution.h"
+#include"BatchSolution.h"
+#include"PppStreamSolution.h"
+#include"StreamDataSource.hpp"
+#include"SystemTime.hpp"
 #include"Action.h"
 #include"Rtcm3Decoder.hpp"
 #include"SerialDataSource.hpp"
-#include"BitSetProxy.hpp"
 
 #include <iostream>
 #include<filesystem>
@@ -31,7 +34,7 @@ void testRinNav(char* path)
 {
     Rinex3EphemerisStore nrin;
     cout<< nrin.loadFile(path) << endl;
-    auto &sid = SatID(1, SatID::SatelliteSystem::systemGPS);
+    auto sid = SatID(1, SatID::SatelliteSystem::systemGPS);
     CommonTime t0 = nrin.getInitialTime(sid);
     CommonTime te = nrin.getFinalTime(sid);
     nrin.SearchNear();
@@ -98,7 +101,9 @@ void testPod(char * path)
     cout << "processed epochs: " << sol.getData().data.size() << endl;
    
     sol.saveStatistic();
-    sol.saveToDb();
+    sol.saveProfile();
+    sol.moveToDb();
+    sol.waitForDb();
 
     cout << "inserting to db complete ";
     cout << (std::clock() - t2) / (double)CLOCKS_PER_SEC << endl;
@@ -108,10 +113,45 @@ void testPod(char * path)
     //f.close();
 }
 
+void testBatch(char * path)
+{
+    auto t1 = clock();
+    BatchSolution batch(path);
+    batch.process();
+    cout << "batch complete, failed sites: " << batch.numFailed() << " ";
+    cout << (std::clock() - t1) / (double)CLOCKS_PER_SEC << endl;
+}
+
+// plays back a recorded RTCM 3 (*.rtcm3) or RINEX feed of 'site' through
+// the real-time PPP engine; 'refTime' resolves the weeks of the RTCM times
+void testStream(char * path, char * site, char * feed, const CommonTime& refTime)
+{
+    ConfDataReader confReader;
+    auto data = std::make_shared<GnssDataStore>(confReader);
+    data->LoadSiteData(path, site);
+
+    PppStreamSolution engine(data);
+    engine.setRealTime(confReader.getValueAsBoolean("realTimePlayback"));
+    engine.setKeepEpochs(false);
+    engine.setSolutionCallback([](const CommonTime& t, const GnssEpoch& ep)
+    {
+        cout << CivilTime(t) << " " << ep.slnData.getValue(TypeID::recX) << " "
+            << ep.slnData.getValue(TypeID::recY) << " " << ep.slnData.getValue(TypeID::recZ) << endl;
+    });
+
+    fs::path feedPath(feed);
+    if (feedPath.extension() == ".rtcm3")
+        engine.playRtcm(std::make_unique<StreamDataSource>(feedPath.string()), refTime);
+    else
+        engine.playRinex(feedPath.string());
+
+    cout << "processed epochs: " << engine.epochsProcessed() << endl;
+    engine.printLatency(cout);
+}
+
 int main(int argc, char* argv[])
 {
 	cout << "Build: " << __DATE__" " << __TIME__ << endl << endl;
-	testRtcm();
     //cout << CivilTime(CommonTime::BEGINNING_OF_TIME) << endl;
     //Solution sol(argv[1]);
     //sol.chekObs();
@@ -120,10 +160,24 @@ int main(int argc, char* argv[])
     //SQLiteAdapter:: testSQLite(argv[1], argv[2]);
     //test();
 
-    //testRinParse(argv[1]);
-    cout << argv[1] << endl;
-
-    //testPod(argv[1]);
+    //the first argument selects the test, the others are its own
+    string mode(argc > 1 ? argv[1] : "");
+    if (mode == "pod" && argc == 3)
+        testPod(argv[2]);
+    else if (mode == "batch" && argc == 3)
+        testBatch(argv[2]);
+    else if (mode == "stream" && argc == 5)
+        testStream(argv[2], argv[3], argv[4], SystemTime().convertToCommonTime());
+    else if (mode == "rtcm" && argc == 2)
+        testRtcm();
+    else
+    {
+        cerr << "Usage: test_app pod <config>" << endl
+             << "       test_app batch <config>" << endl
+             << "       test_app stream <config> <site> <feed>" << endl
+             << "       test_app rtcm" << endl;
+        return 1;
+    }
     //system("pause");
     return 0;
 }